@@ -1,6 +1,7 @@
 
 #include "normApi.h"
 #include "normPostProcess.h"
+#include "normCompletion.h"
 #include <stdio.h>       // for printf(), etc
 #include <stdlib.h>      // for atoi(), etc
 #include <cassert>
@@ -187,6 +188,10 @@ class NormCaster
             {return purged_processor->SetCommand(cmd);}
         void SaveAborts(bool save_aborts)
             {save_aborted_files = save_aborts;}
+        // Post processing (and aborted file removal) is handed to this
+        // many worker threads (0 means it's done in the event loop)
+        void SetCompletionWorkers(unsigned int count)
+            {completion_workers = count;}
         
         // These can only be called post-OpenNormSession()
         
@@ -229,6 +234,8 @@ class NormCaster
         NormPostProcessor*                  sent_processor;
         NormPostProcessor*                  purged_processor;
         bool                                save_aborted_files;
+        NormCompletionPool                  completion_pool;
+        unsigned int                        completion_workers;
         ProtoFile::PathList                 tx_file_list;
         ProtoFile::PathList::PathIterator   tx_file_iterator;
         char                                tx_pending_path[PATH_MAX + 1];
@@ -268,7 +275,7 @@ class NormCaster
 
 NormCaster::NormCaster()
  : norm_session(NORM_SESSION_INVALID), post_processor(NULL), sent_processor(NULL),
-   purged_processor(NULL), save_aborted_files(false), tx_file_iterator(tx_file_list), 
+   purged_processor(NULL), save_aborted_files(false), completion_workers(0), tx_file_iterator(tx_file_list), 
    tx_pending_prefix_len(0), repeat_interval(-1.0), timer_delay(-1.0),
    is_multicast(false), loopback(false), probe_tos(0), probe_mode(NORM_PROBE_ACTIVE),
    norm_tx_queue_max(8), norm_tx_queue_count(0), 
@@ -292,6 +299,7 @@ NormCaster::~NormCaster()
 void NormCaster::Destroy()
 {
     tx_file_list.Destroy();
+    completion_pool.Destroy();  // (finishes pending post processing first)
     if (post_processor)
     {
         delete post_processor;
@@ -420,6 +428,12 @@ bool NormCaster::Start(bool sender, bool receiver)
         //NormPreallocateRemoteSender(norm_session, buffer_size, segment_size, block_size, num_parity, buffer_size);
         if (0 != rx_socket_buffer_size)
             NormSetRxSocketBuffer(norm_session, rx_socket_buffer_size);
+        if ((completion_workers > 0) && !completion_pool.Init(completion_workers, post_processor))
+        {
+            fprintf(stderr, "normCast error: unable to start completion workers\n");
+            NormStopReceiver(norm_session);
+            return false;
+        }
         fprintf(stderr, "normCast: receiver ready ...\n");
     }
     if (sender)
@@ -821,7 +835,14 @@ void NormCaster::HandleNormEvent(const NormEvent& event)
             fileName[PATH_MAX] = '\0';
             NormFileGetName(event.object, fileName, PATH_MAX);
             fprintf(stderr, "normCast: aborted reception of \"%s\"\n", fileName);
-            if (save_aborted_files)
+            if (completion_pool.IsActive())
+            {
+                NormCompletionPool::Action action = save_aborted_files ? 
+                    NormCompletionPool::PROCESS : NormCompletionPool::REMOVE;
+                if (!completion_pool.Submit(NormNodeGetId(event.sender), action, fileName))
+                    fprintf(stderr, "normCast: error queueing aborted file \"%s\"\n", fileName);
+            }
+            else if (save_aborted_files)
             {
                 if (post_processor->IsEnabled())
                 {
@@ -876,7 +897,12 @@ void NormCaster::HandleNormEvent(const NormEvent& event)
             fileName[PATH_MAX] = '\0';
             NormFileGetName(event.object, fileName, PATH_MAX);
             fprintf(stderr, "normCast: completed reception of \"%s\"\n", fileName);
-            if (post_processor->IsEnabled())
+            if (completion_pool.IsActive())
+            {
+                if (!completion_pool.Submit(NormNodeGetId(event.sender), NormCompletionPool::PROCESS, fileName))
+                    fprintf(stderr, "normCast: error queueing \"%s\" for post processing\n", fileName);
+            }
+            else if (post_processor->IsEnabled())
             {
                 if (!post_processor->ProcessFile(fileName))
                     fprintf(stderr, "normCast: post processing error\n");
@@ -905,6 +931,7 @@ void Usage()
                     "                [ptos <value>] [processor <processorCmdLine>] [saveaborts]\n"
                     "                [sentprocessor <processorCmdLine>]\n"
                     "                [purgeprocessor <processorCmdLine>] [buffer <bytes>]\n"
+                    "                [workers <count>]\n"
                     "                [txsockbuffer <bytes>] [rxsockbuffer <bytes>]\n"
                     "                [debug <level>] [trace] [log <logfile>]\n");
 }  // end Usage()
@@ -1510,6 +1537,17 @@ int main(int argc, char* argv[])
         {
             normCast.SaveAborts(true);
         }
+        else if (0 == strncmp(cmd, "workers", len))
+        {
+            int count;
+            if ((i >= argc) || (1 != sscanf(argv[i++], "%d", &count)) || (count < 0))
+            {
+                fprintf(stderr, "normCast error: missing or invalid 'workers' count!\n");
+                Usage();
+                return -1;
+            }
+            normCast.SetCompletionWorkers((unsigned int)count);
+        }
         else
         {
             fprintf(stderr, "normCast error: invalid command \"%s\"!\n", cmd);
@@ -1,6 +1,7 @@
 
 #include "normApi.h"
 #include "normPostProcess.h" // for "process" commandline
+#include "normCompletion.h"  // for "workers" post processing threads
 #include <stdio.h>       // for printf(), etc
 #include <stdlib.h>      // for atoi(), etc
 #include <cassert>
@@ -145,6 +146,12 @@ class NormCaster
             {return sent_count;}
         void SetTxSocketBufferSize(unsigned int value)
             {tx_socket_buffer_size = value;}
+        // Bytes of block parity kept so repeated files aren't re-encoded
+        void SetParityCacheSize(unsigned long value)
+            {parity_cache_size = value;}
+        // Sent files carry a content digest receivers verify
+        void SetTxDigest(bool enable)
+            {tx_digest = enable;}
 
         void SetSegmentSize(unsigned short segmentSize)
             {segment_size = segmentSize;}
@@ -183,6 +190,10 @@ class NormCaster
             {return purged_processor->SetCommand(cmd);}
         void SaveAborts(bool save_aborts)
             {save_aborted_files = save_aborts;}
+        // Post processing, archive unpacking and aborted file removal are
+        // handed to this many worker threads (0 means done in the event loop)
+        void SetCompletionWorkers(unsigned int count)
+            {completion_workers = count;}
         
         // These can only be called post-OpenNormSession()
         
@@ -225,6 +236,8 @@ class NormCaster
         NormPostProcessor*                  sent_processor;
         NormPostProcessor*                  purged_processor;
         bool                                save_aborted_files;
+        NormCompletionPool                  completion_pool;
+        unsigned int                        completion_workers;
         ProtoFile::PathList                 tx_file_list;
         ProtoFile::PathList::PathIterator   tx_file_iterator;
         char                                tx_pending_path[PATH_MAX + 1];
@@ -252,6 +265,8 @@ class NormCaster
         unsigned int                        tx_socket_buffer_size;
         unsigned int                        rx_socket_buffer_size;
         unsigned int                        buffer_size;
+        unsigned long                       parity_cache_size;
+        bool                                tx_digest;
 
         
         // receiver state variables
@@ -264,14 +279,15 @@ class NormCaster
 
 NormCaster::NormCaster()
  : norm_session(NORM_SESSION_INVALID), post_processor(NULL), sent_processor(NULL),
-   purged_processor(NULL), save_aborted_files(false), tx_file_iterator(tx_file_list), 
+   purged_processor(NULL), save_aborted_files(false), completion_workers(0), tx_file_iterator(tx_file_list), 
    tx_pending_prefix_len(0), repeat_interval(-1.0), timer_delay(-1.0),
    is_multicast(false), loopback(false), probe_tos(0), probe_mode(NORM_PROBE_ACTIVE),
    norm_tx_queue_max(8), norm_tx_queue_count(0), 
    norm_flow_control_pending(false), norm_tx_vacancy(true), norm_acking(false), 
    norm_flushing(true), norm_flush_object(NORM_OBJECT_INVALID), norm_last_object(NORM_OBJECT_INVALID),
    sent_count(0), segment_size(1400), block_size(64), num_parity(0), auto_parity(0),
-   tx_socket_buffer_size(4*1024*1024), rx_socket_buffer_size(6*1024*1024), buffer_size(64*1024*1024)
+   tx_socket_buffer_size(4*1024*1024), rx_socket_buffer_size(6*1024*1024), buffer_size(64*1024*1024),
+   parity_cache_size(0), tx_digest(false)
    //, rx_silent(false), tx_loss(0.0)
 {
     tx_pending_path[0] = '\0';
@@ -288,6 +304,7 @@ NormCaster::~NormCaster()
 void NormCaster::Destroy()
 {
     tx_file_list.Destroy();
+    completion_pool.Destroy();  // (finishes pending post processing first)
     if (post_processor)
     {
         delete post_processor;
@@ -416,6 +433,13 @@ bool NormCaster::Start(bool sender, bool receiver)
         //NormPreallocateRemoteSender(norm_session, buffer_size, segment_size, block_size, num_parity, buffer_size);
         if (0 != rx_socket_buffer_size)
             NormSetRxSocketBuffer(norm_session, rx_socket_buffer_size);
+        if ((completion_workers > 0) && 
+            !completion_pool.Init(completion_workers, post_processor, rx_cache_path))
+        {
+            fprintf(stderr, "normCastApp error: unable to start completion workers\n");
+            NormStopReceiver(norm_session);
+            return false;
+        }
         fprintf(stderr, "normCastApp: receiver ready ...\n");
     }
     if (sender)
@@ -446,6 +470,10 @@ bool NormCaster::Start(bool sender, bool receiver)
             NormSetAutoParity(norm_session, auto_parity < num_parity ? auto_parity : num_parity);
         if (0 != tx_socket_buffer_size)
             NormSetTxSocketBuffer(norm_session, tx_socket_buffer_size);
+        if (0 != parity_cache_size)
+            NormSetTxParityCache(norm_session, parity_cache_size);
+        if (tx_digest)
+            NormSetTxDigest(norm_session, true);
         
         
     }
@@ -817,7 +845,14 @@ void NormCaster::HandleNormEvent(const NormEvent& event)
             fileName[PATH_MAX] = '\0';
             NormFileGetName(event.object, fileName, PATH_MAX);
             fprintf(stderr, "normCastApp: aborted reception of \"%s\"\n", fileName);
-            if (save_aborted_files)
+            if (completion_pool.IsActive())
+            {
+                NormCompletionPool::Action action = save_aborted_files ? 
+                    NormCompletionPool::PROCESS : NormCompletionPool::REMOVE;
+                if (!completion_pool.Submit(NormNodeGetId(event.sender), action, fileName))
+                    fprintf(stderr, "normCastApp: error queueing aborted file \"%s\"\n", fileName);
+            }
+            else if (save_aborted_files)
             {
                 if (post_processor->IsEnabled())
                 {
@@ -872,7 +907,21 @@ void NormCaster::HandleNormEvent(const NormEvent& event)
             fileName[PATH_MAX] = '\0';
             NormFileGetName(event.object, fileName, PATH_MAX);
             fprintf(stderr, "normCastApp: completed reception of \"%s\"\n", fileName);
-            if (post_processor->IsEnabled())
+            if (completion_pool.IsActive())
+            {
+                NormCompletionPool::Action action = NormFileIsArchive(event.object) ? 
+                    NormCompletionPool::UNPACK : NormCompletionPool::PROCESS;
+                if (!completion_pool.Submit(NormNodeGetId(event.sender), action, fileName))
+                    fprintf(stderr, "normCastApp: error queueing \"%s\" for post processing\n", fileName);
+            }
+            else if (NormFileIsArchive(event.object))
+            {
+                // Small files a sender packed with NormFileEnqueueArchive()
+                unsigned int count = NormFileUnpackArchive(event.object, rx_cache_path);
+                fprintf(stderr, "normCastApp: unpacked %u files from archive \"%s\"\n", count, fileName);
+                remove(fileName);
+            }
+            else if (post_processor->IsEnabled())
             {
                 if (!post_processor->ProcessFile(fileName))
                     fprintf(stderr, "normCastApp: post processing error\n");
@@ -987,6 +1036,7 @@ void NormCastApp::Usage()
                     "                   [sentprocessor <processorCmdLine>]\n"
                     "                   [purgeprocessor <processorCmdLine>] [buffer <bytes>]\n"
                     "                   [txsockbuffer <bytes>] [rxsockbuffer <bytes>]\n"
+                    "                   [txparitycache <bytes>] [txdigest] [workers <count>]\n"
                     "                   [instance <name>] [debug <level>] [trace] [log <logfile>]\n");
 }  // end NormCastApp::Usage()
 
@@ -1468,6 +1518,27 @@ bool NormCastApp::ProcessCommands(int argc, const char*const* argv)
             }
             normCast.SetNumParity(value);
         }
+        else if (0 == strncmp(cmd, "txparitycache", len))
+        {
+            unsigned long value = 0 ;
+            if (i >= argc)
+            {
+                fprintf(stderr, "normCastApp error: missing 'txparitycache' size!\n");
+                Usage();
+                return false;
+            }
+            if (1 != sscanf(argv[i++], "%lu", &value))
+            {
+                fprintf(stderr, "normCastApp error: invalid 'txparitycache' size!\n");
+                Usage();
+                return false;
+            }
+            normCast.SetParityCacheSize(value);
+        }
+        else if (0 == strncmp(cmd, "txdigest", len))
+        {
+            normCast.SetTxDigest(true);
+        }
         else if (0 == strncmp(cmd, "auto", len))
         {
             if (i >= argc)
@@ -1644,6 +1715,17 @@ bool NormCastApp::ProcessCommands(int argc, const char*const* argv)
         {
             normCast.SaveAborts(true);
         }
+        else if (0 == strncmp(cmd, "workers", len))
+        {
+            int count;
+            if ((i >= argc) || (1 != sscanf(argv[i++], "%d", &count)) || (count < 0))
+            {
+                fprintf(stderr, "normCastApp error: missing or invalid 'workers' count!\n");
+                Usage();
+                return false;
+            }
+            normCast.SetCompletionWorkers((unsigned int)count);
+        }
         else if (0 == strncmp(cmd, "instance", len))
         {
             if (i >= argc)
@@ -41,7 +41,9 @@ const unsigned int LOOP_MAX = 1;
 // with the SHOOT_FIRST type strategies and high throughput is
 // the application may end up "chasing" the ACK request until
 // flow control buffer limits are reached and end up with 
-// "dead air" time.  There are always tradeoffs!
+// "dead air" time.  There are always tradeoffs!  (NormAddWatermark()
+// avoids the choice by pipelining ACK requests without canceling ones
+// still pending, each completing with its own notification)
 
 //#define SHOOT_FIRST 0
 
@@ -0,0 +1,65 @@
+#ifndef _NORM_AEAD
+#define _NORM_AEAD
+
+#include "protoDefs.h"  // for UINT32, etc
+
+// NormAead is the ChaCha20-Poly1305 AEAD (RFC 8439) used by the optional
+// per-session packet protection (see NormSetAeadKey()).  It is self
+// contained (no crypto library dependency).  With GCC/Clang, ChaCha20
+// computes four blocks at a time in SIMD (SSE2/NEON) registers, and
+// Poly1305 uses 44/44/42-bit limbs (in 64-bit words) instead of 26-bit
+// ones where 128-bit integers are available.
+//
+// Seal() encrypts "text" in place and computes the 16 byte tag over the
+// "aad" (authenticated but not encrypted) and encrypted text.  Open()
+// checks the tag and only then decrypts in place.  A nonce must never be
+// used twice with the same key.  Open() doesn't track nonces, so (as used
+// by NormSession) there is no replay protection.
+
+class NormAead
+{
+    public:
+        enum
+        {
+            KEY_SIZE    = 32,
+            NONCE_SIZE  = 12,
+            TAG_SIZE    = 16
+        };
+
+        NormAead();
+        ~NormAead();
+
+        void SetKey(const UINT8* key);  // KEY_SIZE bytes
+        void ClearKey();
+        bool IsKeySet() const
+            {return key_set;}
+
+        void Seal(const UINT8*  nonce,
+                  const UINT8*  aad,
+                  unsigned int  aadLen,
+                  UINT8*        text,
+                  unsigned int  textLen,
+                  UINT8*        tag) const;
+        bool Open(const UINT8*  nonce,
+                  const UINT8*  aad,
+                  unsigned int  aadLen,
+                  UINT8*        text,
+                  unsigned int  textLen,
+                  const UINT8*  tag) const;
+
+    private:
+        void ChaChaBlock(UINT32 counter, const UINT8* nonce, UINT8* out) const;
+        void ChaChaXor(UINT32 counter, const UINT8* nonce, UINT8* text, unsigned int len) const;
+        void ComputeTag(const UINT8*  nonce,
+                        const UINT8*  aad,
+                        unsigned int  aadLen,
+                        const UINT8*  text,
+                        unsigned int  textLen,
+                        UINT8*        tag) const;
+
+        UINT32      key_words[8];
+        bool        key_set;
+
+};  // end class NormAead
+
+#endif // _NORM_AEAD
@@ -149,12 +149,27 @@ typedef enum NormSyncPolicy
     NORM_SYNC_ALL       // attempt to receive old and new objects
 } NORM_API_LINKAGE NormSyncPolicy;
 
+// Which buffered FEC block a receiver gives up when its buffers are full:
+// the ordinally furthest one (the default), or the one least costly to lose
+// (fewest segments received and not yet NACKed)
+typedef enum NormEvictionPolicy
+{
+    NORM_EVICT_ORDINAL,
+    NORM_EVICT_SCORED
+} NORM_API_LINKAGE NormEvictionPolicy;
+
 typedef enum NormRepairBoundary
 {
     NORM_BOUNDARY_BLOCK,
     NORM_BOUNDARY_OBJECT
 } NORM_API_LINKAGE NormRepairBoundary;
 
+typedef enum NormCCMode
+{
+    NORM_CC_TFMCC,  // NORM-CC (RFC 5740), the default
+    NORM_CC_BBR     // bottleneck bandwidth / min RTT model based
+} NORM_API_LINKAGE NormCCMode;
+
 typedef enum NormEventType
 {
     NORM_EVENT_INVALID = 0,
@@ -185,7 +200,9 @@ typedef enum NormEventType
     NORM_CC_INACTIVE,
     NORM_ACKING_NODE_NEW,        // whe NormSetAutoAcking
     NORM_SEND_ERROR,             // ICMP error (e.g. destination unreachable)
-    NORM_USER_TIMEOUT            // issues when timeout set by NormSetUserTimer() expires
+    NORM_USER_TIMEOUT,           // issues when timeout set by NormSetUserTimer() expires
+    NORM_RX_OBJECT_BLOCK_COMPLETED, // progressive receive mode, see NormSetRxProgressive()
+    NORM_RX_SOCKET_OVERFLOW      // rx socket buffer dropped datagrams (see NormSetRxExcuseSocketDrops())
 } NORM_API_LINKAGE NormEventType;
 
 typedef struct
@@ -238,6 +255,17 @@ bool NormSetCacheDirectory(NormInstanceHandle instanceHandle,
 NORM_API_LINKAGE
 bool NormGetNextEvent(NormInstanceHandle instanceHandle, NormEvent* theEvent, bool waitForEvent DEFAULT(true));
 
+// "NormGetNextEvents()" retrieves up to "maxEvents" pending events with a
+// single NORM thread handoff and returns the number retrieved (blocking
+// for at least one unless "waitForEvent" is "false").  Handles for all of
+// the returned events remain valid until the next NormGetNextEvent(s)()
+// or NormReleasePreviousEvent() call.
+NORM_API_LINKAGE
+unsigned int NormGetNextEvents(NormInstanceHandle instanceHandle, 
+                               NormEvent*         eventList, 
+                               unsigned int       maxEvents, 
+                               bool               waitForEvent DEFAULT(true));
+
 // The "NormGetDescriptor()" function returns a HANDLE (WIN32) or
 // a file descriptor (UNIX) which can be used for async notification
 // of pending NORM events. On WIN32, the returned HANDLE can be used 
@@ -256,11 +284,87 @@ const NormDescriptor NORM_DESCRIPTOR_INVALID;
 NORM_API_LINKAGE
 NormDescriptor NormGetDescriptor(NormInstanceHandle instanceHandle);
 
+// "NormGetSessionDescriptor()" gives the session its own event queue and
+// descriptor (an eventfd on Linux), so that event loops (epoll, io_uring,
+// etc) can each own a subset of sessions.  From then on the session's 
+// events (including any already pending) are no longer returned by 
+// NormGetNextEvent(s)(), but by the non-blocking "NormGetSessionEvents()"
+// instead.  The descriptor is readable while the session's queue is not
+// empty and stays valid until NormDestroySession().  Handles for the events
+// returned remain valid until the next NormGetSessionEvents() call for the
+// session.
+NORM_API_LINKAGE
+NormDescriptor NormGetSessionDescriptor(NormSessionHandle sessionHandle);
+
+NORM_API_LINKAGE
+unsigned int NormGetSessionEvents(NormSessionHandle sessionHandle,
+                                  NormEvent*        eventList,
+                                  unsigned int      maxEvents);
+
 NORM_API_LINKAGE
 void NormSetAllocationFunctions(NormInstanceHandle      instance,
                                 NormAllocFunctionHandle allocFunc,
                                 NormFreeFunctionHandle  freeFunc);
 
+// Enables a pool of size-classed buffers (caching up to "cacheLimit" bytes
+// of freed buffers for reuse) for received NORM_OBJECT_DATA content in place 
+// of per-object allocation (0 disables).  Regions of app-supplied memory may
+// be added for the pool to carve buffers from first, and must remain valid
+// until the instance is destroyed.  Data detached from pooled objects with
+// NormDataDetachData() must be freed with NormDataFreeBuffer().
+NORM_API_LINKAGE
+bool NormSetRxDataPool(NormInstanceHandle instance,
+                       size_t             cacheLimit);
+
+NORM_API_LINKAGE
+bool NormAddRxDataPoolRegion(NormInstanceHandle instance,
+                             char*              region,
+                             size_t             regionSize);
+
+NORM_API_LINKAGE
+void NormDataFreeBuffer(char* dataPtr);
+
+// Busy-poll mode has the instance's protocol thread spin, polling its
+// session sockets every few microseconds, instead of sleeping until a
+// socket or timer is ready.  This trades a full CPU core for lower and 
+// steadier latency.  When "cpuId" is non-negative, the protocol thread is
+// also pinned to that CPU.  SO_BUSY_POLL is set on session sockets where
+// supported (Linux), so the kernel polls the device queue on reads, too.
+NORM_API_LINKAGE
+bool NormSetBusyPoll(NormInstanceHandle instance,
+                     bool               enable,
+                     int                cpuId DEFAULT(-1));
+
+// Sharded mode spreads the instance's sessions (round-robin as created) 
+// over "shardCount" protocol threads, each with its own dispatcher and
+// timers, so many busy sessions aren't limited to one CPU core.  Events
+// from all shards are still retrieved through the instance as usual.
+// This must be set before any sessions are created (zero disables).  In
+// busy-poll mode each shard thread spins (pinned to "cpuId" + shard index).
+NORM_API_LINKAGE
+bool NormSetShardCount(NormInstanceHandle instance,
+                       unsigned int       shardCount);
+
+// Caps the total receive buffer memory (in bytes) allocated for remote
+// senders across all of the instance's sessions (zero, the default, is no
+// limit).  A sender whose buffers would exceed the budget gets what is left
+// (at least two FEC blocks' worth) or, if none is, its data is ignored until
+// memory is freed.  In sharded mode each shard gets an even share.
+NORM_API_LINKAGE
+bool NormSetRxMemoryBudget(NormInstanceHandle instance,
+                           unsigned long      numBytes);
+
+// Caps the total transmit rate (in bits/sec) of all of the instance's
+// sessions (zero, the default, is no limit).  The sessions actively sending
+// share the budget in proportion to their NormSetTxRateWeight() weights, so
+// the unused shares of idle sessions (or of sessions whose own tx rate is
+// lower) go to the busy ones.  A session never sends faster than its own
+// NormSetTxRate() (or congestion control) rate.  In sharded mode each shard
+// gets an even share.
+NORM_API_LINKAGE
+bool NormSetTxRateBudget(NormInstanceHandle instance,
+                         double             bitsPerSecond);
+
 // NORM Session Creation and Control Functions
 
 NORM_API_LINKAGE
@@ -351,13 +455,30 @@ void NormSetRxPortReuse(NormSessionHandle sessionHandle,
                         const char*       senderAddress DEFAULT((const char*)0), // if non-NULL, connect() to <senderAddress>/<senderPort>
                         UINT16            senderPort DEFAULT(0));
 
+// Receive sharding (Linux only): "shardCount" sessions on the same address and
+// port, started in "shardIndex" order, each receive the messages of the remote
+// senders whose NormNodeId modulo "shardCount" is their "shardIndex".  With
+// NormSetShardCount(), the sessions (and so the senders) are processed on
+// separate threads.  The sessions should use the same local NormNodeId.
+NORM_API_LINKAGE
+bool NormSetRxShard(NormSessionHandle sessionHandle,
+                    unsigned int      shardIndex,
+                    unsigned int      shardCount);
+
+// With "enable" true, the instance's sessions on the same port (and multicast
+// interface) receive through one shared socket that hands each packet to the
+// session for its destination (group) address, or for its source address when
+// that is the unicast peer of a session.  Call before the session is started.
+NORM_API_LINKAGE
+bool NormSetRxPortShare(NormSessionHandle sessionHandle,
+                        bool              enable);
+
 NORM_API_LINKAGE
 UINT16 NormGetRxPort(NormSessionHandle sessionHandle);
 
 NORM_API_LINKAGE
 bool NormGetRxBindAddress(NormSessionHandle sessionHandle, char* addr, unsigned int& addrLen, UINT16& port);
 
-// TBD - We should probably have a "NormSetCCMode(NormCCMode ccMode)" function for users
 NORM_API_LINKAGE
 void NormSetEcnSupport(NormSessionHandle  sessionHandle, 
                        bool               ecnEnable,             // enables NORM ECN (congestion control) support
@@ -368,6 +489,48 @@ NORM_API_LINKAGE
 bool NormSetMulticastInterface(NormSessionHandle sessionHandle,
                                const char*       interfaceName);
 
+// Multipath transmission: adds a transmit path using the "interfaceName"
+// multicast interface and/or bound to the "srcAddr" source address.  Sender
+// data is striped over the session's paths in proportion to their weights
+// (e.g. path rates, with path 0 being the session's usual transmit socket).
+// The session transmit rate applies to the aggregate of the paths.
+NORM_API_LINKAGE
+bool NormAddTxPath(NormSessionHandle sessionHandle,
+                   const char*       interfaceName,
+                   const char*       srcAddr DEFAULT((const char*)0),
+                   double            weight DEFAULT(1.0));
+
+NORM_API_LINKAGE
+bool NormSetTxPathWeight(NormSessionHandle sessionHandle,
+                         unsigned int      pathIndex,
+                         double            weight);
+
+// Layered multi-rate multicast: the sender adds multicast groups (on the
+// session port) as layers 1, 2, ... and fresh data is spread over the
+// session group (layer 0, weight 1.0) and the layers by weight, with
+// repairs and commands on layer 0.  The session transmit rate (set or
+// congestion controlled) is layer 0's, so receivers that only keep layer 0
+// set the base rate but fast receivers take in the layers too; layer 0
+// receivers repair the rest through NACKs and FEC as usual.  Receivers add
+// the same groups in order and join (or leave) them one at a time as their
+// measured loss allows.  NormGetRxLayerLevel() is how many are joined.
+NORM_API_LINKAGE
+bool NormAddTxLayer(NormSessionHandle sessionHandle,
+                    const char*       groupAddr,
+                    double            weight DEFAULT(1.0));
+
+NORM_API_LINKAGE
+bool NormAddRxLayer(NormSessionHandle sessionHandle,
+                    const char*       groupAddr);
+
+NORM_API_LINKAGE
+unsigned int NormGetRxLayerLevel(NormSessionHandle sessionHandle);
+
+NORM_API_LINKAGE
+bool NormSetXdpInterface(NormSessionHandle sessionHandle,
+                         const char*       interfaceName,
+                         unsigned int      queueId);
+
 NORM_API_LINKAGE
 bool NormSetSSM(NormSessionHandle sessionHandle,
                 const char*       sourceAddress);
@@ -397,6 +560,15 @@ bool NormSetFragmentation(NormSessionHandle sessionHandle,
 NORM_API_LINKAGE
 void NormSetMessageTrace(NormSessionHandle sessionHandle, bool state);
 
+// Binary trace ring of the last "numRecords" messages sent and received
+// (zero disables it), cheap enough to leave enabled, and saved to a file
+// for the "pcap2norm" and "n2m" tools' offline decoding on demand
+NORM_API_LINKAGE
+bool NormSetTraceRing(NormSessionHandle sessionHandle, unsigned int numRecords);
+
+NORM_API_LINKAGE
+bool NormWriteTraceRing(NormSessionHandle sessionHandle, const char* fileName);
+
 NORM_API_LINKAGE
 void NormSetTxLoss(NormSessionHandle sessionHandle, double percent);
 
@@ -427,6 +599,88 @@ void NormSetReportInterval(NormSessionHandle sessionHandle, double interval);
 NORM_API_LINKAGE
 double NormGetReportInterval(NormSessionHandle sessionHandle);
 
+// Statistics snapshots (the counts are cumulative since the session or
+// remote sender was created), gathered regardless of the debug level and
+// covering what the periodic REPORT log output shows
+typedef struct
+{
+    NormSize    txBytes;         // NORM messages sent
+    NormSize    txSegments;      // NORM_DATA (source and parity) sent
+    NormSize    txRepairBytes;   // NORM_DATA repair retransmissions
+    NormSize    nacksReceived;
+    double      txRate;          // current tx (or cc) rate, bits/sec
+    double      grtt;            // advertised GRTT, sec
+    bool        ccEnabled;
+    NormSize    rxSocketDrops;   // datagrams dropped by a full rx socket buffer
+    NormSize    rxAuthFailures;  // messages dropped by NormSetAeadKey() checks
+} NormSessionStats;
+
+typedef struct
+{
+    NormSize    rxBytes;         // all messages received from the sender
+    NormSize    rxGoodputBytes;  // object data (incl. FEC recovered)
+    NormSize    rxSegments;      // NORM_DATA received
+    NormSize    fecDecodes;      // blocks FEC decoded
+    NormSize    nacksSent;
+    NormSize    nacksSuppressed;
+    NormSize    objectsCompleted;
+    NormSize    objectsPending;
+    NormSize    objectsFailed;
+    NormSize    resyncs;
+    NormSize    bufferPeak;          // FEC buffer usage, bytes
+    NormSize    bufferOverruns;
+    NormSize    streamBufferPeak;    // stream buffer usage, bytes
+    NormSize    streamBufferOverruns;
+    double      grtt;            // GRTT estimate, sec
+    double      loss;            // loss estimate fraction
+    double      senderRate;      // sender advertised rate, bits/sec
+} NormNodeStats;
+
+NORM_API_LINKAGE
+bool NormGetSessionStats(NormSessionHandle sessionHandle,
+                         NormSessionStats* stats);
+
+NORM_API_LINKAGE
+bool NormNodeGetStats(NormNodeHandle remoteSender,
+                      NormNodeStats* stats);
+
+// Optional latency histograms (log-linear, values within ~6%), recorded
+// once enabled for a session: tx object enqueue to first transmission by
+// the session, and for each remote sender the time from an object's first
+// message to its completion, from a NACK (sent or suppressed) to the first
+// repair received, and inline FEC block decode time
+typedef enum NormLatencyType
+{
+    NORM_LATENCY_OBJECT,    // first message to object complete
+    NORM_LATENCY_REPAIR,    // NACK to repair received
+    NORM_LATENCY_DECODE     // FEC decode
+} NormLatencyType;
+
+typedef struct
+{
+    NormSize    count;
+    double      min;    // (all in seconds)
+    double      mean;
+    double      p50;
+    double      p90;
+    double      p99;
+    double      p999;
+    double      max;
+} NormLatencyStats;
+
+NORM_API_LINKAGE
+void NormSetLatencyStats(NormSessionHandle sessionHandle,
+                         bool              enable);
+
+NORM_API_LINKAGE
+bool NormGetTxLatencyStats(NormSessionHandle sessionHandle,
+                           NormLatencyStats* stats);
+
+NORM_API_LINKAGE
+bool NormNodeGetLatencyStats(NormNodeHandle    remoteSender,
+                             NormLatencyType   latencyType,
+                             NormLatencyStats* stats);
+
 /** NORM Sender Functions */
 
 NORM_API_LINKAGE
@@ -448,6 +702,24 @@ bool NormStartSender(NormSessionHandle  sessionHandle,
 NORM_API_LINKAGE
 void NormStopSender(NormSessionHandle sessionHandle);
 
+// Selects the codec used when NormStartSender() is called with "fecId" = 129.
+// The default "instanceId" of zero is Reed-Solomon (up to 255 segments per block)
+// and NORM_FEC_INSTANCE_LDPC is an LDPC-Staircase code for large (up to 65535
+// segment) blocks.  This must be called before NormStartSender().
+#define NORM_FEC_INSTANCE_LDPC 3
+
+NORM_API_LINKAGE
+void NormSetTxFecInstanceId(NormSessionHandle sessionHandle,
+                            UINT16            instanceId);
+
+// Sets the number of worker threads used to compute FEC parity for data
+// and file objects ahead of transmission, off of the protocol thread.
+// Zero (the default) computes parity inline.  This must be called before
+// NormStartSender().
+NORM_API_LINKAGE
+void NormSetTxFecWorkerCount(NormSessionHandle sessionHandle,
+                             unsigned int      count);
+
 NORM_API_LINKAGE
 void NormSetTxRate(NormSessionHandle sessionHandle,
                    double            bitsPerSecond);
@@ -458,6 +730,13 @@ NORM_API_LINKAGE
 bool NormSetTxSocketBuffer(NormSessionHandle sessionHandle,
                            unsigned int      bufferSize);
 
+// Sizes the socket buffers, the tx cache size bound and tx streams opened with
+// a zero "bufferSize" from the bandwidth-delay product as it changes (sizes
+// set explicitly are kept as lower bounds)
+NORM_API_LINKAGE
+void NormSetAutoTune(NormSessionHandle sessionHandle,
+                     bool              enable);
+
 NORM_API_LINKAGE
 void NormSetFlowControl(NormSessionHandle sessionHandle,
                         double            flowControlFactor);
@@ -467,21 +746,84 @@ void NormSetCongestionControl(NormSessionHandle sessionHandle,
                               bool              enable,
                               bool              adjustRate DEFAULT(true));
 
+// Selects the rate control used when NormSetCongestionControl() is enabled.
+// NORM_CC_BBR paces at the estimated bottleneck bandwidth of the current
+// limiting receiver (from its feedback), cycling the rate to probe for
+// more bandwidth and backing off to measure the min RTT, as in BBR.  This
+// keeps throughput high without the standing queue loss-based NORM-CC can
+// build on deep-buffered paths.  Receivers need no changes.
+NORM_API_LINKAGE
+void NormSetCCMode(NormSessionHandle sessionHandle,
+                   NormCCMode        ccMode);
+
+// When enabled, the sender limits the new data it has "in flight" (sent,
+// but not yet covered by a completed watermark acknowledgement from the
+// acking nodes) to a window sized from the measured delivery rate and
+// ACK cycle time, setting its own watermarks while the application has
+// none pending (no TX_WATERMARK_COMPLETED is posted for those).  The tx
+// rate then serves as the peak pacing rate, so it can be set high without
+// overrunning the receivers.  Has no effect without acking nodes.
+NORM_API_LINKAGE
+void NormSetTxWindow(NormSessionHandle sessionHandle,
+                     bool              enable);
+
+// Setting a transmit weight (for objects enqueued afterwards, or for a given
+// object) switches the sender from sending objects strictly in order to a
+// weighted round robin that interleaves the pending objects, each sending
+// up to "weight" segments per turn (objects default to a weight of 1).
+// Small urgent objects then need not wait behind a large file.
+NORM_API_LINKAGE
+void NormSetDefaultTxWeight(NormSessionHandle sessionHandle,
+                            unsigned int      weight);
+
+NORM_API_LINKAGE
+void NormObjectSetTxWeight(NormObjectHandle objectHandle,
+                           unsigned int     weight);
+
 NORM_API_LINKAGE
 void NormSetTxRateBounds(NormSessionHandle sessionHandle,
                          double            rateMin,
                          double            rateMax);
 
+// The session's relative share of the NormSetTxRateBudget() budget
+// (default 1.0)
+NORM_API_LINKAGE
+void NormSetTxRateWeight(NormSessionHandle sessionHandle,
+                         double            weight);
+
 NORM_API_LINKAGE
 void NormSetTxCacheBounds(NormSessionHandle sessionHandle,
                           NormSize          sizeMax,
                           UINT32            countMin,
                           UINT32            countMax);
 
+// Extends the tx cache with a "spill" tier of up to "countMax" objects and
+// "sizeMax" bytes kept in memory-mapped files under "directory": instead of
+// being purged when the NormSetTxCacheBounds() limits are reached, the oldest
+// NORM_OBJECT_DATA objects have their content copied there (and the
+// NORM_TX_OBJECT_PURGED event is posted so the application can free its
+// buffer) and remain repairable until the spill tier bounds purge them in turn
+// (with no further event).  Streams and files aren't spilled.  A NULL
+// "directory" disables the spill tier.  (Not yet supported on WIN32.)
+NORM_API_LINKAGE
+bool NormSetTxCacheSpill(NormSessionHandle sessionHandle,
+                         const char*       directory,
+                         NormSize          sizeMax,
+                         UINT32            countMax);
+
 NORM_API_LINKAGE
 void NormSetAutoParity(NormSessionHandle sessionHandle,
                        unsigned char     autoParity);
 
+// When enabled, the sender adjusts its auto parity (starting from any
+// NormSetAutoParity() value and bounded by the "numParity" given to
+// NormStartSender()) from the block erasure counts in received NACKs so
+// that about "targetRepairProb" of blocks need a NACK/repair round.
+NORM_API_LINKAGE
+void NormSetAutoParityAdaptive(NormSessionHandle sessionHandle,
+                               bool              enable,
+                               double            targetRepairProb DEFAULT(0.05));
+
 NORM_API_LINKAGE
 void NormSetGrttEstimate(NormSessionHandle sessionHandle,
                          double            grttEstimate);
@@ -514,16 +856,50 @@ NORM_API_LINKAGE
 void NormSetGroupSize(NormSessionHandle sessionHandle,
                       unsigned int      groupSize);
 
+// When enabled, the sender advertises its own estimate of the group size
+// (from the distinct receivers it hears feedback from, starting from any
+// NormSetGroupSize() value) so receiver NACK backoff tracks the group.
+NORM_API_LINKAGE
+void NormSetGroupSizeEstimation(NormSessionHandle sessionHandle,
+                                bool              enable);
+
+NORM_API_LINKAGE
+double NormGetGroupSizeEstimate(NormSessionHandle sessionHandle);
+
 NORM_API_LINKAGE
 void NormSetTxRobustFactor(NormSessionHandle sessionHandle,
                            int               robustFactor);
 
+// Flush piggybacking: the sender flags the final NORM_DATA of each object
+// (its last segment and auto parity) and of each flushed stream write so
+// receivers NACK trailing losses right away instead of after a
+// NORM_CMD(FLUSH), and the first flush after new data goes out as soon as
+// the tx queue empties.  Receivers need no configuration (older NORM
+// receivers ignore the flag).  Off by default.
+NORM_API_LINKAGE
+void NormSetTxFlushPiggyback(NormSessionHandle sessionHandle,
+                             bool              enable);
+
 NORM_API_LINKAGE
 NormObjectHandle NormFileEnqueue(NormSessionHandle sessionHandle,
                                  const char*       fileName,
                                  const char*       infoPtr DEFAULT((const char*)0),
                                  unsigned int      infoLen DEFAULT(0));
 
+// Packs the "fileCount" files of "fileList" into a single archive file
+// "archivePath" (see normArchive.h) and enqueues it as one NORM_OBJECT_FILE.
+// The "nameList" entries are the '/' delimited names the receiver unpacks
+// them as (NULL uses each file's base name).  The archive file must persist
+// until the object is purged.
+NORM_API_LINKAGE
+NormObjectHandle NormFileEnqueueArchive(NormSessionHandle sessionHandle,
+                                        const char*       archivePath,
+                                        const char**      fileList,
+                                        const char**      nameList,
+                                        unsigned int      fileCount,
+                                        const char*       infoPtr DEFAULT((const char*)0),
+                                        unsigned int      infoLen DEFAULT(0));
+
 NORM_API_LINKAGE
 NormObjectHandle NormDataEnqueue(NormSessionHandle sessionHandle,
                                  const char*       dataPtr,
@@ -531,6 +907,21 @@ NormObjectHandle NormDataEnqueue(NormSessionHandle sessionHandle,
                                  const char*       infoPtr DEFAULT((const char*)0),
                                  unsigned int      infoLen DEFAULT(0));
 
+// Scatter-gather NORM_OBJECT_DATA content (the buffers must remain valid
+// until the object is purged, just as with NormDataEnqueue())
+typedef struct
+{
+    const char*     dataPtr;
+    UINT32          dataLen;
+} NormDataVector;
+
+NORM_API_LINKAGE
+NormObjectHandle NormDataEnqueueV(NormSessionHandle     sessionHandle,
+                                  const NormDataVector* vecList,
+                                  unsigned int          vecCount,
+                                  const char*           infoPtr DEFAULT((const char*)0),
+                                  unsigned int          infoLen DEFAULT(0));
+
 NORM_API_LINKAGE
 bool NormRequeueObject(NormSessionHandle sessionHandle, NormObjectHandle objectHandle);
                                      
@@ -558,6 +949,15 @@ unsigned int NormStreamWrite(NormObjectHandle streamHandle,
                              const char*      buffer,
                              unsigned int     numBytes);
 
+NORM_API_LINKAGE
+char* NormStreamReserve(NormObjectHandle streamHandle,
+                        unsigned int*    numBytes);
+
+NORM_API_LINKAGE
+unsigned int NormStreamCommit(NormObjectHandle streamHandle,
+                              unsigned int     numBytes,
+                              bool             eom DEFAULT(false));
+
 NORM_API_LINKAGE
 void NormStreamFlush(NormObjectHandle streamHandle, 
                      bool             eom DEFAULT(false),
@@ -571,6 +971,59 @@ NORM_API_LINKAGE
 void NormStreamSetPushEnable(NormObjectHandle streamHandle, 
                              bool             pushEnable);
 
+// Small write coalescing: with a non-zero "maxDelay" (seconds, e.g. 200e-06),
+// auto flushes and NormStreamFlush() calls that would send a stream segment
+// holding fewer than "minFill" bytes (0 means a full segment) are deferred so
+// subsequent writes share the segment.  A held segment is sent once it fills
+// to "minFill" or "maxDelay" after it was first held.  A zero "maxDelay"
+// disables coalescing (sending any held segment).
+NORM_API_LINKAGE
+bool NormStreamSetCoalescing(NormObjectHandle streamHandle,
+                             double           maxDelay,
+                             unsigned short   minFill DEFAULT(0));
+
+// Stream event coalescing: once a session stream posts a NORM_TX_QUEUE_VACANCY
+// or NORM_RX_OBJECT_UPDATED ("eventType") event, the next one is held until
+// "minInterval" seconds have passed or, if "threshold" is non-zero, that many
+// segments have been sent (vacancy) or received (update) meanwhile, whichever
+// comes first.  NormStreamGetEventCount() gives the number of vacancies or
+// updates the last such event stood for.  A zero "minInterval" (the default)
+// posts them immediately.
+NORM_API_LINKAGE
+bool NormSetEventCoalescing(NormSessionHandle sessionHandle,
+                            NormEventType     eventType,
+                            unsigned int      threshold,
+                            double            minInterval);
+
+NORM_API_LINKAGE
+unsigned int NormStreamGetEventCount(NormObjectHandle streamHandle,
+                                     NormEventType    eventType);
+
+// Sliding window repair: after every "interval" source segments the sender
+// stream also sends a repair segment coded (over GF(2^8), in the spirit of
+// RFC 8681) from up to the last "window" source segments of the current FEC
+// block, so receivers recover isolated losses within a few packets without a
+// NACK round trip or waiting for the block's parity.  The repair overhead is
+// 1/"interval" of the stream rate.  Receivers need no configuration (older
+// NORM receivers ignore them).  A zero "window" disables.
+NORM_API_LINKAGE
+bool NormStreamSetWindowRepair(NormObjectHandle streamHandle,
+                               unsigned short   window,
+                               unsigned short   interval);
+
+// Stream sync points: after every "interval" source segments the sender
+// stream tags its next NORM_DATA with the block/segment/offset of the latest
+// message start it has sent (a 12 byte header extension).  A late joining
+// receiver that hasn't read yet starts at that message (having its earlier
+// blocks repaired) instead of waiting for the next message to begin, and one
+// seeking a message start after a broken stream moves straight to it.  An
+// "interval" of about the segments sent per GRTT bounds the wait to a GRTT.
+// Receivers need no configuration (older NORM receivers ignore it).  Zero
+// (the default) disables.
+NORM_API_LINKAGE
+bool NormStreamSetSyncInterval(NormObjectHandle streamHandle,
+                               unsigned short   interval);
+
 NORM_API_LINKAGE
 bool NormStreamHasVacancy(NormObjectHandle streamHandle);
 
@@ -592,6 +1045,20 @@ bool NormSetWatermarkEx(NormSessionHandle  sessionHandle,
                         unsigned int       numBytes,
                         bool               overrideFlush DEFAULT(false));
 
+// Unlike NormSetWatermark(), this does not cancel a pending watermark, so
+// ACK collection can go on for several watermarks at once (e.g., one per
+// flow control threshold of a stream) instead of waiting a round trip
+// for each.  Each completes with its own NORM_TX_WATERMARK_COMPLETED
+// notification, in order.  For the older ones, the event "object" is the
+// watermark object and the notification is only posted upon success; a
+// failure is reported with the newest watermark's completion as usual (so
+// NormGetAckingStatus() reflects the newest watermark).  Added watermarks
+// carry no NormSetWatermarkEx() content.  Up to 16 older watermarks may be
+// pending, after which this returns false.
+NORM_API_LINKAGE
+bool NormAddWatermark(NormSessionHandle  sessionHandle,
+                      NormObjectHandle   objectHandle,
+                      bool               overrideFlush DEFAULT(false));
 
 NORM_API_LINKAGE
 bool NormResetWatermark(NormSessionHandle sessionHandle);
@@ -607,6 +1074,16 @@ NORM_API_LINKAGE
 void NormRemoveAckingNode(NormSessionHandle  sessionHandle,
                           NormNodeId         nodeId);
 
+// ACK aggregation for large acking node sets: the sender's watermark
+// requests for "nodeId" list its "aggregatorId" receiver instead (except
+// on the last request attempt), and the aggregator's ACK lists the nodes
+// whose ACKs it has collected.  The aggregator is made an acking node if
+// it isn't one.  Use NORM_NODE_NONE to have "nodeId" ACK directly again.
+NORM_API_LINKAGE
+bool NormSetAckingNodeAggregator(NormSessionHandle  sessionHandle,
+                                 NormNodeId         nodeId,
+                                 NormNodeId         aggregatorId);
+
 NORM_API_LINKAGE
 NormNodeHandle NormGetAckingNodeHandle(NormSessionHandle  sessionHandle,
                                        NormNodeId         nodeId);
@@ -655,10 +1132,101 @@ NORM_API_LINKAGE
 void NormSetRxCacheLimit(NormSessionHandle sessionHandle,
                          unsigned short    countMax);
 
+// Sets the receive buffer space and cache limit (see NormStartReceiver() and
+// NormSetRxCacheLimit()) for remote senders whose NormNodeId matches
+// "senderId" under "idMask" (NORM_NODE_ANY for a single sender, fewer mask 
+// bits for a class of senders).  The matching quota with the most mask bits
+// applies, zero values keep the session default and zero for both removes
+// the quota.  Quotas take effect for senders as they are (re)synchronized.
+NORM_API_LINKAGE 
+bool NormSetRxSenderQuota(NormSessionHandle sessionHandle,
+                          NormNodeId        senderId,
+                          NormNodeId        idMask,
+                          unsigned long     bufferSpace,
+                          unsigned short    cacheMax);
+
+NORM_API_LINKAGE
+void NormSetFileMapping(NormSessionHandle sessionHandle,
+                        bool              enable);
+
+NORM_API_LINKAGE
+bool NormSetFileIoWorkerCount(NormSessionHandle sessionHandle,
+                              unsigned int      count);
+
+NORM_API_LINKAGE
+bool NormSetRxFileJournal(NormSessionHandle sessionHandle,
+                          const char*       dirPath);
+
+NORM_API_LINKAGE
+bool NormSetTxParityCache(NormSessionHandle sessionHandle,
+                          unsigned long     byteMax);
+
+NORM_API_LINKAGE
+void NormSetTxDigest(NormSessionHandle sessionHandle,
+                     bool              enable);
+
+NORM_API_LINKAGE
+void NormSetBufferSlabMode(NormSessionHandle sessionHandle,
+                           bool              enable,
+                           bool              hugePages DEFAULT(false),
+                           int               numaNode DEFAULT(-1));
+
+NORM_API_LINKAGE
+void NormSetRxDecoderCacheSize(NormSessionHandle sessionHandle,
+                               unsigned int      countMax);
+
+NORM_API_LINKAGE
+void NormSetRxFecWorkerCount(NormSessionHandle sessionHandle,
+                             unsigned int      count);
+
 NORM_API_LINKAGE
 bool NormSetRxSocketBuffer(NormSessionHandle sessionHandle,
                            unsigned int      bufferSize);
 
+NORM_API_LINKAGE
+bool NormSetRxBatchSize(NormSessionHandle sessionHandle,
+                        unsigned int      batchSize);
+
+// Uses kernel receive timestamps for GRTT and congestion control RTT
+// measurement so application/dispatch latency doesn't inflate them
+NORM_API_LINKAGE
+bool NormSetRxTimestamps(NormSessionHandle sessionHandle,
+                         bool              enable);
+
+// Datagrams dropped by a full rx socket buffer (where the kernel reports
+// them, e.g. Linux) are logged, counted in NormSessionStats and post one
+// NORM_RX_SOCKET_OVERFLOW until the app gets it.  With "excuse" set, the
+// sequence gaps they leave are not counted as network loss (so they don't
+// lower the congestion controlled rate of the senders we report to).
+NORM_API_LINKAGE
+void NormSetRxExcuseSocketDrops(NormSessionHandle sessionHandle,
+                                bool              excuse);
+
+// Authenticates and encrypts all session messages (ChaCha20-Poly1305, RFC
+// 8439) with a 32 byte "key" shared by the group (a NULL key disables it).
+// NORM headers are authenticated but left clear, and 24 bytes are added
+// to each message, so the segment size should be reduced accordingly.
+// Messages that fail authentication are dropped (see NormSessionStats).
+// There is no replay protection: a recorded sealed message sent again is
+// accepted (NORM's own sequence and object state are all that limit it).
+NORM_API_LINKAGE
+bool NormSetAeadKey(NormSessionHandle sessionHandle,
+                    const char*       key,
+                    unsigned int      keyLength);
+
+NORM_API_LINKAGE
+bool NormSetTxBatchSize(NormSessionHandle sessionHandle,
+                        unsigned int      batchSize);
+
+NORM_API_LINKAGE
+bool NormSetTxZeroCopy(NormSessionHandle sessionHandle,
+                       bool              enable);
+
+NORM_API_LINKAGE
+bool NormSetTxTimePacing(NormSessionHandle sessionHandle,
+                         bool              enable,
+                         bool              taiClock DEFAULT(false));
+
 NORM_API_LINKAGE
 void NormSetSilentReceiver(NormSessionHandle sessionHandle,
                            bool              silent,
@@ -668,6 +1236,109 @@ NORM_API_LINKAGE
 void NormSetDefaultUnicastNack(NormSessionHandle sessionHandle,
                                bool              unicastNacks);
 
+// With "localTtl" non-zero, receivers first send their NACKs with that 
+// (site scoped) multicast TTL and a "repairer" receiver answers the
+// NACKs it hears from its own receive cache (with re-encoded parity when
+// it holds a whole block).  A NACK round not answered locally is followed
+// by a session scoped one.  This requires multicast (not unicast) NACKs.
+NORM_API_LINKAGE
+void NormSetLocalRepair(NormSessionHandle sessionHandle,
+                        unsigned char     localTtl,
+                        bool              repairer DEFAULT(false));
+
+// Receivers aggregated by the sender (see NormSetAckingNodeAggregator()) 
+// send the watermark ACKs requested via their aggregator to the 
+// aggregator's unicast "aggregatorAddr"/"aggregatorPort" (the port it 
+// receives on).  Use NORM_NODE_NONE to clear this.
+NORM_API_LINKAGE
+bool NormSetAckAggregator(NormSessionHandle sessionHandle,
+                          NormNodeId        aggregatorId,
+                          const char*       aggregatorAddr DEFAULT((const char*)0),
+                          UINT16            aggregatorPort DEFAULT(0));
+
+// An ACK aggregation enabled receiver collects those ACKs for the sender
+// watermark it is asked to ACK itself, holding its own ACK for a GRTT to
+// do so, and lists the receivers collected in its ACK.
+NORM_API_LINKAGE
+void NormSetAckAggregation(NormSessionHandle sessionHandle,
+                           bool              enable);
+
+// In progressive mode, NORM_RX_OBJECT_BLOCK_COMPLETED is posted for
+// DATA and FILE objects (received after it is set) as each FEC block
+// becomes complete, in whatever order blocks complete.  The app then
+// calls NormObjectGetCompletedBlock() until it returns false to get the
+// byte range (in the object) of each completed block.  (Note a FILE
+// object's data may still be in write buffers until the object is
+// completed, so this is mainly of use for DATA objects)
+NORM_API_LINKAGE
+void NormSetRxProgressive(NormSessionHandle sessionHandle,
+                          bool              enable);
+
+NORM_API_LINKAGE
+bool NormObjectGetCompletedBlock(NormObjectHandle objectHandle,
+                                 UINT32*          blockId,
+                                 NormSize*        offset,
+                                 NormSize*        length);
+
+// Cut-through relay: DATA objects received by "sessionHandle" are sent
+// by the "relaySession" sender (of the same NormInstance) as each FEC 
+// block is received instead of after the whole object is, and NACKs
+// from its receivers are answered from the received data.  Both must use
+// the same segment and block size.  The relay holds the received data
+// until its tx object is purged, so the app must not detach a relayed
+// object's data (NormDataDetachData()).  The relay's tx objects are not
+// the app's and post no NORM_TX_OBJECT_PURGED.  NORM_SESSION_INVALID
+// stops it.
+NORM_API_LINKAGE
+bool NormSetRelaySession(NormSessionHandle sessionHandle,
+                         NormSessionHandle relaySession);
+
+// Receive mirroring lets several local consumers share one receiver 
+// instead of each joining the sender with its own buffers and decoding.
+// The mirror is in-process only: the consumers are sessions of the same
+// NormInstance in one process, not other processes (it is not a
+// cross-process shared-memory mirror).
+// The "mirrorSession" (of the same NormInstance, and not started as a
+// receiver itself) gets a copy of each receive event of "primarySession"
+// with its own session handle but the primary's (shared) sender and 
+// object handles.  Mirrored objects are read-only; consumers must not
+// detach their data, and stream object events aren't mirrored since 
+// reading a stream consumes it.  NORM_SESSION_INVALID detaches a mirror.
+NORM_API_LINKAGE
+bool NormSetRxMirror(NormSessionHandle mirrorSession,
+                     NormSessionHandle primarySession);
+
+// Shared buffer pools let many sessions (e.g. the per-client sessions a
+// NormSocket server accepts) draw their sender and remote sender buffers
+// from one pool of "bufferSpace" bytes instead of each preallocating its
+// own.  NormSetBufferPool() creates the pool (sized as NormStartSender()
+// would) held by "poolSession" and NormShareBufferPool() lets "session" 
+// (of the same NormInstance) use it from its next NormStartSender() or 
+// new remote sender on, when the FEC block size (numData + numParity) 
+// matches and the segment size fits.  Stream objects keep their own 
+// buffers.  NORM_SESSION_INVALID reverts "session" to its own pools.
+NORM_API_LINKAGE
+bool NormSetBufferPool(NormSessionHandle poolSession,
+                       unsigned long     bufferSpace,
+                       UINT16            segmentSize,
+                       UINT16            numData,
+                       UINT16            numParity);
+
+NORM_API_LINKAGE
+bool NormShareBufferPool(NormSessionHandle session,
+                         NormSessionHandle poolSession);
+
+// Receive demultiplexing lets a (not yet started) unicast "session" 
+// receive the packets its "remoteNode" (a remote sender known to the
+// "listenerSession" of the same NormInstance) sends to the listener's
+// port, and send through the listener's socket, instead of opening its 
+// own connected socket.  One socket then serves all the clients of a 
+// NormSocket server.  Packets are matched by source address and port.
+NORM_API_LINKAGE
+bool NormSetRxDemux(NormSessionHandle session,
+                    NormSessionHandle listenerSession,
+                    NormNodeHandle    remoteNode);
+
 NORM_API_LINKAGE
 void NormNodeSetUnicastNack(NormNodeHandle   remoteSender,
                             bool             unicastNacks);
@@ -676,6 +1347,14 @@ NORM_API_LINKAGE
 void NormSetDefaultSyncPolicy(NormSessionHandle sessionHandle,
                               NormSyncPolicy    syncPolicy);
 
+NORM_API_LINKAGE
+void NormSetDefaultRxEvictionPolicy(NormSessionHandle  sessionHandle,
+                                    NormEvictionPolicy evictionPolicy);
+
+NORM_API_LINKAGE
+void NormNodeSetRxEvictionPolicy(NormNodeHandle     remoteSender,
+                                 NormEvictionPolicy evictionPolicy);
+
 NORM_API_LINKAGE
 void NormSetDefaultNackingMode(NormSessionHandle sessionHandle,
                                NormNackingMode   nackingMode);
@@ -712,14 +1391,51 @@ bool NormPreallocateRemoteSender(NormSessionHandle  sessionHandle,
                                  UINT16             numParity,
                                  unsigned int       streamBufferSize DEFAULT(0));
 
+NORM_API_LINKAGE
+bool NormPreallocateRemoteSenders(NormSessionHandle  sessionHandle,
+                                  unsigned int       count,
+                                  unsigned long      bufferSize,
+                                  UINT16             segmentSize, 
+                                  UINT16             numData, 
+                                  UINT16             numParity,
+                                  unsigned int       streamBufferSize DEFAULT(0));
+
+NORM_API_LINKAGE
+void NormSetMemoryPrefault(NormSessionHandle sessionHandle,
+                           bool              enable);
+
 NORM_API_LINKAGE
 bool NormStreamRead(NormObjectHandle   streamHandle,
                     char*              buffer,
                     unsigned int*      numBytes);
 
+NORM_API_LINKAGE
+bool NormStreamReadView(NormObjectHandle   streamHandle,
+                        const char**       buffer,
+                        unsigned int*      numBytes);
+
+NORM_API_LINKAGE
+bool NormStreamReadRelease(NormObjectHandle streamHandle,
+                           unsigned int     numBytes);
+
 NORM_API_LINKAGE
 bool NormStreamSeekMsgStart(NormObjectHandle streamHandle);
 
+// Reads one whole message (as delimited by the sender's NormStreamMarkEom()
+// or "eom" writes) into "buffer" once all of it has been received.  On
+// return, "*msgLen" is the message length, or zero if no complete message
+// is ready yet.  If the message is larger than the "*msgLen" buffer size
+// given, nothing is read and "*msgLen" says how large a buffer is needed.
+// A false return means the stream broke (messages were lost).  The next
+// call then skips ahead to the next message start.  The end of the latest
+// message is only known once the next message (or stream end) arrives.
+// (A sender never starts two messages in one segment, so short messages
+// each take at least a segment of their own.)
+NORM_API_LINKAGE
+bool NormStreamReadMsg(NormObjectHandle   streamHandle,
+                       char*              buffer,
+                       unsigned int*      msgLen);
+
 NORM_API_LINKAGE
 UINT32 NormStreamGetReadOffset(NormObjectHandle streamHandle);
 
@@ -766,6 +1482,18 @@ NORM_API_LINKAGE
 bool NormFileRename(NormObjectHandle   fileHandle,
                     const char*        fileName);
 
+// True if a (received) file object is an archive from NormFileEnqueueArchive()
+// (a received file is closed by these calls, so use them only once it is
+//  NORM_RX_OBJECT_COMPLETED)
+NORM_API_LINKAGE
+bool NormFileIsArchive(NormObjectHandle fileHandle);
+
+// Unpacks a completed archive file object's files under directory "dirPath"
+// and returns how many were extracted (the archive file itself is left alone)
+NORM_API_LINKAGE
+unsigned int NormFileUnpackArchive(NormObjectHandle   fileHandle,
+                                   const char*        dirPath);
+
 NORM_API_LINKAGE
 const char* NormDataAccessData(NormObjectHandle objectHandle);
 
@@ -801,6 +1529,11 @@ const void* NormNodeGetUserData(NormNodeHandle nodeHandle);
 NORM_API_LINKAGE
 double NormNodeGetGrtt(NormNodeHandle remoteSender);
 
+NORM_API_LINKAGE
+bool NormNodeGetDecoderCacheStats(NormNodeHandle remoteSender,
+                                  unsigned long* hitCount,
+                                  unsigned long* missCount);
+
 
 NORM_API_LINKAGE
 bool NormNodeGetCommand(NormNodeHandle remoteSender,
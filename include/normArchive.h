@@ -0,0 +1,98 @@
+#ifndef _NORM_ARCHIVE
+#define _NORM_ARCHIVE
+
+#include "normFile.h"
+
+// The NormArchiveWriter packs many (typically small) files into a single
+// file that is sent as one NORM_OBJECT_FILE so the per-object overhead
+// (FTI, INFO, watermarks, tx cache and object table slots) is paid once
+// per batch instead of once per file.  The NormArchiveReader unpacks a
+// received archive.
+//
+// Archive layout (all integers in network byte order):
+//
+//   "NORMARC1" magic (8 bytes)
+//   file content, back to back
+//   index:  {offset (8), size (8), nameLen (2), name (nameLen)} per file
+//   trailer:  index offset (8), file count (4), "NORMARC1" magic (8)
+//
+// Names are relative paths with '/' delimiters (as for NORM_INFO file names).
+
+class NormArchiveWriter
+{
+    public:
+        NormArchiveWriter();
+        ~NormArchiveWriter();
+
+        bool Open(const char* path);
+        // Creates the archive as a new temporary file, copying its path to
+        // "pathBuffer" (which should be PATH_MAX long!)
+        bool OpenTemp(char* pathBuffer);
+        bool IsOpen() const
+            {return file.IsOpen();}
+        // Appends the content of file "path" as entry "name"
+        bool AddFile(const char* path, const char* name);
+        // Writes the index and trailer
+        bool Close();
+        // Closes and removes an incomplete archive
+        void Abort();
+
+        unsigned int GetCount() const
+            {return file_count;}
+        NormFile::Offset GetSize() const
+            {return (offset + index_len + TRAILER_SIZE);}
+
+        static const char MAGIC[8];
+        enum {TRAILER_SIZE = 20};
+
+    private:
+        NormFile            file;
+        char                file_path[PATH_MAX];
+        NormFile::Offset    offset;       // where the next entry's content goes
+        unsigned int        file_count;
+        char*               index_buffer; // (written after the content)
+        unsigned int        index_len;
+        unsigned int        index_max;
+};  // end class NormArchiveWriter
+
+class NormArchiveReader
+{
+    public:
+        NormArchiveReader();
+        ~NormArchiveReader();
+
+        static bool IsArchive(const char* path);
+        bool Open(const char* path);
+        void Close();
+        unsigned int GetCount() const
+            {return file_count;}
+
+        // Gets the next entry's (NUL-terminated) name ("buffer" should be
+        // PATH_MAX long!) and content size
+        bool GetNextEntry(char* nameBuffer, NormFile::Offset& size);
+        // Writes the content of the entry last returned by GetNextEntry()
+        // to a new file "path"
+        bool Extract(const char* path);
+        // Extracts each entry under directory "dirPath" and returns how
+        // many were (entries with absolute or ".." names are skipped)
+        unsigned int ExtractAll(const char* dirPath);
+
+        // A received name is safe to extract if it is relative and
+        // has no ".." components
+        static bool IsSafeName(const char* name);
+        // Builds "dirPath" + "name" with '/' converted to native delimiters
+        static bool MakePath(char* pathBuffer, const char* dirPath, const char* name);
+
+    private:
+        enum {INDEX_MAX = 64*1024*1024};  // limits what we'll buffer
+        NormFile            file;
+        NormFile::Offset    index_offset;
+        unsigned int        file_count;
+        char*               index_buffer;
+        unsigned int        index_len;
+        unsigned int        index_pos;    // next entry in "index_buffer"
+        NormFile::Offset    entry_offset; // (last entry returned)
+        NormFile::Offset    entry_size;
+};  // end class NormArchiveReader
+
+#endif // _NORM_ARCHIVE
@@ -0,0 +1,91 @@
+#ifndef _NORM_BITMASK
+#define _NORM_BITMASK
+
+#include "protokit.h"
+
+// The NormBitmask is a fixed size bit mask kept in 64-bit words for the
+// per-block segment "pending_mask" and "repair_mask".  It provides the
+// subset of the ProtoBitmask interface NormBlock uses, but set bit
+// searches, range set/unset and the mask combining operations work a
+// word at a time (with a count trailing zeros instruction where the
+// compiler provides one) instead of bit (or byte) at a time.  It also
+// adds GetNextRun() so repair request building can step through runs of
+// consecutive set bits instead of individual bits.
+
+class NormBitmask
+{
+    public:
+        NormBitmask();
+        ~NormBitmask();
+
+        bool Init(UINT32 numBits);
+        void Destroy();
+        // Attach() uses a caller provided "buffer" of GetWordCount(numBits)
+        // words instead of allocating one.  The caller must Detach() it
+        // (instead of Destroy()) before freeing the buffer.
+        static UINT32 GetWordCount(UINT32 numBits)
+        {
+            UINT32 numWords = (numBits + WORD_MASK) >> WORD_SHIFT;
+            return ((0 != numWords) ? numWords : 1);
+        }
+        void Attach(UINT64* buffer, UINT32 numBits);
+        void Detach()
+        {
+            mask = NULL;
+            num_bits = num_words = 0;
+        }
+        UINT32 GetSize() const
+            {return num_bits;}
+
+        bool IsSet() const;
+        bool Test(UINT32 index) const
+        {
+            return ((index < num_bits) &&
+                    (0 != (mask[index >> WORD_SHIFT] & ((UINT64)1 << (index & WORD_MASK)))));
+        }
+        void Clear();
+        bool Set(UINT32 index);
+        bool Unset(UINT32 index);
+        bool SetBits(UINT32 index, UINT32 count);
+        bool UnsetBits(UINT32 index, UINT32 count);
+
+        // These search from "index" (inclusive) and return false if none found
+        bool GetFirstSet(UINT32& index) const
+        {
+            index = 0;
+            return GetNextSet(index);
+        }
+        bool GetNextSet(UINT32& index) const;
+        bool GetNextUnset(UINT32& index) const;
+        // Finds next run of consecutive set bits at or after "index"
+        bool GetNextRun(UINT32& index, UINT32& count) const;
+        UINT32 Count() const;   // number of set bits
+
+        void Add(const NormBitmask& b);     // this = this | b
+        void Xor(const NormBitmask& b);     // this = this ^ b
+        void XCopy(const NormBitmask& b);   // this = b & ~this
+
+        void Display(FILE* stream) const;
+
+    private:
+        enum
+        {
+            WORD_SHIFT = 6,
+            WORD_BITS  = 1 << WORD_SHIFT,
+            WORD_MASK  = WORD_BITS - 1
+        };
+
+        static unsigned int FirstSetBit(UINT64 word);  // (word must be nonzero)
+        UINT64 LastWordMask() const
+        {
+            unsigned int extra = num_bits & WORD_MASK;
+            return (0 != extra) ? (((UINT64)1 << extra) - 1) : ~((UINT64)0);
+        }
+
+        UINT64* mask;
+        UINT32  num_bits;
+        UINT32  num_words;
+
+};  // end class NormBitmask
+
+#endif // _NORM_BITMASK
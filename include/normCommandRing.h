@@ -0,0 +1,66 @@
+#ifndef _NORM_COMMAND_RING
+#define _NORM_COMMAND_RING
+
+#include "protokit.h"
+
+#ifndef WIN32
+#include <pthread.h>
+#endif // !WIN32
+
+// The NormCommandRing lets API threads hand "fire and forget" commands
+// (ones with no result for the caller, like a stream flush) to the NORM
+// protocol thread without suspending it.  Commands are copied into a
+// fixed size ring under a short mutex that is never held while protocol
+// work is done.  The protocol thread is woken by an eventfd (or pipe on
+// other UNIX systems) installed as a ProtoChannel and drains the ring
+// from its dispatch loop.  Post() fails if the ring is full (or not
+// open, e.g. on WIN32) so the caller can run the command synchronously.
+// The command "type" and fields are interpreted by the ring's user.
+
+class NormCommandRing : public ProtoChannel
+{
+    public:
+        NormCommandRing();
+        ~NormCommandRing();
+
+        enum {DEFAULT_SIZE = 256};
+        struct Command
+        {
+            int             type;
+            void*           handle;
+            double          value;
+            int             param;
+            bool            flag;
+        };
+
+        // (set the ProtoChannel notifier and listener first)
+        bool Open(unsigned int numCommands = DEFAULT_SIZE);
+        void Close();
+
+        bool Post(const Command& cmd);  // (any thread)
+        bool Get(Command& cmd);         // (protocol thread, or while suspended)
+        // This is an unlocked hint, but it is exact for commands the
+        // calling thread itself posted
+        bool IsEmpty() const
+            {return (0 == count);}
+        // Clears the wake up descriptor (protocol thread, before Get()s)
+        void Reset();
+
+    private:
+        void Lock();
+        void Unlock();
+
+        Command*            ring;
+        unsigned int        size;
+        unsigned int        head;   // next command to Get()
+        unsigned int        count;
+#ifdef WIN32
+        CRITICAL_SECTION    mutex;
+#else
+        int                 wake_fd[2];  // (both are the same eventfd on Linux)
+        pthread_mutex_t     mutex;
+#endif // if/else WIN32
+
+};  // end class NormCommandRing
+
+#endif // _NORM_COMMAND_RING
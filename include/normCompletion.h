@@ -0,0 +1,106 @@
+#ifndef _NORM_COMPLETION
+#define _NORM_COMPLETION
+
+#include "normApi.h"          // for NormNodeId
+#include "normPostProcess.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif // if/else WIN32
+
+// The NormCompletionPool lets a NORM file receiver application (e.g. normCast)
+// hand the work that follows a file's reception (archive unpacking, aborted file
+// removal and NormPostProcessor commands) to a set of worker threads so the
+// thread collecting NORM API events is never held up by it (and NORM's receive
+// buffers keep being drained meanwhile).  Jobs are assigned to workers by sender
+// so each sender's files are finished in the order they were received while
+// different senders' files are finished in parallel.  Note only the archive
+// unpacking and file removal run in parallel: the NormPostProcessor manages a
+// single post processing command (process) at a time, so PROCESS jobs' calls
+// to its ProcessFile() are serialized across all workers.  (This is an app
+// helper built with normCast/normCastApp alongside normPostProcess.cpp, not
+// part of the NORM library.)
+
+class NormCompletionPool
+{
+    public:
+        NormCompletionPool();
+        ~NormCompletionPool();
+
+        enum Action
+        {
+            PROCESS,    // run the post processor (if enabled) on the file
+            UNPACK,     // unpack an archive file and remove it
+            REMOVE      // remove the (e.g. aborted) file
+        };
+
+        // "unpackPath" is the directory archives are unpacked under
+        bool Init(unsigned int          numWorkers,
+                  NormPostProcessor*    postProcessor,
+                  const char*           unpackPath = NULL);
+        // Finishes all queued jobs and stops the worker threads
+        void Destroy();
+        bool IsActive() const
+            {return (0 != worker_count);}
+
+        bool Submit(NormNodeId senderId, Action action, const char* path);
+
+        // Number of jobs queued or in progress
+        unsigned int GetPendingCount();
+
+    private:
+        struct Job
+        {
+            Action          action;
+            char            path[PATH_MAX];
+            Job*            next;
+        };
+        struct Worker
+        {
+            NormCompletionPool* pool;
+            Job*                queue_head;
+            Job*                queue_tail;
+#ifdef WIN32
+            HANDLE              thread;
+            CONDITION_VARIABLE  cond;
+#else
+            pthread_t           thread;
+            pthread_cond_t      cond;
+#endif // if/else WIN32
+            bool                started;
+        };
+
+        void Run(Worker& worker);
+        void DoJob(const Job& job);
+#ifdef WIN32
+        static DWORD WINAPI DoWorker(LPVOID param);
+#else
+        static void* DoWorker(void* param);
+#endif // if/else WIN32
+
+        void Lock();
+        void Unlock();
+        void Wait(Worker& worker);  // (called with lock held)
+        void Signal(Worker& worker);
+        void LockProcessor();
+        void UnlockProcessor();
+
+        Worker*             worker_list;
+        unsigned int        worker_count;
+        unsigned int        pending_count;
+        NormPostProcessor*  post_processor;
+        char                unpack_path[PATH_MAX];
+        bool                stopping;
+#ifdef WIN32
+        CRITICAL_SECTION    mutex;
+        CRITICAL_SECTION    processor_mutex;  // serializes post_processor use
+#else
+        pthread_mutex_t     mutex;
+        pthread_mutex_t     processor_mutex;  // serializes post_processor use
+#endif // if/else WIN32
+
+};  // end class NormCompletionPool
+
+#endif // _NORM_COMPLETION
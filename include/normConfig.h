@@ -0,0 +1,66 @@
+#ifndef _NORM_CONFIG
+#define _NORM_CONFIG
+
+// Compile-time limits on NORM's memory use.  The defaults suit hosts with
+// memory to spare.  The low-footprint build profile (NORM_EMBEDDED, see
+// BUILD.TXT) lowers them for small (e.g. ARM) targets, and each can also be
+// set on its own with -D<name>=<value>:
+//
+//   NORM_MSG_SIZE_MAX       - largest NormMsg (also the size of each socket
+//                             receive buffer and NormMsgBatch slot)
+//   NORM_MSG_INLINE_SIZE    - NormMsg buffer size unless grown for larger
+//                             segments (must be <= NORM_MSG_SIZE_MAX)
+//   NORM_SEGMENT_SIZE_MAX   - largest segment size a session sends or
+//                             accepts from a remote sender
+//   NORM_BLOCK_SIZE_MAX     - largest FEC block (numData + numParity) sent
+//                             or accepted
+//   NORM_OBJECT_TABLE_SIZE  - default NormObjectTable (tx and per remote
+//                             sender rx object table) ring size
+//   NORM_NO_TRACE           - compiles out the message trace (PLOG "trace>"
+//                             lines and the binary trace ring)
+//
+// The optional codecs are left out of the build with NORM_NO_RS16 and
+// NORM_NO_LDPC (which the build files also use to drop their sources).
+
+#ifdef NORM_EMBEDDED
+#ifndef NORM_MSG_SIZE_MAX
+#define NORM_MSG_SIZE_MAX 2560  // (NormMsg::HEADER_MAX plus a 1400 byte segment)
+#endif // !NORM_MSG_SIZE_MAX
+#ifndef NORM_MSG_INLINE_SIZE
+#define NORM_MSG_INLINE_SIZE 2560
+#endif // !NORM_MSG_INLINE_SIZE
+#ifndef NORM_SEGMENT_SIZE_MAX
+#define NORM_SEGMENT_SIZE_MAX 1400
+#endif // !NORM_SEGMENT_SIZE_MAX
+#ifndef NORM_BLOCK_SIZE_MAX
+#define NORM_BLOCK_SIZE_MAX 128
+#endif // !NORM_BLOCK_SIZE_MAX
+#ifndef NORM_OBJECT_TABLE_SIZE
+#define NORM_OBJECT_TABLE_SIZE 64
+#endif // !NORM_OBJECT_TABLE_SIZE
+#ifndef NORM_NO_TRACE
+#define NORM_NO_TRACE
+#endif // !NORM_NO_TRACE
+#endif // NORM_EMBEDDED
+
+#ifndef NORM_MSG_SIZE_MAX
+#define NORM_MSG_SIZE_MAX 65536
+#endif // !NORM_MSG_SIZE_MAX
+#ifndef NORM_MSG_INLINE_SIZE
+#define NORM_MSG_INLINE_SIZE 4096
+#endif // !NORM_MSG_INLINE_SIZE
+#ifndef NORM_SEGMENT_SIZE_MAX
+#define NORM_SEGMENT_SIZE_MAX 65535
+#endif // !NORM_SEGMENT_SIZE_MAX
+#ifndef NORM_BLOCK_SIZE_MAX
+#define NORM_BLOCK_SIZE_MAX 65535
+#endif // !NORM_BLOCK_SIZE_MAX
+#ifndef NORM_OBJECT_TABLE_SIZE
+#define NORM_OBJECT_TABLE_SIZE 256
+#endif // !NORM_OBJECT_TABLE_SIZE
+
+#if (NORM_MSG_INLINE_SIZE > NORM_MSG_SIZE_MAX)
+#error "NORM_MSG_INLINE_SIZE must not exceed NORM_MSG_SIZE_MAX"
+#endif
+
+#endif // _NORM_CONFIG
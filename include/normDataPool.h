@@ -0,0 +1,83 @@
+#ifndef _NORM_DATA_POOL
+#define _NORM_DATA_POOL
+
+#include "protokit.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif // if/else WIN32
+
+// The NormDataPool provides the buffers for received NORM_OBJECT_DATA
+// content so that high rates of small objects don't each cost a heap
+// allocation.  Buffers are rounded up to power-of-two size classes and
+// freed buffers are kept on per-class free lists (up to a "cache limit"
+// of bytes) for reuse.  The application may also donate memory "regions"
+// (e.g., hugepage, RDMA-registered or pinned memory) that buffers are
+// carved from before the heap is used.  Region memory is never freed by
+// the pool, so it must remain valid until the pool is gone.
+//
+// Each buffer is preceded by a small header pointing back to its pool so
+// the static Free() can be used as a NormDataObject free function and
+// buffers may be freed from any thread.  Destroy() marks the pool for
+// deletion once any buffers still held (e.g., detached by the app) are
+// freed.
+
+class NormDataPool
+{
+    public:
+        NormDataPool();
+
+        enum
+        {
+            CLASS_MIN_SHIFT = 6,    // smallest size class is 64 bytes
+            CLASS_MAX_SHIFT = 24,   // largest size class is 16 MBytes
+            CLASS_COUNT     = CLASS_MAX_SHIFT - CLASS_MIN_SHIFT + 1,
+            HEADER_SIZE     = 64    // (keeps buffers cache line aligned)
+        };
+
+        void SetCacheLimit(size_t numBytes);
+        size_t GetCacheLimit() const
+            {return cache_limit;}
+        // Adds app-supplied memory to carve buffers from (replacing any
+        // earlier region, after which the rest of that region is unused)
+        bool AddRegion(char* region, size_t regionSize);
+
+        char* Alloc(size_t size);
+        static void Free(char* buffer);
+
+        void Destroy();
+
+    private:
+        ~NormDataPool();
+
+        class Header
+        {
+            public:
+                NormDataPool*   pool;
+                char*           base;        // heap allocation (NULL if region)
+                Header*         next;        // for free list
+                unsigned int    size_class;  // (CLASS_COUNT if oversize)
+        };
+
+        void Return(Header* header);
+        void Lock();
+        void Unlock();
+
+        Header*             free_list[CLASS_COUNT];
+        size_t              cache_limit;
+        size_t              cache_bytes;    // of cached heap buffers
+        char*               region_ptr;     // unused part of current region
+        size_t              region_len;
+        unsigned long       outstanding;    // buffers allocated and not freed
+        bool                destroyed;
+#ifdef WIN32
+        CRITICAL_SECTION    mutex;
+#else
+        pthread_mutex_t     mutex;
+#endif // if/else WIN32
+
+};  // end class NormDataPool
+
+#endif // _NORM_DATA_POOL
@@ -0,0 +1,44 @@
+#ifndef _NORM_DIGEST
+#define _NORM_DIGEST
+
+#include "protoDefs.h"  // for UINT32, etc
+
+// NormDigest computes the optional per-object content digest a sender
+// advertises in the NORM_DIGEST header extension (see NormSetTxDigest()).
+// The digest is the sum (modulo 2^32) of a CRC32C per data segment, with
+// each segment's CRC32C also covering its block and segment id.  The sum
+// doesn't depend on the order the segments are added in, so receivers
+// accumulate it as segments are written (received or decoded) and check it
+// at object completion without reading the object back.
+//
+// CRC32C uses the SSE4.2 (x86) or ARMv8 CRC32 instructions when the CPU
+// has them and a table otherwise.
+
+class NormDigest
+{
+    public:
+        enum Algorithm
+        {
+            NONE   = 0,
+            CRC32C = 1  // sum of per-segment CRC32C (see above)
+        };
+
+        // Continues a CRC32C computation (start with 0)
+        static UINT32 Crc32c(UINT32 crc, const char* buffer, unsigned int len);
+
+        // The CRC32C of a data segment (the digest is the sum of these)
+        static UINT32 SegmentDigest(UINT32          blockId,
+                                    UINT16          segmentId,
+                                    const char*     buffer,
+                                    unsigned int    len);
+
+        // True if Crc32c() is using CPU CRC instructions
+        static bool IsAccelerated();
+
+    private:
+        static UINT32 Crc32cTable(UINT32 crc, const unsigned char* buffer, unsigned int len);
+        static const UINT32 CRC32C_TABLE[256];
+
+};  // end class NormDigest
+
+#endif // _NORM_DIGEST
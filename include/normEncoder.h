@@ -42,15 +42,151 @@ class NormEncoder
         virtual bool Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize) = 0;
         virtual void Destroy() = 0;
         virtual void Encode(unsigned int segmentId, const char *dataVector, char **parityVectorList) = 0;    
+        // Some codes (e.g., NormEncoderLDPC) need a final pass over the parity
+        // vectors after the last of a block's "numData" source vectors has been
+        // passed to Encode().  This is a no-op for the Reed-Solomon codes.
+        virtual void EncodeFinish(unsigned int /*numData*/, char** /*parityVectorList*/) {}
+        // Computes the parity for a whole block of "numData" source vectors at once
+        // (the parity vectors must be zero-initialized).  The default implementation
+        // simply calls Encode() for each source vector in turn and then EncodeFinish().
+        virtual void EncodeBlock(const char** dataVectorList, unsigned int numData, char** parityVectorList);
+        // Computes the parity for "numBlocks" blocks in one call, block "i" having
+        // "numDataList[i]" source vectors (as for EncodeBlock()).  This is the
+        // entry point for encoders that gain from batching work (e.g. offload to a
+        // device, where one transfer and launch can cover many blocks, see
+        // NormEncoderOCL).  The default implementation calls EncodeBlock()
+        // for each block in turn.
+        virtual void EncodeBlocks(unsigned int          numBlocks,
+                                  const char***         dataVectorLists,
+                                  const unsigned int*   numDataList,
+                                  char***               parityVectorLists);
 };  // end class NormEncoder
 
+// The NormDecoderMatrixCache is a small LRU cache that decoders may use to keep the
+// results of decoding matrix inversion for recently seen (numData, erasure pattern)
+// combinations so that repeated loss patterns skip the O(k^3) inversion.  The cached
+// "content" is an opaque buffer whose layout is up to the decoder.
+class NormDecoderMatrixCache
+{
+    public:
+        NormDecoderMatrixCache();
+        ~NormDecoderMatrixCache();
+        
+        // A "maxEntries" of zero disables the cache
+        bool Init(unsigned int maxEntries);
+        void Destroy();
+        void Clear();  // empties cache without resetting hit/miss counts
+        unsigned int GetSize() const
+            {return entry_max;}
+        
+        // Returns the cached content for the given pattern (or NULL); the
+        // "erasureLocs" must be in ascending order as given to Decode()
+        const char* Find(unsigned int numData, unsigned int erasureCount, const unsigned int* erasureLocs);
+        // Returns a "contentSize" buffer for the caller to fill in for the
+        // given pattern, replacing the least recently used entry if needed
+        char* Insert(unsigned int numData, unsigned int erasureCount, const unsigned int* erasureLocs, unsigned int contentSize);
+        
+        unsigned long GetHitCount() const
+            {return hit_count;}
+        unsigned long GetMissCount() const
+            {return miss_count;}
+        void ResetCounts()
+        {
+            hit_count = miss_count = 0;
+        }
+        
+    private:
+        struct Entry
+        {
+            UINT32          hash;
+            unsigned int    num_data;
+            unsigned int    erasure_count;
+            unsigned int*   erasure_locs;
+            char*           content;
+            unsigned int    content_size;
+            unsigned long   last_use;
+        };
+        static UINT32 Hash(unsigned int numData, unsigned int erasureCount, const unsigned int* erasureLocs);
+            
+        Entry*          entry_list;
+        unsigned int    entry_max;
+        unsigned int    entry_count;
+        unsigned long   use_count;
+        unsigned long   hit_count;
+        unsigned long   miss_count;
+        
+};  // end class NormDecoderMatrixCache
+
 class NormDecoder
 {
     public:
+        NormDecoder();
         virtual ~NormDecoder();
         virtual bool Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize) = 0;
         virtual void Destroy() = 0;
         virtual int Decode(char** vectorList, unsigned int numData,  unsigned int erasureCount, unsigned int* erasureLocs) = 0;    
+        
+        // Decoding matrix cache control and statistics (decoders that do
+        // not use the cache always report zero hits and misses)
+        enum {MATRIX_CACHE_DEFAULT = 16};
+        bool SetMatrixCacheSize(unsigned int maxEntries)
+            {return matrix_cache.Init(maxEntries);}
+        unsigned int GetMatrixCacheSize() const
+            {return matrix_cache.GetSize();}
+        unsigned long GetMatrixCacheHits() const
+            {return matrix_cache.GetHitCount();}
+        unsigned long GetMatrixCacheMisses() const
+            {return matrix_cache.GetMissCount();}
+        
+    protected:
+        NormDecoderMatrixCache  matrix_cache;
+        
 };  // end class NormDecoder
 
+// The NormFecRegistry maps the FEC Encoding ID ("fecId"), field size ("fecM")
+// and, for the partially-specified fecId = 129 codes, the FEC Instance ID to
+// encoder/decoder factories.  The built-in codecs (RS8, RS16, LDPC and, if
+// ASSUME_MDP_FEC is defined, MDP) are registered upon first use.  For fecId
+// values other than 129, the "instanceId" is always zero.
+class NormFecRegistry
+{
+    public:
+        typedef NormEncoder* (*EncoderFactory)();
+        typedef NormDecoder* (*DecoderFactory)();
+        
+        // Adds (or replaces) a codec entry, returns false if the table is full
+        static bool Register(UINT8           fecId,
+                             UINT8           fecM,
+                             UINT16          instanceId,
+                             const char*     name,
+                             EncoderFactory  encoderFactory,
+                             DecoderFactory  decoderFactory);
+        static bool IsRegistered(UINT8 fecId, UINT8 fecM, UINT16 instanceId)
+            {return (NULL != Find(fecId, fecM, instanceId));}
+        static const char* GetName(UINT8 fecId, UINT8 fecM, UINT16 instanceId);
+        
+        // These return NULL if the codec is not registered (or on allocation failure)
+        static NormEncoder* CreateEncoder(UINT8 fecId, UINT8 fecM, UINT16 instanceId);
+        static NormDecoder* CreateDecoder(UINT8 fecId, UINT8 fecM, UINT16 instanceId);
+        
+    private:
+        struct Entry
+        {
+            UINT8           fec_id;
+            UINT8           fec_m;
+            UINT16          instance_id;
+            const char*     name;
+            EncoderFactory  encoder_factory;
+            DecoderFactory  decoder_factory;
+        };
+        static void Init();
+        static const Entry* Find(UINT8 fecId, UINT8 fecM, UINT16 instanceId);
+        
+        enum {ENTRY_MAX = 16};
+        static Entry        entry_list[ENTRY_MAX];
+        static unsigned int entry_count;
+        static bool         initialized;
+        
+};  // end class NormFecRegistry
+
 #endif // _NORM_ENCODER
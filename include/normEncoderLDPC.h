@@ -0,0 +1,117 @@
+#ifndef _NORM_ENCODER_LDPC
+#define _NORM_ENCODER_LDPC
+
+#include "normEncoder.h"
+#include "protoDefs.h"  // for UINT16
+
+// The NormEncoderLDPC and NormDecoderLDPC classes implement an "LDPC-Staircase"
+// large block code (after RFC 5170).  The parity check matrix H = [H1 | H2] has
+// a sparse, pseudo-randomly generated "H1" (column weight N1 = 3) covering the
+// source symbols and a "staircase" (dual diagonal) "H2" covering the parity
+// symbols so that encoding and (peeling) decoding run in time linear in the
+// block size.  Block sizes up to 65535 symbols are supported.  Unlike the
+// Reed-Solomon codes, decoding may occasionally need a few more symbols than
+// the number of source symbols erased (Decode() returns zero in that case).
+//
+// Note this code is carried under the "partially-specified" fec_id = 129
+// using a NORM-specific "fecInstanceId" (FEC_INSTANCE_ID) and is _not_ bit-wise
+// interoperable with other RFC 5170 implementations (the H1 generator differs).
+
+class NormLDPCMatrix
+{
+    public:
+        NormLDPCMatrix();
+        ~NormLDPCMatrix();
+
+        bool Init(unsigned int numData, unsigned int numParity);
+        void Destroy();
+
+        unsigned int ColBegin(unsigned int col) const
+            {return col_start[col];}
+        unsigned int ColEnd(unsigned int col) const
+            {return col_start[col+1];}
+        unsigned int ColRow(unsigned int index) const
+            {return col_row[index];}
+
+        unsigned int RowBegin(unsigned int row) const
+            {return row_start[row];}
+        unsigned int RowEnd(unsigned int row) const
+            {return row_start[row+1];}
+        unsigned int RowCol(unsigned int index) const
+            {return row_col[index];}
+
+        enum {N1 = 3};   // H1 column weight
+
+    private:
+        unsigned int    ndata;
+        unsigned int    npar;
+        unsigned int*   col_start;  // H1 column "c" rows are col_row[col_start[c]...col_start[c+1]-1]
+        unsigned int*   col_row;
+        unsigned int*   row_start;  // H1 row "r" columns are row_col[row_start[r]...row_start[r+1]-1]
+        unsigned int*   row_col;
+
+};  // end class NormLDPCMatrix
+
+class NormEncoderLDPC : public NormEncoder
+{
+    public:
+        NormEncoderLDPC();
+        ~NormEncoderLDPC();
+
+        enum {FEC_INSTANCE_ID = 3};  // fec_id = 129 instance identifier
+
+        virtual bool Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize);
+        virtual void Destroy();
+        virtual void Encode(unsigned int segmentId, const char* dataVector, char** parityVectorList);
+        virtual void EncodeFinish(unsigned int numData, char** parityVectorList);
+
+        unsigned int GetNumData()
+            {return ndata;}
+        unsigned int GetNumParity()
+            {return npar;}
+        unsigned int GetVectorSize()
+            {return vector_size;}
+
+    private:
+        unsigned int    ndata;        // max data pkts per block (k)
+        unsigned int    npar;         // No. of parity packets (n-k)
+        unsigned int    vector_size;  // Size of biggest vector to encode
+        NormLDPCMatrix  matrix;
+
+};  // end class NormEncoderLDPC
+
+class NormDecoderLDPC : public NormDecoder
+{
+    public:
+        NormDecoderLDPC();
+        virtual ~NormDecoderLDPC();
+        virtual bool Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize);
+        virtual void Destroy();
+        virtual int Decode(char** vectorList, unsigned int numData,  unsigned int erasureCount, unsigned int* erasureLocs);
+
+        unsigned int GetNumParity()
+            {return npar;}
+        unsigned int GetVectorSize()
+            {return vector_size;}
+
+    private:
+        bool SolveResidual(unsigned int numData, char** vectorList);  // used in Decode() method
+
+        unsigned int    ndata;        // max data pkts per block (k)
+        unsigned int    npar;         // No. of parity packets (n-k)
+        unsigned int    vector_size;  // Size of biggest vector to decode
+        NormLDPCMatrix  matrix;
+
+        // Decode() state: one "right hand side" vector per parity check
+        // equation, the unknown symbol count and XOR of the unknown symbol
+        // indices per equation, and a pointer to each recovered symbol's value
+        char*           rhs_buffer;
+        char**          rhs_list;
+        unsigned int*   row_unknown_count;
+        unsigned int*   row_unknown_sum;
+        unsigned int*   row_queue;
+        const char**    symbol_value;  // NULL for unknown symbols (size ndata + npar)
+
+};  // end class NormDecoderLDPC
+
+#endif // _NORM_ENCODER_LDPC
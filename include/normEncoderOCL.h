@@ -0,0 +1,80 @@
+#ifndef _NORM_ENCODER_OCL
+#define _NORM_ENCODER_OCL
+
+#include "normEncoderRS8.h"
+
+// The OpenCL encoder offload needs an OpenCL (1.2 or later) runtime and
+// headers; "HAVE_OPENCL" is set by the build when enabled
+#if defined(HAVE_OPENCL) && !defined(SIMULATE)
+#define NORM_OPENCL
+#endif // HAVE_OPENCL && !SIMULATE
+
+#ifdef NORM_OPENCL
+#ifdef __APPLE__
+#include <OpenCL/opencl.h>
+#else
+#ifndef CL_TARGET_OPENCL_VERSION
+#define CL_TARGET_OPENCL_VERSION 120
+#endif // !CL_TARGET_OPENCL_VERSION
+#include <CL/cl.h>
+#endif // if/else __APPLE__
+
+// The NormEncoderOCL class is an RS8 (RFC 5510, m = 8) encoder that computes
+// the parity of EncodeBlocks() batches on an OpenCL GPU (or accelerator)
+// device: the batch's source vectors are staged to the device with one
+// transfer and all its blocks are covered by one kernel launch.  The output
+// is identical to NormEncoderRS8.  Encode() and EncodeBlock() (single block
+// work where the transfer isn't worth it) use the inherited CPU code, as do
+// all calls when no device is found or the device fails.
+
+class NormEncoderOCL : public NormEncoderRS8
+{
+    public:
+        NormEncoderOCL();
+        ~NormEncoderOCL();
+
+        // Max blocks staged per kernel launch (bigger batches are split)
+        enum {BATCH_MAX = 64};
+
+        virtual bool Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize);
+        virtual void Destroy();
+        virtual void EncodeBlocks(unsigned int          numBlocks,
+                                  const char***         dataVectorLists,
+                                  const unsigned int*   numDataList,
+                                  char***               parityVectorLists);
+
+        // True when a device was set up (false means CPU encoding)
+        bool IsOffloaded() const
+            {return (NULL != cl_queue);}
+        const char* GetDeviceName() const
+            {return device_name;}
+
+    private:
+        bool InitDevice();
+        void DestroyDevice();
+        bool EncodeBatch(unsigned int          numBlocks,
+                         const char***         dataVectorLists,
+                         const unsigned int*   numDataList,
+                         char***               parityVectorLists);
+
+        unsigned int        vector_words;  // vector stride on device (32-bit words)
+        unsigned int        batch_max;     // blocks per launch (BATCH_MAX or fewer if large)
+        char                device_name[64];
+        cl_context          cl_ctx;
+        cl_command_queue    cl_queue;
+        cl_program          cl_prog;
+        cl_kernel           cl_encode;
+        cl_mem              data_mem;      // (batch_max * ndata * vector_words)
+        cl_mem              parity_mem;    // (batch_max * npar * vector_words)
+        cl_mem              count_mem;     // numData of each staged block
+        cl_mem              matrix_mem;    // parity rows of the encoding matrix
+        cl_mem              nibble_mem;    // Norm::GNIBBLE tables
+        size_t              group_size;    // kernel work-group size
+        char*               data_stage;    // host staging buffers
+        char*               parity_stage;
+
+};  // end class NormEncoderOCL
+
+#endif // NORM_OPENCL
+
+#endif // _NORM_ENCODER_OCL
@@ -46,6 +46,7 @@ class NormDecoderRS16 : public NormDecoder
             {return vector_size;}
         
     private:
+        bool BuildDecodingMatrix(unsigned int numData, unsigned int erasureCount, unsigned int* erasureLocs);
         bool InvertDecodingMatrix();   // used in Decode() method
             
         unsigned int    ndata;        // max data pkts per block (k)
@@ -13,6 +13,7 @@ class NormEncoderRS8 : public NormEncoder
         virtual bool Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize);
         virtual void Destroy();
         virtual void Encode(unsigned int segmentId, const char* dataVector, char** parityVectorList);    
+        virtual void EncodeBlock(const char** dataVectorList, unsigned int numData, char** parityVectorList);
         
         unsigned int GetNumData() 
             {return ndata;}
@@ -20,12 +21,17 @@ class NormEncoderRS8 : public NormEncoder
             {return npar;}
 	    unsigned int GetVectorSize() 
             {return vector_size;}
+        // Returns the "npar" parity rows (of "ndata" coefficients each) of
+        // the systematic encoding matrix (e.g., for offload encoders)
+        const UINT8* GetParityMatrix() const
+            {return (enc_matrix + (ndata * ndata));}
 	
     private:
         unsigned int    ndata;        // max data pkts per block (k)
 	    unsigned int    npar;	      // No. of parity packets (n-k)
 	    unsigned int    vector_size;  // Size of biggest vector to encode
-        UINT8*          enc_matrix;
+        const UINT8*    enc_matrix;   // (shared by instances with the same code)
+        const UINT8**   enc_table_list; // EncodeBlock() kernel tables (npar*ndata, see Init())
         
 };  // end class NormEncoder
 
@@ -45,14 +51,17 @@ class NormDecoderRS8 : public NormDecoder
             {return vector_size;}
         
     private:
+        bool BuildDecodingMatrix(unsigned int numData, unsigned int erasureCount, unsigned int* erasureLocs);
         bool InvertDecodingMatrix();   // used in Decode() method
             
         unsigned int    ndata;        // max data pkts per block (k)
 	    unsigned int    npar;	      // No. of parity packets (n-k)
 	    UINT16          vector_size;  // Size of biggest vector to encode
-        UINT8*          enc_matrix;
+        const UINT8*    enc_matrix;   // (shared by instances with the same code)
         UINT8*          dec_matrix;
         unsigned int*   parity_loc;
+        const UINT8**   dec_src_list;   // Decode() kernel source (ndata) and
+        const UINT8**   dec_table_list; // table (DOT_ROWS_MAX*ndata) pointers
         
         // These "inv_" members are used in InvertDecodingMatrix()
         unsigned int*   inv_ndxc;
@@ -0,0 +1,159 @@
+#ifndef _NORM_FEC_WORKER
+#define _NORM_FEC_WORKER
+
+#include "normEncoder.h"
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif // if/else WIN32
+
+// The NormFecWorkerPool lets NORM compute FEC parity (ENCODE mode, for a
+// NormSession sender) or decode erased blocks (DECODE mode, for a receiver's
+// NormSenderNode) on a set of worker threads instead of inline on the protocol
+// thread.  The protocol thread reserves a job for a block (using the block
+// pointer as a key), copies the block's segments into the job's vectors, and
+// submits it.  Each worker has its own encoder or decoder instance so codecs
+// need not be reentrant.
+//
+// ENCODE: the worker encodes straight into the block's (zeroed) parity
+// segments, so the block must not be modified or returned to the pool until
+// Collect() (or Reap()) has returned the job for it.
+//
+// DECODE: the worker decodes in place in the job's own vectors.  Completed
+// jobs are handed back by GetDecoded() in submission order per "group" (the
+// NormObject pointer) and must then be passed to Release().
+//
+// Callers may point a reserved job's vectors at their own buffers instead (e.g.
+// at byte ranges of larger segments, so one block is coded by several workers),
+// and then need not have Init() allocate job buffers at all ("jobBuffers").
+
+class NormFecWorkerPool
+{
+    public:
+        NormFecWorkerPool();
+        ~NormFecWorkerPool();
+
+        enum Mode {ENCODE, DECODE};
+        bool Init(Mode          mode,
+                  unsigned int  numWorkers,
+                  UINT8         fecId,
+                  UINT8         fecM,
+                  UINT16        fecInstanceId,
+                  unsigned int  numData,
+                  unsigned int  numParity,
+                  UINT16        vectorSize,
+                  bool          jobBuffers = true);
+        // Waits for any queued jobs to finish and stops the worker threads
+        void Destroy();
+        bool IsActive() const
+            {return (0 != worker_count);}
+        bool IsIdle() const  // true if no jobs are in use
+            {return (0 == jobs_in_use);}
+
+        // Returns the data vectors (ENCODE: "numData", DECODE: "numData + numParity")
+        // of a free job for the caller to fill in for the given "key", or NULL if
+        // all jobs are in use.  The reserved job must be submitted or Cancel()ed.
+        // (DECODE callers may set vector list entries of erased parity to NULL)
+        char** Reserve(const void* key);
+        void Cancel(const void* key);
+        void Submit(const void* key, unsigned int numData, char** parityVectorList);
+        void SubmitDecode(const void*           key,
+                          const void*           group,
+                          unsigned int          numData,
+                          unsigned int          erasureCount,
+                          const unsigned int*   erasureLocs);
+        // Blocks until the "key" job is complete and frees the job
+        // (returns false if there was no job for the given "key")
+        bool Collect(const void* key, unsigned int& numData);
+        // Frees a completed job (if any) without blocking and returns its "key"
+        const void* Reap(unsigned int& numData);
+
+        // Returns the "key" of a completed decode job (if any) whose "group" has no
+        // earlier submitted jobs outstanding, along with its decoded vectors.
+        // "decoded" is false if the decoder needed more parity than was given.
+        const void* GetDecoded(const void*&             group,
+                               char**&                  vectorList,
+                               unsigned int&            erasureCount,
+                               const unsigned int*&     erasureLocs,
+                               bool&                    decoded);
+        void Release(const void* key);
+
+        // Sets the worker decoders' matrix cache size (call before jobs are submitted)
+        bool SetDecoderCacheSize(unsigned int count);
+        void GetDecoderCacheStats(unsigned long& hits, unsigned long& misses);
+
+    private:
+        enum JobState {JOB_FREE, JOB_RESERVED, JOB_QUEUED, JOB_BUSY, JOB_DONE};
+        struct Job
+        {
+            JobState        state;
+            const void*     key;
+            const void*     group;          // DECODE only
+            unsigned long   seq;            // submission order
+            char**          buffer_list;    // job's own vector buffers
+            char**          vector_list;    // vectors handed to codec
+            char**          parity_list;    // ENCODE output (caller's)
+            unsigned int    num_data;
+            unsigned int*   erasure_locs;   // DECODE only
+            unsigned int    erasure_count;
+            bool            result;
+            Job*            next;  // for "queue_head" list
+        };
+        struct Worker
+        {
+            NormFecWorkerPool*  pool;
+            NormEncoder*        encoder;
+            NormDecoder*        decoder;
+#ifdef WIN32
+            HANDLE              thread;
+#else
+            pthread_t           thread;
+#endif // if/else WIN32
+            bool                started;
+        };
+
+        Job* FindJob(const void* key);
+        void Enqueue(Job* job);
+        void Run(Worker& worker);
+#ifdef WIN32
+        static DWORD WINAPI DoWorker(LPVOID param);
+#else
+        static void* DoWorker(void* param);
+#endif // if/else WIN32
+
+        void Lock();
+        void Unlock();
+        void WaitWork();    // (called with lock held)
+        void WaitDone();    // (called with lock held)
+        void SignalWork();
+        void SignalDone();
+
+        Mode                mode;
+        Worker*             worker_list;
+        unsigned int        worker_count;
+        Job*                job_list;
+        unsigned int        job_count;
+        unsigned int        jobs_in_use;
+        unsigned long       job_seq;
+        unsigned int        vectors_per_job;
+        char*               data_buffer;
+        char**              data_vectors;   // (2 * vectors_per_job per job)
+        unsigned int*       erasure_buffer;
+        Job*                queue_head;
+        Job*                queue_tail;
+        bool                stopping;
+#ifdef WIN32
+        CRITICAL_SECTION    mutex;
+        CONDITION_VARIABLE  work_cond;
+        CONDITION_VARIABLE  done_cond;
+#else
+        pthread_mutex_t     mutex;
+        pthread_cond_t      work_cond;
+        pthread_cond_t      done_cond;
+#endif // if/else WIN32
+
+};  // end class NormFecWorkerPool
+
+#endif // _NORM_FEC_WORKER
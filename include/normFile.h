@@ -23,6 +23,7 @@
 
 // From PROTOLIB
 #include "protokit.h"    // for Protolib stuff
+#include "protoTree.h"
 
 // (TBD) Rewrite this implementation to use 
 // native WIN32 APIs on that platform !!!
@@ -73,6 +74,44 @@ class NormFile
 		NormFile::Offset GetSize() const;
         bool Pad(Offset theOffset);  // if file size is less than theOffset, writes a byte to force filesize
         
+        // Memory-maps the first "size" bytes of the file (a writable file is
+        // extended to "size" first, with its disk space allocated so a full disk
+        // fails here rather than faulting on access).  Returns false if the file
+        // can't be mapped (e.g. not supported, no disk space, or too big for the
+        // address space) in which case Read()/Write() must be used.  (Note a mapped file that is truncated
+        // by another process will cause a fault on access.)
+        bool Map(Offset size);
+        void Unmap();
+        bool IsMapped() const
+            {return (NULL != map_ptr);}
+        char* GetMapPtr() const
+            {return map_ptr;}
+        NormFile::Offset GetMapSize() const
+            {return map_size;}
+        // Hands the mapping over to the caller so it outlives Close()
+        // (it must later be released with the static Unmap() below)
+        char* DetachMap()
+        {
+            char* ptr = map_ptr;
+            map_ptr = NULL;
+            map_size = 0;
+            return ptr;
+        }
+        static void Unmap(char* ptr, Offset size);
+        
+        // Optional buffering for ReadBuffered()/WriteBuffered().  Sequential
+        // writes are coalesced into a single write() of up to "size" bytes
+        // and reads fill the buffer "size" bytes at a time starting at the
+        // "fillOffset" hint (e.g. the start of the FEC block being read).
+        // (Note Read()/Write() bypass the buffer so don't mix them with the
+        //  buffered calls without a Flush() first.)
+        bool SetBuffer(size_t size);  // zero "size" disables
+        size_t GetBufferSize() const
+            {return buffer_size;}
+        size_t ReadBuffered(Offset theOffset, char* buffer, size_t len, Offset fillOffset);
+        bool WriteBuffered(Offset theOffset, const char* buffer, size_t len);
+        bool Flush();  // writes any buffered data
+        
         // static helper methods
         static NormFile::Type GetType(const char *path);
 		static NormFile::Offset GetSize(const char* path);
@@ -125,6 +164,13 @@ class NormFile
 #else
         off_t   offset;
 #endif // if/else WIN32/UNIX
+        char*   map_ptr;
+        Offset  map_size;
+        char*   buffer_ptr;
+        size_t  buffer_size;
+        Offset  buffer_offset;  // file offset of buffer content
+        size_t  buffer_len;     // bytes of valid content
+        bool    buffer_dirty;   // content not yet written to file
 };  // end class NormFile
 
 
@@ -171,6 +217,97 @@ class NormDirectoryIterator
         int             path_len;
 };  // end class NormDirectoryIterator
 
+/******************************************
+* The NormFileWatcher uses change notification (Linux inotify)
+* to keep a queue of the files that have been written (or moved or 
+* touched) in a set of watched directories so that repeated "updates 
+* only" passes over a NormFileList need not re-walk (and stat()) the
+* whole directory tree.  Changed paths are queued once until they are
+* retrieved with GetNextChange().  Update() returns false if the kernel 
+* event queue overflowed (changes were lost) and the caller should
+* fall back to a full walk.  Open() fails on other platforms.
+*/
+class NormFileWatcher
+{
+    public:
+        NormFileWatcher();
+        ~NormFileWatcher();
+        bool Open();
+        void Close();
+        bool IsOpen() const
+            {return (descriptor >= 0);}
+        
+        // Watches "path" (and its sub-directories if "recursive"), optionally
+        // queueing the files already there as changes (e.g. for a new directory)
+        bool WatchDirectory(const char* path, bool recursive, bool queueFiles = false);
+        
+        // Reads any pending notifications (does not block)
+        bool Update();
+        // "buffer" should be PATH_MAX long!
+        bool GetNextChange(char* pathBuffer);
+        void ClearChanges();
+        
+    private:
+        class Watch : public ProtoTree::Item
+        {
+            public:
+                Watch(int wd, const char* thePath, bool isRecursive);
+                ~Watch();
+                const char* GetPath() const
+                    {return path;}
+                bool IsRecursive() const
+                    {return recursive;}
+                void SetRecursive()
+                    {recursive = true;}
+                
+            private:
+                const char* GetKey() const
+                    {return ((const char*)&descriptor);}
+                unsigned int GetKeysize() const
+                    {return (sizeof(int) << 3);}
+                
+                int     descriptor;
+                char*   path;
+                bool    recursive;
+        };  // end class NormFileWatcher::Watch
+        class WatchTree : public ProtoTreeTemplate<Watch> {};
+        
+        class Change : public ProtoTree::Item
+        {
+            public:
+                Change(const char* thePath);
+                ~Change();
+                const char* GetPath() const
+                    {return path;}
+                Change* GetNext() const
+                    {return next;}
+                void SetNext(Change* theNext)
+                    {next = theNext;}
+                
+            private:
+                const char* GetKey() const
+                    {return path;}
+                unsigned int GetKeysize() const
+                    {return key_size;}
+                
+                char*           path;
+                unsigned int    key_size;  // (includes the '\0' so no key prefixes another)
+                Change*         next;
+        };  // end class NormFileWatcher::Change
+        class ChangeTree : public ProtoTreeTemplate<Change> {};
+        
+        static void MakePath(char* buffer, const char* dirPath, const char* name);
+        bool AddWatch(const char* path, bool recursive);
+        void QueueChange(const char* path);
+        
+        int             descriptor;   // inotify descriptor
+        WatchTree       watch_tree;   // keyed by watch descriptor
+        ChangeTree      change_tree;  // keyed by path (for de-duplication)
+        Change*         change_head;  // changes in order of arrival
+        Change*         change_tail;
+        bool            overflow;
+};  // end class NormFileWatcher
+
 
 class NormFileList
 {
@@ -200,6 +337,9 @@ class NormFileList
         
         bool Append(const char* path);
         bool Remove(const char* path);
+        // In "updates only" mode, the first pass over the list walks the
+        // tree(s) and later passes return just the files a NormFileWatcher
+        // (if supported) has seen change since, instead of walking again
         bool GetNextFile(char* pathBuffer);
         void GetCurrentBasePath(char* pathBuffer);
                      
@@ -243,6 +383,10 @@ class NormFileList
                 NormDirectoryIterator diterator;
         };    
         
+        void StartWatch();
+        bool GetNextChange(char* pathBuffer);
+        FileItem* FindOwner(const char* path);
+        
         time_t          this_time;
         time_t          big_time;
         time_t          last_time;
@@ -251,6 +395,9 @@ class NormFileList
         FileItem*       tail;
         FileItem*       next;
         bool            reset;
+        NormFileWatcher watcher;
+        bool            watch_ready;  // initial walk done, so use "watcher" changes
+        bool            watch_failed; // (not supported, or out of watches)
 };  // end class NormFileList
 
 #endif // _NORM_FILE
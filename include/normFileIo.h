@@ -0,0 +1,125 @@
+#ifndef _NORM_FILE_IO
+#define _NORM_FILE_IO
+
+#include "normFile.h"
+
+// Asynchronous file I/O needs positional pread()/pwrite() (so it is not yet
+// available on Win32).  When "HAVE_LIBURING" is set by the build, Linux
+// io_uring is used instead of the worker thread pool.
+#if !defined(WIN32) && !defined(SIMULATE)
+#define NORM_FILE_IO
+#include <pthread.h>
+#ifdef HAVE_LIBURING
+#define NORM_FILE_IO_URING
+#include <liburing.h>
+#endif // HAVE_LIBURING
+#endif // !WIN32 && !SIMULATE
+
+// The NormFileIoEngine lets NormFileObject segment writes and read-ahead
+// prefetches complete in the background so slow (e.g. network) storage
+// doesn't stall the protocol thread (timers, NACK processing, etc).
+//
+// Writes are copied into an engine request and are "fire and forget";
+// Flush() waits for a file's queued writes and reports any failure.
+// Reads return a Request that the caller must Release() when done with
+// its buffer.  A Release()d request that is still in progress is freed by
+// the engine when it completes.
+//
+// With io_uring, a single engine thread batches requests onto the ring
+// submission queue (so many I/Os may be outstanding); otherwise each of
+// the "numWorkers" threads does blocking pread()/pwrite() calls.
+
+class NormFileIoEngine
+{
+    public:
+        NormFileIoEngine();
+        ~NormFileIoEngine();
+
+        enum {PENDING_MAX_DEFAULT = 256};
+        bool Init(unsigned int numWorkers, unsigned int pendingMax = PENDING_MAX_DEFAULT);
+        // Waits for queued requests to finish and stops the engine thread(s)
+        void Destroy();
+        bool IsActive() const
+            {return (0 != thread_count);}
+        unsigned int GetWorkerCount() const
+            {return thread_count;}
+
+        struct Request;
+
+        // Queues a copy of "buffer" to be written at "offset" of "fd"
+        // (blocks if all requests are in use)
+        bool Write(int fd, NormFile::Offset offset, const char* buffer, size_t len);
+        // Starts a read of up to "len" bytes at "offset" of "fd"
+        // (returns NULL if all requests are in use)
+        Request* Read(int fd, NormFile::Offset offset, size_t len);
+        // Blocks until the read is complete and returns the number of bytes
+        // read (or -1 on error) with "buffer" pointing to the data
+        long Wait(Request* request, const char*& buffer);
+        void Release(Request* request);
+
+        // Blocks until all queued writes to "fd" are complete
+        // (returns false if any failed since the last Flush())
+        bool Flush(int fd);
+
+#ifdef NORM_FILE_IO
+        enum RequestState {REQ_FREE, REQ_QUEUED, REQ_BUSY, REQ_DONE};
+        struct Request
+        {
+            RequestState        state;
+            bool                is_write;
+            bool                orphan;     // Release()d while in progress
+            int                 fd;
+            NormFile::Offset    offset;
+            size_t              length;
+            size_t              done;       // bytes completed so far
+            long                result;
+            char*               buffer;
+            size_t              buffer_size;
+            Request*            next;
+        };
+#endif // NORM_FILE_IO
+
+    private:
+#ifdef NORM_FILE_IO
+        Request* GetFreeRequest(bool wait);  // (called with lock held)
+        void Enqueue(Request* req);          // (called with lock held)
+        Request* Dequeue();                  // (called with lock held)
+        void Complete(Request* req);         // (called with lock held)
+        void FreeRequest(Request* req);      // (called with lock held)
+        static void Execute(Request* req);   // blocking pread()/pwrite() of remainder
+        void RunWorker();
+#ifdef NORM_FILE_IO_URING
+        void RunUring();
+#endif // NORM_FILE_IO_URING
+        static void* DoThread(void* param);
+
+        void Lock()
+            {pthread_mutex_lock(&mutex);}
+        void Unlock()
+            {pthread_mutex_unlock(&mutex);}
+
+        enum {FAIL_MAX = 32};
+
+        Request*            request_list;
+        unsigned int        request_count;
+        Request*            free_head;
+        Request*            queue_head;
+        Request*            queue_tail;
+        pthread_t*          thread_list;
+        int                 fail_list[FAIL_MAX];  // fds with failed writes
+        unsigned int        fail_count;
+        bool                fail_overflow;
+        bool                stopping;
+        pthread_mutex_t     mutex;
+        pthread_cond_t      work_cond;
+        pthread_cond_t      done_cond;
+#ifdef NORM_FILE_IO_URING
+        struct io_uring     ring;
+        bool                ring_init;
+#endif // NORM_FILE_IO_URING
+#endif // NORM_FILE_IO
+        unsigned int        thread_count;
+
+};  // end class NormFileIoEngine
+
+#endif // _NORM_FILE_IO
@@ -0,0 +1,84 @@
+#ifndef _NORM_GF_KERNEL
+#define _NORM_GF_KERNEL
+
+#include "protoDefs.h"  // for UINT8, UINT16
+
+// The NormGFKernel class provides the Galois field "multiply-accumulate"
+// (dst[] ^= c * src[]) vector kernels shared by the RFC 5510 Reed-Solomon
+// encoder/decoder classes (NormEncoderRS8, NormEncoderRS16, etc).  The kernels
+// use the "split nibble" table shuffle technique (pshufb on x86, tbl on ARM)
+// where a product c*x is formed from 16-entry tables of c times each possible
+// 4-bit nibble of x.  The best implementation supported by the CPU is selected
+// at run time (once, during static initialization before any threads run).  When no SIMD implementation is available
+// (or NORM_GF_KERNEL_PORTABLE is defined at build time), the AddMul8/AddMul16
+// pointers returned are NULL and the codecs use their portable table-lookup code.
+
+class NormGFKernel
+{
+    public:
+        enum Type
+        {
+            PORTABLE = 0,   // no SIMD kernel, codecs use their own lookup tables
+            SSSE3,          // x86 128-bit pshufb
+            AVX2,           // x86 256-bit vpshufb
+            NEON            // ARMv8 (aarch64) 128-bit tbl
+        };
+
+        // GF(2^8) kernel: "mulRow" is the 256-entry multiplication table row
+        // for the constant c (i.e., mulRow[x] = c*x)
+        typedef void (*AddMul8)(UINT8*          dst,
+                                const UINT8*    src,
+                                const UINT8*    mulRow,
+                                unsigned int    len);
+
+        // GF(2^16) kernel: "nibbleTable[16*i + n]" is c*(n << (4*i)) for the
+        // constant c and nibble positions i = 0..3 (i.e., 64 entries).
+        // The symbols are 16-bit values in host byte order.
+        typedef void (*AddMul16)(UINT16*        dst,
+                                 const UINT16*  src,
+                                 const UINT16*  nibbleTable,
+                                 unsigned int   count);
+
+        // GF(2^8) "dot product" kernel: for each of "numDst" (at most DOT_ROWS_MAX)
+        // rows r, dstList[r][offset...] ^= sum over j of c_rj * srcList[j][offset...]
+        // where "tableList[r*numSrc + j]" points to the 32-byte nibble table for
+        // c_rj (tbl[n] = c*n and tbl[16+n] = c*(n << 4)).  Each span of the "dst"
+        // rows is accumulated in registers and stored only once.
+        enum {DOT_ROWS_MAX = 4};
+        typedef void (*DotProd8)(UINT8* const*          dstList,
+                                 unsigned int           numDst,
+                                 const UINT8* const*    srcList,
+                                 unsigned int           numSrc,
+                                 const UINT8* const*    tableList,
+                                 unsigned int           offset,
+                                 unsigned int           len);
+
+        static Type GetType();
+        static const char* GetTypeName(Type type);
+        static const char* GetTypeName() {return GetTypeName(GetType());}
+
+        // Allows the run time selection to be overridden (e.g., for "fecTest"
+        // comparisons).  Returns false if the given "type" is not supported.
+        // (Not thread-safe, so call it before any encoder/decoder is in use)
+        static bool SetType(Type type);
+        static bool IsSupported(Type type);
+
+        // These return NULL when the PORTABLE type is in effect
+        static AddMul8 GetAddMul8()
+            {return addmul8;}
+        static AddMul16 GetAddMul16()
+            {return addmul16;}
+        static DotProd8 GetDotProd8()
+            {return dotprod8;}
+
+    private:
+        static Type Init();
+
+        static Type     type;
+        static AddMul8  addmul8;
+        static AddMul16 addmul16;
+        static DotProd8 dotprod8;
+
+};  // end class NormGFKernel
+
+#endif // _NORM_GF_KERNEL
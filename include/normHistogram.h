@@ -0,0 +1,56 @@
+#ifndef _NORM_HISTOGRAM
+#define _NORM_HISTOGRAM
+
+#include "protokit.h"
+
+// The NormHistogram is an HDR-style log-linear latency histogram.  Values
+// are recorded in microseconds into buckets of 16 linear sub-buckets per
+// power of two, so any recorded value (up to about 71 minutes) is kept to
+// within about 6% with a fixed ~2 kB of counts and a constant time
+// Record().  The bucket array is allocated on the first Record(), so an
+// idle histogram costs nothing.  Percentiles are reported as the middle
+// of the bucket they fall in.
+
+class NormHistogram
+{
+    public:
+        NormHistogram();
+        ~NormHistogram();
+
+        void Record(double seconds);
+        void Reset();
+        void Destroy();
+
+        UINT32 GetCount() const
+            {return count;}
+        double GetMin() const  // (seconds)
+            {return ((0 != count) ? (1.0e-06 * value_min) : 0.0);}
+        double GetMax() const
+            {return ((0 != count) ? (1.0e-06 * value_max) : 0.0);}
+        double GetMean() const
+            {return ((0 != count) ? (1.0e-06 * value_sum / (double)count) : 0.0);}
+        // "percent" is 0.0 to 100.0
+        double GetPercentile(double percent) const;
+
+    private:
+        enum
+        {
+            SUB_BITS    = 4,
+            SUB_COUNT   = 1 << SUB_BITS,
+            SUB_MASK    = SUB_COUNT - 1,
+            // (values below SUB_COUNT get a bucket each, then SUB_COUNT
+            // buckets per power of two up through 2^31)
+            BUCKET_COUNT = (32 - SUB_BITS + 1) * SUB_COUNT
+        };
+        static unsigned int GetBucketIndex(UINT32 value);
+        static double GetBucketValue(unsigned int index);
+
+        UINT32* bucket;
+        UINT32  count;
+        UINT32  value_min;  // (microseconds)
+        UINT32  value_max;
+        double  value_sum;
+
+};  // end class NormHistogram
+
+#endif // _NORM_HISTOGRAM
@@ -0,0 +1,86 @@
+#ifndef _NORM_ID_RING
+#define _NORM_ID_RING
+
+#include "protokit.h"
+
+// The NormIdRing is a direct-indexed (id & mask) lookup ring that sits in
+// front of the NormBlockBuffer and NormObjectTable trees.  Block and
+// object ids are dense sliding windows, so items usually land in their own
+// slot and most lookups are one array access plus an id check.  No
+// hashing or tree walk is needed, and wrap is harmless as long as the ring
+// size (a power of two) divides the id space.  An item whose slot is
+// taken (the window is wider than the ring) is an "overflow" item.  The
+// owner then also checks its tree for slot misses until the overflow
+// items are removed.
+
+template <class ITEM>
+class NormIdRing
+{
+    public:
+        NormIdRing() : slot(NULL), mask(0), overflow(0) {}
+        ~NormIdRing() {Destroy();}
+
+        // Rounds "numSlots" up to a power of two, no larger than "sizeMax"
+        // (which must be a power of two if given, e.g. the id space size)
+        bool Init(UINT32 numSlots, UINT32 sizeMax = 0x80000000)
+        {
+            Destroy();
+            UINT32 size = 1;
+            while ((size < numSlots) && (size < sizeMax)) size <<= 1;
+            if (NULL == (slot = new ITEM*[size]))
+            {
+                PLOG(PL_FATAL, "NormIdRing::Init() new slot array error: %s\n", GetErrorString());
+                return false;
+            }
+            memset(slot, 0, size*sizeof(ITEM*));
+            mask = size - 1;
+            overflow = 0;
+            return true;
+        }
+        void Destroy()
+        {
+            if (NULL != slot)
+            {
+                delete[] slot;
+                slot = NULL;
+            }
+            mask = overflow = 0;
+        }
+
+        // The caller validates the id of the returned item
+        ITEM* Get(UINT32 id) const
+            {return ((NULL != slot) ? slot[id & mask] : NULL);}
+        // False if the item's slot was taken (it counts as overflow)
+        bool Insert(UINT32 id, ITEM* item)
+        {
+            if (NULL == slot) return false;
+            ITEM*& entry = slot[id & mask];
+            if (NULL == entry)
+            {
+                entry = item;
+                return true;
+            }
+            overflow++;
+            return false;
+        }
+        // (only for items that were Insert()ed)
+        void Remove(UINT32 id, ITEM* item)
+        {
+            if (NULL == slot) return;
+            ITEM*& entry = slot[id & mask];
+            if (item == entry)
+                entry = NULL;
+            else if (0 != overflow)
+                overflow--;
+        }
+        bool HasOverflow() const
+            {return ((NULL == slot) || (0 != overflow));}
+
+    private:
+        ITEM**  slot;
+        UINT32  mask;
+        UINT32  overflow;  // count of items not in their slot
+
+};  // end class NormIdRing
+
+#endif // _NORM_ID_RING
@@ -4,6 +4,8 @@
 // PROTOLIB includes
 #include "protokit.h"
 
+#include "normConfig.h"  // for NORM_MSG_SIZE_MAX, etc
+
 // standard includes
 #include <string.h>  // for memcpy(), etc
 #include <math.h>
@@ -330,7 +332,12 @@ class NormHeaderExtension
             FTI         =  64,  // FEC Object Transmission Information (FTI) extension
             CC_FEEDBACK =   3,  // NORM-CC Feedback extension
             CC_RATE     = 128,  // NORM-CC Rate extension
-            APP_ACK     =  65   // app-defined ACK extension (see NormSetWatermarkEx())
+            APP_ACK     =  65,  // app-defined ACK extension (see NormSetWatermarkEx())
+            DIGEST      =  66,  // object content digest extension (see NormSetTxDigest())
+            WINDOW_REPAIR = 67, // stream sliding window repair extension (see NormStreamSetWindowRepair())
+            LOCAL_REPAIR  = 68, // receiver local repair extension (see NormSetLocalRepair())
+            ACK_AGGREGATE = 69, // aggregated watermark ACK extension (see NormSetAckAggregator())
+            STREAM_SYNC   = 70  // stream message start sync point extension (see NormStreamSetSyncInterval())
         }; 
             
         NormHeaderExtension();
@@ -581,9 +588,29 @@ class NormMsg
             ACK      = 5,
             REPORT   = 6
         };    
-        enum {MAX_SIZE = 65536};
+        // Messages hold up to MAX_SIZE bytes, but a message's buffer is
+        // only INLINE_SIZE bytes unless SetBufferSize() grows it (which
+        // allocates an overflow buffer the message then keeps)
+        enum 
+        {
+            MAX_SIZE    = NORM_MSG_SIZE_MAX,
+            INLINE_SIZE = NORM_MSG_INLINE_SIZE, 
+            HEADER_MAX  = 1024 + 64  // (1020 byte header + payload header)
+        };
                
         NormMsg();
+        ~NormMsg();
+        
+        bool SetBufferSize(unsigned int bufferSize);
+        unsigned int GetBufferSize() const 
+            {return buffer_size;}
+        // Buffer size needed for messages with up to "payloadMax" bytes
+        // of content (segment size, NACK/ACK content, etc)
+        static unsigned int ComputeBufferSize(unsigned int payloadMax)
+        {
+            unsigned int bufferSize = HEADER_MAX + ((payloadMax + 3) & ~3);
+            return ((bufferSize < MAX_SIZE) ? bufferSize : MAX_SIZE);
+        }
         
         // Message building routines
         void SetVersion(UINT8 version) 
@@ -611,7 +638,8 @@ class NormMsg
         
         void AttachExtension(NormHeaderExtension& extension)
         {
-            extension.Init(buffer+(header_length/4), MAX_SIZE - header_length);
+            extension.Init(buffer+(header_length/4), buffer_size - header_length);
+            IndexExtension(extension.GetType(), header_length/4);
             ExtendHeaderLength(extension.GetLength());
         }
         // Only use this for extensions that have content appended after attachment
@@ -625,7 +653,7 @@ class NormMsg
         bool InitFromBuffer(UINT16 msgLength);
         bool CopyFromBuffer(const char* theBuffer, unsigned int theLength)
         {
-            if (theLength > MAX_SIZE) return false;
+            if ((theLength > buffer_size) && !SetBufferSize(theLength)) return false;
             memcpy(buffer, theBuffer, theLength);
             return InitFromBuffer(theLength);
         }
@@ -654,7 +682,27 @@ class NormMsg
         
         // To retrieve any attached header extensions
         bool HasExtensions() const {return (header_length > header_length_base);}
-        bool HasExtension(NormHeaderExtension::Type extType);
+        bool HasExtension(NormHeaderExtension::Type extType) const
+        {
+            NormHeaderExtension ext;
+            return FindExtension(extType, ext);
+        }
+        // Attaches "ext" to the first extension of type "extType" (if any).
+        // Extensions of the NORM-defined types are indexed as the message is
+        // parsed (see InitFromBuffer()) or built, so this is a lookup.
+        bool FindExtension(NormHeaderExtension::Type extType, NormHeaderExtension& ext) const
+        {
+            int slot = GetExtensionSlot(extType);
+            if (slot < 0) return SearchExtension(extType, ext);
+            UINT16 offset = ext_offset[slot];
+            if (0 == offset)
+            {
+                ext.AttachBuffer((UINT32*)NULL, 0);
+                return false;
+            }
+            ext.AttachBuffer(buffer+offset, ((UINT8*)(buffer + offset))[1] << 2);
+            return true;
+        }
         bool GetNextExtension(NormHeaderExtension& ext) const
         {
             const UINT32* currentBuffer = ext.GetBuffer();
@@ -675,6 +723,18 @@ class NormMsg
             return result;
         }
         
+        // A NORM_DATA payload may instead reference content outside of the
+        // message buffer (e.g. a memory-mapped file) for zero-copy transmission
+        const char* GetPayloadRef() const {return payload_ref;}
+        void CopyPayloadRef()
+        {
+            if (NULL != payload_ref)
+            {
+                memcpy(((char*)buffer)+header_length, payload_ref, length - header_length);
+                payload_ref = NULL;
+            }
+        }
+        
         // For message reception and misc.
         char* AccessBuffer() {return ((char*)buffer);} 
         ProtoAddress& AccessAddress() {return addr;} 
@@ -699,6 +759,8 @@ class NormMsg
         {
             ((UINT8*)buffer)[HDR_LEN_OFFSET] = len >> 2;
             length = header_length_base = header_length = len;
+            payload_ref = NULL;
+            ClearExtensionIndex();
         }
         void ExtendHeaderLength(UINT16 len) 
         {
@@ -707,14 +769,58 @@ class NormMsg
             ((UINT8*)buffer)[HDR_LEN_OFFSET] = header_length >> 2;
         }
            
-        UINT32          buffer[MAX_SIZE / sizeof(UINT32)]; 
+        // Header extension index (UINT32 offsets of the first extension
+        // of each type, zero if there is none)
+        enum 
+        {
+            EXT_SLOT_FTI,
+            EXT_SLOT_CC_FEEDBACK,
+            EXT_SLOT_CC_RATE,
+            EXT_SLOT_APP_ACK,
+            EXT_SLOT_DIGEST,
+            EXT_SLOT_COUNT
+        };
+        static int GetExtensionSlot(NormHeaderExtension::Type extType)
+        {
+            switch (extType)
+            {
+                case NormHeaderExtension::FTI:          return EXT_SLOT_FTI;
+                case NormHeaderExtension::CC_FEEDBACK:  return EXT_SLOT_CC_FEEDBACK;
+                case NormHeaderExtension::CC_RATE:      return EXT_SLOT_CC_RATE;
+                case NormHeaderExtension::APP_ACK:      return EXT_SLOT_APP_ACK;
+                case NormHeaderExtension::DIGEST:       return EXT_SLOT_DIGEST;
+                default:                                return -1;
+            }
+        }
+        void ClearExtensionIndex()
+            {memset(ext_offset, 0, sizeof(ext_offset));}
+        void IndexExtension(NormHeaderExtension::Type extType, UINT16 offset)
+        {
+            int slot = GetExtensionSlot(extType);
+            if ((slot >= 0) && (0 == ext_offset[slot])) ext_offset[slot] = offset;
+        }
+        // Validates and indexes the received header extensions
+        bool ParseExtensions();
+        // (for extension types that aren't indexed)
+        bool SearchExtension(NormHeaderExtension::Type extType, NormHeaderExtension& ext) const;
+        
+        UINT32*         buffer;         // "inline_buffer" or overflow allocation
+        unsigned int    buffer_size;    // in bytes
         UINT16          length;         // in bytes
         UINT16          header_length;  
         UINT16          header_length_base;
+        UINT16          ext_offset[EXT_SLOT_COUNT];
+        const char*     payload_ref;  // external payload (NORM_DATA only)
         ProtoAddress    addr;  // src or dst address
         
         NormMsg*        prev;
         NormMsg*        next;
+        UINT32          inline_buffer[INLINE_SIZE / sizeof(UINT32)]; 
+        
+    private:
+        // (not copyable, since "buffer" may point to "inline_buffer")
+        NormMsg(const NormMsg&);
+        NormMsg& operator=(const NormMsg&);
 };  // end class NormMsg
 
 // "NormObjectMsg" is a base class for the similar "NormInfoMsg"
@@ -732,8 +838,9 @@ class NormObjectMsg : public NormMsg
             FLAG_UNRELIABLE = 0x08,
             FLAG_FILE       = 0x10,
             FLAG_STREAM     = 0x20,
-            FLAG_SYN        = 0x40
+            FLAG_SYN        = 0x40,
             //FLAG_MSG_START  = 0x40 deprecated
+            FLAG_FLUSH      = 0x80  // piggybacked flush (see NormSession::SetTxFlushPiggyback())
         }; 
         UINT16 GetInstanceId() const
             {return (ntohs(((UINT16*)buffer)[INSTANCE_ID_OFFSET]));}
@@ -972,6 +1079,203 @@ class NormAppAckExtension : public NormHeaderExtension
         }
 };  // end class NormAppAckExtension
 
+// Carries the sender's digest of a (non-stream) object's content (see
+// NormDigest) so receivers can verify the object before completing it.
+class NormDigestExtension : public NormHeaderExtension
+{
+    public:
+        virtual void Init(UINT32* theBuffer, UINT16 numBytes)
+        {
+            AttachBuffer(theBuffer, numBytes);
+            SetType(DIGEST);  // HET = 66
+            SetWords(2);
+            ((UINT8*)buffer)[FLAGS_OFFSET] = 0;
+        }
+        void SetAlgorithm(UINT8 algorithm)
+            {((UINT8*)buffer)[ALGORITHM_OFFSET] = algorithm;}
+        void SetDigest(UINT32 digest)
+            {buffer[DIGEST_OFFSET] = htonl(digest);}
+        // A sender sums the digest as it first sends the object, so messages
+        // sent before that's done say the digest is still to come
+        void SetPending(bool state)
+            {((UINT8*)buffer)[FLAGS_OFFSET] = state ? FLAG_PENDING : 0;}
+        
+        UINT8 GetAlgorithm() const
+            {return ((UINT8*)buffer)[ALGORITHM_OFFSET];}
+        UINT32 GetDigest() const
+            {return ntohl(buffer[DIGEST_OFFSET]);}
+        bool IsPending() const
+            {return (0 != (((UINT8*)buffer)[FLAGS_OFFSET] & FLAG_PENDING));}
+        // (the length is checked since received extensions aren't validated)
+        bool IsValid() const
+            {return (GetLength() >= 8);}
+        
+    private:
+        enum
+        {
+            ALGORITHM_OFFSET = LENGTH_OFFSET + 1,      // UINT8 offset
+            FLAGS_OFFSET     = ALGORITHM_OFFSET + 1,   // UINT8 offset
+            DIGEST_OFFSET    = (FLAGS_OFFSET + 1)/4    // UINT32 offset
+        };
+        enum {FLAG_PENDING = 0x01};  // (the digest field isn't set yet)
+};  // end class NormDigestExtension
+
+// A stream's sliding window repair symbol is a NORM_DATA message for the
+// block being sent with the (otherwise unused) highest symbol id of the FEC
+// payload id format.  This extension gives the range of the block's source
+// segments it covers and the key its coding coefficients are generated from
+// (see NormStreamObject::WindowRepairCoefficient()).
+class NormWindowRepairExtension : public NormHeaderExtension
+{
+    public:
+        virtual void Init(UINT32* theBuffer, UINT16 numBytes)
+        {
+            AttachBuffer(theBuffer, numBytes);
+            SetType(WINDOW_REPAIR);  // HET = 67
+            SetWords(2);
+        }
+        void SetFirstSegment(UINT16 segmentId)
+            {((UINT16*)buffer)[FIRST_OFFSET] = htons(segmentId);}
+        void SetSegmentCount(UINT16 count)
+            {((UINT16*)buffer)[COUNT_OFFSET] = htons(count);}
+        void SetRepairKey(UINT16 key)
+            {((UINT16*)buffer)[KEY_OFFSET] = htons(key);}
+        
+        UINT16 GetFirstSegment() const
+            {return ntohs(((UINT16*)buffer)[FIRST_OFFSET]);}
+        UINT16 GetSegmentCount() const
+            {return ntohs(((UINT16*)buffer)[COUNT_OFFSET]);}
+        UINT16 GetRepairKey() const
+            {return ntohs(((UINT16*)buffer)[KEY_OFFSET]);}
+        // (the length is checked since received extensions aren't validated)
+        bool IsValid() const
+            {return (GetLength() >= 8);}
+        
+    private:
+        enum
+        {
+            FIRST_OFFSET = (LENGTH_OFFSET + 1)/2,  // UINT16 offset
+            COUNT_OFFSET = FIRST_OFFSET + 1,       // UINT16 offset
+            KEY_OFFSET   = COUNT_OFFSET + 1        // UINT16 offset
+        };
+};  // end class NormWindowRepairExtension
+
+// A local repairer (see NormSession::SetLocalRepair()) retransmits the
+// sender's NORM_DATA (keeping the sender's source id) with this extension
+// naming itself, so receivers don't take the message as the sender's own
+// for its address, rate and loss measurements.
+class NormLocalRepairExtension : public NormHeaderExtension
+{
+    public:
+        virtual void Init(UINT32* theBuffer, UINT16 numBytes)
+        {
+            AttachBuffer(theBuffer, numBytes);
+            SetType(LOCAL_REPAIR);  // HET = 68
+            SetWords(2);
+            ((UINT16*)buffer)[RESERVED_OFFSET] = 0;
+        }
+        void SetRepairerId(NormNodeId nodeId)
+            {buffer[REPAIRER_ID_OFFSET] = htonl(nodeId);}
+        
+        NormNodeId GetRepairerId() const
+            {return ntohl(buffer[REPAIRER_ID_OFFSET]);}
+        // (the length is checked since received extensions aren't validated)
+        bool IsValid() const
+            {return (GetLength() >= 8);}
+        
+    private:
+        enum
+        {
+            RESERVED_OFFSET    = (LENGTH_OFFSET + 1)/2,     // UINT16 offset
+            REPAIRER_ID_OFFSET = (2*(RESERVED_OFFSET+1))/4  // UINT32 offset
+        };
+};  // end class NormLocalRepairExtension
+
+// An ACK aggregator's NORM_ACK(FLUSH) lists the receivers whose watermark
+// ACKs it has collected as (base node id, mask) pairs where the mask's
+// most significant bit stands for the base node id, the next for base + 1,
+// and so on.  The extension length is set as pairs are appended, so use
+// NormMsg::PackExtension() afterwards.
+class NormAckAggregateExtension : public NormHeaderExtension
+{
+    public:
+        virtual void Init(UINT32* theBuffer, UINT16 numBytes)
+        {
+            AttachBuffer(theBuffer, numBytes);
+            SetType(ACK_AGGREGATE);  // HET = 69
+            SetWords(0);
+            ((UINT16*)buffer)[RESERVED_OFFSET] = 0;
+        }
+        bool AppendPair(NormNodeId baseId, UINT32 mask)
+        {
+            UINT16 offset = PAIR_OFFSET + 2*GetPairCount();
+            if ((offset + 2) > 255) return false;  // (8-bit length field)
+            if ((4*(offset + 2)) > buffer_length) return false;
+            buffer[offset] = htonl(baseId);
+            buffer[offset + 1] = htonl(mask);
+            SetWords((UINT8)(offset + 2));
+            return true;
+        }
+        
+        UINT16 GetPairCount() const
+        {
+            UINT16 words = GetLength() >> 2;
+            return ((words > PAIR_OFFSET) ? ((words - PAIR_OFFSET) >> 1) : 0);
+        }
+        NormNodeId GetPairBaseId(UINT16 index) const
+            {return ntohl(buffer[PAIR_OFFSET + 2*index]);}
+        UINT32 GetPairMask(UINT16 index) const
+            {return ntohl(buffer[PAIR_OFFSET + 2*index + 1]);}
+        
+    private:
+        enum
+        {
+            RESERVED_OFFSET = (LENGTH_OFFSET + 1)/2,    // UINT16 offset
+            PAIR_OFFSET     = (2*(RESERVED_OFFSET+1))/4 // UINT32 offset
+        };
+};  // end class NormAckAggregateExtension
+
+// A stream sync point gives the block, segment and offset (within the
+// segment's data) of the most recent message start the sender has sent, so
+// late joining (or broken stream) receivers can start reading at a message
+// boundary right away instead of waiting for the next one to arrive.
+class NormStreamSyncExtension : public NormHeaderExtension
+{
+    public:
+        virtual void Init(UINT32* theBuffer, UINT16 numBytes)
+        {
+            AttachBuffer(theBuffer, numBytes);
+            SetType(STREAM_SYNC);  // HET = 70
+            SetWords(3);
+            ((UINT16*)buffer)[RESERVED_OFFSET] = 0;
+        }
+        void SetSegmentId(UINT16 segmentId)
+            {((UINT16*)buffer)[SEGMENT_OFFSET] = htons(segmentId);}
+        void SetBlockId(UINT32 blockId)
+            {buffer[BLOCK_OFFSET] = htonl(blockId);}
+        void SetMsgOffset(UINT16 offset)
+            {((UINT16*)buffer)[MSG_OFFSET_OFFSET] = htons(offset);}
+        
+        UINT16 GetSegmentId() const
+            {return ntohs(((UINT16*)buffer)[SEGMENT_OFFSET]);}
+        UINT32 GetBlockId() const
+            {return ntohl(buffer[BLOCK_OFFSET]);}
+        UINT16 GetMsgOffset() const
+            {return ntohs(((UINT16*)buffer)[MSG_OFFSET_OFFSET]);}
+        // (the length is checked since received extensions aren't validated)
+        bool IsValid() const
+            {return (GetLength() >= 12);}
+        
+    private:
+        enum
+        {
+            SEGMENT_OFFSET    = (LENGTH_OFFSET + 1)/2,      // UINT16 offset
+            BLOCK_OFFSET      = (2*(SEGMENT_OFFSET+1))/4,   // UINT32 offset
+            MSG_OFFSET_OFFSET = (4*(BLOCK_OFFSET+1))/2,     // UINT16 offset
+            RESERVED_OFFSET   = MSG_OFFSET_OFFSET + 1       // UINT16 offset
+        };
+};  // end class NormStreamSyncExtension
+
 
 // This FEC Object Transmission Information assumes "fec_id" == 129
 class NormFtiExtension129 : public NormHeaderExtension
@@ -1089,12 +1393,22 @@ class NormDataMsg : public NormObjectMsg
         char* AccessPayload() {return (((char*)buffer)+header_length);}
         // For NORM_STREAM_OBJECT segments, "dataLength" must include the PAYLOAD_HEADER_LENGTH
         void SetPayloadLength(UINT16 payloadLength)
-            {length = header_length + payloadLength;}
+        {
+            length = header_length + payloadLength;
+            payload_ref = NULL;
+        }
         // Set "payload" directly (useful for FEC parity segments)
         void SetPayload(char* payload, UINT16 payloadLength)
         {
             memcpy(((char*)buffer)+header_length, payload, payloadLength);
             length = header_length + payloadLength; 
+            payload_ref = NULL;
+        }
+        // 3) Reference "payload" in place (it must remain valid until sent)
+        void SetPayloadRef(const char* payload, UINT16 payloadLength)
+        {
+            length = header_length + payloadLength;
+            payload_ref = payload;
         }
         // AccessPayloadData() (useful for setting ZERO padding)
         char* AccessPayloadData() 
@@ -1616,6 +1930,12 @@ class NormRepairRequest
                                 UINT16              blockLen,
                                 UINT16              erasureCount);     
         
+        // Copies "numBytes" of item list content (whole items) from
+        // "request" starting at item list "offset"
+        bool AppendRepairContent(const NormRepairRequest& request,
+                                 UINT16                   offset,
+                                 UINT16                   numBytes);
+        
         UINT16 Pack();       
         
         // Repair request processing
@@ -1938,12 +2258,13 @@ class NormNackMsg : public NormMsg
         }
         
         // TBD - add some safety checks to these methods 
-        void InitFrom(NormNackMsg nack)
+        void InitFrom(const NormNackMsg& nack)
         {
             // Copy header from "nack"
             memcpy(buffer, nack.buffer, nack.GetHeaderLength());
             header_length_base = nack.header_length_base;
             length = header_length = nack.GetHeaderLength();
+            memcpy(ext_offset, nack.ext_offset, sizeof(ext_offset));
         }
         void AppendRepairRequest(const NormRepairRequest request)
         {
@@ -0,0 +1,154 @@
+#ifndef _NORM_MSG_BATCH
+#define _NORM_MSG_BATCH
+
+#include "normMessage.h"
+#include "protokit.h"
+
+// Batched datagram I/O is only available where the system provides
+// recvmmsg() (Linux 2.6.33+) and sendmmsg() (Linux 3.0+); "HAVE_RECVMMSG"
+// and "HAVE_SENDMMSG" are set by the build
+#if defined(HAVE_RECVMMSG) && !defined(SIMULATE)
+#define NORM_RECV_BATCH
+#endif // HAVE_RECVMMSG && !SIMULATE
+#if defined(HAVE_SENDMMSG) && !defined(SIMULATE)
+#define NORM_SEND_BATCH
+#endif // HAVE_SENDMMSG && !SIMULATE
+
+#if defined(NORM_RECV_BATCH) || defined(NORM_SEND_BATCH)
+struct mmsghdr;
+struct iovec;
+#endif // NORM_RECV_BATCH || NORM_SEND_BATCH
+
+// The NormRecvBatch class receives up to "batch size" datagrams from a
+// ProtoSocket with a single recvmmsg() system call into a ring of
+// pre-allocated NormMsg buffers, along with each datagram's source and
+// (IP_PKTINFO) destination address and (IP_TOS / IPV6_TCLASS) ECN status.
+// Note each NormMsg buffer is NormMsg::MAX_SIZE bytes so large batch sizes
+// use a fair amount of memory.
+
+class NormRecvBatch
+{
+    public:
+        NormRecvBatch();
+        ~NormRecvBatch();
+
+        static bool IsSupported();
+
+        // A "batchSize" of zero (or one) disables batching
+        bool Init(unsigned int batchSize);
+        void Destroy();
+        bool IsEnabled() const
+            {return (0 != batch_size);}
+        unsigned int GetSize() const
+            {return batch_size;}
+
+        // Returns number of datagrams received, zero if none
+        // were ready, or -1 on socket error
+        int Recv(ProtoSocket& theSocket);
+
+        NormMsg& AccessMsg(unsigned int index)
+            {return msg_list[index];}
+        unsigned int GetMsgLength(unsigned int index) const
+            {return msg_length[index];}
+        const ProtoAddress& GetDestAddr(unsigned int index) const
+            {return dst_addr[index];}
+        // The kernel receive time (SCM_TIMESTAMPNS) of the datagram when the
+        // socket has SO_TIMESTAMPNS set (zero otherwise)
+        const struct timeval& GetRxTime(unsigned int index) const
+            {return rx_time[index];}
+        // True if the datagram was marked ECN "congestion experienced" (the
+        // socket must have IP_RECVTOS / IPV6_RECVTCLASS set to get this)
+        bool GetEcnStatus(unsigned int index) const
+            {return (ProtoSocket::ECN_CE == (traffic_class[index] & ProtoSocket::ECN_CE));}
+        // The socket's cumulative overflow drop count (SO_RXQ_OVFL) as of the
+        // latest datagram received that carried it (false if none has)
+        bool GetDropCount(UINT32& dropCount) const
+        {
+            dropCount = drop_count;
+            return drop_count_valid;
+        }
+
+    private:
+        unsigned int        batch_size;
+        NormMsg*            msg_list;
+        unsigned int*       msg_length;
+        ProtoAddress*       dst_addr;
+        struct timeval*     rx_time;
+        UINT8*              traffic_class;
+        UINT32              drop_count;
+        bool                drop_count_valid;
+#ifdef NORM_RECV_BATCH
+        struct mmsghdr*     hdr_list;
+        struct iovec*       iov_list;
+        char*               name_buffer;     // source sockaddr storage
+        char*               control_buffer;  // IP_PKTINFO / IPV6_PKTINFO, IP_TOS / IPV6_TCLASS,
+                                             // SCM_TIMESTAMPNS and SO_RXQ_OVFL
+#endif // NORM_RECV_BATCH
+
+};  // end class NormRecvBatch
+
+// The NormSendBatch class collects copies of outbound datagrams and sends
+// them with a single sendmmsg() system call when flushed.  Where UDP generic
+// segmentation offload is available (UDP_SEGMENT, Linux 4.18+), a batch of
+// equal size datagrams to the same destination is instead sent as one
+// "super" datagram for the kernel (or NIC) to segment.  Each batch slot is
+// NormMsg::MAX_SIZE bytes.
+//
+// Datagrams may also be queued with an "earliest departure time" that is
+// passed to the kernel as an SCM_TXTIME control message (Linux 4.19+) so
+// the "fq" or "etf" qdisc spaces them on the wire.  The socket must have
+// the SO_TXTIME option set (see NormSession::SetTxTimePacing()) and GSO
+// is not used for batches with departure times.
+
+class NormSendBatch
+{
+    public:
+        NormSendBatch();
+        ~NormSendBatch();
+
+        static bool IsSupported();
+
+        // A "batchSize" of zero (or one) disables batching
+        bool Init(unsigned int batchSize);
+        void Destroy();
+        bool IsEnabled() const
+            {return (0 != batch_size);}
+        unsigned int GetSize() const
+            {return batch_size;}
+        bool IsEmpty() const
+            {return (0 == msg_count);}
+        bool IsFull() const
+            {return (msg_count >= batch_size);}
+
+        // Copies a datagram into the batch (returns false if full). A nonzero
+        // "txTime" is the departure time (nsec per the socket's SO_TXTIME clock).
+        bool Queue(const char* buffer, unsigned int numBytes, const ProtoAddress& dstAddr,
+                   UINT64 txTime = 0);
+
+        enum FlushStatus {FLUSH_OK, FLUSH_BLOCKED, FLUSH_FAILED};
+        // Sends the queued datagrams.  When BLOCKED, the unsent remainder stays
+        // queued (in order) for the next Flush().  When FAILED, the datagrams
+        // that could not be sent are discarded.
+        FlushStatus Flush(ProtoSocket& theSocket);
+
+    private:
+#ifdef NORM_SEND_BATCH
+        bool GsoFlush(int fd, FlushStatus& status);
+#endif // NORM_SEND_BATCH
+
+        unsigned int        batch_size;
+        unsigned int        msg_count;
+        unsigned int        msg_index;     // first unsent queued datagram
+        char*               msg_buffer;
+#ifdef NORM_SEND_BATCH
+        struct mmsghdr*     hdr_list;
+        struct iovec*       iov_list;
+        char*               name_buffer;   // destination sockaddr storage
+        char*               control_buffer;  // SCM_TXTIME departure times
+        bool                gso_enable;    // cleared if UDP_SEGMENT sends fail
+        bool                tx_time_queued;  // some queued datagrams have a "txTime"
+#endif // NORM_SEND_BATCH
+
+};  // end class NormSendBatch
+
+#endif // _NORM_MSG_BATCH
@@ -4,6 +4,9 @@
 #include "normMessage.h"
 #include "normObject.h"
 #include "normEncoder.h"
+#include "normFecWorker.h"
+#include "normTimerWheel.h"
+#include "normHistogram.h"
 #include "protokit.h"
 
 class NormNode
@@ -124,9 +127,13 @@ class NormLossEstimator2
         NormLossEstimator2();
         void SetLossEventWindow(double theTime)
             {event_window = theTime;}
+        // A non-NULL "excuseCount" is a count of datagrams known to have been
+        // dropped locally (not by the network), which are taken out of (and
+        // deducted from the count by) any outage found
         bool Update(const struct timeval&   currentTime,
                     unsigned short          seqNumber, 
-                    bool                    ecn = false);
+                    bool                    ecn = false,
+                    unsigned int*           excuseCount = NULL);
         double LossFraction();
         void SetInitialLoss(double lossFraction) 
         {
@@ -210,6 +217,73 @@ class NormCongestionDetector
     //
 };  // end class NormCongestionDetector
 
+class NormBandwidthModel
+{
+    // This class implements a BBR-style model of the path to the
+    // current limiting receiver (CLR): a windowed max of delivery rate
+    // samples (the bottleneck bandwidth) and a windowed min RTT.  The
+    // sender paces at "pacing gain" times the bandwidth estimate.  The
+    // gain cycles through STARTUP (fill the path quickly), DRAIN (drain
+    // the queue STARTUP built), PROBE_BW (periodically probe for more
+    // bandwidth) and PROBE_RTT (briefly back off to refresh the min RTT)
+    // as in BBR.  NORM has no congestion window, so rate alone is used
+    // to keep standing queues short.
+    public:
+        enum State {STARTUP, DRAIN, PROBE_BW, PROBE_RTT};
+            
+        NormBandwidthModel();
+        void Reset();
+        
+        // "now" and "rtt" are in seconds, "rate" in bytes/sec (zero if
+        // no delivery rate sample is available)
+        void Update(double now, double rtt, double rate);
+        // Caps the bandwidth estimate (e.g., upon heavy loss)
+        void LimitBtlBw(double rate);
+        
+        bool IsValid() const {return (btl_bw > 0.0);}
+        double GetPacingRate() const {return (pacing_gain * btl_bw);}
+        double GetBtlBw() const {return btl_bw;}
+        double GetMinRtt() const {return min_rtt;}
+        State GetState() const {return state;}
+        
+    private:
+        void EnterState(State newState, double now);
+        void UpdateBtlBw(double now, double rate);
+        
+        static const double STARTUP_GAIN;
+        static const double MIN_RTT_WINDOW;      // seconds
+        static const double PROBE_RTT_DURATION;  // seconds
+        static const double QUEUE_RTT_FACTOR;    // RTT over min RTT that means a queue
+        static const double PROBE_BW_GAIN[];
+        enum
+        {
+            BW_WINDOW_ROUNDS = 10,  // max filter window, in (min RTT) rounds
+            PROBE_BW_PHASES = 8,
+            FULL_BW_ROUNDS = 3,     // rounds without growth for full pipe
+            DRAIN_ROUNDS_MAX = 4    // max rounds to hold a queue draining gain
+        };
+        
+        struct Sample
+        {
+            double  value;
+            double  time;
+        };
+            
+        State           state;
+        double          state_start;
+        double          pacing_gain;
+        double          btl_bw;
+        Sample          bw_sample[3];  // (windowed max, as in Linux "win_minmax")
+        double          min_rtt;
+        double          min_rtt_time;
+        double          round_start;
+        double          full_bw;
+        unsigned int    full_bw_count;
+        bool            filled_pipe;
+        unsigned int    cycle_index;
+        double          cycle_start;
+};  // end class NormBandwidthModel
+
 class NormAckingNode : public NormNode
 {
     public:
@@ -229,9 +303,34 @@ class NormAckingNode : public NormNode
         bool AckReceived() const {return ack_received;}
         void MarkAckReceived() {ack_received = true;}
         
+        // ACK state for the session's older, still outstanding "pipelined"
+        // watermarks (see NormSession::SenderAddWatermark()), by ring slot
+        bool PipelineAckReceived(unsigned int slot) const 
+            {return (0 != (pipeline_ack_mask & ((UINT32)1 << slot)));}
+        void MarkPipelineAck(unsigned int slot) 
+            {pipeline_ack_mask |= ((UINT32)1 << slot);}
+        void ClearPipelineAck(unsigned int slot) 
+            {pipeline_ack_mask &= ~((UINT32)1 << slot);}
+        void ClearPipelineAcks() {pipeline_ack_mask = 0;}
+        
         bool SetAckEx(const char* buffer, UINT16 numBytes);
         bool GetAckEx(char* buffer, unsigned int* buflen);
         
+        // Watermark requests for a node with an ACK aggregator (see
+        // NormSession::SenderSetAckingNodeAggregator()) list the aggregator
+        // instead (except for the node's last request attempt)
+        void SetAggregatorId(NormNodeId aggregatorId)
+            {aggregator_id = aggregatorId;}
+        NormNodeId GetAggregatorId() const
+            {return aggregator_id;}
+        bool IsAggregated() const
+            {return ((NORM_NODE_NONE != aggregator_id) && (GetId() != aggregator_id));}
+        // The watermark flush this node (or aggregator) was last listed in
+        void SetFlushSerial(UINT32 serial)
+            {flush_serial = serial;}
+        UINT32 GetFlushSerial() const
+            {return flush_serial;}
+        
         /*
         const char* GetAppAckContent() const
             {return (const char*)ack_ex_buffer;}
@@ -241,8 +340,11 @@ class NormAckingNode : public NormNode
     private:
         bool            ack_received; // was ack received?
         unsigned int    req_count;    // remaining request attempts
+        UINT32          pipeline_ack_mask;  // pipelined watermark slots acked
         char*           ack_ex_buffer;
         unsigned int    ack_ex_length;
+        NormNodeId      aggregator_id;
+        UINT32          flush_serial;
         
 };  // end NormAckingNode
 
@@ -319,6 +421,13 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
             SYNC_STREAM,   // same as SYNC_CURRENT, but attempts to recover stream block zero
             SYNC_ALL      // permiscuously sync as far back as possible given rx cache size
         };
+        
+        // Which buffered block GetFreeBlock() steals when the block pool is exhausted
+        enum EvictionPolicy
+        {
+            EVICT_ORDINAL, // newest block of newest object (oldest/oldest for silent or realtime receivers)
+            EVICT_SCORED   // least costly block to lose (see NormObject::GetEvictionCandidate())
+        };
     
         NormSenderNode(class NormSession& theSession, NormNodeId nodeId);  
         ~NormSenderNode();
@@ -352,6 +461,11 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         void SetSyncPolicy(SyncPolicy syncPolicy)
             {sync_policy = syncPolicy;}
         
+        EvictionPolicy GetEvictionPolicy() const
+            {return eviction_policy;}
+        void SetEvictionPolicy(EvictionPolicy evictionPolicy)
+            {eviction_policy = evictionPolicy;}
+        
         bool UnicastNacks() {return unicast_nacks;}
         void SetUnicastNacks(bool state) {unicast_nacks = state;}
         
@@ -380,6 +494,10 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         void HandleCCFeedback(UINT8 ccFlags, double ccRate);
         void HandleNackMessage(const NormNackMsg& nack);
         void HandleAckMessage(const NormAckMsg& ack);
+        // Called for a local repairer's retransmission of this sender's data
+        // (see NormSession::ReceiverSetLocalRepair())
+        void LocalRepairHeard()
+            {local_nack_sent = false;}
         
         bool Open(UINT16 instanceId);
         UINT16 GetInstanceId() {return instance_id;}
@@ -394,6 +512,9 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
                              UINT16         numParity);
         bool BuffersAllocated() {return (NULL != retrieval_pool);}
         void FreeBuffers();
+        // Touches the allocated buffer pages so the first packets from
+        // the sender don't take page faults
+        void Prefault();
         void Activate(bool isObjectMsg);
         
         bool SyncTest(const NormObjectMsg& msg) const;
@@ -448,6 +569,7 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         NormBlock* GetFreeBlock(NormObjectId objectId, NormBlockId blockId);
         void PutFreeBlock(NormBlock* block)
         {
+            if (block->DecodePending()) AbandonDecode(block);
             block->EmptyToPool(segment_pool);
             block_pool.Put(block);   
         }
@@ -481,11 +603,34 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
             return s;   
         }
         
-        UINT16 Decode(char** segmentList, UINT16 numData, UINT16 erasureCount)
+        UINT16 Decode(char** segmentList, UINT16 numData, UINT16 erasureCount);
+        // Returns false if no decoder is allocated
+        bool GetDecoderCacheStats(unsigned long& hits, unsigned long& misses)
         {
-            return decoder->Decode(segmentList, numData, erasureCount, erasure_loc);
+            if (NULL == decoder) return false;
+            rx_fec_pool.GetDecoderCacheStats(hits, misses);
+            hits += decoder->GetMatrixCacheHits();
+            misses += decoder->GetMatrixCacheMisses();
+            return true;
         }
         
+        // Optional FEC worker threads decode completed blocks off the protocol
+        // thread (see NormObject::SubmitBlockDecode() and NormSession::SetRxFecWorkerCount())
+        bool DecodeWorkersActive() const
+            {return rx_fec_pool.IsActive();}
+        char** ReserveDecodeJob(NormBlock* block)
+            {return rx_fec_pool.Reserve(block);}
+        void CancelDecodeJob(NormBlock* block)
+            {rx_fec_pool.Cancel(block);}
+        // Submits the block decode using the current "erasure_loc" list
+        void SubmitDecodeJob(NormObject* obj, NormBlock* block, UINT16 numData, UINT16 erasureCount);
+        // Starts a NACK-to-repair latency measurement (if not already timing one)
+        void MarkRepairWait();
+        // Waits for the block's decode job (if any) and discards the result
+        void AbandonDecode(NormBlock* block);
+        // Writes completed decode results to their objects (in order per object)
+        void MergeDecodes();
+        
         void CalculateGrttResponse(const struct timeval& currentTime,
                                    struct timeval&       grttResponse) const;
         
@@ -512,9 +657,26 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
             {return recv_goodput.GetScaledValue(1.0 / interval);}
         
         void IncrementRecvTotal(unsigned long count) 
-            {recv_total.Increment(count);}
+        {
+            recv_total.Increment(count);
+            recv_bytes += count;
+        }
         void IncrementRecvGoodput(unsigned long count) 
-            {recv_goodput.Increment(count);}
+        {
+            recv_goodput.Increment(count);
+            goodput_bytes += count;
+        }
+        void IncrementRecvSegments()
+            {recv_segment_count++;}
+        // (these are cumulative, unlike the recv rate accumulators)
+        UINT64 RecvBytes() const {return recv_bytes;}
+        UINT64 GoodputBytes() const {return goodput_bytes;}
+        UINT64 RecvSegmentCount() const {return recv_segment_count;}
+        UINT64 DecodeCount() const {return decode_count;}
+        // Latency histograms (when NormSession::SetLatencyStats() is enabled)
+        const NormHistogram& GetObjectLatency() const {return object_latency;}
+        const NormHistogram& GetRepairLatency() const {return repair_latency;}
+        const NormHistogram& GetDecodeLatency() const {return decode_latency;}
         void ResetRecvStats() 
         {
             recv_total.Reset();
@@ -596,6 +758,8 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
             
         static const double DEFAULT_NOMINAL_INTERVAL;
         static const double ACTIVITY_INTERVAL_MIN;
+        static const double DECODE_POLL_INTERVAL;
+        enum {EVICT_SCAN_MAX = 64};  // max blocks scored per EVICT_SCORED steal
         
         bool PassiveRepairCheck(NormObjectId    objectId,  
                                 NormBlockId     blockId,
@@ -605,26 +769,45 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
                          NormBlockId            blockId,
                          NormSegmentId          segmentId);
     
-        bool OnActivityTimeout(ProtoTimer& theTimer);
+        bool OnActivityTimeout(NormTimerWheel::Timer& theTimer);
         bool OnRepairTimeout(ProtoTimer& theTimer);
         bool OnCCTimeout(ProtoTimer& theTimer);
         bool OnAckTimeout(ProtoTimer& theTimer);
+        void AggregateReset(NormObjectId objectId, NormBlockId blockId, NormSegmentId segmentId);
+        void AggregateAck(const NormAckFlushMsg& ack);
+        bool AppendAggregate(NormAckFlushMsg& ack, unsigned int& index);
+        bool OnDecodeTimeout(ProtoTimer& theTimer);
+        
+        // Returns true if the object completed (and was deleted)
+        bool HandleObjectCompletion(NormObject* obj);
         
         void AttachCCFeedback(NormAckMsg& ack);
         void HandleRepairContent(const UINT32* buffer, UINT16 bufferLen);
         void FragmentNack(NormNackMsg& superNack);
+        void SendNack(NormNackMsg& nack);
+        
+        // Local repair (see NormSession::ReceiverSetLocalRepair())
+        enum {LOCAL_REPAIR_MAX = 256};  // max segments sent per overheard NACK
+        void LocalRepair(const UINT32* buffer, UINT16 bufferLen);
+        bool LocalRepairLoad(NormObject& obj, NormBlockId blockId);
+        bool LocalRepairParity();
+        bool LocalRepairSend(NormObject& obj, NormSegmentId segmentId);
+        void LocalRepairFree();
         
         
          
         UINT16                  instance_id;
         int                     robust_factor;
         SyncPolicy              sync_policy;
+        EvictionPolicy          eviction_policy;
         bool                    synchronized;
         NormObjectId            sync_id;  // only valid if(synchronized)
         NormObjectId            next_id;  // only valid if(synchronized)
         NormObjectId            max_pending_object; // index for NACK construction
         NormObjectId            current_object_id;  // index for suppression
         UINT16                  max_pending_range;  // max range of pending objs allowed
+        unsigned long           rx_buffer_space;    // (session default or sender quota)
+        unsigned long           rx_memory_reserved; // (of the session mgr rx memory budget)
         
         bool                    is_open;
         // TBD - embed the FTI parameters into a NormFtiData object
@@ -644,6 +827,18 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         RepairBoundary          repair_boundary;
         NormObject::NackingMode default_nacking_mode;
         bool                    unicast_nacks;
+        bool                    local_nack_sent;    // last NACK round was site scoped
+        NormEncoder*            local_encoder;      // (local repairer parity)
+        char**                  local_vectors;      // a block's source then parity segments
+        unsigned int            local_vector_count;
+        UINT16                  local_vector_size;
+        UINT16*                 local_lengths;      // source segment lengths (zero if not held)
+        NormObjectId            local_object_id;
+        NormBlockId             local_block_id;
+        UINT16                  local_block_len;
+        UINT16                  local_seg_max;
+        bool                    local_block_valid;
+        bool                    local_parity_ready;
         NormBlockPool           block_pool;
         NormSegmentPool         segment_pool;
         NormDecoder*            decoder;
@@ -651,9 +846,11 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         unsigned int*           retrieval_loc;
         char**                  retrieval_pool;
         unsigned int            retrieval_index;
+        NormFecWorkerPool       rx_fec_pool;
+        ProtoTimer              decode_timer;  // polls "rx_fec_pool" for results
         
         bool                    sender_active;
-        ProtoTimer              activity_timer;
+        NormTimerWheel::Timer   activity_timer;  // (in the session mgr "timer_wheel")
         ProtoTimer              repair_timer;
         
         // Watermark acknowledgement
@@ -665,6 +862,16 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         bool                    ack_ex_pending;
         char*                   ack_ex_buffer;
         unsigned int            ack_ex_length;
+        bool                    ack_via_aggregator; // (see NormSession::ReceiverSetAckAggregator())
+        // ACK aggregator state: the (sorted) ids of the receivers that have
+        // ACKed the "agg_*" watermark to us
+        NormNodeId*             agg_list;
+        unsigned int            agg_count;
+        unsigned int            agg_size;
+        bool                    agg_valid;
+        NormObjectId            agg_object_id;
+        NormBlockId             agg_block_id;
+        NormSegmentId           agg_segment_id;
         
         // Remote sender grtt measurement state       
         double                  grtt_estimate;
@@ -713,6 +920,15 @@ class NormSenderNode : public NormNode, public ProtoTree::Item
         unsigned long           suppress_count;
         unsigned long           completion_count;
         unsigned long           failure_count;     // usually due to re-syncs
+        UINT64                  recv_bytes;
+        UINT64                  goodput_bytes;
+        UINT64                  recv_segment_count;  // NORM_DATA messages
+        UINT64                  decode_count;        // blocks FEC decoded
+        NormHistogram           object_latency;      // first message to object complete
+        NormHistogram           repair_latency;      // NACK (or suppression) to first repair
+        NormHistogram           decode_latency;      // (inline) FEC decode time
+        ProtoTime               repair_wait_time;
+        bool                    repair_waiting;
         
 };  // end class NormSenderNode
     
@@ -734,8 +950,22 @@ class NormNodeTree
         void Destroy();    // delete all nodes in tree
        
     private: 
+        // An open-addressing (linear probing) hash index of the
+        // attached nodes makes FindNodeById() O(1) for large groups
+        // (the tree still provides ordered iteration)
+        enum {HASH_SIZE_MIN = 64};
+        unsigned int HashIndex(NormNodeId nodeId) const
+            {return ((UINT32)(nodeId * 2654435761UL) >> (32 - hash_bits)) & (hash_size - 1);}
+        bool HashInsert(NormNode* node);
+        void HashRemove(NormNode* node);
+        bool HashResize(unsigned int numBits);
+        
     // Members
-        NormNode* root;
+        NormNode*       root;
+        NormNode**      hash_table;  // (NULL if allocation failed)
+        unsigned int    hash_bits;
+        unsigned int    hash_size;
+        unsigned int    hash_count;
 };  // end class NormNodeTree
 
 class NormNodeTreeIterator
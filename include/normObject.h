@@ -4,6 +4,8 @@
 #include "normSegment.h"  // NORM segmentation classes
 #include "normEncoder.h"
 #include "normFile.h"
+#include "normFileIo.h"
+#include "protoTimer.h"
 
 #include <stdio.h>
 
@@ -101,6 +103,10 @@ class NormObject
         const char* GetInfo() const {return info_ptr;}
         UINT16 GetInfoLength() const {return info_len;}
         bool IsStream() const {return (STREAM == type);}
+        // The highest symbol id of the FEC payload id format is never a block
+        // symbol, so it marks stream window repairs (see NormWindowRepairExtension)
+        NormSegmentId WindowRepairId() const
+            {return (((5 == fec_id) || ((2 == fec_id) && (8 == fec_m))) ? 0x00ff : 0xffff);}
         
         class NormSession& GetSession() const {return session;}
         NormNodeId LocalNodeId() const;
@@ -145,9 +151,22 @@ class NormObject
                                    NormSegmentId  segmentId,
                                    char*          buffer) = 0;
         
+        // Receivers use this to copy a source segment they already
+        // hold (for local repair).  Returns zero if the segment isn't held.
+        UINT16 ReceiverReadSegment(NormBlockId    blockId, 
+                                   NormSegmentId  segmentId,
+                                   char*          buffer);
+        
         virtual char* RetrieveSegment(NormBlockId   blockId,
                                       NormSegmentId segmentId) = 0;
         
+        // Returns a pointer to segment content that remains valid while queued
+        // for transmission (or NULL, so ReadSegment() is used instead)
+        virtual const char* ReferenceSegment(NormBlockId    blockId,
+                                             NormSegmentId  segmentId,
+                                             UINT16&        length)
+            {return NULL;}
+        
         NackingMode GetNackingMode() const {return nacking_mode;}
         void SetNackingMode(NackingMode nackingMode) 
         {
@@ -156,6 +175,27 @@ class NormObject
             // to prompt repair process if needed
         }
         
+        // Sender share (in segments per round) once the session interleaves
+        // objects by weight (see NormSession::SenderSetObjectWeight())
+        unsigned int GetTxWeight() const {return tx_weight;}
+        void SetTxWeight(unsigned int weight) 
+            {tx_weight = (0 != weight) ? weight : 1;}
+        
+        // Latency statistics start time (tx enqueue or first rx message),
+        // GetLatency() gives the time since and clears it
+        void MarkLatencyTime()
+        {
+            latency_time.GetCurrentTime();
+            latency_pending = true;
+        }
+        bool LatencyPending() const
+            {return latency_pending;}
+        double GetLatency()
+        {
+            latency_pending = false;
+            return ProtoTime::Delta(ProtoTime().GetCurrentTime(), latency_time);
+        }
+        
         // These are only valid after object is open
         NormBlockId GetFinalBlockId() const {return final_block_id;}
         UINT32 GetBlockSize(NormBlockId blockId) const
@@ -166,6 +206,29 @@ class NormObject
         
         NormObjectSize GetBytesPending() const;
         
+        // Byte range of a (DATA or FILE) object's FEC block
+        NormObjectSize GetBlockOffset(NormBlockId blockId) const;
+        NormObjectSize GetBlockLength(NormBlockId blockId) const;
+        // Progressive receive mode: gets (and clears) the lowest numbered 
+        // block completed since last asked (see NormSession::RcvrSetProgressive())
+        bool ReceiverGetCompletedBlock(NormBlockId& blockId);
+        
+        // Cut-through relay (see NormSession::SetRelaySession()).  A relay
+        // is a DATA tx object that sends the data of a received "source" 
+        // object, each FEC block becoming tx pending as the source block 
+        // completes.  The relay retains its source until it is closed.
+        bool IsRelay() const
+            {return (0 != relay_ready.GetSize());}
+        bool RelayOpen(NormObject& source);
+        bool RelaySetReady(NormBlockId blockId);
+        bool RelayIsReady(NormBlockId blockId) const
+            {return (!IsRelay() || relay_ready.Test(blockId.GetValue()));}
+        bool RelayIsComplete() const;
+        NormObject* GetRelayObject() const
+            {return relay_object;}
+        NormObject* GetRelaySource() const
+            {return relay_source;}
+        
         bool IsPending(bool flush = true) const;
         bool IsRepairPending();
         bool IsPendingInfo() {return pending_info;}
@@ -223,6 +286,19 @@ class NormObject
         bool NextSenderMsg(NormObjectMsg* msg);
         NormBlock* SenderRecoverBlock(NormBlockId blockId);
         bool CalculateBlockParity(NormBlock* block);
+        bool SubmitBlockParity(NormBlock* block);
+        // Enables the session parity cache (see NormSession::SetTxParityCache())
+        // for this object with "contentKey" identifying its content (it is
+        // combined with the object size and FEC parameters)
+        void SenderSetParityKey(UINT64 contentKey);
+        // Fills the block's parity from the cache (if it is there)
+        bool SenderRetrieveParity(NormBlock* block);
+        // Stores the (ready) block parity in the cache (once per block)
+        void SenderCacheParity(NormBlock* block);
+        // Starts the object's content digest (see NormSession::SetTxDigest()),
+        // which is summed as the first transmission pass reads the source
+        // segments (see SenderDigestSegment()) and then carried by its messages
+        void SenderStartDigest();
         
         /*bool IsFirstPass() {return first_pass;}
         void ClearFirstPass() {first_pass = false};*/
@@ -250,15 +326,42 @@ class NormObject
         
         // Methods available to receiver for reception
         bool Accepted() {return accepted;}
+        // Content digest (sender computed or receiver advertised)
+        bool HasDigest() const {return (DIGEST_SET == digest_status);}
+        UINT32 GetDigest() const {return digest;}
+        // Receivers don't verify objects they didn't write all of (e.g. resumed files)
+        void ReceiverIgnoreDigest() {digest_status = DIGEST_IGNORED;}
+        // False if the sender advertised a digest the received content doesn't match
+        // (objects completed before the sender's digest value arrived aren't verified)
+        bool ReceiverVerifyDigest() const 
+            {return ((DIGEST_SET != digest_status) || (digest_sum == digest));}
         void HandleObjectMessage(const NormObjectMsg& msg,
                                  NormMsg::Type        msgType,
                                  NormBlockId          blockId,
                                  NormSegmentId        segmentId);
+        // Hands a completed block to the sender node's FEC decode workers
+        bool SubmitBlockDecode(NormBlock* block);
+        // Writes a FEC worker's decoded segments to the object
+        void ReceiverMergeDecode(NormBlock*             block,
+                                 char**                 vectorList,
+                                 unsigned int           erasureCount,
+                                 const unsigned int*    erasureLocs,
+                                 bool                   decoded);
         
         
         // Used by receiver for resource management scheme
         NormBlock* StealNewestBlock(bool excludeBlock, NormBlockId excludeId = 0);
         NormBlock* StealOldestBlock(bool excludeBlock, NormBlockId excludeId = 0);
+        // Returns the buffered block least costly to lose (fewest segments
+        // received, not yet NACKed) if it costs less than "costMin" (which
+        // is then updated), scoring at most "scanCount" blocks
+        NormBlock* GetEvictionCandidate(bool            excludeBlock, 
+                                        NormBlockId     excludeId,
+                                        bool            preferNewer,
+                                        unsigned int&   costMin,
+                                        unsigned int&   scanCount);
+        void StealBlock(NormBlock* block)
+            {block_buffer.Remove(block);}
         bool ReclaimSourceSegments(NormSegmentPool& segmentPool);
         bool PassiveRepairCheck(NormBlockId   blockId,
                                 NormSegmentId segmentId);
@@ -292,6 +395,19 @@ class NormObject
                    const NormObjectId&      objectId); 
     
         void Accept() {accepted = true;}
+        
+        // (posts RX_OBJECT_BLOCK_COMPLETED in progressive receive mode)
+        void ReceiverBlockCompleted(NormBlockId blockId);
+        void ReceiverGetDigest(const NormObjectMsg& msg);
+        // Adds a written source segment to its block's digest
+        void ReceiverDigestSegment(NormBlock* block, NormSegmentId segmentId, const char* buffer);
+        UINT16 GetSegmentLength(NormBlockId blockId, NormSegmentId segmentId) const
+        {
+            return (((blockId == final_block_id) && (segmentId == (GetBlockSize(blockId) - 1))) ?
+                        final_segment_size : segment_size);
+        }
+        void RelayMaskPending();
+        void RelayClose();
 
 #ifdef USE_PROTO_TREE    
         // Proto::Tree item required overrides
@@ -333,12 +449,42 @@ class NormObject
         UINT16                final_segment_size;
         NackingMode           nacking_mode;
         ProtoTime             last_nack_time;  // time of last NACK received (used for flow control)
+        unsigned int          tx_weight;
+        ProtoTime             latency_time;
+        bool                  latency_pending;
+        NormBitmask           completed_blocks;  // progressive receive mode, blocks not yet reported
+        NormBitmask           relay_ready;       // relay tx object, source blocks completed
+        NormObject*           relay_source;      // (retained) received object we relay
+        NormObject*           relay_object;      // relay tx object of this received object
         char*                 info_ptr;
         UINT16                info_len;
+        UINT64                parity_key;  // sender parity cache key (zero if not cached)
+        // Adds a source segment read for the first pass to a DIGEST_PENDING sender
+        // digest, returning true once that completes it (segments sent again are
+        // skipped since the first pass reads them in order)
+        bool SenderDigestSegment(NormBlockId    blockId,
+                                 NormSegmentId  segmentId,
+                                 const char*    buffer,
+                                 UINT16         len);
+        enum DigestStatus
+        {
+            DIGEST_NONE,     // none (receiver: the sender's not known yet)
+            DIGEST_PENDING,  // sender still summing it (the value is to come)
+            DIGEST_SET,
+            DIGEST_IGNORED,  // (receiver) not verified
+            DIGEST_ABSENT    // (receiver) the sender doesn't use one
+        };
+        DigestStatus          digest_status;
+        UINT32                digest;      // sender computed (or advertised to receiver)
+        UINT32                digest_sum;  // digest of the completed blocks (receiver) or 
+                                           // of the source segments read so far (sender)
+        NormBlockId           digest_block;    // (sender) next segment SenderDigestSegment() 
+        NormSegmentId         digest_segment;  // expects
         
         // Here are some members used to let us know
         // our status with respect to the rest of the world
         bool                  first_pass;   // for sender objects
+        bool                  info_sent;    // sender: NORM_INFO sent this pass (so resends are repairs)
         bool                  accepted;
         bool                  notify_on_update;
         
@@ -367,6 +513,7 @@ class NormFileObject : public NormObject
         const char* GetPath() {return path;}
         bool Rename(const char* newPath) 
         {
+            DrainFileIo();  // (the file is closed and reopened)
             bool result = file.Rename(path, newPath);
             result ? strncpy(path, newPath, PATH_MAX) : NULL;
             return result;
@@ -384,12 +531,62 @@ class NormFileObject : public NormObject
         
         virtual char* RetrieveSegment(NormBlockId   blockId,
                                       NormSegmentId segmentId);
+        
+        virtual const char* ReferenceSegment(NormBlockId    blockId,
+                                             NormSegmentId  segmentId,
+                                             UINT16&        length);
             
     //private:
-        char            path[PATH_MAX+10];
-        NormFile        file;
-        NormObjectSize  large_block_length;
-        NormObjectSize  small_block_length;
+        NormFile::Offset GetSegmentOffset(NormBlockId blockId, NormSegmentId segmentId) const;
+        // Copies the segment from a completed read-ahead chunk (if there is
+        // one) and keeps the read-ahead queue ahead of sequential reads
+        bool ReadAhead(NormFile::Offset offset, char* buffer, size_t len);
+        // Cancels read-ahead and waits for pending writes to complete
+        bool DrainFileIo();
+        
+        // Receive journal (see NormSession::SetRxFileJournal()).  JournalOpen()
+        // recovers a journaled partial reception of this object (renaming its
+        // file to "thePath" and unsetting its completed blocks) and returns true
+        // if the reception is resumed.  JournalBlock() records a completed block
+        // and the journal is written every JOURNAL_SYNC_BLOCKS blocks (after the
+        // file writes complete so it never claims blocks that weren't written)
+        bool JournalOpen(const char* thePath);
+        void JournalBlock(NormBlockId blockId);
+        bool JournalSync();
+        // Removes the journal if reception completed (else syncs and keeps it)
+        void JournalClose();
+        bool JournalGetPath(char* pathBuffer);
+        void JournalGetHeader(char* buffer);
+        
+        enum
+        {
+            READ_AHEAD_COUNT = 4,       // chunks kept in flight
+            READ_AHEAD_CHUNK = 65536,   // (rounded down to a segment multiple)
+            FILE_BUFFER_MAX  = 4194304  // NormFile buffer limit for huge blocks
+        };
+        enum
+        {
+            JOURNAL_HEADER_SIZE = 30,   // object identity and FTI (then path and block mask)
+            JOURNAL_SYNC_BLOCKS = 32
+        };
+        static const char JOURNAL_MAGIC[8];
+        
+        char                        path[PATH_MAX+10];
+        NormFile                    file;
+        NormObjectSize              large_block_length;
+        NormObjectSize              small_block_length;
+        NormFileIoEngine*           file_io;  // NULL for inline (or mapped) file access
+        size_t                      read_ahead_size;
+        NormFileIoEngine::Request*  read_ahead[READ_AHEAD_COUNT];
+        NormFile::Offset            read_ahead_chunk[READ_AHEAD_COUNT];
+        NormFile                    journal;
+        bool                        journal_resume;  // Open() keeps the existing file content
+        char*                       journal_mask;    // completed blocks (MSB first)
+        UINT32                      journal_mask_len;
+        NormFile::Offset            journal_mask_offset;
+        unsigned int                journal_pending; // blocks completed since last sync
+        UINT32                      journal_dirty_min;
+        UINT32                      journal_dirty_max;
 };  // end class NormFileObject
 
 class NormDataObject : public NormObject
@@ -409,10 +606,24 @@ class NormDataObject : public NormObject
                   bool        dataRelease,
                   const char* infoPtr = NULL,
                   UINT16      infoLen = 0);
+        // Scatter-gather (tx only) alternative to Open() where the object
+        // data is the concatenation of the (application-owned) buffers listed
+        class Vector
+        {
+            public:
+                const char* ptr;
+                UINT32      len;
+        };
+        bool OpenV(const Vector* vecList,
+                   unsigned int  vecCount,
+                   const char*   infoPtr = NULL,
+                   UINT16        infoLen = 0);
         bool Accept(char* dataPtr, UINT32 dataMax, bool dataRelease);
         void Close();
         
         const char* GetData() {return data_ptr;}
+        void SetDataFreeFunction(DataFreeFunctionHandle freeFunc)
+            {data_free_func = freeFunc;}
         char* DetachData() 
         {
             char* dataPtr = data_ptr;
@@ -431,15 +642,43 @@ class NormDataObject : public NormObject
         virtual char* RetrieveSegment(NormBlockId   blockId,
                                       NormSegmentId segmentId);
         
-        
+        // (tx only) Copies the object content to a new memory-mapped file
+        // "path" (unlinked again once mapped) and releases the application's
+        // data so the object stays repairable without holding on to it (see
+        // NormSession::SetTxCacheSpill()).  Returns false if the file can't
+        // be created or mapped, in which case the object is unchanged.
+        bool Spill(const char* path);
+        bool IsSpilled() const
+            {return spilled;}
             
     private:
+        void FreeData();
+        void ReadVector(UINT32 offset, char* buffer, UINT16 len);
+        void FreeVector()
+        {
+            if (NULL != vec_list) delete[] vec_list;
+            vec_list = NULL;
+            vec_count = vec_index = 0;
+        }
+        
+        class Fragment
+        {
+            public:
+                const char* ptr;
+                UINT32      len;
+                UINT32      offset;  // of fragment within object
+        };
+        
         NormObjectSize          large_block_length;
         NormObjectSize          small_block_length;
         char*                   data_ptr;
         UINT32                  data_max;
         bool                    data_released;   // when true, data_ptr is deleted 
         DataFreeFunctionHandle  data_free_func;
+        Fragment*               vec_list;        // OpenV() buffers (NULL otherwise)
+        unsigned int            vec_count;
+        unsigned int            vec_index;       // last fragment read (reads are mostly sequential)
+        bool                    spilled;         // data_ptr is a (detached) file mapping
         
                                          // on NormDataObject destruction
 };  // end class NormDataObject
@@ -479,6 +718,31 @@ class NormStreamObject : public NormObject
         void SetPushMode(bool state) {push_mode = state;}
         bool GetPushMode() const {return push_mode;}
         
+        // Small write coalescing: with a non-zero "maxDelay" (seconds), a
+        // flushing Write() (or Flush()) that leaves the current segment with
+        // fewer than "minFill" bytes (0 means a full segment) holds it for more
+        // writes instead of queueing it.  The held segment is transmitted once
+        // it fills to "minFill" or "maxDelay" after it was first held, so many
+        // tiny messages share segments.  A zero "maxDelay" disables (and
+        // flushes any held segment).
+        bool SetCoalescing(double maxDelay, UINT16 minFill);
+        bool IsCoalescing() const
+            {return (coalesce_delay > 0.0);}
+        
+        // Posts an RX_OBJECT_UPDATED (clearing "notify_on_update") or
+        // TX_QUEUE_VACANCY notification subject to the session's event
+        // coalescing policy (see NormSession::SetEventCoalescing()).  Each
+        // call counts as one update or vacancy.
+        enum EventType
+        {
+            EVENT_RX_UPDATED  = 0,  // RX_OBJECT_UPDATED
+            EVENT_TX_VACANCY  = 1   // TX_QUEUE_VACANCY
+        };
+        void PostEvent(EventType type);
+        // The number of updates or vacancies the last posted event stood for
+        unsigned int GetEventCount(EventType type) const
+            {return event_hold[type].posted;}
+        
         bool IsOldBlock(NormBlockId blockId) const
             {return (!stream_buffer.IsEmpty() && (Compare(blockId, stream_buffer.RangeLo()) < 0));}
 
@@ -500,7 +764,29 @@ class NormStreamObject : public NormObject
         
             
         bool Read(char* buffer, unsigned int* buflen, bool findMsgStart = false);
+        // Zero-copy alternative to Read(): "buffer" is pointed at up to "buflen"
+        // bytes (0 means no limit) of the current stream segment.  The viewed
+        // segment is locked in the stream buffer until ReadRelease() says how
+        // many of those bytes were consumed (any other Read() also unlocks it)
+        bool ReadView(const char*& buffer, unsigned int& buflen);
+        bool ReadRelease(unsigned int numBytes);
+        bool IsReadViewPending() const
+            {return (0 != read_view_len);}
+        // Reads one whole message (as delimited by the sender's message start
+        // marks) once it is fully buffered.  If the message is larger than
+        // "*buflen", nothing is read and "*buflen" is set to its length.
+        // Otherwise "*buflen" is the message length (zero if none is ready).
+        // It returns false on a stream break (it then resyncs to the next
+        // message start on its own).
+        bool ReadMsg(char* buffer, unsigned int* buflen);
         UINT32 Write(const char* buffer, UINT32 len, bool eom = false);
+        // Zero-copy alternative to Write(): Reserve() returns up to "len"
+        // bytes (0 means as many as possible) of the current segment's free
+        // space for the app to fill in place (NULL if the stream is full) and
+        // Commit() then enqueues the first "len" of them as Write() would.
+        // (Any Write() in between cancels the reservation.)
+        char* Reserve(unsigned int& len);
+        UINT32 Commit(unsigned int len, bool eom = false);
         
         UINT32 GetCurrentReadOffset() {return read_offset;}
         
@@ -530,6 +816,12 @@ class NormStreamObject : public NormObject
                                    NormSegmentId  segmentId,
                                    char*          buffer);
         
+        // Copies a received segment (w/ stream payload header) that is
+        // still buffered, returning zero if it isn't
+        UINT16 ReceiverCopySegment(NormBlockId    blockId, 
+                                   NormSegmentId  segmentId,
+                                   char*          buffer);
+        
         virtual char* RetrieveSegment(NormBlockId   blockId,
                                       NormSegmentId segmentId);
         
@@ -582,10 +874,54 @@ class NormStreamObject : public NormObject
             {return ((blockId == read_index.block) && (segmentId == read_index.segment));}
         
         bool PassiveReadCheck(NormBlockId blockId, NormSegmentId segmentId);
+        
+        // Sliding window repair: a sender stream with a non-zero "window" sends,
+        // after every "interval" source segments, a repair symbol that is a
+        // random linear combination (over GF(2^8), in the spirit of RFC 8681) of
+        // up to the last "window" source segments of the current block (the
+        // window doesn't reach back past the block start).  Receivers solve for
+        // isolated losses from these without a NACK round trip or waiting for
+        // the block's parity (and legacy receivers ignore them).
+        bool SetWindowRepair(UINT16 window, UINT16 interval);
+        UINT16 GetWindowRepairWindow() const
+            {return swr_window;}
+        // (sender) Builds the pending window repair message, if any
+        bool SenderNextWindowRepair(NormDataMsg* msg);
+        void SenderWindowSourceSent(NormBlockId blockId, NormSegmentId segmentId);
+        // (receiver) Buffers a received window repair and returns how many of
+        // "block"'s missing source segments it (with those buffered) recovered
+        unsigned int ReceiverHandleWindowRepair(NormBlock* block, const NormDataMsg& msg);
+        
+        // Stream sync points: a sender stream with a non-zero "interval" puts,
+        // after every "interval" source segments, a NormStreamSyncExtension
+        // naming the latest message start sent (if still buffered) in its
+        // next NORM_DATA.  A new rx stream nothing has been read from yet
+        // moves its start back to it (and has the message's blocks repaired)
+        // instead of waiting for a new message start, and one seeking a
+        // message start after a break moves ahead to it instead of skipping
+        // whole blocks.
+        bool SetSyncInterval(UINT16 interval);
+        UINT16 GetSyncInterval() const
+            {return ssp_interval;}
+        // (sender) Attaches the due sync point extension, if any
+        void SenderAttachSync(NormDataMsg* msg);
+        void SenderSyncSourceSent(NormBlockId blockId, NormSegmentId segmentId);
+        // (receiver) Handles the sync point, if any, of a received NORM_DATA
+        void ReceiverHandleSync(const NormDataMsg& msg, NormBlockId blockId);
          
     private:
-        bool ReadPrivate(char* buffer, unsigned int* buflen, bool findMsgStart = false);
+        bool ReadPrivate(char* buffer, unsigned int* buflen, bool findMsgStart = false,
+                         const char** view = NULL);
         void Terminate();
+        char* AcquireWriteSegment(NormBlock*& block);  // NULL if stream full
+        void CloseWriteSegment(NormBlock* block);
+        bool OnCoalesceTimeout(ProtoTimer& theTimer);
+        bool OnNotifyTimeout(ProtoTimer& theTimer);
+        // (a held event is posted once it's due, "update" counts a new one)
+        void CheckEvent(EventType type, bool update);
+        void FlushCoalesced();  // flushes a held segment now
+        UINT16 CoalesceFill() const
+            {return (((0 == coalesce_fill) || (coalesce_fill > segment_size)) ? segment_size : coalesce_fill);}
         
         class Index
         {
@@ -594,6 +930,46 @@ class NormStreamObject : public NormObject
                 NormSegmentId   segment; 
                 UINT16          offset;
         };
+        // The "msg_index" has a bit per receive stream buffer segment slot
+        // that is set when a segment with a message start arrives so seeking
+        // can jump to the next buffered message start instead of scanning
+        bool FindMsgStart(Index& index);
+        void ReadAdvance(const Index& index);
+        // (the received sync point if it is ahead of the read_index)
+        bool ReceiverSyncPoint(Index& index);
+        bool ReceiverGetSync(const NormObjectMsg& msg, NormBlockId blockId, Index& index) const;
+        UINT32 MsgIndexBit(NormBlockId blockId, NormSegmentId segmentId) const
+            {return ((blockId.GetValue() & msg_index_mask) * ndata + segmentId);}
+        
+        // Window repair coding coefficients (never zero) are an xorshift32
+        // sequence seeded from the repair key, one per window segment in order
+        static UINT32 WindowRepairSeed(UINT16 key)
+            {return ((((UINT32)key + 1) * 2654435761UL) | 1);}
+        static UINT8 WindowRepairCoefficient(UINT32& state)
+        {
+            state ^= (state << 13);
+            state ^= (state >> 17);
+            state ^= (state << 5);
+            return (UINT8)(1 + (state % 255));
+        }
+        static void WindowAddMul(char* dst, const char* src, UINT8 c, unsigned int len);
+        static void WindowScale(char* buffer, UINT8 c, unsigned int len);
+        // (the stream buffer segment without RetrieveSegment()'s error logging)
+        const char* FindStreamSegment(NormBlockId blockId, NormSegmentId segmentId) const;
+        unsigned int ReceiverWindowDecode(NormBlock* block);
+        void FreeWindowRepair();
+        
+        enum {WINDOW_REPAIR_MAX = 8};  // repairs buffered (and so erasures solvable) at once
+        class WindowRepair
+        {
+            public:
+                NormBlockId     block_id;
+                UINT16          first;
+                UINT16          count;
+                UINT16          key;
+                bool            valid;
+                char*           payload;
+        };
         // Extra state for STREAM objects
         bool                        stream_sync;
         NormBlockId                 stream_sync_id;
@@ -604,6 +980,8 @@ class NormStreamObject : public NormObject
         NormBlockBuffer             stream_buffer;
         Index                       write_index;
         UINT32                      write_offset;
+        char*                       write_reserve;      // Reserve()d segment space
+        unsigned int                write_reserve_len;
         Index                       tx_index;
         UINT32                      tx_offset;
         bool                        write_vacancy;
@@ -611,6 +989,10 @@ class NormStreamObject : public NormObject
         Index                       read_index;
         UINT32                      read_offset;
         bool                        read_ready;
+        UINT16                      read_view_len;  // non-zero while ReadView() segment is locked
+        bool                        read_msg_aligned; // read_index is at a message start
+        NormBitmask                 msg_index;
+        UINT32                      msg_index_mask;
         bool                        flush_pending;
         bool                        msg_start;
         FlushMode                   flush_mode;
@@ -618,6 +1000,43 @@ class NormStreamObject : public NormObject
         bool                        stream_broken;
         bool                        stream_closing;
         
+        // Small write coalescing state
+        ProtoTimer                  coalesce_timer;  // (active while a segment is held)
+        double                      coalesce_delay;
+        UINT16                      coalesce_fill;
+        bool                        coalesce_force;  // (FlushCoalesced() in progress)
+        bool                        coalesce_active; // a held flush was FLUSH_ACTIVE
+        
+        // Event coalescing state (indexed by EventType)
+        class EventHold
+        {
+            public:
+                unsigned int    count;      // vacancies or updates not yet posted
+                unsigned int    posted;     // count the last posted event stood for
+                bool            held;
+                ProtoTime       post_time;  // when the last event was posted
+        };
+        EventHold                   event_hold[2];
+        ProtoTimer                  notify_timer;    // (active while an event is held)
+        
+        // Sliding window repair state
+        UINT16                      swr_window;
+        UINT16                      swr_interval;
+        bool                        swr_pending;     // (sender) a repair is due
+        NormBlockId                 swr_block_id;
+        UINT16                      swr_end;         // (sender) window end (segment after the last covered)
+        UINT16                      swr_key;
+        WindowRepair*               swr_list;        // (receiver) buffered repairs
+        char*                       swr_buffer;      // (receiver) repair payloads and decode work space
+        unsigned int                swr_next;        // (receiver) next swr_list slot to (re)use
+        
+        // Stream sync point state
+        UINT16                      ssp_interval;
+        UINT16                      ssp_count;       // (sender) source segments since the last sync point
+        bool                        ssp_pending;     // (sender) a sync point is due
+        bool                        ssp_valid;       // ssp_index is set
+        Index                       ssp_index;       // latest message start sent (sender) or heard of (receiver)
+        
         
         // For threaded API purposes
         UINT32                      block_pool_threshold;
@@ -665,7 +1084,7 @@ class NormObjectTable
         
         NormObjectTable();
         ~NormObjectTable();
-        bool Init(UINT16 rangeMax, UINT16 tableSize = 256);
+        bool Init(UINT16 rangeMax, UINT16 tableSize = NORM_OBJECT_TABLE_SIZE);
         void SetRangeMax(UINT16 rangeMax);
         void Destroy();
         
@@ -723,6 +1142,8 @@ class NormObjectTable
         NormObject**    table;
         UINT16          hash_mask;       
 #endif // if/else USE_PROTO_TREE
+        // (direct-indexed fast path in front of the tree (or hash table))
+        NormIdRing<NormObject> ring;
         UINT16          range_max;  // max range of objects that can be kept
         UINT16          range;      // zero if "object table" is empty
         NormObjectId    range_lo;
@@ -0,0 +1,34 @@
+#ifndef _NORM_PROBE
+#define _NORM_PROBE
+
+// Static (USDT) probe points on NORM's hot paths for perf, bpftrace, etc.
+// Built in when NORM_USDT is defined (CMake NORM_USE_USDT or waf
+// --enable-usdt, Linux with the systemtap <sys/sdt.h> header), and each is
+// then a single "nop" until a tracer attaches.  Otherwise they compile to
+// nothing.  The probes (provider "norm") and their arguments are:
+//
+//   rx_message(type, sourceId, length)       - NormSession::HandleReceiveMessage()
+//   nack_send(senderId, length)              - receiver NACK sent for a sender
+//   tx_repair(objectId, length)              - sender repair DATA transmitted
+//   fec_encode_start/end(numData, worker)    - block parity encoding (worker is
+//                                              1 on a FEC worker thread)
+//   fec_decode_start/end(numData, erasures)  - block decoding (same thread
+//                                              for start and end)
+//   rate_change(oldRate, newRate)            - congestion control rate (bits/sec)
+//   stream_broken(senderId, objectId)        - receive stream overrun (data lost)
+//   block_steal(senderId, objectId)          - block buffer taken from an object
+//                                              (senderId is the local node
+//                                              for the sender's own blocks)
+//
+// (See examples/bpftrace for scripts using them)
+
+#ifdef NORM_USDT
+#include <sys/sdt.h>
+#define NORM_PROBE2(name, a1, a2) DTRACE_PROBE2(norm, name, a1, a2)
+#define NORM_PROBE3(name, a1, a2, a3) DTRACE_PROBE3(norm, name, a1, a2, a3)
+#else
+#define NORM_PROBE2(name, a1, a2)
+#define NORM_PROBE3(name, a1, a2, a3)
+#endif // if/else NORM_USDT
+
+#endif // _NORM_PROBE
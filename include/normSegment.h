@@ -2,6 +2,8 @@
 #define _NORM_SEGMENT
 
 #include "normMessage.h"
+#include "normBitmask.h"
+#include "normIdRing.h"
 #include "protoBitmask.h"
 
 #define USE_PROTO_TREE 1  // for more better performing NormBlockBuffer?
@@ -16,17 +18,43 @@ class NormSegmentPool
         NormSegmentPool();
         ~NormSegmentPool();
         
+        // In "slab" mode, Init() carves cache line aligned segments (so FEC
+        // kernels get aligned vectors) from a single memory mapped region that
+        // may use huge pages (to reduce TLB misses) and be bound to a NUMA
+        // node (where supported, "numaNode" < 0 leaves placement to the OS)
+        enum {CACHE_LINE_SIZE = 64};
+        void SetSlabMode(bool enable, bool hugePages = false, int numaNode = -1)
+        {
+            slab_mode = enable;
+            slab_huge_pages = hugePages;
+            slab_numa_node = numaNode;
+        }
+        // A pool "shared" (set before Init()) allocates nothing itself and
+        // gets/puts the segments of "sharePool" (see NormBufferPool below)
+        void SetSharePool(NormSegmentPool* sharePool)
+            {share_pool = sharePool;}
+        bool IsShared() const
+            {return (NULL != share_pool);}
         bool Init(unsigned int count, unsigned int size);
         void Destroy();        
+        // Touches every page of the pool so the page faults happen now
+        // instead of on first use (e.g. on the first packets of a burst)
+        void Prefault();
         char* Get();
         void Put(char* segment)
         {
+            if (NULL != share_pool)
+            {
+                share_pool->Put(segment);
+                return;
+            }
             ASSERT(seg_count < seg_total);
             *((char**)((void*)segment)) = seg_list;  // this might make a warning on Solaris
             seg_list = segment;
             seg_count++;
         }
-        bool IsEmpty() const {return (NULL == seg_list);}
+        bool IsEmpty() const 
+            {return ((NULL != share_pool) ? share_pool->IsEmpty() : (NULL == seg_list));}
         
         unsigned int CurrentUsage() const 
             {return (seg_total - seg_count);}
@@ -35,11 +63,19 @@ class NormSegmentPool
         unsigned int GetSegmentSize() {return seg_size;}
         
     private: 
+        bool InitSlab(unsigned int count);
+        
         unsigned int    seg_size;
         unsigned int    seg_count;  
         unsigned int    seg_total;
         char*           seg_list;
 		char**          seg_pool;
+        bool            slab_mode;
+        bool            slab_huge_pages;
+        int             slab_numa_node;
+        char*           slab_ptr;       // slab region (instead of "seg_pool")
+        size_t          slab_size;      // (0 if slab_ptr is a new[] allocation)
+        NormSegmentPool* share_pool;
         
         unsigned long   peak_usage;
         unsigned long   overruns;
@@ -58,19 +94,35 @@ class NormBlock
     public:
         enum Flag 
         {
-            IN_REPAIR    = 0x01
+            IN_REPAIR       = 0x01,
+            PARITY_PENDING  = 0x02,  // parity is being computed by a FEC worker thread
+            DECODE_PENDING  = 0x04,  // block is being decoded by a FEC worker thread
+            PARITY_CACHED   = 0x08   // parity is in (or came from) the NormParityCache
         };
             
         NormBlock();
         ~NormBlock();
         const NormBlockId& GetId() const {return blk_id;}
         void SetId(NormBlockId& x) {blk_id = x;}
-        bool Init(UINT16 totalSize);
+        // The caller may provide the "storage" (of GetStorageSize() bytes,
+        // 8-byte aligned) for the block's segment table and masks which are
+        // otherwise allocated separately.  The size is rounded up to a whole
+        // number of UINT64 words (the segment table is an odd number of
+        // words with 4-byte pointers and an odd "totalSize")
+        bool Init(UINT16 totalSize, char* storage = NULL);
         void Destroy();   
+        static size_t GetStorageSize(UINT16 totalSize)
+        {
+            return ((2 * sizeof(UINT64) * NormBitmask::GetWordCount(totalSize) + 
+                     totalSize * sizeof(char*) + 7) & ~((size_t)7));
+        }
         
         void SetFlag(NormBlock::Flag flag) {flags |= flag;}
         void ClearFlag(NormBlock::Flag flag) {flags &= ~flag;}
         bool InRepair() {return (0 != (flags & IN_REPAIR));}
+        bool ParityPending() {return (0 != (flags & PARITY_PENDING));}
+        bool DecodePending() {return (0 != (flags & DECODE_PENDING));}
+        bool ParityCached() {return (0 != (flags & PARITY_CACHED));}
         bool ParityReady(UINT16 ndata) {return (erasure_count == ndata);}
         UINT16 ParityReadiness() {return erasure_count;}
         void IncreaseParityReadiness() {erasure_count++;}
@@ -114,6 +166,8 @@ class NormBlock
             parity_offset = autoParity;  
             flags = 0;
             seg_size_max = 0;
+            nack_loss = 0;
+            auto_parity = autoParity;
             last_nack_time.GetCurrentTime();
         }
         void TxRecover(NormBlockId& blockId, UINT16 ndata, UINT16 nparity)
@@ -126,6 +180,7 @@ class NormBlock
             parity_offset = nparity; // explicit repair mode ???  
             flags = IN_REPAIR;
             seg_size_max = 0;
+            auto_parity = 0;  // (what was sent before is unknown)
         }
         bool TxReset(UINT16 ndata, UINT16 nparity, UINT16 autoParity, 
                      UINT16 segmentSize);
@@ -164,12 +219,23 @@ class NormBlock
             parity_count = 0;
             parity_offset = 0;
             flags = 0;
+            digest_sum = 0;
         }
+        // (receiver) digest of the source segments written so far (it's only
+        // added to the object's digest when the block completes, so segments
+        // written again after the block was stolen aren't counted twice)
+        void AddDigest(UINT32 segmentDigest) {digest_sum += segmentDigest;}
+        UINT32 GetDigest() const {return digest_sum;}
         // Note: This invalidates the repair_mask state.
         bool IsRepairPending(UINT16 ndata, UINT16 nparity); 
         void DecrementErasureCount() {erasure_count--;}
         void IncrementErasureCount() {erasure_count++;}
         UINT16 ErasureCount() const {return erasure_count;}
+        // (sender) largest block loss estimated from NACKs for this block
+        UINT16 GetNackLoss() const {return nack_loss;}
+        void SetNackLoss(UINT16 loss) {nack_loss = loss;}
+        // (sender) auto parity segments sent with the block's latest transmission
+        UINT16 GetAutoParity() const {return auto_parity;}
         void IncrementParityCount() {parity_count++;}
         UINT16 ParityCount() const {return parity_count;}
         
@@ -202,6 +268,26 @@ class NormBlock
             symbolId = (UINT16)index;
             return result;
         }
+        // These find the next run of consecutive pending (or repair)
+        // symbols at or after "symbolId"
+        bool GetNextPendingRun(NormSymbolId& symbolId, UINT16& count) const
+        {
+            UINT32 index = (UINT32)symbolId;
+            UINT32 runLength;
+            if (!pending_mask.GetNextRun(index, runLength)) return false;
+            symbolId = (UINT16)index;
+            count = (UINT16)runLength;
+            return true;
+        }
+        bool GetNextRepairRun(NormSymbolId& symbolId, UINT16& count) const
+        {
+            UINT32 index = (UINT32)symbolId;
+            UINT32 runLength;
+            if (!repair_mask.GetNextRun(index, runLength)) return false;
+            symbolId = (UINT16)index;
+            count = (UINT16)runLength;
+            return true;
+        }
         
         bool SetPending(NormSymbolId s) 
             {return pending_mask.Set(s);}
@@ -238,14 +324,17 @@ class NormBlock
                                        NormBlockId finalBlockId,
                                        UINT16      finalSegmentSize) const;
         
-        bool AppendRepairRequest(NormNackMsg&   nack, 
-                                 UINT8          fecId,
-                                 UINT8          fecM,
-                                 UINT16         numData, 
-                                 UINT16         numParity,
-                                 NormObjectId   objectId,
-                                 bool           pendingInfo,
-                                 UINT16         payloadMax);
+        // (continues "req" if open, see comment in normSegment.cpp)
+        bool AppendRepairRequest(NormNackMsg&             nack, 
+                                 NormRepairRequest&       req,
+                                 NormRepairRequest::Form& reqForm,
+                                 UINT8                    fecId,
+                                 UINT8                    fecM,
+                                 UINT16                   numData, 
+                                 UINT16                   numParity,
+                                 NormObjectId             objectId,
+                                 bool                     pendingInfo,
+                                 UINT16                   payloadMax);
         
         
         void SetLastNackTime(const ProtoTime& theTime)
@@ -270,18 +359,23 @@ class NormBlock
             {return ProtoTree::GetNativeEndian();}    
 #endif  // USE_PROTO_TREE
             
-        NormBlockId  blk_id;
-        UINT16       size;
-        char**       segment_table;
-        
-        int          flags;
+        // (the state used for every segment sent or received comes first
+        //  so it shares a cache line)
+        UINT16       flags;
         UINT16       erasure_count;
         UINT16       parity_count;  // how many fresh parity we are currently planning to send
         UINT16       parity_offset; // offset from where our fresh parity will be sent
+        UINT16       size;
         UINT16       seg_size_max;
+        NormBitmask  pending_mask;
+        NormBitmask  repair_mask;
+        char**       segment_table;
+        NormBlockId  blk_id;
         
-        ProtoBitmask pending_mask;
-        ProtoBitmask repair_mask;
+        UINT16       nack_loss;     // (sender) for adaptive auto parity
+        UINT16       auto_parity;   // (sender) see GetAutoParity()
+        bool         storage_owner; // false if storage provided to Init()
+        UINT32       digest_sum;    // (receiver) see AddDigest()
         ProtoTime    last_nack_time;  // for stream flow control
         NormBlock*   next;            // used for NormBlockPool
 };  // end class NormBlock
@@ -291,11 +385,22 @@ class NormBlockPool
     public:
         NormBlockPool();
         ~NormBlockPool();
+        // Each block is a single allocation holding the NormBlock and its
+        // segment table and masks (see GetBlockSpace()).  In "slab" mode,
+        // Init() allocates all of the blocks as one contiguous array.
+        void SetSlabMode(bool enable)
+            {slab_mode = enable;}
+        void SetSharePool(NormBlockPool* sharePool)
+            {share_pool = sharePool;}
+        bool IsShared() const
+            {return (NULL != share_pool);}
         bool Init(UINT32 numBlocks, UINT16 totalSize);
         void Destroy();
-        bool IsEmpty() const {return (NULL == head);}
+        bool IsEmpty() const 
+            {return ((NULL != share_pool) ? share_pool->IsEmpty() : (NULL == head));}
         NormBlock* Get()
         {
+            if (NULL != share_pool) return share_pool->Get();
             NormBlock* b = head;
             head = b ? b->next : NULL;
             if (b) 
@@ -313,22 +418,78 @@ class NormBlockPool
         }
         void Put(NormBlock* b)
         {
+            if (NULL != share_pool)
+            {
+                share_pool->Put(b);
+                return;
+            }
             b->next = head;
             head = b;
             blk_count++;
         }
         unsigned long OverrunCount() const {return overruns;}
-        UINT32 GetCount() {return blk_count;}
-        UINT32 GetTotal() {return blk_total;}
+        UINT32 GetCount() {return ((NULL != share_pool) ? share_pool->GetCount() : blk_count);}
+        UINT32 GetTotal() {return ((NULL != share_pool) ? share_pool->GetTotal() : blk_total);}
+        UINT16 GetBlockSize() const {return blk_size;}
+        
+        // Bytes per block (including segment table and masks)
+        static size_t GetBlockSpace(UINT16 totalSize)
+        {
+            return ((sizeof(NormBlock) + 7) & ~((size_t)7)) + NormBlock::GetStorageSize(totalSize);
+        }
         
     private:
+        void DestroyBlock(NormBlock* b);
+        
         NormBlock*      head;
+        UINT16          blk_size;
         UINT32          blk_total;
         UINT32          blk_count;
         unsigned long   overruns;
         bool            overrun_flag;
+        bool            slab_mode;
+        UINT64*         slab_array;   // (slab mode only)
+        NormBlockPool*  share_pool;
 };  // end class NormBlockPool
 
+// A reference counted block and segment pool that many sessions (e.g. the
+// per-client sessions of a server) can share for their sender and remote
+// sender buffers instead of each allocating its own (mostly idle) pools.
+// The pools of a session bind to it (see NormSession::BindBufferPool())
+// when its FEC block and segment sizes fit and are then drawn from it only
+// as data is actually buffered.  All users must run on one NORM thread.
+class NormBufferPool
+{
+    public:
+        NormBufferPool();
+        
+        // Pools are sized as for NormSession::StartSender()
+        bool Init(unsigned long bufferSpace, UINT16 segmentSize, UINT16 numData, UINT16 numParity, 
+                  bool slabMode = false, bool hugePages = false, int numaNode = -1);
+        
+        void Retain()
+            {ref_count++;}
+        void Release()
+        {
+            ASSERT(ref_count > 0);
+            if (0 == --ref_count) delete this;
+        }
+        
+        // Binds "segmentPool" and "blockPool" to this pool if their sizes fit
+        // (the FEC block size must match and segments be no larger)
+        bool Bind(NormSegmentPool& segmentPool, NormBlockPool& blockPool,
+                  UINT16 segmentSize, UINT16 blockSize);
+        
+    private:
+        ~NormBufferPool();
+        
+        NormSegmentPool segment_pool;
+        NormBlockPool   block_pool;
+        UINT16          segment_size;
+        UINT16          block_size;
+        unsigned int    ref_count;
+};  // end class NormBufferPool
+
 #ifdef USE_PROTO_TREE
 class NormBlockTree : public ProtoSortedTreeTemplate<NormBlock> {};
 #endif // USE_PROTO_TREE
@@ -399,6 +560,8 @@ class NormBlockBuffer
         NormBlock**     table;
         unsigned long   hash_mask; 
 #endif // if/else USE_PROTO_TREE      
+        // (direct-indexed fast path in front of the tree (or hash table))
+        NormIdRing<NormBlock> ring;
         unsigned long   range_max;  // max range of blocks that can be buffered
         unsigned long   range;      // zero if "block buffer" is empty
         UINT32          fec_block_mask;
@@ -406,4 +569,70 @@ class NormBlockBuffer
         NormBlockId     range_hi;
 };  // end class NormBlockBuffer
 
+// The NormParityCache keeps the computed parity segments of sender blocks,
+// keyed by an object "content key" (see NormObject::SenderSetParityKey())
+// and block id, so repeated or requeued transmissions of the same content
+// copy the parity instead of re-reading and re-encoding the source data.
+// The least recently used blocks are dropped to stay within "byteMax".
+class NormParityCache
+{
+    public:
+        NormParityCache();
+        ~NormParityCache();
+        bool Init(unsigned long byteMax);  // (zero disables and empties the cache)
+        void Destroy();
+        bool IsEnabled() const
+            {return (0 != byte_max);}
+        unsigned long GetByteCount() const
+            {return byte_count;}
+        
+        // Copies the cached parity of "blockId" to "parityList" and gets the
+        // block's biggest source segment size (for parity payload length)
+        bool Retrieve(UINT64 contentKey, UINT32 blockId, UINT16 numParity, 
+                      UINT16 segmentLength, char** parityList, UINT16& segSizeMax);
+        void Store(UINT64 contentKey, UINT32 blockId, UINT16 numParity, 
+                   UINT16 segmentLength, char** parityList, UINT16 segSizeMax);
+        
+        // FNV-1a hash (chain calls by passing the prior result as "hash")
+        static UINT64 Hash(const void* buffer, size_t len, UINT64 hash = HASH_INIT);
+        static const UINT64 HASH_INIT;
+        
+    private:
+        class Entry : public ProtoTree::Item
+        {
+            public:
+                Entry(UINT64 contentKey, UINT32 blockId);
+                ~Entry();
+                bool Init(unsigned long length);
+                
+                char*           data;
+                unsigned long   data_len;
+                UINT16          num_parity;
+                UINT16          segment_length;
+                UINT16          seg_size_max;
+                Entry*          prev;  // LRU list (head is most recent)
+                Entry*          next;
+                
+            private:
+                const char* GetKey() const
+                    {return key;}
+                unsigned int GetKeysize() const
+                    {return (8 * KEY_SIZE);}
+                
+                enum {KEY_SIZE = 12};
+                char            key[KEY_SIZE];  // content key and block id
+        };  // end class NormParityCache::Entry
+        class EntryTree : public ProtoTreeTemplate<Entry> {};
+        
+        Entry* Find(UINT64 contentKey, UINT32 blockId);
+        void Touch(Entry* entry);
+        void Remove(Entry* entry);
+        
+        EntryTree       tree;
+        Entry*          lru_head;
+        Entry*          lru_tail;
+        unsigned long   byte_max;
+        unsigned long   byte_count;
+};  // end class NormParityCache
+
 #endif // _NORM_SEGMENT
@@ -5,6 +5,13 @@
 #include "normObject.h"
 #include "normNode.h"
 #include "normEncoder.h"
+#include "normFecWorker.h"
+#include "normFileIo.h"
+#include "normMsgBatch.h"
+#include "normXdp.h"
+#include "normTraceRing.h"
+#include "normProbe.h"
+#include "normAead.h"
 
 #include "protokit.h"
 
@@ -23,6 +30,18 @@
 
 #define LIMIT_CC_RATE 1
 
+// Zero-copy NORM_DATA transmission (see NormSession::SetTxZeroCopy()) uses
+// sendmsg() and, where supported (Linux 5.0+), MSG_ZEROCOPY
+#if !defined(WIN32) && !defined(SIMULATE)
+#define NORM_TX_ZEROCOPY
+#endif // !WIN32 && !SIMULATE
+
+// Earliest departure time pacing of batched transmission (see
+// NormSession::SetTxTimePacing()) uses SO_TXTIME (Linux 4.19+)
+#if defined(__linux__) && defined(NORM_SEND_BATCH)
+#define NORM_TX_TIME
+#endif // __linux__ && NORM_SEND_BATCH
+
 class NormController
 {
     public:
@@ -58,6 +77,8 @@ class NormController
             ACKING_NODE_NEW,
             SEND_ERROR,
             USER_TIMEOUT,
+            RX_OBJECT_BLOCK_COMPLETED,  // (progressive receive mode only)
+            RX_SOCKET_OVERFLOW,         // rx socket buffer dropped datagrams
             // The ones below here are not exposed via the NORM API
             SEND_OK
         };
@@ -70,6 +91,8 @@ class NormController
                     
 };  // end class NormController
 
+class NormRxPort;
+
 class NormSessionMgr
 {
     friend class NormSession;
@@ -86,6 +109,8 @@ class NormSessionMgr
                                       UINT16        sessionPort,
                                       NormNodeId    localNodeId = NORM_NODE_ANY);
         void DeleteSession(class NormSession* theSession);
+        bool IsEmpty() const
+            {return (NULL == top_session);}
         
         void Notify(NormController::Event event,
                     class NormSession*    session,
@@ -97,12 +122,24 @@ class NormSessionMgr
         }
                
         void ActivateTimer(ProtoTimer& timer) {timer_mgr.ActivateTimer(timer);}
+        // (long-lived per-node timers go in the "timer_wheel" to keep the
+        //  ProtoTimerMgr list short with many remote senders)
+        void ActivateTimer(NormTimerWheel::Timer& timer) {timer_wheel.ActivateTimer(timer);}
         ProtoTimerMgr& GetTimerMgr() const {return timer_mgr;}        
+        NormTimerWheel& GetTimerWheel() {return timer_wheel;}
         ProtoSocket::Notifier& GetSocketNotifier() const {return socket_notifier;}
         ProtoChannel::Notifier* GetChannelNotifier() const {return channel_notifier;}
         
         void DoSystemTimeout()
             {timer_mgr.DoSystemTimeout();}
+        
+        // Busy-poll mode services the session sockets (with SO_BUSY_POLL
+        // where supported) from a short repeating timer so, with a spinning
+        // (precise timing) dispatcher, the protocol thread never sleeps.  A
+        // "cpuId" >= 0 pins the protocol thread to that CPU.
+        bool SetBusyPoll(bool enable, int cpuId = -1);
+        bool GetBusyPoll() const
+            {return poll_timer.IsActive();}
     
         NormController* GetController() const {return controller;}
         
@@ -112,21 +149,169 @@ class NormSessionMgr
         NormDataObject::DataFreeFunctionHandle GetDataFreeFunction() const
             {return data_free_func;}
         
+        // Budget (in bytes, zero for no limit) for the receive buffers of
+        // all remote senders of all sessions (see NormSenderNode::AllocateBuffers())
+        void SetRxMemoryBudget(unsigned long numBytes)
+            {rx_memory_budget = numBytes;}
+        unsigned long GetRxMemoryBudget() const
+            {return rx_memory_budget;}
+        unsigned long GetRxMemoryUsed() const
+            {return rx_memory_used;}
+        // Reserves up to "numBytes" (but at least "minBytes") of the budget,
+        // returning how much was reserved (zero if "minBytes" isn't available)
+        unsigned long ReserveRxMemory(unsigned long numBytes, unsigned long minBytes);
+        void ReleaseRxMemory(unsigned long numBytes)
+            {rx_memory_used = (numBytes < rx_memory_used) ? (rx_memory_used - numBytes) : 0;}
+        
+        // Caps the total transmit rate (in bytes/sec, zero for no limit) of
+        // all sessions.  The sessions that have sent within TX_BUDGET_WINDOW
+        // share the budget by NormSession::SetTxRateWeight(), so the shares
+        // of idle (or slower, self-paced) sessions go to the busy ones.
+        void SetTxRateBudget(double bytesPerSecond);
+        double GetTxRateBudget() const
+            {return tx_budget_rate;}
+        // Debits "numBytes" sent by "session" from the shared token bucket,
+        // returning the (minimum) interval until its next message
+        double DrawTxBudget(NormSession& session, unsigned int numBytes);
+        
+        // Shared receive ports (see NormSession::SetRxPortShare()): returns the
+        // (opened as needed) socket for "port" and "interfaceName" (or NULL)
+        NormRxPort* GetRxPort(UINT16 port, const char* interfaceName, ProtoAddress::Type addrType);
+        // Closes the port when its last session has detached
+        void ReleaseRxPort(NormRxPort* rxPort);
+        
     private:   
+        enum {BUSY_POLL_USEC = 50};  // SO_BUSY_POLL time
+        static const double BUSY_POLL_INTERVAL;
+        bool OnPollTimeout(ProtoTimer& theTimer);
+        static const double TX_BUDGET_WINDOW;  // sec
+        static const double TX_BUDGET_DEPTH;   // sec of tokens
+        void UpdateTxShares(const ProtoTime& currentTime);
+        
         ProtoTimerMgr&                          timer_mgr;      
+        NormTimerWheel                          timer_wheel;
         ProtoSocket::Notifier&                  socket_notifier; 
         ProtoChannel::Notifier*                 channel_notifier; 
         NormController*                         controller;     
         NormDataObject::DataFreeFunctionHandle  data_free_func;
         
         class NormSession*       top_session;  // top of NormSession list
+        NormRxPort*              rx_port_list;
+        ProtoTimer               poll_timer;   // for busy-poll mode
+        int                      poll_cpu;
+        bool                     poll_pin;     // "poll_cpu" affinity not yet set
+        unsigned long            rx_memory_budget;
+        unsigned long            rx_memory_used;
+        double                   tx_budget_rate;    // bytes per second
+        double                   tx_budget_tokens;  // bytes (negative if overdrawn)
+        ProtoTime                tx_budget_time;    // last token refill
+        double                   tx_share_rate;     // budget left for weighted shares
+        double                   tx_share_weight;   // sum of active session weights
+        ProtoTime                tx_share_time;     // last UpdateTxShares()
               
 };  // end class NormSessionMgr
 
+class NormSession;
+
+// A NormSession that receives from a given remote address/port through
+// another (listener) session's rx_socket (see NormSession::SetRxDemux())
+class NormRxDemuxItem : public ProtoTree::Item
+{
+    public:
+        NormRxDemuxItem(NormSession& theSession, const ProtoAddress& remoteAddr)
+         : session(theSession)
+        {
+            key_size = MakeKey(remoteAddr, key_buffer);
+        }
+        NormSession& GetSession() const
+            {return session;}
+        
+        // (the same source address/port key as NormClientTree uses)
+        static unsigned int MakeKey(const ProtoAddress& addr, char* key)
+        {
+            unsigned int len = addr.GetLength();
+            memcpy(key, addr.GetRawHostAddress(), len);
+            UINT16 port = htons(addr.GetPort());
+            memcpy(key+len, &port, 2);
+            return ((len+2) << 3);
+        }
+            
+    private:
+        const char* GetKey() const
+            {return key_buffer;}    
+        unsigned int GetKeysize() const
+            {return key_size;}
+            
+        NormSession&        session;
+        char                key_buffer[16+2];
+        unsigned int        key_size;
+};  // end class NormRxDemuxItem
+
+class NormRxDemuxTree : public ProtoTreeTemplate<NormRxDemuxItem>
+{
+    public:
+        NormRxDemuxItem* FindItem(const ProtoAddress& remoteAddr)
+        {
+            char key[16+2];
+            unsigned int keysize = NormRxDemuxItem::MakeKey(remoteAddr, key);
+            return Find(key, keysize);
+        }
+};  // end class NormRxDemuxTree
+
+// A socket a NormSessionMgr's sessions share to receive on the same port (and
+// multicast interface) instead of each opening its own (see SetRxPortShare()).
+// Packets are handed to the session whose address is their destination (group)
+// address or, failing that, their source host (i.e. a unicast session's peer).
+// The NormRxDemuxItem keys hold the session addresses with the port number.
+class NormRxPort
+{
+    public:
+        NormRxPort(NormSessionMgr& sessionMgr, UINT16 thePort, const char* interfaceName);
+        ~NormRxPort();
+        
+        bool Open(ProtoAddress::Type addrType);
+        void Close();
+        
+        // Adds the session (joining its group if multicast)
+        NormRxDemuxItem* Attach(NormSession& session);
+        void Detach(NormRxDemuxItem* item);
+        bool IsEmpty() const
+            {return (0 == session_count);}
+        
+        UINT16 GetPort() const
+            {return port;}
+        const char* GetInterfaceName() const
+            {return iface_name;}
+        ProtoAddress::Type GetAddressType() const
+            {return addr_type;}
+        ProtoSocket& AccessSocket()
+            {return socket;}
+        
+        NormRxPort* GetNext() const
+            {return next;}
+        void SetNext(NormRxPort* rxPort)
+            {next = rxPort;}
+        
+        // Reads and dispatches queued packets (also called in busy-poll mode)
+        void OnSocketEvent(ProtoSocket& theSocket, ProtoSocket::Event theEvent);
+        
+    private:
+        enum {IFACE_NAME_MAX = 31};
+        
+        ProtoSocket         socket;
+        UINT16              port;
+        char                iface_name[IFACE_NAME_MAX+1];
+        ProtoAddress::Type  addr_type;
+        NormRxDemuxTree     session_tree;
+        unsigned int        session_count;
+        NormMsg             rx_msg;
+        NormRxPort*         next;
+};  // end class NormRxPort
 
 class NormSession
 {
     friend class NormSessionMgr;
+    friend class NormRxPort;
     
     public:
         enum {DEFAULT_MESSAGE_POOL_DEPTH = 16};
@@ -146,6 +331,20 @@ class NormSession
         static const UINT32 DEFAULT_TX_CACHE_SIZE;
         static const double DEFAULT_FLOW_CONTROL_FACTOR;
         static const UINT16 DEFAULT_RX_CACHE_MAX;
+        static const double TX_BATCH_QUANTUM;  // max sec of tx pacing per batch
+        static const double CC_MODEL_LOSS_MAX;  // CC_BBR loss fraction that caps bandwidth
+        static const double TX_WINDOW_GAIN;     // window = gain * delivery rate * min ACK cycle
+        static const double TX_WINDOW_PROBE;    // growth per ACK cycle while window limited
+        static const double TX_WINDOW_QUEUE_FACTOR;  // ACK cycle over min that means a queue
+        static const double TX_WINDOW_CYCLE_AGE;  // sec a min ACK cycle measurement is kept
+        static const unsigned int AUTO_TUNE_SOCK_MIN;  // auto-tuned socket buffer bounds
+        static const unsigned int AUTO_TUNE_SOCK_MAX;
+        static const double RX_DROP_EXCUSE_AGE;
+        static const unsigned int AEAD_OVERHEAD;
+        static const double AUTO_TUNE_SOCK_FACTOR;   // socket buffer = factor * BDP
+        static const double AUTO_TUNE_CACHE_FACTOR;  // tx cache and stream buffer = factor * BDP
+        static const double DEFAULT_ADAPT_PARITY_TARGET;  // fraction of blocks needing repair
+        static const double GSIZE_EPOCH;  // sec of receiver feedback per group size estimate
         static const int DEFAULT_ROBUST_FACTOR;
         
         enum {IFACE_NAME_MAX = 31};
@@ -188,6 +387,33 @@ class NormSession
         const ProtoAddress& Address() {return address;}
         void SetAddress(const ProtoAddress& addr) {address = addr;}
         bool SetMulticastInterface(const char* interfaceName);
+        // Multipath transmission: adds a transmit path (socket) using the
+        // "interfaceName" multicast interface and/or bound to "srcAddr".  Sender
+        // DATA messages are striped over the paths in proportion to their
+        // weights (e.g. path rates).  Path 0 is the session tx_socket, so the
+        // path index of an added path is the previous GetTxPathCount().
+        bool AddTxPath(const char* interfaceName, const char* srcAddr, double weight);
+        bool SetTxPathWeight(unsigned int pathIndex, double weight);
+        unsigned int GetTxPathCount() const
+            {return tx_path_count;}
+        // Layered multi-rate transmission: adds a multicast group (on the
+        // session port) as the next layer.  Fresh sender DATA messages are
+        // spread over the layers by weight (layer 0, the session address,
+        // has weight 1.0) and everything else stays on layer 0.  The session
+        // tx rate (set or congestion controlled) is layer 0's, so the total
+        // rate is scaled by the sum of the layer weights.
+        bool AddTxLayer(const char* groupAddr, double weight);
+        unsigned int GetTxLayerCount() const
+            {return tx_layer_count;}
+        // Receivers add the same groups in the same order.  Layers above 0
+        // are then joined one at a time while the receiver's loss stays low
+        // and the top one left when it rises ("receiver-driven" layer CC).
+        bool AddRxLayer(const char* groupAddr);
+        unsigned int GetRxLayerLevel() const  // (number of layers joined)
+            {return (rx_layer_top + 1);}
+        // Use an AF_XDP socket bound to "queueId" of "interfaceName" for
+        // session traffic (must be set before the session is opened)
+        bool SetXdpInterface(const char* interfaceName, unsigned int queueId);
         bool SetSSM(const char* sourceAddress);
         bool SetTTL(UINT8 theTTL) 
         {
@@ -236,6 +462,28 @@ class NormSession
         
         UINT16 GetRxPort() const;
         
+        // Receive sharding: "shardCount" sessions opened (in "shardIndex" order)
+        // on the same address and port each receive the messages of the remote
+        // senders whose node id modulo "shardCount" is their "shardIndex" (with
+        // feedback steered by the sender id it is addressed to).  With the
+        // sessions spread over a sharded NormInstance's threads, the senders are
+        // processed in parallel.  (Linux only, using SO_REUSEPORT with BPF
+        // steering. MUST be called before the receiver is started)
+        bool SetRxShard(unsigned int shardIndex, unsigned int shardCount);
+        unsigned int GetRxShardIndex() const
+            {return rx_shard_index;}
+        unsigned int GetRxShardCount() const
+            {return rx_shard_count;}
+        
+        // Receive through a socket shared with the NormSessionMgr's other
+        // sessions on the same port and multicast interface (see NormRxPort)
+        // instead of opening an rx_socket per session, so many sessions (e.g.
+        // on different groups) don't each cost a socket and a copy of the 
+        // port's packets.  MUST be called before the session is opened.
+        bool SetRxPortShare(bool enable);
+        bool GetRxPortShare() const
+            {return rx_port_share;}
+        
         const ProtoAddress& GetRxBindAddr() const
             {return rx_bind_addr;}
         
@@ -256,13 +504,159 @@ class NormSession
         
         NormSessionMgr& GetSessionMgr() {return session_mgr;}
         
+        // (Explicitly set socket buffer sizes are kept as lower bounds by SetAutoTune())
         bool SetTxSocketBuffer(unsigned int bufferSize)
-            {return tx_socket->SetTxBufferSize(bufferSize);}
+        {
+            tx_sock_buffer_base = tx_sock_buffer_tuned = bufferSize;
+            return tx_socket->SetTxBufferSize(bufferSize);
+        }
         bool SetRxSocketBuffer(unsigned int bufferSize)
-            {return rx_socket.SetRxBufferSize(bufferSize);}
+        {
+            rx_sock_buffer_base = rx_sock_buffer_tuned = bufferSize;
+            return rx_socket.SetRxBufferSize(bufferSize);
+        }
+        // Sizes the socket buffers, the tx cache size bound and tx streams opened
+        // with a zero buffer size from the bandwidth-delay product (rate times
+        // grtt), resizing as the rate and grtt change (configured sizes are the
+        // lower bounds)
+        void SetAutoTune(bool enable);
+        bool GetAutoTune() const
+            {return auto_tune;}
+        // Receive up to "batchSize" datagrams per system call (zero disables)
+        bool SetRxBatchSize(unsigned int batchSize)
+            {return rx_batch.Init(batchSize);}
+        unsigned int GetRxBatchSize() const
+            {return rx_batch.GetSize();}
+        // Use kernel receive timestamps (SO_TIMESTAMPNS) instead of the time
+        // messages are read for GRTT and congestion control RTT measurement
+        // (so dispatch latency doesn't inflate the measurements)
+        bool SetRxTimestamps(bool enable);
+        bool GetRxTimestamps() const
+            {return rx_timestamps;}
+        // Datagrams the rx socket dropped for lack of buffer space (Linux
+        // SO_RXQ_OVFL, or SO_MEMINFO when receives aren't batched).  Drops
+        // are logged, counted, post RX_SOCKET_OVERFLOW and grow the rx socket
+        // buffer when auto tuning.  With "excuse" set, sequence gaps from
+        // them (seen within RX_DROP_EXCUSE_AGE) aren't counted as network
+        // loss by our congestion control loss estimates.
+        void SetRxExcuseSocketDrops(bool excuse)
+            {rx_drop_excuse_enable = excuse;}
+        bool GetRxExcuseSocketDrops() const
+            {return rx_drop_excuse_enable;}
+        UINT64 GetRxSocketDropCount() const
+            {return rx_stat_socket_drops;}
+        void ClearRxSocketOverflow()
+            {posted_rx_socket_overflow = false;}
+        // Called by NormSenderNode::UpdateLossEstimate() for drops not yet
+        // accounted for (NULL if none)
+        unsigned int* ReceiverDropExcuse(const struct timeval& currentTime);
+        // Protects all messages sent and received with ChaCha20-Poly1305
+        // under a group "key" (NormAead::KEY_SIZE bytes, NULL disables).
+        // The NORM header stays clear (but authenticated) and AEAD_OVERHEAD
+        // bytes (nonce counter and tag) are appended, so the segment size
+        // should be that much smaller to keep messages within the MTU.
+        // Messages failing authentication are dropped and counted (replayed
+        // messages are not detected).
+        bool SetAeadKey(const char* key, unsigned int keyLength);
+        bool AeadEnabled() const
+            {return aead.IsKeySet();}
+        UINT64 GetRxAuthFailureCount() const
+            {return rx_stat_auth_failures;}
+        // Send up to "batchSize" datagrams per system call (zero disables)
+        bool SetTxBatchSize(unsigned int batchSize);
+        unsigned int GetTxBatchSize() const
+            {return tx_batch.GetSize();}
+        // Send memory-mapped file object segments in place (see SetFileMapping())
+        // instead of copying them into messages (when not needed for FEC encoding)
+        bool SetTxZeroCopy(bool enable);
+        bool GetTxZeroCopy() const
+            {return tx_zero_copy;}
+        // Stamps batched messages (see SetTxBatchSize()) with departure times
+        // per the transmit rate for the "fq" (or with "taiClock", "etf")
+        // qdisc to space them instead of sending each burst back-to-back
+        bool SetTxTimePacing(bool enable, bool taiClock = false);
+        bool GetTxTimePacing() const
+            {return tx_time_pacing;}
+        // Sets SO_BUSY_POLL "usec" on the session sockets (zero disables)
+        void SetBusyPoll(unsigned int usec);
+        // Reads whatever is ready on the session sockets (for busy-poll mode)
+        void PollSockets();
+        // Copies content referenced by queued messages within "base" .. "base+len"
+        // into the messages themselves (e.g. before a mapped file is closed)
+        void SenderCopyPayloadRefs(const char* base, size_t len);
+        // Memory-map NormFileObject files (when possible) for segment access
+        void SetFileMapping(bool enable)
+            {file_mapping = enable;}
+        bool GetFileMapping() const
+            {return file_mapping;}
+        // Use "count" background threads for NormFileObject file writes and
+        // read-ahead (zero does file I/O inline).  Must be set while closed.
+        bool SetFileIoWorkerCount(unsigned int count);
+        unsigned int GetFileIoWorkerCount() const
+            {return file_io.GetWorkerCount();}
+        NormFileIoEngine* GetFileIo()
+            {return (file_io.IsActive() ? &file_io : NULL);}
+        // Journal the completed blocks of received files under "dirPath" (NULL
+        // disables) so a restarted receiver only NACKs for the missing blocks
+        // of objects the sender still has (see NormFileObject::Accept())
+        bool SetRxFileJournal(const char* dirPath);
+        const char* GetRxFileJournal() const
+            {return (('\0' != rx_journal_dir[0]) ? rx_journal_dir : NULL);}
+        // Use "slab" mode (see NormSegmentPool::SetSlabMode()) for the segment
+        // and block pools of subsequently started senders, remote senders and
+        // rx streams
+        void SetSlabMode(bool enable, bool hugePages, int numaNode)
+        {
+            slab_mode = enable;
+            slab_huge_pages = hugePages;
+            slab_numa_node = numaNode;
+        }
+        void SetPoolSlabMode(NormSegmentPool& segmentPool, NormBlockPool& blockPool) const
+        {
+            segmentPool.SetSlabMode(slab_mode, slab_huge_pages, slab_numa_node);
+            blockPool.SetSlabMode(slab_mode);
+        }
+        // Touch the pool memory of subsequently started senders and
+        // preallocated remote senders (see PreallocateRemoteSenders())
+        // up front instead of faulting it in as the first packets arrive
+        void SetMemoryPrefault(bool enable)
+            {memory_prefault = enable;}
+        bool GetMemoryPrefault() const
+            {return memory_prefault;}
+        
+        // A shared buffer pool (e.g. the NormSocket server listener's) the
+        // sender and remote sender pools of this session draw from instead
+        // of allocating their own (NULL reverts to per-session pools).  The
+        // pool is retained and takes effect upon the next buffer allocation.
+        void SetBufferPool(NormBufferPool* bufferPool);
+        NormBufferPool* GetBufferPool() const
+            {return buffer_pool;}
+        // Creates (with our slab mode) and sets a new shared buffer pool
+        bool CreateBufferPool(unsigned long bufferSpace, UINT16 segmentSize, 
+                              UINT16 numData, UINT16 numParity);
+        // Called before pool Init() to share "buffer_pool" if it fits
+        bool BindBufferPool(NormSegmentPool& segmentPool, NormBlockPool& blockPool,
+                            UINT16 segmentSize, UINT16 blockSize) const;
         
         // Session parameters
         double GetTxRate();  // returns bits/sec
+        
+        // Cumulative sender statistics (messages actually sent, NORM_DATA 
+        // segments and retransmitted repair bytes, and NACKs received)
+        UINT64 GetTxByteCount() const {return tx_stat_bytes;}
+        UINT64 GetTxSegmentCount() const {return tx_stat_segments;}
+        UINT64 GetTxRepairByteCount() const {return tx_stat_repair_bytes;}
+        UINT64 GetNackRecvCount() const {return tx_stat_nacks;}
+        
+        // Optional latency histograms: the session's own tracks tx object
+        // enqueue to first transmission, and remote senders track object
+        // reception, NACK-to-repair and FEC decode times
+        void SetLatencyStats(bool enable)
+            {latency_stats = enable;}
+        bool LatencyStatsEnabled() const
+            {return latency_stats;}
+        const NormHistogram& GetTxLatency() const
+            {return tx_latency;}
         // (TBD) watch timer scheduling and min/max bounds
         void SetTxRate(double txRate)
         {
@@ -271,6 +665,11 @@ class NormSession
             SetTxRateInternal(txRate);
         }
         void SetTxRateBounds(double rateMin, double rateMax);
+        // Relative share of the NormSessionMgr tx rate budget (default 1.0)
+        void SetTxRateWeight(double weight)
+            {tx_budget_weight = (weight > 0.0) ? weight : 1.0;}
+        double GetTxRateWeight() const
+            {return tx_budget_weight;}
         
         void ClearSendError()
             {posted_send_error = false;}
@@ -288,6 +687,29 @@ class NormSession
             cc_adjust = adjustRate;
             if (state) probe_proactive = true;
         }
+        // CC_TFMCC is NORM-CC (RFC 5740, including the ECN variants) and
+        // CC_BBR paces at a bottleneck bandwidth / min RTT model estimate
+        // for the current limiting receiver (see NormBandwidthModel)
+        enum CCMode {CC_TFMCC, CC_BBR};
+        void SetCCMode(CCMode ccMode)
+        {
+            cc_mode = ccMode;
+            cc_model.Reset();
+            cc_model_clr = NORM_NODE_NONE;
+        }
+        CCMode GetCCMode() const
+            {return cc_mode;}
+        
+        // Window mode limits the new data "in flight" (sent, but not yet
+        // covered by a completed watermark ACK) to a window sized from the
+        // acking nodes' delivery rate and ACK cycle time.  The sender sets
+        // its own watermarks as needed while the app has none pending.
+        // The tx rate is still used as the peak pacing rate.
+        void SetTxWindow(bool state);
+        bool GetTxWindow() const
+            {return tx_window_enable;}
+        double GetTxWindowSize() const  // in bytes
+            {return tx_window;}
         
         // This MUST be called before
         void SetProbeTOS(UINT8 probeTOS)
@@ -334,6 +756,18 @@ class NormSession
         bool SetTxCacheBounds(NormObjectSize sizeMax,
                               unsigned long  countMin,
                               unsigned long  countMax);
+        // Adds a second tx cache tier of up to "countMax" objects / "sizeMax"
+        // bytes: instead of being purged when the (memory) cache bounds above
+        // are reached, the oldest NORM_OBJECT_DATA objects have their content
+        // moved to memory-mapped files under "dirPath" (and are reported
+        // TX_OBJECT_PURGED so the application can free its buffer) and stay
+        // repairable until the spill tier's bounds purge them in turn.  A NULL
+        // "dirPath" disables (and purges) the spill tier.
+        bool SetTxCacheSpill(const char*    dirPath,
+                             NormObjectSize sizeMax,
+                             unsigned long  countMax);
+        unsigned int GetTxSpillCount() const
+            {return tx_spill_count;}
         
         // For NormSocket API extension support only
         void SetServerListener(bool state)
@@ -341,6 +775,16 @@ class NormSession
         bool IsServerListener() const
             {return is_server_listener;}
         
+        // Receive demultiplexing: instead of opening its own rx_socket, a 
+        // (not yet open) unicast session receives the packets from "remoteAddr"
+        // that arrive at the "listener" session's rx_socket and transmits
+        // through it, so one socket serves many accepted NormSocket clients
+        // (NULL detaches).  The remote address/port is the key because remote
+        // NormNodeIds are not assured to be unique across clients.
+        bool SetRxDemux(NormSession* listener, const ProtoAddress& remoteAddr);
+        NormSession* GetRxDemuxListener() const
+            {return rx_demux_listener;}
+        
         void Notify(NormController::Event event,
                     class NormNode*       node,
                     class NormObject*     object)
@@ -350,7 +794,21 @@ class NormSession
             notify_pending = false;
         }
         
-        NormMsg* GetMessageFromPool() {return message_pool.RemoveHead();}
+        // Stream event coalescing: after a stream posts a TX_QUEUE_VACANCY or
+        // RX_OBJECT_UPDATED notification, the next one of that type is held
+        // until "interval" seconds have passed or "threshold" segments have
+        // been sent (for vacancy) or received (for updates) meanwhile, if
+        // non-zero.  A zero "interval" (the default) posts them immediately.
+        bool SetEventCoalescing(NormController::Event event, unsigned int threshold, double interval);
+        unsigned int GetEventThreshold(NormController::Event event) const
+            {return ((NormController::TX_QUEUE_VACANCY == event) ? tx_vacancy_threshold : rx_update_threshold);}
+        double GetEventInterval(NormController::Event event) const
+            {return ((NormController::TX_QUEUE_VACANCY == event) ? tx_vacancy_interval : rx_update_interval);}
+        
+        // Pool messages are grown (if needed) to hold "payloadMax" bytes of
+        // content (by default, the session "segment_size")
+        NormMsg* GetMessageFromPool() {return GetMessageFromPool(segment_size);}
+        NormMsg* GetMessageFromPool(unsigned int payloadMax);
         void ReturnMessageToPool(NormMsg* msg) {message_pool.Append(msg);}
         void QueueMessage(NormMsg* msg);
         enum MessageStatus
@@ -361,7 +819,12 @@ class NormSession
                     
         };
         MessageStatus SendMessage(NormMsg& msg);
+        // Sends "msg" with a "scopeTtl" multicast TTL instead of the session's
+        // (see ReceiverSetLocalRepair()).  A "localRepair" message is a receiver's
+        // retransmission of a sender's message and is sent as built.
+        MessageStatus SendScopedMessage(NormMsg& msg, UINT8 scopeTtl, bool localRepair = false);
         void ActivateTimer(ProtoTimer& timer) {session_mgr.ActivateTimer(timer);}
+        void ActivateTimer(NormTimerWheel::Timer& timer) {session_mgr.ActivateTimer(timer);}
         
         void SetUserData(const void* userData) 
             {user_data = userData;}
@@ -399,6 +862,10 @@ class NormSession
                                     UINT32      dataLen,
                                     const char* infoPtr = NULL,
                                     UINT16      infoLen = 0);
+        NormDataObject* QueueTxDataV(const NormDataObject::Vector* vecList,
+                                     unsigned int                  vecCount,
+                                     const char*                   infoPtr = NULL,
+                                     UINT16                        infoLen = 0);
         
         bool RequeueTxObject(NormObject* obj);
         
@@ -407,6 +874,20 @@ class NormSession
         NormObject* SenderFindTxObject(NormObjectId objectId)
             {return tx_table.Find(objectId);}
         
+        // Once any weight is set, Serve() interleaves the pending objects by
+        // weighted round robin (each sends up to its weight in segments per
+        // turn) instead of sending them strictly in object id order
+        void SenderSetObjectWeight(NormObject& obj, unsigned int weight)
+        {
+            obj.SetTxWeight(weight);
+            tx_weighted = true;
+        }
+        void SenderSetDefaultWeight(unsigned int weight)  // (for objects enqueued later)
+        {
+            tx_weight_default = (0 != weight) ? weight : 1;
+            tx_weighted = true;
+        }
+        
         // postive ack mgmnt (can only fail when 'appAckReq' is set)
         bool SenderSetWatermark(NormObjectId  objectId,
                                 NormBlockId   blockId,
@@ -415,6 +896,14 @@ class NormSession
                                 const char*   appAckReq = NULL,
                                 unsigned int  appAckReqLen = 0);
         
+        // Adds a watermark without canceling any pending one, so ACK
+        // collection for several watermarks can be in progress at once
+        // (up to WATERMARK_PIPELINE_MAX older ones besides the newest)
+        bool SenderAddWatermark(NormObjectId  objectId,
+                                NormBlockId   blockId,
+                                NormSegmentId segmentId,
+                                bool          overrideFlush = false);
+        
         void SenderResetWatermark();
         void SenderCancelWatermark();
         
@@ -423,6 +912,10 @@ class NormSession
             {acking_auto_populate = trackingStatus;}
         NormAckingNode* SenderAddAckingNode(NormNodeId nodeId, const ProtoAddress* srcAddr = NULL);
         void SenderRemoveAckingNode(NormNodeId nodeId);
+        // Watermark requests for "nodeId" go to its "aggregatorId" receiver
+        // (added as an acking node if needed), whose ACK lists "nodeId" once
+        // it has collected its ACK.  (NORM_NODE_NONE or "nodeId" clears this)
+        bool SenderSetAckingNodeAggregator(NormNodeId nodeId, NormNodeId aggregatorId);
         AckingStatus SenderGetAckingStatus(NormNodeId nodeId);
         // Set "prevNodeId = NORM_NODE_NONE" to init this iteration (returns "false" when done)
         bool SenderGetNextAckingNode(NormNodeId& prevNodeId, AckingStatus* ackingStatus = NULL);
@@ -448,6 +941,16 @@ class NormSession
             {tx_robust_factor = value;}
         int GetTxRobustFactor() const
             {return tx_robust_factor;}
+        // Flush piggybacking: the final NORM_DATA of an object (its last
+        // source segment and any auto parity) or of a flushed stream write
+        // is flagged (NormObjectMsg::FLAG_FLUSH) so receivers check for
+        // repair through it right away, as they would upon NORM_CMD(FLUSH),
+        // and the first flush after new data isn't held by the flush_timer
+        // interval left over from an earlier flush
+        void SetTxFlushPiggyback(bool state)
+            {tx_flush_piggyback = state;}
+        bool GetTxFlushPiggyback() const
+            {return tx_flush_piggyback;}
         void SetRxRobustFactor(int value)
             {rx_robust_factor = value;}
         int GetRxRobustFactor() const
@@ -455,6 +958,11 @@ class NormSession
         
         UINT8 GetSenderFecId() const {return fec_id;}
         UINT8 GetSenderFecFieldSize() const {return fec_m;}
+        // The fec_id = 129 "instance id" selects among the codecs registered
+        // with NormFecRegistry (e.g., NormEncoderLDPC::FEC_INSTANCE_ID for
+        // large blocks).  This must be set before StartSender() to take effect.
+        UINT16 GetSenderFecInstanceId() const {return fec_instance_id;}
+        void SenderSetFecInstanceId(UINT16 instanceId) {fec_instance_id = instanceId;}
         UINT16 SenderSegmentSize() const {return segment_size;}
         UINT16 SenderBlockSize() const {return ndata;}
         UINT16 SenderNumParity() const {return nparity;}
@@ -464,6 +972,14 @@ class NormSession
         UINT16 SenderExtraParity() const {return extra_parity;}
         void SenderSetExtraParity(UINT16 extraParity)
             {extra_parity = extraParity;}
+        // Adaptive auto parity adjusts "auto_parity" (within 0..nparity) from
+        // the block losses reported in NACKs, aiming for "targetRepairProb"
+        // of blocks to need a repair round.  Any SenderSetAutoParity() value
+        // is the starting point.
+        void SenderSetAdaptiveParity(bool enable, double targetRepairProb = DEFAULT_ADAPT_PARITY_TARGET);
+        bool SenderAdaptiveParity() const {return adapt_parity;}
+        // Called for each new tx block to get its auto parity
+        UINT16 SenderBlockAutoParity();
         
         INT32 Difference(NormBlockId a, NormBlockId b) const
             {return NormBlockId::Difference(a, b, fec_block_mask);}
@@ -480,12 +996,35 @@ class NormSession
         bool SndrEmcon() const
             {return sndr_emcon;}
         
+        // The lowest pending object id (Serve()'s next object) is cached so
+        // it's only searched for again after that object leaves the mask
         bool SenderGetFirstPending(NormObjectId& objectId)
         {
-            UINT32 index;
-            bool result = tx_pending_mask.GetFirstSet(index);
-            objectId = (UINT16)index;
-            return result;   
+            if (!tx_pending_cached)
+            {
+                UINT32 index;
+                tx_pending_any = tx_pending_mask.GetFirstSet(index);
+                tx_pending_first = (UINT16)index;
+                tx_pending_cached = true;
+            }
+            objectId = tx_pending_first;
+            return tx_pending_any;   
+        }
+        bool SenderSetPending(NormObjectId objectId)
+        {
+            if (!tx_pending_mask.Set(objectId)) return false;
+            if (tx_pending_cached && (!tx_pending_any || (objectId < tx_pending_first)))
+            {
+                tx_pending_first = objectId;
+                tx_pending_any = true;
+            }
+            return true;
+        }
+        void SenderUnsetPending(NormObjectId objectId)
+        {
+            tx_pending_mask.Unset(objectId);
+            if (tx_pending_cached && tx_pending_any && (objectId == tx_pending_first))
+                tx_pending_cached = false;
         }
         bool SenderGetFirstRepairPending(NormObjectId& objectId)
         {
@@ -515,6 +1054,13 @@ class NormSession
             gsize_quantized = NormQuantizeGroupSize(gsize);   
             gsize_advertised = NormUnquantizeGroupSize(gsize_quantized);
         }
+        // Group size estimation replaces the SenderSetGroupSize() hint (the
+        // starting point) with a count of the distinct receivers heard from
+        // (ACK, NACK and CC feedback) over the last one to two GSIZE_EPOCH
+        // intervals.  The count is a lower bound so increases are made
+        // immediately while decreases are at most a halving per epoch.
+        void SenderSetGroupSizeEstimation(bool enable);
+        bool SenderGroupSizeEstimation() const {return gsize_auto;}
         
         FtiMode SenderFtiMode() const
             {return fti_mode;}
@@ -523,11 +1069,60 @@ class NormSession
         
         void SenderEncode(unsigned int segmentId, const char* segment, char** parityVectorList)
             {encoder->Encode(segmentId, segment, parityVectorList);}
+        // Whole block encoding uses the session's "tx_encode_list" scratch vectors 
+        // (NULL if they could not be allocated)
+        char** SenderEncodeVectorList() 
+            {return tx_encode_list;}
+        void SenderEncodeBlock(const char** dataVectorList, unsigned int numData, char** parityVectorList)
+        {
+            NORM_PROBE2(fec_encode_start, numData, 0);
+            encoder->EncodeBlock(dataVectorList, numData, parityVectorList);
+            NORM_PROBE2(fec_encode_end, numData, 0);
+        }
+        void SenderEncodeFinish(unsigned int numData, char** parityVectorList)
+            {encoder->EncodeFinish(numData, parityVectorList);}
+        
+        // Optional FEC worker threads compute block parity ahead of transmission
+        // (see NormObject::SubmitBlockParity()).  The worker count must be set
+        // before StartSender() to take effect (zero, the default, encodes inline).
+        void SenderSetFecWorkerCount(unsigned int count)
+            {tx_fec_worker_count = count;}
+        unsigned int SenderGetFecWorkerCount() const
+            {return tx_fec_worker_count;}
+        bool SenderFecWorkersActive() const
+            {return tx_fec_pool.IsActive();}
+        char** SenderReserveParityJob(NormBlock* block)
+            {return tx_fec_pool.Reserve(block);}
+        void SenderCancelParityJob(NormBlock* block)
+            {tx_fec_pool.Cancel(block);}
+        void SenderSubmitParityJob(NormBlock* block, UINT16 numData)
+        {
+            tx_fec_pool.Submit(block, numData, block->SegmentList(numData));
+            block->SetFlag(NormBlock::PARITY_PENDING);
+        }
+        // Waits for the block's parity job (if any) to complete
+        void SenderCollectParity(NormBlock* block);
+        // Marks blocks whose parity jobs have completed as parity ready
+        void SenderReapParity();
+        // Keeps up to "byteMax" bytes of computed block parity (zero disables)
+        // so objects enqueued again with the same content aren't re-encoded
+        bool SetTxParityCache(unsigned long byteMax)
+            {return tx_parity_cache.Init(byteMax);}
+        NormParityCache& SenderParityCache()
+            {return tx_parity_cache;}
+        // File and data objects enqueued while enabled carry a digest of
+        // their content (see NormDigest) that receivers verify (it is summed
+        // as the first transmission pass reads the content)
+        void SetTxDigest(bool enable)
+            {tx_digest = enable;}
+        bool SenderDigestEnabled() const
+            {return tx_digest;}
         
         
         NormBlock* SenderGetFreeBlock(NormObjectId objectId, NormBlockId blockId);
         void SenderPutFreeBlock(NormBlock* block)
         {
+            if (block->ParityPending()) SenderCollectParity(block);
             block->EmptyToPool(segment_pool);
             block_pool.Put(block);
         }
@@ -540,6 +1135,7 @@ class NormSession
         void TouchSender() 
         {
             posted_tx_queue_empty = false;
+            tx_drr_skips = 0;  // (objects may have something to send now)
             PromptSender();
             //if (!notify_pending) Serve();
         }
@@ -563,7 +1159,22 @@ class NormSession
                                      UINT16         segmentSize, 
                                      UINT16         numData, 
                                      UINT16         numParity, 
-                                     unsigned int   streamBufferSize = 0);
+                                     unsigned int   streamBufferSize = 0)
+        {
+            return PreallocateRemoteSenders(1, bufferSize, segmentSize, numData, 
+                                            numParity, streamBufferSize);
+        }
+        // Replaces the pool of ready-to-use remote sender contexts (buffers,
+        // decoder and optional rx stream) with "count" new ones that new
+        // remote senders are then assigned (in order) as they appear
+        bool PreallocateRemoteSenders(unsigned int   count,
+                                      unsigned int   bufferSize,
+                                      UINT16         segmentSize, 
+                                      UINT16         numData, 
+                                      UINT16         numParity, 
+                                      unsigned int   streamBufferSize = 0);
+        unsigned int GetPresetSenderCount()
+            {return preset_sender_list.GetCount();}
         
         bool SetPresetFtiData(unsigned int objectSize,
                               UINT16       segmentSize,   
@@ -589,6 +1200,43 @@ class NormSession
             {receiver_silent = state;}
         bool ReceiverIsSilent() const {return receiver_silent;}
         
+        // Local repair: receivers first send their NACKs with the site scoped
+        // "localTtl" (instead of the session TTL), and a "repairer" receiver
+        // answers the NACKs it overhears from what it has itself received,
+        // with the same scope.  A receiver NACKs with the session TTL when its
+        // site scoped NACK round goes unanswered, so only losses the site
+        // couldn't repair reach the sender.  (A zero "localTtl" disables this.)
+        void ReceiverSetLocalRepair(UINT8 localTtl, bool repairer)
+        {
+            local_repair_ttl = localTtl;
+            local_repairer = (0 != localTtl) && repairer;
+        }
+        UINT8 ReceiverLocalRepairTtl() const 
+            {return local_repair_ttl;}
+        bool ReceiverIsLocalRepairer() const 
+            {return local_repairer;}
+        
+        // ACK aggregation: a receiver with an "aggregator" sends the watermark
+        // ACKs requested via its aggregator's id to the aggregator's (unicast)
+        // address.  An aggregation enabled receiver collects those ACKs and
+        // lists the ACKing receivers in its own watermark ACK to the sender.
+        void ReceiverSetAckAggregator(NormNodeId aggregatorId, const ProtoAddress& aggregatorAddr)
+        {
+            ack_aggregator_id = aggregatorId;
+            ack_aggregator_addr = aggregatorAddr;
+        }
+        NormNodeId ReceiverAckAggregatorId() const
+            {return ack_aggregator_id;}
+        const ProtoAddress& ReceiverAckAggregatorAddress() const
+            {return ack_aggregator_addr;}
+        void ReceiverSetAckAggregation(bool state)
+            {ack_aggregation = state;}
+        bool ReceiverIsAckAggregator() const
+            {return ack_aggregation;}
+        // Grows the rx socket buffer (see SetAutoTune()) for a sender's
+        // bandwidth-delay product "bdp" (bytes)
+        void ReceiverAutoTune(double bdp);
+        
         void RcvrSetIgnoreInfo(bool state)
             {rcvr_ignore_info = state;}
         bool RcvrIgnoreInfo() const
@@ -619,6 +1267,49 @@ class NormSession
         bool RcvrIsRealtime() const
             {return rcvr_realtime;}
         
+        // When "rcvr_progressive" is set, DATA and FILE objects received
+        // afterwards post RX_OBJECT_BLOCK_COMPLETED as each FEC block is
+        // complete so the app can use the data before the whole object is
+        void RcvrSetProgressive(bool state)
+            {rcvr_progressive = state;}
+        bool RcvrIsProgressive() const
+            {return rcvr_progressive;}
+        
+        // Cut-through relay: DATA objects received by this session are
+        // re-sent by the "relaySession" sender (same session manager) 
+        // block by block as each FEC block is complete rather than after
+        // the whole object is.  NACKs from the relay's receivers are 
+        // answered from the received data.  The relay session's segment 
+        // and block size must match the upstream sender's.
+        void SetRelaySession(NormSession* relaySession)
+            {relay_session = relaySession;}
+        NormSession* GetRelaySession() const
+            {return relay_session;}
+        // (these are invoked on the relay session)
+        NormObject* RelayOpenObject(NormObject& source);
+        void RelayBlockCompleted(NormObject& relayObj, NormBlockId blockId);
+        void RelayAbortObject(NormObject& relayObj);
+        void RelayCancelSource(NormSession& upstream);
+        
+        // Receive mirroring: a mirror session doesn't receive on its own,
+        // but gets (read-only) copies of the API receive events of its
+        // "primary" session, so local consumers share one receiver's 
+        // buffers and decoding (NULL detaches it)
+        void SetRxMirror(NormSession* primary);
+        NormSession* GetRxMirrorPrimary() const
+            {return rx_mirror_primary;}
+        NormSession* GetRxMirrorHead() const
+            {return rx_mirror_head;}
+        NormSession* GetRxMirrorNext() const
+            {return rx_mirror_next;}
+        
+        // The API's per-session event queue (see NormGetSessionDescriptor()),
+        // NULL when the session's events go to its instance queue
+        void SetEventQueue(void* eventQueue)
+            {event_queue = eventQueue;}
+        void* GetEventQueue() const
+            {return event_queue;}
+        
         NormObject::NackingMode ReceiverGetDefaultNackingMode() const
             {return default_nacking_mode;}
         void ReceiverSetDefaultNackingMode(NormObject::NackingMode nackingMode)
@@ -634,14 +1325,64 @@ class NormSession
         void ReceiverSetDefaultSyncPolicy(NormSenderNode::SyncPolicy syncPolicy)
             {default_sync_policy = syncPolicy;}
         
+        NormSenderNode::EvictionPolicy ReceiverGetDefaultEvictionPolicy() const
+            {return default_eviction_policy;}
+        void ReceiverSetDefaultEvictionPolicy(NormSenderNode::EvictionPolicy evictionPolicy)
+            {default_eviction_policy = evictionPolicy;}
+        
         // Set default "max_pending_range" of NormObjects for reception
         void SetRxCacheMax(UINT16 maxCount)
             {rx_cache_count_max = (maxCount > 0x7fff) ? 0x7fff : maxCount;}
         UINT16 GetRxCacheMax() const
             {return rx_cache_count_max;}
         
+        // Per-sender receive quotas override the StartReceiver() "bufferSpace"
+        // and SetRxCacheMax() defaults for remote senders whose id matches
+        // "senderId" under "idMask" (all ones for a single sender, fewer bits
+        // for a class of senders).  The quota with the most mask bits that
+        // matches applies, and zero values keep the default (both zero
+        // removes the quota).  Quotas apply as senders are (re)opened.
+        bool ReceiverSetSenderQuota(NormNodeId      senderId,
+                                    NormNodeId      idMask,
+                                    unsigned long   bufferSpace,
+                                    UINT16          cacheMax);
+        // Returns true if a quota (instead of the defaults) applies
+        bool ReceiverGetSenderQuota(NormNodeId      senderId,
+                                    unsigned long&  bufferSpace,
+                                    UINT16&         cacheMax) const;
+        
+        // Set number of inverted FEC decoding matrices cached per remote sender
+        void SetRxDecoderCacheSize(unsigned int count)
+            {rx_decoder_cache_size = count;}
+        unsigned int GetRxDecoderCacheSize() const
+            {return rx_decoder_cache_size;}
+        
+        // Set number of FEC decoder worker threads per remote sender (zero decodes
+        // inline) for senders whose buffers are allocated after this is called
+        void SetRxFecWorkerCount(unsigned int count)
+            {rx_fec_worker_count = count;}
+        unsigned int GetRxFecWorkerCount() const
+            {return rx_fec_worker_count;}
+        
         // Debug settings
         void SetTrace(bool state) {trace = state;}
+        // Binary trace of the last "numRecords" messages (zero closes it)
+        bool SetTraceRing(unsigned int numRecords)
+        {
+            if (0 == numRecords)
+            {
+                trace_ring.Close();
+                return true;
+            }
+#ifdef NORM_NO_TRACE
+            PLOG(PL_ERROR, "NormSession::SetTraceRing() error: tracing not built (NORM_NO_TRACE)\n");
+            return false;
+#else
+            return trace_ring.Open(numRecords);
+#endif // if/else NORM_NO_TRACE
+        }
+        bool WriteTraceRing(const char* path) const
+            {return trace_ring.Write(path, (UINT32)LocalNodeId());}
         void SetTxLoss(double percent) {tx_loss_rate = percent;}
         void SetRxLoss(double percent) {rx_loss_rate = percent;}
         void SetReportTimerInterval(double interval) {report_timer.SetInterval(interval);}
@@ -664,11 +1405,34 @@ class NormSession
         
         void Serve();
         bool QueueTxObject(NormObject* obj);
+        // Moves the oldest (memory tier) tx object to the spill tier if it's
+        // a NORM_OBJECT_DATA object that fits (see SetTxCacheSpill())
+        bool SenderSpillTxObject();
+        static bool TxObjectIsSpilled(const NormObject* obj)
+        {
+            return ((NormObject::DATA == obj->GetType()) &&
+                    static_cast<const NormDataObject*>(obj)->IsSpilled());
+        }
+        UINT16 TxTableRangeMax() const
+        {
+            unsigned long rangeMax = tx_cache_count_max + tx_spill_count_max;
+            return (UINT16)((rangeMax < 0x7fff) ? rangeMax : 0x7fff);
+        }
+        
+        bool PresetRemoteSender(NormSenderNode& presetSender,
+                                unsigned int    bufferSpace,
+                                UINT16          segmentSize,
+                                UINT16          numData,
+                                UINT16          numParity,
+                                unsigned int    streamBufferSize);
+        NormSenderNode* GetPresetSender(NormNodeId senderId);
         
         
         double GetProbeInterval();
         
         bool OnTxTimeout(ProtoTimer& theTimer);
+        bool TxSendNext();
+        NormSendBatch::FlushStatus FlushTxBatch();
         bool OnRepairTimeout(ProtoTimer& theTimer);
         bool OnFlushTimeout(ProtoTimer& theTimer);
         bool OnProbeTimeout(ProtoTimer& theTimer);
@@ -679,7 +1443,80 @@ class NormSession
         
         void TxSocketRecvHandler(ProtoSocket& theSocket, ProtoSocket::Event theEvent);
         void RxSocketRecvHandler(ProtoSocket& theSocket, ProtoSocket::Event theEvent);        
-        void HandleReceiveMessage(NormMsg& msg, bool wasUnicast, bool ecn = false);
+        void RxSocketRecvBatch(ProtoSocket& theSocket);
+        bool EnableRxDropCount(ProtoSocket& theSocket);
+        bool EnableRxEcn(ProtoSocket& theSocket);
+        bool GetRxDropCount(ProtoSocket& theSocket, UINT32& dropCount);
+        void UpdateRxSocketDrops(UINT32 dropCount);
+        unsigned int SealMessage(const NormMsg& msg);  // into "aead_buffer"
+        bool OpenMessage(NormMsg& msg);
+        // (a non-NULL "rxTime" is the kernel receive time of the message)
+        void HandleReceiveMessage(NormMsg& msg, bool wasUnicast, bool ecn = false,
+                                  const struct timeval* rxTime = NULL);
+        bool EnableRxTimestamps(ProtoSocket& theSocket);
+        bool GetRxTimestamp(ProtoSocket& theSocket, const NormMsg& msg, struct timeval& rxTime);
+        bool InitDstAddrList();
+        
+#ifdef NORM_XDP
+        // These are used when the AF_XDP socket backend is enabled
+        bool OpenXdpSocket();
+        void CloseXdpSocket();
+        bool XdpSendTo(const char* buffer, unsigned int& numBytes, const ProtoAddress& dstAddr);
+        void OnXdpInput(ProtoChannel&              theChannel,
+                        ProtoChannel::Notification notifyType);
+        void HandleXdpFrame(NormMsg& msg, const char* frame, unsigned int frameLen);
+#endif // NORM_XDP
+#ifdef NORM_TX_ZEROCOPY
+        void EnableTxZeroCopy();
+        bool ZeroCopySendTo(const NormMsg& msg, unsigned int& numBytes);
+        void TxZeroCopyReap();  // drains MSG_ZEROCOPY completion notifications
+#endif // NORM_TX_ZEROCOPY
+        void EnableBusyPoll(ProtoSocket& theSocket);
+        bool EnableRxShard(bool isBound);
+        
+        // An added multipath transmit path (see AddTxPath())
+        class TxPath
+        {
+            public:
+                TxPath() : socket(ProtoSocket::UDP) 
+                    {iface_name[0] = '\0'; src_addr.Invalidate();}
+                ProtoSocket     socket;
+                char            iface_name[IFACE_NAME_MAX+1];
+                ProtoAddress    src_addr;
+        };
+        enum {TX_PATH_MAX = 8};
+        bool OpenTxPath(TxPath& path);
+        unsigned int SelectTxPath();
+        
+        // Layered multi-rate transmission (see AddTxLayer()/AddRxLayer())
+        enum {LAYER_MAX = 8};
+        static const double RX_LAYER_INTERVAL;  // sec between join/leave decisions
+        static const double RX_LAYER_LOSS_LOW;  // join a layer below this loss
+        static const double RX_LAYER_LOSS_HIGH; // leave the top layer above it
+        static const double RX_LAYER_BACKOFF_MIN;
+        static const double RX_LAYER_BACKOFF_MAX;
+        class RxLayer
+        {
+            public:
+                RxLayer() : join_backoff(0.0), join_time(0.0), seq_valid(false), seq_next(0), recv_count(0), lost_count(0)
+                    {addr.Invalidate();}
+                ProtoAddress    addr;
+                double          join_backoff;  // (doubles each time the layer is left)
+                double          join_time;     // no join experiment before this time (sec)
+                bool            seq_valid;
+                UINT16          seq_next;
+                UINT32          recv_count;
+                UINT32          lost_count;
+        };
+        unsigned int SelectTxLayer();
+        bool SenderMsgIsRepair(const NormDataMsg& data);
+        unsigned int RxLayerUpdate(const NormMsg& msg, const struct timeval& currentTime);
+        bool JoinRxLayer(unsigned int index);
+        void LeaveRxLayer(unsigned int index);
+#ifdef NORM_TX_TIME
+        void EnableTxTimePacing();
+        UINT64 TxTimeNow() const;  // nsec per the SO_TXTIME clock
+#endif // NORM_TX_TIME
 
 #ifdef ECN_SUPPORT        
         // This is used when raw packet capture is enabled
@@ -693,6 +1530,16 @@ class NormSession
         // Sender message handling routines
         void SenderHandleNackMessage(const struct timeval& currentTime, 
                                      NormNackMsg&          nack);
+        // Digests of NACK repair content already applied in the current
+        // NACK aggregation period (so identical NACKs can be skipped)
+        static UINT64 NackDigest(const NormNackMsg& nack);
+        bool SenderFindNackDigest(UINT64 digest) const;
+        void SenderAddNackDigest(UINT64 digest);
+        void SenderClearNackDigests()
+        {
+            if (0 != nack_digest_count) memset(nack_digest, 0, sizeof(nack_digest));
+            nack_digest_count = 0;
+        }
         void SenderHandleAckMessage(const struct timeval& currentTime, 
                                     const NormAckMsg&     ack,
                                     bool                  wasUnicast);
@@ -707,10 +1554,26 @@ class NormSession
                                     double         ccRate,              
                                     UINT16         ccSequence);         
         void AdjustRate(bool onResponse);
+        double GetModelRate(const NormCCNode& clr);
         void SetTxRateInternal(double txRate);  // here, txRate is bytes/sec
         //bool SenderQueueSquelch(NormObjectId objectId);
         void SenderQueueFlush();
+        // (true if the flush_timer holds off the next flush)
+        bool SenderFlushHeld() const
+            {return (flush_timer.IsActive() && (!tx_flush_piggyback || (0 != flush_count) || watermark_pending));}
         bool SenderQueueWatermarkFlush();
+        void SenderHandleAggregateAck(const NormAckAggregateExtension& ext, NormNodeId aggregatorId,
+                                      bool isCurrent, unsigned int pipelineIndex);
+        double GetTxWindowMin() const
+            {return (2.0 * (double)ndata * (double)segment_size);}
+        bool SenderWindowBlocks(NormObject& obj);
+        void SenderSetWindowMark();
+        void SenderUpdateWindow(bool success);
+        void SenderAutoTune();
+        static unsigned int AutoTuneSocketSize(double bdp, unsigned int sizeMin);
+        void SenderCheckWatermarkPipeline();
+        NormObject* SenderGetWeightedObject(NormObject* firstObj);
+        void SenderClearWatermarkPipeline();
         bool SenderBuildRepairAdv(NormCmdRepairAdvMsg& cmd);
         void SenderUpdateGroupSize();
         bool SenderQueueAppCmd();  
@@ -727,6 +1590,10 @@ class NormSession
         
         NormSessionMgr&                 session_mgr;
         bool                            notify_pending;
+        unsigned int                    tx_vacancy_threshold;  // (see SetEventCoalescing())
+        double                          tx_vacancy_interval;
+        unsigned int                    rx_update_threshold;
+        double                          rx_update_interval;
         ProtoTimer                      tx_timer;
         UINT16                          tx_port;
         bool                            tx_port_reuse;
@@ -734,11 +1601,50 @@ class NormSession
         ProtoSocket                     tx_socket_actual;
         ProtoSocket*                    tx_socket;
         ProtoSocket                     rx_socket;
+        NormRecvBatch                   rx_batch;
+        NormSendBatch                   tx_batch;
+        bool                            tx_batching;   // true while OnTxTimeout() is filling tx_batch
+        bool                            tx_zero_copy;
+        bool                            tx_zero_copy_sock;  // MSG_ZEROCOPY enabled on tx_socket
+        bool                            tx_zero_copy_reap;  // MSG_ZEROCOPY notifications may be queued
+        bool                            tx_time_pacing;
+        bool                            tx_time_tai;        // CLOCK_TAI (for "etf") instead of CLOCK_MONOTONIC
+        bool                            tx_time_sock;       // SO_TXTIME enabled on tx_socket
+        UINT64                          tx_time_next;       // departure time (nsec) for next batched message
+        bool                            auto_tune;
+        unsigned int                    tx_sock_buffer_base;   // configured sizes (zero if not set)
+        unsigned int                    rx_sock_buffer_base;
+        unsigned int                    tx_sock_buffer_tuned;  // current sizes set
+        unsigned int                    rx_sock_buffer_tuned;
+        unsigned int                    busy_poll_usec;
+        bool                            rx_timestamps;
+        UINT32                          rx_drop_last;       // cumulative kernel drop count last seen
+        UINT64                          rx_stat_socket_drops;
+        bool                            rx_drop_excuse_enable;
+        unsigned int                    rx_drop_excuse;     // drops not yet taken out of loss estimates
+        struct timeval                  rx_drop_time;       // time of most recent drops
+        bool                            posted_rx_socket_overflow;
+        NormAead                        aead;
+        UINT64                          aead_counter;       // (nonce for next message sent)
+        char*                           aead_buffer;        // sealed copy of message being sent
+        UINT64                          rx_stat_auth_failures;
 #ifdef ECN_SUPPORT
         ProtoCap*                       proto_cap;        // raw packet capture alternative to "rx_socket"
         ProtoAddress                    src_addr;         // used for raw packet sendto()
 #endif // ECN_SUPPORT
+#ifdef NORM_XDP
+        NormXdpSocket*                  xdp_socket;       // AF_XDP alternative to "rx_socket" / "tx_socket"
+        ProtoAddress                    xdp_src_addr;     // IP source address for XDP frames
+        ProtoAddress                    xdp_src_mac;      // Ethernet source address for XDP frames
+        unsigned int                    xdp_queue;
+        bool                            xdp_blocked;      // XdpSendTo() found no free tx frame
+#endif // NORM_XDP
         bool                            rx_port_reuse; // enable rx_socket port (sessionPort) reuse when true
+        bool                            rx_port_share;
+        NormRxPort*                     rx_port;        // shared receive port (when open)
+        NormRxDemuxItem*                rx_port_item;
+        unsigned int                    rx_shard_index;
+        unsigned int                    rx_shard_count; // (receive sharding is off unless > 1)
         ProtoAddress                    rx_bind_addr;
         ProtoAddress                    rx_connect_addr;
         
@@ -746,6 +1652,7 @@ class NormSession
         ProtoAddressList                dst_addr_list;  // list of local addresses
         NormMessageQueue                message_queue;
         NormMessageQueue                message_pool;
+        NormMsg                         rx_msg;  // (MAX_SIZE socket recv buffer)
         ProtoTimer                      report_timer;
         UINT16                          tx_sequence;
         
@@ -761,9 +1668,28 @@ class NormSession
         bool                            ecn_enabled;     // set true to get raw packets and check for ECN status
         
         char                            interface_name[IFACE_NAME_MAX+1];    
+        char                            xdp_interface[IFACE_NAME_MAX+1];   // AF_XDP disabled when empty
+        TxPath*                         tx_path_list[TX_PATH_MAX];    // (index 0, the tx_socket, is NULL)
+        double                          tx_path_weight[TX_PATH_MAX];
+        double                          tx_path_credit[TX_PATH_MAX];  // smooth weighted round-robin state
+        unsigned int                    tx_path_count;
+        ProtoAddress                    tx_layer_addr[LAYER_MAX];     // (index 0 is the session address)
+        double                          tx_layer_weight[LAYER_MAX];
+        double                          tx_layer_credit[LAYER_MAX];   // smooth weighted round-robin state
+        UINT16                          tx_layer_seq[LAYER_MAX];      // (layer 0 uses tx_sequence)
+        unsigned int                    tx_layer_count;
+        double                          tx_layer_scale;  // total rate / layer 0 rate
+        RxLayer                         rx_layer_list[LAYER_MAX];
+        unsigned int                    rx_layer_count;
+        unsigned int                    rx_layer_top;    // highest layer joined
+        double                          rx_layer_time;   // last join/leave decision (sec, 0.0 if none)
+        unsigned int                    rx_msg_layer;    // layer of the message being handled
         double                          tx_rate;  // bytes per second
         double                          tx_rate_min;
         double                          tx_rate_max;
+        double                          tx_budget_weight;  // see NormSessionMgr::SetTxRateBudget()
+        ProtoTime                       tx_budget_sent;    // last DrawTxBudget()
+        bool                            tx_budget_capped;  // (paced below its share by tx_rate)
         unsigned int                    tx_residual;    // for NORM_CMD(CC)/NORM_DATA "packet pairing"
         
         
@@ -777,6 +1703,15 @@ class NormSession
         UINT16                          nparity;
         UINT16                          auto_parity;
         UINT16                          extra_parity;
+        // Adaptive auto parity state: a histogram of estimated block losses
+        // (NACKed erasures plus auto parity sent) over a window of blocks
+        enum {ADAPT_PARITY_WINDOW = 64, ADAPT_LOSS_MAX = 255};
+        void SenderRecordBlockLoss(NormBlock& block, UINT16 numErasures);
+        void SenderAdaptParity();
+        bool                            adapt_parity;
+        double                          adapt_parity_target;
+        unsigned int                    adapt_block_count;    // blocks sent this window
+        unsigned int                    adapt_loss_hist[ADAPT_LOSS_MAX+1];
         bool                            sndr_emcon;
         bool                            tx_only;
         bool                            tx_connect;
@@ -784,21 +1719,47 @@ class NormSession
         
         NormObjectTable                 tx_table;
         ProtoSlidingMask                tx_pending_mask;
+        bool                            tx_pending_cached;  // "tx_pending_first" is valid
+        bool                            tx_pending_any;     // (false if mask was empty)
+        NormObjectId                    tx_pending_first;
+        bool                            tx_weighted;        // interleave objects by weight
+        unsigned int                    tx_weight_default;
+        NormObjectId                    tx_drr_object_id;   // object whose turn it is
+        unsigned int                    tx_drr_credit;      // segments left in its turn
+        unsigned int                    tx_drr_skips;       // turns passed without sending
         ProtoSlidingMask                tx_repair_mask;
         ProtoTimer                      repair_timer;
+        enum {NACK_DIGEST_SIZE = 256};  // (filled to at most half)
+        UINT64                          nack_digest[NACK_DIGEST_SIZE];
+        unsigned int                    nack_digest_count;
         NormBlockPool                   block_pool;
         NormSegmentPool                 segment_pool;
         NormEncoder*                    encoder;
+        char*                           tx_encode_buffer;
+        char**                          tx_encode_list;
         UINT8                           fec_id;
         UINT8                           fec_m;
+        UINT16                          fec_instance_id;  // for fec_id = 129 only
+        NormFecWorkerPool               tx_fec_pool;
+        NormParityCache                 tx_parity_cache;
+        bool                            tx_digest;
+        unsigned int                    tx_fec_worker_count;
         INT32                           fec_block_mask;
         
         NormObjectId                    next_tx_object_id;
         unsigned int                    tx_cache_count_min;
         unsigned int                    tx_cache_count_max;
         NormObjectSize                  tx_cache_size_max;
+        NormObjectSize                  tx_cache_size_base;  // configured size (floor when auto-tuning)
+        char                            tx_spill_dir[PATH_MAX];
+        unsigned int                    tx_spill_count_max;
+        NormObjectSize                  tx_spill_size_max;
+        unsigned int                    tx_spill_count;   // spilled objects (the oldest in the tx_table)
+        NormObjectSize                  tx_spill_size;
+        NormObjectId                    tx_spill_next;    // where to look for the next to spill
         ProtoTimer                      flush_timer;
         int                             flush_count;
+        bool                            tx_flush_piggyback;
         bool                            posted_tx_queue_empty;
         bool                            posted_tx_rate_changed;
         bool                            posted_send_error;
@@ -811,14 +1772,44 @@ class NormSession
         bool                            watermark_pending;
         bool                            watermark_flushes;
         bool                            watermark_active;
+        UINT32                          watermark_flush_serial;  // counts watermark flushes
         NormObjectId                    watermark_object_id;
         NormBlockId                     watermark_block_id;
         NormSegmentId                   watermark_segment_id;
+        // Older watermarks still outstanding after SenderAddWatermark()
+        // calls, oldest first in a ring ("watermark_*" is the newest)
+        enum {WATERMARK_PIPELINE_MAX = 16};
+        struct PipelinedWatermark
+        {
+            NormObjectId                object_id;
+            NormBlockId                 block_id;
+            NormSegmentId               segment_id;
+        };
+        PipelinedWatermark              watermark_pipeline[WATERMARK_PIPELINE_MAX];
+        unsigned int                    watermark_pipeline_head;
+        unsigned int                    watermark_pipeline_count;
         bool                            tx_repair_pending;
         NormObjectId                    tx_repair_object_min;
         NormBlockId                     tx_repair_block_min;
         NormSegmentId                   tx_repair_segment_min;
         
+        // for window-based transmission (see SetTxWindow())
+        bool                            tx_window_enable;
+        double                          tx_window;           // in bytes
+        UINT64                          tx_window_sent;      // object message bytes sent
+        UINT64                          tx_window_acked;     // bytes sent as of last completed watermark
+        bool                            tx_window_marked;    // true when "tx_window_mark" set for watermark
+        UINT64                          tx_window_mark;      // bytes sent when watermark was reached
+        ProtoTime                       tx_window_mark_time;
+        ProtoTime                       tx_window_ack_time;  // time of last completed watermark
+        double                          tx_window_cycle_min; // min watermark ACK cycle time
+        ProtoTime                       tx_window_cycle_time;
+        bool                            tx_window_auto;      // watermark pending was set for window
+        bool                            tx_window_limited;   // window blocked data since last ACK
+        NormObjectId                    tx_window_object_id; // index of last new data sent
+        NormBlockId                     tx_window_block_id;
+        NormSegmentId                   tx_window_segment_id;
+        
         // for unicast nack/cc feedback suppression
         bool                            advertise_repairs;
         bool                            suppress_nonconfirmed;
@@ -848,6 +1839,16 @@ class NormSession
         double                          gsize_measured;
         double                          gsize_advertised;
         UINT8                           gsize_quantized;
+        // Group size estimation state: "linear counting" bitmaps of hashed
+        // receiver ids for the current and previous epoch
+        enum {GSIZE_BITMAP_LOG2 = 12, GSIZE_BITMAP_BITS = (1 << GSIZE_BITMAP_LOG2)};
+        void SenderNoteReceiver(NormNodeId nodeId);
+        double SenderCountReceivers() const;
+        bool                            gsize_auto;
+        double                          gsize_age;
+        unsigned int                    gsize_epoch;   // index of current epoch bitmap
+        unsigned int                    gsize_zeros;   // unset bits in the union of both
+        UINT32                          gsize_bitmap[2][GSIZE_BITMAP_BITS / 32];
         
         // Sender congestion control parameters
         unsigned int                    probe_count;  // for experimentation (cc probes per rtt)
@@ -857,8 +1858,17 @@ class NormSession
         NormNodeList                    cc_node_list;
         bool                            cc_slow_start;
         bool                            cc_active;
+        CCMode                          cc_mode;
+        NormBandwidthModel              cc_model;
+        NormNodeId                      cc_model_clr;  // CLR the "cc_model" is tracking
         NormNode::Accumulator           sent_accumulator;  // for sentRate measurement
         double                          nominal_packet_size;
+        UINT64                          tx_stat_bytes;         // (cumulative statistics)
+        UINT64                          tx_stat_segments;
+        UINT64                          tx_stat_repair_bytes;
+        UINT64                          tx_stat_nacks;
+        bool                            latency_stats;
+        NormHistogram                   tx_latency;  // enqueue to first transmit
         bool                            data_active;       // true when actively sending data
         double                          flow_control_factor;
         ProtoTimer                      flow_control_timer;
@@ -879,18 +1889,52 @@ class NormSession
         // Receiver parameters
         bool                            is_receiver;
         int                             rx_robust_factor;
-        NormSenderNode*                 preset_sender;
+        NormNodeList                    preset_sender_list;  // (see PreallocateRemoteSenders())
         NormNodeTree                    sender_tree;
         unsigned long                   remote_sender_buffer_size;
         bool                            unicast_nacks;
         bool                            receiver_silent;
+        UINT8                           local_repair_ttl;
+        bool                            local_repairer;
+        NormNodeId                      ack_aggregator_id;
+        ProtoAddress                    ack_aggregator_addr;
+        bool                            ack_aggregation;
         bool                            rcvr_ignore_info;
         INT32                           rcvr_max_delay;
         bool                            rcvr_realtime;
+        bool                            rcvr_progressive;
+        NormSession*                    relay_session;
+        NormSession*                    rx_mirror_primary;
+        NormSession*                    rx_mirror_head;  // list of our mirrors
+        NormSession*                    rx_mirror_next;
+        NormSession*                    rx_demux_listener;
+        NormRxDemuxItem*                rx_demux_item;
+        NormRxDemuxTree                 rx_demux_tree;   // (listener only)
+        NormBufferPool*                 buffer_pool;
+        void*                           event_queue;
         NormSenderNode::RepairBoundary  default_repair_boundary;
         NormObject::NackingMode         default_nacking_mode;
         NormSenderNode::SyncPolicy      default_sync_policy;
+        NormSenderNode::EvictionPolicy  default_eviction_policy;
         UINT16                          rx_cache_count_max;
+        struct RxQuota
+        {
+            NormNodeId      sender_id;
+            NormNodeId      id_mask;
+            unsigned long   buffer_space;
+            UINT16          cache_max;
+        };
+        RxQuota*                        rx_quota_list;  // (see ReceiverSetSenderQuota())
+        unsigned int                    rx_quota_count;
+        unsigned int                    rx_decoder_cache_size;
+        unsigned int                    rx_fec_worker_count;
+        bool                            file_mapping;
+        NormFileIoEngine                file_io;
+        char                            rx_journal_dir[PATH_MAX];
+        bool                            slab_mode;
+        bool                            slab_huge_pages;
+        int                             slab_numa_node;
+        bool                            memory_prefault;
         NormFtiData                     preset_fti;
         
         // For NormSocket server-listener support
@@ -906,6 +1950,7 @@ class NormSession
         
         // Protocol test/debug parameters
         bool                            trace;
+        NormTraceRing                   trace_ring;
         double                          tx_loss_rate;  // for correlated loss
         double                          rx_loss_rate;  // for uncorrelated loss
         double                          report_timer_interval;
@@ -917,6 +1962,7 @@ class NormSession
         NormSession*                    next;
 };  // end class NormSession
 
+#ifndef NORM_NO_TRACE
 // This function prints out NORM message info
 void NormTrace(const struct timeval&    currentTime, 
                NormNodeId               localId, 
@@ -924,5 +1970,6 @@ void NormTrace(const struct timeval&    currentTime,
                bool                     sent,
                UINT8                    fecM,
 	           UINT16			instId = 0);  // this might not always be available to caller
+#endif // !NORM_NO_TRACE
 
 #endif  // _NORM_SESSION
@@ -53,14 +53,16 @@ class NormSimAgent : public NormController, public ProtoMessageSink
 		void SetSink(ProtoMessageSink* sink){msg_sink=sink;}
 #endif //OPNET     
 
-    private:
-        void OnInputReady();
-        bool FlushStream(bool eom);// = true);
+        // (protected so simulation environments can also observe events)
         virtual void Notify(NormController::Event event,
                             class NormSessionMgr* sessionMgr,
                             class NormSession*    session,
                             class NormSenderNode* sender,
                             class NormObject*     object);
+
+    private:
+        void OnInputReady();
+        bool FlushStream(bool eom);// = true);
         
         void ActivateTimer(ProtoTimer& theTimer)
             {session_mgr.ActivateTimer(theTimer);}
@@ -2,9 +2,9 @@
 #ifndef _NORM_SOCKET
 #define _NORM_SOCKET
 
-// IMPORTANT NOTE:  THIS IS A WORK IN PROGRESS. This code, if/when fully developed, will be 
-//                  "promoted" from the 'examples' directory to a standard part of the NORM
-//                  library if appropriate.
+// IMPORTANT NOTE:  THIS IS A WORK IN PROGRESS. This code has been "promoted" from the
+//                  'examples' directory to part of the NORM library, but its API may
+//                  still change as it is further developed.
 
 // This provides a higher level API that facilitates a socket-like programming interface
 // to use NORM for a specific usage pattern.  The usage pattern uses NORM_OBJECT_STREAM
@@ -51,9 +51,9 @@ typedef SSIZE_T ssize_t;
 
 typedef const void* NormSocketHandle;
 
-extern const NormSocketHandle NORM_SOCKET_INVALID;
+extern NORM_API_LINKAGE const NormSocketHandle NORM_SOCKET_INVALID;
 
-extern const double NORM_DEFAULT_CONNECT_TIMEOUT;
+extern NORM_API_LINKAGE const double NORM_DEFAULT_CONNECT_TIMEOUT;
 
 #ifndef NULL
 #define NULL 0
@@ -61,13 +61,16 @@ extern const double NORM_DEFAULT_CONNECT_TIMEOUT;
 
 // Main NormSocket API Functions
 
+NORM_API_LINKAGE
 NormSocketHandle NormOpen(NormInstanceHandle instance);
 
+NORM_API_LINKAGE
 bool NormListen(NormSocketHandle    normSocket,
                 UINT16              serverPort,
                 const char*         groupAddr = NULL,
                 const char*         serverAddr = NULL);
 
+NORM_API_LINKAGE
 bool NormConnect(NormSocketHandle   normSocket,
                  const char*        serverAddr,
                  UINT16             serverPort,
@@ -75,36 +78,53 @@ bool NormConnect(NormSocketHandle   normSocket,
                  const char*        groupAddr = NULL, 
                  NormNodeId         clientId = NORM_NODE_ANY);
 
+NORM_API_LINKAGE
 NormSocketHandle NormAccept(NormSocketHandle    serverSocket,
                             NormNodeHandle      clientNode,
                             NormInstanceHandle  instance = NORM_INSTANCE_INVALID);
 
+NORM_API_LINKAGE
 void NormReject(NormSocketHandle    serverSocket,
                 NormNodeHandle      clientNode);
         
+NORM_API_LINKAGE
 void NormShutdown(NormSocketHandle normSocket);
 
+NORM_API_LINKAGE
 void NormClose(NormSocketHandle normSocket);
 
+NORM_API_LINKAGE
 ssize_t NormRead(NormSocketHandle normSocket, void* buf, size_t nbyte);
 
+NORM_API_LINKAGE
 ssize_t NormWrite(NormSocketHandle normSocket, const void* buf, size_t nbyte);
 
+NORM_API_LINKAGE
 int NormFlush(NormSocketHandle normSocket);
 
 // NormSocket helper functions
 
+NORM_API_LINKAGE
 void NormSetSocketUserData(NormSocketHandle normSocket, const void* userData);
+NORM_API_LINKAGE
 const void* NormGetSocketUserData(NormSocketHandle normSocket);
         
+NORM_API_LINKAGE
 NormInstanceHandle NormGetSocketInstance(NormSocketHandle normSocket);
+NORM_API_LINKAGE
 NormSessionHandle NormGetSocketSession(NormSocketHandle normSocket);
+NORM_API_LINKAGE
 NormSessionHandle NormGetSocketMulticastSession(NormSocketHandle normSocket);
+NORM_API_LINKAGE
 void NormGetPeerName(NormSocketHandle normSocket, char* addr, unsigned int* addrLen, UINT16* port);
+NORM_API_LINKAGE
 NormObjectHandle NormGetSocketTxStream(NormSocketHandle normSocket);
+NORM_API_LINKAGE
 NormObjectHandle NormGetSocketRxStream(NormSocketHandle normSocket);
 
+NORM_API_LINKAGE
 void NormSetSocketFlowControl(NormSocketHandle normSocket, bool enable);
+NORM_API_LINKAGE
 void NormSetSocketTrace(NormSocketHandle normSocket, bool enable);
 
 typedef enum NormSocketEventType
@@ -132,9 +152,13 @@ typedef struct
     unsigned int    buffer_size;      // used for both FEC and stream buffer sizing
     bool            silent_receiver;  // not yet used  (maybe should be nack_mode instead)
     int             max_delay;        // not yet used
+    unsigned int    pool_size;        // unicast server buffer pool shared by accepted
+                                      // sockets (0 for per-socket FEC buffers)
 } NormSocketOptions;
 
+NORM_API_LINKAGE
 void NormGetSocketOptions(NormSocketHandle normSocket, NormSocketOptions* options);
+NORM_API_LINKAGE
 bool NormSetSocketOptions(NormSocketHandle normSocket, NormSocketOptions* options);
     
 #pragma GCC diagnostic push
@@ -160,6 +184,7 @@ typedef struct
 } NormSocketEvent;
 #pragma GCC diagnostic pop
     
+NORM_API_LINKAGE
 bool NormGetSocketEvent(NormInstanceHandle normInstance, NormSocketEvent* event, bool waitForEvent = true);
 
 
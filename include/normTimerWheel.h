@@ -0,0 +1,138 @@
+#ifndef _NORM_TIMER_WHEEL
+#define _NORM_TIMER_WHEEL
+
+#include "protokit.h"
+
+// The NormTimerWheel is a hierarchical timing wheel for the large numbers
+// of long-lived timers a session can accumulate (e.g., one activity timer
+// per remote sender).  Timers are kept in per-tick slot lists so
+// activation and deactivation are O(1) no matter how many are active, and
+// all timers expiring in a tick are handled in one batch.  The wheel is
+// driven by a single ProtoTimer in the underlying ProtoTimerMgr that is
+// only scheduled for ticks with something to do.
+//
+// LEVEL_COUNT levels of LEVEL_SIZE slots cover 2^32 ticks (about 49 days
+// at the default 1 msec tick). Timers are rounded up to a tick so
+// timers needing finer resolution should stay with the ProtoTimerMgr.
+//
+// NormTimerWheel::Timer mimics the ProtoTimer interval / repeat semantics
+// and the listener's return value has the same meaning: "false" says the
+// timer was deactivated or reactivated by the listener.
+
+class NormTimerWheel
+{
+    public:
+        class Timer
+        {
+            friend class NormTimerWheel;
+            public:
+                Timer();
+                ~Timer();
+
+                template <class listenerType>
+                bool SetListener(listenerType* theListener, bool(listenerType::*timeoutHandler)(Timer&))
+                {
+                    if (NULL != listener) delete listener;
+                    listener = (theListener && timeoutHandler) ?
+                                new LISTENER_TYPE<listenerType>(theListener, timeoutHandler) : NULL;
+                    return (NULL != theListener) ? (NULL != listener) : true;
+                }
+                void SetInterval(double theInterval)
+                    {interval = (theInterval > 0.0) ? theInterval : 0.0;}
+                double GetInterval() const
+                    {return interval;}
+                // (-1 repeats forever and 0 is a one-shot timer)
+                void SetRepeat(int numRepeat)
+                    {repeat = numRepeat;}
+                int GetRepeat() const
+                    {return repeat;}
+                void ResetRepeat()
+                    {repeat_count = repeat;}
+                int GetRepeatCount() const
+                    {return repeat_count;}
+                void SetRepeatCount(int repeatCount)
+                    {repeat_count = repeatCount;}
+
+                bool IsActive() const
+                    {return (NULL != wheel);}
+                void Deactivate();
+                // Restarts the timer's interval from now (repeat count kept)
+                void Reschedule();
+                double GetTimeRemaining() const;
+
+            private:
+                class Listener
+                {
+                    public:
+                        virtual ~Listener() {}
+                        virtual bool on_timeout(Timer& theTimer) = 0;
+                };
+                template <class listenerType>
+                class LISTENER_TYPE : public Listener
+                {
+                    public:
+                        LISTENER_TYPE(listenerType* theListener, bool(listenerType::*timeoutHandler)(Timer&))
+                            : listener(theListener), timeout_handler(timeoutHandler) {}
+                        bool on_timeout(Timer& theTimer)
+                            {return (listener->*timeout_handler)(theTimer);}
+                    private:
+                        listenerType* listener;
+                        bool (listenerType::*timeout_handler)(Timer&);
+                };
+
+                Listener*       listener;
+                double          interval;
+                int             repeat;
+                int             repeat_count;
+                NormTimerWheel* wheel;        // non-NULL when active
+                UINT64          expire_tick;
+                int             level;        // (-1 when not in a slot)
+                Timer**         list_head;    // slot (or expiry batch) list we're in
+                Timer*          prev;
+                Timer*          next;
+        };  // end class NormTimerWheel::Timer
+
+        enum {DEFAULT_TICK_USEC = 1000};
+
+        NormTimerWheel(ProtoTimerMgr& timerMgr, unsigned int tickUsec = DEFAULT_TICK_USEC);
+        ~NormTimerWheel();
+
+        void ActivateTimer(Timer& theTimer);
+        void DeactivateTimer(Timer& theTimer);
+        unsigned int GetTimerCount() const
+            {return timer_count;}
+        double GetTickInterval() const
+            {return (1.0e-06 * (double)tick_usec);}
+
+    private:
+        enum
+        {
+            LEVEL_BITS  = 8,
+            LEVEL_SIZE  = 1 << LEVEL_BITS,
+            LEVEL_MASK  = LEVEL_SIZE - 1,
+            LEVEL_COUNT = 4
+        };
+
+        UINT64 CurrentTick() const;
+        UINT64 IntervalTicks(double interval) const;
+        void Link(Timer& theTimer, Timer** head);
+        void Unlink(Timer& theTimer);
+        void Insert(Timer& theTimer);   // into slot for its "expire_tick"
+        void Cascade(int level);        // redistributes slot at "base_tick"
+        void Schedule();                // (re)schedules "tick_timer"
+        bool OnTickTimeout(ProtoTimer& theTimer);
+
+        ProtoTimerMgr&      timer_mgr;
+        ProtoTimer          tick_timer;
+        unsigned int        tick_usec;
+        UINT64              base_tick;    // next tick to be processed
+        UINT64              wake_tick;    // when "tick_timer" is set to fire
+        Timer*              slot[LEVEL_COUNT][LEVEL_SIZE];
+        unsigned int        level_count[LEVEL_COUNT];
+        Timer*              expire_list;  // batch of timers being expired
+        unsigned int        timer_count;
+        bool                in_timeout;   // (Schedule() deferred while expiring)
+
+};  // end class NormTimerWheel
+
+#endif // _NORM_TIMER_WHEEL
@@ -0,0 +1,135 @@
+#ifndef _NORM_TRACE_RING
+#define _NORM_TRACE_RING
+
+#include "protokit.h"
+#include <stdio.h>
+
+class NormMsg;
+
+// The NormTraceRing is a binary per-packet trace cheap enough to leave on
+// at full packet rates (unlike the PLOG text NormTrace()).  Each message
+// sent or received is reduced to a fixed size Record that overwrites the
+// oldest one when the ring is full, so the ring always holds the most
+// recent traffic.  Write() saves the ring contents (oldest first) to a
+// file of network byte order records that ReadHeader()/ReadRecord() parse
+// offline (see "n2m" and "pcap2norm") without any of the NORM library.
+
+class NormTraceRing
+{
+    public:
+        NormTraceRing();
+        ~NormTraceRing();
+
+        enum Flag
+        {
+            FLAG_SENT       = 0x01,  // else received
+            FLAG_REPAIR     = 0x02,  // DATA/INFO with FLAG_REPAIR
+            FLAG_STREAM     = 0x04,  // DATA for a stream object
+            FLAG_WATERMARK  = 0x08,  // CMD(FLUSH) requesting acks
+            FLAG_CLR        = 0x10,  // NACK/ACK cc feedback from the CLR
+            FLAG_IPV6       = 0x20   // ("addr" is not recorded)
+        };
+        struct Record
+        {
+            UINT32  sec;        // (UTC time)
+            UINT32  usec;
+            UINT8   type;       // NormMsg::Type
+            UINT8   subtype;    // CMD flavor or ACK type
+            UINT8   flags;
+            UINT8   reserved;
+            UINT16  seq;
+            UINT16  length;
+            UINT32  sourceId;
+            UINT16  instId;
+            UINT16  objectId;
+            UINT32  blockId;    // (the cc sequence for CMD(CC))
+            UINT16  segmentId;
+            UINT16  port;       // remote (src or dst) port
+            UINT32  addr;       // remote IPv4 address (network order)
+        };
+        enum
+        {
+            RECORD_SIZE         = 36,
+            FILE_HEADER_SIZE    = 16,
+            FILE_VERSION        = 1
+        };
+
+        bool Open(unsigned int numRecords);
+        void Close();
+        bool IsOpen() const
+            {return (NULL != ring);}
+        unsigned int GetCount() const
+            {return count;}
+        // (index 0 is the oldest record)
+        const Record& GetRecord(unsigned int index) const
+            {return ring[(count < size) ? index : ((next + index) % size)];}
+
+        void Add(const struct timeval& currentTime,
+                 const NormMsg&        msg,
+                 bool                  sent,
+                 UINT8                 fecM,
+                 UINT16                instId);
+
+        // Saves records oldest first, the ring is left as is
+        bool Write(const char* path, UINT32 localId) const;
+
+        // Offline parsing of a Write() file
+        static bool ReadHeader(FILE* filePtr, UINT32& localId, UINT32& recordCount)
+        {
+            UINT8 buffer[FILE_HEADER_SIZE];
+            if (1 != fread(buffer, FILE_HEADER_SIZE, 1, filePtr)) return false;
+            if (0 != memcmp(buffer, "NTRC", 4)) return false;
+            if ((FILE_VERSION != GetUINT16(buffer + 4)) || (RECORD_SIZE != GetUINT16(buffer + 6)))
+                return false;
+            localId = GetUINT32(buffer + 8);
+            recordCount = GetUINT32(buffer + 12);
+            return true;
+        }
+        static bool ReadRecord(FILE* filePtr, Record& record)
+        {
+            UINT8 buffer[RECORD_SIZE];
+            if (1 != fread(buffer, RECORD_SIZE, 1, filePtr)) return false;
+            record.sec = GetUINT32(buffer);
+            record.usec = GetUINT32(buffer + 4);
+            record.type = buffer[8];
+            record.subtype = buffer[9];
+            record.flags = buffer[10];
+            record.reserved = buffer[11];
+            record.seq = GetUINT16(buffer + 12);
+            record.length = GetUINT16(buffer + 14);
+            record.sourceId = GetUINT32(buffer + 16);
+            record.instId = GetUINT16(buffer + 20);
+            record.objectId = GetUINT16(buffer + 22);
+            record.blockId = GetUINT32(buffer + 24);
+            record.segmentId = GetUINT16(buffer + 28);
+            record.port = GetUINT16(buffer + 30);
+            memcpy(&record.addr, buffer + 32, 4);
+            return true;
+        }
+        // Prints a NormTrace() style "trace>" line
+        static void Print(FILE* filePtr, UINT32 localId, const Record& record);
+
+    private:
+        static UINT16 GetUINT16(const UINT8* ptr)
+            {return (((UINT16)ptr[0] << 8) | (UINT16)ptr[1]);}
+        static UINT32 GetUINT32(const UINT8* ptr)
+            {return (((UINT32)GetUINT16(ptr) << 16) | (UINT32)GetUINT16(ptr + 2));}
+        static void PutUINT16(UINT8* ptr, UINT16 value)
+        {
+            ptr[0] = (UINT8)(value >> 8);
+            ptr[1] = (UINT8)value;
+        }
+        static void PutUINT32(UINT8* ptr, UINT32 value)
+        {
+            PutUINT16(ptr, (UINT16)(value >> 16));
+            PutUINT16(ptr + 2, (UINT16)value);
+        }
+
+        Record*         ring;
+        unsigned int    size;
+        unsigned int    next;   // index the next Add() fills
+        unsigned int    count;
+
+};  // end class NormTraceRing
+
+#endif // _NORM_TRACE_RING
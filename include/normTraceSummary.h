@@ -0,0 +1,87 @@
+#ifndef _NORM_TRACE_SUMMARY
+#define _NORM_TRACE_SUMMARY
+
+#include "normTraceRing.h"  // for NormTraceRing::Record
+
+// The NormTraceSummary reduces a packet trace (NormTraceRing records, as
+// decoded by "pcap2norm" and "n2m") to one row per sender object of
+// throughput, loss and repair figures, printed as whitespace separated
+// columns under a header line for direct use by spreadsheet or plotting
+// tools (instead of MGEN-format lines for "trpr"):
+//
+//   sender      - NormNodeId of the sender (hex)
+//   object      - NormObjectId
+//   start/end   - time of the first and last object message (sec, UTC)
+//   pkts/bytes  - DATA and INFO messages (including repairs) and bytes
+//   kbps        - message throughput over "start" to "end"
+//   repairs     - messages with the repair flag set
+//   nacks       - NACKs for the sender while this object was current
+//   runs/lost   - gaps in the sender's message sequence numbers found at
+//   maxRun        this object's messages, messages lost and longest gap
+//   rptAvg/Max  - time from the first NACK (after a repair) to the next
+//                 repair message from the sender (msec)
+//
+// Records must be added in time order, each with the sender it pertains to.
+
+class NormTraceSummary
+{
+    public:
+        NormTraceSummary();
+        ~NormTraceSummary();
+
+        // The sender a record pertains to: the source of sender messages,
+        // or "localId" (the trace's own node) for NACK and ACK messages
+        // received.  Zero (unknown) for NACK and ACK messages sent.
+        static UINT32 GetSenderId(const NormTraceRing::Record& record, UINT32 localId);
+
+        void Add(const NormTraceRing::Record& record, UINT32 senderId);
+        void Print(FILE* filePtr) const;
+        void Destroy();
+
+        unsigned int GetObjectCount() const
+            {return object_count;}
+
+    private:
+        enum
+        {
+            SENDER_HASH_SIZE = 256,  // (must be power of two)
+            OBJECT_HASH_SIZE = 256
+        };
+        struct Object
+        {
+            UINT32      sender_id;
+            UINT16      object_id;
+            double      time_first;
+            double      time_last;
+            UINT32      pkt_count;
+            double      byte_count;
+            UINT32      repair_count;
+            UINT32      nack_count;
+            UINT32      run_count;
+            UINT32      lost_count;
+            UINT32      run_max;
+            UINT32      repair_samples;
+            double      repair_delay_sum;
+            double      repair_delay_max;
+            Object*     next;       // (hash chain)
+        };
+        struct Sender
+        {
+            UINT32      id;
+            bool        seq_valid;
+            UINT16      seq_last;
+            double      nack_time;  // first NACK since a repair (< 0 if none)
+            Object*     current;    // most recent object
+            Object*     object_table[OBJECT_HASH_SIZE];
+            Sender*     next;       // (hash chain)
+        };
+        Sender* GetSender(UINT32 senderId);
+        Object* GetObject(Sender& sender, UINT16 objectId, double time);
+        static int CompareObjects(const void* a, const void* b);
+
+        Sender*         sender_table[SENDER_HASH_SIZE];
+        unsigned int    object_count;
+
+};  // end class NormTraceSummary
+
+#endif // _NORM_TRACE_SUMMARY
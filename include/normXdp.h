@@ -0,0 +1,85 @@
+#ifndef _NORM_XDP
+#define _NORM_XDP
+
+#include "protokit.h"
+
+// The AF_XDP socket backend is only available on Linux (5.4+ recommended)
+// with libxdp; "HAVE_LIBXDP" is set by the build when enabled
+#if defined(HAVE_LIBXDP) && !defined(SIMULATE)
+#define NORM_XDP
+#endif // HAVE_LIBXDP && !SIMULATE
+
+#ifdef NORM_XDP
+#include <xdp/xsk.h>
+
+// The NormXdpSocket class is an AF_XDP "kernel bypass" alternative to the
+// NormSession UDP sockets.  It binds to a single NIC queue and exchanges
+// raw Ethernet frames with the driver through a shared "UMEM" frame area,
+// so received frames are parsed in place and outbound frames are built
+// directly in UMEM with no kernel socket buffer copies or per-packet
+// system calls.  The UMEM is split in half between the rx (fill) ring and
+// a free list of tx frames.
+//
+// IMPORTANT: The default XDP program that libxdp loads redirects _all_
+// traffic arriving on the bound queue to the socket, so that queue should
+// be dedicated to NORM traffic with NIC flow steering, e.g.:
+//
+//     ethtool -N <iface> flow-type udp4 dst-port <port> action <queue>
+
+class NormXdpSocket : public ProtoChannel
+{
+    public:
+        NormXdpSocket();
+        ~NormXdpSocket();
+
+        enum
+        {
+            FRAME_SIZE  = XSK_UMEM__DEFAULT_FRAME_SIZE,
+            FRAME_COUNT = 4096,   // (half for rx, half for tx)
+            RING_SIZE   = FRAME_COUNT / 2,
+            TX_OFFSET   = 2       // so IP headers are 32-bit aligned
+        };
+
+        bool Open(const char* ifaceName, unsigned int queueId);
+        void Close();
+        unsigned int GetInterfaceIndex() const
+            {return if_index;}
+        bool IsZeroCopy() const
+            {return zero_copy;}
+
+        // Returns the number of received frames (up to "maxFrames") that
+        // may be accessed with GetRxFrame() until RecvRelease() is called.
+        unsigned int RecvPeek(unsigned int maxFrames);
+        const char* GetRxFrame(unsigned int index, unsigned int& frameLen) const;
+        void RecvRelease();
+
+        // Returns the next free tx frame buffer (or NULL if none are free)
+        // for the caller to build a frame in and pass to Send()
+        char* GetTxFrame(unsigned int& maxLen);
+        bool Send(char* frame, unsigned int frameLen);
+        // Kicks the kernel to transmit Send() frames (if needed)
+        void Flush();
+
+    private:
+        void Reclaim();  // returns completed tx frames to "tx_free_list"
+
+        unsigned int            if_index;
+        bool                    zero_copy;
+        char*                   umem_area;
+        struct xsk_umem*        umem;
+        struct xsk_socket*      xsk;
+        struct xsk_ring_prod    fill_ring;
+        struct xsk_ring_cons    comp_ring;
+        struct xsk_ring_cons    rx_ring;
+        struct xsk_ring_prod    tx_ring;
+        UINT32                  rx_index;
+        unsigned int            rx_count;
+        UINT64*                 tx_free_list;
+        unsigned int            tx_free_count;
+        unsigned int            tx_pending;
+
+};  // end class NormXdpSocket
+
+#endif // NORM_XDP
+
+#endif // _NORM_XDP
@@ -17,15 +17,32 @@ LOCAL_SRC_FILES := \
 	../../../src/common/galois.cpp \
 	../../../src/common/normApi.cpp \
 	../../../src/common/normEncoder.cpp \
+	../../../src/common/normEncoderLDPC.cpp \
 	../../../src/common/normEncoderMDP.cpp \
+	../../../src/common/normEncoderOCL.cpp \
 	../../../src/common/normEncoderRS16.cpp \
 	../../../src/common/normEncoderRS8.cpp \
+	../../../src/common/normFecWorker.cpp \
 	../../../src/common/normFile.cpp \
+	../../../src/common/normFileIo.cpp \
+	../../../src/common/normArchive.cpp \
+	../../../src/common/normDigest.cpp \
+	../../../src/common/normAead.cpp \
+	../../../src/common/normDataPool.cpp \
+	../../../src/common/normGFKernel.cpp \
 	../../../src/common/normMessage.cpp \
+	../../../src/common/normMsgBatch.cpp \
 	../../../src/common/normNode.cpp \
 	../../../src/common/normObject.cpp \
 	../../../src/common/normSegment.cpp \
-	../../../src/common/normSession.cpp
+	../../../src/common/normSession.cpp \
+	../../../src/common/normXdp.cpp
+	../../../src/common/normTimerWheel.cpp
+	../../../src/common/normBitmask.cpp
+	../../../src/common/normCommandRing.cpp
+	../../../src/common/normHistogram.cpp
+	../../../src/common/normTraceRing.cpp
+	../../../src/common/normSocket.cpp
 include $(BUILD_STATIC_LIBRARY)
 
 include $(CLEAR_VARS)
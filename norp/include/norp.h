@@ -372,9 +372,12 @@ class NorpSession : public ProtoTree::Item
             
         enum {SOCKS_BUFFER_SIZE = 16384};
         enum {NORP_BUFFER_SIZE = 512};
-        enum {NORM_BUFFER_SIZE = (8192*1024)};
         
         unsigned int WriteToNormStream(const char* buffer, unsigned int numBytes);
+        // Zero-copy alternative to Recv() plus WriteToNormStream() that receives
+        // TCP data straight into the NORM stream buffer (see Norp::SetNormSplice())
+        bool SpliceToNormStream(ProtoSocket& srcSocket);
+        void ResumeNormSplice();
         void FlushNormStream(bool eom, NormFlushMode flushMode);
         unsigned int ComputeNormStreamBufferSegmentCount(unsigned int bufferBytes, UINT16 segmentSize, UINT16 blockSize);
 
@@ -421,6 +424,7 @@ class NorpSession : public ProtoTree::Item
         unsigned int        norm_stream_buffer_count;
         unsigned int        norm_stream_bytes_remain;
         bool                norm_watermark_pending;
+        bool                norm_splice_blocked;  // splice source input paused for flow control
         
 };  // end class NorpSession
 
@@ -453,6 +457,8 @@ class Norp
             DEFAULT_NORP_PORT  = 7001,  // Where NORP listens for UDP signaling, relayed commands, etc
             DEFAULT_NORM_PORT  = 7002   // Port used for NORM data transfer
         };
+        enum {DEFAULT_NORM_BUFFER_SIZE = (8192*1024)};  // per NORM session tx/rx buffer
+        enum {NORM_POOL_MAX = 16};
             
         static const double DEFAULT_TX_RATE;
         static const double DEFAULT_PERSIST_INTERVAL;
@@ -572,6 +578,38 @@ class Norp
         UINT16 GetNormParityAuto() const
             {return norm_parity_auto;}
         
+        // Sets the NORM sender, receiver and stream buffer size of each proxied
+        // connection (this is most of the memory a connection uses)
+        void SetNormBufferSize(unsigned int numBytes)
+            {norm_buffer_size = numBytes;}
+        unsigned int GetNormBufferSize() const
+            {return norm_buffer_size;}
+        
+        // When enabled, TCP data is received directly into the NORM stream
+        // buffer (NormStreamReserve()/NormStreamCommit()) instead of being
+        // copied through the session's intermediate buffer
+        void SetNormSplice(bool enable)
+            {norm_splice = enable;}
+        bool GetNormSplice() const
+            {return norm_splice;}
+        
+        // Keeps up to "count" idle, already started originator NORM sessions 
+        // ready per remote NORP peer so new connections skip NORM session setup
+        void SetNormSessionPool(unsigned int count)
+            {norm_pool_size = (count < NORM_POOL_MAX) ? count : NORM_POOL_MAX;}
+        unsigned int GetNormSessionPool() const
+            {return norm_pool_size;}
+        
+        // Creates an originator-side (tx-only, not yet probing) NORM session 
+        // to the given remote NORP peer
+        NormSessionHandle CreateOriginatorSession(const ProtoAddress& remoteAddr, UINT16 instanceId);
+        // Returns a pooled session for the "remoteAddr" peer, if one is ready
+        NormSessionHandle GrabPooledSession(const ProtoAddress& remoteAddr);
+        // Tops up the pool of sessions for the "remoteAddr" peer
+        void FillSessionPool(const ProtoAddress& remoteAddr);
+        // Destroys the pooled sessions for "remoteAddr" (or all if NULL)
+        void FlushSessionPool(const ProtoAddress* remoteAddr = NULL);
+        
         ProtoSocket::Notifier& GetSocketNotifier() const
             {return static_cast<ProtoSocket::Notifier&>(dispatcher);}
         
@@ -634,6 +672,18 @@ class Norp
         UINT16              norm_block_size;   // number of user data segments per FEC coding block
         UINT16              norm_parity_count; // number of _computed_ parity segments per FEC coding block
         UINT16              norm_parity_auto;  // number of proactive (automatically sent) parity segments per block
+        unsigned int        norm_buffer_size;  // per connection NORM session buffer size
+        bool                norm_splice;       // receive TCP data in place into NORM stream
+        
+        // Pool of idle originator NORM sessions (see SetNormSessionPool())
+        struct PooledSession
+        {
+            NormSessionHandle   session;
+            ProtoAddress        remote_addr;
+        };
+        PooledSession       norm_pool[NORM_POOL_MAX];
+        unsigned int        norm_pool_count;
+        unsigned int        norm_pool_size;
         
         bool                norm_trace;
         
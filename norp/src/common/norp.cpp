@@ -68,7 +68,7 @@ NorpSession::NorpSession(Norp& theController, UINT16 sessionId, NormNodeId origi
    persist_interval(Norp::DEFAULT_PERSIST_INTERVAL), persist_start_time(0, 0),
    norm_rate_min(-1.0), norm_rate_max(-1.0),
    norm_segment_size(0), norm_stream_buffer_max(0), norm_stream_buffer_count(0),
-   norm_stream_bytes_remain(0), norm_watermark_pending(false)
+   norm_stream_bytes_remain(0), norm_watermark_pending(false), norm_splice_blocked(false)
 {
     memset(&session_id, 0, sizeof(Moniker));
     session_id.originator = originatorId;
@@ -688,83 +688,31 @@ bool NorpSession::PutRemoteRequest(const ProtoPktSOCKS::Request& request, const
     // "session_id.identifier" to the end.  This "identifier" gives the command a unique key in
     // the context of the NorpSession "originator" NormNodeId to recognize if it is a repeated
     // request command, etc.
+    bool newSession = false;
     if (NORM_SESSION_INVALID == norm_session)
     {
-        // This creates the client-side NORM session for a connection.
-        // (TBD) Create single-socket NORM session using an ephemeral port and connect() to the remote
-        //       NORP server NORM port. (Use NormChangeDestination() after NormStartReceiver() to 
-        //       configure this newly-create NormSession as needed)
-#ifdef NEW_PORT
-        // We use port zero to get session that will bound to an ephemeral port (single port for tx and rx) upon NormStartReceiver
-        norm_session = NormCreateSession(controller.GetNormInstance(), remoteAddr.GetHostString(), 0, controller.GetNormNodeId());
-#else 
-        norm_session = NormCreateSession(controller.GetNormInstance(), remoteAddr.GetHostString(), controller.GetNormPort(), controller.GetNormNodeId());
-#endif
-        if (NORM_SESSION_INVALID == norm_session)
+        // This gets the client-side NORM session for a connection, either a ready one
+        // from our controller's pool (see Norp::SetNormSessionPool()) or a new one
+        if (NORM_SESSION_INVALID == (norm_session = controller.GrabPooledSession(remoteAddr)))
         {
-            PLOG(PL_ERROR, "NorpSession::PutRemoteRequest() NormCreateSession() failure!\n");
-            return false;
+            norm_session = controller.CreateOriginatorSession(remoteAddr, GetSessionId());
+            if (NORM_SESSION_INVALID == norm_session)
+            {
+                PLOG(PL_ERROR, "NorpSession::PutRemoteRequest() error: unable to create NORM session!\n");
+                return false;
+            }
         }
-        NormSetMessageTrace(norm_session, controller.GetNormTrace());
+        newSession = true;
         NormSetUserData(norm_session, this); 
-        NormSetDefaultSyncPolicy(norm_session, NORM_SYNC_STREAM);
-        
-        // We use a 2-step sender/receiver startup  process by first opening an idle, "tx-only" NormSession to
-        // send the Request command to the remote "controller" NormSession (The remote will get our "tx port" 
-        // info as part of this request sent). Our controller will get the REQ_ACK and/or SOCKS_REPLY message, 
-        // then inform us, and so we will get the remote "tx port" info so we can then start our own receiver  
-        // and "connect" our NORM rx_socket to the remote tx_socket.  The sender here is made "idle" by disabling
-        // disabling the normal NORM GRTT probing.  We don't re-activate that until we know the remote end has 
-        // a receiver running (This is done upon REQ_ACK or SOCKS_REPLY reception when we also start our own NORM 
-        // receiver).
-        
-        char ifaceName[64];
-        ifaceName[63] = '\0';
-        if (ProtoNet::GetInterfaceName(controller.GetProxyAddress(), ifaceName, 63))
-            NormSetMulticastInterface(norm_session, ifaceName);
-        else
-            PLOG(PL_ERROR, "NorpSession::PutRemoteRequest() warning: unable to get interface name for address %s\n", controller.GetProxyAddress().GetHostString());
-        switch (controller.GetNormCC())
-        {
-            case Norp::NORM_CC:  // default TCP-friendly congestion control
-                // do nothing, this is NORM's default mode
-                break;
-            case Norp::NORM_CCE: // "wireless-ready" ECN-only congestion control
-                NormSetEcnSupport(norm_session, true, true);
-                break;
-            case Norp::NORM_CCL: // "loss tolerant", non-ECN congestion control
-                NormSetEcnSupport(norm_session, false, false, true);
-                break;
-            case Norp::NORM_FIXED:  // fixed-rate operation
-                // if cumulative rate limit has been imposed, it can override the fixed rate
-                // (i.e. to share pipe among multiple flows)
-                if ((norm_rate_min >= 0) && (norm_rate_min < controller.GetNormTxRate()))
-                    NormSetTxRate(norm_session, norm_rate_min);                    
-                else
-                    NormSetTxRate(norm_session, controller.GetNormTxRate());
-                break;
-        }
+        // If cumulative rate limit has been imposed, it can override the fixed rate
+        // (i.e. to share pipe among multiple flows)
+        if ((Norp::NORM_FIXED == controller.GetNormCC()) && 
+            (norm_rate_min >= 0) && (norm_rate_min < controller.GetNormTxRate()))
+            NormSetTxRate(norm_session, norm_rate_min);
         if ((norm_rate_min >= 0.0) || (norm_rate_max >= 0.0))
             NormSetTxRateBounds(norm_session, norm_rate_min, norm_rate_max);
-        
-        // Even though we call "NormStartSender()" to get a "tx port" value, we disable GRTT probing and thus
-        // defer "real" sender startup until we get an ACK to our request (see "OriginatorStartNorm()")
-        NormSetTxOnly(norm_session, true);
-        NormSetGrttProbingMode(norm_session, NORM_PROBE_NONE);  // no probing until remote receiver is started
-        if (!NormStartSender(norm_session, GetSessionId(), NORM_BUFFER_SIZE, controller.GetNormSegmentSize(), 
-                             controller.GetNormBlockSize(), controller.GetNormParityCount()))
-        {
-            PLOG(PL_ERROR, "NorpSession::PutRemoteRequest() error: NormStartSender() failure!\n");
-            return false;
-        }
-#ifdef NEW_PORT
-        // Now call NormChangeDestination() to set proper destination port and "connect" to it
-        NormChangeDestination(norm_session, remoteAddr.GetHostString(), controller.GetNormPort(), true);
-#endif // NEW_PORT
-        //NormSetTxSocketBuffer(norm_session, 4096);
-        NormSetFlowControl(norm_session, 0.0);  // disable timer-based flow control since we are ACK-limiting writes to stream
         norm_segment_size = controller.GetNormSegmentSize();
-        norm_stream_buffer_max = ComputeNormStreamBufferSegmentCount(NORM_BUFFER_SIZE, norm_segment_size, controller.GetNormBlockSize());
+        norm_stream_buffer_max = ComputeNormStreamBufferSegmentCount(controller.GetNormBufferSize(), norm_segment_size, controller.GetNormBlockSize());
         norm_stream_buffer_max -= controller.GetNormBlockSize();  // a little safety margin
         norm_stream_buffer_count = 0;
         norm_stream_bytes_remain = 0;
@@ -809,6 +757,8 @@ bool NorpSession::PutRemoteRequest(const ProtoPktSOCKS::Request& request, const
     norp_msg_timer.SetInterval(2.0 * norp_rtt_estimate);
     ActivateTimer(norp_msg_timer);
     socks_state = SOCKS_PUT_REQUEST;
+    // Now that the request is on its way, ready another session for the next connection
+    if (newSession) controller.FillSessionPool(remoteAddr);
     return true;
 }  // end NorpSession::PutRemoteRequest()
 
@@ -821,6 +771,8 @@ bool NorpSession::MakeDirectConnect()
     {
         NormDestroySession(norm_session);
         norm_session = NORM_SESSION_INVALID;
+        // The remote isn't NORP-enabled, so sessions pooled for it are of no use
+        controller.FlushSessionPool(&norp_remote_addr);
     }
     if (norp_msg_timer.IsActive()) norp_msg_timer.Deactivate();
     if (NorpMsg::SOCKS_REQ != norp_msg.GetType())
@@ -953,7 +905,7 @@ bool NorpSession::OriginatorStartNorm(const ProtoAddress& senderAddr,
                     controller.GetNormNodeId(), normSrcPort);
     NormSetGrttEstimate(norm_session, norp_rtt_estimate);  // init NORM with value learned from NORP setup handshake
     NormSetRxPortReuse(norm_session, true, NULL, senderAddr.GetHostString(), normSrcPort);
-    if (!NormStartReceiver(norm_session, NORM_BUFFER_SIZE))
+    if (!NormStartReceiver(norm_session, controller.GetNormBufferSize()))
     {
         PLOG(PL_ERROR, "NorpSession::OriginatorStartNorm() error: NormStartReceiver() failure!\n");
         return false;
@@ -965,7 +917,7 @@ bool NorpSession::OriginatorStartNorm(const ProtoAddress& senderAddr,
         NormSetCongestionControl(norm_session, true);  // Note this also re-enables GRTT probing that was disabled at session creation
     else
         NormSetGrttProbingMode(norm_session, NORM_PROBE_ACTIVE);  // re-enables previously suspended GRTT probing
-    if (NORM_OBJECT_INVALID == (norm_tx_stream = NormStreamOpen(norm_session, NORM_BUFFER_SIZE)))
+    if (NORM_OBJECT_INVALID == (norm_tx_stream = NormStreamOpen(norm_session, controller.GetNormBufferSize())))
     {
         PLOG(PL_ERROR, "NorpSession::OriginatorStartNorm() NormStreamOpen() failure!\n");
         return false;
@@ -1042,7 +994,7 @@ bool NorpSession::OnRemoteRequest(const NorpMsg& theMsg, const ProtoAddress& sen
 #else
         NormSetRxPortReuse(norm_session, true, NULL, senderAddr.GetHostString(), theMsg.GetSourcePort());
 #endif // if/else NEW_PORT
-        if (!NormStartReceiver(norm_session, NORM_BUFFER_SIZE))
+        if (!NormStartReceiver(norm_session, controller.GetNormBufferSize()))
         {
             PLOG(PL_ERROR, "NorpSession::OnRemoteRequest() error: NormStartReceiver() failure!\n");
             return false;
@@ -1175,7 +1127,7 @@ bool NorpSession::OnRemoteReplyAcknowledgment(const NorpMsg& theMsg)
         PLOG(PL_INFO, "norp node %u starting sender probing (and sender) ...\n", controller.GetNormNodeId());
         if (Norp::NORM_FIXED != controller.GetNormCC())
             NormSetCongestionControl(norm_session, true);
-        if (!NormStartSender(norm_session, GetSessionId(), NORM_BUFFER_SIZE, controller.GetNormSegmentSize(), 
+        if (!NormStartSender(norm_session, GetSessionId(), controller.GetNormBufferSize(), controller.GetNormSegmentSize(), 
                              controller.GetNormBlockSize(), controller.GetNormParityCount()))
         {
             PLOG(PL_ERROR, "NorpSession::OnRemoteReplyAcknowledgment() NormStartSender() failure!\n");
@@ -1184,12 +1136,12 @@ bool NorpSession::OnRemoteReplyAcknowledgment(const NorpMsg& theMsg)
         //NormSetTxSocketBuffer(norm_session, 4096);
         NormSetFlowControl(norm_session, 0.0);  // disable timer-based flow control since we are ACK-limiting writes to stream
         norm_segment_size = controller.GetNormSegmentSize();
-        norm_stream_buffer_max = ComputeNormStreamBufferSegmentCount(NORM_BUFFER_SIZE, norm_segment_size, controller.GetNormBlockSize());
+        norm_stream_buffer_max = ComputeNormStreamBufferSegmentCount(controller.GetNormBufferSize(), norm_segment_size, controller.GetNormBlockSize());
         norm_stream_buffer_max -= controller.GetNormBlockSize();  // a little safety margin
         norm_stream_buffer_count = 0;
         norm_stream_bytes_remain = 0;
         norm_watermark_pending = false;
-        if (NORM_OBJECT_INVALID == (norm_tx_stream = NormStreamOpen(norm_session, NORM_BUFFER_SIZE)))
+        if (NORM_OBJECT_INVALID == (norm_tx_stream = NormStreamOpen(norm_session, controller.GetNormBufferSize())))
         {
             PLOG(PL_ERROR, "NorpSession::OnRemoteReplyAcknowledgment() NormStreamOpen() failure!\n");
             return false;
@@ -1369,6 +1321,12 @@ bool NorpSession::GetClientData()
         }
         // else wait for NORM_RX_OBJECT_UPDATED notification
     }
+    else if (IsRemoteSession() && controller.GetNormSplice())
+    {
+        // Originator server so receive SOCKS client data straight into our NORM stream
+        ASSERT(0 == client_pending);
+        return SpliceToNormStream(socks_client_socket);
+    }
     else
     {
         // Originator server so get data from SOCKS client via TCP
@@ -1678,6 +1636,12 @@ bool NorpSession::GetRemoteData()
         }
         // else wait for NORM_RX_OBJECT_UPDATED notification
     }
+    else if (IsRemoteSession() && controller.GetNormSplice())
+    {
+        // Remote correspondent so receive remote TCP data straight into our NORM stream
+        ASSERT(0 == remote_pending);
+        return SpliceToNormStream(socks_remote_socket);
+    }
     else
     {
         // Remote correspondent or direct-connect, so use TCP
@@ -1953,6 +1917,61 @@ unsigned int NorpSession::WriteToNormStream(const char*         buffer,
     }
 }  // end NorpSession::WriteToNormStream()
 
+bool NorpSession::SpliceToNormStream(ProtoSocket& srcSocket)
+{
+    // This observes the same ACK-based flow control as WriteToNormStream(), but
+    // has "srcSocket" recv() each segment's worth of data in place
+    unsigned int totalBytes = 0;
+    while (norm_stream_buffer_count < norm_stream_buffer_max)
+    {
+        unsigned int bytesAvailable = norm_segment_size * (norm_stream_buffer_max - norm_stream_buffer_count);
+        bytesAvailable -= norm_stream_bytes_remain;  // unflushed segment portion
+        unsigned int numBytes = bytesAvailable;
+        char* buffer = NormStreamReserve(norm_tx_stream, &numBytes);
+        if (NULL == buffer) break;  // stream buffer is full
+        if (!srcSocket.Recv(buffer, numBytes))
+        {
+            PLOG(PL_ERROR, "NorpSession::SpliceToNormStream() error: socket recv failure!\n");
+            return false;
+        }
+        if (0 == numBytes)
+        {
+            // Nothing more ready for now (or socket is closing and will say so itself)
+            if (0 != totalBytes) FlushNormStream(false, NORM_FLUSH_ACTIVE);
+            return true;
+        }
+        NormStreamCommit(norm_tx_stream, numBytes);
+        totalBytes += numBytes;
+        unsigned int pendingBytes = numBytes + norm_stream_bytes_remain;
+        norm_stream_buffer_count += pendingBytes / norm_segment_size;
+        norm_stream_bytes_remain = pendingBytes % norm_segment_size;
+        if (!norm_watermark_pending && (norm_stream_buffer_count >= (norm_stream_buffer_max >> 1)))
+        {
+            NormSetWatermark(norm_session, norm_tx_stream);
+            norm_watermark_pending = true;
+        }
+    }
+    // Stop reading from "srcSocket" until a watermark acknowledgment or
+    // NORM_TX_QUEUE_VACANCY says there is room again (see ResumeNormSplice())
+    PLOG(PL_DETAIL, "NorpSession::SpliceToNormStream() is blocked pending acknowledgment from receiver\n");
+    srcSocket.StopInputNotification();
+    norm_splice_blocked = true;
+    if (0 != totalBytes) FlushNormStream(false, NORM_FLUSH_ACTIVE);
+    return true;
+}  // end NorpSession::SpliceToNormStream()
+
+void NorpSession::ResumeNormSplice()
+{
+    if (!norm_splice_blocked) return;
+    norm_splice_blocked = false;
+    if (SOCKS_CONNECTED != socks_state) return;
+    // The originator relays its SOCKS client's data and the correspondent its remote's
+    if (IsRemoteOriginator())
+        socks_client_socket.StartInputNotification();
+    else
+        socks_remote_socket.StartInputNotification();
+}  // end NorpSession::ResumeNormSplice()
+
 void NorpSession::FlushNormStream(bool eom, NormFlushMode flushMode)
 {
     // NormStreamFlush always will transmit pending runt segments, if applicable
@@ -2027,6 +2046,7 @@ void NorpSession::OnNormEvent(NormEvent& theEvent)
             PLOG(PL_DETAIL, "NORM_TX_QUEUE_VACANCY)\n");
 		case NORM_TX_QUEUE_EMPTY:
             if (NORM_TX_QUEUE_EMPTY == theEvent.type) PLOG(PL_DETAIL, "NORM_TX_QUEUE_EMPTY)\n");
+            ResumeNormSplice();
             if (IsRemoteOriginator())
             {
                 // If there's pending data from the SOCKS client, try to send it
@@ -2063,6 +2083,7 @@ void NorpSession::OnNormEvent(NormEvent& theEvent)
                 norm_watermark_pending = false;
                 norm_stream_buffer_count -= (norm_stream_buffer_max >> 1);
                 //TRACE("   (count reduced to %lu)\n", norm_stream_buffer_count);
+                ResumeNormSplice();
                 // Use as prompt to send pending data to NORM stream
                 if (IsRemoteOriginator())
                 {
@@ -2371,7 +2392,9 @@ Norp::Norp(ProtoDispatcher& theDispatcher)
    norp_remote_port(DEFAULT_NORP_PORT), norp_rtt_init(NorpSession::NORP_RTT_DEFAULT),
    norm_enable(true), norm_instance(NORM_INSTANCE_INVALID), norm_node_id(NORM_NODE_ANY), 
    norm_port(DEFAULT_NORM_PORT), norm_cc_mode(NORM_CC), norm_tx_rate(DEFAULT_TX_RATE), norm_tx_limit(-1.0),
-   norm_segment_size(1400), norm_block_size(64), norm_parity_count(0), norm_parity_auto(0), norm_trace(false)
+   norm_segment_size(1400), norm_block_size(64), norm_parity_count(0), norm_parity_auto(0), 
+   norm_buffer_size(DEFAULT_NORM_BUFFER_SIZE), norm_splice(false), norm_pool_count(0), norm_pool_size(0), 
+   norm_trace(false)
 //   ,port_pool(9000)
 {
     socks_server_socket.SetNotifier(&GetSocketNotifier());
@@ -2451,6 +2474,7 @@ void Norp::StopServer()
     socks_server_socket.Close();
     session_list.Destroy();
     preset_list.Destroy();
+    FlushSessionPool();
     if (NORM_INSTANCE_INVALID != norm_instance)
     {
         dispatcher.RemoveGenericInput(NormGetDescriptor(norm_instance));
@@ -2459,6 +2483,128 @@ void Norp::StopServer()
     }
 }  // end Norp::StopServer()
 
+NormSessionHandle Norp::CreateOriginatorSession(const ProtoAddress& remoteAddr, UINT16 instanceId)
+{
+    // (TBD) Create single-socket NORM session using an ephemeral port and connect() to the remote
+    //       NORP server NORM port. (Use NormChangeDestination() after NormStartReceiver() to 
+    //       configure this newly-create NormSession as needed)
+#ifdef NEW_PORT
+    // We use port zero to get session that will bound to an ephemeral port (single port for tx and rx) upon NormStartReceiver
+    NormSessionHandle session = NormCreateSession(norm_instance, remoteAddr.GetHostString(), 0, norm_node_id);
+#else 
+    NormSessionHandle session = NormCreateSession(norm_instance, remoteAddr.GetHostString(), norm_port, norm_node_id);
+#endif
+    if (NORM_SESSION_INVALID == session)
+    {
+        PLOG(PL_ERROR, "Norp::CreateOriginatorSession() NormCreateSession() failure!\n");
+        return NORM_SESSION_INVALID;
+    }
+    NormSetMessageTrace(session, norm_trace);
+    NormSetDefaultSyncPolicy(session, NORM_SYNC_STREAM);
+    
+    // We use a 2-step sender/receiver startup  process by first opening an idle, "tx-only" NormSession to
+    // send the Request command to the remote "controller" NormSession (The remote will get our "tx port" 
+    // info as part of this request sent). Our controller will get the REQ_ACK and/or SOCKS_REPLY message, 
+    // then inform us, and so we will get the remote "tx port" info so we can then start our own receiver  
+    // and "connect" our NORM rx_socket to the remote tx_socket.  The sender here is made "idle" by disabling
+    // disabling the normal NORM GRTT probing.  We don't re-activate that until we know the remote end has 
+    // a receiver running (This is done upon REQ_ACK or SOCKS_REPLY reception when we also start our own NORM 
+    // receiver).  An idle session like this can thus be made ahead of time and pooled.
+    
+    char ifaceName[64];
+    ifaceName[63] = '\0';
+    if (ProtoNet::GetInterfaceName(proxy_addr, ifaceName, 63))
+        NormSetMulticastInterface(session, ifaceName);
+    else
+        PLOG(PL_ERROR, "Norp::CreateOriginatorSession() warning: unable to get interface name for address %s\n", proxy_addr.GetHostString());
+    switch (norm_cc_mode)
+    {
+        case NORM_CC:  // default TCP-friendly congestion control
+            // do nothing, this is NORM's default mode
+            break;
+        case NORM_CCE: // "wireless-ready" ECN-only congestion control
+            NormSetEcnSupport(session, true, true);
+            break;
+        case NORM_CCL: // "loss tolerant", non-ECN congestion control
+            NormSetEcnSupport(session, false, false, true);
+            break;
+        case NORM_FIXED:  // fixed-rate operation (NorpSession may lower it per its rate bounds)
+            NormSetTxRate(session, norm_tx_rate);
+            break;
+    }
+    
+    // Even though we call "NormStartSender()" to get a "tx port" value, we disable GRTT probing and thus
+    // defer "real" sender startup until we get an ACK to our request (see "OriginatorStartNorm()")
+    NormSetTxOnly(session, true);
+    NormSetGrttProbingMode(session, NORM_PROBE_NONE);  // no probing until remote receiver is started
+    if (!NormStartSender(session, instanceId, norm_buffer_size, norm_segment_size, 
+                         norm_block_size, norm_parity_count))
+    {
+        PLOG(PL_ERROR, "Norp::CreateOriginatorSession() error: NormStartSender() failure!\n");
+        NormDestroySession(session);
+        return NORM_SESSION_INVALID;
+    }
+#ifdef NEW_PORT
+    // Now call NormChangeDestination() to set proper destination port and "connect" to it
+    NormChangeDestination(session, remoteAddr.GetHostString(), norm_port, true);
+#endif // NEW_PORT
+    //NormSetTxSocketBuffer(session, 4096);
+    NormSetFlowControl(session, 0.0);  // disable timer-based flow control since we are ACK-limiting writes to stream
+    return session;
+}  // end Norp::CreateOriginatorSession()
+
+NormSessionHandle Norp::GrabPooledSession(const ProtoAddress& remoteAddr)
+{
+    for (unsigned int i = 0; i < norm_pool_count; i++)
+    {
+        if (norm_pool[i].remote_addr.HostIsEqual(remoteAddr))
+        {
+            NormSessionHandle session = norm_pool[i].session;
+            norm_pool_count--;
+            if (i != norm_pool_count) norm_pool[i] = norm_pool[norm_pool_count];
+            PLOG(PL_DETAIL, "Norp::GrabPooledSession() using pooled session for %s\n", remoteAddr.GetHostString());
+            return session;
+        }
+    }
+    return NORM_SESSION_INVALID;
+}  // end Norp::GrabPooledSession()
+
+void Norp::FillSessionPool(const ProtoAddress& remoteAddr)
+{
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < norm_pool_count; i++)
+    {
+        if (norm_pool[i].remote_addr.HostIsEqual(remoteAddr)) count++;
+    }
+    while ((count < norm_pool_size) && (norm_pool_count < NORM_POOL_MAX))
+    {
+        NormSessionHandle session = CreateOriginatorSession(remoteAddr, next_session_id++);
+        if (NORM_SESSION_INVALID == session) break;  // (error was logged)
+        norm_pool[norm_pool_count].session = session;
+        norm_pool[norm_pool_count].remote_addr = remoteAddr;
+        norm_pool_count++;
+        count++;
+    }
+}  // end Norp::FillSessionPool()
+
+void Norp::FlushSessionPool(const ProtoAddress* remoteAddr)
+{
+    unsigned int i = 0;
+    while (i < norm_pool_count)
+    {
+        if ((NULL == remoteAddr) || norm_pool[i].remote_addr.HostIsEqual(*remoteAddr))
+        {
+            NormDestroySession(norm_pool[i].session);
+            norm_pool_count--;
+            if (i != norm_pool_count) norm_pool[i] = norm_pool[norm_pool_count];
+        }
+        else
+        {
+            i++;
+        }
+    }
+}  // end Norp::FlushSessionPool()
+
 void Norp::OnSessionClose(NorpSession& theSession)
 {
     RemoveSession(theSession);
@@ -49,6 +49,7 @@ void NorpApp::Usage()
     fprintf(stderr, "Usage: norp [interface <ifaceName>][address <publicAddr>][sport <socksPort>][port <norpPort>]\n"
                     "            [norm {on|off}][id <normId>][nport <normPort>][cce | ccl | rate <bits/sec>]\n"
                     "            [limit <bits/sec>][persist <seconds>][segment <segmentSize>]\n"
+                    "            [buffer <bytes>][splice][pool <count>]\n"
                     "            [correspondent <remoteNorpAddr>][forward <tcpPort>,<destAddr>/<destPort>[,<remoteNorpAddr>]]\n"
                     "            [version][debug <level>][trace][dlog <debugLog>][lport <localNorpPort>][rport <remoteNorpPort>]\n");
 }
@@ -68,6 +69,9 @@ const char* const NorpApp::CMD_LIST[] =
     "+limit",           // set  _cumulative_ NORP transmit rate limit
     "+segment",         // Set NORM packet segment size (impacts MTU of NORM packets, UDP packets w/ (40 + <segmentSize>) bytes of payload)
     "+persist",         // <seconds> how long to persist NORM data delivery to receiver after TCP socket closure
+    "+buffer",          // <bytes> of NORM buffering per proxied connection (8 MB by default)
+    "-splice",          // receive TCP data directly into NORM stream buffers (no intermediate copy)
+    "+pool",            // <count> of idle NORM sessions to keep ready per remote NORP peer
     "+debug",           // set debug level
     "-trace",           // enables NORM protocol packet send/recv trace in debug output
     "+dlog",            // specify a file for debug logging
@@ -289,6 +293,30 @@ bool NorpApp::OnCommand(const char* cmd, const char* val)
         }
         norp.SetNormSegmentSize(segmentSize);
     }
+    else if (!strncmp("buffer", cmd, len))
+    {
+        unsigned int bufferSize;
+        if ((1 != sscanf(val, "%u", &bufferSize)) || (0 == bufferSize))
+        {
+            PLOG(PL_ERROR, "NorpApp::OnCommand(buffer) error: invalid buffer size \"%s\"\n", val);
+            return false;
+        }
+        norp.SetNormBufferSize(bufferSize);
+    }
+    else if (!strncmp("splice", cmd, len))
+    {
+        norp.SetNormSplice(true);
+    }
+    else if (!strncmp("pool", cmd, len))
+    {
+        unsigned int poolCount;
+        if (1 != sscanf(val, "%u", &poolCount))
+        {
+            PLOG(PL_ERROR, "NorpApp::OnCommand(pool) error: invalid pool count \"%s\"\n", val);
+            return false;
+        }
+        norp.SetNormSessionPool(poolCount);
+    }
     else if (!strncmp("lport", cmd, len))
     {
         norp.SetLocalNorpPort(atoi(val));
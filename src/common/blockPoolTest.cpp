@@ -0,0 +1,79 @@
+// This code tests the NormBlockPool single allocation (and "slab") block
+// layout, in particular for odd block sizes where (with 4-byte pointers)
+// the segment table isn't a whole number of UINT64 words.  Build it with
+// "-fsanitize=address" (and "-m32" where available) to catch overruns.
+
+#include "normSegment.h"
+
+#include <stdio.h>
+
+const unsigned int NUM_BLOCKS = 4;
+
+static bool TestPool(UINT16 segsPerBlock, bool slabMode)
+{
+    NormBlockPool pool;
+    pool.SetSlabMode(slabMode);
+    if (!pool.Init(NUM_BLOCKS, segsPerBlock))
+    {
+        fprintf(stderr, "bpt: pool init error (size:%hu slab:%d)\n", segsPerBlock, slabMode);
+        return false;
+    }
+    size_t blockSpace = NormBlockPool::GetBlockSpace(segsPerBlock);
+    if (0 != (blockSpace % sizeof(UINT64)))
+    {
+        fprintf(stderr, "bpt: block space %lu not UINT64 aligned (size:%hu)\n",
+                        (unsigned long)blockSpace, segsPerBlock);
+        return false;
+    }
+    NormBlock* blockList[NUM_BLOCKS];
+    unsigned int count = 0;
+    NormBlock* b;
+    while ((count < NUM_BLOCKS) && (NULL != (b = pool.Get())))
+    {
+        // The segment table must end within the block's own space
+        char* tableEnd = (char*)(b->SegmentList() + segsPerBlock);
+        if (tableEnd > ((char*)b + blockSpace))
+        {
+            fprintf(stderr, "bpt: segment table overruns block (size:%hu slab:%d)\n", segsPerBlock, slabMode);
+            return false;
+        }
+        // Fill the whole segment table and masks
+        for (UINT16 i = 0; i < segsPerBlock; i++)
+            b->AttachSegment(i, (char*)b + i);
+        b->SetPending(0, segsPerBlock);
+        NormBlockId blockId(count);
+        b->SetId(blockId);
+        blockList[count++] = b;
+    }
+    bool result = (NUM_BLOCKS == count);
+    // Make sure no block's content was overwritten by its neighbor
+    for (unsigned int n = 0; n < count; n++)
+    {
+        b = blockList[n];
+        if (b->GetId() != NormBlockId(n)) result = false;
+        for (UINT16 i = 0; i < segsPerBlock; i++)
+        {
+            if ((b->GetSegment(i) != ((char*)b + i)) || !b->IsPending(i))
+                result = false;
+            b->DetachSegment(i);
+        }
+        pool.Put(b);
+    }
+    if (!result)
+        fprintf(stderr, "bpt: block content corrupted (size:%hu slab:%d)\n", segsPerBlock, slabMode);
+    pool.Destroy();
+    return result;
+}  // end TestPool()
+
+int main(int argc, char* argv[])
+{
+    bool result = true;
+    const UINT16 sizes[] = {1, 3, 5, 7, 63, 65, 127, 129, 255, 257, 1023, 1025};
+    for (unsigned int i = 0; i < sizeof(sizes)/sizeof(UINT16); i++)
+    {
+        if (!TestPool(sizes[i], false)) result = false;
+        if (!TestPool(sizes[i], true)) result = false;
+    }
+    fprintf(stderr, "bpt: %s\n", result ? "PASSED" : "FAILED");
+    return result ? 0 : 1;
+}  // end main()
@@ -5,6 +5,7 @@
 
 #include "normEncoderRS8.h"
 #include "normEncoderRS16.h"
+#include "normGFKernel.h"
 
 #include <string.h> // for memcpy(), etc
 #include <stdlib.h> // for rand()
@@ -29,6 +30,18 @@ int main(int argc, char* argv[])
     fprintf(stderr, "fect: seed = %u\n", seed);
     srand(seed);
     
+    // Use "fecTest portable" to compare against the non-SIMD code path
+    // and "fecTest block" to encode with EncodeBlock() instead of Encode()
+    bool blockEncode = false;
+    for (int i = 1; i < argc; i++)
+    {
+        if (0 == strcmp(argv[i], "portable"))
+            NormGFKernel::SetType(NormGFKernel::PORTABLE);
+        else if (0 == strcmp(argv[i], "block"))
+            blockEncode = true;
+    }
+    fprintf(stderr, "fect: GF kernel = %s\n", NormGFKernel::GetTypeName());
+    
     NORM_ENCODER encoder;
     encoder.Init(NUM_DATA, NUM_PARITY, SEG_SIZE);
     NORM_DECODER decoder;
@@ -57,9 +70,14 @@ int main(int argc, char* argv[])
         // 3) Run our encoder (and record CPU time)
         ProtoTime startTime, stopTime;
         startTime.GetCurrentTime();
-        for (unsigned int i = 0; i < SHORT_DATA; i++)
+        if (blockEncode)
+        {
+            encoder.EncodeBlock((const char**)txDataPtr, SHORT_DATA, txDataPtr + SHORT_DATA);
+        }
+        else
         {
-            encoder.Encode(i, txDataPtr[i], txDataPtr + SHORT_DATA);
+            for (unsigned int i = 0; i < SHORT_DATA; i++)
+                encoder.Encode(i, txDataPtr[i], txDataPtr + SHORT_DATA);
         }
         stopTime.GetCurrentTime();
         double encodeTime = ProtoTime::Delta(stopTime, startTime);
@@ -5,6 +5,13 @@
 // This currently only fully function when there is a single sender and
 // a single object is in the NORM log file
 
+// With the "binary" option, the input is instead a NormWriteTraceRing()
+// file that is read directly
+
+// With the "summary" option, a columnar per-object summary is printed
+// instead (see normTraceSummary.h).  Named log files are memory mapped
+// and, with "threads <count>", their trace lines are parsed in parallel.
+
 #include <stdio.h>
 #include <string.h>
 #include <ctype.h>
@@ -14,8 +21,15 @@
 #include <unistd.h>      
 #include <sys/time.h>  // for gettimeofday()
 #include <errno.h>
+#include <sys/mman.h>  // for mmap()
+#include <sys/stat.h>  // for fstat()
+#include <pthread.h>
+#define N2M_MMAP
 #endif // !WIN32
 
+#include "normTraceRing.h"
+#include "normTraceSummary.h"
+
 class FastReader
 {
     public:
@@ -40,9 +54,368 @@ class FastReader
 
 void Usage()
 {
-    fprintf(stderr, "Usage:  n2m [data <blkSize>][input <logFile>\n");
+    fprintf(stderr, "Usage:  n2m [data <blkSize>][input <logFile>][binary][summary][threads <count>]\n");
+    fprintf(stderr, "        (a \"summary\" of a text log identifies senders by IPv4 address, or 0\n"
+                    "         for the logging node, and has no repair figures since text trace\n"
+                    "         lines don't mark repairs)\n");
 }
 
+// Unwraps a 16-bit trace "seq" for the send or recv direction
+static unsigned int UnwrapSeq(unsigned int seq, bool& first, 
+                              unsigned int& lastSeq, unsigned int& seqOffset)
+{
+    if (first)
+    {
+        first = false;
+        seqOffset = 0;
+    }
+    else
+    {
+        int delta = seq - lastSeq;
+        if ((delta < -100) || (delta > 32000))
+            seqOffset += 65536;
+    }
+    lastSeq = seq;
+    return (seq + seqOffset);
+}  // end UnwrapSeq()
+
+static void PrintEvent(bool recvEvent, unsigned int hr, unsigned int min, double sec,
+                       unsigned int seq, const char* addr, unsigned int length)
+{
+    if (recvEvent)
+        printf("%u:%u:%lf RECV flow>0 seq>%u src>%s/0 dst>127.0.0.1/0 sent>%u:%u:%lf size>%u\n", 
+               hr, min, sec, seq, addr, hr, min, sec, length);
+    else
+         printf("%u:%u:%lf SEND flow>0 seq>%u dst>%s/0 size>%u\n", 
+                hr, min, sec, seq, addr, length);
+    fflush(stdout);
+}  // end PrintEvent()
+
+// Converts the records of a NormWriteTraceRing() file (or adds them to "summary")
+static int ReadTraceRing(FILE* infile, bool dataSeq, int blkSize, NormTraceSummary* summary)
+{
+    UINT32 localId, recordCount;
+    if (!NormTraceRing::ReadHeader(infile, localId, recordCount))
+    {
+        fprintf(stderr, "n2m: invalid binary trace file header\n");
+        return -1;
+    }
+    if (NULL != summary)
+    {
+        NormTraceRing::Record record;
+        while (NormTraceRing::ReadRecord(infile, record))
+            summary->Add(record, NormTraceSummary::GetSenderId(record, localId));
+        return 0;
+    }
+    bool firstRecvEvent = true;
+    bool firstSendEvent = true;
+    unsigned int lastSendSeq = 0;
+    unsigned int lastRecvSeq = 0;
+    unsigned int sendSeqOffset = 0;
+    unsigned int recvSeqOffset = 0;
+    NormTraceRing::Record record;
+    while (NormTraceRing::ReadRecord(infile, record))
+    {
+        bool recvEvent = (0 == (record.flags & NormTraceRing::FLAG_SENT));
+        unsigned int seq = recvEvent ? 
+                UnwrapSeq(record.seq, firstRecvEvent, lastRecvSeq, recvSeqOffset) :
+                UnwrapSeq(record.seq, firstSendEvent, lastSendSeq, sendSeqOffset);
+        if (dataSeq)
+        {
+            // Only use DATA packets (type 2)! (this is only good for a single object!)
+            if (2 != record.type) continue;
+            seq = record.blockId * blkSize + record.segmentId;
+        }
+        unsigned int hr = (record.sec / 3600) % 24;
+        unsigned int min = (record.sec / 60) % 60;
+        double sec = (double)(record.sec % 60) + 1.0e-06 * (double)record.usec;
+        char addr[64];
+        const unsigned char* a = (const unsigned char*)&record.addr;
+        if (0 != (record.flags & NormTraceRing::FLAG_IPV6))
+            strcpy(addr, "::");
+        else
+            sprintf(addr, "%u.%u.%u.%u", a[0], a[1], a[2], a[3]);
+        PrintEvent(recvEvent, hr, min, sec, seq, addr, record.length);
+    }
+    return 0;
+}  // end ReadTraceRing()
+
+// Parses a "trace>" line to a record for the summary, with "senderKey" the
+// sender's IPv4 address (or a hash of other address forms), or zero when
+// the logging node is the sender
+static bool ParseTraceLine(const char* buffer, NormTraceRing::Record& record, UINT32& senderKey)
+{
+    if (0 != strncmp(buffer, "trace>", 6)) return false;
+    unsigned int hr, min;
+    double sec;
+    const char* ptr = buffer + 6;
+    if (3 != sscanf(ptr, "%u:%u:%lf", &hr, &min, &sec)) return false;
+    memset(&record, 0, sizeof(record));
+    record.sec = hr*3600 + min*60 + (UINT32)sec;
+    record.usec = (UINT32)(1.0e+06 * (sec - (double)((UINT32)sec)) + 0.5);
+    if (record.usec > 999999) record.usec = 999999;
+    const char* ptr2 = strstr(ptr, "src>");
+    if (NULL == ptr2)
+    {
+        if (NULL == (ptr2 = strstr(ptr, "dst>"))) return false;
+        record.flags |= NormTraceRing::FLAG_SENT;
+    }
+    ptr = ptr2 + 4;
+    unsigned int a[4];
+    unsigned int port = 0;
+    UINT32 addrKey = 0;
+    if (4 <= sscanf(ptr, "%u.%u.%u.%u/%u", a, a+1, a+2, a+3, &port))
+    {
+        UINT8* b = (UINT8*)&record.addr;
+        for (int i = 0; i < 4; i++) b[i] = (UINT8)a[i];
+        addrKey = (a[0] << 24) | ((a[1] & 0xff) << 16) | ((a[2] & 0xff) << 8) | (a[3] & 0xff);
+    }
+    else
+    {
+        // (FNV-1a hash of the address string)
+        record.flags |= NormTraceRing::FLAG_IPV6;
+        addrKey = 2166136261u;
+        for (ptr2 = ptr; ('\0' != *ptr2) && ('/' != *ptr2) && (' ' != *ptr2); ptr2++)
+            addrKey = (addrKey ^ (UINT8)*ptr2) * 16777619u;
+        const char* slash = strchr(ptr, '/');
+        if (NULL != slash) sscanf(slash + 1, "%u", &port);
+    }
+    record.port = (UINT16)port;
+    unsigned int value;
+    if ((NULL != (ptr2 = strstr(ptr, "seq>"))) && (1 == sscanf(ptr2 + 4, "%u", &value)))
+        record.seq = (UINT16)value;
+    unsigned int obj = 0, blk = 0, seg = 0;
+    if ((NULL != (ptr2 = strstr(ptr, " DATA "))) || (NULL != (ptr2 = strstr(ptr, " PRTY "))))
+    {
+        record.type = 2;  // NormMsg::DATA
+        if (3 != sscanf(ptr2 + 6, "obj>%u blk>%u seg>%u", &obj, &blk, &seg)) return false;
+    }
+    else if (NULL != (ptr2 = strstr(ptr, " INFO ")))
+    {
+        record.type = 1;  // NormMsg::INFO
+        if (1 != sscanf(ptr2 + 6, "obj>%u", &obj)) return false;
+    }
+    else if (NULL != strstr(ptr, " CMD("))
+    {
+        record.type = 3;  // NormMsg::CMD
+    }
+    else if (NULL != strstr(ptr, " NACK"))
+    {
+        record.type = 4;  // NormMsg::NACK
+    }
+    else if (NULL != strstr(ptr, " ACK"))
+    {
+        record.type = 5;  // NormMsg::ACK
+    }
+    else
+    {
+        return false;
+    }
+    record.objectId = (UINT16)obj;
+    record.blockId = blk;
+    record.segmentId = (UINT16)seg;
+    if ((NULL != (ptr2 = strstr(ptr, "len>"))) && (1 == sscanf(ptr2 + 4, "%u", &value)))
+        record.length = (UINT16)value;
+    // The remote address is the sender's for received sender messages and sent NACK/ACK
+    bool sent = (0 != (record.flags & NormTraceRing::FLAG_SENT));
+    bool senderMsg = (record.type <= 3);
+    senderKey = (senderMsg != sent) ? addrKey : 0;
+    record.sourceId = senderKey;
+    return true;
+}  // end ParseTraceLine()
+
+#ifdef N2M_MMAP
+// MapReader reads the lines of a memory mapped file (in place of the
+// FastReader's character at a time copies)
+class MapReader
+{
+    public:
+        MapReader() : base(NULL), size(0), offset(0) {}
+        ~MapReader() {Close();}
+        
+        bool Open(FILE* filePtr)
+        {
+            struct stat info;
+            int fd = fileno(filePtr);
+            if ((0 != fstat(fd, &info)) || (0 == info.st_size)) return false;
+            void* ptr = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (MAP_FAILED == ptr) return false;
+            base = (const char*)ptr;
+            size = (size_t)info.st_size;
+            offset = 0;
+            madvise(ptr, size, MADV_SEQUENTIAL);
+            return true;
+        }
+        void Close()
+        {
+            if (NULL != base) munmap((void*)base, size);
+            base = NULL;
+            size = offset = 0;
+        }
+        const char* GetBase() const {return base;}
+        size_t GetSize() const {return size;}
+        
+        // As FastReader::Readline(), but over-long lines are truncated
+        FastReader::Result Readline(char* buffer, unsigned int* len)
+        {
+            if (offset >= size) return FastReader::DONE;
+            const char* ptr = base + offset;
+            const char* end = (const char*)memchr(ptr, '\n', size - offset);
+            size_t lineLength = (NULL != end) ? (size_t)(end - ptr) : (size - offset);
+            offset += lineLength + 1;
+            if ((lineLength > 0) && ('\r' == ptr[lineLength - 1])) lineLength--;
+            if (lineLength >= *len) lineLength = *len - 1;
+            memcpy(buffer, ptr, lineLength);
+            buffer[lineLength] = '\0';
+            *len = (unsigned int)lineLength;
+            return FastReader::OK;
+        }
+        
+    private:
+        const char* base;
+        size_t      size;
+        size_t      offset;
+};  // end class MapReader
+
+// For the "summary", a window of the mapped log at a time is split among the
+// threads at line boundaries for parsing (the costly part) and the resulting
+// records are then added to the summary in order (since its sequence gap and
+// NACK to repair figures depend on that order)
+class LineWorker
+{
+    public:
+        enum {WINDOW_SIZE = 64 << 20};  // bytes
+        
+        LineWorker() : record_list(NULL), sender_list(NULL), record_count(0), record_max(0) {}
+        ~LineWorker()
+        {
+            delete[] record_list;
+            delete[] sender_list;
+        }
+        
+        const char*             start;
+        const char*             end;
+        NormTraceRing::Record*  record_list;
+        UINT32*                 sender_list;
+        unsigned int            record_count;
+        unsigned int            record_max;
+        pthread_t               thread;
+        bool                    started;
+        
+        static void* DoWork(void* arg)
+        {
+            ((LineWorker*)arg)->Parse();
+            return NULL;
+        }
+        void Parse()
+        {
+            record_count = 0;
+            const char* ptr = start;
+            while (ptr < end)
+            {
+                const char* eol = (const char*)memchr(ptr, '\n', end - ptr);
+                if (NULL == eol) eol = end;
+                char buffer[1024];
+                size_t lineLength = eol - ptr;
+                if (lineLength > 1023) lineLength = 1023;
+                memcpy(buffer, ptr, lineLength);
+                buffer[lineLength] = '\0';
+                ptr = eol + 1;
+                NormTraceRing::Record record;
+                UINT32 senderKey;
+                if (!ParseTraceLine(buffer, record, senderKey)) continue;
+                if ((record_count == record_max) && !Grow()) return;
+                record_list[record_count] = record;
+                sender_list[record_count++] = senderKey;
+            }
+        }
+        
+    private:
+        bool Grow()
+        {
+            unsigned int newMax = (0 != record_max) ? (2 * record_max) : 4096;
+            NormTraceRing::Record* newRecords = new NormTraceRing::Record[newMax];
+            UINT32* newSenders = new UINT32[newMax];
+            if ((NULL == newRecords) || (NULL == newSenders))
+            {
+                fprintf(stderr, "n2m: memory allocation error\n");
+                delete[] newRecords;
+                delete[] newSenders;
+                return false;
+            }
+            if (0 != record_count)
+            {
+                memcpy(newRecords, record_list, record_count * sizeof(NormTraceRing::Record));
+                memcpy(newSenders, sender_list, record_count * sizeof(UINT32));
+            }
+            delete[] record_list;
+            delete[] sender_list;
+            record_list = newRecords;
+            sender_list = newSenders;
+            record_max = newMax;
+            return true;
+        }
+};  // end class LineWorker
+
+static void SummarizeMap(const MapReader& map, unsigned int numThreads, NormTraceSummary& summary)
+{
+    LineWorker* workerList = new LineWorker[numThreads];
+    if (NULL == workerList)
+    {
+        fprintf(stderr, "n2m: memory allocation error\n");
+        return;
+    }
+    const char* base = map.GetBase();
+    const char* fileEnd = base + map.GetSize();
+    const char* windowStart = base;
+    while (windowStart < fileEnd)
+    {
+        // The window and its thread chunks each end after a newline
+        const char* windowEnd = windowStart + MIN((size_t)LineWorker::WINDOW_SIZE, (size_t)(fileEnd - windowStart));
+        const char* eol;
+        if ((windowEnd < fileEnd) && (NULL != (eol = (const char*)memchr(windowEnd, '\n', fileEnd - windowEnd))))
+            windowEnd = eol + 1;
+        else if (windowEnd < fileEnd)
+            windowEnd = fileEnd;
+        size_t chunk = (windowEnd - windowStart) / numThreads + 1;
+        const char* ptr = windowStart;
+        for (unsigned int i = 0; i < numThreads; i++)
+        {
+            LineWorker& worker = workerList[i];
+            worker.start = ptr;
+            const char* chunkEnd = ptr + MIN(chunk, (size_t)(windowEnd - ptr));
+            if ((chunkEnd < windowEnd) && (NULL != (eol = (const char*)memchr(chunkEnd, '\n', windowEnd - chunkEnd))))
+                chunkEnd = eol + 1;
+            else
+                chunkEnd = windowEnd;
+            worker.end = ptr = chunkEnd;
+        }
+        // (the last chunk is parsed by this thread)
+        for (unsigned int i = 0; i + 1 < numThreads; i++)
+        {
+            LineWorker& worker = workerList[i];
+            worker.started = (0 == pthread_create(&worker.thread, NULL, LineWorker::DoWork, &worker));
+            if (!worker.started)
+            {
+                perror("n2m: pthread_create() error");
+                worker.Parse();
+            }
+        }
+        workerList[numThreads - 1].Parse();
+        for (unsigned int i = 0; i < numThreads; i++)
+        {
+            LineWorker& worker = workerList[i];
+            if ((i + 1 < numThreads) && worker.started)
+                pthread_join(worker.thread, NULL);
+            for (unsigned int j = 0; j < worker.record_count; j++)
+                summary.Add(worker.record_list[j], worker.sender_list[j]);
+        }
+        windowStart = windowEnd;
+    }
+    delete[] workerList;
+}  // end SummarizeMap()
+#endif // N2M_MMAP
+
 int main(int argc, char* argv[])
 {
     FastReader reader;
@@ -59,6 +432,9 @@ int main(int argc, char* argv[])
     FILE* infile = stdin;
     
     bool dataSeq = false;
+    bool binary = false;
+    bool summaryMode = false;
+    unsigned int numThreads = 1;
     int blkSize = 0;
     for (int i = 1; i < argc; i++)
     {
@@ -91,14 +467,59 @@ int main(int argc, char* argv[])
                 return -1;
             }            
         }
+        else if (!strcmp("binary", argv[i]))
+        {
+            binary = true;
+        }
+        else if (!strcmp("summary", argv[i]))
+        {
+            summaryMode = true;
+        }
+        else if (!strcmp("threads", argv[i]))
+        {
+            i++;
+            if ((i >= argc) || (1 != sscanf(argv[i], "%u", &numThreads)) || (0 == numThreads))
+            {
+                fprintf(stderr, "n2m error: invalid thread count\n");
+                Usage();
+                return -1;
+            }
+        }
         
     }
     
+    NormTraceSummary summary;
+    if (binary)
+    {
+        status = ReadTraceRing(infile, dataSeq, blkSize, summaryMode ? &summary : NULL);
+        if (summaryMode) summary.Print(stdout);
+        if (infile != stdin) fclose(infile);
+        return status;
+    }
+    
+#ifdef N2M_MMAP
+    MapReader mapReader;
+    bool mapped = (infile != stdin) && mapReader.Open(infile);
+    if (mapped && summaryMode)
+    {
+        SummarizeMap(mapReader, numThreads, summary);
+        summary.Print(stdout);
+        mapReader.Close();
+        fclose(infile);
+        return 0;
+    }
+#endif // N2M_MMAP
+    
     while (1)
     {
         unsigned int numBytes = 1024;
         char buffer[1024];
+#ifdef N2M_MMAP
+        FastReader::Result result = mapped ? mapReader.Readline(buffer, &numBytes) :
+                                             reader.Readline(infile, buffer, &numBytes);
+#else
         FastReader::Result result = reader.Readline(infile, buffer, &numBytes);
+#endif // if/else N2M_MMAP
         if (FastReader::DONE == result)
         {
             break;
@@ -110,6 +531,14 @@ int main(int argc, char* argv[])
             break;
         }
         line++;
+        if (summaryMode)
+        {
+            NormTraceRing::Record record;
+            UINT32 senderKey;
+            if (ParseTraceLine(buffer, record, senderKey))
+                summary.Add(record, senderKey);
+            continue;
+        }
         // Make sure it is a "trace" line
         if (0 == numBytes) 
             continue;
@@ -170,37 +599,9 @@ int main(int argc, char* argv[])
         
         
         if (recvEvent)
-        {
-            if (firstRecvEvent)
-            {
-                firstRecvEvent = false;
-                recvSeqOffset = 0;
-            }
-            else
-            {
-                int delta = seq - lastRecvSeq;
-                if ((delta < -100) || (delta > 32000))
-                    recvSeqOffset += 65536;
-            }
-            lastRecvSeq = seq;
-            seq += recvSeqOffset;
-        }
+            seq = UnwrapSeq(seq, firstRecvEvent, lastRecvSeq, recvSeqOffset);
         else
-        {
-            if (firstSendEvent)
-            {
-                firstSendEvent = false;
-                sendSeqOffset = 0;
-            }
-            else
-            {
-                int delta = seq - lastSendSeq;
-                if ((delta < -100) || (delta > 32000))
-                    sendSeqOffset += 65536;
-            }
-            lastSendSeq = seq;
-            seq += sendSeqOffset;
-        }
+            seq = UnwrapSeq(seq, firstSendEvent, lastSendSeq, sendSeqOffset);
         
         
         if (dataSeq)
@@ -242,15 +643,13 @@ int main(int argc, char* argv[])
         // Finally, output an MGEN log line
         
         
-        if (recvEvent)
-            printf("%u:%u:%lf RECV flow>0 seq>%u src>%s/0 dst>127.0.0.1/0 sent>%u:%u:%lf size>%u\n", 
-                   hr, min, sec, seq, addr, hr, min, sec, length);
-        else
-             printf("%u:%u:%lf SEND flow>0 seq>%u dst>%s/0 size>%u\n", 
-                    hr, min, sec, seq, addr, length);
-        fflush(stdout);
+        PrintEvent(recvEvent, hr, min, sec, seq, addr, length);
     }
+    if (summaryMode) summary.Print(stdout);
     
+#ifdef N2M_MMAP
+    mapReader.Close();
+#endif // N2M_MMAP
     if (infile != stdin) fclose(infile);
     return status;
 }
@@ -0,0 +1,381 @@
+#include "normAead.h"
+
+#include <string.h>  // for memcpy(), memset()
+
+static inline UINT32 NormAeadLoad32(const UINT8* p)
+{
+    return ((UINT32)p[0] | ((UINT32)p[1] << 8) | ((UINT32)p[2] << 16) | ((UINT32)p[3] << 24));
+}
+
+static inline void NormAeadStore32(UINT8* p, UINT32 value)
+{
+    p[0] = (UINT8)value;
+    p[1] = (UINT8)(value >> 8);
+    p[2] = (UINT8)(value >> 16);
+    p[3] = (UINT8)(value >> 24);
+}
+
+#define NORM_CHACHA_ROTL(v, n) (((v) << (n)) | ((v) >> (32 - (n))))
+#define NORM_CHACHA_QR(a, b, c, d) \
+    a += b; d ^= a; d = NORM_CHACHA_ROTL(d, 16); \
+    c += d; b ^= c; b = NORM_CHACHA_ROTL(b, 12); \
+    a += b; d ^= a; d = NORM_CHACHA_ROTL(d, 8);  \
+    c += d; b ^= c; b = NORM_CHACHA_ROTL(b, 7);
+#define NORM_CHACHA_ROUNDS(s) \
+    for (int r = 0; r < 10; r++) \
+    { \
+        NORM_CHACHA_QR(s[0], s[4], s[8],  s[12]); \
+        NORM_CHACHA_QR(s[1], s[5], s[9],  s[13]); \
+        NORM_CHACHA_QR(s[2], s[6], s[10], s[14]); \
+        NORM_CHACHA_QR(s[3], s[7], s[11], s[15]); \
+        NORM_CHACHA_QR(s[0], s[5], s[10], s[15]); \
+        NORM_CHACHA_QR(s[1], s[6], s[11], s[12]); \
+        NORM_CHACHA_QR(s[2], s[7], s[8],  s[13]); \
+        NORM_CHACHA_QR(s[3], s[4], s[9],  s[14]); \
+    }
+
+// With GCC/Clang vector types, four blocks are computed at once, one per
+// lane (SSE2, AVX or NEON registers as the target has them)
+#if defined(__GNUC__)
+#define NORM_CHACHA_VEC 1
+typedef UINT32 NormChaChaVec __attribute__((vector_size(16)));
+#endif // __GNUC__
+
+NormAead::NormAead()
+ : key_set(false)
+{
+    memset(key_words, 0, sizeof(key_words));
+}
+
+NormAead::~NormAead()
+{
+    ClearKey();
+}
+
+void NormAead::SetKey(const UINT8* key)
+{
+    for (unsigned int i = 0; i < 8; i++)
+        key_words[i] = NormAeadLoad32(key + 4*i);
+    key_set = true;
+}  // end NormAead::SetKey()
+
+void NormAead::ClearKey()
+{
+    // (volatile so the compiler doesn't drop the wipe)
+    volatile UINT32* ptr = key_words;
+    for (unsigned int i = 0; i < 8; i++) ptr[i] = 0;
+    key_set = false;
+}  // end NormAead::ClearKey()
+
+void NormAead::ChaChaBlock(UINT32 counter, const UINT8* nonce, UINT8* out) const
+{
+    UINT32 x[16];
+    x[0] = 0x61707865;  // "expand 32-byte k"
+    x[1] = 0x3320646e;
+    x[2] = 0x79622d32;
+    x[3] = 0x6b206574;
+    memcpy(x + 4, key_words, sizeof(key_words));
+    x[12] = counter;
+    x[13] = NormAeadLoad32(nonce);
+    x[14] = NormAeadLoad32(nonce + 4);
+    x[15] = NormAeadLoad32(nonce + 8);
+    UINT32 s[16];
+    memcpy(s, x, sizeof(x));
+    NORM_CHACHA_ROUNDS(s);
+    for (int i = 0; i < 16; i++)
+        NormAeadStore32(out + 4*i, s[i] + x[i]);
+}  // end NormAead::ChaChaBlock()
+
+#ifdef NORM_CHACHA_VEC
+// XORs four consecutive blocks (256 bytes) of key stream starting at
+// "counter" into "text"
+static void NormChaChaXor4(const UINT32* key, UINT32 counter, const UINT8* nonce, UINT8* text)
+{
+    static const UINT32 SIGMA[4] = {0x61707865, 0x3320646e, 0x79622d32, 0x6b206574};
+    NormChaChaVec x[16];
+    for (int i = 0; i < 4; i++)
+    {
+        NormChaChaVec v = {SIGMA[i], SIGMA[i], SIGMA[i], SIGMA[i]};
+        x[i] = v;
+    }
+    for (int i = 0; i < 8; i++)
+    {
+        NormChaChaVec v = {key[i], key[i], key[i], key[i]};
+        x[4 + i] = v;
+    }
+    NormChaChaVec ctr = {counter, counter + 1, counter + 2, counter + 3};
+    x[12] = ctr;
+    for (int i = 0; i < 3; i++)
+    {
+        UINT32 n = NormAeadLoad32(nonce + 4*i);
+        NormChaChaVec v = {n, n, n, n};
+        x[13 + i] = v;
+    }
+    NormChaChaVec s[16];
+    memcpy(s, x, sizeof(x));
+    NORM_CHACHA_ROUNDS(s);
+    for (int i = 0; i < 16; i++)
+    {
+        s[i] += x[i];
+        for (int b = 0; b < 4; b++)
+        {
+            UINT8* ptr = text + 64*b + 4*i;
+            NormAeadStore32(ptr, NormAeadLoad32(ptr) ^ s[i][b]);
+        }
+    }
+}  // end NormChaChaXor4()
+#endif // NORM_CHACHA_VEC
+
+void NormAead::ChaChaXor(UINT32 counter, const UINT8* nonce, UINT8* text, unsigned int len) const
+{
+#ifdef NORM_CHACHA_VEC
+    while (len >= 256)
+    {
+        NormChaChaXor4(key_words, counter, nonce, text);
+        counter += 4;
+        text += 256;
+        len -= 256;
+    }
+#endif // NORM_CHACHA_VEC
+    UINT8 stream[64];
+    while (len > 0)
+    {
+        ChaChaBlock(counter++, nonce, stream);
+        unsigned int n = (len < 64) ? len : 64;
+        for (unsigned int i = 0; i < n; i++)
+            text[i] ^= stream[i];
+        text += n;
+        len -= n;
+    }
+}  // end NormAead::ChaChaXor()
+
+static inline UINT64 NormAeadLoad64(const UINT8* p)
+{
+    return ((UINT64)NormAeadLoad32(p) | ((UINT64)NormAeadLoad32(p + 4) << 32));
+}
+
+// Poly1305 over the RFC 8439 AEAD input: the aad and text, each zero padded
+// to 16 bytes, then their little-endian 64-bit lengths.  Since every block
+// is then a full one, the partial block case is not needed.  Where the
+// compiler has 128-bit integers, 44/44/42-bit limbs in 64-bit words (3
+// multiplies per term) are used instead of 26-bit ones (5 multiplies per term).
+class NormPoly1305
+{
+    public:
+        NormPoly1305(const UINT8* key);
+        void Update(const UINT8* data, unsigned int len)
+        {
+            while (len >= 16)
+            {
+                Block(data);
+                data += 16;
+                len -= 16;
+            }
+            if (0 != len)
+            {
+                UINT8 last[16];
+                memset(last, 0, 16);
+                memcpy(last, data, len);
+                Block(last);
+            }
+        }
+        void Finish(UINT8* tag);
+
+    private:
+        void Block(const UINT8* m);
+
+#ifdef __SIZEOF_INT128__
+        UINT64  r[3];
+        UINT64  h[3];
+        UINT64  pad[2];
+#else
+        UINT32  r[5];
+        UINT32  h[5];
+        UINT32  pad[4];
+#endif // if/else __SIZEOF_INT128__
+};  // end class NormPoly1305
+
+#ifdef __SIZEOF_INT128__
+__extension__ typedef unsigned __int128 NormUINT128;  // (not ISO C++, so -pedantic clean)
+
+NormPoly1305::NormPoly1305(const UINT8* key)
+{
+    UINT64 t0 = NormAeadLoad64(key);
+    UINT64 t1 = NormAeadLoad64(key + 8);
+    r[0] = t0 & 0xffc0fffffffULL;
+    r[1] = ((t0 >> 44) | (t1 << 20)) & 0xfffffc0ffffULL;
+    r[2] = (t1 >> 24) & 0x00ffffffc0fULL;
+    pad[0] = NormAeadLoad64(key + 16);
+    pad[1] = NormAeadLoad64(key + 24);
+    h[0] = h[1] = h[2] = 0;
+}
+
+void NormPoly1305::Block(const UINT8* m)
+{
+    const UINT64 M44 = 0xfffffffffffULL, M42 = 0x3ffffffffffULL;
+    const UINT64 s1 = r[1] * (5 << 2), s2 = r[2] * (5 << 2);
+    UINT64 t0 = NormAeadLoad64(m);
+    UINT64 t1 = NormAeadLoad64(m + 8);
+    UINT64 h0 = h[0] + (t0 & M44);
+    UINT64 h1 = h[1] + (((t0 >> 44) | (t1 << 20)) & M44);
+    UINT64 h2 = h[2] + ((t1 >> 24) & M42) + (1ULL << 40);
+    NormUINT128 d0 = (NormUINT128)h0*r[0] + (NormUINT128)h1*s2 + (NormUINT128)h2*s1;
+    NormUINT128 d1 = (NormUINT128)h0*r[1] + (NormUINT128)h1*r[0] + (NormUINT128)h2*s2;
+    NormUINT128 d2 = (NormUINT128)h0*r[2] + (NormUINT128)h1*r[1] + (NormUINT128)h2*r[0];
+    UINT64 c = (UINT64)(d0 >> 44); h0 = (UINT64)d0 & M44;
+    d1 += c; c = (UINT64)(d1 >> 44); h1 = (UINT64)d1 & M44;
+    d2 += c; c = (UINT64)(d2 >> 42); h2 = (UINT64)d2 & M42;
+    h0 += c * 5; c = h0 >> 44; h0 &= M44;
+    h1 += c;
+    h[0] = h0; h[1] = h1; h[2] = h2;
+}  // end NormPoly1305::Block()
+
+void NormPoly1305::Finish(UINT8* tag)
+{
+    // Fully carry h, then compute h + -p and select it if h >= p
+    const UINT64 M44 = 0xfffffffffffULL, M42 = 0x3ffffffffffULL;
+    UINT64 h0 = h[0], h1 = h[1], h2 = h[2];
+    UINT64 c = h1 >> 44; h1 &= M44;
+    h2 += c; c = h2 >> 42; h2 &= M42;
+    h0 += c * 5; c = h0 >> 44; h0 &= M44;
+    h1 += c; c = h1 >> 44; h1 &= M44;
+    h2 += c; c = h2 >> 42; h2 &= M42;
+    h0 += c * 5; c = h0 >> 44; h0 &= M44;
+    h1 += c;
+    UINT64 g0 = h0 + 5; c = g0 >> 44; g0 &= M44;
+    UINT64 g1 = h1 + c; c = g1 >> 44; g1 &= M44;
+    UINT64 g2 = h2 + c - (1ULL << 42);
+    UINT64 mask = (g2 >> 63) - 1;  // (all ones if h >= p)
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    // h + pad (mod 2^128)
+    h0 += pad[0] & M44; c = h0 >> 44; h0 &= M44;
+    h1 += (((pad[0] >> 44) | (pad[1] << 20)) & M44) + c; c = h1 >> 44; h1 &= M44;
+    h2 += ((pad[1] >> 24) & M42) + c; h2 &= M42;
+    UINT64 out0 = h0 | (h1 << 44);
+    UINT64 out1 = (h1 >> 20) | (h2 << 24);
+    NormAeadStore32(tag, (UINT32)out0);
+    NormAeadStore32(tag + 4, (UINT32)(out0 >> 32));
+    NormAeadStore32(tag + 8, (UINT32)out1);
+    NormAeadStore32(tag + 12, (UINT32)(out1 >> 32));
+}  // end NormPoly1305::Finish()
+#else
+NormPoly1305::NormPoly1305(const UINT8* key)
+{
+    r[0] = (NormAeadLoad32(key + 0)) & 0x3ffffff;
+    r[1] = (NormAeadLoad32(key + 3) >> 2) & 0x3ffff03;
+    r[2] = (NormAeadLoad32(key + 6) >> 4) & 0x3ffc0ff;
+    r[3] = (NormAeadLoad32(key + 9) >> 6) & 0x3f03fff;
+    r[4] = (NormAeadLoad32(key + 12) >> 8) & 0x00fffff;
+    for (int i = 0; i < 4; i++)
+        pad[i] = NormAeadLoad32(key + 16 + 4*i);
+    memset(h, 0, sizeof(h));
+}
+
+void NormPoly1305::Block(const UINT8* m)
+{
+    const UINT32 s1 = r[1] * 5, s2 = r[2] * 5, s3 = r[3] * 5, s4 = r[4] * 5;
+    UINT32 h0 = h[0] + ((NormAeadLoad32(m + 0)) & 0x3ffffff);
+    UINT32 h1 = h[1] + ((NormAeadLoad32(m + 3) >> 2) & 0x3ffffff);
+    UINT32 h2 = h[2] + ((NormAeadLoad32(m + 6) >> 4) & 0x3ffffff);
+    UINT32 h3 = h[3] + ((NormAeadLoad32(m + 9) >> 6) & 0x3ffffff);
+    UINT32 h4 = h[4] + ((NormAeadLoad32(m + 12) >> 8) | (1 << 24));
+    UINT64 d0 = (UINT64)h0*r[0] + (UINT64)h1*s4 + (UINT64)h2*s3 + (UINT64)h3*s2 + (UINT64)h4*s1;
+    UINT64 d1 = (UINT64)h0*r[1] + (UINT64)h1*r[0] + (UINT64)h2*s4 + (UINT64)h3*s3 + (UINT64)h4*s2;
+    UINT64 d2 = (UINT64)h0*r[2] + (UINT64)h1*r[1] + (UINT64)h2*r[0] + (UINT64)h3*s4 + (UINT64)h4*s3;
+    UINT64 d3 = (UINT64)h0*r[3] + (UINT64)h1*r[2] + (UINT64)h2*r[1] + (UINT64)h3*r[0] + (UINT64)h4*s4;
+    UINT64 d4 = (UINT64)h0*r[4] + (UINT64)h1*r[3] + (UINT64)h2*r[2] + (UINT64)h3*r[1] + (UINT64)h4*r[0];
+    UINT32 c = (UINT32)(d0 >> 26); h0 = (UINT32)d0 & 0x3ffffff;
+    d1 += c; c = (UINT32)(d1 >> 26); h1 = (UINT32)d1 & 0x3ffffff;
+    d2 += c; c = (UINT32)(d2 >> 26); h2 = (UINT32)d2 & 0x3ffffff;
+    d3 += c; c = (UINT32)(d3 >> 26); h3 = (UINT32)d3 & 0x3ffffff;
+    d4 += c; c = (UINT32)(d4 >> 26); h4 = (UINT32)d4 & 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+    h[0] = h0; h[1] = h1; h[2] = h2; h[3] = h3; h[4] = h4;
+}  // end NormPoly1305::Block()
+
+void NormPoly1305::Finish(UINT8* tag)
+{
+    // Fully carry h, then compute h + -p and select it if h >= p
+    UINT32 h0 = h[0], h1 = h[1], h2 = h[2], h3 = h[3], h4 = h[4];
+    UINT32 c = h1 >> 26; h1 &= 0x3ffffff;
+    h2 += c; c = h2 >> 26; h2 &= 0x3ffffff;
+    h3 += c; c = h3 >> 26; h3 &= 0x3ffffff;
+    h4 += c; c = h4 >> 26; h4 &= 0x3ffffff;
+    h0 += c * 5; c = h0 >> 26; h0 &= 0x3ffffff;
+    h1 += c;
+    UINT32 g0 = h0 + 5; c = g0 >> 26; g0 &= 0x3ffffff;
+    UINT32 g1 = h1 + c; c = g1 >> 26; g1 &= 0x3ffffff;
+    UINT32 g2 = h2 + c; c = g2 >> 26; g2 &= 0x3ffffff;
+    UINT32 g3 = h3 + c; c = g3 >> 26; g3 &= 0x3ffffff;
+    UINT32 g4 = h4 + c - (1 << 26);
+    UINT32 mask = (g4 >> 31) - 1;  // (all ones if h >= p)
+    h0 = (h0 & ~mask) | (g0 & mask);
+    h1 = (h1 & ~mask) | (g1 & mask);
+    h2 = (h2 & ~mask) | (g2 & mask);
+    h3 = (h3 & ~mask) | (g3 & mask);
+    h4 = (h4 & ~mask) | (g4 & mask);
+    UINT64 f = (UINT64)(h0 | (h1 << 26)) + pad[0];
+    NormAeadStore32(tag, (UINT32)f);
+    f = (UINT64)((h1 >> 6) | (h2 << 20)) + pad[1] + (f >> 32);
+    NormAeadStore32(tag + 4, (UINT32)f);
+    f = (UINT64)((h2 >> 12) | (h3 << 14)) + pad[2] + (f >> 32);
+    NormAeadStore32(tag + 8, (UINT32)f);
+    f = (UINT64)((h3 >> 18) | (h4 << 8)) + pad[3] + (f >> 32);
+    NormAeadStore32(tag + 12, (UINT32)f);
+}  // end NormPoly1305::Finish()
+#endif // if/else __SIZEOF_INT128__
+
+void NormAead::ComputeTag(const UINT8*  nonce,
+                          const UINT8*  aad,
+                          unsigned int  aadLen,
+                          const UINT8*  text,
+                          unsigned int  textLen,
+                          UINT8*        tag) const
+{
+    // The Poly1305 one-time key is the first half of ChaCha20 block zero
+    UINT8 block[64];
+    ChaChaBlock(0, nonce, block);
+    NormPoly1305 poly(block);
+    memset(block, 0, sizeof(block));
+    poly.Update(aad, aadLen);
+    poly.Update(text, textLen);
+    UINT8 lengths[16];
+    NormAeadStore32(lengths, aadLen);
+    NormAeadStore32(lengths + 4, 0);
+    NormAeadStore32(lengths + 8, textLen);
+    NormAeadStore32(lengths + 12, 0);
+    poly.Update(lengths, 16);
+    poly.Finish(tag);
+}  // end NormAead::ComputeTag()
+
+void NormAead::Seal(const UINT8*  nonce,
+                    const UINT8*  aad,
+                    unsigned int  aadLen,
+                    UINT8*        text,
+                    unsigned int  textLen,
+                    UINT8*        tag) const
+{
+    ChaChaXor(1, nonce, text, textLen);
+    ComputeTag(nonce, aad, aadLen, text, textLen, tag);
+}  // end NormAead::Seal()
+
+bool NormAead::Open(const UINT8*  nonce,
+                    const UINT8*  aad,
+                    unsigned int  aadLen,
+                    UINT8*        text,
+                    unsigned int  textLen,
+                    const UINT8*  tag) const
+{
+    UINT8 check[TAG_SIZE];
+    ComputeTag(nonce, aad, aadLen, text, textLen, check);
+    // (constant time compare)
+    UINT8 diff = 0;
+    for (unsigned int i = 0; i < TAG_SIZE; i++)
+        diff |= check[i] ^ tag[i];
+    if (0 != diff) return false;
+    ChaChaXor(1, nonce, text, textLen);
+    return true;
+}  // end NormAead::Open()
@@ -1,6 +1,9 @@
 #define _NORM_API_BUILD	// force 'dllexport' in "normApi.h"
 #include "normApi.h"
 #include "normSession.h"
+#include "normDataPool.h"
+#include "normCommandRing.h"
+#include "normArchive.h"
 
 #ifdef WIN32
 #ifndef _WIN32_WCE
@@ -8,6 +11,10 @@
 #endif // !_WIN32_WCE
 #endif // WIN32
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif // __linux__
+
 // const defs
 extern NORM_API_LINKAGE
 const NormInstanceHandle NORM_INSTANCE_INVALID = ((NormInstanceHandle)0);
@@ -25,6 +32,154 @@ extern NORM_API_LINKAGE
 const NormDescriptor NORM_DESCRIPTOR_INVALID = ProtoDispatcher::INVALID_DESCRIPTOR;
 
 
+/** The "NormEventSignal" is the descriptor (an eventfd or pipe on UNIX,
+ *  an event HANDLE on WIN32) that tells the application events are
+ *  pending.  Signal() and Reset() only touch the descriptor when its
+ *  state actually changes.
+ */
+class NormEventSignal
+{
+    public:
+        NormEventSignal();
+        ~NormEventSignal();
+        
+        bool Open();
+        void Close();
+        void Signal();
+        void Reset();
+        
+        ProtoDispatcher::Descriptor GetDescriptor() const
+        {
+#ifdef WIN32
+            return notify_event;
+#else
+            return notify_fd[0];
+#endif // if/else WIN32/UNIX            
+        }
+        
+    private:
+        bool                        signaled;
+#ifdef WIN32
+        HANDLE                      notify_event;
+#else
+        int                         notify_fd[2];  // (both are the same eventfd on Linux)
+#endif // if/else WIN32/UNIX
+};  // end class NormEventSignal
+
+NormEventSignal::NormEventSignal()
+ : signaled(false)
+{
+#ifdef WIN32
+    notify_event = NULL;
+#else
+    notify_fd[0] = notify_fd[1] = -1;
+#endif // if/else WIN32/UNIX
+}
+
+NormEventSignal::~NormEventSignal()
+{
+    Close();
+}
+
+bool NormEventSignal::Open()
+{
+    Close();
+#ifdef WIN32
+    // Create initially non-signalled, manual reset event
+    notify_event = CreateEvent(NULL, TRUE, FALSE, NULL);  
+    if (NULL == notify_event)
+    {
+        PLOG(PL_FATAL, "NormEventSignal::Open() CreateEvent() error: %s\n", GetErrorString());
+        return false;
+    }
+#else
+#ifdef __linux__
+    // An eventfd is lighter than a pipe (one descriptor, no buffered bytes)
+    notify_fd[0] = notify_fd[1] = eventfd(0, EFD_NONBLOCK);
+    if (notify_fd[0] < 0)
+        PLOG(PL_WARN, "NormEventSignal::Open() eventfd() error: %s (using pipe)\n", GetErrorString());
+#endif // __linux__
+    if ((notify_fd[0] < 0) && (0 != pipe(notify_fd)))
+    {
+        PLOG(PL_FATAL, "NormEventSignal::Open() pipe() error: %s\n", GetErrorString());
+        notify_fd[0] = notify_fd[1] = -1;
+        return false;
+    }
+    // make reading non-blocking (an eventfd already is)
+    if ((notify_fd[0] != notify_fd[1]) &&
+        (-1 == fcntl(notify_fd[0], F_SETFL, fcntl(notify_fd[0], F_GETFL, 0)  | O_NONBLOCK)))
+    {
+        PLOG(PL_FATAL, "NormEventSignal::Open() fcntl(F_SETFL(O_NONBLOCK)) error: %s\n", GetErrorString());
+        close(notify_fd[0]);
+        close(notify_fd[1]);
+        notify_fd[0] = notify_fd[1] = -1;
+        return false;
+    }
+#endif // if/else WIN32/UNIX
+    signaled = false;
+    return true;
+}  // end NormEventSignal::Open()
+
+void NormEventSignal::Close()
+{
+#ifdef WIN32
+    if (NULL != notify_event)
+    {
+        CloseHandle(notify_event);
+        notify_event = NULL;
+    }
+#else
+    if (notify_fd[0] >= 0)
+    {
+        close(notify_fd[0]);  // close read end of pipe (or the eventfd)
+        if (notify_fd[1] != notify_fd[0])
+            close(notify_fd[1]);  // close write end of pipe
+        notify_fd[0] = notify_fd[1] = -1;
+    }
+#endif // if/else WIN32/UNIX
+    signaled = false;
+}  // end NormEventSignal::Close()
+
+void NormEventSignal::Signal()
+{
+    if (signaled) return;  // already signaled
+    signaled = true;
+#ifdef WIN32
+    if (0 == SetEvent(notify_event))
+    {
+        PLOG(PL_ERROR, "NormEventSignal::Signal() SetEvent() error: %s\n",
+                       GetErrorString());
+    }
+#else
+    // (an eventfd needs an 8 byte write, a pipe just one byte)
+    UINT64 value = 1;
+    size_t len = (notify_fd[0] == notify_fd[1]) ? sizeof(value) : 1;
+    while ((ssize_t)len != write(notify_fd[1], &value, len))
+    {
+        if ((EINTR != errno) && (EAGAIN != errno))
+        {
+            PLOG(PL_FATAL, "NormEventSignal::Signal() write() error: %s\n",
+                           GetErrorString());
+            break;
+        }
+    }    
+#endif // if/else WIN32/UNIX  
+}  // end NormEventSignal::Signal()
+
+void NormEventSignal::Reset()
+{
+    if (!signaled) return;  // nothing to reset
+    signaled = false;
+#ifdef WIN32
+    if (0 == ResetEvent(notify_event))
+        PLOG(PL_ERROR, "NormEventSignal::Reset() ResetEvent error: %s\n", GetErrorString());
+#else
+    char byte[32];
+    while (read(notify_fd[0], byte, 32) > 0);  // TBD - error check
+#endif // if/else WIN32/UNIX
+}  // end NormEventSignal::Reset()
+
+
 /** The "NormInstance" class is a C++ helper class that keeps
  *  state for an instance of the NORM API.  It acts as a
  *  "go between" the API's procedural function calls and
@@ -48,10 +203,20 @@ class NormInstance : public NormController
         void Stop()  // pause NORM protocol engine
         {
             dispatcher.Stop();
+            for (unsigned int i = 0; i < shard_count; i++)
+                shard_list[i]->dispatcher.Stop();
             Notify(NormController::EVENT_INVALID, &session_mgr, NULL, NULL, NULL);
         }
         bool Start()
         {
+            for (unsigned int i = 0; i < shard_count; i++)
+            {
+                if (!shard_list[i]->dispatcher.StartThread(priority_boost))
+                {
+                    PLOG(PL_FATAL, "NormInstance::Resume() error restarting NORM shard thread\n");
+                    return false;
+                }
+            }
             if (dispatcher.StartThread(priority_boost))
             {
                 return true;
@@ -65,6 +230,7 @@ class NormInstance : public NormController
         
         bool WaitForEvent();
         bool GetNextEvent(NormEvent* theEvent);
+        unsigned int GetNextEvents(NormEvent* eventList, unsigned int maxEvents);
         bool SetCacheDirectory(const char* cachePath);
         
         void SetAllocationFunctions(NormAllocFunctionHandle allocFunc, 
@@ -72,12 +238,68 @@ class NormInstance : public NormController
         {
             data_alloc_func = allocFunc;
             session_mgr.SetDataFreeFunction(freeFunc);
+            for (unsigned int i = 0; i < shard_count; i++)
+                shard_list[i]->session_mgr.SetDataFreeFunction(freeFunc);
+        }
+        
+        bool SetRxDataPool(size_t cacheLimit);
+        bool AddRxDataPoolRegion(char* region, size_t regionSize);
+        bool SetBusyPoll(bool enable, int cpuId);
+        // (in sharded mode, each shard gets an even share of the budget)
+        bool SetRxMemoryBudget(unsigned long numBytes);
+        static unsigned long GetShardRxMemoryBudget(unsigned long numBytes, unsigned int shardCount)
+        {
+            if ((0 == numBytes) || (0 == shardCount)) return numBytes;
+            return ((numBytes >= shardCount) ? (numBytes / shardCount) : 1);
+        }
+        // (likewise, each shard gets an even share of the tx rate budget)
+        bool SetTxRateBudget(double bitsPerSecond);
+        
+        // In sharded mode, sessions are spread over "shard" instances, each
+        // with its own protocol thread (dispatcher) and NormSessionMgr, that
+        // all post their events to this (their "parent") instance's queue.
+        bool SetShardCount(unsigned int count);
+        unsigned int GetShardCount() const
+            {return shard_count;}
+        NormInstance* GetSessionShard();  // (round-robin, "this" if not sharded)
+        NormInstance* GetTopInstance()
+            {return ((NULL != parent) ? parent : this);}
+        // These suspend / resume the instance thread _and_ any shard threads
+        bool SuspendAll();
+        void ResumeAll();
+        
+        // API calls suspend the protocol thread with this so any commands
+        // posted by the (asynchronous) PostCommand() calls are run first
+        bool SuspendThread()
+        {
+            if (!dispatcher.SuspendThread()) return false;
+            if (!cmd_ring.IsEmpty()) RunCommands();
+            return true;
         }
+        // These API calls are posted to the "cmd_ring" to be run by the
+        // protocol thread instead of suspending it (the command is run
+        // synchronously if the ring is full or unavailable)
+        enum CommandType
+        {
+            CMD_STREAM_FLUSH,       // handle: stream, flag: eom, param: flush mode
+            CMD_STREAM_MARK_EOM,    // handle: stream
+            CMD_SET_TX_RATE,        // handle: session, value: bits per second
+            CMD_RESET_WATERMARK,    // handle: session
+            CMD_CANCEL_WATERMARK    // handle: session
+        };
+        void PostCommand(CommandType type, 
+                         void*       handle, 
+                         double      value = 0.0, 
+                         int         param = 0, 
+                         bool        flag = false);
         
         void ReleasePreviousEvent();
         
-        bool NotifyQueueIsEmpty() const 
-            {return notify_queue.IsEmpty();}
+        bool NotifyQueueIsEmpty();
+        // The notification descriptor is only signaled when the app
+        // is blocked in WaitForEvent() or has exported the descriptor
+        void SetConsumerWaiting(bool state);
+        void ExportDescriptor();
         
         void PurgeSessionNotifications(NormSessionHandle sessionHandle);
         void PurgeNodeNotifications(NormNodeHandle nodeHandle);
@@ -87,13 +309,7 @@ class NormInstance : public NormController
         UINT32 CountCompletedObjects(NormSession* theSession);
         
         ProtoDispatcher::Descriptor GetDescriptor() const
-        {
-#ifdef WIN32
-            return notify_event;
-#else
-            return notify_fd[0];
-#endif // if/else WIN32/UNIX            
-        }
+            {return notify_signal.GetDescriptor();}
         
         static NormInstance* GetInstanceFromSession(NormSessionHandle sessionHandle)
         {
@@ -123,33 +339,117 @@ class NormInstance : public NormController
             class Queue : public ProtoListTemplate<Notification> {};
         };  // end class NormInstance::Notification
         
+        // A session given its own event descriptor (see NormGetSessionDescriptor())
+        // has its notifications queued here instead of on the instance queue
+        class SessionQueue : public ProtoList::Item
+        {
+            public:
+                SessionQueue(NormSessionHandle sessionHandle)
+                 : session(sessionHandle) {}
+                
+                NormSessionHandle       session;
+                NormEventSignal         notify_signal;  // (always signaled)
+                Notification::Queue     notify_queue;
+                Notification::Queue     previous_queue;
+            
+            class List : public ProtoListTemplate<SessionQueue> {};
+        };  // end class NormInstance::SessionQueue
+        
+        // These MUST be called with the session's thread (its shard's
+        // thread in sharded mode) suspended
+        ProtoDispatcher::Descriptor OpenSessionQueue(NormSession& session);
+        void CloseSessionQueue(NormSession& session);
+        unsigned int GetSessionEvents(NormSession& session, NormEvent* eventList, unsigned int maxEvents);
+        
         ProtoDispatcher             dispatcher;
         bool                        priority_boost;
         NormSessionMgr              session_mgr;   
         NormAllocFunctionHandle     data_alloc_func;
+        NormDataPool*               data_pool;  // for received data objects (optional)
         
     private:
-        void ResetNotificationEvent()
+        // Shard threads post events concurrently, so the notification
+        // queues are guarded by "notify_mutex" in sharded mode.  When 
+        // taken, it must be the last lock acquired.
+        void NotifyLock()
         {
+            if (0 == shard_count) return;
 #ifdef WIN32
-            if (0 == ResetEvent(notify_event))
-                PLOG(PL_ERROR, "NormInstance::ResetNotificationEvent() ResetEvent error: %s\n", GetErrorString());
+            EnterCriticalSection(&notify_mutex);
 #else
-           char byte[32];
-           while (read(notify_fd[0], byte, 32) > 0);  // TBD - error check
-#endif // if/else WIN32/UNIX
-        }  
+            pthread_mutex_lock(&notify_mutex);
+#endif // if/else WIN32
+        }
+        void NotifyUnlock()
+        {
+            if (0 == shard_count) return;
+#ifdef WIN32
+            LeaveCriticalSection(&notify_mutex);
+#else
+            pthread_mutex_unlock(&notify_mutex);
+#endif // if/else WIN32
+        }
+        bool SuspendShards();
+        void ResumeShards();
+        void DestroyShards();
+        
+        bool OpenCommandRing();
+        void OnCommandInput(ProtoChannel&              theChannel,
+                            ProtoChannel::Notification notifyType);
+        void RunCommands();
+        void RunCommand(const NormCommandRing::Command& cmd);
+        
+        void QueueNotification(Notification*     n,
+                               NormEventType     type,
+                               NormSessionHandle session,
+                               NormNodeHandle    node,
+                               NormObjectHandle  object);
+        Notification* DequeueNotification()
+            {return DequeueNotification(notify_queue, previous_queue);}
+        Notification* DequeueNotification(Notification::Queue& pendingQueue,
+                                          Notification::Queue& dispatchedQueue);
+        void PurgeObjectNotifications(NormObjectHandle     objectHandle,
+                                      Notification::Queue& pendingQueue,
+                                      Notification::Queue& dispatchedQueue);
+        void PurgeNodeNotifications(NormNodeHandle       nodeHandle,
+                                    Notification::Queue& pendingQueue,
+                                    Notification::Queue& dispatchedQueue);
+        void PurgeSessionNotifications(NormSessionHandle    sessionHandle,
+                                       Notification::Queue& pendingQueue,
+                                       Notification::Queue& dispatchedQueue);
+        void ReleaseSessionQueue(SessionQueue* sessionQueue);
+        void RecycleNotification(Notification* n)  // (unused notification)
+        {
+            NotifyLock();
+            notify_pool.Append(*n);
+            NotifyUnlock();
+        }
+        void ReleaseNotification(Notification* n);
+        void SignalNotificationEvent()
+            {notify_signal.Signal();}
+        void ResetNotificationEvent()
+            {notify_signal.Reset();}
          
         Notification::Queue         notify_pool;
         Notification::Queue         notify_queue; 
-        Notification*               previous_notification;
+        Notification::Queue         previous_queue;  // dispatched events (handles still retained)
+        bool                        consumer_waiting;
+        bool                        descriptor_exported;
+        NormEventSignal             notify_signal;
+        SessionQueue::List          session_queue_list;
         
         const char*                 rx_cache_path;
         
+        NormInstance*               parent;       // non-NULL for a shard
+        NormInstance**              shard_list;
+        unsigned int                shard_count;  // zero if not sharded
+        unsigned int                shard_next;   // next shard for a new session
+        NormCommandRing             cmd_ring;
+        
 #ifdef WIN32
-        HANDLE                      notify_event;
+        CRITICAL_SECTION            notify_mutex;
 #else
-        int                         notify_fd[2];  // TBD - use eventfd on Linux for this, may EVT_USER on MacOS
+        pthread_mutex_t             notify_mutex;
 #endif // if/else WIN32/UNIX
 };  // end class NormInstance
 
@@ -161,12 +461,14 @@ NormInstance::NormInstance()
    session_mgr(static_cast<ProtoTimerMgr&>(dispatcher), 
                static_cast<ProtoSocket::Notifier&>(dispatcher),
                static_cast<ProtoChannel::Notifier*>(&dispatcher)),
-   data_alloc_func(NULL), previous_notification(NULL), rx_cache_path(NULL)
+   data_alloc_func(NULL), data_pool(NULL), consumer_waiting(false),
+   descriptor_exported(false), rx_cache_path(NULL),
+   parent(NULL), shard_list(NULL), shard_count(0), shard_next(0)
 {
 #ifdef WIN32
-    notify_event = NULL;
+    InitializeCriticalSection(&notify_mutex);
 #else
-    notify_fd[0] = notify_fd[1] = -1;
+    pthread_mutex_init(&notify_mutex, NULL);
 #endif // if/else WIN32/UNIX
     dispatcher.SetUserData(&session_mgr);  // for debugging
     session_mgr.SetController(static_cast<NormController*>(this));
@@ -175,13 +477,18 @@ NormInstance::NormInstance()
 NormInstance::~NormInstance()
 {
     Shutdown();
+#ifdef WIN32
+    DeleteCriticalSection(&notify_mutex);
+#else
+    pthread_mutex_destroy(&notify_mutex);
+#endif // if/else WIN32
 }
 
 bool NormInstance::SetCacheDirectory(const char* cachePath)
 {
     // (TBD) verify that we can _write_ to this directory!
     bool result = false;
-    if (dispatcher.SuspendThread())
+    if (SuspendAll())  // (shard threads use "rx_cache_path", too)
     {
         size_t length = strlen(cachePath);
         if (PROTO_PATH_DELIMITER != cachePath[length-1]) 
@@ -204,7 +511,7 @@ bool NormInstance::SetCacheDirectory(const char* cachePath)
             PLOG(PL_ERROR, "NormInstance::SetCacheDirectory() new pathStorage error: %s\n",
                     GetErrorString());
         }
-        dispatcher.ResumeThread();
+        ResumeAll();
     }
     return result;
 }  // end NormInstance::SetCacheDirectory()
@@ -215,6 +522,13 @@ void NormInstance::Notify(NormController::Event   event,
                           class NormNode*         node,
                           class NormObject*       object)
 {
+    if (NULL != parent)
+    {
+        // A shard's events go to the parent instance queue (called
+        // from the shard's thread)
+        parent->Notify(event, sessionMgr, session, node, object);
+        return;
+    }
     switch (event)
     {
         case SEND_OK:
@@ -229,7 +543,9 @@ void NormInstance::Notify(NormController::Event   event,
     // we allow to queue up (it could be large and probably
     // we could base it on how much memory space the pending
     // notifications are allowed to consume.
+    NotifyLock();
     Notification* next = notify_pool.RemoveHead();
+    NotifyUnlock();
     if (NULL == next)
     {
         if (NULL == (next = new Notification))
@@ -256,7 +572,7 @@ void NormInstance::Notify(NormController::Event   event,
                     if (!stream->Accept(size.LSB(), true))
                     {
                         PLOG(PL_FATAL, "NormInstance::Notify() stream accept error\n");
-                        notify_pool.Append(*next);
+                        RecycleNotification(next);
                         return;   
                     }
                     // By setting a non-zero "block pool threshold", this
@@ -325,7 +641,7 @@ void NormInstance::Notify(NormController::Event   event,
                     {
                         // we're ignoring files
                         PLOG(PL_DETAIL, "NormInstance::Notify() warning: receive file but no cache directory set, so ignoring file\n");
-                        notify_pool.Append(*next);
+                        RecycleNotification(next);
                         return;    
                     }                
                     break;
@@ -334,12 +650,21 @@ void NormInstance::Notify(NormController::Event   event,
                 {
                     NormDataObject* dataObj = static_cast<NormDataObject*>(object);
                     unsigned int dataLen = (unsigned int)(object->GetSize().GetOffset());
-                    char* dataPtr = (NULL != data_alloc_func) ? data_alloc_func(dataLen) : new char[dataLen];
+                    char* dataPtr;
+                    if (NULL != data_pool)
+                    {
+                        dataPtr = data_pool->Alloc(dataLen);
+                        dataObj->SetDataFreeFunction(NormDataPool::Free);
+                    }
+                    else
+                    {
+                        dataPtr = (NULL != data_alloc_func) ? data_alloc_func(dataLen) : new char[dataLen];
+                    }
                     if (NULL == dataPtr)
                     {
                         PLOG(PL_FATAL, "NormInstance::Notify(RX_OBJECT_NEW) new dataPtr error: %s\n",
                                        GetErrorString());
-                        notify_pool.Append(*next);
+                        RecycleNotification(next);
                         return;   
                     }
                     // Note that the "true" parameter means the
@@ -350,14 +675,14 @@ void NormInstance::Notify(NormController::Event   event,
                     if (!dataObj->Accept(dataPtr, dataLen, true))
                     {
                         PLOG(PL_FATAL, "NormInstance::Notify() data object accept error\n");
-                        notify_pool.Append(*next);
+                        RecycleNotification(next);
                         return;   
                     }
                     break;
                 }
                 default:
                     // This shouldn't occur
-                    notify_pool.Append(*next);
+                    RecycleNotification(next);
                     return;
             }  // end switch(object->GetType())
             break;
@@ -367,48 +692,131 @@ void NormInstance::Notify(NormController::Event   event,
             break;
     }  // end switch(event)
     
+    QueueNotification(next, (NormEventType)event, session, node, object);
+    
+    // Receive events are copied to the session's mirrors (see 
+    // NormSetRxMirror()), except for stream objects since reading
+    // a stream consumes its data
+    if ((NULL != node) && (NormNode::SENDER == node->GetType()) &&
+        ((NULL == object) || !object->IsStream()))
+    {
+        for (NormSession* mirror = session->GetRxMirrorHead(); 
+             NULL != mirror; 
+             mirror = mirror->GetRxMirrorNext())
+        {
+            NotifyLock();
+            next = notify_pool.RemoveHead();
+            NotifyUnlock();
+            if ((NULL == next) && (NULL == (next = new Notification)))
+            {
+                PLOG(PL_FATAL, "NormInstance::Notify() new mirror Notification error: %s\n", GetErrorString());
+                return;   
+            }
+            QueueNotification(next, (NormEventType)event, mirror, node, object);
+        }
+    }
+}  // end NormInstance::Notify()
+
+void NormInstance::QueueNotification(Notification*     n,
+                                     NormEventType     type,
+                                     NormSessionHandle session,
+                                     NormNodeHandle    node,
+                                     NormObjectHandle  object)
+{
     // "Retain" any valid "object" or "sender" handles for API access
     if (NORM_OBJECT_INVALID != object)
         ((NormObject*)object)->Retain();
     else if (NORM_NODE_INVALID != node)
         ((NormNode*)node)->Retain();
     
+    n->event.type = type;
+    n->event.session = session;
+    n->event.sender = node;
+    n->event.object = object;
+    NotifyLock();
+    SessionQueue* sessionQueue = (NORM_SESSION_INVALID != session) ?
+        (SessionQueue*)((NormSession*)session)->GetEventQueue() : NULL;
+    if (NULL != sessionQueue)
+    {
+        bool doSignal = sessionQueue->notify_queue.IsEmpty();
+        sessionQueue->notify_queue.Append(*n);
+        if (doSignal) sessionQueue->notify_signal.Signal();
+        NotifyUnlock();
+        return;
+    }
     bool doNotify = notify_queue.IsEmpty();
-    next->event.type = (NormEventType)event;
-    next->event.session = session;
-    next->event.sender = node;
-    next->event.object = object;
-    notify_queue.Append(*next);
+    notify_queue.Append(*n);
     
-    if (doNotify)
-    {
-#ifdef WIN32
-        if (0 == SetEvent(notify_event))
-        {
-            PLOG(PL_ERROR, "NormInstance::Notify() SetEvent() error: %s\n",
-                           GetErrorString());
-        }
-#else
-        char byte = 0;
-        while (1 != write(notify_fd[1], &byte, 1))
-        {
-            if ((EINTR != errno) && (EAGAIN != errno))
-            {
-                PLOG(PL_FATAL, "NormInstance::Notify() write() error: %s\n",
-                               GetErrorString());
-                break;
-            }
-        }    
-#endif // if/else WIN32/UNIX  
-    }  
-}  // end NormInstance::Notify()
+    // (the descriptor is left alone unless someone is waiting on it)
+    if (doNotify && (consumer_waiting || descriptor_exported))
+        SignalNotificationEvent();
+    NotifyUnlock();
+}  // end NormInstance::QueueNotification()
+
+// NormInstance::dispatcher MUST be suspended _before_ calling this
+void NormInstance::ExportDescriptor()
+{
+    NotifyLock();
+    descriptor_exported = true;
+    // Make sure events queued before now are signaled
+    if (!notify_queue.IsEmpty()) SignalNotificationEvent();
+    NotifyUnlock();
+}  // end NormInstance::ExportDescriptor()
+
+bool NormInstance::NotifyQueueIsEmpty()
+{
+    NotifyLock();
+    bool result = notify_queue.IsEmpty();
+    NotifyUnlock();
+    return result;
+}  // end NormInstance::NotifyQueueIsEmpty()
+
+void NormInstance::SetConsumerWaiting(bool state)
+{
+    NotifyLock();
+    consumer_waiting = state;
+    // (a shard may have posted an event since the queue was checked)
+    if (state && !notify_queue.IsEmpty()) SignalNotificationEvent();
+    NotifyUnlock();
+}  // end NormInstance::SetConsumerWaiting()
+
+// "Release" any retained object or node handle and return to pool
+// (with the "notify_mutex" held or the shard threads suspended)
+void NormInstance::ReleaseNotification(Notification* n)
+{
+    if (NORM_OBJECT_INVALID != n->event.object)
+        ((NormObject*)(n->event.object))->Release();
+    else if (NORM_NODE_INVALID != n->event.sender)
+        ((NormNode*)(n->event.sender))->Release();
+    notify_pool.Append(*n);
+}  // end NormInstance::ReleaseNotification()
 
 // Purge any notifications associated with a specific object
 void NormInstance::PurgeObjectNotifications(NormObjectHandle objectHandle)
 {
     if (NORM_OBJECT_INVALID == objectHandle) return;
+    if (NULL != parent)
+    {
+        parent->PurgeObjectNotifications(objectHandle);
+        return;
+    }
     
-    Notification::Queue::Iterator iterator(notify_queue);
+    NotifyLock();
+    PurgeObjectNotifications(objectHandle, notify_queue, previous_queue);
+    // (the object's events may be on its session's queue or a mirror's)
+    SessionQueue::List::Iterator queueIterator(session_queue_list);
+    SessionQueue* sessionQueue;
+    while (NULL != (sessionQueue = queueIterator.GetNextItem()))
+        PurgeObjectNotifications(objectHandle, sessionQueue->notify_queue, sessionQueue->previous_queue);
+    // TBD - check if event queue is emptied and reset event/fd
+    NotifyUnlock();
+}  // end NormInstance::PurgeObjectNotifications()
+
+void NormInstance::PurgeObjectNotifications(NormObjectHandle     objectHandle,
+                                            Notification::Queue& pendingQueue,
+                                            Notification::Queue& dispatchedQueue)
+{
+    Notification::Queue::Iterator iterator(pendingQueue);
     Notification* next;
     while (NULL != (next = iterator.GetNextItem()))
     {
@@ -417,25 +825,48 @@ void NormInstance::PurgeObjectNotifications(NormObjectHandle objectHandle)
             // "Release" the previously-retained object handle
             ((NormObject*)objectHandle)->Release();
             // Remove from queue and put in pool
-            notify_queue.Remove(*next);
+            pendingQueue.Remove(*next);
             notify_pool.Append(*next);
         }
     }
-    if ((NULL != previous_notification) && (objectHandle == previous_notification->event.object))
+    Notification::Queue::Iterator prevIterator(dispatchedQueue);
+    while (NULL != (next = prevIterator.GetNextItem()))
     {
-        // "Release" any previously-retained object or node handle
-        ((NormObject*)(previous_notification->event.object))->Release();
-        notify_pool.Append(*previous_notification);   
-        previous_notification = NULL;   
+        if (objectHandle == next->event.object)
+        {
+            dispatchedQueue.Remove(*next);
+            ReleaseNotification(next);
+        }
     }
-    // TBD - check if event queue is emptied and reset event/fd
 }  // end NormInstance::PurgeObjectNotifications()
 
 // Purge any notifications associated with a specific remote sender node
 void NormInstance::PurgeNodeNotifications(NormNodeHandle nodeHandle)
 {
     if (NORM_NODE_INVALID == nodeHandle) return;
-    Notification::Queue::Iterator iterator(notify_queue);
+    if (NULL != parent)
+    {
+        parent->PurgeNodeNotifications(nodeHandle);
+        return;
+    }
+    NotifyLock();
+    PurgeNodeNotifications(nodeHandle, notify_queue, previous_queue);
+    if (notify_queue.IsEmpty()) ResetNotificationEvent();
+    SessionQueue::List::Iterator queueIterator(session_queue_list);
+    SessionQueue* sessionQueue;
+    while (NULL != (sessionQueue = queueIterator.GetNextItem()))
+    {
+        PurgeNodeNotifications(nodeHandle, sessionQueue->notify_queue, sessionQueue->previous_queue);
+        if (sessionQueue->notify_queue.IsEmpty()) sessionQueue->notify_signal.Reset();
+    }
+    NotifyUnlock();
+}  // end NormInstance::PurgeNodeNotifications()
+
+void NormInstance::PurgeNodeNotifications(NormNodeHandle       nodeHandle,
+                                          Notification::Queue& pendingQueue,
+                                          Notification::Queue& dispatchedQueue)
+{
+    Notification::Queue::Iterator iterator(pendingQueue);
     Notification* next;
     while (NULL != (next = iterator.GetNextItem()))
     {
@@ -444,27 +875,49 @@ void NormInstance::PurgeNodeNotifications(NormNodeHandle nodeHandle)
             // "Release" the previously-retained object handle
             ((NormNode*)nodeHandle)->Release();
             // Remove this notification from queue and return to pool
-            notify_queue.Remove(*next);
+            pendingQueue.Remove(*next);
             notify_pool.Append(*next);
         }
     }
-    if ((NULL != previous_notification) && (nodeHandle == previous_notification->event.sender))
+    Notification::Queue::Iterator prevIterator(dispatchedQueue);
+    while (NULL != (next = prevIterator.GetNextItem()))
     {
-        // "Release" any previously-retained object or node handle
-        if (NORM_OBJECT_INVALID != previous_notification->event.object)
-            ((NormObject*)(previous_notification->event.object))->Release();
-        else
-            ((NormNode*)(previous_notification->event.sender))->Release();
-        notify_pool.Append(*previous_notification);   
-        previous_notification = NULL;   
+        if (nodeHandle == next->event.sender)
+        {
+            dispatchedQueue.Remove(*next);
+            ReleaseNotification(next);
+        }
     }
-    if (notify_queue.IsEmpty()) ResetNotificationEvent();
 }  // end NormInstance::PurgeNodeNotifications()
 
 void NormInstance::PurgeSessionNotifications(NormSessionHandle sessionHandle)
 {
     if (NORM_SESSION_INVALID == sessionHandle) return;
-    Notification::Queue::Iterator iterator(notify_queue);
+    if (NULL != parent)
+    {
+        parent->PurgeSessionNotifications(sessionHandle);
+        return;
+    }
+    NotifyLock();
+    PurgeSessionNotifications(sessionHandle, notify_queue, previous_queue);
+    if (notify_queue.IsEmpty()) ResetNotificationEvent();
+    // (matched by handle since the session may already be deleted)
+    SessionQueue::List::Iterator queueIterator(session_queue_list);
+    SessionQueue* sessionQueue;
+    while (NULL != (sessionQueue = queueIterator.GetNextItem()))
+    {
+        if (sessionHandle != sessionQueue->session) continue;
+        PurgeSessionNotifications(sessionHandle, sessionQueue->notify_queue, sessionQueue->previous_queue);
+        sessionQueue->notify_signal.Reset();
+    }
+    NotifyUnlock();
+}  // end NormInstance::PurgeSessionNotifications()
+
+void NormInstance::PurgeSessionNotifications(NormSessionHandle    sessionHandle,
+                                             Notification::Queue& pendingQueue,
+                                             Notification::Queue& dispatchedQueue)
+{
+    Notification::Queue::Iterator iterator(pendingQueue);
     Notification* next;
     while (NULL != (next = iterator.GetNextItem()))
     {
@@ -475,28 +928,35 @@ void NormInstance::PurgeSessionNotifications(NormSessionHandle sessionHandle)
             else if (NORM_NODE_INVALID != next->event.sender)
                 ((NormNode*)next->event.sender)->Release();
             // Remove this notification from queue and return to pool
-            notify_queue.Remove(*next);
+            pendingQueue.Remove(*next);
             notify_pool.Append(*next);
         }   
     }
-    if ((NULL != previous_notification) && (sessionHandle == previous_notification->event.session))
+    Notification::Queue::Iterator prevIterator(dispatchedQueue);
+    while (NULL != (next = prevIterator.GetNextItem()))
     {
-        // "Release" any previously-retained object or node handle
-        if (NORM_OBJECT_INVALID != previous_notification->event.object)
-            ((NormObject*)(previous_notification->event.object))->Release();
-        else if (NORM_NODE_INVALID != previous_notification->event.sender)
-            ((NormNode*)(previous_notification->event.sender))->Release();
-        notify_pool.Append(*previous_notification);   
-        previous_notification = NULL;   
+        if (sessionHandle == next->event.session)
+        {
+            dispatchedQueue.Remove(*next);
+            ReleaseNotification(next);
+        }
     }
-    if (notify_queue.IsEmpty()) ResetNotificationEvent();
 }  // end NormInstance::PurgeSessionNotifications()
 
 // Purges notifications of a specific type for a specific session
 void NormInstance::PurgeNotifications(NormSessionHandle sessionHandle, NormEventType eventType)
 {
     if (NORM_SESSION_INVALID == sessionHandle) return;
-    Notification::Queue::Iterator iterator(notify_queue);
+    if (NULL != parent)
+    {
+        parent->PurgeNotifications(sessionHandle, eventType);
+        return;
+    }
+    NotifyLock();
+    // (a session's events are all on its own queue if it has one)
+    SessionQueue* sessionQueue = (SessionQueue*)((NormSession*)sessionHandle)->GetEventQueue();
+    Notification::Queue& pendingQueue = (NULL != sessionQueue) ? sessionQueue->notify_queue : notify_queue;
+    Notification::Queue::Iterator iterator(pendingQueue);
     Notification* next;
     while (NULL != (next = iterator.GetNextItem()))
     {
@@ -508,34 +968,34 @@ void NormInstance::PurgeNotifications(NormSessionHandle sessionHandle, NormEvent
             else if (NORM_NODE_INVALID != next->event.sender)
                 ((NormNode*)next->event.sender)->Release();
             // Remove this notification from queue and return to pool
-            notify_queue.Remove(*next);
+            pendingQueue.Remove(*next);
             notify_pool.Append(*next);
         }
     }
-    if (notify_queue.IsEmpty()) ResetNotificationEvent();
+    if (pendingQueue.IsEmpty())
+    {
+        if (NULL != sessionQueue)
+            sessionQueue->notify_signal.Reset();
+        else
+            ResetNotificationEvent();
+    }
+    NotifyUnlock();
 }  // end NormInstance::PurgeNotifications()
 
-// NormInstance::dispatcher MUST be suspended _before_ calling this
-bool NormInstance::GetNextEvent(NormEvent* theEvent)
+// Removes the next notification to be dispatched from the "pendingQueue" and
+// keeps it in the "dispatchedQueue" (NormInstance::dispatcher MUST be suspended
+// _before_ calling this and, since the event objects are touched here, so must 
+// any shard threads or, for a session queue, the session's own shard thread)
+NormInstance::Notification* NormInstance::DequeueNotification(Notification::Queue& pendingQueue,
+                                                              Notification::Queue& dispatchedQueue)
 {
-    // First, do any garbage collection for "previous_notification"
-    if (NULL != previous_notification)
-    {
-        // "Release" any previously-retained object or node handle
-        if (NORM_OBJECT_INVALID != previous_notification->event.object)
-            ((NormObject*)(previous_notification->event.object))->Release();
-        else if (NORM_NODE_INVALID != previous_notification->event.sender)
-            ((NormNode*)(previous_notification->event.sender))->Release();
-        notify_pool.Append(*previous_notification);   
-        previous_notification = NULL;   
-    }
     Notification* next;
-    while (NULL != (next = notify_queue.RemoveHead()))
+    while (NULL != (next = pendingQueue.RemoveHead()))
     {
         switch (next->event.type)
         {
             case NORM_EVENT_INVALID:
-                if (!notify_queue.IsEmpty())
+                if (!pendingQueue.IsEmpty())
                 {
                     // Discard this invalid event and get next one
                     notify_pool.Append(*next);
@@ -556,14 +1016,32 @@ bool NormInstance::GetNextEvent(NormEvent* theEvent)
                 session->ClearSendError();
                 break;
             }
+            case NORM_RX_SOCKET_OVERFLOW:
+            {
+                NormSession* session = (NormSession*)next->event.session;
+                session->ClearRxSocketOverflow();
+                break;
+            }
             default:
                 break;   
         }
 	    break;
     }
+    // Keep dispatched event for garbage collection
+    if (NULL != next) dispatchedQueue.Append(*next);
+    return next;
+}  // end NormInstance::DequeueNotification()
+
+// NormInstance::dispatcher MUST be suspended _before_ calling this
+bool NormInstance::GetNextEvent(NormEvent* theEvent)
+{
+    // (with the shards suspended, no events can be posted meanwhile)
+    if (!SuspendShards()) return false;
+    // First, do any garbage collection of previously dispatched events
+    ReleasePreviousEvent();
+    Notification* next = DequeueNotification();
     if (NULL != next)
     {
-        previous_notification = next;  // keep dispatched event for garbage collection
         if (NULL != theEvent) *theEvent = next->event;
     }
     else if (NULL != theEvent)
@@ -574,31 +1052,143 @@ bool NormInstance::GetNextEvent(NormEvent* theEvent)
 	    theEvent->object = NORM_OBJECT_INVALID;
     }
     if (notify_queue.IsEmpty()) ResetNotificationEvent();
+    ResumeShards();
     return (NULL != next); 
 }  // end NormInstance::GetNextEvent()
 
-bool NormInstance::WaitForEvent()
+// Dispatches up to "maxEvents" pending events at once.  Their handles stay
+// retained until the next GetNextEvent(s)() or ReleasePreviousEvent() call.
+// NormInstance::dispatcher MUST be suspended _before_ calling this
+unsigned int NormInstance::GetNextEvents(NormEvent* eventList, unsigned int maxEvents)
 {
-    if (!dispatcher.IsThreaded()) 
+    if (!SuspendShards()) return 0;
+    ReleasePreviousEvent();
+    unsigned int count = 0;
+    Notification* next;
+    while ((count < maxEvents) && (NULL != (next = DequeueNotification())))
+        eventList[count++] = next->event;
+    if (notify_queue.IsEmpty()) ResetNotificationEvent();
+    ResumeShards();
+    return count;
+}  // end NormInstance::GetNextEvents()
+
+// Gives the session its own event queue and descriptor (moving any events
+// for it already pending on the instance queue) or returns the existing one
+ProtoDispatcher::Descriptor NormInstance::OpenSessionQueue(NormSession& session)
+{
+    if (NULL != parent) return parent->OpenSessionQueue(session);
+    SessionQueue* sessionQueue = (SessionQueue*)session.GetEventQueue();
+    if (NULL != sessionQueue) return sessionQueue->notify_signal.GetDescriptor();
+    if (NULL == (sessionQueue = new SessionQueue((NormSessionHandle)&session)))
     {
-        PLOG(PL_FATAL, "NormInstance::WaitForEvent() warning: NORM thread not running!\n");
-        return false;
+        PLOG(PL_FATAL, "NormInstance::OpenSessionQueue() new SessionQueue error: %s\n", GetErrorString());
+        return ProtoDispatcher::INVALID_DESCRIPTOR;
     }
-#ifdef WIN32
-    WaitForSingleObject(notify_event, INFINITE);
-#else
-    fd_set fdSet;
-    FD_ZERO(&fdSet);
-    FD_SET(notify_fd[0], &fdSet);
-    while (1)
+    if (!sessionQueue->notify_signal.Open())
     {
-        if (0 > select(notify_fd[0] + 1, &fdSet, (fd_set*)NULL, 
-                       (fd_set*)NULL, (struct timeval*)NULL))
+        PLOG(PL_ERROR, "NormInstance::OpenSessionQueue() error: unable to open event descriptor\n");
+        delete sessionQueue;
+        return ProtoDispatcher::INVALID_DESCRIPTOR;
+    }
+    NotifyLock();
+    Notification::Queue::Iterator iterator(notify_queue);
+    Notification* next;
+    while (NULL != (next = iterator.GetNextItem()))
+    {
+        if (sessionQueue->session == next->event.session)
         {
-            if (EINTR != errno)
-            {
-                PLOG(PL_FATAL, "NormInstance::WaitForEvent() select() error: %s\n",
-                        GetErrorString());
+            notify_queue.Remove(*next);
+            sessionQueue->notify_queue.Append(*next);
+        }
+    }
+    if (notify_queue.IsEmpty()) ResetNotificationEvent();
+    if (!sessionQueue->notify_queue.IsEmpty()) sessionQueue->notify_signal.Signal();
+    session_queue_list.Append(*sessionQueue);
+    session.SetEventQueue(sessionQueue);
+    NotifyUnlock();
+    return sessionQueue->notify_signal.GetDescriptor();
+}  // end NormInstance::OpenSessionQueue()
+
+// Discards the session's queued events and closes its descriptor
+void NormInstance::CloseSessionQueue(NormSession& session)
+{
+    if (NULL != parent)
+    {
+        parent->CloseSessionQueue(session);
+        return;
+    }
+    NotifyLock();
+    SessionQueue* sessionQueue = (SessionQueue*)session.GetEventQueue();
+    if (NULL != sessionQueue)
+    {
+        session_queue_list.Remove(*sessionQueue);
+        ReleaseSessionQueue(sessionQueue);
+    }
+    NotifyUnlock();
+}  // end NormInstance::CloseSessionQueue()
+
+// (with the "notify_mutex" held and the queue removed from the list)
+void NormInstance::ReleaseSessionQueue(SessionQueue* sessionQueue)
+{
+    ((NormSession*)sessionQueue->session)->SetEventQueue(NULL);
+    Notification* next;
+    while (NULL != (next = sessionQueue->previous_queue.RemoveHead()))
+        ReleaseNotification(next);
+    while (NULL != (next = sessionQueue->notify_queue.RemoveHead()))
+        ReleaseNotification(next);
+    delete sessionQueue;  // (closes its descriptor)
+}  // end NormInstance::ReleaseSessionQueue()
+
+// Non-blocking, batched drain of a session queue.  Handles for the returned
+// events remain valid until the next GetSessionEvents() call for the session
+unsigned int NormInstance::GetSessionEvents(NormSession& session, 
+                                            NormEvent*   eventList, 
+                                            unsigned int maxEvents)
+{
+    if (NULL != parent) return parent->GetSessionEvents(session, eventList, maxEvents);
+    unsigned int count = 0;
+    NotifyLock();
+    SessionQueue* sessionQueue = (SessionQueue*)session.GetEventQueue();
+    if (NULL != sessionQueue)
+    {
+        Notification* next;
+        while (NULL != (next = sessionQueue->previous_queue.RemoveHead()))
+            ReleaseNotification(next);
+        while ((count < maxEvents) &&
+               (NULL != (next = DequeueNotification(sessionQueue->notify_queue, 
+                                                    sessionQueue->previous_queue))))
+        {
+            eventList[count++] = next->event;
+        }
+        if (sessionQueue->notify_queue.IsEmpty()) sessionQueue->notify_signal.Reset();
+    }
+    NotifyUnlock();
+    return count;
+}  // end NormInstance::GetSessionEvents()
+
+bool NormInstance::WaitForEvent()
+{
+    if (!dispatcher.IsThreaded()) 
+    {
+        PLOG(PL_FATAL, "NormInstance::WaitForEvent() warning: NORM thread not running!\n");
+        return false;
+    }
+#ifdef WIN32
+    WaitForSingleObject(notify_signal.GetDescriptor(), INFINITE);
+#else
+    int notifyFd = notify_signal.GetDescriptor();
+    fd_set fdSet;
+    FD_ZERO(&fdSet);
+    FD_SET(notifyFd, &fdSet);
+    while (1)
+    {
+        if (0 > select(notifyFd + 1, &fdSet, (fd_set*)NULL, 
+                       (fd_set*)NULL, (struct timeval*)NULL))
+        {
+            if (EINTR != errno)
+            {
+                PLOG(PL_FATAL, "NormInstance::WaitForEvent() select() error: %s\n",
+                        GetErrorString());
                 return false;   
             }
         }
@@ -615,60 +1205,120 @@ bool NormInstance::WaitForEvent()
 bool NormInstance::Startup(bool priorityBoost)
 {
     // 1) Create descriptor to use for event notification
-#ifdef WIN32
-    // Create initially non-signalled, manual reset event
-    notify_event = CreateEvent(NULL, TRUE, FALSE, NULL);  
-    if (NULL == notify_event)
+    if (!notify_signal.Open()) return false;
+    consumer_waiting = descriptor_exported = false;
+    // 2) Open command ring (optional, API calls are synchronous without it)
+    OpenCommandRing();
+    // 3) Start thread
+    priority_boost = priorityBoost;
+    return dispatcher.StartThread(priorityBoost);
+}  // end NormInstance::Startup()
+
+// NormInstance::dispatcher MUST be suspended (or not yet started) to call this 
+bool NormInstance::OpenCommandRing()
+{
+    cmd_ring.SetNotifier(static_cast<ProtoChannel::Notifier*>(&dispatcher));
+    cmd_ring.SetListener(this, &NormInstance::OnCommandInput);
+    if (!cmd_ring.Open())
     {
-        PLOG(PL_FATAL, "NormInstance::Startup() CreateEvent() error: %s\n", GetErrorString());
+        PLOG(PL_DEBUG, "NormInstance::OpenCommandRing() command ring not available\n");
         return false;
     }
-#else
-    if (0 != pipe(notify_fd))
+    return true;
+}  // end NormInstance::OpenCommandRing()
+
+void NormInstance::OnCommandInput(ProtoChannel&              /*theChannel*/,
+                                  ProtoChannel::Notification notifyType)
+{
+    if (ProtoChannel::NOTIFY_INPUT != notifyType) return;
+    cmd_ring.Reset();
+    RunCommands();
+}  // end NormInstance::OnCommandInput()
+
+// Called from the protocol thread or with it suspended
+void NormInstance::RunCommands()
+{
+    NormCommandRing::Command cmd;
+    while (cmd_ring.Get(cmd)) RunCommand(cmd);
+}  // end NormInstance::RunCommands()
+
+void NormInstance::RunCommand(const NormCommandRing::Command& cmd)
+{
+    switch (cmd.type)
     {
-        PLOG(PL_FATAL, "NormInstance::Startup() pipe() error: %s\n", GetErrorString());
-        return false;
+        case CMD_STREAM_FLUSH:
+        {
+            NormStreamObject* stream = 
+                static_cast<NormStreamObject*>((NormObject*)cmd.handle);
+            NormStreamObject::FlushMode saveFlushMode = stream->GetFlushMode();
+            stream->SetFlushMode((NormStreamObject::FlushMode)cmd.param);
+            stream->Flush(cmd.flag);
+            stream->SetFlushMode(saveFlushMode);
+            break;
+        }
+        case CMD_STREAM_MARK_EOM:
+        {
+            NormStreamObject* stream = 
+                static_cast<NormStreamObject*>((NormObject*)cmd.handle);
+            stream->Write(NULL, 0, true);
+            break;
+        }
+        case CMD_SET_TX_RATE:
+            ((NormSession*)cmd.handle)->SetTxRate(cmd.value);
+            break;
+        case CMD_RESET_WATERMARK:
+            // Purge any existing NORM_TX_WATERMARK_COMPLETED notifications to be safe
+            PurgeNotifications((NormSessionHandle)cmd.handle, NORM_TX_WATERMARK_COMPLETED);
+            ((NormSession*)cmd.handle)->SenderResetWatermark();
+            break;
+        case CMD_CANCEL_WATERMARK:
+            ((NormSession*)cmd.handle)->SenderCancelWatermark();
+            break;
+        default:
+            PLOG(PL_ERROR, "NormInstance::RunCommand() error: invalid command type %d\n", cmd.type);
+            break;
     }
-    // make reading non-blocking
-    if(-1 == fcntl(notify_fd[0], F_SETFL, fcntl(notify_fd[0], F_GETFL, 0)  | O_NONBLOCK))
-    {
-        PLOG(PL_FATAL, "NormInstance::Startup() fcntl(F_SETFL(O_NONBLOCK)) error: %s\n", GetErrorString());
-        close(notify_fd[0]);
-        close(notify_fd[1]);
-        notify_fd[0] = notify_fd[1] = -1;
-        return false;
+}  // end NormInstance::RunCommand()
+
+void NormInstance::PostCommand(CommandType type, 
+                               void*       handle, 
+                               double      value, 
+                               int         param, 
+                               bool        flag)
+{
+    NormCommandRing::Command cmd;
+    cmd.type = type;
+    cmd.handle = handle;
+    cmd.value = value;
+    cmd.param = param;
+    cmd.flag = flag;
+    if (cmd_ring.Post(cmd)) return;
+    // Ring is full (or not available), so run it now (after those queued)
+    if (SuspendThread())
+    {
+        RunCommand(cmd);
+        dispatcher.ResumeThread();
     }
-#endif // if/else WIN32/UNIX
-    // 2) Start thread
-    priority_boost = priorityBoost;
-    return dispatcher.StartThread(priorityBoost);
-}  // end NormInstance::Startup()
+}  // end NormInstance::PostCommand()
 
 
 
 void NormInstance::ReleasePreviousEvent()
 {
-    // Garbage collect our "previous_notification"
-    if (NULL != previous_notification)
-    {
-        // Release any previously-retained object or node handles
-        if (NORM_OBJECT_INVALID != previous_notification->event.object)
-            ((NormObject*)(previous_notification->event.object))->Release();
-        else if (NORM_NODE_INVALID != previous_notification->event.sender)
-            ((NormNode*)(previous_notification->event.sender))->Release();
-        notify_pool.Append(*previous_notification);   
-        previous_notification = NULL;   
-    }
+    // Garbage collect our previously dispatched notification(s)
+    Notification* prev;
+    while (NULL != (prev = previous_queue.RemoveHead()))
+        ReleaseNotification(prev);
 }  // end NormInstance::ReleasePreviousEvent()
 
 NORM_API_LINKAGE
 void NormReleasePreviousEvent(NormInstanceHandle instanceHandle)
 {
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendAll())
     {
         instance->ReleasePreviousEvent();
-        instance->dispatcher.ResumeThread();
+        instance->ResumeAll();
     }
 }  // end NormReleasePreviousEvent()
 
@@ -676,37 +1326,21 @@ void NormReleasePreviousEvent(NormInstanceHandle instanceHandle)
 void NormInstance::Shutdown()
 {
     dispatcher.Stop();
-#ifdef WIN32
-    if (NULL != notify_event)
-    {
-        CloseHandle(notify_event);
-        notify_event = NULL;
-    }
-#else
-    if (notify_fd[0] >= 0)
-    {
-        close(notify_fd[0]);  // close read end of pipe
-        close(notify_fd[1]);  // close write end of pipe
-        notify_fd[0] = notify_fd[1] = -1;
-    }
-#endif // if/else WIN32/UNIX
+    for (unsigned int i = 0; i < shard_count; i++)
+        shard_list[i]->dispatcher.Stop();
+    cmd_ring.Close();
+    notify_signal.Close();
     if (rx_cache_path)
     {
         delete[] (char*)rx_cache_path;
         rx_cache_path = NULL;   
     }
     
-    // Garbage collect our "previous_notification"
-    if (NULL != previous_notification)
-    {
-        // Release any previously-retained object or node handles
-        if (NORM_OBJECT_INVALID != previous_notification->event.object)
-            ((NormObject*)(previous_notification->event.object))->Release();
-        else if (NORM_NODE_INVALID != previous_notification->event.sender)
-            ((NormNode*)(previous_notification->event.sender))->Release();
-        notify_pool.Append(*previous_notification);   
-        previous_notification = NULL;   
-    }
+    // Garbage collect our previously dispatched notification(s)
+    ReleasePreviousEvent();
+    SessionQueue* sessionQueue;
+    while (NULL != (sessionQueue = session_queue_list.RemoveHead()))
+        ReleaseSessionQueue(sessionQueue);
     
     Notification* next;
     while (NULL != (next = notify_queue.RemoveHead()))
@@ -735,13 +1369,231 @@ void NormInstance::Shutdown()
             ((NormNode*)(next->event.sender))->Release();
         delete next;        
     }
+    DestroyShards();  // (sessions are deleted with their shard)
     notify_pool.Destroy();
+    if (NULL != data_pool)
+    {
+        data_pool->Destroy();  // (deleted once any app detached buffers are freed)
+        data_pool = NULL;
+    }
 }  // end NormInstance::Shutdown()
 
+bool NormInstance::SetRxDataPool(size_t cacheLimit)
+{
+    if (!SuspendAll()) return false;  // (shard threads use "data_pool", too)
+    if (0 != cacheLimit)
+    {
+        if ((NULL == data_pool) && (NULL == (data_pool = new NormDataPool())))
+        {
+            PLOG(PL_FATAL, "NormInstance::SetRxDataPool() new NormDataPool error: %s\n", GetErrorString());
+            ResumeAll();
+            return false;
+        }
+        data_pool->SetCacheLimit(cacheLimit);
+    }
+    else if (NULL != data_pool)
+    {
+        // Buffers already given to data objects are still freed to the pool
+        data_pool->Destroy();
+        data_pool = NULL;
+    }
+    ResumeAll();
+    return true;
+}  // end NormInstance::SetRxDataPool()
+
+bool NormInstance::AddRxDataPoolRegion(char* region, size_t regionSize)
+{
+    if (!dispatcher.SuspendThread()) return false;
+    bool result = false;
+    if (NULL != data_pool)
+        result = data_pool->AddRegion(region, regionSize);
+    else
+        PLOG(PL_ERROR, "NormInstance::AddRxDataPoolRegion() error: receive data pool not enabled\n");
+    dispatcher.ResumeThread();
+    return result;
+}  // end NormInstance::AddRxDataPoolRegion()
+
+bool NormInstance::SetBusyPoll(bool enable, int cpuId)
+{
+    if (0 != shard_count)
+    {
+        // The shard threads spin instead, pinned to successive CPUs
+        bool result = true;
+        for (unsigned int i = 0; i < shard_count; i++)
+        {
+            if (!shard_list[i]->SetBusyPoll(enable, (cpuId >= 0) ? (cpuId + (int)i) : -1))
+                result = false;
+        }
+        return result;
+    }
+    if (!dispatcher.SuspendThread()) return false;
+    // (precise timing keeps the dispatcher spinning instead of sleeping)
+    dispatcher.SetPreciseTiming(enable);
+    bool result = session_mgr.SetBusyPoll(enable, cpuId);
+    dispatcher.ResumeThread();
+    return result;
+}  // end NormInstance::SetBusyPoll()
+
+bool NormInstance::SetRxMemoryBudget(unsigned long numBytes)
+{
+    if (!dispatcher.SuspendThread()) return false;
+    session_mgr.SetRxMemoryBudget(numBytes);
+    dispatcher.ResumeThread();
+    unsigned long shardBudget = GetShardRxMemoryBudget(numBytes, shard_count);
+    for (unsigned int i = 0; i < shard_count; i++)
+    {
+        if (!shard_list[i]->dispatcher.SuspendThread()) return false;
+        shard_list[i]->session_mgr.SetRxMemoryBudget(shardBudget);
+        shard_list[i]->dispatcher.ResumeThread();
+    }
+    return true;
+}  // end NormInstance::SetRxMemoryBudget()
+
+bool NormInstance::SetTxRateBudget(double bitsPerSecond)
+{
+    double bytesPerSecond = bitsPerSecond / 8.0;
+    if (!dispatcher.SuspendThread()) return false;
+    session_mgr.SetTxRateBudget(bytesPerSecond);
+    dispatcher.ResumeThread();
+    for (unsigned int i = 0; i < shard_count; i++)
+    {
+        if (!shard_list[i]->dispatcher.SuspendThread()) return false;
+        shard_list[i]->session_mgr.SetTxRateBudget(bytesPerSecond / shard_count);
+        shard_list[i]->dispatcher.ResumeThread();
+    }
+    return true;
+}  // end NormInstance::SetTxRateBudget()
+
+bool NormInstance::SetShardCount(unsigned int count)
+{
+    if (NULL != parent) return false;
+    if (count == shard_count) return true;
+    if (!dispatcher.SuspendThread()) return false;
+    // Shards can only be set up (or removed) before any sessions are created 
+    bool haveSessions = !session_mgr.IsEmpty();
+    for (unsigned int i = 0; i < shard_count; i++)
+    {
+        if (!shard_list[i]->dispatcher.SuspendThread()) continue;
+        if (!shard_list[i]->session_mgr.IsEmpty()) haveSessions = true;
+        shard_list[i]->dispatcher.ResumeThread();
+    }
+    if (haveSessions)
+    {
+        PLOG(PL_ERROR, "NormInstance::SetShardCount() error: instance already has sessions\n");
+        dispatcher.ResumeThread();
+        return false;
+    }
+    DestroyShards();
+    if (0 == count)
+    {
+        dispatcher.ResumeThread();
+        return true;
+    }
+    NormInstance** shardList = new NormInstance*[count];
+    if (NULL == shardList)
+    {
+        PLOG(PL_FATAL, "NormInstance::SetShardCount() new shard_list error: %s\n", GetErrorString());
+        dispatcher.ResumeThread();
+        return false;
+    }
+    unsigned int shardCount = 0;
+    while (shardCount < count)
+    {
+        NormInstance* shard = new NormInstance();
+        if (NULL == shard)
+        {
+            PLOG(PL_FATAL, "NormInstance::SetShardCount() new shard error: %s\n", GetErrorString());
+            break;
+        }
+        shard->parent = this;
+        shard->priority_boost = priority_boost;
+        shard->session_mgr.SetDataFreeFunction(session_mgr.GetDataFreeFunction());
+        shard->session_mgr.SetRxMemoryBudget(GetShardRxMemoryBudget(session_mgr.GetRxMemoryBudget(), count));
+        shard->session_mgr.SetTxRateBudget(session_mgr.GetTxRateBudget() / count);
+        shard->OpenCommandRing();
+        if (!shard->dispatcher.StartThread(priority_boost))
+        {
+            PLOG(PL_FATAL, "NormInstance::SetShardCount() error starting shard thread\n");
+            delete shard;
+            break;
+        }
+        shardList[shardCount++] = shard;
+    }
+    if (shardCount < count)
+    {
+        while (shardCount > 0) delete shardList[--shardCount];
+        delete[] shardList;
+        dispatcher.ResumeThread();
+        return false;
+    }
+    // (the instance thread is idle, so it's the "notify_mutex" from here on)
+    shard_list = shardList;
+    shard_count = count;
+    shard_next = 0;
+    dispatcher.ResumeThread();
+    return true;
+}  // end NormInstance::SetShardCount()
+
+void NormInstance::DestroyShards()
+{
+    if (NULL == shard_list) return;
+    for (unsigned int i = 0; i < shard_count; i++)
+        delete shard_list[i];  // (stops the shard thread)
+    delete[] shard_list;
+    shard_list = NULL;
+    shard_count = shard_next = 0;
+}  // end NormInstance::DestroyShards()
+
+// NormInstance::dispatcher MUST be suspended _before_ calling this
+NormInstance* NormInstance::GetSessionShard()
+{
+    if (0 == shard_count) return this;
+    NormInstance* shard = shard_list[shard_next];
+    shard_next = (shard_next + 1) % shard_count;
+    return shard;
+}  // end NormInstance::GetSessionShard()
+
+// Shard threads are always suspended in order (after the instance
+// thread, if so) so concurrent callers can't deadlock.
+bool NormInstance::SuspendShards()
+{
+    for (unsigned int i = 0; i < shard_count; i++)
+    {
+        if (!shard_list[i]->SuspendThread())
+        {
+            while (i > 0) shard_list[--i]->dispatcher.ResumeThread();
+            return false;
+        }
+    }
+    return true;
+}  // end NormInstance::SuspendShards()
+
+void NormInstance::ResumeShards()
+{
+    unsigned int i = shard_count;
+    while (i > 0) shard_list[--i]->dispatcher.ResumeThread();
+}  // end NormInstance::ResumeShards()
+
+bool NormInstance::SuspendAll()
+{
+    if (!SuspendThread()) return false;
+    if (SuspendShards()) return true;
+    dispatcher.ResumeThread();
+    return false;
+}  // end NormInstance::SuspendAll()
+
+void NormInstance::ResumeAll()
+{
+    ResumeShards();
+    dispatcher.ResumeThread();
+}  // end NormInstance::ResumeAll()
+
 // This function doesn't make sense?
 UINT32 NormInstance::CountCompletedObjects(NormSession* session)
 {
+    if (NULL != parent) return parent->CountCompletedObjects(session);
 	UINT32 result = 0UL;
+    NotifyLock();
     Notification::Queue::Iterator iterator(notify_queue);
     Notification* next;
     while (NULL != (next = iterator.GetNextItem()))
@@ -752,6 +1604,7 @@ UINT32 NormInstance::CountCompletedObjects(NormSession* session)
 			result ++;
         }
 	}
+    NotifyUnlock();
 	return result;
 } // end NormInstance::CountCompletedObjects()
 
@@ -817,7 +1670,7 @@ bool NormSuspendInstance(NormInstanceHandle instanceHandle)
 {
     NormInstance* instance = (NormInstance*)instanceHandle;
     if (instance) 
-        return instance->dispatcher.SuspendThread();  // stops NORM protocol thread
+        return instance->SuspendAll();  // stops NORM protocol thread(s)
     else
         return false;
 }  // end NormSuspendInstance()
@@ -826,7 +1679,7 @@ NORM_API_LINKAGE
 void NormResumeInstance(NormInstanceHandle instanceHandle)
 {
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance) instance->dispatcher.ResumeThread();  
+    if (instance) instance->ResumeAll();  
 }  // end NormResumeInstance()
 
 
@@ -845,10 +1698,16 @@ NORM_API_LINKAGE
 NormDescriptor NormGetDescriptor(NormInstanceHandle instanceHandle)
 {
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance)
+    if (instance && instance->SuspendThread())
+    {
+        instance->ExportDescriptor();
+        instance->dispatcher.ResumeThread();
         return (instance->GetDescriptor());
+    }
     else
+    {
         return NORM_DESCRIPTOR_INVALID;
+    }
 }  // end NormGetDescriptor()
 
 
@@ -861,6 +1720,68 @@ void NormSetAllocationFunctions(NormInstanceHandle      instanceHandle,
     instance->SetAllocationFunctions(allocFunc, freeFunc);
 }  // end NormSetAllocationFunctions()
 
+NORM_API_LINKAGE
+bool NormSetRxDataPool(NormInstanceHandle instanceHandle,
+                       size_t             cacheLimit)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    if (NULL == instance) return false;
+    return instance->SetRxDataPool(cacheLimit);
+}  // end NormSetRxDataPool()
+
+NORM_API_LINKAGE
+bool NormAddRxDataPoolRegion(NormInstanceHandle instanceHandle,
+                             char*              region,
+                             size_t             regionSize)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    if (NULL == instance) return false;
+    return instance->AddRxDataPoolRegion(region, regionSize);
+}  // end NormAddRxDataPoolRegion()
+
+NORM_API_LINKAGE
+bool NormSetBusyPoll(NormInstanceHandle instanceHandle,
+                     bool               enable,
+                     int                cpuId)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    if (NULL == instance) return false;
+    return instance->SetBusyPoll(enable, cpuId);
+}  // end NormSetBusyPoll()
+
+NORM_API_LINKAGE
+bool NormSetShardCount(NormInstanceHandle instanceHandle,
+                       unsigned int       shardCount)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    if (NULL == instance) return false;
+    return instance->SetShardCount(shardCount);
+}  // end NormSetShardCount()
+
+NORM_API_LINKAGE
+bool NormSetRxMemoryBudget(NormInstanceHandle instanceHandle,
+                           unsigned long      numBytes)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    if (NULL == instance) return false;
+    return instance->SetRxMemoryBudget(numBytes);
+}  // end NormSetRxMemoryBudget()
+
+NORM_API_LINKAGE
+bool NormSetTxRateBudget(NormInstanceHandle instanceHandle,
+                         double             bitsPerSecond)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    if (NULL == instance) return false;
+    return instance->SetTxRateBudget(bitsPerSecond);
+}  // end NormSetTxRateBudget()
+
+NORM_API_LINKAGE
+void NormDataFreeBuffer(char* dataPtr)
+{
+    NormDataPool::Free(dataPtr);
+}  // end NormDataFreeBuffer()
+
 
 // if "waitForEvent" is false, this is a non-blocking call
 // (TBD) add a timeout option to this?
@@ -872,13 +1793,14 @@ bool NormGetNextEvent(NormInstanceHandle instanceHandle, NormEvent* theEvent, bo
     bool result = false;
     if (instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {
             if (waitForEvent)
             {
                 if (instance->NotifyQueueIsEmpty()) 
                 {
                     // no pending events, so resume and wait
+                    instance->SetConsumerWaiting(true);
                     instance->dispatcher.ResumeThread();
                     if (!instance->WaitForEvent())
                     {
@@ -888,7 +1810,8 @@ bool NormGetNextEvent(NormInstanceHandle instanceHandle, NormEvent* theEvent, bo
                         return false;
                     }
                     // re-suspend thread after wait
-                    if (!instance->dispatcher.SuspendThread()) return false;
+                    if (!instance->SuspendThread()) return false;
+                    instance->SetConsumerWaiting(false);
                 }
             }
             result = instance->GetNextEvent(theEvent);
@@ -898,6 +1821,64 @@ bool NormGetNextEvent(NormInstanceHandle instanceHandle, NormEvent* theEvent, bo
     return result;  
 }  // end NormGetNextEvent()
 
+NORM_API_LINKAGE
+unsigned int NormGetNextEvents(NormInstanceHandle instanceHandle, 
+                               NormEvent*         eventList, 
+                               unsigned int       maxEvents, 
+                               bool               waitForEvent)
+{
+    NormInstance* instance = (NormInstance*)instanceHandle;
+    unsigned int result = 0;
+    if (instance && (NULL != eventList) && (0 != maxEvents))
+    {
+        if (instance->SuspendThread())
+        {
+            if (waitForEvent && instance->NotifyQueueIsEmpty())
+            {
+                // no pending events, so resume and wait
+                instance->SetConsumerWaiting(true);
+                instance->dispatcher.ResumeThread();
+                if (!instance->WaitForEvent()) return 0;
+                if (!instance->SuspendThread()) return 0;
+                instance->SetConsumerWaiting(false);
+            }
+            result = instance->GetNextEvents(eventList, maxEvents);
+            instance->dispatcher.ResumeThread();
+        }
+    }
+    return result;  
+}  // end NormGetNextEvents()
+
+NORM_API_LINKAGE
+NormDescriptor NormGetSessionDescriptor(NormSessionHandle sessionHandle)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    NormDescriptor result = NORM_DESCRIPTOR_INVALID;
+    if (instance && instance->SuspendThread())
+    {
+        result = instance->OpenSessionQueue(*((NormSession*)sessionHandle));
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormGetSessionDescriptor()
+
+NORM_API_LINKAGE
+unsigned int NormGetSessionEvents(NormSessionHandle sessionHandle,
+                                  NormEvent*        eventList,
+                                  unsigned int      maxEvents)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    unsigned int result = 0;
+    if (instance && (NULL != eventList) && (0 != maxEvents) && instance->SuspendThread())
+    {
+        // (only this session's thread is suspended, so reactors owning
+        // sessions on different shards don't contend with one another)
+        result = instance->GetSessionEvents(*((NormSession*)sessionHandle), eventList, maxEvents);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormGetSessionEvents()
+
 
 NORM_API_LINKAGE
 bool NormIsUnicastAddress(const char* address)
@@ -919,10 +1900,17 @@ NormSessionHandle NormCreateSession(NormInstanceHandle instanceHandle,
 {
     // (TBD) wrap this with SuspendThread/ResumeThread ???
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
-        NormSession* session = 
-            instance->session_mgr.NewSession(sessionAddr, sessionPort, localNodeId);
+        // In sharded mode, the session is assigned to (and its handle
+        // maps to) one of the instance's shards
+        NormInstance* shard = instance->GetSessionShard();
+        NormSession* session = NULL;
+        if ((shard == instance) || shard->dispatcher.SuspendThread())
+        {
+            session = shard->session_mgr.NewSession(sessionAddr, sessionPort, localNodeId);
+            if (shard != instance) shard->dispatcher.ResumeThread();
+        }
         instance->dispatcher.ResumeThread();
         if (NULL != session) 
             return ((NormSessionHandle)session);
@@ -934,11 +1922,16 @@ NORM_API_LINKAGE
 void NormDestroySession(NormSessionHandle sessionHandle)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {    
         NormSession* session = (NormSession*)sessionHandle;
         if (NULL != session)
         {
+            instance->CloseSessionQueue(*session);
+            // (mirrored events hold the session's objects, too)
+            NormSession* mirror = session->GetRxMirrorHead();
+            for (; NULL != mirror; mirror = mirror->GetRxMirrorNext())
+                instance->PurgeSessionNotifications(mirror);
             session->Close();
             session->GetSessionMgr().DeleteSession(session);
             instance->PurgeSessionNotifications(sessionHandle);
@@ -950,15 +1943,16 @@ void NormDestroySession(NormSessionHandle sessionHandle)
 NORM_API_LINKAGE 
 NormInstanceHandle NormGetInstance(NormSessionHandle sessionHandle)
 {
-    
-    return (NormInstanceHandle)NormInstance::GetInstanceFromSession(sessionHandle);
+    // (a sharded session's instance is its shard's parent)
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    return (NormInstanceHandle)((NULL != instance) ? instance->GetTopInstance() : NULL);
 }  // end NormGetIntance()
 
 NORM_API_LINKAGE
 void NormSetUserData(NormSessionHandle sessionHandle, const void* userData)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {    
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetUserData(userData);
@@ -973,7 +1967,7 @@ const void* NormGetUserData(NormSessionHandle sessionHandle)
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session) 
@@ -991,7 +1985,7 @@ void NormSetUserTimer(NormSessionHandle sessionHandle, double seconds)
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session) session->SetUserTimer(seconds);
@@ -1007,7 +2001,7 @@ void NormCancelUserTimer(NormSessionHandle sessionHandle)
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session) session->SetUserTimer(-1.0);  // interval less than zero cancels timer
@@ -1038,7 +2032,7 @@ bool NormGetAddress(NormSessionHandle   sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             const ProtoAddress& sessionAddr = session->Address();
@@ -1076,7 +2070,7 @@ bool NormGetRxBindAddress(NormSessionHandle sessionHandle, char* addr, unsigned
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if ((NULL != instance) && instance->dispatcher.SuspendThread())
+    if ((NULL != instance) && instance->SuspendThread())
     {    
         NormSession* session = (NormSession*)sessionHandle;
         port = session->GetRxPort();
@@ -1115,7 +2109,7 @@ bool NormSetTxPort(NormSessionHandle sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (NULL != session) 
@@ -1142,7 +2136,7 @@ void NormSetTxOnly(NormSessionHandle sessionHandle,
                    bool              connectToSessionAddress)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetTxOnly(txOnly, connectToSessionAddress);
@@ -1159,7 +2153,7 @@ bool NormPresetObjectInfo(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) 
@@ -1176,7 +2170,7 @@ NORM_API_LINKAGE
 void NormLimitObjectInfo(NormSessionHandle sessionHandle, bool state)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) 
@@ -1196,7 +2190,7 @@ NORM_API_LINKAGE
 void NormSetId(NormSessionHandle sessionHandle, NormNodeId normId)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (NULL != session) session->SetNodeId(normId);
@@ -1225,7 +2219,7 @@ bool NormChangeDestination(NormSessionHandle sessionHandle,
 	}
     dest.SetPort(sessionPort);
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         if (NULL != session) 
         {
@@ -1244,7 +2238,7 @@ void NormSetServerListener(NormSessionHandle sessionHandle, bool state)
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session) session->SetServerListener(state);
@@ -1265,10 +2259,10 @@ bool NormTransferSender(NormSessionHandle sessionHandle, NormNodeHandle senderHa
     NormInstance* dstInstance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != dstInstance)
     {
-        if (dstInstance->dispatcher.SuspendThread())
+        if (dstInstance->SuspendThread())
         {
             NormInstance* srcInstance = NormInstance::GetInstanceFromNode(senderHandle);
-            if (srcInstance->dispatcher.SuspendThread())
+            if (srcInstance->SuspendThread())
             {
                 NormSession* session = (NormSession*)sessionHandle;
                 NormSenderNode* sender = (NormSenderNode*)senderHandle;
@@ -1292,7 +2286,7 @@ void NormSetRxPortReuse(NormSessionHandle sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session) session->SetRxPortReuse(enableReuse, rxAddress, senderAddress, senderPort);
@@ -1301,14 +2295,47 @@ void NormSetRxPortReuse(NormSessionHandle sessionHandle,
     } 
 }  // end NormSetRxPortReuse()
 
+NORM_API_LINKAGE
+bool NormSetRxShard(NormSessionHandle sessionHandle,
+                    unsigned int      shardIndex,
+                    unsigned int      shardCount)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetRxShard(shardIndex, shardCount);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxShard()
 
 NORM_API_LINKAGE
-void NormSetEcnSupport(NormSessionHandle sessionHandle, bool ecnEnable, bool ignoreLoss, bool tolerateLoss)
+bool NormSetRxPortShare(NormSessionHandle sessionHandle,
+                        bool              enable)
 {
+    bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (NULL != instance)
+    if (instance && instance->SuspendThread())
     {
-        if (instance->dispatcher.SuspendThread())
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetRxPortShare(enable);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxPortShare()
+
+
+NORM_API_LINKAGE
+void NormSetEcnSupport(NormSessionHandle sessionHandle, bool ecnEnable, bool ignoreLoss, bool tolerateLoss)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (NULL != instance)
+    {
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session) session->SetEcnSupport(ecnEnable, ignoreLoss, tolerateLoss);
@@ -1325,7 +2352,7 @@ bool NormSetMulticastInterface(NormSessionHandle sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session)
@@ -1336,6 +2363,109 @@ bool NormSetMulticastInterface(NormSessionHandle sessionHandle,
     return result;     
 }  // end NormSetMulticastInterface()
 
+NORM_API_LINKAGE
+bool NormAddTxPath(NormSessionHandle sessionHandle,
+                   const char*       interfaceName,
+                   const char*       srcAddr,
+                   double            weight)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session)
+            result = session->AddTxPath(interfaceName, srcAddr, weight);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormAddTxPath()
+
+NORM_API_LINKAGE
+bool NormSetTxPathWeight(NormSessionHandle sessionHandle,
+                         unsigned int      pathIndex,
+                         double            weight)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session)
+            result = session->SetTxPathWeight(pathIndex, weight);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTxPathWeight()
+
+NORM_API_LINKAGE
+bool NormAddTxLayer(NormSessionHandle sessionHandle,
+                    const char*       groupAddr,
+                    double            weight)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session)
+            result = session->AddTxLayer(groupAddr, weight);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormAddTxLayer()
+
+NORM_API_LINKAGE
+bool NormAddRxLayer(NormSessionHandle sessionHandle,
+                    const char*       groupAddr)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session)
+            result = session->AddRxLayer(groupAddr);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormAddRxLayer()
+
+NORM_API_LINKAGE
+unsigned int NormGetRxLayerLevel(NormSessionHandle sessionHandle)
+{
+    unsigned int level = 0;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session)
+            level = session->GetRxLayerLevel();
+        instance->dispatcher.ResumeThread();
+    }
+    return level;
+}  // end NormGetRxLayerLevel()
+
+NORM_API_LINKAGE 
+bool NormSetXdpInterface(NormSessionHandle sessionHandle,
+                         const char*       interfaceName,
+                         unsigned int      queueId)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (NULL != instance)
+    {
+        if (instance->SuspendThread())
+        {    
+            NormSession* session = (NormSession*)sessionHandle;
+            if (session)
+                result = session->SetXdpInterface(interfaceName, queueId);
+            instance->dispatcher.ResumeThread();
+        }
+    }
+    return result;     
+}  // end NormSetXdpInterface()
+
 NORM_API_LINKAGE 
 bool NormSetSSM(NormSessionHandle sessionHandle,
                 const char*       sourceAddress)
@@ -1344,7 +2474,7 @@ bool NormSetSSM(NormSessionHandle sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session)
@@ -1363,7 +2493,7 @@ bool NormSetTTL(NormSessionHandle sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (NULL != instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session)
@@ -1382,7 +2512,7 @@ bool NormSetTOS(NormSessionHandle sessionHandle,
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
     if (instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             NormSession* session = (NormSession*)sessionHandle;
             if (session)
@@ -1433,6 +2563,35 @@ void NormSetMessageTrace(NormSessionHandle sessionHandle, bool state)
     if (session) session->SetTrace(state);
 }  // end NormSetMessageTrace()
 
+NORM_API_LINKAGE
+bool NormSetTraceRing(NormSessionHandle sessionHandle, unsigned int numRecords)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        result = session->SetTraceRing(numRecords);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTraceRing()
+
+NORM_API_LINKAGE
+bool NormWriteTraceRing(NormSessionHandle sessionHandle, const char* fileName)
+{
+    bool result = false;
+    if (NULL == fileName) return false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        result = session->WriteTraceRing(fileName);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormWriteTraceRing()
+
 NORM_API_LINKAGE
 void NormSetTxLoss(NormSessionHandle sessionHandle, double percent)
 {
@@ -1454,7 +2613,7 @@ bool NormOpenDebugLog(NormInstanceHandle instanceHandle, const char *path)
     cause problems with this. */
     bool result = false;
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance->dispatcher.SuspendThread()) {
+    if (instance->SuspendThread()) {
         result = OpenDebugLog(path);
         instance->dispatcher.ResumeThread();
     }
@@ -1467,7 +2626,7 @@ void NormCloseDebugLog(NormInstanceHandle instanceHandle)
     /* NOTE: This only locks one thread.  Multiple NormInstances could
     cause problems with this. */
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance->dispatcher.SuspendThread()) {
+    if (instance->SuspendThread()) {
         CloseDebugLog();
         instance->dispatcher.ResumeThread();
     }
@@ -1480,7 +2639,7 @@ bool NormOpenDebugPipe(NormInstanceHandle instanceHandle, const char *pipeName)
     cause problems with this. */
     bool result = false;
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance->dispatcher.SuspendThread()) {
+    if (instance->SuspendThread()) {
         result = OpenDebugPipe(pipeName);
         instance->dispatcher.ResumeThread();
     }
@@ -1493,7 +2652,7 @@ void NormCloseDebugPipe(NormInstanceHandle instanceHandle)
     /* NOTE: This only locks one thread.  Multiple NormInstances could
     cause problems with this. */
     NormInstance* instance = (NormInstance*)instanceHandle;
-    if (instance->dispatcher.SuspendThread()) {
+    if (instance->SuspendThread()) {
         CloseDebugPipe();
         instance->dispatcher.ResumeThread();
     }
@@ -1516,7 +2675,7 @@ NORM_API_LINKAGE
 void NormSetReportInterval(NormSessionHandle sessionHandle, double interval)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1530,7 +2689,7 @@ double NormGetReportInterval(NormSessionHandle sessionHandle)
 {
     double result = 0;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1540,6 +2699,73 @@ double NormGetReportInterval(NormSessionHandle sessionHandle)
     return result;
 }  // end NormGetReportInterval()
 
+NORM_API_LINKAGE
+bool NormGetSessionStats(NormSessionHandle sessionHandle,
+                         NormSessionStats* stats)
+{
+    bool result = false;
+    if (NULL == stats) return false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        stats->txBytes = (NormSize)session->GetTxByteCount();
+        stats->txSegments = (NormSize)session->GetTxSegmentCount();
+        stats->txRepairBytes = (NormSize)session->GetTxRepairByteCount();
+        stats->nacksReceived = (NormSize)session->GetNackRecvCount();
+        stats->txRate = session->GetTxRate();
+        stats->grtt = session->SenderGrtt();
+        stats->ccEnabled = session->CongestionControl() && session->IsSender();
+        stats->rxSocketDrops = (NormSize)session->GetRxSocketDropCount();
+        stats->rxAuthFailures = (NormSize)session->GetRxAuthFailureCount();
+        result = true;
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormGetSessionStats()
+
+static void NormGetHistogramStats(const NormHistogram& histogram, NormLatencyStats* stats)
+{
+    stats->count = (NormSize)histogram.GetCount();
+    stats->min = histogram.GetMin();
+    stats->mean = histogram.GetMean();
+    stats->p50 = histogram.GetPercentile(50.0);
+    stats->p90 = histogram.GetPercentile(90.0);
+    stats->p99 = histogram.GetPercentile(99.0);
+    stats->p999 = histogram.GetPercentile(99.9);
+    stats->max = histogram.GetMax();
+}  // end NormGetHistogramStats()
+
+NORM_API_LINKAGE
+void NormSetLatencyStats(NormSessionHandle sessionHandle,
+                         bool              enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->SetLatencyStats(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetLatencyStats()
+
+NORM_API_LINKAGE
+bool NormGetTxLatencyStats(NormSessionHandle sessionHandle,
+                           NormLatencyStats* stats)
+{
+    bool result = false;
+    if (NULL == stats) return false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        NormGetHistogramStats(session->GetTxLatency(), stats);
+        result = true;
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormGetTxLatencyStats()
+
 /** NORM Sender Functions */
 
 NORM_API_LINKAGE
@@ -1562,7 +2788,7 @@ bool NormStartSender(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1578,7 +2804,7 @@ NORM_API_LINKAGE
 void NormStopSender(NormSessionHandle sessionHandle)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->StopSender();
@@ -1586,6 +2812,32 @@ void NormStopSender(NormSessionHandle sessionHandle)
     }
 }  // end NormStopSender()
 
+NORM_API_LINKAGE 
+void NormSetTxFecInstanceId(NormSessionHandle sessionHandle,
+                            UINT16            instanceId)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SenderSetFecInstanceId(instanceId);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetTxFecInstanceId()
+
+NORM_API_LINKAGE 
+void NormSetTxFecWorkerCount(NormSessionHandle sessionHandle,
+                             unsigned int      count)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SenderSetFecWorkerCount(count);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetTxFecWorkerCount()
+
 
 NORM_API_LINKAGE
 double NormGetTxRate(NormSessionHandle sessionHandle)
@@ -1600,13 +2852,10 @@ NORM_API_LINKAGE
 void NormSetTxRate(NormSessionHandle sessionHandle,
                          double            bitsPerSecond)
 {
+    // (posted to the protocol thread, see NormInstance::PostCommand())
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
-    {
-        NormSession* session = (NormSession*)sessionHandle;
-        if (session) session->SetTxRate(bitsPerSecond);
-        instance->dispatcher.ResumeThread();
-    }
+    if (NULL != instance) 
+        instance->PostCommand(NormInstance::CMD_SET_TX_RATE, (void*)sessionHandle, bitsPerSecond);
 }  // end NormSetTxRate()
 
 NORM_API_LINKAGE
@@ -1615,7 +2864,7 @@ bool NormSetTxSocketBuffer(NormSessionHandle sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) 
@@ -1625,11 +2874,23 @@ bool NormSetTxSocketBuffer(NormSessionHandle sessionHandle,
     return result;
 }  // end NormSetTxSocketBuffer()
 
+NORM_API_LINKAGE
+void NormSetAutoTune(NormSessionHandle sessionHandle, bool enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetAutoTune(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetAutoTune()
+
 NORM_API_LINKAGE
 void NormSetFlowControl(NormSessionHandle sessionHandle, double flowControlFactor)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetFlowControl(flowControlFactor);
@@ -1641,7 +2902,7 @@ NORM_API_LINKAGE
 void NormSetCongestionControl(NormSessionHandle sessionHandle, bool enable, bool adjustRate)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetCongestionControl(enable, adjustRate);
@@ -1649,13 +2910,62 @@ void NormSetCongestionControl(NormSessionHandle sessionHandle, bool enable, bool
     }
 }  // end NormSetCongestionControl()
 
+NORM_API_LINKAGE
+void NormSetCCMode(NormSessionHandle sessionHandle, NormCCMode ccMode)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            session->SetCCMode((NORM_CC_BBR == ccMode) ? NormSession::CC_BBR : NormSession::CC_TFMCC);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetCCMode()
+
+NORM_API_LINKAGE
+void NormSetTxWindow(NormSessionHandle sessionHandle, bool enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetTxWindow(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetTxWindow()
+
+NORM_API_LINKAGE
+void NormSetDefaultTxWeight(NormSessionHandle sessionHandle, unsigned int weight)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SenderSetDefaultWeight(weight);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetDefaultTxWeight()
+
+NORM_API_LINKAGE
+void NormObjectSetTxWeight(NormObjectHandle objectHandle, unsigned int weight)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormObject* object = (NormObject*)objectHandle;
+        object->GetSession().SenderSetObjectWeight(*object, weight);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormObjectSetTxWeight()
+
 NORM_API_LINKAGE
 void NormSetTxRateBounds(NormSessionHandle sessionHandle,
                          double            rateMin,
                          double            rateMax)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetTxRateBounds(rateMin, rateMax);
@@ -1663,6 +2973,19 @@ void NormSetTxRateBounds(NormSessionHandle sessionHandle,
     }
 }  // end NormSetTxRateBounds()
 
+NORM_API_LINKAGE
+void NormSetTxRateWeight(NormSessionHandle sessionHandle,
+                         double            weight)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetTxRateWeight(weight);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetTxRateWeight()
+
 NORM_API_LINKAGE
 void NormSetTxCacheBounds(NormSessionHandle sessionHandle,
                           NormSize          sizeMax,
@@ -1670,7 +2993,7 @@ void NormSetTxCacheBounds(NormSessionHandle sessionHandle,
                           UINT32            countMax)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         NormObjectSize theSize(sizeMax);
@@ -1679,11 +3002,29 @@ void NormSetTxCacheBounds(NormSessionHandle sessionHandle,
     }
 }  // end NormSetTxCacheBounds()
 
+NORM_API_LINKAGE
+bool NormSetTxCacheSpill(NormSessionHandle sessionHandle,
+                         const char*       directory,
+                         NormSize          sizeMax,
+                         UINT32            countMax)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        NormObjectSize theSize(sizeMax);
+        if (session) result = session->SetTxCacheSpill(directory, theSize, countMax);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTxCacheSpill()
+
 NORM_API_LINKAGE
 void NormSetAutoParity(NormSessionHandle sessionHandle, unsigned char autoParity)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SenderSetAutoParity(autoParity);
@@ -1691,12 +3032,26 @@ void NormSetAutoParity(NormSessionHandle sessionHandle, unsigned char autoParity
     }
 }  // end NormSetAutoParity()
 
+NORM_API_LINKAGE
+void NormSetAutoParityAdaptive(NormSessionHandle sessionHandle,
+                               bool              enable,
+                               double            targetRepairProb)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SenderSetAdaptiveParity(enable, targetRepairProb);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetAutoParityAdaptive()
+
 NORM_API_LINKAGE
 void NormSetGrttEstimate(NormSessionHandle sessionHandle,
                          double            grttEstimate)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SenderSetGrtt(grttEstimate);
@@ -1724,7 +3079,7 @@ void NormSetGrttMax(NormSessionHandle sessionHandle,
                     double            grttMax)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetGrttMax(grttMax);
@@ -1737,7 +3092,7 @@ void NormSetGrttProbingMode(NormSessionHandle sessionHandle,
                             NormProbingMode   probingMode)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         session->SetGrttProbingMode((NormSession::ProbingMode)probingMode);
@@ -1751,7 +3106,7 @@ void NormSetGrttProbingInterval(NormSessionHandle sessionHandle,
                                 double            intervalMax)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SetGrttProbingInterval(intervalMin, intervalMax);
@@ -1764,7 +3119,7 @@ void NormSetGrttProbingTOS(NormSessionHandle sessionHandle,
                            UINT8              probeTOS)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         session->SetProbeTOS(probeTOS);
@@ -1777,7 +3132,7 @@ void NormSetBackoffFactor(NormSessionHandle sessionHandle,
                           double            backoffFactor)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (backoffFactor >= 0.0)
@@ -1791,7 +3146,7 @@ void NormSetGroupSize(NormSessionHandle sessionHandle,
                       unsigned int      groupSize)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         session->SenderSetGroupSize((double)groupSize);
@@ -1799,12 +3154,39 @@ void NormSetGroupSize(NormSessionHandle sessionHandle,
     }
 }  // end NormSetGroupSize()
 
+NORM_API_LINKAGE
+void NormSetGroupSizeEstimation(NormSessionHandle sessionHandle,
+                                bool              enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->SenderSetGroupSizeEstimation(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetGroupSizeEstimation()
+
+NORM_API_LINKAGE
+double NormGetGroupSizeEstimate(NormSessionHandle sessionHandle)
+{
+    double gsize = -1.0;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        gsize = session->SenderGroupSize();
+        instance->dispatcher.ResumeThread();
+    }
+    return gsize;
+}  // end NormGetGroupSizeEstimate()
+
 NORM_API_LINKAGE 
 void NormSetTxRobustFactor(NormSessionHandle sessionHandle,
                            int               robustFactor)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         session->SetTxRobustFactor(robustFactor);
@@ -1812,6 +3194,19 @@ void NormSetTxRobustFactor(NormSessionHandle sessionHandle,
     }
 }  // end NormSetTxRobustFactor()
 
+NORM_API_LINKAGE
+void NormSetTxFlushPiggyback(NormSessionHandle sessionHandle,
+                             bool              enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->SetTxFlushPiggyback(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetTxFlushPiggyback()
+
 NORM_API_LINKAGE
 NormObjectHandle NormFileEnqueue(NormSessionHandle  sessionHandle,
                                  const char*        fileName,
@@ -1820,7 +3215,7 @@ NormObjectHandle NormFileEnqueue(NormSessionHandle  sessionHandle,
 {
     NormObjectHandle objectHandle = NORM_OBJECT_INVALID;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1834,6 +3229,38 @@ NormObjectHandle NormFileEnqueue(NormSessionHandle  sessionHandle,
     return objectHandle;
 }  // end NormFileEnqueue()
 
+NORM_API_LINKAGE
+NormObjectHandle NormFileEnqueueArchive(NormSessionHandle  sessionHandle,
+                                        const char*        archivePath,
+                                        const char**       fileList,
+                                        const char**       nameList,
+                                        unsigned int       fileCount,
+                                        const char*        infoPtr, 
+                                        unsigned int       infoLen)
+{
+    if ((NORM_SESSION_INVALID == sessionHandle) || (NULL == archivePath) || (NULL == fileList))
+        return NORM_OBJECT_INVALID;
+    // (the archive is written without holding the NORM thread)
+    NormArchiveWriter archive;
+    if (!archive.Open(archivePath)) return NORM_OBJECT_INVALID;
+    for (unsigned int i = 0; i < fileCount; i++)
+    {
+        const char* name = (NULL != nameList) ? nameList[i] : NULL;
+        if (NULL == name)
+        {
+            name = strrchr(fileList[i], PROTO_PATH_DELIMITER);
+            name = (NULL != name) ? (name + 1) : fileList[i];
+        }
+        if (!archive.AddFile(fileList[i], name))
+        {
+            archive.Abort();
+            return NORM_OBJECT_INVALID;
+        }
+    }
+    if (!archive.Close()) return NORM_OBJECT_INVALID;
+    return NormFileEnqueue(sessionHandle, archivePath, infoPtr, infoLen);
+}  // end NormFileEnqueueArchive()
+
 NORM_API_LINKAGE
 NormObjectHandle NormDataEnqueue(NormSessionHandle  sessionHandle,
                                  const char*        dataPtr,
@@ -1843,7 +3270,7 @@ NormObjectHandle NormDataEnqueue(NormSessionHandle  sessionHandle,
 {
     NormObjectHandle objectHandle = NORM_OBJECT_INVALID;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1857,13 +3284,38 @@ NormObjectHandle NormDataEnqueue(NormSessionHandle  sessionHandle,
     return objectHandle;
 }  // end NormDataEnqueue()
 
-
-NORM_API_LINKAGE 
-bool NormRequeueObject(NormSessionHandle sessionHandle, NormObjectHandle objectHandle)
+NORM_API_LINKAGE
+NormObjectHandle NormDataEnqueueV(NormSessionHandle     sessionHandle,
+                                  const NormDataVector* vecList,
+                                  unsigned int          vecCount,
+                                  const char*           infoPtr, 
+                                  unsigned int          infoLen)
+{
+    NormObjectHandle objectHandle = NORM_OBJECT_INVALID;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session)
+        {
+            // (NormDataVector and NormDataObject::Vector have the same layout)
+            NormObject* obj = 
+                static_cast<NormObject*>(session->QueueTxDataV((const NormDataObject::Vector*)vecList, 
+                                                               vecCount, infoPtr, infoLen));
+            if (NULL != obj) objectHandle = (NormObjectHandle)obj;
+        }
+        instance->dispatcher.ResumeThread();
+    }
+    return objectHandle;
+}  // end NormDataEnqueueV()
+
+
+NORM_API_LINKAGE 
+bool NormRequeueObject(NormSessionHandle sessionHandle, NormObjectHandle objectHandle)
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1884,7 +3336,7 @@ NormObjectHandle NormStreamOpen(NormSessionHandle  sessionHandle,
 {
     NormObjectHandle objectHandle = NORM_OBJECT_INVALID;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -1909,7 +3361,7 @@ void NormStreamClose(NormObjectHandle streamHandle, bool graceful)
         if (graceful && (NULL == stream->GetSender()))
         {
             NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-            if (instance && instance->dispatcher.SuspendThread())
+            if (instance && instance->SuspendThread())
             {
                 stream->Close(true);  // graceful stream closure
                 instance->dispatcher.ResumeThread();
@@ -1944,7 +3396,7 @@ unsigned int NormStreamWrite(NormObjectHandle   streamHandle,
     //       as-needed basis.  Thus, using SuspendThread() (lighter weight) should suffice
     unsigned int result = 0;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if ((NULL != instance) && instance->dispatcher.SuspendThread())
+    if ((NULL != instance) && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
@@ -1955,21 +3407,49 @@ unsigned int NormStreamWrite(NormObjectHandle   streamHandle,
 }  // end NormStreamWrite()
 
 NORM_API_LINKAGE
-void NormStreamFlush(NormObjectHandle streamHandle, 
-                     bool             eom,
-                     NormFlushMode    flushMode)
+char* NormStreamReserve(NormObjectHandle streamHandle,
+                        unsigned int*    numBytes)
 {
+    char* result = NULL;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if ((NULL != instance) && instance->dispatcher.SuspendThread())
+    if ((NULL != instance) && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
-        NormStreamObject::FlushMode saveFlushMode = stream->GetFlushMode();
-        stream->SetFlushMode((NormStreamObject::FlushMode)flushMode);
-        stream->Flush(eom);
-        stream->SetFlushMode(saveFlushMode);
+        unsigned int len = (NULL != numBytes) ? *numBytes : 0;
+        result = stream->Reserve(len);
+        if (NULL != numBytes) *numBytes = len;
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamReserve()
+
+NORM_API_LINKAGE
+unsigned int NormStreamCommit(NormObjectHandle streamHandle,
+                              unsigned int     numBytes,
+                              bool             eom)
+{
+    unsigned int result = 0;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if ((NULL != instance) && instance->SuspendThread())
+    {
+        NormStreamObject* stream = 
+            static_cast<NormStreamObject*>((NormObject*)streamHandle);
+        result = stream->Commit(numBytes, eom);
         instance->dispatcher.ResumeThread();
     }
+    return result;
+}  // end NormStreamCommit()
+
+NORM_API_LINKAGE
+void NormStreamFlush(NormObjectHandle streamHandle, 
+                     bool             eom,
+                     NormFlushMode    flushMode)
+{
+    // (posted to the protocol thread, see NormInstance::PostCommand())
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (NULL != instance)
+        instance->PostCommand(NormInstance::CMD_STREAM_FLUSH, (void*)streamHandle, 0.0, (int)flushMode, eom);
 }  // end NormStreamFlush()
 
 NORM_API_LINKAGE
@@ -1990,12 +3470,101 @@ void NormStreamSetPushEnable(NormObjectHandle streamHandle, bool state)
     if (stream) stream->SetPushMode(state);
 }  // end NormStreamSetPushEnable()
 
+NORM_API_LINKAGE
+bool NormStreamSetCoalescing(NormObjectHandle streamHandle,
+                             double           maxDelay,
+                             unsigned short   minFill)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormObject* obj = (NormObject*)streamHandle;
+        if ((NULL != obj) && obj->IsStream())
+            result = static_cast<NormStreamObject*>(obj)->SetCoalescing(maxDelay, minFill);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamSetCoalescing()
+
+NORM_API_LINKAGE
+bool NormSetEventCoalescing(NormSessionHandle sessionHandle,
+                            NormEventType     eventType,
+                            unsigned int      threshold,
+                            double            minInterval)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        result = session->SetEventCoalescing((NormController::Event)eventType, threshold, minInterval);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetEventCoalescing()
+
+NORM_API_LINKAGE
+unsigned int NormStreamGetEventCount(NormObjectHandle streamHandle,
+                                     NormEventType    eventType)
+{
+    unsigned int result = 0;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormObject* obj = (NormObject*)streamHandle;
+        if ((NULL != obj) && obj->IsStream())
+        {
+            NormStreamObject* stream = static_cast<NormStreamObject*>(obj);
+            if (NORM_TX_QUEUE_VACANCY == eventType)
+                result = stream->GetEventCount(NormStreamObject::EVENT_TX_VACANCY);
+            else if (NORM_RX_OBJECT_UPDATED == eventType)
+                result = stream->GetEventCount(NormStreamObject::EVENT_RX_UPDATED);
+        }
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamGetEventCount()
+
+NORM_API_LINKAGE
+bool NormStreamSetWindowRepair(NormObjectHandle streamHandle,
+                               unsigned short   window,
+                               unsigned short   interval)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormObject* obj = (NormObject*)streamHandle;
+        if ((NULL != obj) && obj->IsStream())
+            result = static_cast<NormStreamObject*>(obj)->SetWindowRepair(window, interval);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamSetWindowRepair()
+
+NORM_API_LINKAGE
+bool NormStreamSetSyncInterval(NormObjectHandle streamHandle,
+                               unsigned short   interval)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormObject* obj = (NormObject*)streamHandle;
+        if ((NULL != obj) && obj->IsStream())
+            result = static_cast<NormStreamObject*>(obj)->SetSyncInterval(interval);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamSetSyncInterval()
+
 NORM_API_LINKAGE
 bool NormStreamHasVacancy(NormObjectHandle streamHandle)
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
@@ -2011,7 +3580,7 @@ unsigned int NormStreamGetVacancy(NormObjectHandle streamHandle, unsigned int by
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
@@ -2025,14 +3594,10 @@ unsigned int NormStreamGetVacancy(NormObjectHandle streamHandle, unsigned int by
 NORM_API_LINKAGE
 void NormStreamMarkEom(NormObjectHandle streamHandle)
 {
+    // (posted to the protocol thread, see NormInstance::PostCommand())
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if (instance && instance->dispatcher.SuspendThread())
-    {
-        NormStreamObject* stream = 
-            static_cast<NormStreamObject*>((NormObject*)streamHandle);
-        if (stream) stream->Write(NULL, 0, true);
-        instance->dispatcher.ResumeThread();
-    }
+    if (NULL != instance)
+        instance->PostCommand(NormInstance::CMD_STREAM_MARK_EOM, (void*)streamHandle);
 }  // end NormStreamMarkEom()
 
 NORM_API_LINKAGE
@@ -2042,7 +3607,7 @@ bool NormSetWatermark(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         NormObject* obj = (NormObject*)objectHandle;
@@ -2084,7 +3649,7 @@ bool NormSetWatermarkEx(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         NormObject* obj = (NormObject*)objectHandle;
@@ -2118,35 +3683,61 @@ bool NormSetWatermarkEx(NormSessionHandle  sessionHandle,
     return result;
 }  // end NormSetWatermarkEx()
 
-NORM_API_LINKAGE
-bool NormResetWatermark(NormSessionHandle  sessionHandle)
+NORM_API_LINKAGE 
+bool NormAddWatermark(NormSessionHandle  sessionHandle,
+                      NormObjectHandle   objectHandle,
+                      bool               overrideFlush)
 {
+    bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
-        // Purge any existing NORM_TX_WATERMARK_COMPLETED notifications to be safe
-        instance->PurgeNotifications(sessionHandle, NORM_TX_WATERMARK_COMPLETED);
         NormSession* session = (NormSession*)sessionHandle;
-        session->SenderResetWatermark();
+        NormObject* obj = (NormObject*)objectHandle;
+        if (session && obj)
+        {
+            // (pending NORM_TX_WATERMARK_COMPLETED notifications are kept here
+            //  since they may be for the older watermarks still in progress)
+            if (obj->IsStream())
+            {
+                NormStreamObject* stream = static_cast<NormStreamObject*>(obj);
+                result = session->SenderAddWatermark(stream->GetId(), 
+                                                     stream->FlushBlockId(),
+                                                     stream->FlushSegmentId(),
+                                                     overrideFlush);  
+            }
+            else
+            {
+                NormBlockId blockId = obj->GetFinalBlockId();
+                NormSegmentId segmentId = obj->GetBlockSize(blockId) - 1;
+                result = session->SenderAddWatermark(obj->GetId(), 
+                                                     blockId,
+                                                     segmentId,
+                                                     overrideFlush);  
+            }
+        }        
         instance->dispatcher.ResumeThread();
-        return true;
-    }
-    else
-    {
-        return false;
     }
+    return result;
+}  // end NormAddWatermark()
+
+NORM_API_LINKAGE
+bool NormResetWatermark(NormSessionHandle  sessionHandle)
+{
+    // (posted to the protocol thread, see NormInstance::PostCommand())
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (NULL == instance) return false;
+    instance->PostCommand(NormInstance::CMD_RESET_WATERMARK, (void*)sessionHandle);
+    return true;
 }  // end NormResetWatermark()
 
 NORM_API_LINKAGE
 void NormCancelWatermark(NormSessionHandle sessionHandle)
 {
+    // (posted to the protocol thread, see NormInstance::PostCommand())
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
-    {
-        NormSession* session = (NormSession*)sessionHandle;
-        session->SenderCancelWatermark();
-        instance->dispatcher.ResumeThread();
-    }
+    if (NULL != instance)
+        instance->PostCommand(NormInstance::CMD_CANCEL_WATERMARK, (void*)sessionHandle);
 }  // end NormSetWatermark()
 
 NORM_API_LINKAGE
@@ -2155,7 +3746,7 @@ bool NormAddAckingNode(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session)
@@ -2170,7 +3761,7 @@ void NormRemoveAckingNode(NormSessionHandle  sessionHandle,
                           NormNodeId         nodeId)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         if (session) session->SenderRemoveAckingNode(nodeId);
@@ -2178,6 +3769,22 @@ void NormRemoveAckingNode(NormSessionHandle  sessionHandle,
     }
 }  // end NormRemoveAckingNode()
 
+NORM_API_LINKAGE
+bool NormSetAckingNodeAggregator(NormSessionHandle  sessionHandle,
+                                 NormNodeId         nodeId,
+                                 NormNodeId         aggregatorId)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        result = session->SenderSetAckingNodeAggregator(nodeId, aggregatorId);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetAckingNodeAggregator()
+
 NORM_API_LINKAGE
 NormNodeHandle NormGetAckingNodeHandle(NormSessionHandle  sessionHandle,
                                        NormNodeId         nodeId)
@@ -2185,7 +3792,7 @@ NormNodeHandle NormGetAckingNodeHandle(NormSessionHandle  sessionHandle,
 	if (NORM_SESSION_INVALID != sessionHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormSession* session = (NormSession*)sessionHandle;
             NormAckingNode* acker = session->SenderFindAckingNode(nodeId);
@@ -2226,7 +3833,7 @@ NormAckingStatus NormGetAckingStatus(NormSessionHandle  sessionHandle,
                                      NormNodeId         nodeId)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         NormAckingStatus status = 
@@ -2247,7 +3854,7 @@ bool NormGetNextAckingNode(NormSessionHandle    sessionHandle,
 {
     if (NULL == nodeId) return false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         bool result = session->SenderGetNextAckingNode(*nodeId, (NormSession::AckingStatus*)ackingStatus);
@@ -2267,7 +3874,7 @@ bool NormGetAckEx(NormSessionHandle sessionHandle,
                   unsigned int*     buflen)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         bool result = (NormAckingStatus)session->SenderGetAckEx(nodeId, buffer, buflen);
@@ -2286,7 +3893,7 @@ bool NormSendCommand(NormSessionHandle  sessionHandle,
                      bool               robust)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         bool result = session->SenderSendCmd(cmdBuffer, cmdLength, robust);
@@ -2303,7 +3910,7 @@ NORM_API_LINKAGE
 void NormCancelCommand(NormSessionHandle sessionHandle)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         session->SenderCancelCmd();
@@ -2323,113 +3930,590 @@ bool NormSendCommandTo(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        ProtoAddress dest;
+        if (dest.ResolveFromString(addr))
+        {
+            dest.SetPort(port);
+            result = session->SenderSendAppCmd(cmdBuffer, cmdLength, dest);
+        }
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSendCommandTo()
+
+
+NORM_API_LINKAGE 
+void NormSetSynStatus(NormSessionHandle sessionHandle, bool state)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->SenderSetSynStatus(state);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetSynStatus()
+
+
+/** NORM Receiver Functions */
+
+NORM_API_LINKAGE
+bool NormStartReceiver(NormSessionHandle  sessionHandle,
+                       UINT32      bufferSpace)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        result = session->StartReceiver(bufferSpace);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStartReceiver()
+
+NORM_API_LINKAGE
+void NormStopReceiver(NormSessionHandle sessionHandle)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->StopReceiver();
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormStopReceiver()
+
+
+NORM_API_LINKAGE 
+void NormSetRxCacheLimit(NormSessionHandle sessionHandle,
+                         unsigned short    countMax)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetRxCacheMax(countMax);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetRxCacheLimit()
+
+NORM_API_LINKAGE 
+bool NormSetRxSenderQuota(NormSessionHandle sessionHandle,
+                          NormNodeId        senderId,
+                          NormNodeId        idMask,
+                          unsigned long     bufferSpace,
+                          unsigned short    cacheMax)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) result = session->ReceiverSetSenderQuota(senderId, idMask, bufferSpace, cacheMax);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxSenderQuota()
+
+NORM_API_LINKAGE 
+void NormSetFileMapping(NormSessionHandle sessionHandle,
+                        bool              enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetFileMapping(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetFileMapping()
+
+NORM_API_LINKAGE 
+bool NormSetFileIoWorkerCount(NormSessionHandle sessionHandle,
+                              unsigned int      count)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetFileIoWorkerCount(count);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetFileIoWorkerCount()
+
+NORM_API_LINKAGE 
+bool NormSetRxFileJournal(NormSessionHandle sessionHandle,
+                          const char*       dirPath)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetRxFileJournal(dirPath);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxFileJournal()
+
+NORM_API_LINKAGE 
+bool NormSetTxParityCache(NormSessionHandle sessionHandle,
+                          unsigned long     byteMax)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetTxParityCache(byteMax);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTxParityCache()
+
+NORM_API_LINKAGE 
+void NormSetTxDigest(NormSessionHandle sessionHandle,
+                     bool              enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetTxDigest(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetTxDigest()
+
+NORM_API_LINKAGE 
+void NormSetBufferSlabMode(NormSessionHandle sessionHandle,
+                           bool              enable,
+                           bool              hugePages,
+                           int               numaNode)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetSlabMode(enable, hugePages, numaNode);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetBufferSlabMode()
+
+NORM_API_LINKAGE 
+void NormSetRxDecoderCacheSize(NormSessionHandle sessionHandle,
+                               unsigned int      countMax)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetRxDecoderCacheSize(countMax);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetRxDecoderCacheSize()
+
+NORM_API_LINKAGE 
+void NormSetRxFecWorkerCount(NormSessionHandle sessionHandle,
+                             unsigned int      count)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) session->SetRxFecWorkerCount(count);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetRxFecWorkerCount()
+
+NORM_API_LINKAGE
+bool NormSetRxSocketBuffer(NormSessionHandle sessionHandle, 
+                           unsigned int      bufferSize)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetRxSocketBuffer(bufferSize);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxSocketBuffer()
+
+NORM_API_LINKAGE
+bool NormSetRxBatchSize(NormSessionHandle sessionHandle, 
+                        unsigned int      batchSize)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetRxBatchSize(batchSize);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxBatchSize()
+
+NORM_API_LINKAGE
+bool NormSetRxTimestamps(NormSessionHandle sessionHandle,
+                         bool              enable)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetRxTimestamps(enable);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxTimestamps()
+
+NORM_API_LINKAGE
+void NormSetRxExcuseSocketDrops(NormSessionHandle sessionHandle,
+                                bool              excuse)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            session->SetRxExcuseSocketDrops(excuse);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetRxExcuseSocketDrops()
+
+NORM_API_LINKAGE
+bool NormSetAeadKey(NormSessionHandle sessionHandle,
+                    const char*       key,
+                    unsigned int      keyLength)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetAeadKey(key, keyLength);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetAeadKey()
+
+NORM_API_LINKAGE
+bool NormSetTxBatchSize(NormSessionHandle sessionHandle, 
+                        unsigned int      batchSize)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetTxBatchSize(batchSize);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTxBatchSize()
+
+NORM_API_LINKAGE
+bool NormSetTxZeroCopy(NormSessionHandle sessionHandle, 
+                       bool              enable)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetTxZeroCopy(enable);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTxZeroCopy()
+
+NORM_API_LINKAGE
+bool NormSetTxTimePacing(NormSessionHandle sessionHandle, 
+                         bool              enable,
+                         bool              taiClock)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        if (session) 
+            result = session->SetTxTimePacing(enable, taiClock);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetTxTimePacing()
+
+NORM_API_LINKAGE
+void NormSetSilentReceiver(NormSessionHandle sessionHandle,
+                           bool              silent,
+                           INT32             maxDelay)
+{
+    NormSession* session = (NormSession*)sessionHandle;
+    if (session) 
+    {
+        session->ReceiverSetSilent(silent);
+        session->RcvrSetMaxDelay(maxDelay);
+    }
+}  // end NormSetSilentReceiver()
+
+NORM_API_LINKAGE
+void NormSetDefaultUnicastNack(NormSessionHandle sessionHandle,
+                               bool              unicastNacks)
+{
+    NormSession* session = (NormSession*)sessionHandle;
+    if (session) session->ReceiverSetUnicastNacks(unicastNacks);
+}  // end NormSetDefaultUnicastNack()
+
+NORM_API_LINKAGE
+void NormSetLocalRepair(NormSessionHandle sessionHandle,
+                        unsigned char     localTtl,
+                        bool              repairer)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->ReceiverSetLocalRepair(localTtl, repairer);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetLocalRepair()
+
+NORM_API_LINKAGE
+bool NormSetAckAggregator(NormSessionHandle sessionHandle,
+                          NormNodeId        aggregatorId,
+                          const char*       aggregatorAddr,
+                          UINT16            aggregatorPort)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
-        ProtoAddress dest;
-        if (dest.ResolveFromString(addr))
+        ProtoAddress addr;
+        if (NORM_NODE_NONE == aggregatorId)
         {
-            dest.SetPort(port);
-            result = session->SenderSendAppCmd(cmdBuffer, cmdLength, dest);
+            session->ReceiverSetAckAggregator(NORM_NODE_NONE, addr);
+            result = true;
+        }
+        else if ((NULL != aggregatorAddr) && addr.ResolveFromString(aggregatorAddr))
+        {
+            addr.SetPort(aggregatorPort);
+            session->ReceiverSetAckAggregator(aggregatorId, addr);
+            result = true;
+        }
+        else
+        {
+            PLOG(PL_ERROR, "NormSetAckAggregator() error: invalid aggregator address\n");
         }
         instance->dispatcher.ResumeThread();
     }
     return result;
-}  // end NormSendCommandTo()
+}  // end NormSetAckAggregator()
 
-
-NORM_API_LINKAGE 
-void NormSetSynStatus(NormSessionHandle sessionHandle, bool state)
+NORM_API_LINKAGE
+void NormSetAckAggregation(NormSessionHandle sessionHandle,
+                           bool              enable)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
-        session->SenderSetSynStatus(state);
+        session->ReceiverSetAckAggregation(enable);
         instance->dispatcher.ResumeThread();
     }
-}  // end NormSetSynStatus()
-
-
-/** NORM Receiver Functions */
+}  // end NormSetAckAggregation()
 
 NORM_API_LINKAGE
-bool NormStartReceiver(NormSessionHandle  sessionHandle,
-                       UINT32      bufferSpace)
+void NormSetRxProgressive(NormSessionHandle sessionHandle,
+                          bool              enable)
 {
-    bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
-        result = session->StartReceiver(bufferSpace);
+        session->RcvrSetProgressive(enable);
         instance->dispatcher.ResumeThread();
     }
+}  // end NormSetRxProgressive()
+
+NORM_API_LINKAGE
+bool NormObjectGetCompletedBlock(NormObjectHandle objectHandle,
+                                 UINT32*          blockId,
+                                 NormSize*        offset,
+                                 NormSize*        length)
+{
+    bool result = false;
+    if (NORM_OBJECT_INVALID != objectHandle)
+    {
+        NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
+        if (instance && instance->SuspendThread())
+        {
+            NormObject* obj = (NormObject*)objectHandle;
+            NormBlockId id;
+            if (obj->ReceiverGetCompletedBlock(id))
+            {
+                if (NULL != blockId) *blockId = id.GetValue();
+                if (NULL != offset) *offset = (NormSize)obj->GetBlockOffset(id).GetOffset();
+                if (NULL != length) *length = (NormSize)obj->GetBlockLength(id).GetOffset();
+                result = true;
+            }
+            instance->dispatcher.ResumeThread();
+        }
+    }
     return result;
-}  // end NormStartReceiver()
+}  // end NormObjectGetCompletedBlock()
 
 NORM_API_LINKAGE
-void NormStopReceiver(NormSessionHandle sessionHandle)
+bool NormSetRelaySession(NormSessionHandle sessionHandle,
+                         NormSessionHandle relaySession)
 {
+    bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if ((NORM_SESSION_INVALID != relaySession) && 
+        ((relaySession == sessionHandle) ||
+         (NormInstance::GetInstanceFromSession(relaySession) != instance)))
+    {
+        PLOG(PL_ERROR, "NormSetRelaySession() error: invalid relay session\n");
+        return false;
+    }
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
-        session->StopReceiver();
+        session->SetRelaySession((NormSession*)relaySession);
+        result = true;
         instance->dispatcher.ResumeThread();
     }
-}  // end NormStopReceiver()
-
+    return result;
+}  // end NormSetRelaySession()
 
-NORM_API_LINKAGE 
-void NormSetRxCacheLimit(NormSessionHandle sessionHandle,
-                         unsigned short    countMax)
+NORM_API_LINKAGE
+bool NormSetRxMirror(NormSessionHandle mirrorSession,
+                     NormSessionHandle primarySession)
 {
-    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(mirrorSession);
+    if ((NORM_SESSION_INVALID != primarySession) && 
+        ((primarySession == mirrorSession) ||
+         (NormInstance::GetInstanceFromSession(primarySession) != instance)))
     {
-        NormSession* session = (NormSession*)sessionHandle;
-        if (session) session->SetRxCacheMax(countMax);
+        PLOG(PL_ERROR, "NormSetRxMirror() error: invalid primary session\n");
+        return false;
+    }
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* mirror = (NormSession*)mirrorSession;
+        NormSession* primary = (NormSession*)primarySession;
+        // (mirrors aren't chained, so a mirror can't be a primary)
+        if ((NULL != primary) && 
+            ((NULL != primary->GetRxMirrorPrimary()) || (NULL != mirror->GetRxMirrorHead())))
+        {
+            PLOG(PL_ERROR, "NormSetRxMirror() error: mirror sessions can't be chained\n");
+        }
+        else
+        {
+            mirror->SetRxMirror(primary);
+            result = true;
+        }
         instance->dispatcher.ResumeThread();
     }
-}  // end NormSetRxCacheLimit()
+    return result;
+}  // end NormSetRxMirror()
 
 NORM_API_LINKAGE
-bool NormSetRxSocketBuffer(NormSessionHandle sessionHandle, 
-                           unsigned int      bufferSize)
+bool NormSetBufferPool(NormSessionHandle poolSession,
+                       unsigned long     bufferSpace,
+                       UINT16            segmentSize,
+                       UINT16            numData,
+                       UINT16            numParity)
 {
     bool result = false;
-    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    NormInstance* instance = NormInstance::GetInstanceFromSession(poolSession);
+    if (instance && instance->SuspendThread())
     {
-        NormSession* session = (NormSession*)sessionHandle;
-        if (session) 
-            result = session->SetRxSocketBuffer(bufferSize);
+        NormSession* session = (NormSession*)poolSession;
+        result = session->CreateBufferPool(bufferSpace, segmentSize, numData, numParity);
         instance->dispatcher.ResumeThread();
     }
     return result;
-}  // end NormSetRxSocketBuffer()
+}  // end NormSetBufferPool()
 
 NORM_API_LINKAGE
-void NormSetSilentReceiver(NormSessionHandle sessionHandle,
-                           bool              silent,
-                           INT32             maxDelay)
+bool NormShareBufferPool(NormSessionHandle session,
+                         NormSessionHandle poolSession)
 {
-    NormSession* session = (NormSession*)sessionHandle;
-    if (session) 
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(session);
+    if ((NORM_SESSION_INVALID != poolSession) && 
+        (NormInstance::GetInstanceFromSession(poolSession) != instance))
     {
-        session->ReceiverSetSilent(silent);
-        session->RcvrSetMaxDelay(maxDelay);
+        PLOG(PL_ERROR, "NormShareBufferPool() error: invalid pool session\n");
+        return false;
     }
-}  // end NormSetSilentReceiver()
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* theSession = (NormSession*)session;
+        NormSession* pool = (NormSession*)poolSession;
+        if ((NULL != pool) && (NULL == pool->GetBufferPool()))
+        {
+            PLOG(PL_ERROR, "NormShareBufferPool() error: pool session has no buffer pool\n");
+        }
+        else
+        {
+            theSession->SetBufferPool((NULL != pool) ? pool->GetBufferPool() : NULL);
+            result = true;
+        }
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormShareBufferPool()
 
 NORM_API_LINKAGE
-void NormSetDefaultUnicastNack(NormSessionHandle sessionHandle,
-                               bool              unicastNacks)
+bool NormSetRxDemux(NormSessionHandle session,
+                    NormSessionHandle listenerSession,
+                    NormNodeHandle    remoteNode)
 {
-    NormSession* session = (NormSession*)sessionHandle;
-    if (session) session->ReceiverSetUnicastNacks(unicastNacks);
-}  // end NormSetDefaultUnicastNack()
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(session);
+    if ((NORM_SESSION_INVALID != listenerSession) && 
+        ((listenerSession == session) ||
+         (NormInstance::GetInstanceFromSession(listenerSession) != instance) ||
+         (NORM_NODE_INVALID == remoteNode) ||
+         (&((NormNode*)remoteNode)->GetSession() != (NormSession*)listenerSession)))
+    {
+        PLOG(PL_ERROR, "NormSetRxDemux() error: invalid listener session or remote node\n");
+        return false;
+    }
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* theSession = (NormSession*)session;
+        if (NORM_SESSION_INVALID == listenerSession)
+            result = theSession->SetRxDemux(NULL, ProtoAddress());
+        else
+            result = theSession->SetRxDemux((NormSession*)listenerSession, 
+                                            ((NormNode*)remoteNode)->GetAddress());
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormSetRxDemux()
 
 NORM_API_LINKAGE
 void NormNodeSetUnicastNack(NormNodeHandle   nodeHandle,
@@ -2452,6 +4536,26 @@ void NormSetDefaultSyncPolicy(NormSessionHandle sessionHandle,
     if (session) session->ReceiverSetDefaultSyncPolicy((NormSenderNode::SyncPolicy)syncPolicy);
 }  // end NormSetDefaultSyncPolicy()
 
+NORM_API_LINKAGE
+void NormSetDefaultRxEvictionPolicy(NormSessionHandle  sessionHandle,
+                                    NormEvictionPolicy evictionPolicy)
+{
+    NormSession* session = (NormSession*)sessionHandle;
+    if (session) session->ReceiverSetDefaultEvictionPolicy((NormSenderNode::EvictionPolicy)evictionPolicy);
+}  // end NormSetDefaultRxEvictionPolicy()
+
+NORM_API_LINKAGE
+void NormNodeSetRxEvictionPolicy(NormNodeHandle     nodeHandle,
+                                 NormEvictionPolicy evictionPolicy)
+{
+    NormNode* node = (NormNode*)nodeHandle;
+    if ((NULL != node) && (NormNode::SENDER == node->GetType()))
+    {
+        NormSenderNode* sender = static_cast<NormSenderNode*>(node);
+        sender->SetEvictionPolicy((NormSenderNode::EvictionPolicy)evictionPolicy);
+    }
+}  // end NormNodeSetRxEvictionPolicy()
+
 NORM_API_LINKAGE
 void NormSetDefaultNackingMode(NormSessionHandle sessionHandle,
                                NormNackingMode   nackingMode)
@@ -2507,7 +4611,7 @@ void NormSetDefaultRxRobustFactor(NormSessionHandle sessionHandle,
                                   int               robustFactor)
 {
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         session->SetRxRobustFactor(robustFactor);
@@ -2522,7 +4626,7 @@ void NormNodeSetRxRobustFactor(NormNodeHandle   nodeHandle,
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             if (NormNode::SENDER == node->GetType())
@@ -2545,7 +4649,7 @@ bool NormPreallocateRemoteSender(NormSessionHandle  sessionHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormSession* session = (NormSession*)sessionHandle;
         result = session->PreallocateRemoteSender((unsigned int)bufferSize, segmentSize, numData, numParity, streamBufferSize);
@@ -2554,6 +4658,40 @@ bool NormPreallocateRemoteSender(NormSessionHandle  sessionHandle,
     return result;
 }  // end NormPreallocateRemoteSender()
 
+NORM_API_LINKAGE
+bool NormPreallocateRemoteSenders(NormSessionHandle  sessionHandle,
+                                  unsigned int       count,
+                                  unsigned long      bufferSize,
+                                  UINT16             segmentSize, 
+                                  UINT16             numData, 
+                                  UINT16             numParity,
+                                  unsigned int       streamBufferSize)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        result = session->PreallocateRemoteSenders(count, (unsigned int)bufferSize, segmentSize, 
+                                                   numData, numParity, streamBufferSize);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormPreallocateRemoteSenders()
+
+NORM_API_LINKAGE
+void NormSetMemoryPrefault(NormSessionHandle sessionHandle,
+                           bool              enable)
+{
+    NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormSession* session = (NormSession*)sessionHandle;
+        session->SetMemoryPrefault(enable);
+        instance->dispatcher.ResumeThread();
+    }
+}  // end NormSetMemoryPrefault()
+
 NORM_API_LINKAGE
 bool NormStreamRead(NormObjectHandle   streamHandle,
                     char*              buffer,
@@ -2561,7 +4699,7 @@ bool NormStreamRead(NormObjectHandle   streamHandle,
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
@@ -2571,12 +4709,49 @@ bool NormStreamRead(NormObjectHandle   streamHandle,
     return result;
 }  // end NormStreamRead()
 
+NORM_API_LINKAGE
+bool NormStreamReadView(NormObjectHandle   streamHandle,
+                        const char**       buffer,
+                        unsigned int*      numBytes)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormStreamObject* stream = 
+            static_cast<NormStreamObject*>((NormObject*)streamHandle);
+        const char* ptr = NULL;
+        unsigned int len = (NULL != numBytes) ? *numBytes : 0;
+        result = stream->ReadView(ptr, len);
+        if (NULL != buffer) *buffer = ptr;
+        if (NULL != numBytes) *numBytes = len;
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamReadView()
+
+NORM_API_LINKAGE
+bool NormStreamReadRelease(NormObjectHandle streamHandle,
+                           unsigned int     numBytes)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormStreamObject* stream = 
+            static_cast<NormStreamObject*>((NormObject*)streamHandle);
+        result = stream->ReadRelease(numBytes);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamReadRelease()
+
 NORM_API_LINKAGE
 bool NormStreamSeekMsgStart(NormObjectHandle streamHandle)
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
@@ -2587,6 +4762,23 @@ bool NormStreamSeekMsgStart(NormObjectHandle streamHandle)
     return result;
 }  // end NormStreamSeekMsgStart()
 
+NORM_API_LINKAGE
+bool NormStreamReadMsg(NormObjectHandle   streamHandle,
+                       char*              buffer,
+                       unsigned int*      msgLen)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormStreamObject* stream = 
+            static_cast<NormStreamObject*>((NormObject*)streamHandle);
+        result = stream->ReadMsg(buffer, msgLen);
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormStreamReadMsg()
+
 
 NORM_API_LINKAGE
 UINT32 NormStreamGetReadOffset(NormObjectHandle streamHandle)
@@ -2603,7 +4795,7 @@ unsigned int NormStreamGetBufferUsage(NormObjectHandle streamHandle)
 {
     unsigned int usage = 0;
     NormInstance* instance = NormInstance::GetInstanceFromObject(streamHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormStreamObject* stream = 
             static_cast<NormStreamObject*>((NormObject*)streamHandle);
@@ -2671,7 +4863,7 @@ NormSize NormObjectGetBytesPending(NormObjectHandle objectHandle)
     if (NORM_OBJECT_INVALID != objectHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             bytesPending = ((NormSize)((NormObject*)objectHandle)->GetBytesPending().GetOffset());
             instance->dispatcher.ResumeThread();
@@ -2686,7 +4878,7 @@ void NormObjectCancel(NormObjectHandle objectHandle)
     if (NORM_OBJECT_INVALID != objectHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormObject* obj = (NormObject*)objectHandle;
             NormSenderNode* sender = obj->GetSender();
@@ -2706,7 +4898,7 @@ void NormObjectSetUserData(NormObjectHandle objectHandle, const void* userData)
     NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
     if (instance)
     {
-        if (instance->dispatcher.SuspendThread())
+        if (instance->SuspendThread())
         {    
             ((NormObject*)objectHandle)->SetUserData(userData);
             instance->dispatcher.ResumeThread();
@@ -2727,7 +4919,7 @@ void NormObjectRetain(NormObjectHandle objectHandle)
     if (NORM_OBJECT_INVALID != objectHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             ((NormObject*)objectHandle)->Retain();
             instance->dispatcher.ResumeThread();
@@ -2743,7 +4935,7 @@ void NormObjectRelease(NormObjectHandle objectHandle)
     if (NORM_OBJECT_INVALID != objectHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromObject(objectHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             ((NormObject*)objectHandle)->Release();
             instance->dispatcher.ResumeThread();
@@ -2770,13 +4962,56 @@ bool NormFileGetName(NormObjectHandle   fileHandle,
     return result;
 }  // end NormFileGetName()
 
+// Gets the path of a file object, closing a received file first so any
+// pending (buffered or asynchronous) writes are on disk
+static bool NormFileGetArchivePath(NormObjectHandle fileHandle, char* pathBuffer)
+{
+    bool result = false;
+    NormInstance* instance = NormInstance::GetInstanceFromObject(fileHandle);
+    if (instance && instance->SuspendThread())
+    {
+        NormObject* obj = (NormObject*)fileHandle;
+        if (NormObject::FILE == obj->GetType())
+        {
+            NormFileObject* file = static_cast<NormFileObject*>(obj);
+            if (NULL != file->GetSender()) file->CloseFile();
+            strncpy(pathBuffer, file->GetPath(), PATH_MAX);
+            pathBuffer[PATH_MAX - 1] = '\0';
+            result = true;
+        }
+        instance->dispatcher.ResumeThread();
+    }
+    return result;
+}  // end NormFileGetArchivePath()
+
+NORM_API_LINKAGE
+bool NormFileIsArchive(NormObjectHandle fileHandle)
+{
+    char path[PATH_MAX];
+    if (!NormFileGetArchivePath(fileHandle, path)) return false;
+    return NormArchiveReader::IsArchive(path);
+}  // end NormFileIsArchive()
+
+NORM_API_LINKAGE
+unsigned int NormFileUnpackArchive(NormObjectHandle   fileHandle,
+                                   const char*        dirPath)
+{
+    char path[PATH_MAX];
+    if (!NormFileGetArchivePath(fileHandle, path)) return 0;
+    NormArchiveReader archive;
+    if (!archive.Open(path)) return 0;
+    unsigned int count = archive.ExtractAll(dirPath);
+    archive.Close();
+    return count;
+}  // end NormFileUnpackArchive()
+
 NORM_API_LINKAGE
 bool NormFileRename(NormObjectHandle   fileHandle,
                     const char*        fileName)
 {
     bool result = false;
     NormInstance* instance = NormInstance::GetInstanceFromObject(fileHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         // (TBD) verify "fileHandle" is a NORM_FILE ?>??
         NormFileObject* file = 
@@ -2800,7 +5035,7 @@ char* NormDataDetachData(NormObjectHandle dataHandle)
 {
     char* ptr = NULL;
     NormInstance* instance = NormInstance::GetInstanceFromObject(dataHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         NormDataObject* dataObj = static_cast<NormDataObject*>((NormObject*)dataHandle);
         ptr = dataObj->DetachData();
@@ -2851,7 +5086,7 @@ bool NormNodeGetAddress(NormNodeHandle  nodeHandle,
     if (NORM_NODE_INVALID != nodeHandle)
     {
         //NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        //if (instance && instance->dispatcher.SuspendThread())
+        //if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             const ProtoAddress& nodeAddr = node->GetAddress();
@@ -2909,6 +5144,113 @@ double NormNodeGetGrtt(NormNodeHandle nodeHandle)
     }
 }  // end NormNodeGetGrtt()
 
+NORM_API_LINKAGE
+bool NormNodeGetDecoderCacheStats(NormNodeHandle nodeHandle,
+                                  unsigned long* hitCount,
+                                  unsigned long* missCount)
+{
+    bool result = false;
+    if (NORM_NODE_INVALID != nodeHandle)
+    {
+        NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
+        if (instance && instance->SuspendThread())
+        {
+            NormNode* node = (NormNode*)nodeHandle;
+            if (NormNode::SENDER == node->GetType())
+            {
+                unsigned long hits, misses;
+                NormSenderNode* sender = static_cast<NormSenderNode*>(node);
+                result = sender->GetDecoderCacheStats(hits, misses);
+                if (result)
+                {
+                    if (NULL != hitCount) *hitCount = hits;
+                    if (NULL != missCount) *missCount = misses;
+                }
+            }
+            instance->dispatcher.ResumeThread();  
+        }
+    }
+    return result;
+}  // end NormNodeGetDecoderCacheStats()
+
+NORM_API_LINKAGE
+bool NormNodeGetStats(NormNodeHandle nodeHandle,
+                      NormNodeStats* stats)
+{
+    bool result = false;
+    if ((NORM_NODE_INVALID != nodeHandle) && (NULL != stats))
+    {
+        NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
+        if (instance && instance->SuspendThread())
+        {
+            NormNode* node = (NormNode*)nodeHandle;
+            if (NormNode::SENDER == node->GetType())
+            {
+                NormSenderNode* sender = static_cast<NormSenderNode*>(node);
+                stats->rxBytes = (NormSize)sender->RecvBytes();
+                stats->rxGoodputBytes = (NormSize)sender->GoodputBytes();
+                stats->rxSegments = (NormSize)sender->RecvSegmentCount();
+                stats->fecDecodes = (NormSize)sender->DecodeCount();
+                stats->nacksSent = (NormSize)sender->NackCount();
+                stats->nacksSuppressed = (NormSize)sender->SuppressCount();
+                stats->objectsCompleted = (NormSize)sender->CompletionCount();
+                stats->objectsPending = (NormSize)sender->PendingCount();
+                stats->objectsFailed = (NormSize)sender->FailureCount();
+                // ("ResyncCount()" is really "SyncCount()")
+                stats->resyncs = (NormSize)(sender->ResyncCount() ? sender->ResyncCount() - 1 : 0);
+                stats->bufferPeak = (NormSize)sender->PeakBufferUsage();
+                stats->bufferOverruns = (NormSize)sender->BufferOverunCount();
+                stats->streamBufferPeak = (NormSize)sender->PeakStreamBufferUsage();
+                stats->streamBufferOverruns = (NormSize)sender->StreamBufferOverunCount();
+                stats->grtt = sender->GetGrttEstimate();
+                stats->loss = sender->LossEstimate();
+                stats->senderRate = 8.0 * sender->GetSendRate();
+                result = true;
+            }
+            instance->dispatcher.ResumeThread();  
+        }
+    }
+    return result;
+}  // end NormNodeGetStats()
+
+NORM_API_LINKAGE
+bool NormNodeGetLatencyStats(NormNodeHandle    nodeHandle,
+                             NormLatencyType   latencyType,
+                             NormLatencyStats* stats)
+{
+    bool result = false;
+    if ((NORM_NODE_INVALID != nodeHandle) && (NULL != stats))
+    {
+        NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
+        if (instance && instance->SuspendThread())
+        {
+            NormNode* node = (NormNode*)nodeHandle;
+            if (NormNode::SENDER == node->GetType())
+            {
+                NormSenderNode* sender = static_cast<NormSenderNode*>(node);
+                result = true;
+                switch (latencyType)
+                {
+                    case NORM_LATENCY_OBJECT:
+                        NormGetHistogramStats(sender->GetObjectLatency(), stats);
+                        break;
+                    case NORM_LATENCY_REPAIR:
+                        NormGetHistogramStats(sender->GetRepairLatency(), stats);
+                        break;
+                    case NORM_LATENCY_DECODE:
+                        NormGetHistogramStats(sender->GetDecodeLatency(), stats);
+                        break;
+                    default:
+                        result = false;
+                        break;
+                }
+            }
+            instance->dispatcher.ResumeThread();  
+        }
+    }
+    return result;
+}  // end NormNodeGetLatencyStats()
+
 NORM_API_LINKAGE
 bool NormNodeGetCommand(NormNodeHandle nodeHandle,
                         char*          cmdBuffer,
@@ -2918,7 +5260,7 @@ bool NormNodeGetCommand(NormNodeHandle nodeHandle,
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             if (NormNode::SENDER == node->GetType())
@@ -2941,7 +5283,7 @@ bool NormNodeSendAckEx(NormNodeHandle nodeHandle,
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             if (NormNode::SENDER == node->GetType())
@@ -2964,7 +5306,7 @@ bool NormNodeGetWatermarkEx(NormNodeHandle nodeHandle,
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             if (NormNode::SENDER == node->GetType())
@@ -2984,7 +5326,7 @@ void NormNodeFreeBuffers(NormNodeHandle nodeHandle)
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             if (NormNode::SENDER == node->GetType())
@@ -3005,7 +5347,7 @@ void NormNodeDelete(NormNodeHandle nodeHandle)
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             NormNode* node = (NormNode*)nodeHandle;
             if (NormNode::SENDER == node->GetType())
@@ -3026,7 +5368,7 @@ void NormNodeRetain(NormNodeHandle nodeHandle)
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             ((NormNode*)nodeHandle)->Retain();
             instance->dispatcher.ResumeThread();
@@ -3040,7 +5382,7 @@ void NormNodeRelease(NormNodeHandle nodeHandle)
     if (NORM_NODE_INVALID != nodeHandle)
     {
         NormInstance* instance = NormInstance::GetInstanceFromNode(nodeHandle);
-        if (instance && instance->dispatcher.SuspendThread())
+        if (instance && instance->SuspendThread())
         {
             ((NormNode*)nodeHandle)->Release();
             instance->dispatcher.ResumeThread();
@@ -3074,7 +5416,7 @@ UINT32 NormCountCompletedObjects(NormSessionHandle sessionHandle)
     UINT32 result = 0;
     NormSession* session = (NormSession*)sessionHandle;
 	NormInstance* instance = NormInstance::GetInstanceFromSession(sessionHandle);
-    if (instance && instance->dispatcher.SuspendThread())
+    if (instance && instance->SuspendThread())
     {
         result = instance->CountCompletedObjects(session);
         instance->dispatcher.ResumeThread();
@@ -9,6 +9,7 @@
 #include "protokit.h"
 #include "normSession.h"
 #include "normPostProcess.h"
+#include "normArchive.h"
 
 #include <stdio.h>   // for stdout/stderr printouts
 #include <stdlib.h>
@@ -90,6 +91,9 @@ class NormApp : public NormController, public ProtoApp
                         class NormObject*     object);
         
         bool OnIntervalTimeout(ProtoTimer& theTimer);
+        NormFileObject* QueueTxArchive(const char* fileName, const char* fileNameInfo, unsigned int infoLen);
+        void GetTxFileInfo(const char* fileName, char* infoBuffer);
+        bool UnpackRxArchive(const char* archivePath);
         void OnControlEvent(ProtoSocket& theSocket, ProtoSocket::Event theEvent);
     
         static const char* const cmd_list[];
@@ -164,6 +168,8 @@ class NormApp : public NormController, public ProtoApp
         double              group_size;
         unsigned long       tx_buffer_size; // bytes
         unsigned int        tx_sock_buffer_size;
+        unsigned long       tx_parity_cache;  // bytes (zero disables)
+        bool                tx_digest;
         unsigned long       tx_cache_min;
         unsigned long       tx_cache_max;
         NormObjectSize      tx_cache_size;        
@@ -187,6 +193,12 @@ class NormApp : public NormController, public ProtoApp
         bool                tx_repeat_clear;
         int                 tx_requeue;       // master requeue value
         int                 tx_requeue_count; // current requeue counter vale
+        // "archive" option (files up to "tx_archive_max" bytes are packed
+        // together into archive objects of up to ARCHIVE_SIZE_MAX bytes)
+        enum {ARCHIVE_SIZE_MAX = 8*1024*1024, ARCHIVE_COUNT_MAX = 4096};
+        unsigned long       tx_archive_max;
+        char                tx_archive_path[PATH_MAX];  // built archive pending enqueue
+        char                tx_archive_next[PATH_MAX];  // file that ended the last archive
         ProtoTimer          interval_timer;
         char*               acking_node_list; // comma-delimited string
         bool                acking_flushes;
@@ -197,6 +209,7 @@ class NormApp : public NormController, public ProtoApp
         unsigned int        rx_sock_buffer_size;
         NormFileList        rx_file_cache;
         char*               rx_cache_path;
+        bool                rx_resume;  // journal rx files (under "rx_cache_path") for restarts
         NormPostProcessor*  post_processor;
         bool                unicast_nacks;
         bool                silent_receiver;
@@ -206,6 +219,8 @@ class NormApp : public NormController, public ProtoApp
         bool                rx_persistent;
         bool                process_aborted_files;
         bool                preallocate_sender;
+        unsigned int        preset_count;     // how many remote senders to preallocate
+        bool                memory_prefault;
         NormSenderNode::RepairBoundary repair_boundary;
         
         // Debug parameters
@@ -241,14 +256,14 @@ NormApp::NormApp()
    node_id(NORM_NODE_ANY), segment_size(1024), ndata(32), nparity(16), auto_parity(0), extra_parity(0),
    backoff_factor(NormSession::DEFAULT_BACKOFF_FACTOR), grtt_estimate(NormSession::DEFAULT_GRTT_ESTIMATE), 
    grtt_probing_mode(NormSession::PROBE_ACTIVE), group_size(NormSession::DEFAULT_GSIZE_ESTIMATE),
-   tx_buffer_size(1024*1024), tx_sock_buffer_size(0), tx_cache_min(8), tx_cache_max(256), tx_cache_size((UINT32)20*1024*1024),
+   tx_buffer_size(1024*1024), tx_sock_buffer_size(0), tx_parity_cache(0), tx_digest(false), tx_cache_min(8), tx_cache_max(256), tx_cache_size((UINT32)20*1024*1024),
    tx_file_info(true), tx_one_shot(false), tx_ack_shot(false), tx_file_queued(false),
    tx_robust_factor(NormSession::DEFAULT_ROBUST_FACTOR), tx_object_interval(0.0), tx_repeat_count(0), 
-   tx_repeat_interval(2.0), tx_repeat_clear(true), tx_requeue(0), tx_requeue_count(0), acking_node_list(NULL), 
+   tx_repeat_interval(2.0), tx_repeat_clear(true), tx_requeue(0), tx_requeue_count(0), tx_archive_max(0), acking_node_list(NULL), 
    acking_flushes(false), watermark_pending(false), rx_buffer_size(1024*1024), rx_sock_buffer_size(0),
-   rx_cache_path(NULL), post_processor(NULL), unicast_nacks(false), silent_receiver(false), 
+   rx_cache_path(NULL), rx_resume(false), post_processor(NULL), unicast_nacks(false), silent_receiver(false), 
    low_delay(false), realtime(false), rx_robust_factor(NormSession::DEFAULT_ROBUST_FACTOR), rx_persistent(true), process_aborted_files(false),
-   preallocate_sender(false), repair_boundary(NormSenderNode::BLOCK_BOUNDARY), tracing(false), tx_loss(0.0), rx_loss(0.0)
+   preallocate_sender(false), preset_count(1), memory_prefault(false), repair_boundary(NormSenderNode::BLOCK_BOUNDARY), tracing(false), tx_loss(0.0), rx_loss(0.0)
 {
     control_pipe.SetListener(this, &NormApp::OnControlEvent);
     control_pipe.SetNotifier(&GetSocketNotifier());
@@ -261,6 +276,7 @@ NormApp::NormApp()
     interval_timer.SetRepeat(0);
     
     tx_file_name[0] = '\0';
+    tx_archive_path[0] = tx_archive_next[0] = '\0';
     
     struct timeval currentTime;
     ProtoSystemTime(currentTime);
@@ -347,6 +363,7 @@ const char* const NormApp::cmd_list[] =
     "+repeatcount",  // How many times to repeat the file/directory list tx
     "+rinterval",    // Interval (sec) between file/directory list repeats
     "+requeue",      // <count> how many times files are retransmitted w/ same objId
+    "+archive",      // <bytes> pack files up to this size together into archive objects
     "+boundary",     // 'block' or 'file' to set NORM_REPAIR_BOUNDARY (default is 'block')
     "-oneshot",      // Transmit file(s), exiting upon TX_FLUSH_COMPLETED
     "-ackshot",      // Transmit file(s), exiting upon TX_WATERMARK_COMPLETED
@@ -355,6 +372,7 @@ const char* const NormApp::cmd_list[] =
     "-ackflush",     // when set, acking completion truncates end-of-transmission flushing
     "+id",           // set the local NormNodeId to a specific value
     "+rxcachedir",   // recv file cache directory
+    "-rxresume",     // journal partial receive files so a restarted receiver resumes them
     "+segment",      // payload segment size (bytes)
     "+block",        // User data packets per FEC coding block (blockSize)
     "+parity",       // FEC packets calculated per coding block (nparity)
@@ -366,6 +384,8 @@ const char* const NormApp::cmd_list[] =
     "+gsize",        // Set sender's group size estimate
     "+txbuffer",     // Size of sender's buffer
     "+txsockbuffer", // tx socket buffer size
+    "+txparitycache",// <bytes> of block parity kept so repeated content isn't re-encoded
+    "-txdigest",     // send a content digest with each file/data object for receivers to verify
     "+txcachebounds",// <countMin:countMax:sizeMax> limits on sender tx object caching
     "+txrobustfactor", // integer tx robust factor
     "+rxbuffer",     // Size receiver allocates for buffering each sender
@@ -373,6 +393,8 @@ const char* const NormApp::cmd_list[] =
     "-unicastNacks", // unicast instead of multicast feedback messages
     "-silentReceiver", // "silent" (non-nacking) receiver (EMCON mode) (must set for sender too)
     "-presetSender",   // causes receiver to preallocate resources for remote sender w/ segmentSize, block, and parity params
+    "+presetCount",  // <count> of remote senders to preallocate resources for (implies "presetSender")
+    "-prefault",     // touch preallocated buffer memory at startup so first packets don't page fault
     "-lowDelay",     // for silent receivers only, delivers data/files to app sooner\n"
     "-realtime",     // for NACKing (non-silent) receivers, flips buffer mgmnt to favor low latency over reliability
     "+rxpersist",    // "off" or "on" to make receiver keep state on sender forever ("on" by default)
@@ -420,6 +442,7 @@ void NormApp::ShowHelp()
         "   +repeatcount,  // How many times to repeat the file/directory list tx\n"
         "   +rinterval,    // Interval (sec) between file/directory list repeats\n"
         "   +requeue,      // <count> how many times files are retransmitted w/ same objId\n"
+        "   +archive,      // <bytes> pack files up to this size together into archive objects\n"
         "   +boundary      // 'block' or 'file' to set NORM_REPAIR_BOUNDARY (default is 'block')\n"
         "   -oneshot,      // Exit upon sender TX_FLUSH_COMPLETED event (sender exits after transmission)\n"
         "   -ackshot,      // Exit upon sender TX_WATERMARK_COMPLETED event (sender exits after transmission)\n"
@@ -428,6 +451,7 @@ void NormApp::ShowHelp()
         "   -ackflush,     // when set, acking completion truncates flushing\n"
         "   +id,           // set the local NormNodeId to a specific value\n"
         "   +rxcachedir,   // recv file cache directory\n"
+        "   -rxresume,     // journal partial receive files so a restarted receiver resumes them\n"
         "   +segment,      // payload segment size (bytes)\n"
         "   +block,        // User data packets per FEC coding block (blockSize)\n"
         "   +parity,       // FEC packets calculated per coding block (nparity)\n"
@@ -439,12 +463,16 @@ void NormApp::ShowHelp()
         "   +gsize,        // Set sender's group size estimate\n"
         "   +txbuffer,     // Size of sender's buffer\n"
         "   +txcachebounds,// <countMin:countMax:sizeMax> limits on sender tx object caching\n"
+        "   +txparitycache,// <bytes> of block parity kept so repeated content isn't re-encoded\n"
+        "   -txdigest,     // send a content digest with each file/data object for receivers to verify\n"
         "   +rxbuffer,     // Size receiver allocates for buffering each sender\n"
         "   +rxsockbuffer, // Optional recv socket buffer size.\n"
         "   -unicastNacks, // unicast instead of multicast feedback messages\n"
         "   -silentReceiver, // silent (non-nacking) receiver (EMCON mode) (must set for sender too)\n"
         "   -lowDelay,     // for silent receivers only, delivers data/files to app sooner\n"
         "   -presetSender, // causes receiver to preallocate resources for remote sender w/ segmentSize, block, and parity params\n"
+        "   +presetCount,  // <count> of remote senders to preallocate resources for (implies 'presetSender')\n"
+        "   -prefault,     // touch preallocated buffer memory at startup so first packets don't page fault\n"
         "   -realtime,     // for NACKing (non-silent) receivers, flips buffer mgmnt to favor low latency over reliability\n"
         "   +rxpersist,    // 'off' or 'on' to make receiver keep state on sender forever ('on' by default)\n"
         "   -saveAborts,   // save (and possibly post-process) aborted receive files\n"
@@ -911,6 +939,10 @@ bool NormApp::OnCommand(const char* cmd, const char* val)
     {
         tx_requeue = tx_requeue_count = atoi(val); 
     } 
+    else if (!strncmp("archive", cmd, len))
+    {
+        tx_archive_max = atol(val);
+    }
     else if (!strncmp("boundary", cmd, len))
     {
         if (0 == strcmp("block", val))
@@ -991,6 +1023,10 @@ bool NormApp::OnCommand(const char* cmd, const char* val)
         rx_cache_path[length-2] = PROTO_PATH_DELIMITER;
         rx_cache_path[length-1] = '\0';
     }
+    else if (!strncmp("rxresume", cmd, len))
+    {
+        rx_resume = true;
+    }
     else if (!strncmp("segment", cmd, len))
     {
         int segmentSize = atoi(val);
@@ -1150,6 +1186,20 @@ bool NormApp::OnCommand(const char* cmd, const char* val)
 	    if (session && (tx_sock_buffer_size))
 	    	session->SetTxSocketBuffer(tx_sock_buffer_size);
     }
+    else if (!strncmp("txparitycache", cmd, len))
+    {
+        if (1 != sscanf(val, "%lu", &tx_parity_cache))
+        {
+            PLOG(PL_FATAL, "NormApp::OnCommand(txparitycache) invalid value!\n");
+            return false;
+        }
+        if (session) session->SetTxParityCache(tx_parity_cache);
+    }
+    else if (!strncmp("txdigest", cmd, len))
+    {
+        tx_digest = true;
+        if (session) session->SetTxDigest(true);
+    }
     else if (!strncmp("unicastNacks", cmd, len))
     {
         unicast_nacks = true;
@@ -1168,6 +1218,20 @@ bool NormApp::OnCommand(const char* cmd, const char* val)
     {
         preallocate_sender = true;
     }
+    else if (!strncmp("presetCount", cmd, len))
+    {
+        if ((1 != sscanf(val, "%u", &preset_count)) || (0 == preset_count))
+        {
+            PLOG(PL_FATAL, "NormApp::OnCommand(presetCount) invalid value!\n");
+            return false;
+        }
+        preallocate_sender = true;
+    }
+    else if (!strncmp("prefault", cmd, len))
+    {
+        memory_prefault = true;
+        if (session) session->SetMemoryPrefault(true);
+    }
     else if (!strncmp("lowDelay", cmd, len))
     {
         low_delay = true;
@@ -1630,6 +1694,21 @@ void NormApp::Notify(NormController::Event event,
             PLOG(PL_DEBUG, "NormApp::Notify(TX_OBJECT_SENT) ...\n");
             break;
             
+        case TX_OBJECT_PURGED:
+            PLOG(PL_DEBUG, "NormApp::Notify(TX_OBJECT_PURGED) ...\n");
+            // Remove our temporary archive files once they're done with
+            if ((NULL != object) && (NormObject::FILE == object->GetType()) &&
+                (tx_archive_path == object->GetUserData()))
+            {
+                NormFileObject* file = static_cast<NormFileObject*>(object);
+                char path[PATH_MAX];
+                strncpy(path, file->GetPath(), PATH_MAX);
+                path[PATH_MAX - 1] = '\0';
+                file->CloseFile();
+                NormFile::Unlink(path);
+            }
+            break;
+            
         case TX_FLUSH_COMPLETED:
             PLOG(PL_DEBUG, "NormApp::Notify(TX_FLUSH_COMPLETED) ...\n");
             if (tx_one_shot)
@@ -1992,7 +2071,18 @@ void NormApp::Notify(NormController::Event event,
                 {
                     const char* filePath = static_cast<NormFileObject*>(object)->GetPath();
                     //DMSG(0, "norm: Completed rx file: %s\n", filePath);
-                    if (post_processor->IsEnabled())
+                    // (flushes any pending writes so the content can be read)
+                    static_cast<NormFileObject*>(object)->CloseFile();
+                    if (NormArchiveReader::IsArchive(filePath))
+                    {
+                        // Small files packed by an "archive" sender
+                        char archivePath[PATH_MAX];
+                        strncpy(archivePath, filePath, PATH_MAX);
+                        archivePath[PATH_MAX - 1] = '\0';
+                        if (!UnpackRxArchive(archivePath))
+                            PLOG(PL_ERROR, "norm: error unpacking archive \"%s\"\n", archivePath);
+                    }
+                    else if (post_processor->IsEnabled())
                     {
                         if (!post_processor->ProcessFile(filePath))
                         {
@@ -2041,8 +2131,9 @@ void NormApp::Notify(NormController::Event event,
                             }  
                         }
                     }
-                    else
+                    else if (!rx_resume)
                     {
+                        // (journaled partial files are kept for a resumed reception)
                         NormFile::Unlink(filePath);
                     }
                     break;
@@ -2123,6 +2214,18 @@ bool NormApp::OnIntervalTimeout(ProtoTimer& theTimer)
                 tx_file_name[0] = '\0'; // reset so next file will be fetched
             }
         }
+        if ((NULL == obj) && (('\0' != tx_archive_path[0]) || 
+                              ((0 != tx_archive_max) && (NormFile::GetSize(fileName) <= (NormFile::Offset)tx_archive_max))))
+        {
+            // Pack this file and any small ones following it into an archive object
+            // (empty files can be sent this way)
+            if (NULL == (obj = QueueTxArchive(fileName, fileNameInfo, (unsigned int)len)))
+            {
+                // (flow control, as below, with "tx_archive_path" kept for re-attempt)
+                if (interval_timer.IsActive()) interval_timer.Deactivate();
+                return false;
+            }
+        }
         if (NULL == obj)
         {
             // This makes sure it's not an empty file
@@ -2250,6 +2353,129 @@ bool NormApp::OnIntervalTimeout(ProtoTimer& theTimer)
     return true;
 }  // end NormApp::OnIntervalTimeout()
 
+// Gets the (normalized '/' delimited) file name info conveyed for "fileName"
+// relative to the current "tx_file_list" base path
+void NormApp::GetTxFileInfo(const char* fileName, char* infoBuffer)
+{
+    char pathName[PATH_MAX];
+    tx_file_list.GetCurrentBasePath(pathName);
+    size_t len = strlen(pathName);
+    len = MIN(len, PATH_MAX);
+    size_t maxLen = PATH_MAX - 1;
+    strncpy(infoBuffer, fileName + len, maxLen);
+    infoBuffer[maxLen] = '\0';
+    for (char* ptr = infoBuffer; '\0' != *ptr; ptr++)
+    {
+        if (PROTO_PATH_DELIMITER == *ptr) *ptr = '/';
+    }
+}  // end NormApp::GetTxFileInfo()
+
+// Packs "fileName" and the small files following it in "tx_file_list" into
+// a temporary archive file and enqueues it.  Returns NULL if the enqueue
+// was blocked by flow control (the archive is kept for re-attempt).
+NormFileObject* NormApp::QueueTxArchive(const char* fileName, const char* fileNameInfo, unsigned int infoLen)
+{
+    if ('\0' == tx_archive_path[0])
+    {
+        NormArchiveWriter archive;
+        char name[PATH_MAX];
+        infoLen = MIN(infoLen, PATH_MAX - 1);
+        strncpy(name, fileNameInfo, infoLen);
+        name[infoLen] = '\0';
+        tx_archive_next[0] = '\0';
+        bool result = archive.OpenTemp(tx_archive_path) && archive.AddFile(fileName, name);
+        char nextName[PATH_MAX];
+        while (result &&
+               (archive.GetCount() < ARCHIVE_COUNT_MAX) && 
+               (archive.GetSize() < ARCHIVE_SIZE_MAX) &&
+               tx_file_list.GetNextFile(nextName))
+        {
+            if (NormFile::GetSize(nextName) > (NormFile::Offset)tx_archive_max)
+            {
+                // Too big, so it's sent next on its own
+                strcpy(tx_archive_next, nextName);
+                break;
+            }
+            GetTxFileInfo(nextName, name);
+            if (!archive.AddFile(nextName, name))
+            {
+                if (!archive.IsOpen())
+                {
+                    result = false;  // (write error, the archive was removed)
+                    break;
+                }
+                PLOG(PL_WARN, "norm warning: file \"%s\" could not be archived\n", nextName);
+            }
+        }
+        if (result) result = archive.Close();
+        if (!result)
+        {
+            // Send the first file on its own (others already packed are skipped this pass)
+            PLOG(PL_ERROR, "NormApp::QueueTxArchive() error building archive, sending \"%s\" alone\n", fileName);
+            archive.Abort();
+            tx_archive_path[0] = '\0';
+            NormFileObject* obj = session->QueueTxFile(fileName, tx_file_info ? fileNameInfo : NULL, 
+                                                       tx_file_info ? (UINT16)infoLen : 0);
+            if (NULL != obj)
+            {
+                strcpy(tx_file_name, tx_archive_next);
+                tx_archive_next[0] = '\0';
+            }
+            return obj;
+        }
+        PLOG(PL_INFO, "norm: packed %u files into archive \"%s\"\n", archive.GetCount(), tx_archive_path);
+    }
+    // The archive's temporary file name is its info
+    const char* archiveName = strrchr(tx_archive_path, PROTO_PATH_DELIMITER);
+    archiveName = (NULL != archiveName) ? (archiveName + 1) : tx_archive_path;
+    UINT16 archiveNameLen = (UINT16)strlen(archiveName);
+    NormFileObject* obj = session->QueueTxFile(tx_archive_path, tx_file_info ? archiveName : NULL, 
+                                               tx_file_info ? archiveNameLen : 0);
+    if (NULL == obj)
+    {
+        PLOG(PL_DEBUG, "NormApp::QueueTxArchive() error queuing tx archive: %s\n", tx_archive_path);
+        return NULL;
+    }
+    obj->SetUserData(tx_archive_path);  // marks it for removal when purged
+    tx_archive_path[0] = '\0';
+    // The file that ended the archive (if any) is next
+    strcpy(tx_file_name, tx_archive_next);
+    tx_archive_next[0] = '\0';
+    return obj;
+}  // end NormApp::QueueTxArchive()
+
+// Unpacks a received archive into the "rx_cache_path", post-processing each
+// of its files, and removes the archive
+bool NormApp::UnpackRxArchive(const char* archivePath)
+{
+    NormArchiveReader archive;
+    if (!archive.Open(archivePath)) return false;
+    char name[PATH_MAX];
+    NormFile::Offset size;
+    unsigned int count = 0;
+    while (archive.GetNextEntry(name, size))
+    {
+        char path[PATH_MAX];
+        if (!NormArchiveReader::IsSafeName(name) || 
+            !NormArchiveReader::MakePath(path, rx_cache_path, name))
+        {
+            PLOG(PL_WARN, "norm warning: skipping invalid archive file name \"%s\"\n", name);
+            continue;
+        }
+        if (!archive.Extract(path)) continue;
+        count++;
+        if (post_processor->IsEnabled())
+        {
+            if (!post_processor->ProcessFile(path))
+                PLOG(PL_ERROR, "norm: post processing error\n");
+        }
+    }
+    archive.Close();
+    PLOG(PL_INFO, "norm: unpacked %u files from archive \"%s\"\n", count, archivePath);
+    NormFile::Unlink(archivePath);
+    return true;
+}  // end NormApp::UnpackRxArchive()
+
 bool NormApp::OnStartup(int argc, const char*const* argv)
 {
     if (argc < 3) 
@@ -2335,6 +2561,7 @@ bool NormApp::OnStartup(int argc, const char*const* argv)
             session->SenderSetGroupSize(group_size);
             session->SetTxRobustFactor(tx_robust_factor);
             session->SetTxCacheBounds(tx_cache_size, tx_cache_min, tx_cache_max);
+            session->SetMemoryPrefault(memory_prefault);
             if (!AddAckingNodes(acking_node_list))
             {
                 PLOG(PL_FATAL, "NormApp::OnStartup() error: bad acking node list\n");
@@ -2353,6 +2580,9 @@ bool NormApp::OnStartup(int argc, const char*const* argv)
             }              
 	        if (tx_sock_buffer_size > 0)
 		        session->SetTxSocketBuffer(tx_sock_buffer_size);
+            if (tx_parity_cache > 0)
+                session->SetTxParityCache(tx_parity_cache);
+            session->SetTxDigest(tx_digest);
             session->SenderSetAutoParity(auto_parity);
             session->SenderSetExtraParity(extra_parity);
             if (input || msg_test)
@@ -2382,7 +2612,8 @@ bool NormApp::OnStartup(int argc, const char*const* argv)
             session->ReceiverSetSilent(silent_receiver);
             if (preallocate_sender)
             {
-                if (!session->PreallocateRemoteSender(rx_buffer_size, segment_size, ndata, nparity))
+                session->SetMemoryPrefault(memory_prefault);
+                if (!session->PreallocateRemoteSenders(preset_count, rx_buffer_size, segment_size, ndata, nparity))
                 {
                     PLOG(PL_FATAL, "NormApp::OnStartup() remote sender preallocation error!\n");
                     session_mgr.Destroy();
@@ -2397,6 +2628,16 @@ bool NormApp::OnStartup(int argc, const char*const* argv)
                 session->RcvrSetRealtime(true);           
             session->SetRxRobustFactor(rx_robust_factor);
             session->ReceiverSetDefaultRepairBoundary(repair_boundary);
+            if (rx_resume && (NULL != rx_cache_path))
+            {
+                char journalDir[PATH_MAX];
+                if ((strlen(rx_cache_path) + 16) < PATH_MAX)
+                {
+                    strcpy(journalDir, rx_cache_path);
+                    strcat(journalDir, ".normJournal");
+                    session->SetRxFileJournal(journalDir);
+                }
+            }
             if (!session->StartReceiver(rx_buffer_size))
             {
                 PLOG(PL_FATAL, "NormApp::OnStartup() start receiver error!\n");
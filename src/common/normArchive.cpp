@@ -0,0 +1,395 @@
+#include "normArchive.h"
+
+#include <string.h>
+#include <stdlib.h>  // for getenv(), mkstemp()
+
+const char NormArchiveWriter::MAGIC[8] = {'N', 'O', 'R', 'M', 'A', 'R', 'C', '1'};
+
+static void NormArchivePut64(char* ptr, UINT64 value)
+{
+    UINT32 word = htonl((UINT32)(value >> 32));
+    memcpy(ptr, &word, 4);
+    word = htonl((UINT32)(value & 0xffffffff));
+    memcpy(ptr + 4, &word, 4);
+}  // end NormArchivePut64()
+
+static UINT64 NormArchiveGet64(const char* ptr)
+{
+    UINT32 hi, lo;
+    memcpy(&hi, ptr, 4);
+    memcpy(&lo, ptr + 4, 4);
+    return ((((UINT64)ntohl(hi)) << 32) | (UINT64)ntohl(lo));
+}  // end NormArchiveGet64()
+
+NormArchiveWriter::NormArchiveWriter()
+ : offset(0), file_count(0), index_buffer(NULL), index_len(0), index_max(0)
+{
+    file_path[0] = '\0';
+}
+
+NormArchiveWriter::~NormArchiveWriter()
+{
+    if (file.IsOpen()) Abort();
+    if (NULL != index_buffer) delete[] index_buffer;
+}
+
+bool NormArchiveWriter::Open(const char* path)
+{
+    if (file.IsOpen()) Abort();
+    if (!file.Open(path, O_WRONLY | O_CREAT | O_TRUNC))
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::Open() error opening \"%s\": %s\n", path, GetErrorString());
+        return false;
+    }
+    strncpy(file_path, path, PATH_MAX);
+    file_path[PATH_MAX - 1] = '\0';
+    if (file.Write(MAGIC, 8) != 8)
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::Open() write error: %s\n", GetErrorString());
+        Abort();
+        return false;
+    }
+    offset = 8;
+    file_count = 0;
+    index_len = 0;
+    return true;
+}  // end NormArchiveWriter::Open()
+
+bool NormArchiveWriter::OpenTemp(char* pathBuffer)
+{
+#ifdef WIN32
+    char dirPath[MAX_PATH];
+    if ((0 == GetTempPathA(MAX_PATH, dirPath)) ||
+        (0 == GetTempFileNameA(dirPath, "nar", 0, pathBuffer)))
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::OpenTemp() GetTempFileName() error: %s\n", GetErrorString());
+        return false;
+    }
+#else
+    const char* dirPath = getenv("TMPDIR");
+    if ((NULL == dirPath) || ('\0' == dirPath[0])) dirPath = "/tmp";
+    size_t len = strlen(dirPath);
+    if ((len + 20) > PATH_MAX)
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::OpenTemp() error: temporary directory path too long\n");
+        return false;
+    }
+    strcpy(pathBuffer, dirPath);
+    if (PROTO_PATH_DELIMITER != pathBuffer[len - 1]) pathBuffer[len++] = PROTO_PATH_DELIMITER;
+    strcpy(pathBuffer + len, "normArchiveXXXXXX");
+    int fd = mkstemp(pathBuffer);
+    if (fd < 0)
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::OpenTemp() mkstemp() error: %s\n", GetErrorString());
+        return false;
+    }
+    close(fd);
+#endif // if/else WIN32
+    if (Open(pathBuffer)) return true;
+    NormFile::Unlink(pathBuffer);
+    return false;
+}  // end NormArchiveWriter::OpenTemp()
+
+bool NormArchiveWriter::AddFile(const char* path, const char* name)
+{
+    if (!file.IsOpen()) return false;
+    size_t nameLen = strlen(name);
+    if ((0 == nameLen) || (nameLen > 0xffff))
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::AddFile() error: invalid name \"%s\"\n", name);
+        return false;
+    }
+    // Make sure the index has room for the entry
+    unsigned int entryLen = 18 + (unsigned int)nameLen;
+    if ((index_len + entryLen) > index_max)
+    {
+        unsigned int newMax = 2*index_max;
+        if (newMax < (index_len + entryLen)) newMax = index_len + entryLen + 4096;
+        char* newBuffer = new char[newMax];
+        if (NULL == newBuffer)
+        {
+            PLOG(PL_ERROR, "NormArchiveWriter::AddFile() new index buffer error: %s\n", GetErrorString());
+            return false;
+        }
+        if (NULL != index_buffer)
+        {
+            memcpy(newBuffer, index_buffer, index_len);
+            delete[] index_buffer;
+        }
+        index_buffer = newBuffer;
+        index_max = newMax;
+    }
+    NormFile inFile;
+    if (!inFile.Open(path, O_RDONLY))
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::AddFile() error opening \"%s\": %s\n", path, GetErrorString());
+        return false;
+    }
+    // Copy the file content into the archive
+    // (NormFile::Read() fails short reads, so exact chunks are read)
+    NormFile::Offset size = inFile.GetSize();
+    NormFile::Offset remaining = size;
+    char buffer[65536];
+    while (remaining > 0)
+    {
+        size_t len = (remaining < 65536) ? (size_t)remaining : 65536;
+        if (inFile.Read(buffer, len) != len)
+        {
+            PLOG(PL_ERROR, "NormArchiveWriter::AddFile() error reading \"%s\"\n", path);
+            inFile.Close();
+            Abort();  // (the archive has content not in its index)
+            return false;
+        }
+        if (file.Write(buffer, len) != len)
+        {
+            PLOG(PL_ERROR, "NormArchiveWriter::AddFile() write error: %s\n", GetErrorString());
+            inFile.Close();
+            Abort();
+            return false;
+        }
+        remaining -= len;
+    }
+    inFile.Close();
+    char* ptr = index_buffer + index_len;
+    NormArchivePut64(ptr, (UINT64)offset);
+    NormArchivePut64(ptr + 8, (UINT64)size);
+    UINT16 len16 = htons((UINT16)nameLen);
+    memcpy(ptr + 16, &len16, 2);
+    memcpy(ptr + 18, name, nameLen);
+    index_len += entryLen;
+    offset += size;
+    file_count++;
+    return true;
+}  // end NormArchiveWriter::AddFile()
+
+bool NormArchiveWriter::Close()
+{
+    if (!file.IsOpen()) return false;
+    char trailer[TRAILER_SIZE];
+    NormArchivePut64(trailer, (UINT64)offset);
+    UINT32 count = htonl(file_count);
+    memcpy(trailer + 8, &count, 4);
+    memcpy(trailer + 12, MAGIC, 8);
+    if (((0 != index_len) && (file.Write(index_buffer, index_len) != index_len)) ||
+        (file.Write(trailer, TRAILER_SIZE) != TRAILER_SIZE))
+    {
+        PLOG(PL_ERROR, "NormArchiveWriter::Close() write error: %s\n", GetErrorString());
+        Abort();
+        return false;
+    }
+    file.Close();
+    return true;
+}  // end NormArchiveWriter::Close()
+
+void NormArchiveWriter::Abort()
+{
+    if (file.IsOpen())
+    {
+        file.Close();
+        NormFile::Unlink(file_path);
+    }
+    offset = 0;
+    file_count = 0;
+    index_len = 0;
+}  // end NormArchiveWriter::Abort()
+
+
+NormArchiveReader::NormArchiveReader()
+ : index_offset(0), file_count(0), index_buffer(NULL), index_len(0), index_pos(0),
+   entry_offset(0), entry_size(0)
+{
+}
+
+NormArchiveReader::~NormArchiveReader()
+{
+    Close();
+}
+
+bool NormArchiveReader::IsArchive(const char* path)
+{
+    // (checks both the leading and trailing magic)
+    NormFile::Offset size = NormFile::GetSize(path);
+    if (size < (8 + NormArchiveWriter::TRAILER_SIZE)) return false;
+    NormFile theFile;
+    if (!theFile.Open(path, O_RDONLY)) return false;
+    char magic[8];
+    bool result = (8 == theFile.Read(magic, 8)) && (0 == memcmp(magic, NormArchiveWriter::MAGIC, 8)) &&
+                  theFile.Seek(size - 8) && (8 == theFile.Read(magic, 8)) &&
+                  (0 == memcmp(magic, NormArchiveWriter::MAGIC, 8));
+    theFile.Close();
+    return result;
+}  // end NormArchiveReader::IsArchive()
+
+bool NormArchiveReader::Open(const char* path)
+{
+    Close();
+    if (!file.Open(path, O_RDONLY))
+    {
+        PLOG(PL_ERROR, "NormArchiveReader::Open() error opening \"%s\": %s\n", path, GetErrorString());
+        return false;
+    }
+    NormFile::Offset size = file.GetSize();
+    char trailer[NormArchiveWriter::TRAILER_SIZE];
+    if ((size < (8 + NormArchiveWriter::TRAILER_SIZE)) ||
+        !file.Seek(size - NormArchiveWriter::TRAILER_SIZE) ||
+        (NormArchiveWriter::TRAILER_SIZE != file.Read(trailer, NormArchiveWriter::TRAILER_SIZE)) ||
+        (0 != memcmp(trailer + 12, NormArchiveWriter::MAGIC, 8)))
+    {
+        PLOG(PL_ERROR, "NormArchiveReader::Open() error: \"%s\" is not an archive\n", path);
+        Close();
+        return false;
+    }
+    index_offset = (NormFile::Offset)NormArchiveGet64(trailer);
+    UINT32 count;
+    memcpy(&count, trailer + 8, 4);
+    file_count = ntohl(count);
+    NormFile::Offset indexLen = size - NormArchiveWriter::TRAILER_SIZE - index_offset;
+    if ((index_offset < 8) || (indexLen < 0) || (indexLen > INDEX_MAX))
+    {
+        PLOG(PL_ERROR, "NormArchiveReader::Open() error: invalid archive index\n");
+        Close();
+        return false;
+    }
+    index_len = (unsigned int)indexLen;
+    if (0 != index_len)
+    {
+        if (NULL == (index_buffer = new char[index_len]))
+        {
+            PLOG(PL_ERROR, "NormArchiveReader::Open() new index buffer error: %s\n", GetErrorString());
+            Close();
+            return false;
+        }
+        if (!file.Seek(index_offset) || (file.Read(index_buffer, index_len) != index_len))
+        {
+            PLOG(PL_ERROR, "NormArchiveReader::Open() index read error: %s\n", GetErrorString());
+            Close();
+            return false;
+        }
+    }
+    index_pos = 0;
+    return true;
+}  // end NormArchiveReader::Open()
+
+void NormArchiveReader::Close()
+{
+    if (file.IsOpen()) file.Close();
+    if (NULL != index_buffer)
+    {
+        delete[] index_buffer;
+        index_buffer = NULL;
+    }
+    index_offset = 0;
+    file_count = 0;
+    index_len = index_pos = 0;
+    entry_offset = entry_size = 0;
+}  // end NormArchiveReader::Close()
+
+bool NormArchiveReader::GetNextEntry(char* nameBuffer, NormFile::Offset& size)
+{
+    // (bounds are checked as "len > size - offset" with unsigned values so
+    //  corrupt index fields can't wrap the sums around)
+    unsigned int indexRemaining = index_len - index_pos;  // (index_pos <= index_len)
+    if (indexRemaining < 18) return false;
+    const char* ptr = index_buffer + index_pos;
+    UINT16 nameLen;
+    memcpy(&nameLen, ptr + 16, 2);
+    nameLen = ntohs(nameLen);
+    if ((nameLen > (indexRemaining - 18)) || (nameLen >= PATH_MAX))
+    {
+        PLOG(PL_ERROR, "NormArchiveReader::GetNextEntry() error: invalid archive index entry\n");
+        index_pos = index_len;
+        return false;
+    }
+    UINT64 entryOffset = NormArchiveGet64(ptr);
+    UINT64 entrySize = NormArchiveGet64(ptr + 8);
+    UINT64 dataEnd = (UINT64)index_offset;  // (Open() made sure it's >= 8)
+    if ((entryOffset < 8) || (entryOffset > dataEnd) || (entrySize > (dataEnd - entryOffset)))
+    {
+        PLOG(PL_ERROR, "NormArchiveReader::GetNextEntry() error: invalid archive index entry\n");
+        index_pos = index_len;
+        return false;
+    }
+    entry_offset = (NormFile::Offset)entryOffset;
+    entry_size = (NormFile::Offset)entrySize;
+    memcpy(nameBuffer, ptr + 18, nameLen);
+    nameBuffer[nameLen] = '\0';
+    size = entry_size;
+    index_pos += 18 + nameLen;
+    return true;
+}  // end NormArchiveReader::GetNextEntry()
+
+bool NormArchiveReader::Extract(const char* path)
+{
+    if (!file.IsOpen() || !file.Seek(entry_offset)) return false;
+    NormFile outFile;
+    // (NormFile::Open() creates any sub-directories needed)
+    if (!outFile.Open(path, O_WRONLY | O_CREAT | O_TRUNC))
+    {
+        PLOG(PL_ERROR, "NormArchiveReader::Extract() error opening \"%s\": %s\n", path, GetErrorString());
+        return false;
+    }
+    char buffer[65536];
+    NormFile::Offset remaining = entry_size;
+    while (remaining > 0)
+    {
+        size_t len = (remaining < 65536) ? (size_t)remaining : 65536;
+        if ((file.Read(buffer, len) != len) || (outFile.Write(buffer, len) != len))
+        {
+            PLOG(PL_ERROR, "NormArchiveReader::Extract() error copying \"%s\": %s\n", path, GetErrorString());
+            outFile.Close();
+            return false;
+        }
+        remaining -= len;
+    }
+    outFile.Close();
+    return true;
+}  // end NormArchiveReader::Extract()
+
+unsigned int NormArchiveReader::ExtractAll(const char* dirPath)
+{
+    unsigned int count = 0;
+    char name[PATH_MAX];
+    NormFile::Offset size;
+    while (GetNextEntry(name, size))
+    {
+        char path[PATH_MAX];
+        if (!IsSafeName(name) || !MakePath(path, dirPath, name))
+        {
+            PLOG(PL_WARN, "NormArchiveReader::ExtractAll() warning: skipping invalid name \"%s\"\n", name);
+            continue;
+        }
+        if (Extract(path)) count++;
+    }
+    return count;
+}  // end NormArchiveReader::ExtractAll()
+
+bool NormArchiveReader::IsSafeName(const char* name)
+{
+    if (('\0' == name[0]) || ('/' == name[0]) || ('\\' == name[0])) return false;
+#ifdef WIN32
+    if (NULL != strchr(name, ':')) return false;  // (drive letter)
+#endif // WIN32
+    const char* ptr = name;
+    while ('\0' != *ptr)
+    {
+        // Check each path component for ".."
+        size_t len = strcspn(ptr, "/\\");
+        if ((2 == len) && ('.' == ptr[0]) && ('.' == ptr[1])) return false;
+        ptr += len;
+        if ('\0' != *ptr) ptr++;
+    }
+    return true;
+}  // end NormArchiveReader::IsSafeName()
+
+bool NormArchiveReader::MakePath(char* pathBuffer, const char* dirPath, const char* name)
+{
+    size_t dirLen = strlen(dirPath);
+    size_t nameLen = strlen(name);
+    bool addDelimiter = (0 != dirLen) && (PROTO_PATH_DELIMITER != dirPath[dirLen - 1]);
+    if ((dirLen + nameLen + (addDelimiter ? 1 : 0)) >= PATH_MAX) return false;
+    strcpy(pathBuffer, dirPath);
+    if (addDelimiter) pathBuffer[dirLen++] = PROTO_PATH_DELIMITER;
+    for (size_t i = 0; i <= nameLen; i++)
+        pathBuffer[dirLen + i] = ('/' == name[i]) ? PROTO_PATH_DELIMITER : name[i];
+    return true;
+}  // end NormArchiveReader::MakePath()
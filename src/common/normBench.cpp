@@ -0,0 +1,521 @@
+// normBench.cpp - reproducible NORM throughput/latency benchmarks
+//
+// Each result is printed to stdout as a single line JSON object so runs
+// can be collected and compared across releases (progress and errors go
+// to stderr).  Source data and erasure patterns are generated from a fixed
+// seed so every run does the same work.
+//
+// Usage:  normBench [fec][loopback][multicast][stream][events]
+//                   [duration <sec>][port <port>][addr <mcastAddr>][portable]
+//
+// With no tests named, all but "multicast" are run.  The "loopback",
+// "multicast" and "stream" tests send with the local sender to itself
+// through a single NORM session (with loopback enabled).
+
+#include "normApi.h"
+#include "normEncoderRS8.h"
+#ifndef NORM_NO_RS16
+#include "normEncoderRS16.h"
+#endif // !NORM_NO_RS16
+#include "normEncoderMDP.h"
+#include "normGFKernel.h"
+#include "normHistogram.h"
+#include "protoTime.h"
+
+#include <stdio.h>
+#include <stdlib.h>  // for rand(), atoi()
+#include <string.h>
+
+// Reproducible (seeded) erasure locations, in order
+static void PickErasures(unsigned int blockLen, unsigned int count, unsigned int* erasureLocs)
+{
+    unsigned int* loc = new unsigned int[blockLen];
+    for (unsigned int i = 0; i < blockLen; i++) loc[i] = i;
+    for (unsigned int i = 0; i < count; i++)
+    {
+        unsigned int j = i + (rand() % (blockLen - i));
+        unsigned int tmp = loc[i];
+        loc[i] = loc[j];
+        loc[j] = tmp;
+    }
+    for (unsigned int i = 0; i < count; i++)
+    {
+        for (unsigned int j = i + 1; j < count; j++)
+        {
+            if (loc[j] < loc[i])
+            {
+                unsigned int tmp = loc[i];
+                loc[i] = loc[j];
+                loc[j] = tmp;
+            }
+        }
+    }
+    memcpy(erasureLocs, loc, count * sizeof(unsigned int));
+    delete[] loc;
+}  // end PickErasures()
+
+// Encodes then decodes (with "numParity" erasures of source segments)
+// repeatedly for "duration" seconds each, printing GB/s of source data
+static bool BenchFec(const char*  codecName,
+                     NormEncoder& encoder,
+                     NormDecoder& decoder,
+                     unsigned int numData,
+                     unsigned int numParity,
+                     UINT16       segSize,
+                     double       duration)
+{
+    if (!encoder.Init(numData, numParity, segSize) || !decoder.Init(numData, numParity, segSize))
+    {
+        fprintf(stderr, "normBench: %s init error (numData:%u numParity:%u segSize:%hu)\n",
+                codecName, numData, numParity, segSize);
+        return false;
+    }
+    unsigned int blockLen = numData + numParity;
+    char* txData = new char[blockLen * segSize];
+    char* rxData = new char[blockLen * segSize];
+    char** txPtr = new char*[blockLen];
+    char** rxPtr = new char*[blockLen];
+    unsigned int* erasureLocs = new unsigned int[numParity];
+    for (unsigned int i = 0; i < blockLen; i++)
+    {
+        txPtr[i] = txData + i * segSize;
+        rxPtr[i] = rxData + i * segSize;
+    }
+    for (unsigned int i = 0; i < numData * segSize; i++)
+        txData[i] = (char)rand();
+
+    // 1) Encode
+    unsigned long count = 0;
+    ProtoTime startTime, stopTime;
+    startTime.GetCurrentTime();
+    double elapsed = 0.0;
+    do
+    {
+        memset(txPtr[numData], 0, numParity * segSize);
+        encoder.EncodeBlock((const char**)txPtr, numData, txPtr + numData);
+        count++;
+        stopTime.GetCurrentTime();
+        elapsed = ProtoTime::Delta(stopTime, startTime);
+    } while (elapsed < duration);
+    double bytes = (double)count * (double)numData * (double)segSize;
+    printf("{\"bench\":\"fec\",\"codec\":\"%s\",\"op\":\"encode\",\"numData\":%u,\"numParity\":%u,"
+           "\"segSize\":%hu,\"blocks\":%lu,\"seconds\":%.6f,\"gbps\":%.4f}\n",
+           codecName, numData, numParity, segSize, count, elapsed, 1.0e-09 * bytes / elapsed);
+
+    // 2) Decode (a fixed erasure pattern per run, erasing as many
+    //    source segments as there are parity segments)
+    unsigned int erasureCount = numParity;
+    PickErasures(numData, erasureCount, erasureLocs);
+    count = 0;
+    bool ok = true;
+    startTime.GetCurrentTime();
+    do
+    {
+        memcpy(rxData, txData, blockLen * segSize);
+        for (unsigned int i = 0; i < erasureCount; i++)
+            memset(rxPtr[erasureLocs[i]], 0, segSize);
+        decoder.Decode(rxPtr, numData, erasureCount, erasureLocs);
+        count++;
+        stopTime.GetCurrentTime();
+        elapsed = ProtoTime::Delta(stopTime, startTime);
+    } while (elapsed < duration);
+    if (0 != memcmp(rxData, txData, numData * segSize))
+    {
+        fprintf(stderr, "normBench: %s decode error!\n", codecName);
+        ok = false;
+    }
+    bytes = (double)count * (double)numData * (double)segSize;
+    printf("{\"bench\":\"fec\",\"codec\":\"%s\",\"op\":\"decode\",\"numData\":%u,\"numParity\":%u,"
+           "\"segSize\":%hu,\"erasures\":%u,\"blocks\":%lu,\"seconds\":%.6f,\"gbps\":%.4f,\"ok\":%s}\n",
+           codecName, numData, numParity, segSize, erasureCount, count, elapsed,
+           1.0e-09 * bytes / elapsed, ok ? "true" : "false");
+    fflush(stdout);
+
+    delete[] erasureLocs;
+    delete[] rxPtr;
+    delete[] txPtr;
+    delete[] rxData;
+    delete[] txData;
+    return ok;
+}  // end BenchFec()
+
+static bool RunFecBenchmarks(double duration)
+{
+    struct {unsigned int numData; unsigned int numParity; UINT16 segSize;} SHAPE[] =
+    {
+        {16, 4, 1400},
+        {64, 16, 1400},
+        {128, 32, 8192}
+    };
+    const unsigned int SHAPE_COUNT = sizeof(SHAPE) / sizeof(SHAPE[0]);
+    bool result = true;
+    for (unsigned int i = 0; i < SHAPE_COUNT; i++)
+    {
+        NormEncoderRS8 encoder;
+        NormDecoderRS8 decoder;
+        if (!BenchFec("RS8", encoder, decoder, SHAPE[i].numData, SHAPE[i].numParity, SHAPE[i].segSize, duration))
+            result = false;
+    }
+    for (unsigned int i = 0; i < SHAPE_COUNT; i++)
+    {
+        NormEncoderMDP encoder;
+        NormDecoderMDP decoder;
+        if (!BenchFec("MDP", encoder, decoder, SHAPE[i].numData, SHAPE[i].numParity, SHAPE[i].segSize, duration))
+            result = false;
+    }
+#ifndef NORM_NO_RS16
+    for (unsigned int i = 0; i < SHAPE_COUNT; i++)
+    {
+        NormEncoderRS16 encoder;
+        NormDecoderRS16 decoder;
+        if (!BenchFec("RS16", encoder, decoder, SHAPE[i].numData, SHAPE[i].numParity, SHAPE[i].segSize, duration))
+            result = false;
+    }
+    {
+        // (a long block only RS16 supports)
+        NormEncoderRS16 encoder;
+        NormDecoderRS16 decoder;
+        if (!BenchFec("RS16", encoder, decoder, 400, 100, 1400, duration))
+            result = false;
+    }
+#endif // !NORM_NO_RS16
+    return result;
+}  // end RunFecBenchmarks()
+
+// Creates a session that receives its own transmissions
+static NormSessionHandle CreateLoopbackSession(NormInstanceHandle instance,
+                                               const char*        addr,
+                                               UINT16             port,
+                                               bool               multicast,
+                                               UINT16             segSize,
+                                               UINT16             blockSize)
+{
+    NormSessionHandle session = NormCreateSession(instance, addr, port, NORM_NODE_ANY);
+    if (NORM_SESSION_INVALID == session)
+    {
+        fprintf(stderr, "normBench: NormCreateSession(%s/%hu) error\n", addr, port);
+        return NORM_SESSION_INVALID;
+    }
+    NormSetLoopback(session, true);
+    if (multicast) NormSetMulticastLoopback(session, true);
+    NormSetGrttEstimate(session, 0.001);
+    NormSetTxRate(session, 1.0e+10);  // (effectively unlimited)
+    NormSetRxSocketBuffer(session, 4 * 1024 * 1024);
+    NormSetTxSocketBuffer(session, 4 * 1024 * 1024);
+    if (!NormStartReceiver(session, 16 * 1024 * 1024) ||
+        !NormStartSender(session, (NormSessionId)rand(), 16 * 1024 * 1024, segSize, blockSize, 0))
+    {
+        fprintf(stderr, "normBench: error starting session %s/%hu\n", addr, port);
+        NormDestroySession(session);
+        return NORM_SESSION_INVALID;
+    }
+    return session;
+}  // end CreateLoopbackSession()
+
+// Sends NORM_OBJECT_DATA objects to ourself for "duration" seconds and
+// reports the packet rates seen by the sender and the receiver
+static bool BenchTransfer(NormInstanceHandle instance,
+                          const char*        addr,
+                          UINT16             port,
+                          bool               multicast,
+                          double             duration)
+{
+    const UINT16 SEG_SIZE = 1400;
+    const UINT16 BLOCK_SIZE = 64;
+    const unsigned int OBJECT_SIZE = SEG_SIZE * BLOCK_SIZE;
+    NormSessionHandle session = CreateLoopbackSession(instance, addr, port, multicast, SEG_SIZE, BLOCK_SIZE);
+    if (NORM_SESSION_INVALID == session) return false;
+    char* data = new char[OBJECT_SIZE];  // (shared by all objects, read only)
+    for (unsigned int i = 0; i < OBJECT_SIZE; i++) data[i] = (char)rand();
+
+    unsigned long sentCount = 0;
+    unsigned long recvCount = 0;
+    unsigned long failCount = 0;
+    unsigned long eventCount = 0;
+    NormNodeHandle sender = NORM_NODE_INVALID;
+    bool sending = true;
+    ProtoTime startTime, stopTime, lastRecvTime;
+    startTime.GetCurrentTime();
+    lastRecvTime = startTime;
+    NormSetUserTimer(session, 0.1);
+    while (NORM_OBJECT_INVALID != NormDataEnqueue(session, data, OBJECT_SIZE))
+        sentCount++;
+    NormEvent event;
+    while (NormGetNextEvent(instance, &event))
+    {
+        eventCount++;
+        switch (event.type)
+        {
+            case NORM_TX_QUEUE_VACANCY:
+            case NORM_TX_QUEUE_EMPTY:
+                while (sending && (NORM_OBJECT_INVALID != NormDataEnqueue(session, data, OBJECT_SIZE)))
+                    sentCount++;
+                break;
+            case NORM_RX_OBJECT_COMPLETED:
+                sender = event.sender;
+                recvCount++;
+                lastRecvTime.GetCurrentTime();
+                break;
+            case NORM_RX_OBJECT_ABORTED:
+                failCount++;
+                break;
+            case NORM_USER_TIMEOUT:
+                stopTime.GetCurrentTime();
+                if (sending && (ProtoTime::Delta(stopTime, startTime) >= duration))
+                    sending = false;
+                NormSetUserTimer(session, 0.1);
+                break;
+            default:
+                break;
+        }
+        if (!sending)
+        {
+            // Allow a second for the tail to be received
+            if ((recvCount + failCount) >= sentCount) break;
+            stopTime.GetCurrentTime();
+            if (ProtoTime::Delta(stopTime, startTime) > (duration + 1.0)) break;
+        }
+    }
+    double elapsed = ProtoTime::Delta(lastRecvTime, startTime);
+    if (elapsed <= 0.0) elapsed = duration;
+    NormSessionStats txStats;
+    NormNodeStats rxStats;
+    memset(&txStats, 0, sizeof(txStats));
+    memset(&rxStats, 0, sizeof(rxStats));
+    NormGetSessionStats(session, &txStats);
+    if (NORM_NODE_INVALID != sender) NormNodeGetStats(sender, &rxStats);
+    printf("{\"bench\":\"%s\",\"addr\":\"%s\",\"segSize\":%hu,\"objectSize\":%u,\"seconds\":%.6f,"
+           "\"objectsSent\":%lu,\"objectsCompleted\":%lu,\"objectsFailed\":%lu,"
+           "\"txPps\":%.1f,\"rxPps\":%.1f,\"rxGoodputMbps\":%.3f,\"eventsPerSec\":%.1f}\n",
+           multicast ? "multicast" : "loopback", addr, SEG_SIZE, OBJECT_SIZE, elapsed,
+           sentCount, recvCount, failCount,
+           (double)txStats.txSegments / elapsed, (double)rxStats.rxSegments / elapsed,
+           8.0e-06 * (double)rxStats.rxGoodputBytes / elapsed, (double)eventCount / elapsed);
+    fflush(stdout);
+    NormDestroySession(session);
+    delete[] data;
+    return (0 != recvCount);
+}  // end BenchTransfer()
+
+// Streams "msgSize" byte messages (each stamped with its send time) to
+// ourself and reports the message rate and delivery latency percentiles
+static bool BenchStream(NormInstanceHandle instance,
+                        UINT16             port,
+                        unsigned int       msgSize,
+                        double             duration)
+{
+    const UINT16 SEG_SIZE = 1400;
+    const UINT16 BLOCK_SIZE = 64;
+    const UINT32 STREAM_BUFFER = 4 * 1024 * 1024;
+    if (msgSize < sizeof(double)) msgSize = sizeof(double);
+    NormSessionHandle session = CreateLoopbackSession(instance, "127.0.0.1", port, false, SEG_SIZE, BLOCK_SIZE);
+    if (NORM_SESSION_INVALID == session) return false;
+    NormObjectHandle txStream = NormStreamOpen(session, STREAM_BUFFER);
+    if (NORM_OBJECT_INVALID == txStream)
+    {
+        fprintf(stderr, "normBench: NormStreamOpen() error\n");
+        NormDestroySession(session);
+        return false;
+    }
+    char* txMsg = new char[msgSize];
+    char* rxMsg = new char[msgSize];
+    memset(txMsg, 'a', msgSize);
+    NormHistogram latency;
+    NormObjectHandle rxStream = NORM_OBJECT_INVALID;
+    unsigned long sentCount = 0;
+    unsigned long recvCount = 0;
+    unsigned int txOffset = 0;  // of partially written txMsg
+    bool sending = true;
+    ProtoTime startTime, currentTime, lastRecvTime;
+    startTime.GetCurrentTime();
+    lastRecvTime = startTime;
+    NormSetUserTimer(session, 0.1);
+    NormEvent event;
+    // (the vacancy event for the stream open gets the writes started)
+    while (NormGetNextEvent(instance, &event))
+    {
+        switch (event.type)
+        {
+            case NORM_TX_QUEUE_VACANCY:
+            case NORM_TX_QUEUE_EMPTY:
+                while (sending)
+                {
+                    if (0 == txOffset)
+                    {
+                        currentTime.GetCurrentTime();
+                        double stamp = currentTime.GetValue();
+                        memcpy(txMsg, &stamp, sizeof(double));
+                    }
+                    txOffset += NormStreamWrite(txStream, txMsg + txOffset, msgSize - txOffset);
+                    if (txOffset < msgSize) break;  // (wait for vacancy)
+                    NormStreamFlush(txStream, true);
+                    txOffset = 0;
+                    sentCount++;
+                }
+                break;
+            case NORM_RX_OBJECT_NEW:
+                if (NORM_OBJECT_STREAM == NormObjectGetType(event.object))
+                    rxStream = event.object;
+                break;
+            case NORM_RX_OBJECT_UPDATED:
+            {
+                if (event.object != rxStream) break;
+                unsigned int len = msgSize;
+                while (NormStreamReadMsg(rxStream, rxMsg, &len) && (0 != len))
+                {
+                    double stamp;
+                    memcpy(&stamp, rxMsg, sizeof(double));
+                    lastRecvTime.GetCurrentTime();
+                    double now = lastRecvTime.GetValue();
+                    latency.Record(now - stamp);
+                    recvCount++;
+                    len = msgSize;
+                }
+                break;
+            }
+            case NORM_USER_TIMEOUT:
+                currentTime.GetCurrentTime();
+                if (sending && (ProtoTime::Delta(currentTime, startTime) >= duration))
+                    sending = false;
+                NormSetUserTimer(session, 0.1);
+                break;
+            default:
+                break;
+        }
+        if (!sending)
+        {
+            // (the last message is only complete once the stream closes,
+            //  so it is not waited for)
+            if ((recvCount + 1) >= sentCount) break;
+            currentTime.GetCurrentTime();
+            if (ProtoTime::Delta(currentTime, startTime) > (duration + 1.0)) break;
+        }
+    }
+    double elapsed = ProtoTime::Delta(lastRecvTime, startTime);
+    if (elapsed <= 0.0) elapsed = duration;
+    printf("{\"bench\":\"stream\",\"msgSize\":%u,\"seconds\":%.6f,\"msgsSent\":%lu,\"msgsRecvd\":%lu,"
+           "\"msgsPerSec\":%.1f,\"latencyUsec\":{\"min\":%.1f,\"mean\":%.1f,\"p50\":%.1f,"
+           "\"p90\":%.1f,\"p99\":%.1f,\"p999\":%.1f,\"max\":%.1f}}\n",
+           msgSize, elapsed, sentCount, recvCount, (double)recvCount / elapsed,
+           1.0e+06 * latency.GetMin(), 1.0e+06 * latency.GetMean(),
+           1.0e+06 * latency.GetPercentile(50.0), 1.0e+06 * latency.GetPercentile(90.0),
+           1.0e+06 * latency.GetPercentile(99.0), 1.0e+06 * latency.GetPercentile(99.9),
+           1.0e+06 * latency.GetMax());
+    fflush(stdout);
+    NormStreamClose(txStream);
+    NormDestroySession(session);
+    delete[] rxMsg;
+    delete[] txMsg;
+    return (0 != recvCount);
+}  // end BenchStream()
+
+// Measures API event round trips (NormSetUserTimer() to NORM_USER_TIMEOUT
+// retrieval), i.e. the cost of the API thread hand off per event
+static bool BenchEvents(NormInstanceHandle instance, UINT16 port, double duration)
+{
+    NormSessionHandle session = NormCreateSession(instance, "127.0.0.1", port, NORM_NODE_ANY);
+    if (NORM_SESSION_INVALID == session)
+    {
+        fprintf(stderr, "normBench: NormCreateSession() error\n");
+        return false;
+    }
+    NormHistogram latency;
+    unsigned long count = 0;
+    ProtoTime startTime, setTime, currentTime;
+    startTime.GetCurrentTime();
+    setTime = startTime;
+    NormSetUserTimer(session, 0.0);
+    NormEvent event;
+    double elapsed = 0.0;
+    while (NormGetNextEvent(instance, &event))
+    {
+        if (NORM_USER_TIMEOUT != event.type) continue;
+        currentTime.GetCurrentTime();
+        latency.Record(ProtoTime::Delta(currentTime, setTime));
+        count++;
+        elapsed = ProtoTime::Delta(currentTime, startTime);
+        if (elapsed >= duration) break;
+        setTime = currentTime;
+        NormSetUserTimer(session, 0.0);
+    }
+    if (elapsed <= 0.0) elapsed = duration;
+    printf("{\"bench\":\"events\",\"seconds\":%.6f,\"events\":%lu,\"eventsPerSec\":%.1f,"
+           "\"latencyUsec\":{\"p50\":%.1f,\"p99\":%.1f,\"max\":%.1f}}\n",
+           elapsed, count, (double)count / elapsed,
+           1.0e+06 * latency.GetPercentile(50.0), 1.0e+06 * latency.GetPercentile(99.0),
+           1.0e+06 * latency.GetMax());
+    fflush(stdout);
+    NormDestroySession(session);
+    return (0 != count);
+}  // end BenchEvents()
+
+int main(int argc, char* argv[])
+{
+    bool fec = false;
+    bool loopback = false;
+    bool multicast = false;
+    bool stream = false;
+    bool events = false;
+    double duration = 2.0;
+    UINT16 port = 6003;
+    const char* mcastAddr = "224.1.2.3";
+    for (int i = 1; i < argc; i++)
+    {
+        if (!strcmp(argv[i], "fec"))
+            fec = true;
+        else if (!strcmp(argv[i], "loopback"))
+            loopback = true;
+        else if (!strcmp(argv[i], "multicast"))
+            multicast = true;
+        else if (!strcmp(argv[i], "stream"))
+            stream = true;
+        else if (!strcmp(argv[i], "events"))
+            events = true;
+        else if (!strcmp(argv[i], "portable"))
+            NormGFKernel::SetType(NormGFKernel::PORTABLE);
+        else if (!strcmp(argv[i], "duration") && ((i + 1) < argc))
+            duration = atof(argv[++i]);
+        else if (!strcmp(argv[i], "port") && ((i + 1) < argc))
+            port = (UINT16)atoi(argv[++i]);
+        else if (!strcmp(argv[i], "addr") && ((i + 1) < argc))
+            mcastAddr = argv[++i];
+        else
+        {
+            fprintf(stderr, "Usage: normBench [fec][loopback][multicast][stream][events]\n"
+                            "                 [duration <sec>][port <port>][addr <mcastAddr>][portable]\n");
+            return -1;
+        }
+    }
+    if (!fec && !loopback && !multicast && !stream && !events)
+        fec = loopback = stream = events = true;
+    if (duration <= 0.0) duration = 2.0;
+
+    srand(1);  // (the same data and erasures every run)
+    int major, minor, patch;
+    NormGetVersion(&major, &minor, &patch);
+    printf("{\"bench\":\"info\",\"version\":\"%d.%d.%d\",\"gfKernel\":\"%s\",\"duration\":%.3f}\n",
+           major, minor, patch, NormGFKernel::GetTypeName(), duration);
+    fflush(stdout);
+
+    bool result = true;
+    if (fec && !RunFecBenchmarks(duration)) result = false;
+    if (loopback || multicast || stream || events)
+    {
+        NormInstanceHandle instance = NormCreateInstance();
+        if (NORM_INSTANCE_INVALID == instance)
+        {
+            fprintf(stderr, "normBench: NormCreateInstance() error\n");
+            return -1;
+        }
+        if (loopback && !BenchTransfer(instance, "127.0.0.1", port, false, duration)) result = false;
+        if (multicast && !BenchTransfer(instance, mcastAddr, port + 1, true, duration)) result = false;
+        if (stream)
+        {
+            if (!BenchStream(instance, port + 2, 64, duration)) result = false;
+            if (!BenchStream(instance, port + 3, 1024, duration)) result = false;
+        }
+        if (events && !BenchEvents(instance, port + 4, duration)) result = false;
+        NormDestroyInstance(instance);
+    }
+    return (result ? 0 : -1);
+}  // end main()
@@ -0,0 +1,236 @@
+#include "normBitmask.h"
+#include "protoDebug.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif // _MSC_VER
+
+NormBitmask::NormBitmask()
+ : mask(NULL), num_bits(0), num_words(0)
+{
+}
+
+NormBitmask::~NormBitmask()
+{
+    Destroy();
+}
+
+bool NormBitmask::Init(UINT32 numBits)
+{
+    if (NULL != mask) Destroy();
+    UINT32 numWords = GetWordCount(numBits);
+    if (NULL == (mask = new UINT64[numWords]))
+    {
+        PLOG(PL_FATAL, "NormBitmask::Init() new mask error: %s\n", GetErrorString());
+        return false;
+    }
+    num_bits = numBits;
+    num_words = numWords;
+    Clear();
+    return true;
+}  // end NormBitmask::Init()
+
+void NormBitmask::Attach(UINT64* buffer, UINT32 numBits)
+{
+    ASSERT(NULL == mask);
+    mask = buffer;
+    num_bits = numBits;
+    num_words = GetWordCount(numBits);
+    Clear();
+}  // end NormBitmask::Attach()
+
+void NormBitmask::Destroy()
+{
+    if (NULL != mask)
+    {
+        delete[] mask;
+        mask = NULL;
+    }
+    num_bits = num_words = 0;
+}  // end NormBitmask::Destroy()
+
+unsigned int NormBitmask::FirstSetBit(UINT64 word)
+{
+    ASSERT(0 != word);
+#if defined(__GNUC__) || defined(__clang__)
+    return (unsigned int)__builtin_ctzll(word);
+#elif defined(_MSC_VER) && defined(_WIN64)
+    unsigned long index;
+    _BitScanForward64(&index, word);
+    return (unsigned int)index;
+#else
+    unsigned int index = 0;
+    while (0 == (word & 0xff))
+    {
+        word >>= 8;
+        index += 8;
+    }
+    while (0 == (word & 0x01))
+    {
+        word >>= 1;
+        index++;
+    }
+    return index;
+#endif // if/else __GNUC__ / _MSC_VER
+}  // end NormBitmask::FirstSetBit()
+
+bool NormBitmask::IsSet() const
+{
+    for (UINT32 i = 0; i < num_words; i++)
+        if (0 != mask[i]) return true;
+    return false;
+}  // end NormBitmask::IsSet()
+
+void NormBitmask::Clear()
+{
+    if (NULL != mask) memset(mask, 0, num_words * sizeof(UINT64));
+}  // end NormBitmask::Clear()
+
+bool NormBitmask::Set(UINT32 index)
+{
+    if (index >= num_bits) return false;
+    mask[index >> WORD_SHIFT] |= ((UINT64)1 << (index & WORD_MASK));
+    return true;
+}  // end NormBitmask::Set()
+
+bool NormBitmask::Unset(UINT32 index)
+{
+    if (index >= num_bits) return false;
+    mask[index >> WORD_SHIFT] &= ~((UINT64)1 << (index & WORD_MASK));
+    return true;
+}  // end NormBitmask::Unset()
+
+bool NormBitmask::SetBits(UINT32 index, UINT32 count)
+{
+    if (0 == count) return true;
+    if ((index >= num_bits) || (count > (num_bits - index))) return false;
+    UINT32 word = index >> WORD_SHIFT;
+    UINT32 endWord = (index + count - 1) >> WORD_SHIFT;
+    UINT64 startMask = ~((UINT64)0) << (index & WORD_MASK);
+    UINT64 endMask = ~((UINT64)0) >> (WORD_MASK - ((index + count - 1) & WORD_MASK));
+    if (word == endWord)
+    {
+        mask[word] |= (startMask & endMask);
+        return true;
+    }
+    mask[word++] |= startMask;
+    while (word < endWord) mask[word++] = ~((UINT64)0);
+    mask[endWord] |= endMask;
+    return true;
+}  // end NormBitmask::SetBits()
+
+// (like ProtoBitmask, "count" is truncated to the end of the mask)
+bool NormBitmask::UnsetBits(UINT32 index, UINT32 count)
+{
+    if (index >= num_bits) return false;
+    if (count > (num_bits - index)) count = num_bits - index;
+    if (0 == count) return true;
+    UINT32 word = index >> WORD_SHIFT;
+    UINT32 endWord = (index + count - 1) >> WORD_SHIFT;
+    UINT64 startMask = ~((UINT64)0) << (index & WORD_MASK);
+    UINT64 endMask = ~((UINT64)0) >> (WORD_MASK - ((index + count - 1) & WORD_MASK));
+    if (word == endWord)
+    {
+        mask[word] &= ~(startMask & endMask);
+        return true;
+    }
+    mask[word++] &= ~startMask;
+    while (word < endWord) mask[word++] = 0;
+    mask[endWord] &= ~endMask;
+    return true;
+}  // end NormBitmask::UnsetBits()
+
+bool NormBitmask::GetNextSet(UINT32& index) const
+{
+    if (index >= num_bits) return false;
+    UINT32 word = index >> WORD_SHIFT;
+    UINT64 bits = mask[word] & (~((UINT64)0) << (index & WORD_MASK));
+    while (0 == bits)
+    {
+        if (++word >= num_words) return false;
+        bits = mask[word];
+    }
+    index = (word << WORD_SHIFT) + FirstSetBit(bits);
+    return true;  // (bits past "num_bits" are never set)
+}  // end NormBitmask::GetNextSet()
+
+bool NormBitmask::GetNextUnset(UINT32& index) const
+{
+    if (index >= num_bits) return false;
+    UINT32 word = index >> WORD_SHIFT;
+    UINT64 bits = ~mask[word] & (~((UINT64)0) << (index & WORD_MASK));
+    while (0 == bits)
+    {
+        if (++word >= num_words) return false;
+        bits = ~mask[word];
+    }
+    UINT32 nextIndex = (word << WORD_SHIFT) + FirstSetBit(bits);
+    if (nextIndex >= num_bits) return false;
+    index = nextIndex;
+    return true;
+}  // end NormBitmask::GetNextUnset()
+
+bool NormBitmask::GetNextRun(UINT32& index, UINT32& count) const
+{
+    if (!GetNextSet(index)) return false;
+    UINT32 endIndex = index;
+    if (!GetNextUnset(endIndex)) endIndex = num_bits;
+    count = endIndex - index;
+    return true;
+}  // end NormBitmask::GetNextRun()
+
+UINT32 NormBitmask::Count() const
+{
+    UINT32 total = 0;
+    for (UINT32 i = 0; i < num_words; i++)
+    {
+#if defined(__GNUC__) || defined(__clang__)
+        total += (UINT32)__builtin_popcountll(mask[i]);
+#else
+        UINT64 bits = mask[i];
+        while (0 != bits)
+        {
+            bits &= (bits - 1);
+            total++;
+        }
+#endif // if/else __GNUC__
+    }
+    return total;
+}  // end NormBitmask::Count()
+
+// Note: the masks combined here are assumed to be the same size
+void NormBitmask::Add(const NormBitmask& b)
+{
+    UINT32 numWords = MIN(num_words, b.num_words);
+    for (UINT32 i = 0; i < numWords; i++)
+        mask[i] |= b.mask[i];
+    if (0 != num_words) mask[num_words - 1] &= LastWordMask();
+}  // end NormBitmask::Add()
+
+void NormBitmask::Xor(const NormBitmask& b)
+{
+    UINT32 numWords = MIN(num_words, b.num_words);
+    for (UINT32 i = 0; i < numWords; i++)
+        mask[i] ^= b.mask[i];
+    if (0 != num_words) mask[num_words - 1] &= LastWordMask();
+}  // end NormBitmask::Xor()
+
+void NormBitmask::XCopy(const NormBitmask& b)
+{
+    UINT32 numWords = MIN(num_words, b.num_words);
+    for (UINT32 i = 0; i < numWords; i++)
+        mask[i] = b.mask[i] & ~mask[i];
+    for (UINT32 i = numWords; i < num_words; i++)
+        mask[i] = 0;
+    if (0 != num_words) mask[num_words - 1] &= LastWordMask();
+}  // end NormBitmask::XCopy()
+
+void NormBitmask::Display(FILE* stream) const
+{
+    for (UINT32 i = 0; i < num_bits; i++)
+    {
+        fprintf(stream, "%d", Test(i) ? 1 : 0);
+        if (0x07 == (i & 0x07)) fprintf(stream, " ");
+        if (0x3f == (i & 0x3f)) fprintf(stream, "\n");
+    }
+}  // end NormBitmask::Display()
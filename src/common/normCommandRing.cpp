@@ -0,0 +1,186 @@
+#include "normCommandRing.h"
+#include "protoDebug.h"
+
+#ifndef WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/eventfd.h>
+#endif // __linux__
+#endif // !WIN32
+
+NormCommandRing::NormCommandRing()
+ : ring(NULL), size(0), head(0), count(0)
+{
+#ifdef WIN32
+    InitializeCriticalSection(&mutex);
+#else
+    wake_fd[0] = wake_fd[1] = -1;
+    pthread_mutex_init(&mutex, NULL);
+#endif // if/else WIN32
+}
+
+NormCommandRing::~NormCommandRing()
+{
+    Close();
+#ifdef WIN32
+    DeleteCriticalSection(&mutex);
+#else
+    pthread_mutex_destroy(&mutex);
+#endif // if/else WIN32
+}
+
+void NormCommandRing::Lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&mutex);
+#else
+    pthread_mutex_lock(&mutex);
+#endif // if/else WIN32
+}  // end NormCommandRing::Lock()
+
+void NormCommandRing::Unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&mutex);
+#else
+    pthread_mutex_unlock(&mutex);
+#endif // if/else WIN32
+}  // end NormCommandRing::Unlock()
+
+bool NormCommandRing::Open(unsigned int numCommands)
+{
+#ifdef WIN32
+    PLOG(PL_DEBUG, "NormCommandRing::Open() not supported on WIN32\n");
+    return false;
+#else
+    if (IsOpen()) Close();
+    if (0 == numCommands) numCommands = DEFAULT_SIZE;
+    if (NULL == (ring = new Command[numCommands]))
+    {
+        PLOG(PL_FATAL, "NormCommandRing::Open() new ring error: %s\n", GetErrorString());
+        return false;
+    }
+    size = numCommands;
+    head = count = 0;
+#ifdef __linux__
+    wake_fd[0] = wake_fd[1] = eventfd(0, EFD_NONBLOCK);
+    if (wake_fd[0] < 0)
+        PLOG(PL_WARN, "NormCommandRing::Open() eventfd() error: %s (using pipe)\n", GetErrorString());
+#endif // __linux__
+    if ((wake_fd[0] < 0) && (0 != pipe(wake_fd)))
+    {
+        PLOG(PL_ERROR, "NormCommandRing::Open() pipe() error: %s\n", GetErrorString());
+        wake_fd[0] = wake_fd[1] = -1;
+        Close();
+        return false;
+    }
+    // (both pipe ends are non-blocking so a Post() never blocks)
+    if ((wake_fd[0] != wake_fd[1]) &&
+        ((-1 == fcntl(wake_fd[0], F_SETFL, fcntl(wake_fd[0], F_GETFL, 0) | O_NONBLOCK)) ||
+         (-1 == fcntl(wake_fd[1], F_SETFL, fcntl(wake_fd[1], F_GETFL, 0) | O_NONBLOCK))))
+    {
+        PLOG(PL_ERROR, "NormCommandRing::Open() fcntl(F_SETFL(O_NONBLOCK)) error: %s\n", GetErrorString());
+        Close();
+        return false;
+    }
+    descriptor = wake_fd[0];
+    if (!ProtoChannel::Open())
+    {
+        PLOG(PL_ERROR, "NormCommandRing::Open() error: unable to open channel\n");
+        Close();
+        return false;
+    }
+    if (!StartInputNotification())
+    {
+        PLOG(PL_ERROR, "NormCommandRing::Open() error: unable to start input notification\n");
+        Close();
+        return false;
+    }
+    return true;
+#endif // if/else WIN32
+}  // end NormCommandRing::Open()
+
+void NormCommandRing::Close()
+{
+    if (IsOpen()) ProtoChannel::Close();
+#ifndef WIN32
+    descriptor = INVALID_HANDLE;
+    if (wake_fd[0] >= 0)
+    {
+        close(wake_fd[0]);
+        if (wake_fd[1] != wake_fd[0])
+            close(wake_fd[1]);
+        wake_fd[0] = wake_fd[1] = -1;
+    }
+#endif // !WIN32
+    Lock();
+    if (NULL != ring)
+    {
+        delete[] ring;  // (any unexecuted commands are discarded)
+        ring = NULL;
+    }
+    size = head = count = 0;
+    Unlock();
+}  // end NormCommandRing::Close()
+
+bool NormCommandRing::Post(const Command& cmd)
+{
+#ifdef WIN32
+    return false;
+#else
+    Lock();
+    if ((NULL == ring) || (count >= size))
+    {
+        Unlock();
+        return false;
+    }
+    unsigned int index = head + count;
+    if (index >= size) index -= size;
+    ring[index] = cmd;
+    bool wasEmpty = (0 == count++);
+    Unlock();
+    // Only the first command posted to an empty ring needs to wake
+    // the protocol thread since Reset() is called before draining
+    if (wasEmpty)
+    {
+        // (an eventfd needs an 8 byte write, a pipe just one byte)
+        UINT64 value = 1;
+        size_t len = (wake_fd[0] == wake_fd[1]) ? sizeof(value) : 1;
+        while ((ssize_t)len != write(wake_fd[1], &value, len))
+        {
+            // (EAGAIN means a wake up is already pending)
+            if (EINTR != errno)
+            {
+                if (EAGAIN != errno)
+                    PLOG(PL_ERROR, "NormCommandRing::Post() write() error: %s\n", GetErrorString());
+                break;
+            }
+        }
+    }
+    return true;
+#endif // if/else WIN32
+}  // end NormCommandRing::Post()
+
+bool NormCommandRing::Get(Command& cmd)
+{
+    Lock();
+    if (0 == count)
+    {
+        Unlock();
+        return false;
+    }
+    cmd = ring[head];
+    if (++head >= size) head = 0;
+    count--;
+    Unlock();
+    return true;
+}  // end NormCommandRing::Get()
+
+void NormCommandRing::Reset()
+{
+#ifndef WIN32
+    char byte[32];
+    while (read(wake_fd[0], byte, 32) > 0);
+#endif // !WIN32
+}  // end NormCommandRing::Reset()
@@ -0,0 +1,291 @@
+#include "normCompletion.h"
+#include "normArchive.h"  // for NormArchiveReader
+#include "protoDebug.h"
+
+#include <stdio.h>   // for remove()
+#include <string.h>  // for strncpy()
+
+NormCompletionPool::NormCompletionPool()
+ : worker_list(NULL), worker_count(0), pending_count(0), post_processor(NULL), stopping(false)
+{
+    unpack_path[0] = '\0';
+#ifdef WIN32
+    InitializeCriticalSection(&mutex);
+    InitializeCriticalSection(&processor_mutex);
+#else
+    pthread_mutex_init(&mutex, NULL);
+    pthread_mutex_init(&processor_mutex, NULL);
+#endif // if/else WIN32
+}
+
+NormCompletionPool::~NormCompletionPool()
+{
+    Destroy();
+#ifdef WIN32
+    DeleteCriticalSection(&processor_mutex);
+    DeleteCriticalSection(&mutex);
+#else
+    pthread_mutex_destroy(&processor_mutex);
+    pthread_mutex_destroy(&mutex);
+#endif // if/else WIN32
+}
+
+void NormCompletionPool::Lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&mutex);
+#else
+    pthread_mutex_lock(&mutex);
+#endif // if/else WIN32
+}  // end NormCompletionPool::Lock()
+
+void NormCompletionPool::Unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&mutex);
+#else
+    pthread_mutex_unlock(&mutex);
+#endif // if/else WIN32
+}  // end NormCompletionPool::Unlock()
+
+void NormCompletionPool::Wait(Worker& worker)
+{
+#ifdef WIN32
+    SleepConditionVariableCS(&worker.cond, &mutex, INFINITE);
+#else
+    pthread_cond_wait(&worker.cond, &mutex);
+#endif // if/else WIN32
+}  // end NormCompletionPool::Wait()
+
+void NormCompletionPool::Signal(Worker& worker)
+{
+#ifdef WIN32
+    WakeConditionVariable(&worker.cond);
+#else
+    pthread_cond_signal(&worker.cond);
+#endif // if/else WIN32
+}  // end NormCompletionPool::Signal()
+
+void NormCompletionPool::LockProcessor()
+{
+#ifdef WIN32
+    EnterCriticalSection(&processor_mutex);
+#else
+    pthread_mutex_lock(&processor_mutex);
+#endif // if/else WIN32
+}  // end NormCompletionPool::LockProcessor()
+
+void NormCompletionPool::UnlockProcessor()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&processor_mutex);
+#else
+    pthread_mutex_unlock(&processor_mutex);
+#endif // if/else WIN32
+}  // end NormCompletionPool::UnlockProcessor()
+
+bool NormCompletionPool::Init(unsigned int          numWorkers,
+                              NormPostProcessor*    postProcessor,
+                              const char*           unpackPath)
+{
+    Destroy();
+    if (0 == numWorkers) return true;
+    if (NULL == (worker_list = new Worker[numWorkers]))
+    {
+        PLOG(PL_FATAL, "NormCompletionPool::Init() error: allocation failure: %s\n", GetErrorString());
+        return false;
+    }
+    post_processor = postProcessor;
+    if (NULL != unpackPath)
+    {
+        strncpy(unpack_path, unpackPath, PATH_MAX);
+        unpack_path[PATH_MAX - 1] = '\0';
+    }
+    else
+    {
+        unpack_path[0] = '\0';
+    }
+    stopping = false;
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        Worker& worker = worker_list[i];
+        worker.pool = this;
+        worker.queue_head = worker.queue_tail = NULL;
+        worker.started = false;
+#ifdef WIN32
+        InitializeConditionVariable(&worker.cond);
+#else
+        pthread_cond_init(&worker.cond, NULL);
+#endif // if/else WIN32
+    }
+    worker_count = numWorkers;
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        Worker& worker = worker_list[i];
+#ifdef WIN32
+        worker.thread = CreateThread(NULL, 0, DoWorker, &worker, 0, NULL);
+        worker.started = (NULL != worker.thread);
+#else
+        worker.started = (0 == pthread_create(&worker.thread, NULL, DoWorker, &worker));
+#endif // if/else WIN32
+        if (!worker.started)
+        {
+            PLOG(PL_FATAL, "NormCompletionPool::Init() error: unable to start worker thread: %s\n", GetErrorString());
+            Destroy();
+            return false;
+        }
+    }
+    return true;
+}  // end NormCompletionPool::Init()
+
+void NormCompletionPool::Destroy()
+{
+    if (NULL == worker_list) return;
+    Lock();
+    stopping = true;
+    for (unsigned int i = 0; i < worker_count; i++)
+        Signal(worker_list[i]);
+    Unlock();
+    for (unsigned int i = 0; i < worker_count; i++)
+    {
+        Worker& worker = worker_list[i];
+        if (worker.started)
+        {
+#ifdef WIN32
+            WaitForSingleObject(worker.thread, INFINITE);
+            CloseHandle(worker.thread);
+#else
+            pthread_join(worker.thread, NULL);
+#endif // if/else WIN32
+            worker.started = false;
+        }
+        // (only an unstarted worker can have jobs left)
+        while (NULL != worker.queue_head)
+        {
+            Job* job = worker.queue_head;
+            worker.queue_head = job->next;
+            delete job;
+        }
+#ifndef WIN32
+        pthread_cond_destroy(&worker.cond);
+#endif // !WIN32
+    }
+    delete[] worker_list;
+    worker_list = NULL;
+    worker_count = 0;
+    pending_count = 0;
+}  // end NormCompletionPool::Destroy()
+
+bool NormCompletionPool::Submit(NormNodeId senderId, Action action, const char* path)
+{
+    if (0 == worker_count)
+    {
+        PLOG(PL_ERROR, "NormCompletionPool::Submit() error: pool not initialized\n");
+        return false;
+    }
+    Job* job = new Job;
+    if (NULL == job)
+    {
+        PLOG(PL_ERROR, "NormCompletionPool::Submit() new Job error: %s\n", GetErrorString());
+        return false;
+    }
+    job->action = action;
+    strncpy(job->path, path, PATH_MAX);
+    job->path[PATH_MAX - 1] = '\0';
+    job->next = NULL;
+    // The same sender's jobs always go to the same worker (and so stay in order)
+    Worker& worker = worker_list[senderId % worker_count];
+    Lock();
+    if (NULL != worker.queue_tail)
+        worker.queue_tail->next = job;
+    else
+        worker.queue_head = job;
+    worker.queue_tail = job;
+    pending_count++;
+    Signal(worker);
+    Unlock();
+    return true;
+}  // end NormCompletionPool::Submit()
+
+unsigned int NormCompletionPool::GetPendingCount()
+{
+    Lock();
+    unsigned int count = pending_count;
+    Unlock();
+    return count;
+}  // end NormCompletionPool::GetPendingCount()
+
+#ifdef WIN32
+DWORD WINAPI NormCompletionPool::DoWorker(LPVOID param)
+{
+    Worker* worker = (Worker*)param;
+    worker->pool->Run(*worker);
+    return 0;
+}  // end NormCompletionPool::DoWorker()
+#else
+void* NormCompletionPool::DoWorker(void* param)
+{
+    Worker* worker = (Worker*)param;
+    worker->pool->Run(*worker);
+    return NULL;
+}  // end NormCompletionPool::DoWorker()
+#endif // if/else WIN32
+
+void NormCompletionPool::Run(Worker& worker)
+{
+    Lock();
+    while (true)
+    {
+        // Queued jobs are finished before a worker stops
+        while ((NULL == worker.queue_head) && !stopping)
+            Wait(worker);
+        Job* job = worker.queue_head;
+        if (NULL == job) break;  // (stopping)
+        if (NULL == (worker.queue_head = job->next))
+            worker.queue_tail = NULL;
+        Unlock();
+        DoJob(*job);
+        delete job;
+        Lock();
+        pending_count--;
+    }
+    Unlock();
+}  // end NormCompletionPool::Run()
+
+void NormCompletionPool::DoJob(const Job& job)
+{
+    switch (job.action)
+    {
+        case PROCESS:
+            if ((NULL != post_processor) && post_processor->IsEnabled())
+            {
+                LockProcessor();
+                bool result = post_processor->ProcessFile(job.path);
+                UnlockProcessor();
+                if (!result)
+                    PLOG(PL_ERROR, "NormCompletionPool::DoJob() error: post processing \"%s\" failed\n", job.path);
+            }
+            break;
+        case UNPACK:
+        {
+            NormArchiveReader archive;
+            if (archive.Open(job.path))
+            {
+                unsigned int count = archive.ExtractAll(unpack_path);
+                archive.Close();
+                PLOG(PL_INFO, "NormCompletionPool::DoJob() unpacked %u files from archive \"%s\"\n", count, job.path);
+            }
+            else
+            {
+                PLOG(PL_ERROR, "NormCompletionPool::DoJob() error: unable to open archive \"%s\"\n", job.path);
+            }
+            if (0 != remove(job.path))
+                PLOG(PL_ERROR, "NormCompletionPool::DoJob() error: unable to remove archive \"%s\"\n", job.path);
+            break;
+        }
+        case REMOVE:
+            if (0 != remove(job.path))
+                PLOG(PL_ERROR, "NormCompletionPool::DoJob() error: unable to remove \"%s\"\n", job.path);
+            break;
+    }
+}  // end NormCompletionPool::DoJob()
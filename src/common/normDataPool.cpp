@@ -0,0 +1,178 @@
+#include "normDataPool.h"
+#include "protoDebug.h"
+
+NormDataPool::NormDataPool()
+ : cache_limit(0), cache_bytes(0), region_ptr(NULL), region_len(0),
+   outstanding(0), destroyed(false)
+{
+    for (unsigned int i = 0; i < CLASS_COUNT; i++)
+        free_list[i] = NULL;
+#ifdef WIN32
+    InitializeCriticalSection(&mutex);
+#else
+    pthread_mutex_init(&mutex, NULL);
+#endif // if/else WIN32
+}
+
+NormDataPool::~NormDataPool()
+{
+    for (unsigned int i = 0; i < CLASS_COUNT; i++)
+    {
+        Header* header;
+        while (NULL != (header = free_list[i]))
+        {
+            free_list[i] = header->next;
+            if (NULL != header->base) delete[] header->base;
+        }
+    }
+#ifdef WIN32
+    DeleteCriticalSection(&mutex);
+#else
+    pthread_mutex_destroy(&mutex);
+#endif // if/else WIN32
+}
+
+void NormDataPool::Lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&mutex);
+#else
+    pthread_mutex_lock(&mutex);
+#endif // if/else WIN32
+}  // end NormDataPool::Lock()
+
+void NormDataPool::Unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&mutex);
+#else
+    pthread_mutex_unlock(&mutex);
+#endif // if/else WIN32
+}  // end NormDataPool::Unlock()
+
+void NormDataPool::SetCacheLimit(size_t numBytes)
+{
+    Lock();
+    cache_limit = numBytes;
+    // Trim cached heap buffers, largest first, to the new limit
+    for (int i = CLASS_COUNT - 1; (i >= 0) && (cache_bytes > cache_limit); i--)
+    {
+        Header** prev = &free_list[i];
+        Header* header;
+        while ((NULL != (header = *prev)) && (cache_bytes > cache_limit))
+        {
+            if (NULL != header->base)
+            {
+                *prev = header->next;
+                cache_bytes -= ((size_t)1 << (i + CLASS_MIN_SHIFT));
+                delete[] header->base;
+            }
+            else
+            {
+                prev = &header->next;  // (region buffers are kept)
+            }
+        }
+    }
+    Unlock();
+}  // end NormDataPool::SetCacheLimit()
+
+bool NormDataPool::AddRegion(char* region, size_t regionSize)
+{
+    // Align the region start so carved buffers are cache line aligned
+    size_t pad = (HEADER_SIZE - ((size_t)region % HEADER_SIZE)) % HEADER_SIZE;
+    if ((NULL == region) || (regionSize < (pad + HEADER_SIZE + ((size_t)1 << CLASS_MIN_SHIFT))))
+    {
+        PLOG(PL_ERROR, "NormDataPool::AddRegion() error: invalid region\n");
+        return false;
+    }
+    Lock();
+    region_ptr = region + pad;
+    region_len = regionSize - pad;
+    Unlock();
+    return true;
+}  // end NormDataPool::AddRegion()
+
+char* NormDataPool::Alloc(size_t size)
+{
+    unsigned int sizeClass = 0;
+    while ((sizeClass < CLASS_COUNT) && (((size_t)1 << (sizeClass + CLASS_MIN_SHIFT)) < size))
+        sizeClass++;
+    size_t bufferSize = (sizeClass < CLASS_COUNT) ? ((size_t)1 << (sizeClass + CLASS_MIN_SHIFT)) : size;
+    Header* header = NULL;
+    Lock();
+    if (sizeClass < CLASS_COUNT)
+    {
+        if (NULL != (header = free_list[sizeClass]))
+        {
+            free_list[sizeClass] = header->next;
+            if (NULL != header->base) cache_bytes -= bufferSize;
+        }
+        else if (region_len >= (HEADER_SIZE + bufferSize))
+        {
+            header = (Header*)region_ptr;
+            header->base = NULL;
+            region_ptr += (HEADER_SIZE + bufferSize);
+            region_len -= (HEADER_SIZE + bufferSize);
+        }
+    }
+    if (NULL != header) outstanding++;
+    Unlock();
+    if (NULL == header)
+    {
+        // Allocate from the heap, with room to align the header
+        char* base = new char[bufferSize + 2*HEADER_SIZE - 1];
+        if (NULL == base)
+        {
+            PLOG(PL_FATAL, "NormDataPool::Alloc() new buffer error: %s\n", GetErrorString());
+            return NULL;
+        }
+        size_t pad = (HEADER_SIZE - ((size_t)base % HEADER_SIZE)) % HEADER_SIZE;
+        header = (Header*)(base + pad);
+        header->base = base;
+        Lock();
+        outstanding++;
+        Unlock();
+    }
+    header->pool = this;
+    header->next = NULL;
+    header->size_class = sizeClass;
+    return ((char*)header + HEADER_SIZE);
+}  // end NormDataPool::Alloc()
+
+void NormDataPool::Free(char* buffer)
+{
+    if (NULL == buffer) return;
+    Header* header = (Header*)(buffer - HEADER_SIZE);
+    header->pool->Return(header);
+}  // end NormDataPool::Free()
+
+void NormDataPool::Return(Header* header)
+{
+    Lock();
+    outstanding--;
+    unsigned int sizeClass = header->size_class;
+    size_t bufferSize = (size_t)1 << (sizeClass + CLASS_MIN_SHIFT);
+    if ((sizeClass < CLASS_COUNT) && !destroyed &&
+        ((NULL == header->base) || ((cache_bytes + bufferSize) <= cache_limit)))
+    {
+        header->next = free_list[sizeClass];
+        free_list[sizeClass] = header;
+        if (NULL != header->base) cache_bytes += bufferSize;
+        header = NULL;
+    }
+    bool deletePool = destroyed && (0 == outstanding);
+    Unlock();
+    if ((NULL != header) && (NULL != header->base))
+        delete[] header->base;
+    if (deletePool) delete this;
+}  // end NormDataPool::Return()
+
+void NormDataPool::Destroy()
+{
+    SetCacheLimit(0);
+    Lock();
+    destroyed = true;
+    bool deletePool = (0 == outstanding);
+    Unlock();
+    if (deletePool) delete this;
+}  // end NormDataPool::Destroy()
@@ -35,6 +35,14 @@
 #include <string.h>
         
 #include "normEncoder.h"
+#include "normEncoderMDP.h"   // "legacy" MDP Reed-Solomon encoder
+#include "normEncoderRS8.h"   // 8-bit Reed-Solomon encoder of RFC 5510
+#ifndef NORM_NO_RS16
+#include "normEncoderRS16.h"  // 16-bit Reed-Solomon encoder of RFC 5510
+#endif // !NORM_NO_RS16
+#ifndef NORM_NO_LDPC
+#include "normEncoderLDPC.h"  // LDPC-Staircase large block encoder
+#endif // !NORM_NO_LDPC
 #include "galois.h"  // for Galois math routines
 
 #ifdef SIMULATE
@@ -49,6 +57,258 @@ NormEncoder::~NormEncoder()
 {
 }
 
+void NormEncoder::EncodeBlock(const char** dataVectorList, unsigned int numData, char** parityVectorList)
+{
+    for (unsigned int i = 0; i < numData; i++)
+        Encode(i, dataVectorList[i], parityVectorList);
+    EncodeFinish(numData, parityVectorList);
+}  // end NormEncoder::EncodeBlock()
+
+void NormEncoder::EncodeBlocks(unsigned int          numBlocks,
+                               const char***         dataVectorLists,
+                               const unsigned int*   numDataList,
+                               char***               parityVectorLists)
+{
+    for (unsigned int i = 0; i < numBlocks; i++)
+        EncodeBlock(dataVectorLists[i], numDataList[i], parityVectorLists[i]);
+}  // end NormEncoder::EncodeBlocks()
+
+NormDecoder::NormDecoder()
+{
+    // (if this fails, decoding just proceeds without the cache)
+    matrix_cache.Init(MATRIX_CACHE_DEFAULT);
+}
+
 NormDecoder::~NormDecoder()
 {
 }
+
+NormDecoderMatrixCache::NormDecoderMatrixCache()
+ : entry_list(NULL), entry_max(0), entry_count(0), 
+   use_count(0), hit_count(0), miss_count(0)
+{
+}
+
+NormDecoderMatrixCache::~NormDecoderMatrixCache()
+{
+    Destroy();
+}
+
+bool NormDecoderMatrixCache::Init(unsigned int maxEntries)
+{
+    Destroy();
+    if (0 == maxEntries) return true;
+    if (NULL == (entry_list = new Entry[maxEntries]))
+    {
+        PLOG(PL_FATAL, "NormDecoderMatrixCache::Init() new entry_list error: %s\n", GetErrorString());
+        return false;
+    }
+    memset(entry_list, 0, maxEntries*sizeof(Entry));
+    entry_max = maxEntries;
+    return true;
+}  // end NormDecoderMatrixCache::Init()
+
+void NormDecoderMatrixCache::Clear()
+{
+    for (unsigned int i = 0; i < entry_count; i++)
+    {
+        if (NULL != entry_list[i].erasure_locs) 
+            delete[] entry_list[i].erasure_locs;
+        if (NULL != entry_list[i].content)
+            delete[] entry_list[i].content;
+    }
+    if (NULL != entry_list)
+        memset(entry_list, 0, entry_max*sizeof(Entry));
+    entry_count = 0;
+}  // end NormDecoderMatrixCache::Clear()
+
+void NormDecoderMatrixCache::Destroy()
+{
+    Clear();
+    if (NULL != entry_list)
+    {
+        delete[] entry_list;
+        entry_list = NULL;
+    }
+    entry_max = 0;
+}  // end NormDecoderMatrixCache::Destroy()
+
+UINT32 NormDecoderMatrixCache::Hash(unsigned int numData, unsigned int erasureCount, const unsigned int* erasureLocs)
+{
+    // FNV-1a over the pattern values
+    UINT32 hash = 2166136261UL;
+    hash = (hash ^ numData) * 16777619UL;
+    hash = (hash ^ erasureCount) * 16777619UL;
+    for (unsigned int i = 0; i < erasureCount; i++)
+        hash = (hash ^ erasureLocs[i]) * 16777619UL;
+    return hash;
+}  // end NormDecoderMatrixCache::Hash()
+
+const char* NormDecoderMatrixCache::Find(unsigned int numData, unsigned int erasureCount, const unsigned int* erasureLocs)
+{
+    if (0 == entry_max) return NULL;
+    UINT32 hash = Hash(numData, erasureCount, erasureLocs);
+    for (unsigned int i = 0; i < entry_count; i++)
+    {
+        Entry& entry = entry_list[i];
+        if ((hash == entry.hash) && 
+            (numData == entry.num_data) && 
+            (erasureCount == entry.erasure_count) &&
+            (0 == memcmp(erasureLocs, entry.erasure_locs, erasureCount*sizeof(unsigned int))))
+        {
+            entry.last_use = ++use_count;
+            hit_count++;
+            return entry.content;
+        }
+    }
+    miss_count++;
+    return NULL;
+}  // end NormDecoderMatrixCache::Find()
+
+char* NormDecoderMatrixCache::Insert(unsigned int numData, unsigned int erasureCount, const unsigned int* erasureLocs, unsigned int contentSize)
+{
+    if (0 == entry_max) return NULL;
+    Entry* entry;
+    if (entry_count < entry_max)
+    {
+        entry = entry_list + entry_count++;
+    }
+    else
+    {
+        // Replace the least recently used entry
+        entry = entry_list;
+        for (unsigned int i = 1; i < entry_count; i++)
+        {
+            if (entry_list[i].last_use < entry->last_use)
+                entry = entry_list + i;
+        }
+    }
+    if ((NULL == entry->erasure_locs) || (entry->erasure_count < erasureCount))
+    {
+        if (NULL != entry->erasure_locs) delete[] entry->erasure_locs;
+        entry->erasure_count = 0;
+        if (NULL == (entry->erasure_locs = new unsigned int[erasureCount ? erasureCount : 1]))
+        {
+            PLOG(PL_ERROR, "NormDecoderMatrixCache::Insert() new erasure_locs error: %s\n", GetErrorString());
+            entry->hash = 0;
+            entry->num_data = 0;
+            return NULL;
+        }
+    }
+    if ((NULL == entry->content) || (entry->content_size < contentSize))
+    {
+        if (NULL != entry->content) delete[] entry->content;
+        entry->content_size = 0;
+        if (NULL == (entry->content = new char[contentSize ? contentSize : 1]))
+        {
+            PLOG(PL_ERROR, "NormDecoderMatrixCache::Insert() new content error: %s\n", GetErrorString());
+            entry->hash = 0;
+            entry->num_data = 0;
+            return NULL;
+        }
+        entry->content_size = contentSize;
+    }
+    memcpy(entry->erasure_locs, erasureLocs, erasureCount*sizeof(unsigned int));
+    entry->erasure_count = erasureCount;
+    entry->num_data = numData;
+    entry->hash = Hash(numData, erasureCount, erasureLocs);
+    entry->last_use = ++use_count;
+    return entry->content;
+}  // end NormDecoderMatrixCache::Insert()
+
+// Factories for the built-in codecs
+static NormEncoder* NewEncoderRS8() {return new NormEncoderRS8;}
+static NormDecoder* NewDecoderRS8() {return new NormDecoderRS8;}
+#ifndef NORM_NO_RS16
+static NormEncoder* NewEncoderRS16() {return new NormEncoderRS16;}
+static NormDecoder* NewDecoderRS16() {return new NormDecoderRS16;}
+#endif // !NORM_NO_RS16
+#ifndef NORM_NO_LDPC
+static NormEncoder* NewEncoderLDPC() {return new NormEncoderLDPC;}
+static NormDecoder* NewDecoderLDPC() {return new NormDecoderLDPC;}
+#endif // !NORM_NO_LDPC
+#ifdef ASSUME_MDP_FEC
+static NormEncoder* NewEncoderMDP() {return new NormEncoderMDP;}
+static NormDecoder* NewDecoderMDP() {return new NormDecoderMDP;}
+#endif // ASSUME_MDP_FEC
+
+NormFecRegistry::Entry NormFecRegistry::entry_list[ENTRY_MAX];
+unsigned int NormFecRegistry::entry_count = 0;
+bool NormFecRegistry::initialized = false;
+
+void NormFecRegistry::Init()
+{
+    initialized = true;
+    Register(2, 8, 0, "RS8", NewEncoderRS8, NewDecoderRS8);
+#ifndef NORM_NO_RS16
+    Register(2, 16, 0, "RS16", NewEncoderRS16, NewDecoderRS16);
+#endif // !NORM_NO_RS16
+    Register(5, 8, 0, "RS8", NewEncoderRS8, NewDecoderRS8);
+#ifdef ASSUME_MDP_FEC
+    Register(129, 8, 0, "MDP", NewEncoderMDP, NewDecoderMDP);
+#else
+    Register(129, 8, 0, "RS8", NewEncoderRS8, NewDecoderRS8);
+#endif // if/else ASSUME_MDP_FEC
+#ifndef NORM_NO_LDPC
+    Register(129, 8, NormEncoderLDPC::FEC_INSTANCE_ID, "LDPC", NewEncoderLDPC, NewDecoderLDPC);
+#endif // !NORM_NO_LDPC
+}  // end NormFecRegistry::Init()
+
+bool NormFecRegistry::Register(UINT8           fecId,
+                               UINT8           fecM,
+                               UINT16          instanceId,
+                               const char*     name,
+                               EncoderFactory  encoderFactory,
+                               DecoderFactory  decoderFactory)
+{
+    if (!initialized) Init();
+    Entry* entry = (Entry*)Find(fecId, fecM, instanceId);
+    if (NULL == entry)
+    {
+        if (entry_count >= ENTRY_MAX)
+        {
+            PLOG(PL_ERROR, "NormFecRegistry::Register() error: codec table is full\n");
+            return false;
+        }
+        entry = entry_list + entry_count++;
+    }
+    entry->fec_id = fecId;
+    entry->fec_m = fecM;
+    entry->instance_id = instanceId;
+    entry->name = name;
+    entry->encoder_factory = encoderFactory;
+    entry->decoder_factory = decoderFactory;
+    return true;
+}  // end NormFecRegistry::Register()
+
+const NormFecRegistry::Entry* NormFecRegistry::Find(UINT8 fecId, UINT8 fecM, UINT16 instanceId)
+{
+    if (!initialized) Init();
+    for (unsigned int i = 0; i < entry_count; i++)
+    {
+        const Entry& entry = entry_list[i];
+        if ((fecId == entry.fec_id) && (fecM == entry.fec_m) && (instanceId == entry.instance_id))
+            return &entry;
+    }
+    return NULL;
+}  // end NormFecRegistry::Find()
+
+const char* NormFecRegistry::GetName(UINT8 fecId, UINT8 fecM, UINT16 instanceId)
+{
+    const Entry* entry = Find(fecId, fecM, instanceId);
+    return (NULL != entry) ? entry->name : "UNKNOWN";
+}  // end NormFecRegistry::GetName()
+
+NormEncoder* NormFecRegistry::CreateEncoder(UINT8 fecId, UINT8 fecM, UINT16 instanceId)
+{
+    const Entry* entry = Find(fecId, fecM, instanceId);
+    if ((NULL == entry) || (NULL == entry->encoder_factory)) return NULL;
+    return entry->encoder_factory();
+}  // end NormFecRegistry::CreateEncoder()
+
+NormDecoder* NormFecRegistry::CreateDecoder(UINT8 fecId, UINT8 fecM, UINT16 instanceId)
+{
+    const Entry* entry = Find(fecId, fecM, instanceId);
+    if ((NULL == entry) || (NULL == entry->decoder_factory)) return NULL;
+    return entry->decoder_factory();
+}  // end NormFecRegistry::CreateDecoder()
@@ -0,0 +1,644 @@
+#include "normEncoderLDPC.h"
+#include "protoDebug.h"
+
+#ifdef SIMULATE
+#include "normMessage.h"
+#endif // SIMULATE
+
+#include <string.h>  // for memset(), memcpy()
+
+// dst[] ^= src[] (uses machine words when the vectors are suitably aligned)
+static inline void xor_vector(char* dst, const char* src, unsigned int len)
+{
+    if (0 == ((((size_t)dst) | ((size_t)src)) & (sizeof(unsigned long) - 1)))
+    {
+        unsigned long* d = (unsigned long*)dst;
+        const unsigned long* s = (const unsigned long*)src;
+        unsigned int nwords = len / sizeof(unsigned long);
+        for (unsigned int i = 0; i < nwords; i++)
+            d[i] ^= s[i];
+        unsigned int offset = nwords * sizeof(unsigned long);
+        dst += offset;
+        src += offset;
+        len -= offset;
+    }
+    for (unsigned int i = 0; i < len; i++)
+        dst[i] ^= src[i];
+}  // end xor_vector()
+
+// "Minimal standard" (Park-Miller) pseudo-random number generator used to
+// build the H1 matrix so that sender and receivers derive the same code
+// from the (numData, numParity) parameters alone.
+class NormLDPCRandom
+{
+    public:
+        NormLDPCRandom(INT32 seed) : state(seed) {}
+        // returns a value in the range 0..(maxValue-1)
+        unsigned int GetValue(unsigned int maxValue)
+        {
+            // (Schrage's method computes (16807 * state) mod (2^31 - 1) without overflow)
+            INT32 hi = state / 127773;
+            INT32 lo = state % 127773;
+            state = 16807*lo - 2836*hi;
+            if (state <= 0) state += 2147483647;
+            return (unsigned int)(((double)state / 2147483647.0) * maxValue) % maxValue;
+        }
+    private:
+        INT32   state;  // 1..(2^31 - 2)
+};  // end class NormLDPCRandom
+
+NormLDPCMatrix::NormLDPCMatrix()
+ : ndata(0), npar(0), col_start(NULL), col_row(NULL), row_start(NULL), row_col(NULL)
+{
+}
+
+NormLDPCMatrix::~NormLDPCMatrix()
+{
+    Destroy();
+}
+
+void NormLDPCMatrix::Destroy()
+{
+    if (NULL != row_col)
+    {
+        delete[] row_col;
+        row_col = NULL;
+    }
+    if (NULL != row_start)
+    {
+        delete[] row_start;
+        row_start = NULL;
+    }
+    if (NULL != col_row)
+    {
+        delete[] col_row;
+        col_row = NULL;
+    }
+    if (NULL != col_start)
+    {
+        delete[] col_start;
+        col_start = NULL;
+    }
+    ndata = npar = 0;
+}  // end NormLDPCMatrix::Destroy()
+
+bool NormLDPCMatrix::Init(unsigned int numData, unsigned int numParity)
+{
+    Destroy();
+    if ((0 == numData) || (0 == numParity))
+    {
+        PLOG(PL_FATAL, "NormLDPCMatrix::Init() error: invalid code parameters\n");
+        return false;
+    }
+    // 1) Each H1 column gets "n1" distinct rows drawn from a "pool" where each row
+    //    appears (nearly) the same number of times so the row degrees are balanced.
+    unsigned int n1 = (numParity < (unsigned int)N1) ? numParity : (unsigned int)N1;
+    unsigned int poolSize = n1 * numData;
+    // Rows with degree < 2 get up to 2 extra entries each (when numData is small)
+    unsigned int entryMax = poolSize + 2*numParity;
+    unsigned int* pool = new unsigned int[poolSize];
+    unsigned int* entryCol = new unsigned int[entryMax];
+    unsigned int* entryRow = new unsigned int[entryMax];
+    unsigned int* rowDegree = new unsigned int[numParity];
+    col_start = new unsigned int[numData + 1];
+    row_start = new unsigned int[numParity + 1];
+    if ((NULL == pool) || (NULL == entryCol) || (NULL == entryRow) || (NULL == rowDegree) ||
+        (NULL == col_start) || (NULL == row_start))
+    {
+        PLOG(PL_FATAL, "NormLDPCMatrix::Init() error: allocation failure: %s\n", GetErrorString());
+        if (NULL != pool) delete[] pool;
+        if (NULL != entryCol) delete[] entryCol;
+        if (NULL != entryRow) delete[] entryRow;
+        if (NULL != rowDegree) delete[] rowDegree;
+        Destroy();
+        return false;
+    }
+    for (unsigned int i = 0; i < poolSize; i++)
+        pool[i] = i % numParity;
+    memset(rowDegree, 0, numParity*sizeof(unsigned int));
+    NormLDPCRandom rand((INT32)((1 + numData + 65536*numParity) % 2147483647));
+    unsigned int entryCount = 0;
+    unsigned int poolCount = poolSize;
+    for (unsigned int col = 0; col < numData; col++)
+    {
+        unsigned int colFirst = entryCount;
+        for (unsigned int h = 0; h < n1; h++)
+        {
+            // Find a pool entry whose row is not already used in this column
+            unsigned int row = 0;
+            unsigned int index = 0;
+            bool found = false;
+            for (unsigned int attempt = 0; (attempt < 2*numParity) && (0 != poolCount); attempt++)
+            {
+                index = rand.GetValue(poolCount);
+                row = pool[index];
+                found = true;
+                for (unsigned int e = colFirst; e < entryCount; e++)
+                {
+                    if (entryRow[e] == row)
+                    {
+                        found = false;
+                        break;
+                    }
+                }
+                if (found) break;
+            }
+            if (found)
+            {
+                pool[index] = pool[--poolCount];
+            }
+            else
+            {
+                // Pool is exhausted (or only has rows already in this column), so
+                // pick the next free row after a random starting point instead
+                row = rand.GetValue(numParity);
+                bool conflict = true;
+                while (conflict)
+                {
+                    conflict = false;
+                    for (unsigned int e = colFirst; e < entryCount; e++)
+                    {
+                        if (entryRow[e] == row)
+                        {
+                            row = (row + 1) % numParity;
+                            conflict = true;
+                            break;
+                        }
+                    }
+                }
+            }
+            entryCol[entryCount] = col;
+            entryRow[entryCount++] = row;
+            rowDegree[row]++;
+        }
+    }
+    // 2) Make sure each row has degree >= 2 (only an issue for small blocks)
+    for (unsigned int row = 0; row < numParity; row++)
+    {
+        while ((rowDegree[row] < 2) && (rowDegree[row] < numData))
+        {
+            unsigned int col = rand.GetValue(numData);
+            bool used = false;
+            for (unsigned int e = 0; e < entryCount; e++)
+            {
+                if ((entryRow[e] == row) && (entryCol[e] == col))
+                {
+                    used = true;
+                    break;
+                }
+            }
+            if (used) continue;
+            entryCol[entryCount] = col;
+            entryRow[entryCount++] = row;
+            rowDegree[row]++;
+        }
+    }
+    delete[] pool;
+    // 3) Build the column-wise and row-wise "compressed" adjacency lists
+    col_row = new unsigned int[entryCount];
+    row_col = new unsigned int[entryCount];
+    if ((NULL == col_row) || (NULL == row_col))
+    {
+        PLOG(PL_FATAL, "NormLDPCMatrix::Init() error: allocation failure: %s\n", GetErrorString());
+        delete[] entryCol;
+        delete[] entryRow;
+        delete[] rowDegree;
+        Destroy();
+        return false;
+    }
+    memset(col_start, 0, (numData + 1)*sizeof(unsigned int));
+    memset(row_start, 0, (numParity + 1)*sizeof(unsigned int));
+    for (unsigned int e = 0; e < entryCount; e++)
+    {
+        col_start[entryCol[e] + 1]++;
+        row_start[entryRow[e] + 1]++;
+    }
+    for (unsigned int col = 0; col < numData; col++)
+        col_start[col + 1] += col_start[col];
+    for (unsigned int row = 0; row < numParity; row++)
+        row_start[row + 1] += row_start[row];
+    // (uses "rowDegree" as a fill index for the row lists)
+    memset(rowDegree, 0, numParity*sizeof(unsigned int));
+    unsigned int* colFill = entryRow;  // reuse as column fill index after copying rows
+    for (unsigned int e = 0; e < entryCount; e++)
+    {
+        unsigned int row = entryRow[e];
+        row_col[row_start[row] + rowDegree[row]++] = entryCol[e];
+    }
+    memset(colFill, 0, numData*sizeof(unsigned int));
+    for (unsigned int row = 0; row < numParity; row++)
+    {
+        for (unsigned int i = row_start[row]; i < row_start[row+1]; i++)
+        {
+            unsigned int col = row_col[i];
+            col_row[col_start[col] + colFill[col]++] = row;
+        }
+    }
+    delete[] entryCol;
+    delete[] entryRow;
+    delete[] rowDegree;
+    ndata = numData;
+    npar = numParity;
+    return true;
+}  // end NormLDPCMatrix::Init()
+
+NormEncoderLDPC::NormEncoderLDPC()
+ : ndata(0), npar(0), vector_size(0)
+{
+}
+
+NormEncoderLDPC::~NormEncoderLDPC()
+{
+    Destroy();
+}
+
+bool NormEncoderLDPC::Init(unsigned int numData, unsigned int numParity, UINT16 vecSizeMax)
+{
+#ifdef SIMULATE
+    vecSizeMax = MIN(SIM_PAYLOAD_MAX, vecSizeMax);
+#endif // SIMULATE
+    if ((numData + numParity) > 65535)
+    {
+        PLOG(PL_FATAL, "NormEncoderLDPC::Init() error: numData/numParity exceeds code limits\n");
+        return false;
+    }
+    Destroy();
+    if (!matrix.Init(numData, numParity))
+    {
+        PLOG(PL_FATAL, "NormEncoderLDPC::Init() error: unable to build parity check matrix\n");
+        return false;
+    }
+    ndata = numData;
+    npar = numParity;
+    vector_size = vecSizeMax;
+    return true;
+}  // end NormEncoderLDPC::Init()
+
+void NormEncoderLDPC::Destroy()
+{
+    matrix.Destroy();
+    ndata = npar = 0;
+}  // end NormEncoderLDPC::Destroy()
+
+// Accumulates the source symbol into the H1 rows of its column.  The parity
+// vectors are not complete until EncodeFinish() has been called.
+void NormEncoderLDPC::Encode(unsigned int segmentId, const char* dataVector, char** parityVectorList)
+{
+    ASSERT(segmentId < ndata);
+    for (unsigned int i = matrix.ColBegin(segmentId); i < matrix.ColEnd(segmentId); i++)
+        xor_vector(parityVectorList[matrix.ColRow(i)], dataVector, vector_size);
+}  // end NormEncoderLDPC::Encode()
+
+// Applies the "staircase" (p_i = x_i + p_(i-1)).  Source symbols beyond
+// "numData" (i.e., for a short last block) are implicitly zero.
+void NormEncoderLDPC::EncodeFinish(unsigned int numData, char** parityVectorList)
+{
+    for (unsigned int i = 1; i < npar; i++)
+        xor_vector(parityVectorList[i], parityVectorList[i-1], vector_size);
+}  // end NormEncoderLDPC::EncodeFinish()
+
+
+NormDecoderLDPC::NormDecoderLDPC()
+ : ndata(0), npar(0), vector_size(0), rhs_buffer(NULL), rhs_list(NULL),
+   row_unknown_count(NULL), row_unknown_sum(NULL), row_queue(NULL), symbol_value(NULL)
+{
+}
+
+NormDecoderLDPC::~NormDecoderLDPC()
+{
+    Destroy();
+}
+
+void NormDecoderLDPC::Destroy()
+{
+    matrix.Destroy();
+    if (NULL != symbol_value)
+    {
+        delete[] symbol_value;
+        symbol_value = NULL;
+    }
+    if (NULL != row_queue)
+    {
+        delete[] row_queue;
+        row_queue = NULL;
+    }
+    if (NULL != row_unknown_sum)
+    {
+        delete[] row_unknown_sum;
+        row_unknown_sum = NULL;
+    }
+    if (NULL != row_unknown_count)
+    {
+        delete[] row_unknown_count;
+        row_unknown_count = NULL;
+    }
+    if (NULL != rhs_list)
+    {
+        delete[] rhs_list;
+        rhs_list = NULL;
+    }
+    if (NULL != rhs_buffer)
+    {
+        delete[] rhs_buffer;
+        rhs_buffer = NULL;
+    }
+    ndata = npar = 0;
+}  // end NormDecoderLDPC::Destroy()
+
+bool NormDecoderLDPC::Init(unsigned int numData, unsigned int numParity, UINT16 vecSizeMax)
+{
+#ifdef SIMULATE
+    vecSizeMax = MIN(SIM_PAYLOAD_MAX, vecSizeMax);
+#endif // SIMULATE
+    if ((numData + numParity) > 65535)
+    {
+        PLOG(PL_FATAL, "NormDecoderLDPC::Init() error: numData/numParity exceeds code limits\n");
+        return false;
+    }
+    Destroy();
+    if (!matrix.Init(numData, numParity))
+    {
+        PLOG(PL_FATAL, "NormDecoderLDPC::Init() error: unable to build parity check matrix\n");
+        return false;
+    }
+    if ((NULL == (rhs_buffer = new char[(unsigned long)numParity * vecSizeMax])) ||
+        (NULL == (rhs_list = new char*[numParity])) ||
+        (NULL == (row_unknown_count = new unsigned int[numParity])) ||
+        (NULL == (row_unknown_sum = new unsigned int[numParity])) ||
+        (NULL == (row_queue = new unsigned int[numParity])) ||
+        (NULL == (symbol_value = new const char*[numData + numParity])))
+    {
+        PLOG(PL_FATAL, "NormDecoderLDPC::Init() error: allocation failure: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
+    for (unsigned int i = 0; i < numParity; i++)
+        rhs_list[i] = rhs_buffer + ((unsigned long)i * vecSizeMax);
+    ndata = numData;
+    npar = numParity;
+    vector_size = vecSizeMax;
+    return true;
+}  // end NormDecoderLDPC::Init()
+
+// Symbols are indexed 0..(ndata-1) for source symbols and ndata..(ndata+npar-1)
+// for parity symbols, independent of "numData" (parity vector "i" of a short
+// block is vectorList[numData+i]).  Parity check equation (row) "r" is
+// (sum of H1 row "r" source symbols) + p_r + p_(r-1) = 0.  Only the erased
+// source vectors are written to, so the erased parity vectors may be NULL.
+int NormDecoderLDPC::Decode(char** vectorList, unsigned int numData,  unsigned int erasureCount, unsigned int* erasureLocs)
+{
+    unsigned int sourceErasures = 0;
+    while ((sourceErasures < erasureCount) && (erasureLocs[sourceErasures] < numData))
+        sourceErasures++;
+    if (0 == sourceErasures) return erasureCount;  // nothing to decode
+
+    // 1) Mark the known and unknown symbols.  Source symbols beyond "numData"
+    //    are zero and simply skipped when the equations are summed.
+    for (unsigned int i = 0; i < numData; i++)
+        symbol_value[i] = vectorList[i];
+    for (unsigned int i = numData; i < ndata; i++)
+        symbol_value[i] = NULL;
+    for (unsigned int i = 0; i < npar; i++)
+        symbol_value[ndata + i] = vectorList[numData + i];
+    for (unsigned int e = 0; e < erasureCount; e++)
+    {
+        unsigned int loc = erasureLocs[e];
+        if (loc < numData)
+            symbol_value[loc] = NULL;
+        else
+            symbol_value[ndata + loc - numData] = NULL;
+    }
+
+    // 2) Sum the known symbols of each equation into its "right hand side"
+    unsigned int queueCount = 0;
+    for (unsigned int row = 0; row < npar; row++)
+    {
+        char* rhs = rhs_list[row];
+        memset(rhs, 0, vector_size);
+        unsigned int count = 0;
+        unsigned int sum = 0;
+        for (unsigned int i = matrix.RowBegin(row); i < matrix.RowEnd(row); i++)
+        {
+            unsigned int col = matrix.RowCol(i);
+            if (col >= numData) continue;
+            if (NULL != symbol_value[col])
+            {
+                xor_vector(rhs, symbol_value[col], vector_size);
+            }
+            else
+            {
+                count++;
+                sum ^= col;
+            }
+        }
+        // The "staircase" parity symbols p_r and p_(r-1)
+        unsigned int stairCount = (0 != row) ? 2 : 1;
+        for (unsigned int j = 0; j < stairCount; j++)
+        {
+            unsigned int p = ndata + row - j;
+            if (NULL != symbol_value[p])
+            {
+                xor_vector(rhs, symbol_value[p], vector_size);
+            }
+            else
+            {
+                count++;
+                sum ^= p;
+            }
+        }
+        row_unknown_count[row] = count;
+        row_unknown_sum[row] = sum;
+        if (1 == count) row_queue[queueCount++] = row;
+    }
+
+    // 3) "Peel" off equations with a single unknown symbol.  A row is queued
+    //    (at most once) when its unknown count reaches one.
+    unsigned int sourceRecovered = 0;
+    for (unsigned int q = 0; (q < queueCount) && (sourceRecovered < sourceErasures); q++)
+    {
+        unsigned int row = row_queue[q];
+        if (1 != row_unknown_count[row]) continue;  // already consumed
+        unsigned int sym = row_unknown_sum[row];
+        row_unknown_count[row] = 0;
+        const char* value = rhs_list[row];
+        if (sym < ndata)
+        {
+            memcpy(vectorList[sym], value, vector_size);
+            value = vectorList[sym];
+            sourceRecovered++;
+        }
+        // (else the "rhs" vector of this consumed row now holds the parity value)
+        symbol_value[sym] = value;
+        // Remove the recovered symbol from the other equations it appears in
+        unsigned int rowList[2];
+        unsigned int rowCount = 0;
+        unsigned int index = 0;
+        unsigned int indexEnd = 0;
+        if (sym < ndata)
+        {
+            index = matrix.ColBegin(sym);
+            indexEnd = matrix.ColEnd(sym);
+        }
+        else
+        {
+            rowList[rowCount++] = sym - ndata;
+            if ((sym - ndata + 1) < npar) rowList[rowCount++] = sym - ndata + 1;
+        }
+        while (true)
+        {
+            unsigned int r;
+            if (index < indexEnd)
+                r = matrix.ColRow(index++);
+            else if (0 != rowCount)
+                r = rowList[--rowCount];
+            else
+                break;
+            if (0 == row_unknown_count[r]) continue;
+            xor_vector(rhs_list[r], value, vector_size);
+            row_unknown_sum[r] ^= sym;
+            if (1 == --row_unknown_count[r])
+                row_queue[queueCount++] = r;
+        }
+    }
+    if (sourceRecovered < sourceErasures)
+    {
+        // 4) Peeling stalled, so try Gaussian elimination on what is left
+        if (!SolveResidual(numData, vectorList))
+        {
+            PLOG(PL_DEBUG, "NormDecoderLDPC::Decode() unable to decode block (need more parity)\n");
+            return 0;
+        }
+    }
+    return erasureCount;
+}  // end NormDecoderLDPC::Decode()
+
+// Gauss-Jordan elimination over GF(2) of the equations and unknown symbols
+// remaining after peeling.  The unknown parity symbol columns are ordered
+// first so that only the source symbol columns need a pivot.
+bool NormDecoderLDPC::SolveResidual(unsigned int numData, char** vectorList)
+{
+    const unsigned int PIVOT_FLAG = 0x80000000;
+    unsigned int numRows = 0;
+    for (unsigned int row = 0; row < npar; row++)
+        if (0 != row_unknown_count[row]) row_queue[numRows++] = row;  // reuse as list of rows
+    unsigned int numSyms = 0;
+    unsigned int numParitySyms = 0;
+    for (unsigned int i = 0; i < npar; i++)
+        if (NULL == symbol_value[ndata + i]) numParitySyms++;
+    unsigned int numSourceSyms = 0;
+    for (unsigned int i = 0; i < numData; i++)
+        if (NULL == symbol_value[i]) numSourceSyms++;
+    numSyms = numParitySyms + numSourceSyms;
+    if (numRows < numSourceSyms) return false;
+
+    // Map symbol indices to matrix columns and build the (dense) bit matrix
+    unsigned int* symCol = new unsigned int[ndata + npar];
+    unsigned int* colSym = new unsigned int[numSyms];
+    unsigned int rowWords = (numSyms + 31) / 32;
+    UINT32* bits = new UINT32[(unsigned long)numRows * rowWords];
+    if ((NULL == symCol) || (NULL == colSym) || (NULL == bits))
+    {
+        PLOG(PL_ERROR, "NormDecoderLDPC::SolveResidual() error: allocation failure: %s\n", GetErrorString());
+        if (NULL != bits) delete[] bits;
+        if (NULL != colSym) delete[] colSym;
+        if (NULL != symCol) delete[] symCol;
+        return false;
+    }
+    unsigned int c = 0;
+    for (unsigned int i = 0; i < npar; i++)
+        if (NULL == symbol_value[ndata + i])
+        {
+            colSym[c] = ndata + i;
+            symCol[ndata + i] = c++;
+        }
+    for (unsigned int i = 0; i < numData; i++)
+        if (NULL == symbol_value[i])
+        {
+            colSym[c] = i;
+            symCol[i] = c++;
+        }
+    memset(bits, 0, (unsigned long)numRows * rowWords * sizeof(UINT32));
+    for (unsigned int n = 0; n < numRows; n++)
+    {
+        unsigned int row = row_queue[n];
+        UINT32* b = bits + (unsigned long)n * rowWords;
+        for (unsigned int i = matrix.RowBegin(row); i < matrix.RowEnd(row); i++)
+        {
+            unsigned int col = matrix.RowCol(i);
+            if ((col < numData) && (NULL == symbol_value[col]))
+                b[symCol[col] >> 5] |= (UINT32)1 << (symCol[col] & 31);
+        }
+        if (NULL == symbol_value[ndata + row])
+            b[symCol[ndata + row] >> 5] |= (UINT32)1 << (symCol[ndata + row] & 31);
+        if ((0 != row) && (NULL == symbol_value[ndata + row - 1]))
+            b[symCol[ndata + row - 1] >> 5] |= (UINT32)1 << (symCol[ndata + row - 1] & 31);
+    }
+
+    // Eliminate, applying the same row operations to the "rhs" vectors
+    bool result = true;
+    unsigned int pivotCount = 0;
+    for (c = 0; c < numSyms; c++)
+    {
+        unsigned int word = c >> 5;
+        UINT32 mask = (UINT32)1 << (c & 31);
+        unsigned int pivot = pivotCount;
+        while ((pivot < numRows) && (0 == (bits[(unsigned long)pivot*rowWords + word] & mask)))
+            pivot++;
+        if (pivot == numRows)
+        {
+            // No pivot is OK for a parity symbol, but not for a source symbol
+            if (colSym[c] < ndata)
+            {
+                result = false;
+                break;
+            }
+            continue;
+        }
+        UINT32* p = bits + (unsigned long)pivot*rowWords;
+        if (pivot != pivotCount)
+        {
+            // Swap rows
+            UINT32* q = bits + (unsigned long)pivotCount*rowWords;
+            for (unsigned int w = 0; w < rowWords; w++)
+            {
+                UINT32 tmp = p[w];
+                p[w] = q[w];
+                q[w] = tmp;
+            }
+            p = q;
+            unsigned int tmp = row_queue[pivot];
+            row_queue[pivot] = row_queue[pivotCount];
+            row_queue[pivotCount] = tmp;
+        }
+        const char* pivotRhs = rhs_list[row_queue[pivotCount]];
+        for (unsigned int n = 0; n < numRows; n++)
+        {
+            if (n == pivotCount) continue;
+            UINT32* b = bits + (unsigned long)n*rowWords;
+            if (0 == (b[word] & mask)) continue;
+            for (unsigned int w = word; w < rowWords; w++)
+                b[w] ^= p[w];
+            xor_vector(rhs_list[row_queue[n]], pivotRhs, vector_size);
+        }
+        colSym[c] |= PIVOT_FLAG;  // marks column as having pivot row "pivotCount"
+        pivotCount++;
+    }
+    if (result)
+    {
+        // The source symbol columns are last and all have a pivot, so each of
+        // their pivot rows has been reduced to that source symbol alone
+        pivotCount = 0;
+        for (c = 0; c < numSyms; c++)
+        {
+            if (0 == (colSym[c] & PIVOT_FLAG)) continue;
+            unsigned int sym = colSym[c] & ~PIVOT_FLAG;
+            if (sym < ndata)
+                memcpy(vectorList[sym], rhs_list[row_queue[pivotCount]], vector_size);
+            pivotCount++;
+        }
+    }
+    delete[] bits;
+    delete[] colSym;
+    delete[] symCol;
+    return result;
+}  // end NormDecoderLDPC::SolveResidual()
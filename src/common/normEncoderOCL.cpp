@@ -0,0 +1,314 @@
+#include "normEncoderOCL.h"
+
+#ifdef NORM_OPENCL
+#include "galois.h"  // for Norm::GNIBBLE tables
+
+#include <string.h>  // for memcpy(), memset()
+
+// Each work-item computes one 32-bit word of one parity vector of one block
+// (global ids: word, parity row, block) as the GF(2^8) dot product of the
+// parity row's coefficients and the block's source words.  Products are
+// formed from the 32-byte "split nibble" tables (tbl[n] = c*n and
+// tbl[16+n] = c*(n << 4)) that the CPU kernels use, kept in local memory.
+static const char* const NORM_OCL_ENCODE_SOURCE =
+"__kernel void NormEncodeRS8(__global const uint*   data,\n"
+"                            __global uint*         parity,\n"
+"                            __global const uint*   numData,\n"
+"                            __global const uchar*  matrix,\n"
+"                            __global const uchar*  nibble,\n"
+"                            uint ndata, uint npar, uint words)\n"
+"{\n"
+"    __local uchar tbl[256*32];\n"
+"    for (uint i = get_local_id(0); i < 256*32; i += get_local_size(0))\n"
+"        tbl[i] = nibble[i];\n"
+"    barrier(CLK_LOCAL_MEM_FENCE);\n"
+"    uint w = get_global_id(0);\n"
+"    if (w >= words) return;\n"
+"    uint r = get_global_id(1);\n"
+"    uint b = get_global_id(2);\n"
+"    uint k = numData[b];\n"
+"    __global const uchar* row = matrix + r*ndata;\n"
+"    __global const uint* src = data + (size_t)b*ndata*words + w;\n"
+"    uint acc = 0;\n"
+"    for (uint j = 0; j < k; j++)\n"
+"    {\n"
+"        __local const uchar* t = tbl + 32*row[j];\n"
+"        uint x = src[(size_t)j*words];\n"
+"        acc ^= (uint)(t[x & 15] ^ t[16 + ((x >> 4) & 15)]) |\n"
+"               ((uint)(t[(x >> 8) & 15] ^ t[16 + ((x >> 12) & 15)]) << 8) |\n"
+"               ((uint)(t[(x >> 16) & 15] ^ t[16 + ((x >> 20) & 15)]) << 16) |\n"
+"               ((uint)(t[(x >> 24) & 15] ^ t[16 + (x >> 28)]) << 24);\n"
+"    }\n"
+"    parity[((size_t)b*npar + r)*words + w] = acc;\n"
+"}\n";
+
+// Device (and host staging) memory budget for a batch's source vectors
+#define BATCH_BYTES_MAX (64*1024*1024)
+
+NormEncoderOCL::NormEncoderOCL()
+ : vector_words(0), batch_max(0), cl_ctx(NULL), cl_queue(NULL), cl_prog(NULL), cl_encode(NULL),
+   data_mem(NULL), parity_mem(NULL), count_mem(NULL), matrix_mem(NULL), nibble_mem(NULL),
+   group_size(1), data_stage(NULL), parity_stage(NULL)
+{
+    device_name[0] = '\0';
+}
+
+NormEncoderOCL::~NormEncoderOCL()
+{
+    DestroyDevice();
+}
+
+bool NormEncoderOCL::Init(unsigned int numData, unsigned int numParity, UINT16 vectorSize)
+{
+    Destroy();
+    if (!NormEncoderRS8::Init(numData, numParity, vectorSize)) return false;
+    if (InitDevice())
+        PLOG(PL_INFO, "NormEncoderOCL::Init() encoding on OpenCL device \"%s\"\n", device_name);
+    else
+        PLOG(PL_WARN, "NormEncoderOCL::Init() warning: no usable OpenCL device, using CPU encoding\n");
+    return true;  // (CPU encoding otherwise)
+}  // end NormEncoderOCL::Init()
+
+void NormEncoderOCL::Destroy()
+{
+    DestroyDevice();
+    NormEncoderRS8::Destroy();
+}  // end NormEncoderOCL::Destroy()
+
+bool NormEncoderOCL::InitDevice()
+{
+    DestroyDevice();
+    // Use the first GPU (or else accelerator) device of any platform
+    cl_platform_id platformList[8];
+    cl_uint numPlatforms = 0;
+    if ((CL_SUCCESS != clGetPlatformIDs(8, platformList, &numPlatforms)) || (0 == numPlatforms))
+    {
+        PLOG(PL_INFO, "NormEncoderOCL::InitDevice() no OpenCL platform found\n");
+        return false;
+    }
+    if (numPlatforms > 8) numPlatforms = 8;
+    const cl_device_type typeList[2] = {CL_DEVICE_TYPE_GPU, CL_DEVICE_TYPE_ACCELERATOR};
+    cl_device_id device = NULL;
+    for (unsigned int t = 0; (t < 2) && (NULL == device); t++)
+    {
+        for (cl_uint p = 0; p < numPlatforms; p++)
+        {
+            if (CL_SUCCESS == clGetDeviceIDs(platformList[p], typeList[t], 1, &device, NULL)) break;
+            device = NULL;
+        }
+    }
+    if (NULL == device)
+    {
+        PLOG(PL_INFO, "NormEncoderOCL::InitDevice() no OpenCL GPU device found\n");
+        return false;
+    }
+    if (CL_SUCCESS != clGetDeviceInfo(device, CL_DEVICE_NAME, sizeof(device_name), device_name, NULL))
+        strcpy(device_name, "unknown");
+    device_name[sizeof(device_name) - 1] = '\0';
+
+    cl_int err = CL_SUCCESS;
+    if (NULL == (cl_ctx = clCreateContext(NULL, 1, &device, NULL, NULL, &err)))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clCreateContext() error: %d\n", err);
+        return false;
+    }
+    const char* source = NORM_OCL_ENCODE_SOURCE;
+    if (NULL == (cl_prog = clCreateProgramWithSource(cl_ctx, 1, &source, NULL, &err)))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clCreateProgramWithSource() error: %d\n", err);
+        DestroyDevice();
+        return false;
+    }
+    if (CL_SUCCESS != (err = clBuildProgram(cl_prog, 1, &device, NULL, NULL, NULL)))
+    {
+        char buildLog[1024];
+        buildLog[0] = '\0';
+        clGetProgramBuildInfo(cl_prog, device, CL_PROGRAM_BUILD_LOG, sizeof(buildLog), buildLog, NULL);
+        buildLog[sizeof(buildLog) - 1] = '\0';
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clBuildProgram() error: %d\n%s\n", err, buildLog);
+        DestroyDevice();
+        return false;
+    }
+    if (NULL == (cl_encode = clCreateKernel(cl_prog, "NormEncodeRS8", &err)))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clCreateKernel() error: %d\n", err);
+        DestroyDevice();
+        return false;
+    }
+    if (CL_SUCCESS != clGetKernelWorkGroupInfo(cl_encode, device, CL_KERNEL_WORK_GROUP_SIZE,
+                                               sizeof(group_size), &group_size, NULL))
+        group_size = 1;
+    if (group_size > 256) group_size = 256;
+    if (0 == group_size) group_size = 1;
+
+    // The device vectors are padded to whole 32-bit words
+    unsigned int ndata = GetNumData();
+    unsigned int npar = GetNumParity();
+    vector_words = (GetVectorSize() + 3) / 4;
+    unsigned long blockBytes = (unsigned long)ndata * vector_words * 4;
+    batch_max = (unsigned int)(BATCH_BYTES_MAX / blockBytes);
+    if (batch_max > BATCH_MAX) batch_max = BATCH_MAX;
+    if (0 == batch_max) batch_max = 1;
+    size_t dataBytes = (size_t)batch_max * blockBytes;
+    size_t parityBytes = (size_t)batch_max * npar * vector_words * 4;
+    if ((NULL == (data_mem = clCreateBuffer(cl_ctx, CL_MEM_READ_ONLY, dataBytes, NULL, &err))) ||
+        (NULL == (parity_mem = clCreateBuffer(cl_ctx, CL_MEM_WRITE_ONLY, parityBytes, NULL, &err))) ||
+        (NULL == (count_mem = clCreateBuffer(cl_ctx, CL_MEM_READ_ONLY, batch_max * sizeof(cl_uint), NULL, &err))) ||
+        (NULL == (matrix_mem = clCreateBuffer(cl_ctx, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, npar * ndata,
+                                              (void*)GetParityMatrix(), &err))) ||
+        (NULL == (nibble_mem = clCreateBuffer(cl_ctx, CL_MEM_READ_ONLY | CL_MEM_COPY_HOST_PTR, 256*32,
+                                              (void*)Norm::GNIBBLE, &err))))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clCreateBuffer() error: %d\n", err);
+        DestroyDevice();
+        return false;
+    }
+    if ((NULL == (data_stage = new char[dataBytes])) || (NULL == (parity_stage = new char[parityBytes])))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() new staging buffer error: %s\n", GetErrorString());
+        DestroyDevice();
+        return false;
+    }
+    memset(data_stage, 0, dataBytes);  // (so the word padding is defined)
+    cl_uint numData = ndata;
+    cl_uint numParity = npar;
+    cl_uint numWords = vector_words;
+    if ((CL_SUCCESS != (err = clSetKernelArg(cl_encode, 0, sizeof(cl_mem), &data_mem))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 1, sizeof(cl_mem), &parity_mem))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 2, sizeof(cl_mem), &count_mem))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 3, sizeof(cl_mem), &matrix_mem))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 4, sizeof(cl_mem), &nibble_mem))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 5, sizeof(cl_uint), &numData))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 6, sizeof(cl_uint), &numParity))) ||
+        (CL_SUCCESS != (err = clSetKernelArg(cl_encode, 7, sizeof(cl_uint), &numWords))))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clSetKernelArg() error: %d\n", err);
+        DestroyDevice();
+        return false;
+    }
+    // (the command queue is created last since it marks the device as usable)
+    if (NULL == (cl_queue = clCreateCommandQueue(cl_ctx, device, 0, &err)))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::InitDevice() clCreateCommandQueue() error: %d\n", err);
+        DestroyDevice();
+        return false;
+    }
+    return true;
+}  // end NormEncoderOCL::InitDevice()
+
+void NormEncoderOCL::DestroyDevice()
+{
+    if (NULL != cl_queue)
+    {
+        clReleaseCommandQueue(cl_queue);
+        cl_queue = NULL;
+    }
+    cl_mem* memList[5] = {&data_mem, &parity_mem, &count_mem, &matrix_mem, &nibble_mem};
+    for (unsigned int i = 0; i < 5; i++)
+    {
+        if (NULL != *memList[i])
+        {
+            clReleaseMemObject(*memList[i]);
+            *memList[i] = NULL;
+        }
+    }
+    if (NULL != cl_encode)
+    {
+        clReleaseKernel(cl_encode);
+        cl_encode = NULL;
+    }
+    if (NULL != cl_prog)
+    {
+        clReleaseProgram(cl_prog);
+        cl_prog = NULL;
+    }
+    if (NULL != cl_ctx)
+    {
+        clReleaseContext(cl_ctx);
+        cl_ctx = NULL;
+    }
+    if (NULL != data_stage)
+    {
+        delete[] data_stage;
+        data_stage = NULL;
+    }
+    if (NULL != parity_stage)
+    {
+        delete[] parity_stage;
+        parity_stage = NULL;
+    }
+    batch_max = 0;
+}  // end NormEncoderOCL::DestroyDevice()
+
+void NormEncoderOCL::EncodeBlocks(unsigned int          numBlocks,
+                                  const char***         dataVectorLists,
+                                  const unsigned int*   numDataList,
+                                  char***               parityVectorLists)
+{
+    unsigned int index = 0;
+    while ((index < numBlocks) && IsOffloaded())
+    {
+        unsigned int count = numBlocks - index;
+        if (count > batch_max) count = batch_max;
+        if (!EncodeBatch(count, dataVectorLists + index, numDataList + index, parityVectorLists + index))
+        {
+            PLOG(PL_ERROR, "NormEncoderOCL::EncodeBlocks() error: OpenCL device failed, reverting to CPU encoding\n");
+            DestroyDevice();
+            break;
+        }
+        index += count;
+    }
+    // (CPU encoding of whatever the device didn't do)
+    if (index < numBlocks)
+        NormEncoderRS8::EncodeBlocks(numBlocks - index, dataVectorLists + index,
+                                     numDataList + index, parityVectorLists + index);
+}  // end NormEncoderOCL::EncodeBlocks()
+
+// Stages "numBlocks" (up to "batch_max") blocks to the device, runs the
+// kernel once for all of them and reads their parity back
+bool NormEncoderOCL::EncodeBatch(unsigned int          numBlocks,
+                                 const char***         dataVectorLists,
+                                 const unsigned int*   numDataList,
+                                 char***               parityVectorLists)
+{
+    unsigned int ndata = GetNumData();
+    unsigned int npar = GetNumParity();
+    unsigned int vecSize = GetVectorSize();
+    size_t stride = (size_t)vector_words * 4;
+    cl_uint countList[BATCH_MAX];
+    for (unsigned int b = 0; b < numBlocks; b++)
+    {
+        char* ptr = data_stage + ((size_t)b * ndata * stride);
+        unsigned int numData = numDataList[b];
+        ASSERT(numData <= ndata);
+        for (unsigned int j = 0; j < numData; j++)
+            memcpy(ptr + (j * stride), dataVectorLists[b][j], vecSize);
+        countList[b] = numData;
+    }
+    cl_int err;
+    size_t dataBytes = (size_t)numBlocks * ndata * stride;
+    size_t parityBytes = (size_t)numBlocks * npar * stride;
+    // (the ND range is padded to whole work-groups of vector words)
+    size_t globalSize[3] = {((vector_words + group_size - 1) / group_size) * group_size, npar, numBlocks};
+    size_t localSize[3] = {group_size, 1, 1};
+    if ((CL_SUCCESS != (err = clEnqueueWriteBuffer(cl_queue, data_mem, CL_FALSE, 0, dataBytes, data_stage, 0, NULL, NULL))) ||
+        (CL_SUCCESS != (err = clEnqueueWriteBuffer(cl_queue, count_mem, CL_FALSE, 0, numBlocks * sizeof(cl_uint), countList, 0, NULL, NULL))) ||
+        (CL_SUCCESS != (err = clEnqueueNDRangeKernel(cl_queue, cl_encode, 3, NULL, globalSize, localSize, 0, NULL, NULL))) ||
+        (CL_SUCCESS != (err = clEnqueueReadBuffer(cl_queue, parity_mem, CL_TRUE, 0, parityBytes, parity_stage, 0, NULL, NULL))))
+    {
+        PLOG(PL_ERROR, "NormEncoderOCL::EncodeBatch() OpenCL error: %d\n", err);
+        clFinish(cl_queue);  // (so no pending transfer still uses the staging buffers)
+        return false;
+    }
+    // (the parity vectors are overwritten, which is the same as accumulating
+    //  into the zero-initialized vectors the EncodeBlock() contract requires)
+    for (unsigned int b = 0; b < numBlocks; b++)
+    {
+        const char* ptr = parity_stage + ((size_t)b * npar * stride);
+        for (unsigned int i = 0; i < npar; i++)
+            memcpy(parityVectorLists[b][i], ptr + (i * stride), vecSize);
+    }
+    return true;
+}  // end NormEncoderOCL::EncodeBatch()
+
+#endif // NORM_OPENCL
@@ -34,6 +34,7 @@
 
 
 #include "normEncoderRS16.h"
+#include "normGFKernel.h"  // for SIMD multiply-accumulate kernels
 #include "protoDebug.h"
 #ifdef SIMULATE
 #include "normMessage.h"
@@ -258,8 +259,37 @@ static void generate_gf()
     if (c != 0) addmul1(dst, src, c, sz)
 #define UNROLL 16 /* 1, 4, 8, 16 */
 
+// The SIMD multiply-accumulate kernel (if any) is chosen by the encoder/decoder
+// Init() methods (see normGFKernel.h).  Vectors shorter than GF_KERNEL_MIN
+// symbols are not worth the nibble table setup and use log/exp lookups.
+#if (GF_BITS > 8)
+static NormGFKernel::AddMul16 gf_kernel = (NormGFKernel::AddMul16)0;
+#define GF_KERNEL_MIN 64
+#endif // GF_BITS > 8
+
 static void addmul1(gf* dst1, gf* src1, gf c, int sz)
 {
+#if (GF_BITS > 8)
+    if ((NULL != gf_kernel) && (sz >= GF_KERNEL_MIN))
+    {
+        // Tables of c times each 4-bit nibble value at each nibble position,
+        // built from the 16 products c*(1 << j) since multiplication is linear
+        gf nibbleTable[64];
+        for (int i = 0; i < 4; i++)
+        {
+            gf* t = nibbleTable + 16*i;
+            t[0] = 0;
+            for (int b = 0; b < 4; b++)
+            {
+                gf v = gf_mul(c, 1 << (4*i + b));
+                for (int n = 0; n < (1 << b); n++)
+                    t[(1 << b) + n] = t[n] ^ v;
+            }
+        }
+        gf_kernel(dst1, src1, nibbleTable, sz);
+        return;
+    }
+#endif // GF_BITS > 8
     USE_GF_MULC ;
     gf* dst = dst1;
     gf* src = src1 ;
@@ -384,6 +414,9 @@ static void init_fec()
         init_mul_table();
         fec_initialized = true;
     }
+#if (GF_BITS > 8)
+    gf_kernel = NormGFKernel::GetAddMul16();
+#endif // GF_BITS > 8
 }
 
 NormEncoderRS16::NormEncoderRS16()
@@ -496,6 +529,7 @@ NormDecoderRS16::~NormDecoderRS16()
 
 void NormDecoderRS16::Destroy()
 {
+    matrix_cache.Clear();  // cached patterns are specific to the code parameters
     if (NULL != enc_matrix)
     {
         delete[] enc_matrix;
@@ -648,6 +682,69 @@ bool NormDecoderRS16::Init(unsigned int numData, unsigned int numParity, UINT16
 
 
 int NormDecoderRS16::Decode(char** vectorList, unsigned int numData,  unsigned int erasureCount, unsigned int* erasureLocs)
+{
+    // 0) Check for a cached decoding matrix for this erasure pattern.  The
+    //    cache content is the "parity_loc" list followed by the inverted
+    //    dec_matrix rows for the erased source segments.
+    unsigned int sourceErasures = 0;
+    while ((sourceErasures < erasureCount) && (erasureLocs[sourceErasures] < numData))
+        sourceErasures++;
+    const unsigned int* parityLoc = parity_loc;
+    const gf* decRows = NULL;  // if non-NULL, compact list of cached rows
+    const char* cached = matrix_cache.Find(numData, erasureCount, erasureLocs);
+    if (NULL != cached)
+    {
+        parityLoc = (const unsigned int*)cached;
+        decRows = (const gf*)(cached + sourceErasures*sizeof(unsigned int));
+    }
+    else
+    {
+        if (!BuildDecodingMatrix(numData, erasureCount, erasureLocs)) return 0;
+        char* content = matrix_cache.Insert(numData, erasureCount, erasureLocs,
+                                            sourceErasures*(sizeof(unsigned int) + ndata*sizeof(gf)));
+        if (NULL != content)
+        {
+            memcpy(content, parity_loc, sourceErasures*sizeof(unsigned int));
+            gf* rowPtr = (gf*)(content + sourceErasures*sizeof(unsigned int));
+            for (unsigned int e = 0; e < sourceErasures; e++)
+            {
+                memcpy(rowPtr, ((gf*)dec_matrix) + erasureLocs[e]*ndata, ndata*sizeof(gf));
+                rowPtr += ndata;
+            }
+        }
+    }
+    
+    // 3) Decode
+    unsigned int nelements = (GF_BITS > 8) ? vector_size/2 : vector_size;
+    for (unsigned int e = 0; e < sourceErasures; e++)
+    {
+        // Calculate missing segments (erasures) using dec_matrix and non-erasures
+        unsigned int row = erasureLocs[e];
+        const gf* decRow = (NULL != decRows) ? (decRows + e*ndata) : (((gf*)dec_matrix) + row*ndata);
+        unsigned int col = 0;
+        unsigned int nextErasure = 0;
+        for (unsigned int i  = 0; i < numData; i++)
+        {
+            if ((nextErasure < erasureCount) && (i == erasureLocs[nextErasure]))
+            {
+                // Use parity segments in place of erased vector in decoding
+                addmul((gf*)vectorList[row], (gf*)vectorList[parityLoc[nextErasure]], decRow[col], nelements);
+                col++;
+                nextErasure++;  // point to next erasure
+            }
+            else
+            {
+                addmul((gf*)vectorList[row], (gf*)vectorList[i], decRow[col], nelements);
+                col++;
+            }
+        }
+    } 
+    return erasureCount ; 
+}  // end NormDecoderRS16::Decode()
+
+// Steps 1) and 2) of Decode(), leaving the inverted matrix in "dec_matrix"
+// and the parity segments used in "parity_loc"
+bool NormDecoderRS16::BuildDecodingMatrix(unsigned int numData, unsigned int erasureCount, unsigned int* erasureLocs)
 {
     unsigned int bsz = ndata + npar;
     // 1) Build decoding matrix for the given set of segments & erasures
@@ -719,40 +816,10 @@ int NormDecoderRS16::Decode(char** vectorList, unsigned int numData,  unsigned i
     if (!InvertDecodingMatrix()) 
     {
 	    PLOG(PL_FATAL, "NormDecoderRS16::Decode() error: couldn't invert dec_matrix (numData:%d erasureCount:%d) ?!\n", numData, erasureCount);
-        return 0;
+        return false;
     }
-    
-    // 3) Decode
-    for (unsigned int e = 0; e < erasureCount; e++)
-    {
-        // Calculate missing segments (erasures) using dec_matrix and non-erasures
-        unsigned int row = erasureLocs[e];
-        if (row >= numData) break; // don't bother filling in parity segments
-        unsigned int col = 0;
-        unsigned int nextErasure = 0;
-        unsigned int nelements = (GF_BITS > 8) ? vector_size/2 : vector_size;
-        for (unsigned int i  = 0; i < numData; i++)
-        {
-            if ((nextErasure < erasureCount) && (i == erasureLocs[nextErasure]))
-            {
-                // Use parity segments in place of erased vector in decoding
-                addmul((gf*)vectorList[row], (gf*)vectorList[parity_loc[nextErasure]], ((gf*)dec_matrix)[row*ndata + col], nelements);
-                col++;
-                nextErasure++;  // point to next erasure
-            }
-            else if (i < numData)
-            {
-                addmul((gf*)vectorList[row], (gf*)vectorList[i], ((gf*)dec_matrix)[row*ndata + col], nelements);
-                col++;
-            }
-            else
-            {
-                ASSERT(0);
-            }
-        }
-    } 
-    return erasureCount ; 
-}  // end NormDecoderRS16::Decode()
+    return true;
+}  // end NormDecoderRS16::BuildDecodingMatrix()
 
 
 
@@ -34,8 +34,14 @@
 
 
 #include "normEncoderRS8.h"
+#include "normGFKernel.h"  // for SIMD multiply-accumulate kernels
+#include "galois.h"        // for GF(2^8) tables
 #include "protoDebug.h"
 
+#ifndef WIN32
+#include <pthread.h>
+#endif // !WIN32
+
 #ifdef SIMULATE
 #include "normMessage.h" 
 #endif // SIMULATE
@@ -52,57 +58,27 @@
  */
  
 #define GF_BITS  8	                    // 8-bit RS code
-#if (GF_BITS < 2)  || (GF_BITS > 16)
-#error "GF_BITS must be 2 .. 16"
+#if (GF_BITS != 8)
+#error "GF_BITS must be 8 (see galois.h)"
 #endif
-#if (GF_BITS <= 8)
 typedef UINT8 gf;
-#else
-typedef UINT16 gf;
-#endif
 #define	GF_SIZE ((1 << GF_BITS) - 1)	// powers of alpha 
 
 
 /*
- * Primitive polynomials - see Lin & Costello, Appendix A,
- * and  Lee & Messerschmitt, p. 453.
- */
-
-static const char *allPp[] = 
-{                        // GF_BITS   Polynomial	
-    NULL,		         //   0      no code                 
-    NULL,		         //   1      no code                 
-    "111",		         //   2      1+x+x^2                 
-    "1101",		         //   3      1+x+x^3                 
-    "11001",		     //   4      1+x+x^4                 
-    "101001",		     //   5      1+x^2+x^5               
-    "1100001",		     //   6      1+x+x^6                 
-    "10010001",		     //   7      1 + x^3 + x^7           
-    "101110001",	     //   8      1+x^2+x^3+x^4+x^8       
-    "1000100001",	     //   9      1+x^4+x^9               
-    "10010000001",	     //  10      1+x^3+x^10              
-    "101000000001",	     //  11      1+x^2+x^11              
-    "1100101000001",	 //  12      1+x+x^4+x^6+x^12        
-    "11011000000001",	 //  13      1+x+x^3+x^4+x^13        
-    "110000100010001",	 //  14      1+x+x^6+x^10+x^14       
-    "1100000000000001",  //  15      1+x+x^15                
-    "11010000000010001"  //  16      1+x+x^3+x^12+x^16       
-};
-
-
-/*
- * To speed up computations, we have tables for logarithm, exponent
- * and inverse of a number. If GF_BITS <= 8, we use a table for
- * multiplication as well (it takes 64K, no big deal even on a PDA,
- * especially because it can be pre-initialized an put into a ROM!),
- * otherwhise we use a table of logarithms.
+ * The exponent, inverse and multiplication tables for the 1+x^2+x^3+x^4+x^8
+ * primitive polynomial (see Lin & Costello, Appendix A, and Lee &
+ * Messerschmitt, p. 453) are the compile time constants of "galois.cpp"
+ * (shared with the MDP codec), so there's nothing to build at startup.
  * In any case the macro gf_mul(x,y) takes care of multiplications.
  */
 
-static gf gf_exp[2*GF_SIZE];	// index->poly form conversion table	
-static int gf_log[GF_SIZE + 1];	// Poly->index form conversion table	
-static gf inverse[GF_SIZE+1];	// inverse of field elem.		
-				                // inv[\alpha**i]=\alpha**(GF_SIZE-i-1)	
+static const gf* const gf_exp = Norm::GEXP;     // index->poly form conversion table (2*GF_SIZE)
+static const gf* const inverse = Norm::GINV;    // inverse of field elem.
+static const gf (* const gf_mul_table)[GF_SIZE + 1] = Norm::GMULT;
+// For each constant c, products c*n and c*(n << 4) for 4-bit n as used by
+// the NormGFKernel::DotProd8 kernels
+static const UINT8 (* const gf_nibble_table)[32] = Norm::GNIBBLE;
 
 // modnn(x) computes x % GF_SIZE, where GF_SIZE is 2**GF_BITS - 1,
 // without a slow divide.
@@ -119,127 +95,18 @@ static inline gf modnn(int x)
 #define SWAP(a,b,t) {t tmp; tmp=a; a=b; b=tmp;}
 
 /*
- * gf_mul(x,y) multiplies two numbers. If GF_BITS<=8, it is much
- * faster to use a multiplication table.
- *
  * USE_GF_MULC, GF_MULC0(c) and GF_ADDMULC(x) can be used when multiplying
  * many numbers by the same constant. In this case the first
  * call sets the constant, and others perform the multiplications.
  * A value related to the multiplication is held in a local variable
  * declared with USE_GF_MULC . See usage in addmul1().
  */
-#if (GF_BITS <= 8)
-
-static gf gf_mul_table[GF_SIZE + 1][GF_SIZE + 1];
-
 #define gf_mul(x,y) gf_mul_table[x][y]
-#define USE_GF_MULC gf * __gf_mulc_
+#define USE_GF_MULC const gf * __gf_mulc_
 #define GF_MULC0(c) __gf_mulc_ = gf_mul_table[c]
 #define GF_ADDMULC(dst, x) dst ^= __gf_mulc_[x]
 
-static void init_mul_table()
-{
-    for (int i = 0; i <= GF_SIZE; i++)
-    {
-	    for (int j = 0; j <= GF_SIZE; j++)
-	        gf_mul_table[i][j] = gf_exp[modnn(gf_log[i] + gf_log[j]) ] ;
-    }
-    for (int j = 0; j <= GF_SIZE; j++)
-	    gf_mul_table[0][j] = gf_mul_table[j][0] = 0;
-}
-
-#else	/* GF_BITS > 8 */
-
-inline gf gf_mul(int x, int y)
-{
-    if ((0 == x) || (0 == y)) return 0;
-    return gf_exp[gf_log[x] + gf_log[y] ] ;
-}
-
-#define init_mul_table()
-#define USE_GF_MULC register gf * __gf_mulc_
-#define GF_MULC0(c) __gf_mulc_ = &gf_exp[ gf_log[c] ]
-#define GF_ADDMULC(dst, x) { if (x) dst ^= __gf_mulc_[ gf_log[x] ] ; }
-
-#endif  // if/else (GF_BITS <= 8)
-
-/*
- * Generate GF(2**m) from the irreducible polynomial p(X) in p[0]..p[m]
- * Lookup tables:
- *     index->polynomial form		gf_exp[] contains j= \alpha^i;
- *     polynomial form -> index form	gf_log[ j = \alpha^i ] = i
- * \alpha=x is the primitive element of GF(2^m)
- *
- * For efficiency, gf_exp[] has size 2*GF_SIZE, so that a simple
- * multiplication of two numbers can be resolved without calling modnn
- */
-         
 #define NEW_GF_MATRIX(rows, cols) (new gf[rows*cols])
-
-/*
- * initialize the data structures used for computations in GF.
- */
-static void generate_gf()
-{
-    const char *Pp =  allPp[GF_BITS] ;
-
-    gf mask = 1;	/* x ** 0 = 1 */
-    gf_exp[GF_BITS] = 0; /* will be updated at the end of the 1st loop */
-    /*
-     * first, generate the (polynomial representation of) powers of \alpha,
-     * which are stored in gf_exp[i] = \alpha ** i .
-     * At the same time build gf_log[gf_exp[i]] = i .
-     * The first GF_BITS powers are simply bits shifted to the left.
-     */
-    for (int i = 0; i < GF_BITS; i++, mask <<= 1 ) 
-    {
-	    gf_exp[i] = mask;
-	    gf_log[gf_exp[i]] = i;
-	    /*
-	     * If Pp[i] == 1 then \alpha ** i occurs in poly-repr
-	     * gf_exp[GF_BITS] = \alpha ** GF_BITS
-	     */
-	    if ( Pp[i] == '1' )
-	        gf_exp[GF_BITS] ^= mask;
-    }
-    /*
-     * now gf_exp[GF_BITS] = \alpha ** GF_BITS is complete, so can als
-     * compute its inverse.
-     */
-    gf_log[gf_exp[GF_BITS]] = GF_BITS;
-    /*
-     * Poly-repr of \alpha ** (i+1) is given by poly-repr of
-     * \alpha ** i shifted left one-bit and accounting for any
-     * \alpha ** GF_BITS term that may occur when poly-repr of
-     * \alpha ** i is shifted.
-     */
-    mask = 1 << (GF_BITS - 1 ) ;
-    for (int i = GF_BITS + 1; i < GF_SIZE; i++) 
-    {
-	    if (gf_exp[i - 1] >= mask)
-	        gf_exp[i] = gf_exp[GF_BITS] ^ ((gf_exp[i - 1] ^ mask) << 1);
-	    else
-	        gf_exp[i] = gf_exp[i - 1] << 1;
-	    gf_log[gf_exp[i]] = i;
-    }
-    /*
-     * log(0) is not defined, so use a special value
-     */
-    gf_log[0] =	GF_SIZE ;
-    /* set the extended gf_exp values for fast multiply */
-    for (int i = 0 ; i < GF_SIZE ; i++)
-	    gf_exp[i + GF_SIZE] = gf_exp[i] ;
-
-    /*
-     * again special cases. 0 has no inverse. This used to
-     * be initialized to GF_SIZE, but it should make no difference
-     * since noone is supposed to read from here.
-     */
-    inverse[0] = 0 ;
-    inverse[1] = 1;
-    for (int i = 2; i <= GF_SIZE; i++)
-	    inverse[i] = gf_exp[GF_SIZE-gf_log[i]];
-}  // end generate_gf()       
          
          
 /*
@@ -259,8 +126,19 @@ static void generate_gf()
     if (c != 0) addmul1(dst, src, c, sz)
 #define UNROLL 16 /* 1, 4, 8, 16 */
 
+// Vectors shorter than this are not worth the SIMD kernel table setup
+#define GF_KERNEL_MIN 32
+
 static void addmul1(gf* dst1, gf* src1, gf c, int sz)
 {
+    // Use the SIMD "split nibble" kernel when available (see normGFKernel.h)
+    NormGFKernel::AddMul8 kernel = NormGFKernel::GetAddMul8();
+    if ((NULL != kernel) && (sz >= GF_KERNEL_MIN))
+    {
+        kernel(dst1, src1, gf_mul_table[c], sz);
+        return;
+    }
+    
     USE_GF_MULC ;
     gf* dst = dst1;
     gf* src = src1 ;
@@ -376,19 +254,133 @@ static int invert_vdm(gf* src, int k)
 }  // end invert_vdm()
 
 
-static bool fec_initialized = false;
-static void init_fec()
+// The systematic encoding matrix of an (n, k) code is built once and shared
+// (read-only) by all the encoder and decoder instances using that code (e.g.,
+// the decoders of a receiver's many senders) for as long as any use it
+class NormRS8Matrix
+{
+    public:
+        unsigned int    ndata;
+        unsigned int    npar;
+        unsigned int    refs;
+        gf*             matrix;
+        NormRS8Matrix*  next;
+};
+static NormRS8Matrix* rs8_matrix_list = NULL;
+#ifdef WIN32
+static SRWLOCK rs8_matrix_lock = SRWLOCK_INIT;
+#else
+static pthread_mutex_t rs8_matrix_lock = PTHREAD_MUTEX_INITIALIZER;
+#endif // if/else WIN32
+
+static void LockMatrixList()
+{
+#ifdef WIN32
+    AcquireSRWLockExclusive(&rs8_matrix_lock);
+#else
+    pthread_mutex_lock(&rs8_matrix_lock);
+#endif // if/else WIN32
+}  // end LockMatrixList()
+
+static void UnlockMatrixList()
 {
-    if (!fec_initialized)
+#ifdef WIN32
+    ReleaseSRWLockExclusive(&rs8_matrix_lock);
+#else
+    pthread_mutex_unlock(&rs8_matrix_lock);
+#endif // if/else WIN32
+}  // end UnlockMatrixList()
+
+static gf* BuildEncodingMatrix(int k, int n)
+{
+    gf* encMatrix = NEW_GF_MATRIX(n, k);
+    if (NULL == encMatrix) return NULL;
+    gf* tmpMatrix = NEW_GF_MATRIX(n, k);
+    if (NULL == tmpMatrix)
     {
-        generate_gf();
-        init_mul_table();
-        fec_initialized = true;
+        delete[] encMatrix;
+        return NULL;
     }
-}
+    // Fill the matrix with powers of field elements, starting from 0.
+    // The first row is special, cannot be computed with exp. table.
+    tmpMatrix[0] = 1 ;
+    for (int col = 1; col < k ; col++)
+	    tmpMatrix[col] = 0 ;
+    for (gf* p = tmpMatrix + k, row = 0; row < n-1 ; row++, p += k) 
+    {
+	    for (int col = 0 ; col < k ; col ++ )
+	        p[col] = gf_exp[modnn(row*col)];
+    }
+    
+    // Quick code to build systematic matrix: invert the top
+    // k*k vandermonde matrix, multiply right the bottom n-k rows
+    // by the inverse, and construct the identity matrix at the top.
+    invert_vdm(tmpMatrix, k); /* much faster than invert_mat */
+    matmul(tmpMatrix + k*k, tmpMatrix, encMatrix + k*k, n - k, k, k);
+    // the upper matrix is I so do not bother with a slow multiply
+    memset(encMatrix, 0, k*k*sizeof(gf));
+    for (gf* p = encMatrix, col = 0 ; col < k ; col++, p += k+1 )
+	    *p = 1 ;
+    delete[] tmpMatrix;
+    return encMatrix;
+}  // end BuildEncodingMatrix()
+
+static const UINT8* AcquireEncodingMatrix(unsigned int numData, unsigned int numParity)
+{
+    LockMatrixList();
+    NormRS8Matrix* entry = rs8_matrix_list;
+    while ((NULL != entry) && ((entry->ndata != numData) || (entry->npar != numParity)))
+        entry = entry->next;
+    if (NULL == entry)
+    {
+        if (NULL == (entry = new NormRS8Matrix))
+        {
+            UnlockMatrixList();
+            return NULL;
+        }
+        // (this is built with the lock held so concurrent users of a
+        // new code shape wait for it instead of building their own)
+        if (NULL == (entry->matrix = BuildEncodingMatrix(numData, numData + numParity)))
+        {
+            delete entry;
+            UnlockMatrixList();
+            return NULL;
+        }
+        entry->ndata = numData;
+        entry->npar = numParity;
+        entry->refs = 0;
+        entry->next = rs8_matrix_list;
+        rs8_matrix_list = entry;
+    }
+    entry->refs++;
+    UnlockMatrixList();
+    return entry->matrix;
+}  // end AcquireEncodingMatrix()
+
+static void ReleaseEncodingMatrix(const UINT8* matrix)
+{
+    LockMatrixList();
+    NormRS8Matrix* prev = NULL;
+    NormRS8Matrix* entry = rs8_matrix_list;
+    while ((NULL != entry) && (entry->matrix != matrix))
+    {
+        prev = entry;
+        entry = entry->next;
+    }
+    if ((NULL != entry) && (0 == --entry->refs))
+    {
+        if (NULL != prev)
+            prev->next = entry->next;
+        else
+            rs8_matrix_list = entry->next;
+        delete[] entry->matrix;
+        delete entry;
+    }
+    UnlockMatrixList();
+}  // end ReleaseEncodingMatrix()
 
 NormEncoderRS8::NormEncoderRS8()
- : enc_matrix(NULL)
+ : enc_matrix(NULL), enc_table_list(NULL)
 {
 }
 
@@ -408,66 +400,43 @@ bool NormEncoderRS8::Init(unsigned int numData, unsigned int numParity, UINT16 v
         return false;
     }
     
-    if (NULL != enc_matrix) 
+    Destroy();
+    if (NULL == (enc_matrix = AcquireEncodingMatrix(numData, numParity)))
     {
-        delete[] enc_matrix;
-        enc_matrix = NULL;
+        PLOG(PL_FATAL, "NormEncoderRS8::Init() error: new enc_matrix error: %s\n", GetErrorString());
+        return false;
     }
-    init_fec();
-    int n = numData + numParity;
-    int k = numData;
-    enc_matrix = (UINT8*)NEW_GF_MATRIX(n, k);
-    if (NULL != enc_matrix)
+    if (NULL == (enc_table_list = new const UINT8*[numParity*numData]))
     {
-        gf* tmpMatrix = NEW_GF_MATRIX(n, k);
-        if (NULL == tmpMatrix)
-        {
-            PLOG(PL_FATAL, "NormEncoderRS8::Init() error: new  tmpMatrix error: %s\n", GetErrorString());
-            delete[] enc_matrix;
-            enc_matrix = NULL;
-            return false;
-        }
-        // Fill the matrix with powers of field elements, starting from 0.
-        // The first row is special, cannot be computed with exp. table.
-        tmpMatrix[0] = 1 ;
-        for (int col = 1; col < k ; col++)
-	        tmpMatrix[col] = 0 ;
-        for (gf* p = tmpMatrix + k, row = 0; row < n-1 ; row++, p += k) 
-        {
-	        for (int col = 0 ; col < k ; col ++ )
-	            p[col] = gf_exp[modnn(row*col)];
-        }
-        
-        
-        // Quick code to build systematic matrix: invert the top
-        // k*k vandermonde matrix, multiply right the bottom n-k rows
-        // by the inverse, and construct the identity matrix at the top.
-        invert_vdm(tmpMatrix, k); /* much faster than invert_mat */
-        matmul(tmpMatrix + k*k, tmpMatrix, ((gf*)enc_matrix) + k*k, n - k, k, k);
-        // the upper matrix is I so do not bother with a slow multiply
-        memset(enc_matrix, 0, k*k*sizeof(gf));
-        for (gf* p = (gf*)enc_matrix, col = 0 ; col < k ; col++, p += k+1 )
-	        *p = 1 ;
-        delete[] tmpMatrix;
-        ndata = numData;
-        npar = numParity;
-        vector_size = vecSizeMax;
-        return true;
+        PLOG(PL_FATAL, "NormEncoderRS8::Init() error: new enc_table_list error: %s\n", GetErrorString());
+        Destroy();
+        return false;
     }
-    else
+    // The EncodeBlock() kernel coefficient tables for full blocks are
+    // fixed by the code shape, so they're looked up once here
+    for (unsigned int row = 0; row < numParity; row++)
     {
-        PLOG(PL_FATAL, "NormEncoderRS8::Init() error: new enc_matrix error: %s\n", GetErrorString());
-        return false;
+        for (unsigned int col = 0; col < numData; col++)
+            enc_table_list[row*numData + col] = gf_nibble_table[enc_matrix[(row + numData)*numData + col]];
     }
+    ndata = numData;
+    npar = numParity;
+    vector_size = vecSizeMax;
+    return true;
 }  // end NormEncoderRS8::Init()
 
 void NormEncoderRS8::Destroy()
 {
     if (NULL != enc_matrix)
     {
-        delete[] enc_matrix;
+        ReleaseEncodingMatrix(enc_matrix);
         enc_matrix = NULL;
     }
+    if (NULL != enc_table_list)
+    {
+        delete[] enc_table_list;
+        enc_table_list = NULL;
+    }
 }  // end NormEncoderRS8::Destroy()
 
 void NormEncoderRS8::Encode(unsigned int segmentId, const char* dataVector, char** parityVectorList)
@@ -476,16 +445,60 @@ void NormEncoderRS8::Encode(unsigned int segmentId, const char* dataVector, char
     {
         // Update each parity vector   
         gf* fec = (gf*)parityVectorList[i];
-        gf* p = ((gf*)enc_matrix) + ((i+ndata)*ndata);
+        const gf* p = ((const gf*)enc_matrix) + ((i+ndata)*ndata);
         unsigned int nelements = (GF_BITS > 8) ? vector_size / 2 : vector_size;
         addmul(fec, (gf*)dataVector, p[segmentId], nelements);
     }
 }  // end NormEncoderRS8::Encode()
 
+// Bytes of each parity vector computed per pass of EncodeBlock()
+#define ENCODE_TILE 512
+
+void NormEncoderRS8::EncodeBlock(const char** dataVectorList, unsigned int numData, char** parityVectorList)
+{
+    NormGFKernel::DotProd8 kernel = NormGFKernel::GetDotProd8();
+    if (NULL == kernel)
+    {
+        NormEncoder::EncodeBlock(dataVectorList, numData, parityVectorList);
+        return;
+    }
+    // Work across the vectors in "tiles" so the source data tiles stay in
+    // cache while the parity rows are computed (in registers, a few rows at
+    // a time) so each parity span is stored just once
+    UINT8** dstList = (UINT8**)parityVectorList;
+    const UINT8* const* srcList = (const UINT8* const*)dataVectorList;
+    const UINT8* tableList[NormGFKernel::DOT_ROWS_MAX*(GF_SIZE + 1)];
+    for (unsigned int offset = 0; offset < vector_size; offset += ENCODE_TILE)
+    {
+        unsigned int len = vector_size - offset;
+        if (len > ENCODE_TILE) len = ENCODE_TILE;
+        for (unsigned int i = 0; i < npar; i += NormGFKernel::DOT_ROWS_MAX)
+        {
+            unsigned int numRows = npar - i;
+            if (numRows > NormGFKernel::DOT_ROWS_MAX) 
+                numRows = NormGFKernel::DOT_ROWS_MAX;
+            if (numData == ndata)
+            {
+                // (full block, so the rows' tables are in "enc_table_list")
+                kernel(dstList + i, numRows, srcList, numData, enc_table_list + i*ndata, offset, len);
+                continue;
+            }
+            for (unsigned int r = 0; r < numRows; r++)
+            {
+                const gf* p = ((const gf*)enc_matrix) + ((i+r+ndata)*ndata);
+                for (unsigned int j = 0; j < numData; j++)
+                    tableList[r*numData + j] = gf_nibble_table[p[j]];
+            }
+            kernel(dstList + i, numRows, srcList, numData, tableList, offset, len);
+        }
+    }
+}  // end NormEncoderRS8::EncodeBlock()
+
+
 
 NormDecoderRS8::NormDecoderRS8()
  : enc_matrix(NULL), dec_matrix(NULL), 
-   parity_loc(NULL), inv_ndxc(NULL), inv_ndxr(NULL), 
+   parity_loc(NULL), dec_src_list(NULL), dec_table_list(NULL), inv_ndxc(NULL), inv_ndxr(NULL), 
    inv_pivt(NULL), inv_id_row(NULL), inv_temp_row(NULL)
 {
 }
@@ -497,9 +510,10 @@ NormDecoderRS8::~NormDecoderRS8()
 
 void NormDecoderRS8::Destroy()
 {
+    matrix_cache.Clear();  // cached patterns are specific to the code parameters
     if (NULL != enc_matrix)
     {
-        delete[] enc_matrix;
+        ReleaseEncodingMatrix(enc_matrix);
         enc_matrix = NULL;
     }
     if (NULL != dec_matrix)
@@ -512,6 +526,16 @@ void NormDecoderRS8::Destroy()
         delete[] parity_loc;
         parity_loc = NULL;
     }
+    if (NULL != dec_src_list)
+    {
+        delete[] dec_src_list;
+        dec_src_list = NULL;
+    }
+    if (NULL != dec_table_list)
+    {
+        delete[] dec_table_list;
+        dec_table_list = NULL;
+    }
     if (NULL != inv_ndxc)
     {
         delete[] inv_ndxc;
@@ -550,10 +574,8 @@ bool NormDecoderRS8::Init(unsigned int numData, unsigned int numParity, UINT16 v
         return false;
     }
     
-    init_fec();
     Destroy();
     
-    int n = numData + numParity;
     int k = numData;
     
     if (NULL == (inv_ndxc = new unsigned int[k]))
@@ -598,50 +620,27 @@ bool NormDecoderRS8::Init(unsigned int numData, unsigned int numParity, UINT16 v
         return false;
     }
     
-    if (NULL == (dec_matrix = (UINT8*)NEW_GF_MATRIX(k, k)))
+    if ((NULL == (dec_src_list = new const UINT8*[k])) ||
+        (NULL == (dec_table_list = new const UINT8*[NormGFKernel::DOT_ROWS_MAX*k])))
     {
-        PLOG(PL_FATAL, "NormDecoderRS8::Init() error: new dec_matrix error: %s\n", GetErrorString());
+        PLOG(PL_FATAL, "NormDecoderRS8::Init() error: new kernel list error: %s\n", GetErrorString());
         Destroy();
         return false;
     }
     
-    if (NULL == (enc_matrix = (UINT8*)NEW_GF_MATRIX(n, k)))
+    if (NULL == (dec_matrix = (UINT8*)NEW_GF_MATRIX(k, k)))
     {
-        PLOG(PL_FATAL, "NormDecoderRS8::Init() error: new enc_matrix error: %s\n", GetErrorString());
+        PLOG(PL_FATAL, "NormDecoderRS8::Init() error: new dec_matrix error: %s\n", GetErrorString());
         Destroy();
         return false;
     }
     
-    
-    gf* tmpMatrix = NEW_GF_MATRIX(n, k);
-    if (NULL == tmpMatrix)
+    if (NULL == (enc_matrix = AcquireEncodingMatrix(numData, numParity)))
     {
-        PLOG(PL_FATAL, "NormEncoderRS8::Init() error: new  tmpMatrix error: %s\n", GetErrorString());
-        delete[] enc_matrix;
-        enc_matrix = NULL;
+        PLOG(PL_FATAL, "NormDecoderRS8::Init() error: new enc_matrix error: %s\n", GetErrorString());
+        Destroy();
         return false;
     }
-    // Fill the matrix with powers of field elements, starting from 0.
-    // The first row is special, cannot be computed with exp. table.
-    tmpMatrix[0] = 1 ;
-    for (int col = 1; col < k ; col++)
-	    tmpMatrix[col] = 0 ;
-    for (gf* p = tmpMatrix + k, row = 0; row < n-1 ; row++, p += k) 
-    {
-	    for (int col = 0 ; col < k ; col ++ )
-	        p[col] = gf_exp[modnn(row*col)];
-    }
-
-    // Quick code to build systematic matrix: invert the top
-    // k*k vandermonde matrix, multiply right the bottom n-k rows
-    // by the inverse, and construct the identity matrix at the top.
-    invert_vdm(tmpMatrix, k); /* much faster than invert_mat */
-    matmul(tmpMatrix + k*k, tmpMatrix, ((gf*)enc_matrix) + k*k, n - k, k, k);
-    // the upper matrix is I so do not bother with a slow multiply
-    memset(enc_matrix, 0, k*k*sizeof(gf));
-    for (gf* p = (gf*)enc_matrix, col = 0 ; col < k ; col++, p += k+1 )
-	    *p = 1 ;
-    delete[] tmpMatrix;
     ndata = numData;
     npar = numParity;
     vector_size = vecSizeMax;
@@ -650,6 +649,106 @@ bool NormDecoderRS8::Init(unsigned int numData, unsigned int numParity, UINT16 v
 
 
 int NormDecoderRS8::Decode(char** vectorList, unsigned int numData,  unsigned int erasureCount, unsigned int* erasureLocs)
+{
+    // 0) Check for a cached decoding matrix for this erasure pattern.  The
+    //    cache content is the "parity_loc" list followed by the inverted
+    //    dec_matrix rows for the erased source segments.
+    unsigned int sourceErasures = 0;
+    while ((sourceErasures < erasureCount) && (erasureLocs[sourceErasures] < numData))
+        sourceErasures++;
+    const unsigned int* parityLoc = parity_loc;
+    const gf* decRows = NULL;  // if non-NULL, compact list of cached rows
+    const char* cached = matrix_cache.Find(numData, erasureCount, erasureLocs);
+    if (NULL != cached)
+    {
+        parityLoc = (const unsigned int*)cached;
+        decRows = (const gf*)(cached + sourceErasures*sizeof(unsigned int));
+    }
+    else
+    {
+        if (!BuildDecodingMatrix(numData, erasureCount, erasureLocs)) return 0;
+        char* content = matrix_cache.Insert(numData, erasureCount, erasureLocs,
+                                            sourceErasures*(sizeof(unsigned int) + ndata*sizeof(gf)));
+        if (NULL != content)
+        {
+            memcpy(content, parity_loc, sourceErasures*sizeof(unsigned int));
+            gf* rowPtr = (gf*)(content + sourceErasures*sizeof(unsigned int));
+            for (unsigned int e = 0; e < sourceErasures; e++)
+            {
+                memcpy(rowPtr, ((gf*)dec_matrix) + erasureLocs[e]*ndata, ndata*sizeof(gf));
+                rowPtr += ndata;
+            }
+        }
+    }
+    
+    // 3) Decode
+    unsigned int nelements = (GF_BITS > 8) ? vector_size/2 : vector_size;
+    NormGFKernel::DotProd8 kernel = NormGFKernel::GetDotProd8();
+    if ((NULL != kernel) && (nelements >= GF_KERNEL_MIN))
+    {
+        // Rebuild up to DOT_ROWS_MAX erasures per pass with the dot product
+        // kernel (as in NormEncoderRS8::EncodeBlock()) with the parity
+        // segments used in place of the erased ones in the source list
+        unsigned int nextErasure = 0;
+        for (unsigned int i = 0; i < numData; i++)
+        {
+            if ((nextErasure < erasureCount) && (i == erasureLocs[nextErasure]))
+                dec_src_list[i] = (const UINT8*)vectorList[parityLoc[nextErasure++]];
+            else
+                dec_src_list[i] = (const UINT8*)vectorList[i];
+        }
+        UINT8* dstList[NormGFKernel::DOT_ROWS_MAX];
+        for (unsigned int e = 0; e < sourceErasures; e += NormGFKernel::DOT_ROWS_MAX)
+        {
+            unsigned int numRows = sourceErasures - e;
+            if (numRows > NormGFKernel::DOT_ROWS_MAX) 
+                numRows = NormGFKernel::DOT_ROWS_MAX;
+            for (unsigned int r = 0; r < numRows; r++)
+            {
+                unsigned int row = erasureLocs[e + r];
+                dstList[r] = (UINT8*)vectorList[row];
+                const gf* decRow = (NULL != decRows) ? (decRows + (e + r)*ndata) : (((gf*)dec_matrix) + row*ndata);
+                for (unsigned int j = 0; j < numData; j++)
+                    dec_table_list[r*numData + j] = gf_nibble_table[decRow[j]];
+            }
+            for (unsigned int offset = 0; offset < nelements; offset += ENCODE_TILE)
+            {
+                unsigned int len = nelements - offset;
+                if (len > ENCODE_TILE) len = ENCODE_TILE;
+                kernel(dstList, numRows, dec_src_list, numData, dec_table_list, offset, len);
+            }
+        }
+        return erasureCount;
+    }
+    for (unsigned int e = 0; e < sourceErasures; e++)
+    {
+        // Calculate missing segments (erasures) using dec_matrix and non-erasures
+        unsigned int row = erasureLocs[e];
+        const gf* decRow = (NULL != decRows) ? (decRows + e*ndata) : (((gf*)dec_matrix) + row*ndata);
+        unsigned int col = 0;
+        unsigned int nextErasure = 0;
+        for (unsigned int i  = 0; i < numData; i++)
+        {
+            if ((nextErasure < erasureCount) && (i == erasureLocs[nextErasure]))
+            {
+                // Use parity segments in place of erased vector in decoding
+                addmul((gf*)vectorList[row], (gf*)vectorList[parityLoc[nextErasure]], decRow[col], nelements);
+                col++;
+                nextErasure++;  // point to next erasure
+            }
+            else
+            {
+                addmul((gf*)vectorList[row], (gf*)vectorList[i], decRow[col], nelements);
+                col++;
+            }
+        }
+    } 
+    return erasureCount ; 
+}  // end NormDecoderRS8::Decode()
+
+// Steps 1) and 2) of Decode(), leaving the inverted matrix in "dec_matrix"
+// and the parity segments used in "parity_loc"
+bool NormDecoderRS8::BuildDecodingMatrix(unsigned int numData, unsigned int erasureCount, unsigned int* erasureLocs)
 {
     unsigned int bsz = ndata + npar;
     // 1) Build decoding matrix for the given set of segments & erasures
@@ -691,7 +790,7 @@ int NormDecoderRS8::Decode(char** vectorList, unsigned int numData,  unsigned in
                 parity_loc[parityCount++] = i;
                 // Copy appropriate enc_matric parity row to dec_matrix erasureRow
                 gf* p = ((gf*)dec_matrix) + ndata*erasureLocs[ne++];  
-                memcpy(p, ((gf*)enc_matrix) + (ndata-numData+i)*ndata, ndata*sizeof(gf)); 
+                memcpy(p, ((const gf*)enc_matrix) + (ndata-numData+i)*ndata, ndata*sizeof(gf)); 
             }
                 
         }
@@ -707,7 +806,7 @@ int NormDecoderRS8::Decode(char** vectorList, unsigned int numData,  unsigned in
                 parity_loc[parityCount++] = i;
                 // Copy appropriate enc_matric parity row to dec_matrix erasureRow
                 gf* p = ((gf*)dec_matrix) + ndata*erasureLocs[ne++];  
-                memcpy(p, ((gf*)enc_matrix) + (ndata-numData+i)*ndata, ndata*sizeof(gf)); 
+                memcpy(p, ((const gf*)enc_matrix) + (ndata-numData+i)*ndata, ndata*sizeof(gf)); 
             }
         }
         else
@@ -721,40 +820,10 @@ int NormDecoderRS8::Decode(char** vectorList, unsigned int numData,  unsigned in
     if (!InvertDecodingMatrix()) 
     {
 	    PLOG(PL_FATAL, "NormDecoderRS8::Decode() error: couldn't invert dec_matrix ?!\n");
-        return 0;
+        return false;
     }
-    
-    // 3) Decode
-    for (unsigned int e = 0; e < erasureCount; e++)
-    {
-        // Calculate missing segments (erasures) using dec_matrix and non-erasures
-        unsigned int row = erasureLocs[e];
-        if (row >= numData) break; // don't bother filling in parity segments
-        unsigned int col = 0;
-        unsigned int nextErasure = 0;
-        unsigned int nelements = (GF_BITS > 8) ? vector_size/2 : vector_size;
-        for (unsigned int i  = 0; i < numData; i++)
-        {
-            if ((nextErasure < erasureCount) && (i == erasureLocs[nextErasure]))
-            {
-                // Use parity segments in place of erased vector in decoding
-                addmul((gf*)vectorList[row], (gf*)vectorList[parity_loc[nextErasure]], ((gf*)dec_matrix)[row*ndata + col], nelements);
-                col++;
-                nextErasure++;  // point to next erasure
-            }
-            else if (i < numData)
-            {
-                addmul((gf*)vectorList[row], (gf*)vectorList[i], ((gf*)dec_matrix)[row*ndata + col], nelements);
-                col++;
-            }
-            else
-            {
-                ASSERT(0);
-            }
-        }
-    } 
-    return erasureCount ; 
-}  // end NormDecoderRS8::Decode()
+    return true;
+}  // end NormDecoderRS8::BuildDecodingMatrix()
 
 
 
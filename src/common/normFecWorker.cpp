@@ -0,0 +1,505 @@
+#include "normFecWorker.h"
+#include "normProbe.h"
+#include "protoDebug.h"
+
+#include <string.h>  // for memcpy()
+
+NormFecWorkerPool::NormFecWorkerPool()
+ : mode(ENCODE), worker_list(NULL), worker_count(0), job_list(NULL), job_count(0),
+   jobs_in_use(0), job_seq(0), vectors_per_job(0), data_buffer(NULL), data_vectors(NULL),
+   erasure_buffer(NULL), queue_head(NULL), queue_tail(NULL), stopping(false)
+{
+#ifdef WIN32
+    InitializeCriticalSection(&mutex);
+    InitializeConditionVariable(&work_cond);
+    InitializeConditionVariable(&done_cond);
+#else
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&work_cond, NULL);
+    pthread_cond_init(&done_cond, NULL);
+#endif // if/else WIN32
+}
+
+NormFecWorkerPool::~NormFecWorkerPool()
+{
+    Destroy();
+#ifdef WIN32
+    DeleteCriticalSection(&mutex);
+#else
+    pthread_cond_destroy(&done_cond);
+    pthread_cond_destroy(&work_cond);
+    pthread_mutex_destroy(&mutex);
+#endif // if/else WIN32
+}
+
+void NormFecWorkerPool::Lock()
+{
+#ifdef WIN32
+    EnterCriticalSection(&mutex);
+#else
+    pthread_mutex_lock(&mutex);
+#endif // if/else WIN32
+}  // end NormFecWorkerPool::Lock()
+
+void NormFecWorkerPool::Unlock()
+{
+#ifdef WIN32
+    LeaveCriticalSection(&mutex);
+#else
+    pthread_mutex_unlock(&mutex);
+#endif // if/else WIN32
+}  // end NormFecWorkerPool::Unlock()
+
+void NormFecWorkerPool::WaitWork()
+{
+#ifdef WIN32
+    SleepConditionVariableCS(&work_cond, &mutex, INFINITE);
+#else
+    pthread_cond_wait(&work_cond, &mutex);
+#endif // if/else WIN32
+}  // end NormFecWorkerPool::WaitWork()
+
+void NormFecWorkerPool::WaitDone()
+{
+#ifdef WIN32
+    SleepConditionVariableCS(&done_cond, &mutex, INFINITE);
+#else
+    pthread_cond_wait(&done_cond, &mutex);
+#endif // if/else WIN32
+}  // end NormFecWorkerPool::WaitDone()
+
+void NormFecWorkerPool::SignalWork()
+{
+#ifdef WIN32
+    WakeAllConditionVariable(&work_cond);
+#else
+    pthread_cond_broadcast(&work_cond);
+#endif // if/else WIN32
+}  // end NormFecWorkerPool::SignalWork()
+
+void NormFecWorkerPool::SignalDone()
+{
+#ifdef WIN32
+    WakeAllConditionVariable(&done_cond);
+#else
+    pthread_cond_broadcast(&done_cond);
+#endif // if/else WIN32
+}  // end NormFecWorkerPool::SignalDone()
+
+bool NormFecWorkerPool::Init(Mode          theMode,
+                             unsigned int  numWorkers,
+                             UINT8         fecId,
+                             UINT8         fecM,
+                             UINT16        fecInstanceId,
+                             unsigned int  numData,
+                             unsigned int  numParity,
+                             UINT16        vectorSize,
+                             bool          jobBuffers)
+{
+    Destroy();
+    if (0 == numWorkers) return true;
+    mode = theMode;
+    // Two jobs per worker lets the protocol thread queue the next
+    // block(s) while the current ones are being processed
+    unsigned int numJobs = 2*numWorkers;
+    unsigned int vecSize = vectorSize + 1;  // extra byte for msg flags
+    vectors_per_job = (DECODE == mode) ? (numData + numParity) : numData;
+    unsigned int numVectors = numJobs*vectors_per_job;
+    if ((NULL == (worker_list = new Worker[numWorkers])) ||
+        (NULL == (job_list = new Job[numJobs])) ||
+        (NULL == (data_vectors = new char*[2*numVectors])) ||
+        (jobBuffers && (NULL == (data_buffer = new char[(unsigned long)numVectors*vecSize]))) ||
+        ((DECODE == mode) && (NULL == (erasure_buffer = new unsigned int[numJobs*numParity]))))
+    {
+        PLOG(PL_FATAL, "NormFecWorkerPool::Init() error: allocation failure: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
+    for (unsigned int i = 0; i < numVectors; i++)
+        data_vectors[i] = jobBuffers ? (data_buffer + ((unsigned long)i * vecSize)) : NULL;
+    for (unsigned int i = 0; i < numJobs; i++)
+    {
+        Job& job = job_list[i];
+        job.state = JOB_FREE;
+        job.key = job.group = NULL;
+        job.seq = 0;
+        job.buffer_list = data_vectors + i*vectors_per_job;
+        job.vector_list = data_vectors + numVectors + i*vectors_per_job;
+        job.parity_list = NULL;
+        job.num_data = 0;
+        job.erasure_locs = (DECODE == mode) ? (erasure_buffer + i*numParity) : NULL;
+        job.erasure_count = 0;
+        job.result = false;
+        job.next = NULL;
+    }
+    job_count = numJobs;
+    jobs_in_use = 0;
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        Worker& worker = worker_list[i];
+        worker.pool = this;
+        worker.started = false;
+        worker.encoder = NULL;
+        worker.decoder = NULL;
+        if (DECODE == mode)
+            worker.decoder = NormFecRegistry::CreateDecoder(fecId, fecM, fecInstanceId);
+        else
+            worker.encoder = NormFecRegistry::CreateEncoder(fecId, fecM, fecInstanceId);
+    }
+    worker_count = numWorkers;  // so Destroy() cleans up the codecs
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        Worker& worker = worker_list[i];
+        bool result;
+        if (DECODE == mode)
+            result = (NULL != worker.decoder) && worker.decoder->Init(numData, numParity, vectorSize);
+        else
+            result = (NULL != worker.encoder) && worker.encoder->Init(numData, numParity, vectorSize);
+        if (!result)
+        {
+            PLOG(PL_FATAL, "NormFecWorkerPool::Init() error: unable to create codec\n");
+            Destroy();
+            return false;
+        }
+    }
+    stopping = false;
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        Worker& worker = worker_list[i];
+#ifdef WIN32
+        worker.thread = CreateThread(NULL, 0, DoWorker, &worker, 0, NULL);
+        worker.started = (NULL != worker.thread);
+#else
+        worker.started = (0 == pthread_create(&worker.thread, NULL, DoWorker, &worker));
+#endif // if/else WIN32
+        if (!worker.started)
+        {
+            PLOG(PL_FATAL, "NormFecWorkerPool::Init() error: unable to start worker thread: %s\n", GetErrorString());
+            Destroy();
+            return false;
+        }
+    }
+    return true;
+}  // end NormFecWorkerPool::Init()
+
+void NormFecWorkerPool::Destroy()
+{
+    if (NULL != worker_list)
+    {
+        Lock();
+        stopping = true;
+        SignalWork();
+        Unlock();
+        for (unsigned int i = 0; i < worker_count; i++)
+        {
+            Worker& worker = worker_list[i];
+            if (worker.started)
+            {
+#ifdef WIN32
+                WaitForSingleObject(worker.thread, INFINITE);
+                CloseHandle(worker.thread);
+#else
+                pthread_join(worker.thread, NULL);
+#endif // if/else WIN32
+                worker.started = false;
+            }
+            if (NULL != worker.encoder) delete worker.encoder;
+            if (NULL != worker.decoder) delete worker.decoder;
+        }
+        delete[] worker_list;
+        worker_list = NULL;
+    }
+    worker_count = 0;
+    if (NULL != job_list)
+    {
+        delete[] job_list;
+        job_list = NULL;
+    }
+    job_count = 0;
+    jobs_in_use = 0;
+    if (NULL != data_vectors)
+    {
+        delete[] data_vectors;
+        data_vectors = NULL;
+    }
+    if (NULL != data_buffer)
+    {
+        delete[] data_buffer;
+        data_buffer = NULL;
+    }
+    if (NULL != erasure_buffer)
+    {
+        delete[] erasure_buffer;
+        erasure_buffer = NULL;
+    }
+    queue_head = queue_tail = NULL;
+    stopping = false;
+}  // end NormFecWorkerPool::Destroy()
+
+bool NormFecWorkerPool::SetDecoderCacheSize(unsigned int count)
+{
+    bool result = true;
+    for (unsigned int i = 0; i < worker_count; i++)
+    {
+        if (NULL != worker_list[i].decoder)
+            result &= worker_list[i].decoder->SetMatrixCacheSize(count);
+    }
+    return result;
+}  // end NormFecWorkerPool::SetDecoderCacheSize()
+
+void NormFecWorkerPool::GetDecoderCacheStats(unsigned long& hits, unsigned long& misses)
+{
+    // (the counts are approximate while workers are busy)
+    hits = misses = 0;
+    Lock();
+    for (unsigned int i = 0; i < worker_count; i++)
+    {
+        if (NULL != worker_list[i].decoder)
+        {
+            hits += worker_list[i].decoder->GetMatrixCacheHits();
+            misses += worker_list[i].decoder->GetMatrixCacheMisses();
+        }
+    }
+    Unlock();
+}  // end NormFecWorkerPool::GetDecoderCacheStats()
+
+// (called with lock held)
+NormFecWorkerPool::Job* NormFecWorkerPool::FindJob(const void* key)
+{
+    for (unsigned int i = 0; i < job_count; i++)
+    {
+        if ((JOB_FREE != job_list[i].state) && (key == job_list[i].key))
+            return (job_list + i);
+    }
+    return NULL;
+}  // end NormFecWorkerPool::FindJob()
+
+char** NormFecWorkerPool::Reserve(const void* key)
+{
+    char** dataList = NULL;
+    Lock();
+    for (unsigned int i = 0; i < job_count; i++)
+    {
+        Job& job = job_list[i];
+        if (JOB_FREE == job.state)
+        {
+            job.state = JOB_RESERVED;
+            job.key = key;
+            for (unsigned int j = 0; j < vectors_per_job; j++)
+                job.vector_list[j] = job.buffer_list[j];
+            dataList = job.vector_list;
+            jobs_in_use++;
+            break;
+        }
+    }
+    Unlock();
+    return dataList;
+}  // end NormFecWorkerPool::Reserve()
+
+void NormFecWorkerPool::Cancel(const void* key)
+{
+    Lock();
+    Job* job = FindJob(key);
+    ASSERT((NULL != job) && (JOB_RESERVED == job->state));
+    if (NULL != job)
+    {
+        job->state = JOB_FREE;
+        job->key = NULL;
+        jobs_in_use--;
+    }
+    Unlock();
+}  // end NormFecWorkerPool::Cancel()
+
+void NormFecWorkerPool::Submit(const void* key, unsigned int numData, char** parityVectorList)
+{
+    Lock();
+    Job* job = FindJob(key);
+    ASSERT((NULL != job) && (JOB_RESERVED == job->state) && (ENCODE == mode));
+    if (NULL != job)
+    {
+        job->group = NULL;
+        job->num_data = numData;
+        job->parity_list = parityVectorList;
+        Enqueue(job);
+    }
+    Unlock();
+}  // end NormFecWorkerPool::Submit()
+
+void NormFecWorkerPool::SubmitDecode(const void*            key,
+                                     const void*            group,
+                                     unsigned int           numData,
+                                     unsigned int           erasureCount,
+                                     const unsigned int*    erasureLocs)
+{
+    Lock();
+    Job* job = FindJob(key);
+    ASSERT((NULL != job) && (JOB_RESERVED == job->state) && (DECODE == mode));
+    if (NULL != job)
+    {
+        job->group = group;
+        job->num_data = numData;
+        job->erasure_count = erasureCount;
+        memcpy(job->erasure_locs, erasureLocs, erasureCount*sizeof(unsigned int));
+        job->result = false;
+        Enqueue(job);
+    }
+    Unlock();
+}  // end NormFecWorkerPool::SubmitDecode()
+
+// (called with lock held)
+void NormFecWorkerPool::Enqueue(Job* job)
+{
+    job->seq = job_seq++;
+    job->state = JOB_QUEUED;
+    job->next = NULL;
+    if (NULL != queue_tail)
+        queue_tail->next = job;
+    else
+        queue_head = job;
+    queue_tail = job;
+    SignalWork();
+}  // end NormFecWorkerPool::Enqueue()
+
+bool NormFecWorkerPool::Collect(const void* key, unsigned int& numData)
+{
+    Lock();
+    Job* job = FindJob(key);
+    if (NULL == job)
+    {
+        Unlock();
+        return false;
+    }
+    ASSERT(JOB_RESERVED != job->state);
+    while (JOB_DONE != job->state)
+        WaitDone();
+    numData = job->num_data;
+    job->state = JOB_FREE;
+    job->key = NULL;
+    jobs_in_use--;
+    Unlock();
+    return true;
+}  // end NormFecWorkerPool::Collect()
+
+const void* NormFecWorkerPool::Reap(unsigned int& numData)
+{
+    const void* key = NULL;
+    Lock();
+    for (unsigned int i = 0; i < job_count; i++)
+    {
+        Job& job = job_list[i];
+        if (JOB_DONE == job.state)
+        {
+            key = job.key;
+            numData = job.num_data;
+            job.state = JOB_FREE;
+            job.key = NULL;
+            jobs_in_use--;
+            break;
+        }
+    }
+    Unlock();
+    return key;
+}  // end NormFecWorkerPool::Reap()
+
+const void* NormFecWorkerPool::GetDecoded(const void*&          group,
+                                          char**&               vectorList,
+                                          unsigned int&         erasureCount,
+                                          const unsigned int*&  erasureLocs,
+                                          bool&                 decoded)
+{
+    const void* key = NULL;
+    Lock();
+    for (unsigned int i = 0; i < job_count; i++)
+    {
+        Job& job = job_list[i];
+        if (JOB_DONE != job.state) continue;
+        // Hold back completions that would overtake an earlier job of the same group
+        bool inOrder = true;
+        for (unsigned int j = 0; j < job_count; j++)
+        {
+            const Job& prev = job_list[j];
+            if ((j != i) && (prev.group == job.group) && (prev.seq < job.seq) &&
+                ((JOB_QUEUED == prev.state) || (JOB_BUSY == prev.state) || (JOB_DONE == prev.state)))
+            {
+                inOrder = false;
+                break;
+            }
+        }
+        if (inOrder)
+        {
+            key = job.key;
+            group = job.group;
+            vectorList = job.vector_list;
+            erasureCount = job.erasure_count;
+            erasureLocs = job.erasure_locs;
+            decoded = job.result;
+            break;
+        }
+    }
+    Unlock();
+    return key;
+}  // end NormFecWorkerPool::GetDecoded()
+
+void NormFecWorkerPool::Release(const void* key)
+{
+    Lock();
+    Job* job = FindJob(key);
+    if ((NULL != job) && (JOB_DONE == job->state))
+    {
+        job->state = JOB_FREE;
+        job->key = NULL;
+        jobs_in_use--;
+    }
+    Unlock();
+}  // end NormFecWorkerPool::Release()
+
+void NormFecWorkerPool::Run(Worker& worker)
+{
+    Lock();
+    while (true)
+    {
+        Job* job = queue_head;
+        if (NULL == job)
+        {
+            if (stopping) break;  // (queued jobs are finished first)
+            WaitWork();
+            continue;
+        }
+        if (NULL == (queue_head = job->next)) queue_tail = NULL;
+        job->state = JOB_BUSY;
+        Unlock();
+        if (DECODE == mode)
+        {
+            NORM_PROBE2(fec_decode_start, job->num_data, job->erasure_count);
+            job->result = (0 != worker.decoder->Decode(job->vector_list, job->num_data,
+                                                       job->erasure_count, job->erasure_locs));
+            NORM_PROBE2(fec_decode_end, job->num_data, job->erasure_count);
+        }
+        else
+        {
+            NORM_PROBE2(fec_encode_start, job->num_data, 1);
+            worker.encoder->EncodeBlock((const char**)job->vector_list, job->num_data, job->parity_list);
+            NORM_PROBE2(fec_encode_end, job->num_data, 1);
+        }
+        Lock();
+        job->state = JOB_DONE;
+        SignalDone();
+    }
+    Unlock();
+}  // end NormFecWorkerPool::Run()
+
+#ifdef WIN32
+DWORD WINAPI NormFecWorkerPool::DoWorker(LPVOID param)
+{
+    Worker* worker = (Worker*)param;
+    worker->pool->Run(*worker);
+    return 0;
+}  // end NormFecWorkerPool::DoWorker()
+#else
+void* NormFecWorkerPool::DoWorker(void* param)
+{
+    Worker* worker = (Worker*)param;
+    worker->pool->Run(*worker);
+    return NULL;
+}  // end NormFecWorkerPool::DoWorker()
+#endif // if/else WIN32
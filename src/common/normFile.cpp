@@ -11,12 +11,18 @@
 #endif // !_WIN32_WCE
 #else
 #include <unistd.h>
+#include <sys/mman.h>  // for mmap()
 // Most don't have the dirfd() function
 #ifndef HAVE_DIRFD
 static inline int dirfd(DIR *dir) {return (dir->dd_fd);}
 #endif // HAVE_DIRFD    
 #endif // if/else WIN32
 
+#ifdef __linux__
+#include <errno.h>
+#include <sys/inotify.h>  // for NormFileWatcher
+#endif // __linux__
+
 #ifdef HAVE_FLOCK
     #include <sys/file.h>
 #elif defined(HAVE_LOCKF)
@@ -31,16 +37,19 @@ static inline int dirfd(DIR *dir) {return (dir->dd_fd);}
 
 NormFile::NormFile()
 #ifdef _WIN32_WCE
-    : file_ptr(NULL)
+    : file_ptr(NULL),
 #else
-    : fd(-1)
+    : fd(-1),
 #endif // if/else _WIN32_WCE
+      map_ptr(NULL), map_size(0), buffer_ptr(NULL), buffer_size(0),
+      buffer_offset(0), buffer_len(0), buffer_dirty(false)
 {    
 }
 
 NormFile::~NormFile()
 {
     if (IsOpen()) Close();
+    SetBuffer(0);
 }  // end NormFile::~NormFile()
 
 
@@ -150,8 +159,12 @@ bool NormFile::Open(const char* thePath, int theFlags)
 
 void NormFile::Close()
 {
+    if (IsMapped()) Unmap();
     if (IsOpen())
     {
+        if (!Flush())
+            PLOG(PL_ERROR, "NormFile::Close() error: buffered data lost\n");
+        buffer_len = 0;
 #ifdef WIN32
 #ifdef _WIN32_WCE
         fclose(file_ptr);
@@ -249,6 +262,7 @@ bool NormFile::Rename(const char* oldName, const char* newName)
     // performance to close/reopen a file being renamed
     bool wasOpen = false;
 	int oldFlags = 0;
+    Offset oldMapSize = map_size;  // (mapping is restored after reopen)
 	if (IsOpen())
 	{
         wasOpen = true;
@@ -326,6 +340,8 @@ bool NormFile::Rename(const char* oldName, const char* newName)
 #endif // if/else _WIN32_WCE / WIN32|UNIX
         if (wasOpen && !Open(oldName, oldFlags))
             PLOG(PL_ERROR, "NormFile::Rename() error re-opening file w/ old name\n");
+        else if (wasOpen && (0 != oldMapSize) && !Map(oldMapSize))
+            PLOG(PL_WARN, "NormFile::Rename() warning: unable to re-map file\n");
         return false;
     }
     else
@@ -336,6 +352,8 @@ bool NormFile::Rename(const char* oldName, const char* newName)
            return false;
         }
     }
+    if (wasOpen && (0 != oldMapSize) && !Map(oldMapSize))
+        PLOG(PL_WARN, "NormFile::Rename() warning: unable to re-map file\n");
     return true;
 }  // end NormFile::Rename()
 
@@ -436,6 +454,7 @@ bool NormFile::Seek(Offset theOffset)
 
 bool NormFile::Pad(Offset theOffset)
 {
+    if (!Flush()) return false;
     if (theOffset > GetSize())
     {
         if (Seek(theOffset - 1))
@@ -456,6 +475,192 @@ bool NormFile::Pad(Offset theOffset)
     return true; 
 }  // end NormFile::Pad()
 
+bool NormFile::SetBuffer(size_t size)
+{
+    if (size == buffer_size) return true;
+    bool result = IsOpen() ? Flush() : true;
+    if (NULL != buffer_ptr)
+    {
+        delete[] buffer_ptr;
+        buffer_ptr = NULL;
+    }
+    buffer_size = buffer_len = 0;
+    buffer_dirty = false;
+    if (0 != size)
+    {
+        if (NULL == (buffer_ptr = new char[size]))
+        {
+            PLOG(PL_FATAL, "NormFile::SetBuffer() new buffer error: %s\n", GetErrorString());
+            return false;
+        }
+        buffer_size = size;
+    }
+    return result;
+}  // end NormFile::SetBuffer()
+
+bool NormFile::Flush()
+{
+    if (!buffer_dirty) return true;
+    buffer_dirty = false;
+    // (the flushed content remains valid for ReadBuffered())
+    if (!Seek(buffer_offset) || (buffer_len != Write(buffer_ptr, buffer_len)))
+    {
+        PLOG(PL_FATAL, "NormFile::Flush() error writing buffered data\n");
+        buffer_len = 0;
+        return false;
+    }
+    return true;
+}  // end NormFile::Flush()
+
+size_t NormFile::ReadBuffered(Offset theOffset, char* buffer, size_t len, Offset fillOffset)
+{
+    if ((theOffset >= buffer_offset) && ((theOffset + (Offset)len) <= (buffer_offset + (Offset)buffer_len)))
+    {
+        memcpy(buffer, buffer_ptr + (size_t)(theOffset - buffer_offset), len);
+        return len;
+    }
+    if (!Flush()) return 0;
+    if (len > buffer_size)
+    {
+        // Too big to buffer, so read directly
+        if (!Seek(theOffset)) return 0;
+        return Read(buffer, len);
+    }
+    if ((fillOffset > theOffset) || ((theOffset + (Offset)len) > (fillOffset + (Offset)buffer_size)))
+        fillOffset = theOffset;
+    // Don't try to read past the end of the file
+    size_t fillLen = buffer_size;
+    Offset fileSize = GetSize();
+    if ((fillOffset + (Offset)fillLen) > fileSize)
+        fillLen = (fileSize > fillOffset) ? (size_t)(fileSize - fillOffset) : 0;
+    buffer_len = 0;
+    if ((fillOffset + (Offset)fillLen) < (theOffset + (Offset)len))
+        return 0;  // requested data is not in the file
+    if (!Seek(fillOffset) || (fillLen != Read(buffer_ptr, fillLen)))
+        return 0;
+    buffer_offset = fillOffset;
+    buffer_len = fillLen;
+    memcpy(buffer, buffer_ptr + (size_t)(theOffset - buffer_offset), len);
+    return len;
+}  // end NormFile::ReadBuffered()
+
+bool NormFile::WriteBuffered(Offset theOffset, const char* buffer, size_t len)
+{
+    Offset bufferEnd = buffer_offset + (Offset)buffer_len;
+    if (buffer_dirty && (theOffset >= buffer_offset) && (theOffset <= bufferEnd) &&
+        ((size_t)(theOffset - buffer_offset) + len <= buffer_size))
+    {
+        // Extends (or overwrites part of) the pending write
+        size_t index = (size_t)(theOffset - buffer_offset);
+        memcpy(buffer_ptr + index, buffer, len);
+        if ((index + len) > buffer_len) buffer_len = index + len;
+    }
+    else
+    {
+        if (!Flush()) return false;
+        if (len > buffer_size)
+        {
+            // Too big to buffer, so write directly
+            buffer_len = 0;
+            if (!Seek(theOffset)) return false;
+            return (len == Write(buffer, len));
+        }
+        // (any clean read content is replaced)
+        memcpy(buffer_ptr, buffer, len);
+        buffer_offset = theOffset;
+        buffer_len = len;
+        buffer_dirty = true;
+    }
+    return (buffer_len < buffer_size) ? true : Flush();
+}  // end NormFile::WriteBuffered()
+
+#ifndef WIN32
+// Allocates disk space for the file out to "size" so that a MAP_SHARED
+// mapping of it can't fault (SIGBUS) on a full disk when its pages are
+// first touched.  (Returns false with "errno" set if the space isn't there.)
+static bool ReserveFileSpace(int fd, off_t oldSize, off_t size)
+{
+#ifdef __linux__
+    int result = posix_fallocate(fd, oldSize, size - oldSize);
+    if (0 == result) return true;
+    if ((EOPNOTSUPP != result) && (EINVAL != result))
+    {
+        errno = result;
+        return false;
+    }
+    // (else the file system doesn't support it, so write the space instead)
+#endif // __linux__
+    // Writing a byte to each file system block allocates it
+    struct stat info;
+    off_t blockSize = ((0 == fstat(fd, &info)) && (info.st_blksize > 0)) ? info.st_blksize : 512;
+    off_t offset = oldSize - (oldSize % blockSize);
+    if (offset < oldSize) offset += blockSize;  // (the partial tail block is allocated)
+    const char zero = 0;
+    for (; offset < size; offset += blockSize)
+    {
+        if (1 != pwrite(fd, &zero, 1, offset))
+            return false;
+    }
+    if (1 != pwrite(fd, &zero, 1, size - 1))
+        return false;
+    return true;
+}  // end ReserveFileSpace()
+#endif // !WIN32
+
+bool NormFile::Map(Offset size)
+{
+#ifdef WIN32
+    // (TBD) support CreateFileMapping() / MapViewOfFile() here
+    return false;
+#else
+    ASSERT(IsOpen());
+    if (IsMapped()) Unmap();
+    // Zero-length files can't be mapped and on 32-bit systems big
+    // files may not fit the address space
+    if ((size <= 0) || ((Offset)((size_t)size) != size))
+        return false;
+    bool writable = (O_RDONLY != (flags & O_ACCMODE));
+    Offset oldSize = writable ? GetSize() : size;
+    if ((oldSize < size) && !ReserveFileSpace(fd, (off_t)oldSize, (off_t)size))
+    {
+        PLOG(PL_WARN, "NormFile::Map() error: unable to allocate file space: %s\n", GetErrorString());
+        if (0 != ftruncate(fd, oldSize))  // (give back any partial allocation)
+            PLOG(PL_WARN, "NormFile::Map() ftruncate() error: %s\n", GetErrorString());
+        return false;
+    }
+    int prot = writable ? (PROT_READ | PROT_WRITE) : PROT_READ;
+    void* ptr = mmap(NULL, (size_t)size, prot, MAP_SHARED, fd, 0);
+    if (MAP_FAILED == ptr)
+    {
+        PLOG(PL_WARN, "NormFile::Map() mmap() error: %s\n", GetErrorString());
+        return false;
+    }
+    // Senders mostly read files front to back
+    if (!writable) madvise(ptr, (size_t)size, MADV_SEQUENTIAL);
+    map_ptr = (char*)ptr;
+    map_size = size;
+    return true;
+#endif // if/else WIN32
+}  // end NormFile::Map()
+
+void NormFile::Unmap()
+{
+#ifndef WIN32
+    if (NULL != map_ptr)
+        munmap(map_ptr, (size_t)map_size);
+#endif // !WIN32
+    map_ptr = NULL;
+    map_size = 0;
+}  // end NormFile::Unmap()
+
+void NormFile::Unmap(char* ptr, Offset size)
+{
+#ifndef WIN32
+    if (NULL != ptr)
+        munmap(ptr, (size_t)size);
+#endif // !WIN32
+}  // end NormFile::Unmap(ptr, size)
+
 NormFile::Offset NormFile::GetSize() const
 {
     ASSERT(IsOpen());
@@ -1020,9 +1225,283 @@ bool NormFile::Unlink(const char* path)
 
 }  // end NormFile::Unlink()
 
+NormFileWatcher::Watch::Watch(int wd, const char* thePath, bool isRecursive)
+ : descriptor(wd), recursive(isRecursive)
+{
+    if (NULL != (path = new char[strlen(thePath) + 1]))
+        strcpy(path, thePath);
+}
+
+NormFileWatcher::Watch::~Watch()
+{
+    if (NULL != path) delete[] path;
+}
+
+NormFileWatcher::Change::Change(const char* thePath)
+ : key_size(0), next(NULL)
+{
+    size_t len = strlen(thePath);
+    if (NULL != (path = new char[len + 1]))
+    {
+        strcpy(path, thePath);
+        key_size = (unsigned int)((len + 1) << 3);
+    }
+}
+
+NormFileWatcher::Change::~Change()
+{
+    if (NULL != path) delete[] path;
+}
+
+NormFileWatcher::NormFileWatcher()
+ : descriptor(-1), change_head(NULL), change_tail(NULL), overflow(false)
+{
+}
+
+NormFileWatcher::~NormFileWatcher()
+{
+    Close();
+}
+
+bool NormFileWatcher::Open()
+{
+    Close();
+#ifdef __linux__
+    // (non-blocking so Update() just reads what's queued)
+    if ((descriptor = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0)
+    {
+        PLOG(PL_ERROR, "NormFileWatcher::Open() inotify_init1() error: %s\n", GetErrorString());
+        return false;
+    }
+    overflow = false;
+    return true;
+#else
+    return false;  // (not supported, so NormFileList walks the tree for updates)
+#endif // if/else __linux__
+}  // end NormFileWatcher::Open()
+
+void NormFileWatcher::Close()
+{
+    ClearChanges();
+    while (!watch_tree.IsEmpty())
+    {
+        WatchTree::Iterator iterator(watch_tree);
+        Watch* watch = iterator.GetNextItem();
+        watch_tree.Remove(*watch);
+        delete watch;
+    }
+#ifdef __linux__
+    if (descriptor >= 0) close(descriptor);  // (removes the kernel watches)
+#endif // __linux__
+    descriptor = -1;
+    overflow = false;
+}  // end NormFileWatcher::Close()
+
+void NormFileWatcher::MakePath(char* buffer, const char* dirPath, const char* name)
+{
+    size_t len = strlen(dirPath);
+    len = MIN(len, PATH_MAX - 1);
+    memcpy(buffer, dirPath, len);
+    if ((0 != len) && (PROTO_PATH_DELIMITER != buffer[len-1]) && (len < (PATH_MAX - 1)))
+        buffer[len++] = PROTO_PATH_DELIMITER;
+    buffer[len] = '\0';
+    strncat(buffer, name, PATH_MAX - 1 - len);
+}  // end NormFileWatcher::MakePath()
+
+bool NormFileWatcher::WatchDirectory(const char* path, bool recursive, bool queueFiles)
+{
+#ifdef __linux__
+    if (!IsOpen()) return false;
+    // (files are reported once written and closed, moved in or touched and
+    //  sub-directory creation is watched for)
+    UINT32 mask = IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB | IN_CREATE | IN_ONLYDIR;
+    int wd = inotify_add_watch(descriptor, ('\0' != path[0]) ? path : ".", mask);
+    if (wd < 0)
+    {
+        // (e.g. ENOSPC when "fs.inotify.max_user_watches" is exceeded)
+        PLOG(PL_ERROR, "NormFileWatcher::WatchDirectory() inotify_add_watch(%s) error: %s\n",
+                       path, GetErrorString());
+        return false;
+    }
+    Watch* watch = watch_tree.Find((const char*)&wd, sizeof(int) << 3);
+    if (NULL != watch)
+    {
+        // Already watched (e.g. for a file and as part of a tree, or
+        // reached again through a symbolic link), so it's covered unless
+        // only its own files were watched so far
+        if (!recursive || watch->IsRecursive()) return true;
+        watch->SetRecursive();
+    }
+    else
+    {
+        watch = new Watch(wd, path, recursive);
+        if ((NULL == watch) || (NULL == watch->GetPath()))
+        {
+            PLOG(PL_ERROR, "NormFileWatcher::WatchDirectory() new Watch error: %s\n", GetErrorString());
+            if (NULL != watch) delete watch;
+            inotify_rm_watch(descriptor, wd);
+            return false;
+        }
+        watch_tree.Insert(*watch);
+    }
+    if (!recursive && !queueFiles) return true;
+    
+    // Walk the directory to watch its sub-directories (and queue its files)
+    DIR* dptr = opendir(('\0' != path[0]) ? path : ".");
+    if (NULL == dptr)
+    {
+        PLOG(PL_ERROR, "NormFileWatcher::WatchDirectory() opendir(%s) error: %s\n", path, GetErrorString());
+        return false;
+    }
+    bool result = true;
+    char childPath[PATH_MAX];
+    struct dirent* dp;
+    while (result && (NULL != (dp = readdir(dptr))))
+    {
+        if (('.' == dp->d_name[0]) && 
+            (('\0' == dp->d_name[1]) || (('.' == dp->d_name[1]) && ('\0' == dp->d_name[2]))))
+        {
+            continue;  // skip "." and ".." directory names
+        }
+        MakePath(childPath, path, dp->d_name);
+        // (d_type saves a stat() per entry where the file system provides it)
+        NormFile::Type type;
+        if (DT_DIR == dp->d_type)
+            type = NormFile::DIRECTORY;
+        else if (DT_REG == dp->d_type)
+            type = NormFile::NORMAL;
+        else
+            type = NormFile::GetType(childPath);  // (DT_UNKNOWN or a symbolic link)
+        if (NormFile::DIRECTORY == type)
+        {
+            if (recursive) result = WatchDirectory(childPath, true, queueFiles);
+        }
+        else if ((NormFile::NORMAL == type) && queueFiles)
+        {
+            QueueChange(childPath);
+        }
+    }
+    closedir(dptr);
+    return result;
+#else
+    return false;
+#endif // if/else __linux__
+}  // end NormFileWatcher::WatchDirectory()
+
+bool NormFileWatcher::Update()
+{
+#ifdef __linux__
+    if (!IsOpen()) return false;
+    char buffer[4096] __attribute__ ((aligned(__alignof__(struct inotify_event))));
+    for (;;)
+    {
+        ssize_t result = read(descriptor, buffer, sizeof(buffer));
+        if (result <= 0)
+        {
+            if (result < 0)
+            {
+                if (EINTR == errno) continue;
+                if (EAGAIN != errno)
+                {
+                    PLOG(PL_ERROR, "NormFileWatcher::Update() read() error: %s\n", GetErrorString());
+                    overflow = true;
+                }
+            }
+            break;  // (nothing more queued)
+        }
+        const char* ptr = buffer;
+        const char* end = buffer + result;
+        while (ptr < end)
+        {
+            const struct inotify_event* event = (const struct inotify_event*)ptr;
+            ptr += sizeof(struct inotify_event) + event->len;
+            if (0 != (event->mask & IN_Q_OVERFLOW))
+            {
+                overflow = true;
+                continue;
+            }
+            Watch* watch = watch_tree.Find((const char*)&event->wd, sizeof(int) << 3);
+            if (NULL == watch) continue;
+            if (0 != (event->mask & IN_IGNORED))
+            {
+                // The directory was removed (or unmounted)
+                watch_tree.Remove(*watch);
+                delete watch;
+                continue;
+            }
+            if (0 == event->len) continue;  // (event for the directory itself)
+            char path[PATH_MAX];
+            MakePath(path, watch->GetPath(), event->name);
+            if (0 != (event->mask & IN_ISDIR))
+            {
+                // A new (or moved in) sub-directory, so watch it and queue its files
+                if (watch->IsRecursive() && (0 != (event->mask & (IN_CREATE | IN_MOVED_TO))))
+                {
+                    if (!WatchDirectory(path, true, true))
+                        overflow = true;  // (its changes can't be tracked)
+                }
+            }
+            else if (0 != (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO | IN_ATTRIB)))
+            {
+                QueueChange(path);
+            }
+        }
+    }
+    bool result = !overflow;
+    overflow = false;
+    return result;
+#else
+    return false;
+#endif // if/else __linux__
+}  // end NormFileWatcher::Update()
+
+void NormFileWatcher::QueueChange(const char* path)
+{
+    // (a file already queued keeps its place)
+    if (NULL != change_tree.Find(path, (unsigned int)((strlen(path) + 1) << 3))) return;
+    Change* change = new Change(path);
+    if ((NULL == change) || (NULL == change->GetPath()))
+    {
+        PLOG(PL_ERROR, "NormFileWatcher::QueueChange() new Change error: %s\n", GetErrorString());
+        if (NULL != change) delete change;
+        overflow = true;  // (the change is lost)
+        return;
+    }
+    change_tree.Insert(*change);
+    if (NULL != change_tail)
+        change_tail->SetNext(change);
+    else
+        change_head = change;
+    change_tail = change;
+}  // end NormFileWatcher::QueueChange()
+
+bool NormFileWatcher::GetNextChange(char* pathBuffer)
+{
+    Change* change = change_head;
+    if (NULL == change) return false;
+    if (NULL == (change_head = change->GetNext())) change_tail = NULL;
+    change_tree.Remove(*change);
+    strncpy(pathBuffer, change->GetPath(), PATH_MAX);
+    delete change;
+    return true;
+}  // end NormFileWatcher::GetNextChange()
+
+void NormFileWatcher::ClearChanges()
+{
+    Change* change;
+    while (NULL != (change = change_head))
+    {
+        change_head = change->GetNext();
+        change_tree.Remove(*change);
+        delete change;
+    }
+    change_tail = NULL;
+}  // end NormFileWatcher::ClearChanges()
+
 NormFileList::NormFileList()
  : this_time(0), big_time(0), last_time(0),
-   updates_only(false), head(NULL), tail(NULL), next(NULL)
+   updates_only(false), head(NULL), tail(NULL), next(NULL),
+   watch_ready(false), watch_failed(false)
 { 
 }
         
@@ -1039,10 +1518,15 @@ void NormFileList::Destroy()
         delete next;   
     }
     tail = NULL;
+    watcher.Close();
+    watch_ready = false;
 }  // end NormFileList::Destroy()
 
 bool NormFileList::Append(const char* path)
 {
+    // (the next pass walks the list again and restarts the watch)
+    watcher.Close();
+    watch_ready = false;
     FileItem* theItem = NULL;
     switch(NormFile::GetType(path))
     {
@@ -1114,8 +1598,11 @@ bool NormFileList::Remove(const char* path)
 
 bool NormFileList::GetNextFile(char* pathBuffer)
 {
+    if (watch_ready) return GetNextChange(pathBuffer);
     if (!next)
     {
+        // The watch (if any) is set up before the walk so no change is missed
+        if (updates_only) StartWatch();
         next = head;
         reset = true;
     }
@@ -1138,6 +1625,8 @@ bool NormFileList::GetNextFile(char* pathBuffer)
             else
             {
                 reset = false;
+                // Later passes just get the changes the watcher saw
+                if (watcher.IsOpen()) watch_ready = true;
                 return false;  // end of list
             }   
         }
@@ -1148,6 +1637,96 @@ bool NormFileList::GetNextFile(char* pathBuffer)
     }
 }  // end NormFileList::GetNextFile()
 
+void NormFileList::StartWatch()
+{
+    if (watch_failed) return;
+    if (!watcher.Open())
+    {
+        watch_failed = true;  // (not supported, so each pass walks the list)
+        return;
+    }
+    FileItem* item = head;
+    while (NULL != item)
+    {
+        bool result;
+        if (NormFile::DIRECTORY == item->GetType())
+        {
+            result = watcher.WatchDirectory(item->Path(), true);
+        }
+        else
+        {
+            // Watch the file's directory (FindOwner() ignores its other files)
+            char dirPath[PATH_MAX];
+            strncpy(dirPath, item->Path(), PATH_MAX);
+            dirPath[PATH_MAX-1] = '\0';
+            char* ptr = strrchr(dirPath, PROTO_PATH_DELIMITER);
+            if (NULL == ptr)
+                dirPath[0] = '\0';  // (current directory)
+            else if (ptr == dirPath)
+                dirPath[1] = '\0';  // (root directory)
+            else
+                *ptr = '\0';
+            result = watcher.WatchDirectory(dirPath, false);
+        }
+        if (!result)
+        {
+            PLOG(PL_WARN, "NormFileList::StartWatch() warning: unable to watch \"%s\" (will check update times instead)\n",
+                          item->Path());
+            watcher.Close();
+            watch_failed = true;
+            return;
+        }
+        item = item->next;
+    }
+}  // end NormFileList::StartWatch()
+
+bool NormFileList::GetNextChange(char* pathBuffer)
+{
+    if (!watcher.Update())
+    {
+        // Changes were lost, so walk the whole list again (restarting the watch)
+        PLOG(PL_WARN, "NormFileList::GetNextChange() warning: file change notifications lost, checking all files\n");
+        watcher.Close();
+        watch_ready = false;
+        next = NULL;
+        return GetNextFile(pathBuffer);
+    }
+    while (watcher.GetNextChange(pathBuffer))
+    {
+        FileItem* item = FindOwner(pathBuffer);
+        if (NULL == item) continue;  // (another file in a listed file's directory)
+        if (NormFile::NORMAL != NormFile::GetType(pathBuffer)) continue;  // (removed since)
+        // (keeps "big_time" current in case we fall back to walking)
+        time_t updateTime = NormFile::GetUpdateTime(pathBuffer);
+        if (updateTime > big_time) big_time = updateTime;
+        next = item;  // for GetCurrentBasePath()
+        return true;
+    }
+    return false;
+}  // end NormFileList::GetNextChange()
+
+// Finds the list item a changed file path belongs to
+NormFileList::FileItem* NormFileList::FindOwner(const char* path)
+{
+    FileItem* item = head;
+    while (NULL != item)
+    {
+        if (NormFile::DIRECTORY == item->GetType())
+        {
+            size_t len = strlen(item->Path());
+            if ((0 != len) && (PROTO_PATH_DELIMITER == item->Path()[len-1])) len--;
+            if (!strncmp(path, item->Path(), len) && (PROTO_PATH_DELIMITER == path[len]))
+                return item;
+        }
+        else if (!strcmp(path, item->Path()))
+        {
+            return item;
+        }
+        item = item->next;
+    }
+    return NULL;
+}  // end NormFileList::FindOwner()
+
 void NormFileList::GetCurrentBasePath(char* pathBuffer)
 {
     if (next)
@@ -0,0 +1,524 @@
+#include "normFileIo.h"
+#include "protoDebug.h"
+
+#ifdef NORM_FILE_IO
+#include <unistd.h>  // for pread(), pwrite()
+#include <errno.h>
+#include <string.h>  // for memcpy(), strerror()
+
+NormFileIoEngine::NormFileIoEngine()
+ : request_list(NULL), request_count(0), free_head(NULL), queue_head(NULL), queue_tail(NULL),
+   thread_list(NULL), fail_count(0), fail_overflow(false), stopping(false),
+#ifdef NORM_FILE_IO_URING
+   ring_init(false),
+#endif // NORM_FILE_IO_URING
+   thread_count(0)
+{
+    pthread_mutex_init(&mutex, NULL);
+    pthread_cond_init(&work_cond, NULL);
+    pthread_cond_init(&done_cond, NULL);
+}
+
+NormFileIoEngine::~NormFileIoEngine()
+{
+    Destroy();
+    pthread_cond_destroy(&done_cond);
+    pthread_cond_destroy(&work_cond);
+    pthread_mutex_destroy(&mutex);
+}
+
+bool NormFileIoEngine::Init(unsigned int numWorkers, unsigned int pendingMax)
+{
+    Destroy();
+    if (0 == numWorkers) return true;
+    if (0 == pendingMax) pendingMax = PENDING_MAX_DEFAULT;
+    if (NULL == (request_list = new Request[pendingMax]))
+    {
+        PLOG(PL_FATAL, "NormFileIoEngine::Init() error: allocation failure: %s\n", GetErrorString());
+        return false;
+    }
+    for (unsigned int i = 0; i < pendingMax; i++)
+    {
+        Request& req = request_list[i];
+        req.state = REQ_FREE;
+        req.is_write = req.orphan = false;
+        req.fd = -1;
+        req.offset = 0;
+        req.length = req.done = 0;
+        req.result = 0;
+        req.buffer = NULL;
+        req.buffer_size = 0;
+        req.next = (i < (pendingMax - 1)) ? (request_list + i + 1) : NULL;
+    }
+    request_count = pendingMax;
+    free_head = request_list;
+    queue_head = queue_tail = NULL;
+    fail_count = 0;
+    fail_overflow = false;
+#ifdef NORM_FILE_IO_URING
+    // A single thread drives the ring, but fall back to the
+    // worker pool if io_uring isn't permitted (e.g. older kernel)
+    int result = io_uring_queue_init(pendingMax, &ring, 0);
+    if (0 == result)
+    {
+        ring_init = true;
+        numWorkers = 1;
+    }
+    else
+    {
+        PLOG(PL_WARN, "NormFileIoEngine::Init() io_uring_queue_init() error: %s (using worker threads)\n",
+                      strerror(-result));
+    }
+#endif // NORM_FILE_IO_URING
+    if (NULL == (thread_list = new pthread_t[numWorkers]))
+    {
+        PLOG(PL_FATAL, "NormFileIoEngine::Init() error: allocation failure: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
+    stopping = false;
+    for (unsigned int i = 0; i < numWorkers; i++)
+    {
+        if (0 != pthread_create(thread_list + i, NULL, DoThread, this))
+        {
+            PLOG(PL_FATAL, "NormFileIoEngine::Init() error: unable to start thread: %s\n", GetErrorString());
+            Destroy();
+            return false;
+        }
+        thread_count++;
+    }
+    return true;
+}  // end NormFileIoEngine::Init()
+
+void NormFileIoEngine::Destroy()
+{
+    if (NULL != thread_list)
+    {
+        // (the thread(s) finish any queued requests before exiting)
+        Lock();
+        stopping = true;
+        pthread_cond_broadcast(&work_cond);
+        Unlock();
+        for (unsigned int i = 0; i < thread_count; i++)
+            pthread_join(thread_list[i], NULL);
+        delete[] thread_list;
+        thread_list = NULL;
+    }
+    thread_count = 0;
+#ifdef NORM_FILE_IO_URING
+    if (ring_init)
+    {
+        io_uring_queue_exit(&ring);
+        ring_init = false;
+    }
+#endif // NORM_FILE_IO_URING
+    if (NULL != request_list)
+    {
+        for (unsigned int i = 0; i < request_count; i++)
+        {
+            if (NULL != request_list[i].buffer)
+                delete[] request_list[i].buffer;
+        }
+        delete[] request_list;
+        request_list = NULL;
+    }
+    request_count = 0;
+    free_head = queue_head = queue_tail = NULL;
+    fail_count = 0;
+    fail_overflow = false;
+    stopping = false;
+}  // end NormFileIoEngine::Destroy()
+
+// (called with lock held)
+NormFileIoEngine::Request* NormFileIoEngine::GetFreeRequest(bool wait)
+{
+    while (NULL == free_head)
+    {
+        if (!wait || stopping) return NULL;
+        pthread_cond_wait(&done_cond, &mutex);
+    }
+    Request* req = free_head;
+    free_head = req->next;
+    req->next = NULL;
+    req->orphan = false;
+    req->done = 0;
+    req->result = 0;
+    return req;
+}  // end NormFileIoEngine::GetFreeRequest()
+
+// (called with lock held)
+void NormFileIoEngine::FreeRequest(Request* req)
+{
+    req->state = REQ_FREE;
+    req->fd = -1;
+    req->next = free_head;
+    free_head = req;
+}  // end NormFileIoEngine::FreeRequest()
+
+// (called with lock held)
+void NormFileIoEngine::Enqueue(Request* req)
+{
+    req->state = REQ_QUEUED;
+    req->next = NULL;
+    if (NULL != queue_tail)
+        queue_tail->next = req;
+    else
+        queue_head = req;
+    queue_tail = req;
+    pthread_cond_signal(&work_cond);
+}  // end NormFileIoEngine::Enqueue()
+
+// (called with lock held)
+NormFileIoEngine::Request* NormFileIoEngine::Dequeue()
+{
+    Request* req = queue_head;
+    if (NULL != req)
+    {
+        if (NULL == (queue_head = req->next)) queue_tail = NULL;
+        req->next = NULL;
+        req->state = REQ_BUSY;
+    }
+    return req;
+}  // end NormFileIoEngine::Dequeue()
+
+// (called with lock held)
+void NormFileIoEngine::Complete(Request* req)
+{
+    if (req->is_write)
+    {
+        if (req->result < 0)
+        {
+            bool found = false;
+            for (unsigned int i = 0; i < fail_count; i++)
+            {
+                if (req->fd == fail_list[i])
+                {
+                    found = true;
+                    break;
+                }
+            }
+            if (!found)
+            {
+                if (fail_count < FAIL_MAX)
+                    fail_list[fail_count++] = req->fd;
+                else
+                    fail_overflow = true;
+            }
+        }
+        FreeRequest(req);
+    }
+    else if (req->orphan)
+    {
+        FreeRequest(req);
+    }
+    else
+    {
+        req->state = REQ_DONE;
+    }
+    pthread_cond_broadcast(&done_cond);
+}  // end NormFileIoEngine::Complete()
+
+// Does blocking I/O for the remainder (if any) of the request and sets its result
+void NormFileIoEngine::Execute(Request* req)
+{
+    while (req->done < req->length)
+    {
+        ssize_t result;
+        if (req->is_write)
+            result = pwrite(req->fd, req->buffer + req->done, req->length - req->done, req->offset + req->done);
+        else
+            result = pread(req->fd, req->buffer + req->done, req->length - req->done, req->offset + req->done);
+        if (result < 0)
+        {
+            if (EINTR == errno) continue;
+            PLOG(PL_ERROR, "NormFileIoEngine::Execute() %s() error: %s\n",
+                           req->is_write ? "pwrite" : "pread", GetErrorString());
+            req->result = -1;
+            return;
+        }
+        else if (0 == result)
+        {
+            break;  // end-of-file
+        }
+        req->done += result;
+    }
+    req->result = (req->is_write && (req->done < req->length)) ? -1 : (long)req->done;
+}  // end NormFileIoEngine::Execute()
+
+bool NormFileIoEngine::Write(int fd, NormFile::Offset offset, const char* buffer, size_t len)
+{
+    Lock();
+    Request* req = IsActive() ? GetFreeRequest(true) : NULL;
+    Unlock();
+    if (NULL == req) return false;
+    // The request is ours until enqueued, so copy the data without the lock held
+    if (req->buffer_size < len)
+    {
+        if (NULL != req->buffer) delete[] req->buffer;
+        if (NULL == (req->buffer = new char[len]))
+        {
+            PLOG(PL_FATAL, "NormFileIoEngine::Write() new buffer error: %s\n", GetErrorString());
+            req->buffer_size = 0;
+            Lock();
+            FreeRequest(req);
+            Unlock();
+            return false;
+        }
+        req->buffer_size = len;
+    }
+    memcpy(req->buffer, buffer, len);
+    req->is_write = true;
+    req->fd = fd;
+    req->offset = offset;
+    req->length = len;
+    Lock();
+    Enqueue(req);
+    Unlock();
+    return true;
+}  // end NormFileIoEngine::Write()
+
+NormFileIoEngine::Request* NormFileIoEngine::Read(int fd, NormFile::Offset offset, size_t len)
+{
+    Lock();
+    Request* req = IsActive() ? GetFreeRequest(false) : NULL;
+    Unlock();
+    if (NULL == req) return NULL;
+    if (req->buffer_size < len)
+    {
+        if (NULL != req->buffer) delete[] req->buffer;
+        if (NULL == (req->buffer = new char[len]))
+        {
+            PLOG(PL_FATAL, "NormFileIoEngine::Read() new buffer error: %s\n", GetErrorString());
+            req->buffer_size = 0;
+            Lock();
+            FreeRequest(req);
+            Unlock();
+            return NULL;
+        }
+        req->buffer_size = len;
+    }
+    req->is_write = false;
+    req->fd = fd;
+    req->offset = offset;
+    req->length = len;
+    Lock();
+    Enqueue(req);
+    Unlock();
+    return req;
+}  // end NormFileIoEngine::Read()
+
+long NormFileIoEngine::Wait(Request* req, const char*& buffer)
+{
+    Lock();
+    while (REQ_DONE != req->state)
+        pthread_cond_wait(&done_cond, &mutex);
+    long result = req->result;
+    Unlock();
+    buffer = req->buffer;
+    return result;
+}  // end NormFileIoEngine::Wait()
+
+void NormFileIoEngine::Release(Request* req)
+{
+    Lock();
+    if (REQ_DONE == req->state)
+    {
+        FreeRequest(req);
+        pthread_cond_broadcast(&done_cond);
+    }
+    else
+    {
+        req->orphan = true;  // freed upon completion
+    }
+    Unlock();
+}  // end NormFileIoEngine::Release()
+
+bool NormFileIoEngine::Flush(int fd)
+{
+    if (!IsActive()) return true;
+    Lock();
+    // Wait until no requests (orphaned reads included) reference "fd"
+    bool pending = true;
+    while (pending)
+    {
+        pending = false;
+        for (unsigned int i = 0; i < request_count; i++)
+        {
+            const Request& req = request_list[i];
+            if ((fd == req.fd) && ((REQ_QUEUED == req.state) || (REQ_BUSY == req.state)))
+            {
+                pending = true;
+                break;
+            }
+        }
+        if (pending) pthread_cond_wait(&done_cond, &mutex);
+    }
+    bool result = !fail_overflow;
+    for (unsigned int i = 0; i < fail_count; i++)
+    {
+        if (fd == fail_list[i])
+        {
+            fail_list[i] = fail_list[--fail_count];
+            result = false;
+            break;
+        }
+    }
+    Unlock();
+    return result;
+}  // end NormFileIoEngine::Flush()
+
+void* NormFileIoEngine::DoThread(void* param)
+{
+    NormFileIoEngine* engine = (NormFileIoEngine*)param;
+#ifdef NORM_FILE_IO_URING
+    if (engine->ring_init)
+    {
+        engine->RunUring();
+        return NULL;
+    }
+#endif // NORM_FILE_IO_URING
+    engine->RunWorker();
+    return NULL;
+}  // end NormFileIoEngine::DoThread()
+
+void NormFileIoEngine::RunWorker()
+{
+    Lock();
+    while (true)
+    {
+        while (!stopping && (NULL == queue_head))
+            pthread_cond_wait(&work_cond, &mutex);
+        Request* req = Dequeue();
+        if (NULL == req) break;  // stopping and nothing left to do
+        Unlock();
+        Execute(req);
+        Lock();
+        Complete(req);
+    }
+    Unlock();
+}  // end NormFileIoEngine::RunWorker()
+
+#ifdef NORM_FILE_IO_URING
+void NormFileIoEngine::RunUring()
+{
+    unsigned int inflight = 0;
+    Lock();
+    while (true)
+    {
+        while (!stopping && (NULL == queue_head) && (0 == inflight))
+            pthread_cond_wait(&work_cond, &mutex);
+        if ((NULL == queue_head) && (0 == inflight)) break;  // stopping
+        unsigned int count = 0;
+        while (NULL != queue_head)
+        {
+            // The ring is sized for all requests, so this only fails transiently
+            struct io_uring_sqe* sqe = io_uring_get_sqe(&ring);
+            if (NULL == sqe) break;
+            Request* req = Dequeue();
+            if (req->is_write)
+                io_uring_prep_write(sqe, req->fd, req->buffer, req->length, req->offset);
+            else
+                io_uring_prep_read(sqe, req->fd, req->buffer, req->length, req->offset);
+            io_uring_sqe_set_data(sqe, req);
+            count++;
+        }
+        Unlock();
+        inflight += count;
+        // (submitting each pass also retries any entries a prior submit left queued)
+        int result = io_uring_submit(&ring);
+        if ((result < 0) && (-EINTR != result) && (-EAGAIN != result) && (-EBUSY != result))
+            PLOG(PL_WARN, "NormFileIoEngine::RunUring() io_uring_submit() error: %s\n", strerror(-result));
+        // Reap completions, waiting briefly so newly queued requests
+        // are submitted without much delay
+        Request* doneList = NULL;
+        struct __kernel_timespec timeout;
+        timeout.tv_sec = 0;
+        timeout.tv_nsec = 1000000;
+        struct io_uring_cqe* cqe;
+        if (0 == io_uring_wait_cqe_timeout(&ring, &cqe, &timeout))
+        {
+            while (0 == io_uring_peek_cqe(&ring, &cqe))
+            {
+                Request* req = (Request*)io_uring_cqe_get_data(cqe);
+                int res = cqe->res;
+                io_uring_cqe_seen(&ring, cqe);
+                inflight--;
+                if ((res < 0) && (-EINTR != res) && (-EAGAIN != res))
+                {
+                    PLOG(PL_ERROR, "NormFileIoEngine::RunUring() %s error: %s\n",
+                                   req->is_write ? "write" : "read", strerror(-res));
+                    req->result = -1;
+                }
+                else
+                {
+                    // Retries and short transfers are finished synchronously
+                    if (res > 0) req->done += res;
+                    if ((req->done < req->length) && (0 != res))
+                        Execute(req);
+                    else
+                        req->result = (req->is_write && (req->done < req->length)) ? -1 : (long)req->done;
+                }
+                req->next = doneList;
+                doneList = req;
+            }
+        }
+        Lock();
+        while (NULL != doneList)
+        {
+            Request* req = doneList;
+            doneList = req->next;
+            Complete(req);
+        }
+    }
+    Unlock();
+}  // end NormFileIoEngine::RunUring()
+#endif // NORM_FILE_IO_URING
+
+#else // !NORM_FILE_IO
+
+NormFileIoEngine::NormFileIoEngine()
+ : thread_count(0)
+{
+}
+
+NormFileIoEngine::~NormFileIoEngine()
+{
+}
+
+bool NormFileIoEngine::Init(unsigned int numWorkers, unsigned int pendingMax)
+{
+    if (0 == numWorkers) return true;
+    PLOG(PL_ERROR, "NormFileIoEngine::Init() error: asynchronous file I/O not supported\n");
+    return false;
+}  // end NormFileIoEngine::Init()
+
+void NormFileIoEngine::Destroy()
+{
+}
+
+bool NormFileIoEngine::Write(int fd, NormFile::Offset offset, const char* buffer, size_t len)
+{
+    return false;
+}
+
+NormFileIoEngine::Request* NormFileIoEngine::Read(int fd, NormFile::Offset offset, size_t len)
+{
+    return NULL;
+}
+
+long NormFileIoEngine::Wait(Request* request, const char*& buffer)
+{
+    buffer = NULL;
+    return -1;
+}
+
+void NormFileIoEngine::Release(Request* request)
+{
+}
+
+bool NormFileIoEngine::Flush(int fd)
+{
+    return true;
+}
+
+#endif // if/else NORM_FILE_IO
@@ -0,0 +1,605 @@
+#include "normGFKernel.h"
+
+// Determine which SIMD kernel families can be compiled for this target.
+// x86 kernels are built with per-function "target" attributes (GCC/Clang) so
+// no special compiler flags are required and selection is done at run time.
+#ifndef NORM_GF_KERNEL_PORTABLE
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define NORM_GF_X86 1
+#define NORM_GF_TARGET(x) __attribute__((target(x)))
+#include <immintrin.h>
+#elif (defined(_M_X64) || defined(_M_IX86)) && defined(_MSC_VER)
+#define NORM_GF_X86 1
+#define NORM_GF_TARGET(x)
+#include <intrin.h>
+#include <immintrin.h>
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#define NORM_GF_NEON 1
+#include <arm_neon.h>
+#endif
+// The GF(2^16) kernels assume little-endian 16-bit symbol layout
+#if !defined(__ARM_BIG_ENDIAN) && !(defined(__BYTE_ORDER__) && (__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__))
+#define NORM_GF_16 1
+#endif
+#endif // !NORM_GF_KERNEL_PORTABLE
+
+NormGFKernel::AddMul8 NormGFKernel::addmul8 = (NormGFKernel::AddMul8)0;
+NormGFKernel::AddMul16 NormGFKernel::addmul16 = (NormGFKernel::AddMul16)0;
+NormGFKernel::DotProd8 NormGFKernel::dotprod8 = (NormGFKernel::DotProd8)0;
+
+// Scalar completion of the vector remainder ("len" less than vector width)
+static inline void AddMul8Tail(UINT8* dst, const UINT8* src, const UINT8* mulRow, unsigned int len)
+{
+    for (unsigned int i = 0; i < len; i++)
+        dst[i] ^= mulRow[src[i]];
+}  // end AddMul8Tail()
+
+static inline void AddMul16Tail(UINT16* dst, const UINT16* src, const UINT16* tbl, unsigned int count)
+{
+    for (unsigned int i = 0; i < count; i++)
+    {
+        UINT16 x = src[i];
+        dst[i] ^= tbl[x & 0x0f] ^ tbl[16 + ((x >> 4) & 0x0f)] ^
+                  tbl[32 + ((x >> 8) & 0x0f)] ^ tbl[48 + (x >> 12)];
+    }
+}  // end AddMul16Tail()
+
+static inline void DotProd8Tail(UINT8* const* dstList, unsigned int numDst, 
+                                const UINT8* const* srcList, unsigned int numSrc,
+                                const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    for (unsigned int r = 0; r < numDst; r++)
+    {
+        UINT8* dst = dstList[r] + offset;
+        for (unsigned int j = 0; j < numSrc; j++)
+        {
+            const UINT8* src = srcList[j] + offset;
+            const UINT8* tbl = tableList[r*numSrc + j];
+            for (unsigned int i = 0; i < len; i++)
+                dst[i] ^= tbl[src[i] & 0x0f] ^ tbl[16 + (src[i] >> 4)];
+        }
+    }
+}  // end DotProd8Tail()
+
+// Splits the 64-entry GF(2^16) nibble table into eight 16-byte shuffle
+// tables: tbl8[32*i + n] is the low byte of c*(n << 4i) and tbl8[32*i + 16 + n]
+// is its high byte.
+static inline void SplitNibbleTable16(UINT8* tbl8, const UINT16* tbl)
+{
+    for (unsigned int i = 0; i < 4; i++)
+    {
+        for (unsigned int n = 0; n < 16; n++)
+        {
+            tbl8[32*i + n] = (UINT8)(tbl[16*i + n] & 0xff);
+            tbl8[32*i + 16 + n] = (UINT8)(tbl[16*i + n] >> 8);
+        }
+    }
+}  // end SplitNibbleTable16()
+
+#ifdef NORM_GF_X86
+
+NORM_GF_TARGET("ssse3")
+static void AddMul8SSSE3(UINT8* dst, const UINT8* src, const UINT8* mulRow, unsigned int len)
+{
+    // Build the low and high nibble product tables from the mulRow
+    UINT8 tbl[32];
+    for (unsigned int n = 0; n < 16; n++)
+    {
+        tbl[n] = mulRow[n];
+        tbl[16 + n] = mulRow[n << 4];
+    }
+    const __m128i tlo = _mm_loadu_si128((const __m128i*)tbl);
+    const __m128i thi = _mm_loadu_si128((const __m128i*)(tbl + 16));
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 16) <= len; i += 16)
+    {
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i l = _mm_and_si128(s, mask);
+        __m128i h = _mm_and_si128(_mm_srli_epi64(s, 4), mask);
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(tlo, l), _mm_shuffle_epi8(thi, h));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, p));
+    }
+    AddMul8Tail(dst + i, src + i, mulRow, len - i);
+}  // end AddMul8SSSE3()
+
+NORM_GF_TARGET("avx2")
+static void AddMul8AVX2(UINT8* dst, const UINT8* src, const UINT8* mulRow, unsigned int len)
+{
+    UINT8 tbl[32];
+    for (unsigned int n = 0; n < 16; n++)
+    {
+        tbl[n] = mulRow[n];
+        tbl[16 + n] = mulRow[n << 4];
+    }
+    const __m128i tlo128 = _mm_loadu_si128((const __m128i*)tbl);
+    const __m128i thi128 = _mm_loadu_si128((const __m128i*)(tbl + 16));
+    const __m256i tlo = _mm256_broadcastsi128_si256(tlo128);
+    const __m256i thi = _mm256_broadcastsi128_si256(thi128);
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 32) <= len; i += 32)
+    {
+        __m256i s = _mm256_loadu_si256((const __m256i*)(src + i));
+        __m256i d = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i l = _mm256_and_si256(s, mask);
+        __m256i h = _mm256_and_si256(_mm256_srli_epi64(s, 4), mask);
+        __m256i p = _mm256_xor_si256(_mm256_shuffle_epi8(tlo, l), _mm256_shuffle_epi8(thi, h));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d, p));
+    }
+    if ((i + 16) <= len)
+    {
+        const __m128i mask128 = _mm_set1_epi8(0x0f);
+        __m128i s = _mm_loadu_si128((const __m128i*)(src + i));
+        __m128i d = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i l = _mm_and_si128(s, mask128);
+        __m128i h = _mm_and_si128(_mm_srli_epi64(s, 4), mask128);
+        __m128i p = _mm_xor_si128(_mm_shuffle_epi8(tlo128, l), _mm_shuffle_epi8(thi128, h));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d, p));
+        i += 16;
+    }
+    AddMul8Tail(dst + i, src + i, mulRow, len - i);
+}  // end AddMul8AVX2()
+
+// The DotProd8 kernels are templated by the number of destination rows so
+// the per-row accumulator loops are fully unrolled
+template <unsigned int ROWS>
+NORM_GF_TARGET("ssse3")
+static void DotProd8SSSE3Rows(UINT8* const* dstList, const UINT8* const* srcList, unsigned int numSrc,
+                              const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 32) <= len; i += 32)
+    {
+        __m128i a[ROWS][2];
+        for (unsigned int r = 0; r < ROWS; r++)
+        {
+            a[r][0] = _mm_loadu_si128((const __m128i*)(dstList[r] + offset + i));
+            a[r][1] = _mm_loadu_si128((const __m128i*)(dstList[r] + offset + i + 16));
+        }
+        for (unsigned int j = 0; j < numSrc; j++)
+        {
+            const UINT8* src = srcList[j] + offset + i;
+            __m128i s0 = _mm_loadu_si128((const __m128i*)src);
+            __m128i s1 = _mm_loadu_si128((const __m128i*)(src + 16));
+            __m128i l0 = _mm_and_si128(s0, mask);
+            __m128i h0 = _mm_and_si128(_mm_srli_epi64(s0, 4), mask);
+            __m128i l1 = _mm_and_si128(s1, mask);
+            __m128i h1 = _mm_and_si128(_mm_srli_epi64(s1, 4), mask);
+            for (unsigned int r = 0; r < ROWS; r++)
+            {
+                const UINT8* tbl = tableList[r*numSrc + j];
+                const __m128i tlo = _mm_loadu_si128((const __m128i*)tbl);
+                const __m128i thi = _mm_loadu_si128((const __m128i*)(tbl + 16));
+                a[r][0] = _mm_xor_si128(a[r][0], _mm_xor_si128(_mm_shuffle_epi8(tlo, l0), _mm_shuffle_epi8(thi, h0)));
+                a[r][1] = _mm_xor_si128(a[r][1], _mm_xor_si128(_mm_shuffle_epi8(tlo, l1), _mm_shuffle_epi8(thi, h1)));
+            }
+        }
+        for (unsigned int r = 0; r < ROWS; r++)
+        {
+            _mm_storeu_si128((__m128i*)(dstList[r] + offset + i), a[r][0]);
+            _mm_storeu_si128((__m128i*)(dstList[r] + offset + i + 16), a[r][1]);
+        }
+    }
+    DotProd8Tail(dstList, ROWS, srcList, numSrc, tableList, offset + i, len - i);
+}  // end DotProd8SSSE3Rows()
+
+static void DotProd8SSSE3(UINT8* const* dstList, unsigned int numDst, 
+                          const UINT8* const* srcList, unsigned int numSrc,
+                          const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    switch (numDst)
+    {
+        case 1:
+            DotProd8SSSE3Rows<1>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        case 2:
+            DotProd8SSSE3Rows<2>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        case 3:
+            DotProd8SSSE3Rows<3>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        default:
+            DotProd8SSSE3Rows<4>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+    }
+}  // end DotProd8SSSE3()
+
+template <unsigned int ROWS>
+NORM_GF_TARGET("avx2")
+static void DotProd8AVX2Rows(UINT8* const* dstList, const UINT8* const* srcList, unsigned int numSrc,
+                             const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 64) <= len; i += 64)
+    {
+        __m256i a[ROWS][2];
+        for (unsigned int r = 0; r < ROWS; r++)
+        {
+            a[r][0] = _mm256_loadu_si256((const __m256i*)(dstList[r] + offset + i));
+            a[r][1] = _mm256_loadu_si256((const __m256i*)(dstList[r] + offset + i + 32));
+        }
+        for (unsigned int j = 0; j < numSrc; j++)
+        {
+            const UINT8* src = srcList[j] + offset + i;
+            __m256i s0 = _mm256_loadu_si256((const __m256i*)src);
+            __m256i s1 = _mm256_loadu_si256((const __m256i*)(src + 32));
+            __m256i l0 = _mm256_and_si256(s0, mask);
+            __m256i h0 = _mm256_and_si256(_mm256_srli_epi64(s0, 4), mask);
+            __m256i l1 = _mm256_and_si256(s1, mask);
+            __m256i h1 = _mm256_and_si256(_mm256_srli_epi64(s1, 4), mask);
+            for (unsigned int r = 0; r < ROWS; r++)
+            {
+                const UINT8* tbl = tableList[r*numSrc + j];
+                const __m256i tlo = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)tbl));
+                const __m256i thi = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tbl + 16)));
+                a[r][0] = _mm256_xor_si256(a[r][0], _mm256_xor_si256(_mm256_shuffle_epi8(tlo, l0), _mm256_shuffle_epi8(thi, h0)));
+                a[r][1] = _mm256_xor_si256(a[r][1], _mm256_xor_si256(_mm256_shuffle_epi8(tlo, l1), _mm256_shuffle_epi8(thi, h1)));
+            }
+        }
+        for (unsigned int r = 0; r < ROWS; r++)
+        {
+            _mm256_storeu_si256((__m256i*)(dstList[r] + offset + i), a[r][0]);
+            _mm256_storeu_si256((__m256i*)(dstList[r] + offset + i + 32), a[r][1]);
+        }
+    }
+    if (i < len)
+        DotProd8SSSE3Rows<ROWS>(dstList, srcList, numSrc, tableList, offset + i, len - i);
+}  // end DotProd8AVX2Rows()
+
+static void DotProd8AVX2(UINT8* const* dstList, unsigned int numDst, 
+                         const UINT8* const* srcList, unsigned int numSrc,
+                         const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    switch (numDst)
+    {
+        case 1:
+            DotProd8AVX2Rows<1>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        case 2:
+            DotProd8AVX2Rows<2>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        case 3:
+            DotProd8AVX2Rows<3>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        default:
+            DotProd8AVX2Rows<4>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+    }
+}  // end DotProd8AVX2()
+
+#ifdef NORM_GF_16
+NORM_GF_TARGET("ssse3")
+static void AddMul16SSSE3(UINT16* dst, const UINT16* src, const UINT16* nibbleTable, unsigned int count)
+{
+    UINT8 tbl8[128];
+    SplitNibbleTable16(tbl8, nibbleTable);
+    __m128i tlo[4], thi[4];
+    for (unsigned int k = 0; k < 4; k++)
+    {
+        tlo[k] = _mm_loadu_si128((const __m128i*)(tbl8 + 32*k));
+        thi[k] = _mm_loadu_si128((const __m128i*)(tbl8 + 32*k + 16));
+    }
+    const __m128i mask = _mm_set1_epi8(0x0f);
+    // Gathers the low bytes of 8 symbols into the low half and high bytes into the high half
+    const __m128i split = _mm_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    unsigned int i = 0;
+    for (; (i + 16) <= count; i += 16)
+    {
+        __m128i a = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i)), split);
+        __m128i b = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*)(src + i + 8)), split);
+        __m128i lo = _mm_unpacklo_epi64(a, b);  // low bytes of 16 symbols
+        __m128i hi = _mm_unpackhi_epi64(a, b);  // high bytes of 16 symbols
+        __m128i n0 = _mm_and_si128(lo, mask);
+        __m128i n1 = _mm_and_si128(_mm_srli_epi64(lo, 4), mask);
+        __m128i n2 = _mm_and_si128(hi, mask);
+        __m128i n3 = _mm_and_si128(_mm_srli_epi64(hi, 4), mask);
+        __m128i plo = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(tlo[0], n0), _mm_shuffle_epi8(tlo[1], n1)),
+                                    _mm_xor_si128(_mm_shuffle_epi8(tlo[2], n2), _mm_shuffle_epi8(tlo[3], n3)));
+        __m128i phi = _mm_xor_si128(_mm_xor_si128(_mm_shuffle_epi8(thi[0], n0), _mm_shuffle_epi8(thi[1], n1)),
+                                    _mm_xor_si128(_mm_shuffle_epi8(thi[2], n2), _mm_shuffle_epi8(thi[3], n3)));
+        __m128i d0 = _mm_loadu_si128((const __m128i*)(dst + i));
+        __m128i d1 = _mm_loadu_si128((const __m128i*)(dst + i + 8));
+        _mm_storeu_si128((__m128i*)(dst + i), _mm_xor_si128(d0, _mm_unpacklo_epi8(plo, phi)));
+        _mm_storeu_si128((__m128i*)(dst + i + 8), _mm_xor_si128(d1, _mm_unpackhi_epi8(plo, phi)));
+    }
+    AddMul16Tail(dst + i, src + i, nibbleTable, count - i);
+}  // end AddMul16SSSE3()
+
+NORM_GF_TARGET("avx2")
+static void AddMul16AVX2(UINT16* dst, const UINT16* src, const UINT16* nibbleTable, unsigned int count)
+{
+    UINT8 tbl8[128];
+    SplitNibbleTable16(tbl8, nibbleTable);
+    __m256i tlo[4], thi[4];
+    for (unsigned int k = 0; k < 4; k++)
+    {
+        tlo[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tbl8 + 32*k)));
+        thi[k] = _mm256_broadcastsi128_si256(_mm_loadu_si128((const __m128i*)(tbl8 + 32*k + 16)));
+    }
+    const __m256i mask = _mm256_set1_epi8(0x0f);
+    const __m256i split = _mm256_setr_epi8(0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15,
+                                           0, 2, 4, 6, 8, 10, 12, 14, 1, 3, 5, 7, 9, 11, 13, 15);
+    unsigned int i = 0;
+    for (; (i + 32) <= count; i += 32)
+    {
+        // The shuffles/unpacks operate per 128-bit lane so the final unpacklo/hi
+        // restore the symbol order of the first/second 32-byte loads respectively
+        __m256i a = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i)), split);
+        __m256i b = _mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i*)(src + i + 16)), split);
+        __m256i lo = _mm256_unpacklo_epi64(a, b);
+        __m256i hi = _mm256_unpackhi_epi64(a, b);
+        __m256i n0 = _mm256_and_si256(lo, mask);
+        __m256i n1 = _mm256_and_si256(_mm256_srli_epi64(lo, 4), mask);
+        __m256i n2 = _mm256_and_si256(hi, mask);
+        __m256i n3 = _mm256_and_si256(_mm256_srli_epi64(hi, 4), mask);
+        __m256i plo = _mm256_xor_si256(_mm256_xor_si256(_mm256_shuffle_epi8(tlo[0], n0), _mm256_shuffle_epi8(tlo[1], n1)),
+                                       _mm256_xor_si256(_mm256_shuffle_epi8(tlo[2], n2), _mm256_shuffle_epi8(tlo[3], n3)));
+        __m256i phi = _mm256_xor_si256(_mm256_xor_si256(_mm256_shuffle_epi8(thi[0], n0), _mm256_shuffle_epi8(thi[1], n1)),
+                                       _mm256_xor_si256(_mm256_shuffle_epi8(thi[2], n2), _mm256_shuffle_epi8(thi[3], n3)));
+        __m256i d0 = _mm256_loadu_si256((const __m256i*)(dst + i));
+        __m256i d1 = _mm256_loadu_si256((const __m256i*)(dst + i + 16));
+        _mm256_storeu_si256((__m256i*)(dst + i), _mm256_xor_si256(d0, _mm256_unpacklo_epi8(plo, phi)));
+        _mm256_storeu_si256((__m256i*)(dst + i + 16), _mm256_xor_si256(d1, _mm256_unpackhi_epi8(plo, phi)));
+    }
+    if (i < count)
+        AddMul16SSSE3(dst + i, src + i, nibbleTable, count - i);
+}  // end AddMul16AVX2()
+#endif // NORM_GF_16
+
+static bool CpuHasSSSE3()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 1);
+    return (0 != (info[2] & (1 << 9)));
+#else
+    __builtin_cpu_init();
+    return (0 != __builtin_cpu_supports("ssse3"));
+#endif // if/else _MSC_VER
+}  // end CpuHasSSSE3()
+
+static bool CpuHasAVX2()
+{
+#ifdef _MSC_VER
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    // Need OSXSAVE and AVX plus OS-enabled XMM/YMM state
+    if ((info[2] & ((1 << 27) | (1 << 28))) != ((1 << 27) | (1 << 28))) return false;
+    if ((_xgetbv(0) & 0x06) != 0x06) return false;
+    __cpuidex(info, 7, 0);
+    return (0 != (info[1] & (1 << 5)));
+#else
+    __builtin_cpu_init();
+    return (0 != __builtin_cpu_supports("avx2"));
+#endif // if/else _MSC_VER
+}  // end CpuHasAVX2()
+
+#endif // NORM_GF_X86
+
+#ifdef NORM_GF_NEON
+
+static void AddMul8NEON(UINT8* dst, const UINT8* src, const UINT8* mulRow, unsigned int len)
+{
+    UINT8 tbl[32];
+    for (unsigned int n = 0; n < 16; n++)
+    {
+        tbl[n] = mulRow[n];
+        tbl[16 + n] = mulRow[n << 4];
+    }
+    const uint8x16_t tlo = vld1q_u8(tbl);
+    const uint8x16_t thi = vld1q_u8(tbl + 16);
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 16) <= len; i += 16)
+    {
+        uint8x16_t s = vld1q_u8(src + i);
+        uint8x16_t d = vld1q_u8(dst + i);
+        uint8x16_t p = veorq_u8(vqtbl1q_u8(tlo, vandq_u8(s, mask)),
+                                vqtbl1q_u8(thi, vshrq_n_u8(s, 4)));
+        vst1q_u8(dst + i, veorq_u8(d, p));
+    }
+    AddMul8Tail(dst + i, src + i, mulRow, len - i);
+}  // end AddMul8NEON()
+
+template <unsigned int ROWS>
+static void DotProd8NEONRows(UINT8* const* dstList, const UINT8* const* srcList, unsigned int numSrc,
+                             const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 32) <= len; i += 32)
+    {
+        uint8x16_t a[ROWS][2];
+        for (unsigned int r = 0; r < ROWS; r++)
+        {
+            a[r][0] = vld1q_u8(dstList[r] + offset + i);
+            a[r][1] = vld1q_u8(dstList[r] + offset + i + 16);
+        }
+        for (unsigned int j = 0; j < numSrc; j++)
+        {
+            const UINT8* src = srcList[j] + offset + i;
+            uint8x16_t s0 = vld1q_u8(src);
+            uint8x16_t s1 = vld1q_u8(src + 16);
+            uint8x16_t l0 = vandq_u8(s0, mask);
+            uint8x16_t h0 = vshrq_n_u8(s0, 4);
+            uint8x16_t l1 = vandq_u8(s1, mask);
+            uint8x16_t h1 = vshrq_n_u8(s1, 4);
+            for (unsigned int r = 0; r < ROWS; r++)
+            {
+                const UINT8* tbl = tableList[r*numSrc + j];
+                const uint8x16_t tlo = vld1q_u8(tbl);
+                const uint8x16_t thi = vld1q_u8(tbl + 16);
+                a[r][0] = veorq_u8(a[r][0], veorq_u8(vqtbl1q_u8(tlo, l0), vqtbl1q_u8(thi, h0)));
+                a[r][1] = veorq_u8(a[r][1], veorq_u8(vqtbl1q_u8(tlo, l1), vqtbl1q_u8(thi, h1)));
+            }
+        }
+        for (unsigned int r = 0; r < ROWS; r++)
+        {
+            vst1q_u8(dstList[r] + offset + i, a[r][0]);
+            vst1q_u8(dstList[r] + offset + i + 16, a[r][1]);
+        }
+    }
+    DotProd8Tail(dstList, ROWS, srcList, numSrc, tableList, offset + i, len - i);
+}  // end DotProd8NEONRows()
+
+static void DotProd8NEON(UINT8* const* dstList, unsigned int numDst, 
+                         const UINT8* const* srcList, unsigned int numSrc,
+                         const UINT8* const* tableList, unsigned int offset, unsigned int len)
+{
+    switch (numDst)
+    {
+        case 1:
+            DotProd8NEONRows<1>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        case 2:
+            DotProd8NEONRows<2>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        case 3:
+            DotProd8NEONRows<3>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+        default:
+            DotProd8NEONRows<4>(dstList, srcList, numSrc, tableList, offset, len);
+            break;
+    }
+}  // end DotProd8NEON()
+
+#ifdef NORM_GF_16
+static void AddMul16NEON(UINT16* dst, const UINT16* src, const UINT16* nibbleTable, unsigned int count)
+{
+    UINT8 tbl8[128];
+    SplitNibbleTable16(tbl8, nibbleTable);
+    uint8x16_t tlo[4], thi[4];
+    for (unsigned int k = 0; k < 4; k++)
+    {
+        tlo[k] = vld1q_u8(tbl8 + 32*k);
+        thi[k] = vld1q_u8(tbl8 + 32*k + 16);
+    }
+    const uint8x16_t mask = vdupq_n_u8(0x0f);
+    unsigned int i = 0;
+    for (; (i + 16) <= count; i += 16)
+    {
+        // vld2q de-interleaves into low (val[0]) and high (val[1]) symbol bytes
+        uint8x16x2_t s = vld2q_u8((const UINT8*)(src + i));
+        uint8x16x2_t d = vld2q_u8((const UINT8*)(dst + i));
+        uint8x16_t n0 = vandq_u8(s.val[0], mask);
+        uint8x16_t n1 = vshrq_n_u8(s.val[0], 4);
+        uint8x16_t n2 = vandq_u8(s.val[1], mask);
+        uint8x16_t n3 = vshrq_n_u8(s.val[1], 4);
+        d.val[0] = veorq_u8(d.val[0], veorq_u8(veorq_u8(vqtbl1q_u8(tlo[0], n0), vqtbl1q_u8(tlo[1], n1)),
+                                               veorq_u8(vqtbl1q_u8(tlo[2], n2), vqtbl1q_u8(tlo[3], n3))));
+        d.val[1] = veorq_u8(d.val[1], veorq_u8(veorq_u8(vqtbl1q_u8(thi[0], n0), vqtbl1q_u8(thi[1], n1)),
+                                               veorq_u8(vqtbl1q_u8(thi[2], n2), vqtbl1q_u8(thi[3], n3))));
+        vst2q_u8((UINT8*)(dst + i), d);
+    }
+    AddMul16Tail(dst + i, src + i, nibbleTable, count - i);
+}  // end AddMul16NEON()
+#endif // NORM_GF_16
+
+#endif // NORM_GF_NEON
+
+bool NormGFKernel::IsSupported(Type theType)
+{
+    switch (theType)
+    {
+        case PORTABLE:
+            return true;
+#ifdef NORM_GF_X86
+        case SSSE3:
+            return CpuHasSSSE3();
+        case AVX2:
+            return CpuHasAVX2();
+#endif // NORM_GF_X86
+#ifdef NORM_GF_NEON
+        case NEON:
+            return true;
+#endif // NORM_GF_NEON
+        default:
+            return false;
+    }
+}  // end NormGFKernel::IsSupported()
+
+bool NormGFKernel::SetType(Type theType)
+{
+    if (!IsSupported(theType)) return false;
+    switch (theType)
+    {
+#ifdef NORM_GF_X86
+        case SSSE3:
+            addmul8 = AddMul8SSSE3;
+            dotprod8 = DotProd8SSSE3;
+#ifdef NORM_GF_16
+            addmul16 = AddMul16SSSE3;
+#endif // NORM_GF_16
+            break;
+        case AVX2:
+            addmul8 = AddMul8AVX2;
+            dotprod8 = DotProd8AVX2;
+#ifdef NORM_GF_16
+            addmul16 = AddMul16AVX2;
+#endif // NORM_GF_16
+            break;
+#endif // NORM_GF_X86
+#ifdef NORM_GF_NEON
+        case NEON:
+            addmul8 = AddMul8NEON;
+            dotprod8 = DotProd8NEON;
+#ifdef NORM_GF_16
+            addmul16 = AddMul16NEON;
+#endif // NORM_GF_16
+            break;
+#endif // NORM_GF_NEON
+        default:
+            addmul8 = (AddMul8)0;
+            addmul16 = (AddMul16)0;
+            dotprod8 = (DotProd8)0;
+            break;
+    }
+    type = theType;
+    return true;
+}  // end NormGFKernel::SetType()
+
+NormGFKernel::Type NormGFKernel::Init()
+{
+    // Pick the "widest" supported kernel
+    Type theType = PORTABLE;
+    if (IsSupported(AVX2))
+        theType = AVX2;
+    else if (IsSupported(SSSE3))
+        theType = SSSE3;
+    else if (IsSupported(NEON))
+        theType = NEON;
+    SetType(theType);
+    return theType;
+}  // end NormGFKernel::Init()
+
+// The selection is made once at load time (before any codec or worker thread
+// can run) rather than lazily upon first use, so there's no data race.  The
+// kernel pointers above are constant (zero) initialized first, so a codec used
+// from another module's static initializer just gets the portable code.
+NormGFKernel::Type NormGFKernel::type = NormGFKernel::Init();
+
+NormGFKernel::Type NormGFKernel::GetType()
+{
+    return type;
+}  // end NormGFKernel::GetType()
+
+const char* NormGFKernel::GetTypeName(Type theType)
+{
+    switch (theType)
+    {
+        case SSSE3:
+            return "SSSE3";
+        case AVX2:
+            return "AVX2";
+        case NEON:
+            return "NEON";
+        default:
+            return "PORTABLE";
+    }
+}  // end NormGFKernel::GetTypeName()
@@ -0,0 +1,94 @@
+#include "normHistogram.h"
+#include "protoDebug.h"
+
+NormHistogram::NormHistogram()
+ : bucket(NULL), count(0), value_min(0), value_max(0), value_sum(0.0)
+{
+}
+
+NormHistogram::~NormHistogram()
+{
+    Destroy();
+}
+
+void NormHistogram::Destroy()
+{
+    if (NULL != bucket)
+    {
+        delete[] bucket;
+        bucket = NULL;
+    }
+    count = value_min = value_max = 0;
+    value_sum = 0.0;
+}  // end NormHistogram::Destroy()
+
+void NormHistogram::Reset()
+{
+    if (NULL != bucket) memset(bucket, 0, BUCKET_COUNT * sizeof(UINT32));
+    count = value_min = value_max = 0;
+    value_sum = 0.0;
+}  // end NormHistogram::Reset()
+
+unsigned int NormHistogram::GetBucketIndex(UINT32 value)
+{
+    if (value < SUB_COUNT) return value;
+    unsigned int msb = 31;
+    while (0 == (value & ((UINT32)1 << msb))) msb--;
+    return (((msb - SUB_BITS + 1) << SUB_BITS) + ((value >> (msb - SUB_BITS)) & SUB_MASK));
+}  // end NormHistogram::GetBucketIndex()
+
+// Returns the middle value (usec) of the bucket
+double NormHistogram::GetBucketValue(unsigned int index)
+{
+    if (index < SUB_COUNT) return (double)index;
+    unsigned int shift = (index >> SUB_BITS) - 1;
+    double lo = (double)((UINT32)(SUB_COUNT + (index & SUB_MASK)) << shift);
+    return (lo + 0.5 * (double)((UINT32)1 << shift));
+}  // end NormHistogram::GetBucketValue()
+
+void NormHistogram::Record(double seconds)
+{
+    if (NULL == bucket)
+    {
+        if (NULL == (bucket = new UINT32[BUCKET_COUNT]))
+        {
+            PLOG(PL_ERROR, "NormHistogram::Record() new bucket array error: %s\n", GetErrorString());
+            return;
+        }
+        Reset();
+    }
+    double usec = 1.0e+06 * seconds;
+    UINT32 value;
+    if (usec <= 0.0)
+        value = 0;
+    else if (usec >= 4294967295.0)
+        value = 0xffffffff;
+    else
+        value = (UINT32)(usec + 0.5);
+    bucket[GetBucketIndex(value)]++;
+    if ((0 == count) || (value < value_min)) value_min = value;
+    if (value > value_max) value_max = value;
+    value_sum += (double)value;
+    count++;
+}  // end NormHistogram::Record()
+
+double NormHistogram::GetPercentile(double percent) const
+{
+    if (0 == count) return 0.0;
+    double target = 0.01 * percent * (double)count;
+    if (target < 1.0) target = 1.0;
+    UINT32 total = 0;
+    for (unsigned int i = 0; i < BUCKET_COUNT; i++)
+    {
+        total += bucket[i];
+        if ((double)total >= target)
+        {
+            // (clamped to the exact extremes recorded)
+            double value = GetBucketValue(i);
+            if (value < (double)value_min) value = (double)value_min;
+            if (value > (double)value_max) value = (double)value_max;
+            return (1.0e-06 * value);
+        }
+    }
+    return GetMax();
+}  // end NormHistogram::GetPercentile()
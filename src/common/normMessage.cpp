@@ -8,14 +8,45 @@ NormHeaderExtension::NormHeaderExtension()
 }
 
 NormMsg::NormMsg() 
- : length(8), header_length(8), header_length_base(8)
+ : buffer(inline_buffer), buffer_size(INLINE_SIZE), 
+   length(8), header_length(8), header_length_base(8), payload_ref(NULL)
 {
+    ClearExtensionIndex();
     SetType(INVALID);
     SetVersion(NORM_PROTOCOL_VERSION);
 }
 
+NormMsg::~NormMsg()
+{
+    if (buffer != inline_buffer) delete[] buffer;
+}
+
+// Grows (never shrinks) the message buffer, keeping its content
+bool NormMsg::SetBufferSize(unsigned int bufferSize)
+{
+    if (bufferSize <= buffer_size) return true;
+    if (bufferSize > MAX_SIZE)
+    {
+        PLOG(PL_ERROR, "NormMsg::SetBufferSize() error: size %u exceeds MAX_SIZE\n", bufferSize);
+        return false;
+    }
+    UINT32* newBuffer = new UINT32[(bufferSize + 3) / sizeof(UINT32)];
+    if (NULL == newBuffer)
+    {
+        PLOG(PL_ERROR, "NormMsg::SetBufferSize() new buffer error: %s\n", GetErrorString());
+        return false;
+    }
+    // (a NORM_DATA "payload_ref" payload isn't in the buffer)
+    memcpy(newBuffer, buffer, (length < buffer_size) ? length : buffer_size);
+    if (buffer != inline_buffer) delete[] buffer;
+    buffer = newBuffer;
+    buffer_size = (bufferSize + 3) & ~3;
+    return true;
+}  // end NormMsg::SetBufferSize()
+
 bool NormMsg::InitFromBuffer(UINT16 msgLength)
 {
+    payload_ref = NULL;
     header_length = GetHeaderLength();
     // "header_length_base" is type dependent
     switch (GetType())
@@ -87,10 +118,35 @@ bool NormMsg::InitFromBuffer(UINT16 msgLength)
     else
     {
         length = msgLength;
-        return true;
+        return ParseExtensions();
     }
 }  // end NormMsg::InitFromBuffer()
 
+// One pass over the extensions here means handlers can look them up with
+// FindExtension() instead of each walking (and trusting) the list
+bool NormMsg::ParseExtensions()
+{
+    ClearExtensionIndex();
+    if (!HasExtensions()) return true;
+    UINT16 offset = header_length_base/4;
+    UINT16 end = header_length/4;
+    while (offset < end)
+    {
+        const UINT8* ext = (const UINT8*)(buffer + offset);
+        NormHeaderExtension::Type extType = (NormHeaderExtension::Type)ext[0];
+        // (types 128 and up are a single word)
+        UINT16 words = (extType < 128) ? ext[1] : 1;
+        if ((0 == words) || (words > (end - offset)))
+        {
+            PLOG(PL_ERROR, "NormMsg::InitFromBuffer() invalid header extension length\n");
+            return false;
+        }
+        IndexExtension(extType, offset);
+        offset += words;
+    }
+    return true;
+}  // end NormMsg::ParseExtensions()
+
 void NormMsg::Display() const
 {
     const unsigned char* ptr = (const unsigned char*)buffer;
@@ -98,17 +154,16 @@ void NormMsg::Display() const
         PLOG(PL_ALWAYS, "%02x", *ptr++);
 }  // end NormMsg::Display()
 
-bool NormMsg::HasExtension(NormHeaderExtension::Type extType)
+bool NormMsg::SearchExtension(NormHeaderExtension::Type extType, NormHeaderExtension& ext) const
 {
-    
-    NormHeaderExtension ext;
+    ext.AttachBuffer((UINT32*)NULL, 0);
     while (GetNextExtension(ext))
     {
         if (ext.GetType() == extType)
             return true;
     }
     return false;
-}  // end NormMsg::HasExtension()
+}  // end NormMsg::SearchExtension()
 
 bool NormCmdCCMsg::GetCCNode(NormNodeId     nodeId, 
                              UINT8&         flags, 
@@ -258,6 +313,24 @@ bool NormRepairRequest::AppendErasureCount(UINT8                fecId,
     }
 }  // end NormRepairRequest::AppendErasureCount()
 
+bool NormRepairRequest::AppendRepairContent(const NormRepairRequest& request,
+                                            UINT16                   offset,
+                                            UINT16                   numBytes)
+{
+    if ((offset + numBytes) > request.length) return false;
+    if (buffer_len >= (ITEM_LIST_OFFSET+length+numBytes))
+    {
+        memcpy((char*)buffer + ITEM_LIST_OFFSET + length,
+               (const char*)request.buffer + ITEM_LIST_OFFSET + offset, numBytes);
+        length += numBytes;
+        return true;
+    }
+    else
+    {
+        return false;
+    }
+}  // end NormRepairRequest::AppendRepairContent()
+
 
 UINT16 NormRepairRequest::Pack()
 {
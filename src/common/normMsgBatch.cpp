@@ -0,0 +1,442 @@
+#include "normMsgBatch.h"
+
+#if defined(NORM_RECV_BATCH) || defined(NORM_SEND_BATCH)
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>  // for UDP_SEGMENT (if available)
+#include <errno.h>
+#include <string.h>  // for memcpy()
+#include <time.h>    // for struct timespec
+#endif // NORM_RECV_BATCH || NORM_SEND_BATCH
+
+#ifdef NORM_RECV_BATCH
+// Ancillary data space per datagram (room for either pktinfo struct, a traffic
+// class, a timestamp and an SO_RXQ_OVFL drop count)
+static const unsigned int NORM_BATCH_CONTROL_SIZE = CMSG_SPACE(sizeof(struct in6_pktinfo)) +
+                                                    CMSG_SPACE(sizeof(int)) +
+                                                    CMSG_SPACE(sizeof(struct timespec)) +
+                                                    CMSG_SPACE(sizeof(UINT32));
+#endif // NORM_RECV_BATCH
+
+#ifdef NORM_SEND_BATCH
+// Ancillary data space per datagram for an SCM_TXTIME departure time
+static const unsigned int NORM_BATCH_TXTIME_SIZE = CMSG_SPACE(sizeof(UINT64));
+#endif // NORM_SEND_BATCH
+
+NormRecvBatch::NormRecvBatch()
+ : batch_size(0), msg_list(NULL), msg_length(NULL), dst_addr(NULL), rx_time(NULL),
+   traffic_class(NULL), drop_count(0), drop_count_valid(false)
+#ifdef NORM_RECV_BATCH
+   , hdr_list(NULL), iov_list(NULL), name_buffer(NULL), control_buffer(NULL)
+#endif // NORM_RECV_BATCH
+{
+}
+
+NormRecvBatch::~NormRecvBatch()
+{
+    Destroy();
+}
+
+bool NormRecvBatch::IsSupported()
+{
+#ifdef NORM_RECV_BATCH
+    return true;
+#else
+    return false;
+#endif // if/else NORM_RECV_BATCH
+}  // end NormRecvBatch::IsSupported()
+
+bool NormRecvBatch::Init(unsigned int batchSize)
+{
+    Destroy();
+    if (batchSize < 2) return true;  // batching disabled
+#ifdef NORM_RECV_BATCH
+    if ((NULL == (msg_list = new NormMsg[batchSize])) ||
+        (NULL == (msg_length = new unsigned int[batchSize])) ||
+        (NULL == (dst_addr = new ProtoAddress[batchSize])) ||
+        (NULL == (rx_time = new struct timeval[batchSize])) ||
+        (NULL == (traffic_class = new UINT8[batchSize])) ||
+        (NULL == (hdr_list = new struct mmsghdr[batchSize])) ||
+        (NULL == (iov_list = new struct iovec[batchSize])) ||
+        (NULL == (name_buffer = new char[batchSize*sizeof(struct sockaddr_storage)])) ||
+        (NULL == (control_buffer = new char[batchSize*NORM_BATCH_CONTROL_SIZE])))
+    {
+        PLOG(PL_FATAL, "NormRecvBatch::Init() error: allocation failure: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
+    for (unsigned int i = 0; i < batchSize; i++)
+    {
+        if (!msg_list[i].SetBufferSize(NormMsg::MAX_SIZE))
+        {
+            PLOG(PL_FATAL, "NormRecvBatch::Init() error: buffer allocation failure\n");
+            Destroy();
+            return false;
+        }
+    }
+    batch_size = batchSize;
+    return true;
+#else
+    PLOG(PL_ERROR, "NormRecvBatch::Init() error: batched receive not supported on this system\n");
+    return false;
+#endif // if/else NORM_RECV_BATCH
+}  // end NormRecvBatch::Init()
+
+void NormRecvBatch::Destroy()
+{
+#ifdef NORM_RECV_BATCH
+    if (NULL != control_buffer)
+    {
+        delete[] control_buffer;
+        control_buffer = NULL;
+    }
+    if (NULL != name_buffer)
+    {
+        delete[] name_buffer;
+        name_buffer = NULL;
+    }
+    if (NULL != iov_list)
+    {
+        delete[] iov_list;
+        iov_list = NULL;
+    }
+    if (NULL != hdr_list)
+    {
+        delete[] hdr_list;
+        hdr_list = NULL;
+    }
+#endif // NORM_RECV_BATCH
+    if (NULL != traffic_class)
+    {
+        delete[] traffic_class;
+        traffic_class = NULL;
+    }
+    if (NULL != rx_time)
+    {
+        delete[] rx_time;
+        rx_time = NULL;
+    }
+    if (NULL != dst_addr)
+    {
+        delete[] dst_addr;
+        dst_addr = NULL;
+    }
+    if (NULL != msg_length)
+    {
+        delete[] msg_length;
+        msg_length = NULL;
+    }
+    if (NULL != msg_list)
+    {
+        delete[] msg_list;
+        msg_list = NULL;
+    }
+    batch_size = 0;
+}  // end NormRecvBatch::Destroy()
+
+int NormRecvBatch::Recv(ProtoSocket& theSocket)
+{
+#ifdef NORM_RECV_BATCH
+    // (the headers are re-armed each call since recvmmsg() overwrites lengths)
+    for (unsigned int i = 0; i < batch_size; i++)
+    {
+        iov_list[i].iov_base = msg_list[i].AccessBuffer();
+        iov_list[i].iov_len = msg_list[i].GetBufferSize();
+        struct msghdr& hdr = hdr_list[i].msg_hdr;
+        hdr.msg_name = name_buffer + i*sizeof(struct sockaddr_storage);
+        hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        hdr.msg_iov = iov_list + i;
+        hdr.msg_iovlen = 1;
+        hdr.msg_control = control_buffer + i*NORM_BATCH_CONTROL_SIZE;
+        hdr.msg_controllen = NORM_BATCH_CONTROL_SIZE;
+        hdr.msg_flags = 0;
+        hdr_list[i].msg_len = 0;
+    }
+    int result = recvmmsg(theSocket.GetHandle(), hdr_list, batch_size, MSG_DONTWAIT, NULL);
+    if (result < 0)
+    {
+        switch (errno)
+        {
+            case EINTR:
+            case EAGAIN:
+#if (EAGAIN != EWOULDBLOCK)
+            case EWOULDBLOCK:
+#endif // EAGAIN != EWOULDBLOCK
+                return 0;
+            default:
+                PLOG(PL_DEBUG, "NormRecvBatch::Recv() recvmmsg() error: %s\n", GetErrorString());
+                return -1;
+        }
+    }
+    for (int i = 0; i < result; i++)
+    {
+        struct msghdr& hdr = hdr_list[i].msg_hdr;
+        msg_length[i] = (0 != (hdr.msg_flags & MSG_TRUNC)) ? 0 : hdr_list[i].msg_len;
+        msg_list[i].AccessAddress().SetSockAddr(*((struct sockaddr*)hdr.msg_name));
+        ProtoAddress& dstAddr = dst_addr[i];
+        dstAddr.Invalidate();
+        rx_time[i].tv_sec = rx_time[i].tv_usec = 0;
+        traffic_class[i] = 0;
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); NULL != cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+        {
+            if ((IPPROTO_IP == cmsg->cmsg_level) && (IP_PKTINFO == cmsg->cmsg_type))
+            {
+                struct in_pktinfo* info = (struct in_pktinfo*)CMSG_DATA(cmsg);
+                dstAddr.SetRawHostAddress(ProtoAddress::IPv4, (char*)&info->ipi_addr, 4);
+            }
+            else if ((IPPROTO_IP == cmsg->cmsg_level) && (IP_TOS == cmsg->cmsg_type))
+            {
+                traffic_class[i] = *((UINT8*)CMSG_DATA(cmsg));  // (a single byte)
+            }
+#ifdef SCM_TIMESTAMPNS
+            else if ((SOL_SOCKET == cmsg->cmsg_level) && (SCM_TIMESTAMPNS == cmsg->cmsg_type))
+            {
+                struct timespec ts;
+                memcpy(&ts, CMSG_DATA(cmsg), sizeof(ts));
+                rx_time[i].tv_sec = ts.tv_sec;
+                rx_time[i].tv_usec = ts.tv_nsec / 1000;
+            }
+#endif // SCM_TIMESTAMPNS
+#ifdef SO_RXQ_OVFL
+            else if ((SOL_SOCKET == cmsg->cmsg_level) && (SO_RXQ_OVFL == cmsg->cmsg_type))
+            {
+                memcpy(&drop_count, CMSG_DATA(cmsg), sizeof(UINT32));
+                drop_count_valid = true;
+            }
+#endif // SO_RXQ_OVFL
+#ifdef HAVE_IPV6
+            else if ((IPPROTO_IPV6 == cmsg->cmsg_level) && (IPV6_PKTINFO == cmsg->cmsg_type))
+            {
+                struct in6_pktinfo* info = (struct in6_pktinfo*)CMSG_DATA(cmsg);
+                dstAddr.SetRawHostAddress(ProtoAddress::IPv6, (char*)&info->ipi6_addr, 16);
+            }
+            else if ((IPPROTO_IPV6 == cmsg->cmsg_level) && (IPV6_TCLASS == cmsg->cmsg_type))
+            {
+                int tclass;
+                memcpy(&tclass, CMSG_DATA(cmsg), sizeof(int));
+                traffic_class[i] = (UINT8)tclass;
+            }
+#endif // HAVE_IPV6
+        }
+    }
+    return result;
+#else
+    return -1;
+#endif // if/else NORM_RECV_BATCH
+}  // end NormRecvBatch::Recv()
+
+NormSendBatch::NormSendBatch()
+ : batch_size(0), msg_count(0), msg_index(0), msg_buffer(NULL)
+#ifdef NORM_SEND_BATCH
+   , hdr_list(NULL), iov_list(NULL), name_buffer(NULL), control_buffer(NULL),
+   gso_enable(true), tx_time_queued(false)
+#endif // NORM_SEND_BATCH
+{
+}
+
+NormSendBatch::~NormSendBatch()
+{
+    Destroy();
+}
+
+bool NormSendBatch::IsSupported()
+{
+#ifdef NORM_SEND_BATCH
+    return true;
+#else
+    return false;
+#endif // if/else NORM_SEND_BATCH
+}  // end NormSendBatch::IsSupported()
+
+bool NormSendBatch::Init(unsigned int batchSize)
+{
+    Destroy();
+    if (batchSize < 2) return true;  // batching disabled
+#ifdef NORM_SEND_BATCH
+    if ((NULL == (msg_buffer = new char[(unsigned long)batchSize*NormMsg::MAX_SIZE])) ||
+        (NULL == (hdr_list = new struct mmsghdr[batchSize])) ||
+        (NULL == (iov_list = new struct iovec[batchSize])) ||
+        (NULL == (name_buffer = new char[batchSize*sizeof(struct sockaddr_storage)])) ||
+        (NULL == (control_buffer = new char[batchSize*NORM_BATCH_TXTIME_SIZE])))
+    {
+        PLOG(PL_FATAL, "NormSendBatch::Init() error: allocation failure: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
+    memset(control_buffer, 0, batchSize*NORM_BATCH_TXTIME_SIZE);
+    batch_size = batchSize;
+    msg_count = msg_index = 0;
+    gso_enable = true;
+    tx_time_queued = false;
+    return true;
+#else
+    PLOG(PL_ERROR, "NormSendBatch::Init() error: batched send not supported on this system\n");
+    return false;
+#endif // if/else NORM_SEND_BATCH
+}  // end NormSendBatch::Init()
+
+void NormSendBatch::Destroy()
+{
+#ifdef NORM_SEND_BATCH
+    if (NULL != control_buffer)
+    {
+        delete[] control_buffer;
+        control_buffer = NULL;
+    }
+    if (NULL != name_buffer)
+    {
+        delete[] name_buffer;
+        name_buffer = NULL;
+    }
+    tx_time_queued = false;
+    if (NULL != iov_list)
+    {
+        delete[] iov_list;
+        iov_list = NULL;
+    }
+    if (NULL != hdr_list)
+    {
+        delete[] hdr_list;
+        hdr_list = NULL;
+    }
+#endif // NORM_SEND_BATCH
+    if (NULL != msg_buffer)
+    {
+        delete[] msg_buffer;
+        msg_buffer = NULL;
+    }
+    batch_size = msg_count = msg_index = 0;
+}  // end NormSendBatch::Destroy()
+
+bool NormSendBatch::Queue(const char* buffer, unsigned int numBytes, const ProtoAddress& dstAddr,
+                          UINT64 txTime)
+{
+#ifdef NORM_SEND_BATCH
+    if (IsFull() || (numBytes > NormMsg::MAX_SIZE)) return false;
+    char* slot = msg_buffer + ((unsigned long)msg_count * NormMsg::MAX_SIZE);
+    memcpy(slot, buffer, numBytes);
+    iov_list[msg_count].iov_base = slot;
+    iov_list[msg_count].iov_len = numBytes;
+    struct msghdr& hdr = hdr_list[msg_count].msg_hdr;
+    char* name = name_buffer + msg_count*sizeof(struct sockaddr_storage);
+    socklen_t nameLen = (ProtoAddress::IPv6 == dstAddr.GetType()) ? 
+                            sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    memcpy(name, &dstAddr.GetSockAddr(), nameLen);
+    hdr.msg_name = name;
+    hdr.msg_namelen = nameLen;
+    hdr.msg_iov = iov_list + msg_count;
+    hdr.msg_iovlen = 1;
+    hdr.msg_control = NULL;
+    hdr.msg_controllen = 0;
+#ifdef SCM_TXTIME
+    if (0 != txTime)
+    {
+        hdr.msg_control = control_buffer + msg_count*NORM_BATCH_TXTIME_SIZE;
+        hdr.msg_controllen = NORM_BATCH_TXTIME_SIZE;
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_TXTIME;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(UINT64));
+        memcpy(CMSG_DATA(cmsg), &txTime, sizeof(UINT64));
+        tx_time_queued = true;
+    }
+#endif // SCM_TXTIME
+    hdr.msg_flags = 0;
+    hdr_list[msg_count].msg_len = 0;
+    msg_count++;
+    return true;
+#else
+    return false;
+#endif // if/else NORM_SEND_BATCH
+}  // end NormSendBatch::Queue()
+
+NormSendBatch::FlushStatus NormSendBatch::Flush(ProtoSocket& theSocket)
+{
+#ifdef NORM_SEND_BATCH
+    int fd = theSocket.GetHandle();
+    FlushStatus status = FLUSH_OK;
+    if (GsoFlush(fd, status)) return status;
+    while (msg_index < msg_count)
+    {
+        int result = sendmmsg(fd, hdr_list + msg_index, msg_count - msg_index, MSG_DONTWAIT);
+        if (result < 0)
+        {
+            if (EINTR == errno) continue;
+            if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (ENOBUFS == errno))
+                return FLUSH_BLOCKED;
+            PLOG(PL_WARN, "NormSendBatch::Flush() sendmmsg() error: %s\n", GetErrorString());
+            status = FLUSH_FAILED;
+            break;
+        }
+        msg_index += result;
+    }
+    msg_count = msg_index = 0;
+    tx_time_queued = false;
+    return status;
+#else
+    return FLUSH_FAILED;
+#endif // if/else NORM_SEND_BATCH
+}  // end NormSendBatch::Flush()
+
+#ifdef NORM_SEND_BATCH
+// Sends the queued datagrams as one UDP_SEGMENT "super" datagram if they
+// have a common destination and size (the last may be shorter).  Returns
+// false if the batch isn't eligible (or GSO is not available).
+bool NormSendBatch::GsoFlush(int fd, FlushStatus& status)
+{
+#ifdef UDP_SEGMENT
+    // (the kernel limits a GSO send to 64 segments and 64 kB)
+    unsigned int count = msg_count - msg_index;
+    // (a "super" datagram would depart all at once, defeating SCM_TXTIME pacing)
+    if (!gso_enable || tx_time_queued || (count < 2) || (count > 64)) return false;
+    const struct msghdr& first = hdr_list[msg_index].msg_hdr;
+    size_t segSize = iov_list[msg_index].iov_len;
+    size_t total = 0;
+    for (unsigned int i = msg_index; i < msg_count; i++)
+    {
+        const struct msghdr& hdr = hdr_list[i].msg_hdr;
+        size_t len = iov_list[i].iov_len;
+        if ((len > segSize) || ((len < segSize) && ((i + 1) < msg_count)) ||
+            (hdr.msg_namelen != first.msg_namelen) ||
+            (0 != memcmp(hdr.msg_name, first.msg_name, first.msg_namelen)))
+        {
+            return false;
+        }
+        total += len;
+    }
+    if (total > 65000) return false;
+    char control[CMSG_SPACE(sizeof(UINT16))];
+    memset(control, 0, sizeof(control));
+    struct msghdr hdr = first;
+    hdr.msg_iov = iov_list + msg_index;
+    hdr.msg_iovlen = count;
+    hdr.msg_control = control;
+    hdr.msg_controllen = sizeof(control);
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr);
+    cmsg->cmsg_level = IPPROTO_UDP;
+    cmsg->cmsg_type = UDP_SEGMENT;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(UINT16));
+    UINT16 gsoSize = (UINT16)segSize;
+    memcpy(CMSG_DATA(cmsg), &gsoSize, sizeof(UINT16));
+    while (sendmsg(fd, &hdr, MSG_DONTWAIT) < 0)
+    {
+        if (EINTR == errno) continue;
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (ENOBUFS == errno))
+        {
+            status = FLUSH_BLOCKED;
+            return true;
+        }
+        // Probably no kernel (or device checksum) support, so fall
+        // back to sendmmsg() from now on
+        PLOG(PL_DEBUG, "NormSendBatch::GsoFlush() UDP_SEGMENT error: %s (disabling GSO)\n", GetErrorString());
+        gso_enable = false;
+        return false;
+    }
+    msg_count = msg_index = 0;
+    status = FLUSH_OK;
+    return true;
+#else
+    return false;
+#endif // if/else UDP_SEGMENT
+}  // end NormSendBatch::GsoFlush()
+#endif // NORM_SEND_BATCH
@@ -1,9 +1,6 @@
 #include "normNode.h"
 #include "normSession.h"
 
-#include "normEncoderMDP.h"
-#include "normEncoderRS8.h"  // 8-bit Reed-Solomon encoder of RFC 5510
-#include "normEncoderRS16.h"  // 16-bit Reed-Solomon encoder of RFC 5510
 
 NormNode::NormNode(Type nodeType, class NormSession& theSession, NormNodeId nodeId)
  : session(theSession), node_type(nodeType), id(nodeId), reference_count(1), user_data(NULL),
@@ -61,6 +58,7 @@ NormSenderNode::CmdBuffer::~CmdBuffer()
 
 const double NormSenderNode::DEFAULT_NOMINAL_INTERVAL = 2*NormSession::DEFAULT_GRTT_ESTIMATE;
 const double NormSenderNode::ACTIVITY_INTERVAL_MIN = 1.0;  // 1 second min activity timeout
+const double NormSenderNode::DECODE_POLL_INTERVAL = 0.001;  // FEC worker results poll interval
         
 NormSenderNode::NormSenderNode(class NormSession& theSession, NormNodeId nodeId)
  : NormNode(SENDER, theSession, nodeId), instance_id(0), robust_factor(session.GetRxRobustFactor()),
@@ -69,20 +67,34 @@ NormSenderNode::NormSenderNode(class NormSession& theSession, NormNodeId nodeId)
    repair_boundary(BLOCK_BOUNDARY), decoder(NULL), erasure_loc(NULL),
    retrieval_loc(NULL), retrieval_pool(NULL), ack_pending(false), 
    ack_ex_pending(false), ack_ex_buffer(NULL), ack_ex_length(0),
+   ack_via_aggregator(false), agg_list(NULL), agg_count(0), agg_size(0), agg_valid(false),
    notify_on_grtt_update(true),
    cc_sequence(0), cc_enable(false), cc_feedback_needed(false), cc_rate(0.0), 
    rtt_confirmed(false), is_clr(false), is_plr(false),
    slow_start(true), send_rate(0.0), recv_rate(0.0), recv_rate_prev(0.0),
    nominal_packet_size(0), cmd_buffer_head(NULL), cmd_buffer_tail(NULL),
    cmd_buffer_pool(NULL), resync_count(0),
-   nack_count(0), suppress_count(0), completion_count(0), failure_count(0)
+   nack_count(0), suppress_count(0), completion_count(0), failure_count(0),
+   recv_bytes(0), goodput_bytes(0), recv_segment_count(0), decode_count(0),
+   repair_waiting(false)
 {
     repair_boundary = session.ReceiverGetDefaultRepairBoundary();
     sync_policy = session.ReceiverGetDefaultSyncPolicy();
+    eviction_policy = session.ReceiverGetDefaultEvictionPolicy();
     default_nacking_mode = session.ReceiverGetDefaultNackingMode();
     unicast_nacks = session.ReceiverGetUnicastNacks();
+    local_nack_sent = false;
+    local_encoder = NULL;
+    local_vectors = NULL;
+    local_vector_count = 0;
+    local_vector_size = 0;
+    local_lengths = NULL;
+    local_block_len = local_seg_max = 0;
+    local_block_valid = local_parity_ready = false;
     
     max_pending_range = session.GetRxCacheMax();
+    rx_buffer_space = session.RemoteSenderBufferSize();
+    rx_memory_reserved = 0;
     
     repair_timer.SetListener(this, &NormSenderNode::OnRepairTimeout);
     repair_timer.SetInterval(0.0);
@@ -102,6 +114,10 @@ NormSenderNode::NormSenderNode(class NormSession& theSession, NormNodeId nodeId)
     ack_timer.SetInterval(0.0);
     ack_timer.SetRepeat(0);
     
+    decode_timer.SetListener(this, &NormSenderNode::OnDecodeTimeout);
+    decode_timer.SetInterval(DECODE_POLL_INTERVAL);
+    decode_timer.SetRepeat(-1);
+    
     grtt_send_time.tv_sec = 0;
     grtt_send_time.tv_usec = 0;
     grtt_quantized = NormQuantizeRtt(NormSession::DEFAULT_GRTT_ESTIMATE);
@@ -126,11 +142,19 @@ NormSenderNode::NormSenderNode(class NormSession& theSession, NormNodeId nodeId)
 NormSenderNode::~NormSenderNode()
 {
     Close();
+    if (NULL != agg_list)
+    {
+        delete[] agg_list;
+        agg_list = NULL;
+    }
 }
 
 bool NormSenderNode::Open(UINT16 instanceId)
 {
     instance_id = instanceId;
+    // (preset senders are opened before they have an id)
+    if (NORM_NODE_ANY != GetId())
+        session.ReceiverGetSenderQuota(GetId(), rx_buffer_space, max_pending_range);
     if (!rx_table.Init(max_pending_range))
     {
         PLOG(PL_FATAL, "NormSenderNode::Open() rx_table init error\n");
@@ -161,6 +185,7 @@ void NormSenderNode::Close()
     if (repair_timer.IsActive()) repair_timer.Deactivate();
     if (cc_timer.IsActive()) cc_timer.Deactivate();   
     if (ack_timer.IsActive()) ack_timer.Deactivate();
+    if (decode_timer.IsActive()) decode_timer.Deactivate();
     FreeBuffers(); 
     
     if (NULL != ack_ex_buffer)
@@ -201,11 +226,14 @@ bool NormSenderNode::AllocateBuffers(unsigned int   bufferSpace,
                                      UINT16         numParity)
 {    
     ASSERT(IsOpen());
+    if ((segmentSize > NORM_SEGMENT_SIZE_MAX) || ((numData + numParity) > NORM_BLOCK_SIZE_MAX))
+    {
+        PLOG(PL_ERROR, "NormSenderNode::AllocateBuffers() error: sender segment size or FEC block size exceeds build limit\n");
+        return false;
+    }
     // Calculate how much memory each buffered block will require
     UINT16 blockSize = numData + numParity;
-    unsigned long maskSize = blockSize >> 3;
-    if (0 != (blockSize & 0x07)) maskSize++;
-    unsigned long blockStateSpace = sizeof(NormBlock) +  blockSize * sizeof(char*) + 2*maskSize;
+    unsigned long blockStateSpace = NormBlockPool::GetBlockSpace(blockSize);
     // The "bufferFactor" weight determines the ratio of segment buffers (blockSegmentSpace) to
     // allocated NormBlock (blockStateSpace).  
     // If "bufferFactor = 1.0", this is equivalent to the old scheme, where every allocated
@@ -235,8 +263,35 @@ bool NormSenderNode::AllocateBuffers(unsigned int   bufferSpace,
     // Always have at least 2 blocks in the pool
     if (numBlocks < 2) numBlocks = 2;
 
+    // The buffers are charged to the instance-wide rx memory budget (if any),
+    // which may leave us fewer blocks than "bufferSpace" would get
+    unsigned long reserveSpace = numBlocks * blockSpace;
+    NormSessionMgr& sessionMgr = session.GetSessionMgr();
+    if (0 != rx_memory_reserved)
+    {
+        sessionMgr.ReleaseRxMemory(rx_memory_reserved);
+        rx_memory_reserved = 0;
+    }
+    unsigned long reserved = sessionMgr.ReserveRxMemory(reserveSpace, 2*blockSpace);
+    if (0 == reserved)
+    {
+        PLOG(PL_ERROR, "NormSenderNode::AllocateBuffers() node>%lu sender>%lu error: rx memory budget exhausted\n",
+                       (unsigned long)LocalNodeId(), (unsigned long)GetId());
+        return false;
+    }
+    else if (reserved < reserveSpace)
+    {
+        numBlocks = reserved / blockSpace;
+        PLOG(PL_WARN, "NormSenderNode::AllocateBuffers() node>%lu sender>%lu warning: rx memory budget limits buffering to %lu blocks\n",
+                      (unsigned long)LocalNodeId(), (unsigned long)GetId(), numBlocks);
+    }
+    rx_memory_reserved = numBlocks * blockSpace;
+    sessionMgr.ReleaseRxMemory(reserved - rx_memory_reserved);
+    
     unsigned long numSegments = numBlocks * segPerBlock;
 
+    session.SetPoolSlabMode(segment_pool, block_pool);
+    session.BindBufferPool(segment_pool, block_pool, segmentSize, blockSize);
     if (!block_pool.Init((UINT32)numBlocks, blockSize))
     {
         PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() block_pool init error\n");
@@ -283,76 +338,29 @@ bool NormSenderNode::AllocateBuffers(unsigned int   bufferSpace,
         return false;   
     }
     
-    if (NULL != decoder) delete decoder;
+    if (NULL != decoder) 
+    {
+        delete decoder;
+        decoder = NULL;
+    }
     
     if (0 != numParity)
     {
-        switch (fecId)
+        // The "instanceId" only distinguishes codecs for fecId = 129
+        UINT16 instanceId = (129 == fecId) ? fecInstanceId : 0;
+        if (!NormFecRegistry::IsRegistered(fecId, fecM, instanceId))
         {
-            case 2:
-                if (8 == fecM)
-                {
-                    if (NULL == (decoder = new NormDecoderRS8))
-                    {
-                        PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() new NormDecoderRS8 error: %s\n", GetErrorString());
-                        Close();
-                        return false; 
-                    }
-                }
-                else if (16 == fecM)
-                {
-                    if (NULL == (decoder = new NormDecoderRS16))
-                    {
-                        PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() new NormDecoderRS16 error: %s\n", GetErrorString());
-                        Close();
-                        return false; 
-                    }
-                }
-                else
-                {
-                    PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() error: unsupported fecId=2 'm' value %d!\n", fecM);
-                    Close();
-                    return false;
-                }
-                break;
-            case 5:
-                if (NULL == (decoder = new NormDecoderRS8))
-                {
-                    PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() new NormDecoderRS8 error: %s\n", GetErrorString());
-                    Close();
-                    return false; 
-                }
-                break;
-            case 129:
-#ifdef ASSUME_MDP_FEC 
-                if (NULL == (decoder = new NormDecoderMDP))
-                {
-                    PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() new NormDecoderMDP error: %s\n", GetErrorString());
-                    Close();
-                    return false; 
-                }
-#else
-                if (0 == fecInstanceId)
-                {
-                    if (NULL == (decoder = new NormDecoderRS8))
-                    {
-                        PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() new NormDecoderRS8 error: %s\n", GetErrorString());
-                        Close();
-                        return false; 
-                    }
-                }
-                else
-                {
-                    PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() error: unknown fecId=129 instanceId!\n");
-                    Close();
-                    return false;
-                }
-#endif // if/else ASSUME_MDP_FEC
-                break;
-            default:
-                PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() error: unknown fecId>%d!\n", fecId);
-                Close();
-                return false;     
+            PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() error: unsupported fecId>%d m>%d instanceId>%hu!\n", 
+                           (int)fecId, (int)fecM, instanceId);
+            Close();
+            return false;
+        }
+        if (NULL == (decoder = NormFecRegistry::CreateDecoder(fecId, fecM, instanceId)))
+        {
+            PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() new %s decoder error: %s\n", 
+                           NormFecRegistry::GetName(fecId, fecM, instanceId), GetErrorString());
+            Close();
+            return false; 
         }
         if (!decoder->Init(numData, numParity, segmentSize+NormDataMsg::GetStreamPayloadHeaderLength()))
         {
@@ -360,6 +368,17 @@ bool NormSenderNode::AllocateBuffers(unsigned int   bufferSpace,
             Close();
             return false; 
         }
+        if (!decoder->SetMatrixCacheSize(session.GetRxDecoderCacheSize()))
+            PLOG(PL_WARN, "NormSenderNode::AllocateBuffers() warning: unable to allocate decoder matrix cache\n");
+        unsigned int numWorkers = session.GetRxFecWorkerCount();
+        if (0 != numWorkers)
+        {
+            if (rx_fec_pool.Init(NormFecWorkerPool::DECODE, numWorkers, fecId, fecM, instanceId, numData, numParity,
+                                 segmentSize+NormDataMsg::GetStreamPayloadHeaderLength()))
+                rx_fec_pool.SetDecoderCacheSize(session.GetRxDecoderCacheSize());
+            else
+                PLOG(PL_WARN, "NormSenderNode::AllocateBuffers() warning: unable to start FEC worker threads, decoding inline\n");
+        }
         if (!(erasure_loc = new unsigned int[numParity]))
         {
             PLOG(PL_FATAL, "NormSenderNode::AllocateBuffers() erasure_loc allocation error: %s\n",  GetErrorString());
@@ -376,6 +395,7 @@ bool NormSenderNode::AllocateBuffers(unsigned int   bufferSpace,
     nominal_packet_size = (double)segmentSize;
     
     fec_id = fecId;
+    fti_data.SetFecInstanceId(fecInstanceId);
     fti_data.SetFecFieldSize(fecM);
     fti_data.SetFecMaxBlockLen(numData);
     fti_data.SetFecNumParity(numParity);
@@ -383,8 +403,27 @@ bool NormSenderNode::AllocateBuffers(unsigned int   bufferSpace,
     return true;
 }  // end NormSenderNode::AllocateBuffers()
 
+void NormSenderNode::Prefault()
+{
+    segment_pool.Prefault();
+    if (NULL != retrieval_pool)
+    {
+        UINT16 numData = BlockSize();
+        unsigned int segLen = SegmentSize() + NormDataMsg::GetStreamPayloadHeaderLength();
+        for (UINT16 i = 0; i < numData; i++)
+        {
+            if (NULL != retrieval_pool[i])
+                memset(retrieval_pool[i], 0, segLen);
+        }
+    }
+    if (NULL != retrieval_loc)
+        memset(retrieval_loc, 0, BlockSize()*sizeof(unsigned int));
+}  // end NormSenderNode::Prefault()
+
 void NormSenderNode::FreeBuffers()
 {
+    rx_fec_pool.Destroy();  // (pending decodes are discarded)
+    if (decode_timer.IsActive()) decode_timer.Deactivate();
     if (erasure_loc)
     {
         delete[] erasure_loc;
@@ -425,7 +464,13 @@ void NormSenderNode::FreeBuffers()
     }
     segment_pool.Destroy();
     block_pool.Destroy();
+    LocalRepairFree();
     fti_data.Invalidate();
+    if (0 != rx_memory_reserved)
+    {
+        session.GetSessionMgr().ReleaseRxMemory(rx_memory_reserved);
+        rx_memory_reserved = 0;
+    }
 }  // end NormSenderNode::FreeBuffers()
 
 unsigned long NormSenderNode::CurrentStreamBufferUsage() 
@@ -679,61 +724,54 @@ void NormSenderNode::HandleCommand(const struct timeval& currentTime,
             cc_sequence = cc.GetCCSequence();
             NormCCRateExtension ext;
             bool hasCCRateExtension = false;
-            while (cc.GetNextExtension(ext))
+            if (cc.FindExtension(NormHeaderExtension::CC_RATE, ext))
             {
-                if (NormHeaderExtension::CC_RATE == ext.GetType())
+                hasCCRateExtension = true;
+                cc_enable = true;
+                send_rate = NormUnquantizeRate(ext.GetSendRate());
+                // Are we in the cc_node_list?
+                UINT8 flags, rtt;
+                UINT16 loss;
+                if (cc.GetCCNode(LocalNodeId(), flags, rtt, loss))
                 {
-                    hasCCRateExtension = true;
-                    cc_enable = true;
-                    send_rate = NormUnquantizeRate(ext.GetSendRate());
-                    // Are we in the cc_node_list?
-                    UINT8 flags, rtt;
-                    UINT16 loss;
-                    if (cc.GetCCNode(LocalNodeId(), flags, rtt, loss))
+                    if (rtt != rtt_quantized)
                     {
-                        if (rtt != rtt_quantized)
-                        {
-                            rtt_quantized = rtt;
-                            rtt_estimate = NormUnquantizeRtt(rtt);
-                            loss_estimator.SetLossEventWindow(rtt_estimate);
-                        }
-                        rtt_confirmed = true;
-                        if (0 != (flags & NormCC::CLR))
-                        {
-                            is_clr = true;
-                            is_plr = false;
-                        }
-                        else if (0 != (flags & NormCC::PLR))
-                        {
-                            is_clr = false;
-                            is_plr = true;   
-                        }
-                        else
-                        {
-                            is_clr = is_plr = false;   
-                        }
+                        rtt_quantized = rtt;
+                        rtt_estimate = NormUnquantizeRtt(rtt);
+                        loss_estimator.SetLossEventWindow(rtt_estimate);
                     }
-                    else
+                    rtt_confirmed = true;
+                    if (0 != (flags & NormCC::CLR))
                     {
-                        is_clr = is_plr = false;
+                        is_clr = true;
+                        is_plr = false;
                     }
-                    double maxBackoff;
-                    if (is_clr || is_plr || !session.Address().IsMulticast())
+                    else if (0 != (flags & NormCC::PLR))
                     {
-                        // Respond immediately (i.e., no backoff, holdoff etc)
-                        maxBackoff = 0.0;
-                        if (cc_timer.IsActive()) cc_timer.Deactivate();
-                        cc_timer.ResetRepeat(); // makes sure timer phase is correct
-                        OnCCTimeout(cc_timer);
-                        break;
+                        is_clr = false;
+                        is_plr = true;   
                     }
                     else
                     {
-                        if (cc_timer.IsActive()) break;
-                        double backoffFactor = backoff_factor;
-                        backoffFactor = MAX(backoffFactor, 4.0);
-                        maxBackoff = grtt_estimate*backoffFactor;
+                        is_clr = is_plr = false;   
                     }
+                }
+                else
+                {
+                    is_clr = is_plr = false;
+                }
+                if (is_clr || is_plr || !session.Address().IsMulticast())
+                {
+                    // Respond immediately (i.e., no backoff, holdoff etc)
+                    if (cc_timer.IsActive()) cc_timer.Deactivate();
+                    cc_timer.ResetRepeat(); // makes sure timer phase is correct
+                    OnCCTimeout(cc_timer);
+                }
+                else if (!cc_timer.IsActive())
+                {
+                    double backoffFactor = backoff_factor;
+                    backoffFactor = MAX(backoffFactor, 4.0);
+                    double maxBackoff = grtt_estimate*backoffFactor;
                     double backoffTime = 
                         (maxBackoff > 0.0) ?
                             ExponentialRand(maxBackoff, gsize_estimate) : 0.0;
@@ -764,9 +802,8 @@ void NormSenderNode::HandleCommand(const struct timeval& currentTime,
                     PLOG(PL_DEBUG, "NormSenderNode::HandleCommand() node>%lu begin CC back-off: %lf sec)...\n",
                                     (unsigned long)LocalNodeId(), backoffTime);
                     session.ActivateTimer(cc_timer);
-                    break;
-                }  // end if (CC_RATE == ext.GetType())
-            }  // end while (GetNextExtension())
+                }
+            }  // end if (cc.FindExtension(CC_RATE))
             // Disable CC feedback if sender doesn't want it
             if (!hasCCRateExtension && cc_enable) cc_enable = false;
             break;
@@ -777,16 +814,26 @@ void NormSenderNode::HandleCommand(const struct timeval& currentTime,
             // to positively acknowledge the FLUSH
             const NormCmdFlushMsg& flush = (const NormCmdFlushMsg&)cmd;
             bool doAck = false;
+            bool viaAggregator = false;
             UINT16 nodeCount = flush.GetAckingNodeCount();
             NormNodeId localId = LocalNodeId();
+            NormNodeId aggregatorId = session.ReceiverAckAggregatorId();
             for (UINT16 i = 0; i < nodeCount; i++)
             {
                 // (TBD) also ACK if NORM_NODE_ANY is listed???
-                if (flush.GetAckingNodeId(i) == localId)
+                NormNodeId nodeId = flush.GetAckingNodeId(i);
+                if (nodeId == localId)
                 {
                     doAck = true;
+                    viaAggregator = false;
                     break;   
                 }
+                else if ((NORM_NODE_NONE != aggregatorId) && (nodeId == aggregatorId))
+                {
+                    // Our aggregator was listed for us (keep looking in case we are, too)
+                    doAck = true;
+                    viaAggregator = true;
+                }
             } 
             NormObjectId objectId = flush.GetObjectId();
             NormBlockId blockId = 0;
@@ -827,23 +874,29 @@ void NormSenderNode::HandleCommand(const struct timeval& currentTime,
             {
                 if (doAck) // this was a watermark flush
                 {
+                    // An aggregator collects its members' ACKs for the latest watermark
+                    // it is asked for (whether or not it can ACK it itself yet)
+                    if (!viaAggregator && session.ReceiverIsAckAggregator() &&
+                        (!agg_valid || (objectId != agg_object_id) || 
+                         (blockId != agg_block_id) || (symbolId != agg_segment_id)))
+                    {
+                        AggregateReset(objectId, blockId, symbolId);
+                    }
                     if (!PassiveRepairCheck(objectId, blockId, symbolId))
                     {
                        watermark_object_id = objectId;
                        watermark_block_id = blockId;  
                        watermark_segment_id = symbolId;
+                       ack_via_aggregator = viaAggregator;
                        
                        // Check for application-extended watermark request (see NormSetWatermarkEx())
                        const char* appAckReq = NULL;
                        unsigned int appAckReqLen = 0;
                        NormAppAckExtension ext;
-                       while (flush.GetNextExtension(ext))
+                       if (flush.FindExtension(NormHeaderExtension::APP_ACK, ext))
                        {
-                           if (NormHeaderExtension::APP_ACK == ext.GetType())
-                           {
-                               appAckReq = ext.GetContent();
-                               appAckReqLen = ext.GetContentLength();
-                           }
+                           appAckReq = ext.GetContent();
+                           appAckReqLen = ext.GetContentLength();
                        }   
                        if (NULL != appAckReq)
                        {
@@ -874,6 +927,9 @@ void NormSenderNode::HandleCommand(const struct timeval& currentTime,
                        {
                             double ackBackoff = (session.Address().IsMulticast() && (backoff_factor > 0.0)) ? 
                                                     UniformRand(grtt_estimate) : 0.0;
+                            // An aggregator holds its ACK to collect its members' ACKs first
+                            if (!viaAggregator && session.ReceiverIsAckAggregator())
+                                ackBackoff = grtt_estimate;
                             ack_timer.SetInterval(ackBackoff);
                             ack_pending = true;
                             session.ActivateTimer(ack_timer); 
@@ -894,14 +950,8 @@ void NormSenderNode::HandleCommand(const struct timeval& currentTime,
                 cc_timer.GetRepeatCount())
             {
                 NormCCFeedbackExtension ext;
-                while (repairAdv.GetNextExtension(ext))
-                {
-                    if (NormHeaderExtension::CC_FEEDBACK == ext.GetType())
-                    {
-                        HandleCCFeedback(ext.GetCCFlags(), NormUnquantizeRate(ext.GetCCRate()));
-                        break;
-                    }
-                }
+                if (repairAdv.FindExtension(NormHeaderExtension::CC_FEEDBACK, ext))
+                    HandleCCFeedback(ext.GetCCFlags(), NormUnquantizeRate(ext.GetCCRate()));
             }   
             if (repair_timer.IsActive() && repair_timer.GetRepeatCount())
             {
@@ -1031,15 +1081,12 @@ void NormSenderNode::HandleAckMessage(const NormAckMsg& ack)
     if (!is_clr && !is_plr && cc_timer.IsActive() && cc_timer.GetRepeatCount())
     {
         NormCCFeedbackExtension ext;
-        while (ack.GetNextExtension(ext))
-        {
-            if (NormHeaderExtension::CC_FEEDBACK == ext.GetType())
-            {
-                HandleCCFeedback(ext.GetCCFlags(), NormUnquantizeRate(ext.GetCCRate()));
-                break;
-            }
-        }
+        if (ack.FindExtension(NormHeaderExtension::CC_FEEDBACK, ext))
+            HandleCCFeedback(ext.GetCCFlags(), NormUnquantizeRate(ext.GetCCRate()));
     }    
+    // An ACK aggregator collects the watermark ACKs its members send it
+    if (session.ReceiverIsAckAggregator() && (NormAck::FLUSH == ack.GetAckType()))
+        AggregateAck(static_cast<const NormAckFlushMsg&>(ack));
 }  // end NormSenderNode::HandleAckMessage()
 
 void NormSenderNode::HandleNackMessage(const NormNackMsg& nack)
@@ -1048,18 +1095,15 @@ void NormSenderNode::HandleNackMessage(const NormNackMsg& nack)
     if (!is_clr && !is_plr && cc_timer.IsActive() && cc_timer.GetRepeatCount())
     {
         NormCCFeedbackExtension ext;
-        while (nack.GetNextExtension(ext))
-        {
-            if (NormHeaderExtension::CC_FEEDBACK == ext.GetType())
-            {
-                HandleCCFeedback(ext.GetCCFlags(), NormUnquantizeRate(ext.GetCCRate()));
-                break;
-            }
-        }
+        if (nack.FindExtension(NormHeaderExtension::CC_FEEDBACK, ext))
+            HandleCCFeedback(ext.GetCCFlags(), NormUnquantizeRate(ext.GetCCRate()));
     }
     // Receivers also care about recvd NACKS for NACK suppression
     if (repair_timer.IsActive() && repair_timer.GetRepeatCount())
         HandleRepairContent(nack.GetRepairContent(), nack.GetRepairContentLength());
+    // A designated local repairer answers what it can of the NACK from its receive cache
+    if (session.ReceiverIsLocalRepairer())
+        LocalRepair(nack.GetRepairContent(), nack.GetRepairContentLength());
 }  // end NormSenderNode::HandleNackMessage()
 
 // Receivers use this method to process NACK content overheard from other 
@@ -1186,6 +1230,304 @@ void NormSenderNode::HandleRepairContent(const UINT32* buffer, UINT16 bufferLen)
     }  // end while (nack.UnpackRepairRequest())
 }  // end NormSenderNode::HandleRepairContent()
 
+// A designated local repairer answers the segment and block requests of NACKs
+// overheard from (site scoped) receivers with content from its own receive
+// cache.  Source segments are copied from the received object and parity
+// segments are re-encoded when the whole block is held.  INFO and OBJECT
+// requests are left to the sender.
+void NormSenderNode::LocalRepair(const UINT32* buffer, UINT16 bufferLen)
+{
+    if (!BuffersAllocated() || !fti_data.IsValid()) return;
+    local_block_valid = false;  // (the receive cache may have changed since)
+    unsigned int repairCount = 0;
+    NormRepairRequest req;
+    UINT16 requestLength = 0;
+    while (0 != (requestLength = req.Unpack(buffer, bufferLen)))
+    {      
+        buffer += (requestLength/4); 
+        bufferLen -= requestLength;
+        bool segmentLevel = req.FlagIsSet(NormRepairRequest::SEGMENT);
+        if (!segmentLevel && !req.FlagIsSet(NormRepairRequest::BLOCK)) continue;
+        NormRepairRequest::Form requestForm = req.GetForm();
+        NormRepairRequest::Iterator iterator(req, fec_id, fti_data.GetFecFieldSize());
+        NormObjectId nextObjectId, lastObjectId;
+        NormBlockId nextBlockId, lastBlockId;
+        UINT16 nextBlockLen, lastBlockLen;
+        NormSegmentId nextSegmentId, lastSegmentId;
+        while (iterator.NextRepairItem(&nextObjectId, &nextBlockId, 
+                                       &nextBlockLen, &nextSegmentId))
+        {
+            if (NormRepairRequest::RANGES == requestForm)
+            {
+                if (!iterator.NextRepairItem(&lastObjectId, &lastBlockId, 
+                                             &lastBlockLen, &lastSegmentId))
+                    break;
+            }
+            else
+            {
+                lastObjectId = nextObjectId;
+                lastBlockId = nextBlockId;
+                lastSegmentId = nextSegmentId;
+            }
+            // (ranges spanning objects aren't used for these requests)
+            NormObject* obj = rx_table.Find(nextObjectId);
+            if (NULL == obj) continue;
+            if (segmentLevel)
+            {
+                if (!LocalRepairLoad(*obj, nextBlockId)) continue;
+                UINT16 segmentMax = local_block_len + NumParity() - 1;
+                if (lastSegmentId > segmentMax) lastSegmentId = segmentMax;
+                for (NormSegmentId s = nextSegmentId; s <= lastSegmentId; s++)
+                {
+                    if (repairCount >= LOCAL_REPAIR_MAX) return;
+                    if (LocalRepairSend(*obj, s)) repairCount++;
+                }
+            }
+            else
+            {
+                NormBlockId blockId = nextBlockId;
+                unsigned int blockCount = 0;
+                while ((obj->Compare(blockId, lastBlockId) <= 0) && (blockCount++ < LOCAL_REPAIR_MAX))
+                {
+                    if (LocalRepairLoad(*obj, blockId))
+                    {
+                        for (NormSegmentId s = 0; s < local_block_len; s++)
+                        {
+                            if (repairCount >= LOCAL_REPAIR_MAX) return;
+                            if (LocalRepairSend(*obj, s)) repairCount++;
+                        }
+                    }
+                    obj->Increment(blockId);
+                }
+            }
+        }  // end while (iterator.NextRepairItem())
+    }  // end while (req.Unpack())
+    if (0 != repairCount)
+        PLOG(PL_DEBUG, "NormSenderNode::LocalRepair() node>%lu sender>%lu sent %u local repairs\n",
+                        (unsigned long)LocalNodeId(), (unsigned long)GetId(), repairCount);
+}  // end NormSenderNode::LocalRepair()
+
+// Copies the source segments of the given block we hold into "local_vectors"
+bool NormSenderNode::LocalRepairLoad(NormObject& obj, NormBlockId blockId)
+{
+    if (local_block_valid && (obj.GetId() == local_object_id) && (blockId == local_block_id))
+        return (0 != local_seg_max);
+    unsigned int vectorCount = BlockSize() + NumParity();
+    UINT16 vectorSize = SegmentSize() + NormDataMsg::GetStreamPayloadHeaderLength();
+    if ((NULL != local_vectors) && ((vectorCount != local_vector_count) || (vectorSize != local_vector_size)))
+        LocalRepairFree();  // (FEC parameters changed)
+    if (NULL == local_vectors)
+    {
+        if (NULL == (local_vectors = new char*[vectorCount]))
+        {
+            PLOG(PL_ERROR, "NormSenderNode::LocalRepairLoad() new vector list error: %s\n", GetErrorString());
+            return false;
+        }
+        memset(local_vectors, 0, vectorCount*sizeof(char*));
+        local_vector_count = vectorCount;
+        local_vector_size = vectorSize;
+        for (unsigned int i = 0; i < vectorCount; i++)
+        {
+            if (NULL == (local_vectors[i] = new char[vectorSize]))
+            {
+                PLOG(PL_ERROR, "NormSenderNode::LocalRepairLoad() new vector error: %s\n", GetErrorString());
+                LocalRepairFree();
+                return false;
+            }
+        }
+        if (NULL == (local_lengths = new UINT16[BlockSize()]))
+        {
+            PLOG(PL_ERROR, "NormSenderNode::LocalRepairLoad() new length list error: %s\n", GetErrorString());
+            LocalRepairFree();
+            return false;
+        }
+    }
+    local_object_id = obj.GetId();
+    local_block_id = blockId;
+    local_block_len = (UINT16)obj.GetBlockSize(blockId);
+    if (local_block_len > BlockSize()) local_block_len = BlockSize();
+    local_seg_max = 0;
+    local_parity_ready = false;
+    for (UINT16 i = 0; i < local_block_len; i++)
+    {
+        local_lengths[i] = obj.ReceiverReadSegment(blockId, i, local_vectors[i]);
+        if (local_lengths[i] > local_seg_max) local_seg_max = local_lengths[i];
+    }
+    local_block_valid = true;
+    return (0 != local_seg_max);
+}  // end NormSenderNode::LocalRepairLoad()
+
+// Re-encodes the loaded block's parity (which requires all of its source segments)
+bool NormSenderNode::LocalRepairParity()
+{
+    if (local_parity_ready) return true;
+    if (0 == NumParity()) return false;
+    for (UINT16 i = 0; i < local_block_len; i++)
+        if (0 == local_lengths[i]) return false;
+    if (NULL == local_encoder)
+    {
+        UINT16 instanceId = (129 == fec_id) ? fti_data.GetFecInstanceId() : 0;
+        if (NULL == (local_encoder = NormFecRegistry::CreateEncoder(fec_id, fti_data.GetFecFieldSize(), instanceId)))
+        {
+            PLOG(PL_ERROR, "NormSenderNode::LocalRepairParity() new encoder error: %s\n", GetErrorString());
+            return false;
+        }
+        if (!local_encoder->Init(BlockSize(), NumParity(), local_vector_size))
+        {
+            PLOG(PL_ERROR, "NormSenderNode::LocalRepairParity() encoder init error\n");
+            delete local_encoder;
+            local_encoder = NULL;
+            return false;
+        }
+    }
+    // ZERO pad any "runt" segments before encoding
+    for (UINT16 i = 0; i < local_block_len; i++)
+    {
+        if (local_lengths[i] < local_vector_size)
+            memset(local_vectors[i] + local_lengths[i], 0, local_vector_size - local_lengths[i]);
+    }
+    char** parityList = local_vectors + BlockSize();
+    for (UINT16 i = 0; i < NumParity(); i++)
+        memset(parityList[i], 0, local_vector_size);
+    NORM_PROBE2(fec_encode_start, local_block_len, 0);
+    local_encoder->EncodeBlock((const char**)local_vectors, local_block_len, parityList);
+    NORM_PROBE2(fec_encode_end, local_block_len, 0);
+    local_parity_ready = true;
+    return true;
+}  // end NormSenderNode::LocalRepairParity()
+
+bool NormSenderNode::LocalRepairSend(NormObject& obj, NormSegmentId segmentId)
+{
+    const char* payload;
+    UINT16 payloadLength;
+    if (segmentId < local_block_len)
+    {
+        if (0 == (payloadLength = local_lengths[segmentId])) return false;
+        payload = local_vectors[segmentId];
+    }
+    else
+    {
+        if ((segmentId >= (local_block_len + NumParity())) || !LocalRepairParity()) return false;
+        payload = local_vectors[BlockSize() + segmentId - local_block_len];
+        payloadLength = local_seg_max;  // (enough to cover the block's biggest segment)
+    }
+    NormDataMsg* data = (NormDataMsg*)session.GetMessageFromPool(local_vector_size);
+    if (NULL == data)
+    {
+        PLOG(PL_WARN, "NormSenderNode::LocalRepairSend() node>%lu warning: message pool empty\n",
+                       (unsigned long)LocalNodeId());
+        return false;
+    }
+    data->Init();
+    data->SetFecId(fec_id);
+    data->ResetFlags();
+    data->SetFlag(NormObjectMsg::FLAG_REPAIR);
+    switch (obj.GetType())
+    {
+        case NormObject::STREAM:
+            data->SetFlag(NormObjectMsg::FLAG_STREAM);
+            break;
+        case NormObject::FILE:
+            data->SetFlag(NormObjectMsg::FLAG_FILE);
+            break;
+        default:
+            break;
+    }
+    if (obj.HasInfo()) data->SetFlag(NormObjectMsg::FLAG_INFO);
+    data->SetObjectId(obj.GetId());
+    // Receivers that haven't got this object's FTI yet may need it
+    switch (fec_id)
+    {
+        case 2:
+        {
+            NormFtiExtension2 fti;
+            data->AttachExtension(fti);
+            fti.SetObjectSize(obj.GetSize());
+            fti.SetFecFieldSize(fti_data.GetFecFieldSize());
+            fti.SetFecGroupSize(1);
+            fti.SetSegmentSize(SegmentSize());
+            fti.SetFecMaxBlockLen(BlockSize());
+            fti.SetFecNumParity(NumParity());
+            break;
+        }
+        case 5:
+        {
+            NormFtiExtension5 fti;
+            data->AttachExtension(fti);
+            fti.SetObjectSize(obj.GetSize());
+            fti.SetSegmentSize(SegmentSize());
+            fti.SetFecMaxBlockLen((UINT8)BlockSize());
+            fti.SetFecNumParity((UINT8)NumParity());
+            break;
+        }
+        case 129:
+        {
+            NormFtiExtension129 fti;
+            data->AttachExtension(fti);
+            fti.SetObjectSize(obj.GetSize());
+            fti.SetFecInstanceId(fti_data.GetFecInstanceId());
+            fti.SetSegmentSize(SegmentSize());
+            fti.SetFecMaxBlockLen(BlockSize());
+            fti.SetFecNumParity(NumParity());
+            break;
+        }
+        default:
+            break;
+    }
+    NormLocalRepairExtension ext;
+    data->AttachExtension(ext);
+    ext.SetRepairerId(LocalNodeId());
+    memcpy(data->AccessPayload(), payload, payloadLength);
+    data->SetPayloadLength(payloadLength);
+    data->SetFecPayloadId(fec_id, local_block_id.GetValue(), segmentId, local_block_len, fti_data.GetFecFieldSize());
+    // These are stamped as from the sender itself
+    data->SetInstanceId(instance_id);
+    data->SetGrtt(grtt_quantized);
+    data->SetBackoffFactor((unsigned char)backoff_factor);
+    data->SetGroupSize(gsize_quantized);
+    data->SetSequence(0);
+    data->SetSourceId(GetId());
+    data->SetDestination(session.Address());
+    bool result = (NormSession::MSG_SEND_OK == session.SendScopedMessage(*data, session.ReceiverLocalRepairTtl(), true));
+    session.ReturnMessageToPool(data);
+    return result;
+}  // end NormSenderNode::LocalRepairSend()
+
+void NormSenderNode::LocalRepairFree()
+{
+    if (NULL != local_encoder)
+    {
+        local_encoder->Destroy();
+        delete local_encoder;
+        local_encoder = NULL;
+    }
+    if (NULL != local_vectors)
+    {
+        for (unsigned int i = 0; i < local_vector_count; i++)
+            if (NULL != local_vectors[i]) delete[] local_vectors[i];
+        delete[] local_vectors;
+        local_vectors = NULL;
+    }
+    local_vector_count = 0;
+    local_vector_size = 0;
+    if (NULL != local_lengths)
+    {
+        delete[] local_lengths;
+        local_lengths = NULL;
+    }
+    local_block_valid = false;
+    local_parity_ready = false;
+}  // end NormSenderNode::LocalRepairFree()
+
+// Local repair NACK rounds are site scoped (see NormSession::ReceiverSetLocalRepair())
+void NormSenderNode::SendNack(NormNackMsg& nack)
+{
+    if ((0 != session.ReceiverLocalRepairTtl()) && local_nack_sent)
+        session.SendScopedMessage(nack, session.ReceiverLocalRepairTtl());
+    else
+        session.SendMessage(nack);
+}  // end NormSenderNode::SendNack()
+
 
 void NormSenderNode::CalculateGrttResponse(const struct timeval&    currentTime,
                                            struct timeval&          grttResponse) const
@@ -1232,7 +1574,38 @@ void NormSenderNode::DeleteObject(NormObject* obj)
 NormBlock* NormSenderNode::GetFreeBlock(NormObjectId objectId, NormBlockId blockId)
 {
     NormBlock* b = block_pool.Get();
-    if (NULL == b)
+    if ((NULL == b) && (EVICT_SCORED == eviction_policy))
+    {
+        // Steal the least costly block to lose among the same objects the
+        // ordinal policy would consider, scanning them in the same order
+        // (so equal cost blocks are stolen as the ordinal policy would)
+        bool olderFirst = session.ReceiverIsSilent() || session.RcvrIsRealtime();
+        NormObject* victimObj = NULL;
+        unsigned int costMin = (unsigned int)-1;
+        unsigned int scanCount = EVICT_SCAN_MAX;
+        NormObjectTable::Iterator iterator(rx_table);
+        NormObject* obj;
+        while ((0 != scanCount) && (NULL != (obj = (olderFirst ? iterator.GetNextObject() : iterator.GetPrevObject()))))
+        {
+            if (olderFirst ? (obj->GetId() > objectId) : (obj->GetId() < objectId)) break;
+            NormBlock* block = obj->GetEvictionCandidate(obj->GetId() == objectId, blockId, 
+                                                         !olderFirst, costMin, scanCount);
+            if (NULL != block)
+            {
+                b = block;
+                victimObj = obj;
+                if (0 == costMin) break;  // (can't do better than an empty block)
+            }
+        }
+        if (NULL != b)
+        {
+            victimObj->StealBlock(b);
+            NORM_PROBE2(block_steal, (unsigned long)GetId(), (UINT16)victimObj->GetId());
+            if (b->DecodePending()) AbandonDecode(b);
+            b->EmptyToPool(segment_pool);
+        }
+    }
+    else if (NULL == b)
     {
         if (session.ReceiverIsSilent() || session.RcvrIsRealtime())
         {
@@ -1253,6 +1626,8 @@ NormBlock* NormSenderNode::GetFreeBlock(NormObjectId objectId, NormBlockId block
                         b = obj->StealOldestBlock(true, blockId); 
                     if (b) 
                     {
+                        NORM_PROBE2(block_steal, (unsigned long)GetId(), (UINT16)obj->GetId());
+                        if (b->DecodePending()) AbandonDecode(b);
                         b->EmptyToPool(segment_pool);
                         break;
                     }
@@ -1278,6 +1653,8 @@ NormBlock* NormSenderNode::GetFreeBlock(NormObjectId objectId, NormBlockId block
                         b = obj->StealNewestBlock(true, blockId); 
                     if (b) 
                     {
+                        NORM_PROBE2(block_steal, (unsigned long)GetId(), (UINT16)obj->GetId());
+                        if (b->DecodePending()) AbandonDecode(b);
                         b->EmptyToPool(segment_pool);
                         break;
                     }
@@ -1379,55 +1756,46 @@ bool NormSenderNode::GetFtiData(const NormObjectMsg& msg, NormFtiData& ftiData)
         case 2:
         {
             NormFtiExtension2 fti;
-            while (msg.GetNextExtension(fti))
+            if (msg.FindExtension(NormHeaderExtension::FTI, fti))
             {
-                if (NormHeaderExtension::FTI == fti.GetType())
-                {
-                    ASSERT(1 == fti.GetFecGroupSize());  // TBD - allow for different groupings
-                    ftiData.SetFecInstanceId(0);
-                    ftiData.SetFecFieldSize(fti.GetFecFieldSize());
-                    ftiData.SetSegmentSize(fti.GetSegmentSize());
-                    ftiData.SetFecMaxBlockLen(fti.GetFecMaxBlockLen());
-                    ftiData.SetFecNumParity(fti.GetFecNumParity());
-                    ftiData.SetObjectSize(fti.GetObjectSize());
-                    return true;
-                }
+                ASSERT(1 == fti.GetFecGroupSize());  // TBD - allow for different groupings
+                ftiData.SetFecInstanceId(0);
+                ftiData.SetFecFieldSize(fti.GetFecFieldSize());
+                ftiData.SetSegmentSize(fti.GetSegmentSize());
+                ftiData.SetFecMaxBlockLen(fti.GetFecMaxBlockLen());
+                ftiData.SetFecNumParity(fti.GetFecNumParity());
+                ftiData.SetObjectSize(fti.GetObjectSize());
+                return true;
             }
             break;
         }
         case 5:
         {
             NormFtiExtension5 fti;
-            while (msg.GetNextExtension(fti))
+            if (msg.FindExtension(NormHeaderExtension::FTI, fti))
             {
-                if (NormHeaderExtension::FTI == fti.GetType())
-                {
-                    ftiData.SetFecInstanceId(0);
-                    ftiData.SetFecFieldSize(8);
-                    ftiData.SetSegmentSize(fti.GetSegmentSize());
-                    ftiData.SetFecMaxBlockLen(fti.GetFecMaxBlockLen());
-                    ftiData.SetFecNumParity(fti.GetFecNumParity());
-                    ftiData.SetObjectSize(fti.GetObjectSize());
-                    return true;
-                }
+                ftiData.SetFecInstanceId(0);
+                ftiData.SetFecFieldSize(8);
+                ftiData.SetSegmentSize(fti.GetSegmentSize());
+                ftiData.SetFecMaxBlockLen(fti.GetFecMaxBlockLen());
+                ftiData.SetFecNumParity(fti.GetFecNumParity());
+                ftiData.SetObjectSize(fti.GetObjectSize());
+                return true;
             }
             break;
         }
         case 129:
         {
             NormFtiExtension129 fti;
-            while (msg.GetNextExtension(fti))
+            if (msg.FindExtension(NormHeaderExtension::FTI, fti))
             {
-                if (NormHeaderExtension::FTI == fti.GetType())
-                {
-                    ftiData.SetFecInstanceId(fti.GetFecInstanceId());
-                    ftiData.SetFecFieldSize(8);
-                    ftiData.SetSegmentSize(fti.GetSegmentSize());
-                    ftiData.SetFecMaxBlockLen(fti.GetFecMaxBlockLen());
-                    ftiData.SetFecNumParity(fti.GetFecNumParity());
-                    ftiData.SetObjectSize(fti.GetObjectSize());
-                    return true;
-                }
+                ftiData.SetFecInstanceId(fti.GetFecInstanceId());
+                ftiData.SetFecFieldSize(8);
+                ftiData.SetSegmentSize(fti.GetSegmentSize());
+                ftiData.SetFecMaxBlockLen(fti.GetFecMaxBlockLen());
+                ftiData.SetFecNumParity(fti.GetFecNumParity());
+                ftiData.SetObjectSize(fti.GetObjectSize());
+                return true;
             }
             break;
         }
@@ -1572,7 +1940,7 @@ void NormSenderNode::HandleObjectMessage(const NormObjectMsg& msg)
                 }
                 // else wait for NORM_INFO message with sender FTI
             }
-            if (gotFTI && !AllocateBuffers((unsigned int)session.RemoteSenderBufferSize(),
+            if (gotFTI && !AllocateBuffers((unsigned int)rx_buffer_space,
                                            fecId, ftiData.GetFecInstanceId(),
                                            ftiData.GetFecFieldSize(),
                                            ftiData.GetSegmentSize(),
@@ -1774,6 +2142,7 @@ void NormSenderNode::HandleObjectMessage(const NormObjectMsg& msg)
                                     ftiData.GetFecMaxBlockLen(),
                                     ftiData.GetFecNumParity()))
                     {
+                        if (session.LatencyStatsEnabled()) obj->MarkLatencyTime();
                         session.Notify(NormController::RX_OBJECT_NEW, this, obj);
                         if (obj->Accepted())
                         {
@@ -1803,6 +2172,10 @@ void NormSenderNode::HandleObjectMessage(const NormObjectMsg& msg)
                                     stream->StreamUpdateStatus(syncId);
                                 }
                             }    
+                            else if (NULL != session.GetRelaySession())
+                            {
+                                session.GetRelaySession()->RelayOpenObject(*obj);
+                            }
                             PLOG(PL_DETAIL, "NormSenderNode::HandleObjectMessage() node>%lu sender>%lu new obj>%hu\n", 
                                             (unsigned long)LocalNodeId(), (unsigned long)GetId(), (UINT16)objectId);
                         }
@@ -1853,33 +2226,43 @@ void NormSenderNode::HandleObjectMessage(const NormObjectMsg& msg)
     
     if (NULL != obj)
     {
-        obj->HandleObjectMessage(msg, msgType, blockId, segmentId);
-        bool objIsPending = obj->IsPending();
-        
-        // Silent receivers may be configured to allow obj completion w/out INFO
-        if (objIsPending && session.RcvrIgnoreInfo())
-            objIsPending = obj->PendingMaskIsSet();
-        
-        if (!objIsPending)
+        // The first message for content we're waiting on repair of (a NACKed
+        // block or missing NORM_INFO) ends the repair wait (see MarkRepairWait())
+        if (repair_waiting && (OBJ_PENDING == status))
         {
-            // Reliable reception of this object has completed
-            if (NormObject::FILE == obj->GetType()) 
-#ifdef SIMULATE
-                static_cast<NormSimObject*>(obj)->Close();           
-#else
-                static_cast<NormFileObject*>(obj)->Close();
-#endif // !SIMULATE
-            if (NormObject::STREAM != obj->GetType())
+            bool isRepair;
+            if (NormMsg::DATA == msgType)
             {
-                // Streams never complete unless they are "closed" by sender
-                // and this is handled within stream control code in "normObject.cpp"
-                session.Notify(NormController::RX_OBJECT_COMPLETED, this, obj);
-                DeleteObject(obj);
-                obj = NULL;
-                completion_count++;
+                // (unbuffered blocks before max_pending_block were NACKed whole)
+                NormBlock* block = obj->FindBlock(blockId);
+                if (NULL != block)
+                    isRepair = block->InRepair();
+                else
+                    isRepair = obj->IsPendingSet(blockId) &&
+                               (obj->Compare(blockId, obj->GetMaxPendingBlockId()) < 0);
             }
-        } 
+            else
+            {
+                isRepair = obj->IsPendingInfo();
+            }
+            if (isRepair)
+            {
+                repair_latency.Record(ProtoTime::Delta(ProtoTime().GetCurrentTime(), repair_wait_time));
+                repair_waiting = false;
+            }
+        }
+        obj->HandleObjectMessage(msg, msgType, blockId, segmentId);
+        if (HandleObjectCompletion(obj)) obj = NULL;
     }  // end (if (NULL != obj)  
+    if ((NormMsg::DATA == msgType) && msg.FlagIsSet(NormObjectMsg::FLAG_FLUSH))
+    {
+        // The sender piggybacked its flush on this message (see NormSession::SetTxFlushPiggyback()),
+        // so check for repair needs through it (a parity segment flushes its whole block) now
+        if ((NULL != obj) && (segmentId >= obj->GetBlockSize(blockId)))
+            segmentId = obj->GetBlockSize(blockId) - 1;
+        RepairCheck(NormObject::THRU_SEGMENT, objectId, blockId, segmentId);
+        return;
+    }
     switch (repair_boundary)
     {
         case BLOCK_BOUNDARY:
@@ -1899,6 +2282,115 @@ void NormSenderNode::HandleObjectMessage(const NormObjectMsg& msg)
     }
 }  // end NormSenderNode::HandleObjectMessage()
 
+bool NormSenderNode::HandleObjectCompletion(NormObject* obj)
+{
+    bool objIsPending = obj->IsPending();
+    
+    // Silent receivers may be configured to allow obj completion w/out INFO
+    if (objIsPending && session.RcvrIgnoreInfo())
+        objIsPending = obj->PendingMaskIsSet();
+    
+    if (!objIsPending)
+    {
+        if (!obj->ReceiverVerifyDigest())
+        {
+            PLOG(PL_ERROR, "NormSenderNode::HandleObjectCompletion() node>%lu sender>%lu obj>%hu "
+                           "content digest mismatch (aborting object)\n", (unsigned long)LocalNodeId(),
+                           (unsigned long)GetId(), (UINT16)obj->GetId());
+            AbortObject(obj);
+            return true;
+        }
+        // Reliable reception of this object has completed
+        if (NormObject::FILE == obj->GetType()) 
+#ifdef SIMULATE
+            static_cast<NormSimObject*>(obj)->Close();           
+#else
+            static_cast<NormFileObject*>(obj)->Close();
+#endif // !SIMULATE
+        if (NormObject::STREAM != obj->GetType())
+        {
+            // Streams never complete unless they are "closed" by sender
+            // and this is handled within stream control code in "normObject.cpp"
+            if (obj->LatencyPending())
+                object_latency.Record(obj->GetLatency());
+            session.Notify(NormController::RX_OBJECT_COMPLETED, this, obj);
+            DeleteObject(obj);
+            completion_count++;
+            return true;
+        }
+    } 
+    return false;
+}  // end NormSenderNode::HandleObjectCompletion()
+
+UINT16 NormSenderNode::Decode(char** segmentList, UINT16 numData, UINT16 erasureCount)
+{
+    decode_count++;
+    NORM_PROBE2(fec_decode_start, numData, erasureCount);
+    if (!session.LatencyStatsEnabled())
+    {
+        UINT16 result = decoder->Decode(segmentList, numData, erasureCount, erasure_loc);
+        NORM_PROBE2(fec_decode_end, numData, erasureCount);
+        return result;
+    }
+    ProtoTime startTime;
+    startTime.GetCurrentTime();
+    UINT16 result = decoder->Decode(segmentList, numData, erasureCount, erasure_loc);
+    decode_latency.Record(ProtoTime::Delta(ProtoTime().GetCurrentTime(), startTime));
+    NORM_PROBE2(fec_decode_end, numData, erasureCount);
+    return result;
+}  // end NormSenderNode::Decode()
+
+void NormSenderNode::MarkRepairWait()
+{
+    if (repair_waiting || !session.LatencyStatsEnabled()) return;
+    repair_wait_time.GetCurrentTime();
+    repair_waiting = true;
+}  // end NormSenderNode::MarkRepairWait()
+
+void NormSenderNode::SubmitDecodeJob(NormObject* obj, NormBlock* block, UINT16 numData, UINT16 erasureCount)
+{
+    rx_fec_pool.SubmitDecode(block, obj, numData, erasureCount, erasure_loc);
+    decode_count++;
+    block->SetFlag(NormBlock::DECODE_PENDING);
+    if (!decode_timer.IsActive()) session.ActivateTimer(decode_timer);
+}  // end NormSenderNode::SubmitDecodeJob()
+
+void NormSenderNode::AbandonDecode(NormBlock* block)
+{
+    unsigned int numData;
+    rx_fec_pool.Collect(block, numData);
+    block->ClearFlag(NormBlock::DECODE_PENDING);
+}  // end NormSenderNode::AbandonDecode()
+
+void NormSenderNode::MergeDecodes()
+{
+    const void* group;
+    char** vectorList;
+    unsigned int erasureCount;
+    const unsigned int* erasureLocs;
+    bool decoded;
+    NormBlock* block;
+    while (NULL != (block = (NormBlock*)rx_fec_pool.GetDecoded(group, vectorList, erasureCount, erasureLocs, decoded)))
+    {
+        // (the job's object is valid since its blocks' jobs are abandoned when it is closed)
+        NormObject* obj = (NormObject*)group;
+        obj->ReceiverMergeDecode(block, vectorList, erasureCount, erasureLocs, decoded);
+        rx_fec_pool.Release(block);
+        HandleObjectCompletion(obj);
+    }
+}  // end NormSenderNode::MergeDecodes()
+
+bool NormSenderNode::OnDecodeTimeout(ProtoTimer& /*theTimer*/)
+{
+    MergeDecodes();
+    if (rx_fec_pool.IsIdle())
+    {
+        decode_timer.Deactivate();
+        return false;
+    }
+    return true;
+}  // end NormSenderNode::OnDecodeTimeout()
+
 bool NormSenderNode::SyncTest(const NormObjectMsg& msg) const
 {
     switch (sync_policy)
@@ -1936,6 +2428,9 @@ void NormSenderNode::AbortObject(NormObject* obj)
         static_cast<NormFileObject*>(obj)->Close();
 #endif // !SIMULATE
     session.Notify(NormController::RX_OBJECT_ABORTED, this, obj);
+    // An incomplete object's relay can't be completed either
+    NormObject* relayObj = obj->GetRelayObject();
+    if (NULL != relayObj) relayObj->GetSession().RelayAbortObject(*relayObj);
     DeleteObject(obj);
     failure_count++;
 }  // end NormSenderNode::AbortObject()
@@ -2388,7 +2883,11 @@ bool NormSenderNode::OnRepairTimeout(ProtoTimer& /*theTimer*/)
                 if (repairPending)
                 {
                     // We weren't completely suppressed, so build NACK
-                    NormNackMsg* nack = static_cast<NormNackMsg*>(session.GetMessageFromPool());
+                    UINT16 payloadMax = 4*SegmentSize();
+                    // If we sync'd to non-DATA, we don't yet know the sender segment_size
+                    if (0 == payloadMax) 
+                        payloadMax = 4*NormNackMsg::DEFAULT_LENGTH_MAX;
+                    NormNackMsg* nack = static_cast<NormNackMsg*>(session.GetMessageFromPool(payloadMax));
                     if (NULL == nack)
                     {
                         PLOG(PL_WARN, "NormSenderNode::OnRepairTimeout() node>%lu Warning! "
@@ -2397,10 +2896,6 @@ bool NormSenderNode::OnRepairTimeout(ProtoTimer& /*theTimer*/)
                         return false;   
                     }
                     nack->Init();
-                    UINT16 payloadMax = 4*SegmentSize();
-                    // If we sync'd to non-DATA, we don't yet know the sender segment_size
-                    if (0 == payloadMax) 
-                        payloadMax = 4*NormNackMsg::DEFAULT_LENGTH_MAX;
                     bool nackAppended = false;
                     
                     if (cc_enable)
@@ -2598,10 +3093,18 @@ bool NormSenderNode::OnRepairTimeout(ProtoTimer& /*theTimer*/)
                         ASSERT(nack->GetRepairContentLength() > 0);
                         if (!session.ReceiverIsSilent())
                         {
+                            // With local repair enabled, NACK rounds alternate between
+                            // site scoped (answered by a local repairer) and session
+                            // scoped ones.  A heard local repair resets this so the
+                            // next round is site scoped again.
+                            local_nack_sent = (0 != session.ReceiverLocalRepairTtl()) &&
+                                              !session.ReceiverIsLocalRepairer() &&
+                                              !unicast_nacks && !local_nack_sent;
                             UINT16 singleNackSize = SegmentSize() ? SegmentSize() : NormNackMsg::DEFAULT_LENGTH_MAX;
+                            NORM_PROBE2(nack_send, (unsigned long)GetId(), nack->GetRepairContentLength());
                             if (nack->GetRepairContentLength() <= singleNackSize)
                             {
-                                session.SendMessage(*nack);
+                                SendNack(*nack);
                                 nack_count++;
                             }
                             else
@@ -2609,6 +3112,7 @@ bool NormSenderNode::OnRepairTimeout(ProtoTimer& /*theTimer*/)
                                 FragmentNack(*nack);
                             }
                         }
+                        MarkRepairWait();
                         session.ReturnMessageToPool(nack);
                     }
                     else
@@ -2627,6 +3131,7 @@ bool NormSenderNode::OnRepairTimeout(ProtoTimer& /*theTimer*/)
                     if (!session.ReceiverIsSilent())
                     {
                         suppress_count++;
+                        MarkRepairWait();
                         PLOG(PL_DEBUG, "NormSenderNode::OnRepairTimeout() node>%lu sender>%lu NACK SUPPRESSED ...\n",
                                         (unsigned long)LocalNodeId(), (unsigned long)GetId());
                     }
@@ -2678,7 +3183,8 @@ void NormSenderNode::FragmentNack(NormNackMsg& superNack)
     // Parse a "super" NACK and refactor it into a series of smaller
     // NACK messages as needed (per "segment_size" constraint)
     // and send them.
-    NormNackMsg* nack = (NormNackMsg*)session.GetMessageFromPool();
+    UINT16 nackMax = SegmentSize() ? SegmentSize() : NormNackMsg::DEFAULT_LENGTH_MAX;
+    NormNackMsg* nack = (NormNackMsg*)session.GetMessageFromPool(nackMax);
     if (!nack)
     {
         PLOG(PL_WARN, "NormSenderNode::FragmentNack() node>%lu Warning! "
@@ -2700,71 +3206,54 @@ void NormSenderNode::FragmentNack(NormNackMsg& superNack)
     {
         const UINT16 REQ_HDR_LEN = 4;  // TBD - get from normMessage.h instead
         requestOffset += requestLength;
-        if ((payloadLength + requestLength) <= SegmentSize())
+        if ((payloadLength + requestLength) <= nackMax)
         {
             // Copy whole request over
             nack->AppendRepairRequest(superReq);
             payloadLength += requestLength;
+            continue;
         }
-        else if ((payloadLength + REQ_HDR_LEN) < SegmentSize())
+        // Split the request on item (or range) boundaries, copying
+        // as many whole items as fit into each NACK in one go
+        NormRepairRequest::Form requestForm = superReq.GetForm();
+        UINT16 itemLength = (NormRepairRequest::RANGES == requestForm) ?
+                                NormRepairRequest::RepairRangeLength(fec_id) :
+                                NormRepairRequest::RepairItemLength(fec_id);
+        UINT16 itemTotal = requestLength - REQ_HDR_LEN;
+        UINT16 itemOffset = 0;
+        while (itemOffset < itemTotal)
         {
-            // Duplicate request and add individual repair items
-            NormRepairRequest::Form requestForm = superReq.GetForm();
-            NormRepairRequest req;
-            nack->AttachRepairRequest(req, SegmentSize());
-            req.SetForm(requestForm);
-            req.SetFlags(superReq.GetFlags());
-            payloadLength += REQ_HDR_LEN;
-            
-            NormRepairRequest::Iterator iterator(superReq, fec_id, fti_data.GetFecFieldSize());
-            NormObjectId objectId, lastObjectId;
-            NormBlockId blockId, lastBlockId;
-            UINT16  blockLen, lastBlockLen;
-            NormSegmentId segmentId, lastSegmentId;
-            UINT16 itemLength;
-            while (0 != (itemLength = iterator.NextRepairItem(&objectId, &blockId, &blockLen, &segmentId)))
-            {
-                if (NormRepairRequest::RANGES == requestForm)
-                {
-                    itemLength += iterator.NextRepairItem(&lastObjectId, &lastBlockId, 
-                                                          &lastBlockLen, &lastSegmentId);
-                }
-                if ((payloadLength + itemLength) > SegmentSize())
-                {
-                    // We have filled the NACK, so pack, send, and reset request
-                    nack->PackRepairRequest(req);
-                    session.SendMessage(*nack);
-                    nack_count++;
-                    nack->ResetPayload();
-                    nack->AttachRepairRequest(req, SegmentSize());
-                    payloadLength = REQ_HDR_LEN;
-                }
-                if (NormRepairRequest::RANGES == requestForm)
+            if ((payloadLength + REQ_HDR_LEN + itemLength) > nackMax)
+            {
+                if (0 == payloadLength)
                 {
-                    req.AppendRepairRange(fec_id, fti_data.GetFecFieldSize(), objectId, blockId, blockLen, segmentId,
-                                          lastObjectId, lastBlockId, lastBlockLen, lastSegmentId);
+                    PLOG(PL_ERROR, "NormSenderNode::FragmentNack() node>%lu error: segment size too small for NACK\n",
+                                   (unsigned long)LocalNodeId());
+                    break;
                 }
-                else
-                {
-                    req.AppendRepairItem(fec_id, fti_data.GetFecFieldSize(), objectId, blockId, blockLen, segmentId);
-                }   
-                payloadLength += itemLength;
+                // We have filled the NACK, so send and reset it
+                SendNack(*nack);
+                nack_count++;
+                nack->ResetPayload();
+                payloadLength = 0;
+                continue;
             }
-            nack->PackRepairRequest(req);
-            ASSERT(nack->GetRepairContentLength() == payloadLength);
-        }
-        else
-        {
-            session.SendMessage(*nack);
-            nack_count++;
-            nack->ResetPayload();
-            payloadLength = 0;
+            UINT16 numBytes = ((nackMax - payloadLength - REQ_HDR_LEN) / itemLength) * itemLength;
+            if (numBytes > (itemTotal - itemOffset)) numBytes = itemTotal - itemOffset;
+            NormRepairRequest req;
+            nack->AttachRepairRequest(req, nackMax);
+            req.SetForm(requestForm);
+            req.SetFlags(superReq.GetFlags());
+            req.AppendRepairContent(superReq, itemOffset, numBytes);
+            payloadLength += nack->PackRepairRequest(req);
+            itemOffset += numBytes;
         }
+        ASSERT(nack->GetRepairContentLength() == payloadLength);
     }
     if (0 != payloadLength)
     {
         ASSERT(nack->GetRepairContentLength() == payloadLength);
-        session.SendMessage(*nack);
+        SendNack(*nack);
         nack_count++;
     }
     session.ReturnMessageToPool(nack);
@@ -2801,6 +3290,8 @@ void NormSenderNode::UpdateRecvRate(const struct timeval& currentTime, unsigned
                 recv_rate = recv_rate_prev = currentRecvRate; 
                 prev_update_time = currentTime;
                 recv_accumulator.Reset();
+                if (session.GetAutoTune())
+                    session.ReceiverAutoTune(recv_rate * grtt_estimate);
             }
             else if (0.0 == recv_rate)
             {
@@ -2865,7 +3356,7 @@ void NormSenderNode::Activate(bool isObjectMsg)
     }
 }  // end NormSenderNode::Activate()
 
-bool NormSenderNode::OnActivityTimeout(ProtoTimer& /*theTimer*/)
+bool NormSenderNode::OnActivityTimeout(NormTimerWheel::Timer& /*theTimer*/)
 {
     if (sender_active)
     {
@@ -2918,7 +3409,8 @@ bool NormSenderNode::UpdateLossEstimate(const struct timeval& currentTime,
                                         unsigned short        seq, 
                                         bool                  ecnStatus)
 {
-    if (loss_estimator.Update(currentTime, seq, ecnStatus))
+    // (local rx socket drops may be excluded from the loss estimate)
+    if (loss_estimator.Update(currentTime, seq, ecnStatus, session.ReceiverDropExcuse(currentTime)))
     {
         if (slow_start)
         {
@@ -3098,15 +3590,26 @@ bool NormSenderNode::OnAckTimeout(ProtoTimer& /*theTimer*/)
     // Build and send NORM_ACK(FLUSH)
     if (ack_ex_pending)
         return true;  // Will acknowledge when application services RX_ACK_REQUEST notification
-    NormAckFlushMsg* ack = (NormAckFlushMsg*)session.GetMessageFromPool();
-    if (NULL != ack)
+    // An aggregator's collected ACKs may take more than one message
+    bool aggregate = session.ReceiverIsAckAggregator() && !ack_via_aggregator && agg_valid &&
+                     (0 != agg_count) && (watermark_object_id == agg_object_id) &&
+                     (watermark_block_id == agg_block_id) && (watermark_segment_id == agg_segment_id);
+    unsigned int aggIndex = 0;
+    do
     {
+        bool firstAck = (0 == aggIndex);
+        NormAckFlushMsg* ack = (NormAckFlushMsg*)session.GetMessageFromPool();
+        if (NULL == ack)
+        {
+            PLOG(PL_WARN, "NormSenderNode::OnAckTimeout() warning: message pool exhausted!\n");
+            break;
+        }
         ack->Init();
         ack->SetSenderId(GetId());
         ack->SetInstanceId(instance_id);
         ack->SetAckType(NormAck::FLUSH);
         ack->SetAckId(0);
-        AttachCCFeedback(*ack);
+        if (firstAck) AttachCCFeedback(*ack);
         if (0 != ack_ex_length)
         {
             NormAppAckExtension ext;
@@ -3114,6 +3617,8 @@ bool NormSenderNode::OnAckTimeout(ProtoTimer& /*theTimer*/)
             ext.SetContent(ack_ex_buffer, ack_ex_length);
             ack->PackExtension(ext);
         }
+        if (aggregate && !AppendAggregate(*ack, aggIndex))
+            aggregate = false;
         
         ack->SetObjectId(watermark_object_id);
         
@@ -3129,7 +3634,9 @@ bool NormSenderNode::OnAckTimeout(ProtoTimer& /*theTimer*/)
         
         ack->SetFecPayloadId(fec_id, watermark_block_id.GetValue(), watermark_segment_id, blockLen, fti_data.GetFecFieldSize());
         
-        if (unicast_nacks)
+        if (ack_via_aggregator)
+            ack->SetDestination(session.ReceiverAckAggregatorAddress());
+        else if (unicast_nacks)
             ack->SetDestination(GetAddress());
         else
             ack->SetDestination(session.Address());
@@ -3138,7 +3645,7 @@ bool NormSenderNode::OnAckTimeout(ProtoTimer& /*theTimer*/)
 	    if (session.SendMessage(*ack))
 	    {
             ack_pending = false;
-            if (0 == session.GetProbeTOS())  // Always send NormAck(CC) for special TOS case
+            if (firstAck && (0 == session.GetProbeTOS()))  // Always send NormAck(CC) for special TOS case
             {
                 cc_feedback_needed = false;
                 if (cc_enable && !is_clr && !is_plr && session.Address().IsMulticast())
@@ -3161,21 +3668,102 @@ bool NormSenderNode::OnAckTimeout(ProtoTimer& /*theTimer*/)
         {
             // TBD - should we queue the message so it can get a send retry?
             PLOG(PL_ERROR, "NormSenderNode::OnAckTimeout() error: SendMessage(ack) failure\n");
+            aggregate = false;
         }
 	    session.ReturnMessageToPool(ack);
+    } while (aggregate && (aggIndex < agg_count));
+    return true;
+}  // end NormSenderNode::OnAckTimeout()
+
+void NormSenderNode::AggregateReset(NormObjectId objectId, NormBlockId blockId, NormSegmentId segmentId)
+{
+    agg_object_id = objectId;
+    agg_block_id = blockId;
+    agg_segment_id = segmentId;
+    agg_count = 0;
+    agg_valid = true;
+}  // end NormSenderNode::AggregateReset()
+
+// An ACK aggregator records the members' watermark ACKs it receives
+void NormSenderNode::AggregateAck(const NormAckFlushMsg& ack)
+{
+    if (!agg_valid || (ack.GetFecId() != fec_id) || (ack.GetObjectId() != agg_object_id) ||
+        (ack.GetFecBlockId(fti_data.GetFecFieldSize()) != agg_block_id) ||
+        (ack.GetFecSymbolId(fti_data.GetFecFieldSize()) != agg_segment_id))
+    {
+        PLOG(PL_DEBUG, "NormSenderNode::AggregateAck() node>%lu sender>%lu ignoring ACK for other watermark\n",
+                        (unsigned long)LocalNodeId(), (unsigned long)GetId());
+        return;
     }
-    else
+    NormNodeId nodeId = ack.GetSourceId();
+    if ((nodeId == LocalNodeId()) || (NORM_NODE_NONE == nodeId) || (NORM_NODE_ANY == nodeId)) return;
+    // Binary search for the sorted insertion point
+    unsigned int lo = 0;
+    unsigned int hi = agg_count;
+    while (lo < hi)
+    {
+        unsigned int mid = (lo + hi) >> 1;
+        if (agg_list[mid] < nodeId)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if ((lo < agg_count) && (agg_list[lo] == nodeId)) return;  // (already have it)
+    if (agg_count == agg_size)
+    {
+        unsigned int newSize = (0 != agg_size) ? (2*agg_size) : 32;
+        NormNodeId* newList = new NormNodeId[newSize];
+        if (NULL == newList)
+        {
+            PLOG(PL_ERROR, "NormSenderNode::AggregateAck() new agg_list error: %s\n", GetErrorString());
+            return;
+        }
+        if (0 != agg_count) memcpy(newList, agg_list, agg_count*sizeof(NormNodeId));
+        if (NULL != agg_list) delete[] agg_list;
+        agg_list = newList;
+        agg_size = newSize;
+    }
+    memmove(agg_list + lo + 1, agg_list + lo, (agg_count - lo)*sizeof(NormNodeId));
+    agg_list[lo] = nodeId;
+    agg_count++;
+}  // end NormSenderNode::AggregateAck()
+
+// Appends as much of the aggregated ACK list from "index" as fits to "ack"
+bool NormSenderNode::AppendAggregate(NormAckFlushMsg& ack, unsigned int& index)
+{
+    // (the NORM header length is limited to 255 words)
+    int wordsMax = 255 - (ack.GetHeaderLength() >> 2) - 1;
+    if (wordsMax < 2) return false;
+    NormAckAggregateExtension ext;
+    ack.AttachExtension(ext);
+    unsigned int pairMax = (unsigned int)(wordsMax >> 1);
+    unsigned int pairCount = 0;
+    while ((index < agg_count) && (pairCount < pairMax))
     {
-        PLOG(PL_WARN, "NormSenderNode::OnAckTimeout() warning: message pool exhausted!\n");
+        unsigned int pairStart = index;
+        NormNodeId baseId = agg_list[index];
+        UINT32 mask = 0;
+        while ((index < agg_count) && ((agg_list[index] - baseId) < 32))
+            mask |= ((UINT32)0x80000000 >> (agg_list[index++] - baseId));
+        if (!ext.AppendPair(baseId, mask))
+        {
+            index = pairStart;
+            break;
+        }
+        pairCount++;
     }
+    // (an empty extension isn't packed, so the header isn't extended)
+    if (0 == pairCount) return false;
+    ack.PackExtension(ext);
     return true;
-}  // end NormSenderNode::OnAckTimeout()
+}  // end NormSenderNode::AppendAggregate()
 
 
 NormAckingNode::NormAckingNode(class NormSession& theSession, NormNodeId nodeId)
  : NormNode(ACKER, theSession, nodeId), 
    ack_received(false), req_count(theSession.GetTxRobustFactor()),
-   ack_ex_buffer(NULL), ack_ex_length(0)
+   pipeline_ack_mask(0), ack_ex_buffer(NULL), ack_ex_length(0),
+   aggregator_id(NORM_NODE_NONE), flush_serial(0)
     
 {
 }
@@ -3235,7 +3823,7 @@ bool NormAckingNode::GetAckEx(char* buffer, unsigned int* buflen)
 }  // end NormAckingNode::GetAckEx()
 
 NormNodeTree::NormNodeTree()
- : root(NULL)
+ : root(NULL), hash_table(NULL), hash_bits(0), hash_size(0), hash_count(0)
 {
 
 }
@@ -3243,11 +3831,102 @@ NormNodeTree::NormNodeTree()
 NormNodeTree::~NormNodeTree()
 {
     Destroy();
+    if (NULL != hash_table)
+    {
+        delete[] hash_table;
+        hash_table = NULL;
+    }
 }
 
+bool NormNodeTree::HashResize(unsigned int numBits)
+{
+    unsigned int newSize = 1 << numBits;
+    NormNode** newTable = new NormNode*[newSize];
+    if (NULL == newTable)
+    {
+        PLOG(PL_ERROR, "NormNodeTree::HashResize() new hash_table error: %s\n", GetErrorString());
+        return false;
+    }
+    memset(newTable, 0, newSize * sizeof(NormNode*));
+    NormNode** oldTable = hash_table;
+    unsigned int oldSize = hash_size;
+    hash_table = newTable;
+    hash_bits = numBits;
+    hash_size = newSize;
+    hash_count = 0;
+    for (unsigned int i = 0; i < oldSize; i++)
+    {
+        if (NULL != oldTable[i]) HashInsert(oldTable[i]);
+    }
+    if (NULL != oldTable) delete[] oldTable;
+    return true;
+}  // end NormNodeTree::HashResize()
+
+bool NormNodeTree::HashInsert(NormNode* node)
+{
+    // Keep load factor at or below 1/2
+    if (2*(hash_count + 1) > hash_size)
+    {
+        unsigned int numBits = (0 != hash_bits) ? (hash_bits + 1) : 6;  // (HASH_SIZE_MIN)
+        if (!HashResize(numBits))
+        {
+            // Fall back to tree search
+            if (NULL != hash_table) delete[] hash_table;
+            hash_table = NULL;
+            hash_bits = hash_size = hash_count = 0;
+            return false;
+        }
+    }
+    unsigned int index = HashIndex(node->id);
+    while (NULL != hash_table[index])
+        index = (index + 1) & (hash_size - 1);
+    hash_table[index] = node;
+    hash_count++;
+    return true;
+}  // end NormNodeTree::HashInsert()
+
+void NormNodeTree::HashRemove(NormNode* node)
+{
+    if (NULL == hash_table) return;
+    unsigned int mask = hash_size - 1;
+    unsigned int index = HashIndex(node->id);
+    while (node != hash_table[index])
+    {
+        if (NULL == hash_table[index]) return;  // not found?!
+        index = (index + 1) & mask;
+    }
+    // Backward shift deletion: move later entries of the probe
+    // sequence into the hole so no "tombstones" are needed
+    unsigned int hole = index;
+    index = (index + 1) & mask;
+    while (NULL != hash_table[index])
+    {
+        unsigned int home = HashIndex(hash_table[index]->id);
+        // Move the entry if its home isn't cyclically in (hole, index]
+        if (((index - home) & mask) >= ((index - hole) & mask))
+        {
+            hash_table[hole] = hash_table[index];
+            hole = index;
+        }
+        index = (index + 1) & mask;
+    }
+    hash_table[hole] = NULL;
+    hash_count--;
+}  // end NormNodeTree::HashRemove()
 
 NormNode *NormNodeTree::FindNodeById(NormNodeId nodeId) const
 {
+    if (NULL != hash_table)
+    {
+        unsigned int index = HashIndex(nodeId);
+        NormNode* x;
+        while (NULL != (x = hash_table[index]))
+        {
+            if (nodeId == x->id) return x;
+            index = (index + 1) & (hash_size - 1);
+        }
+        return NULL;
+    }
     NormNode* x = root;
     while(x && (x->id != nodeId))
     {
@@ -3267,6 +3946,9 @@ void NormNodeTree::AttachNode(NormNode *node)
     node->Retain();
     node->left = NULL;
     node->right = NULL;
+    // The hash index is (re)built on the first attach (or after any
+    // allocation failure once the tree has been emptied)
+    if ((NULL != hash_table) || (NULL == root)) HashInsert(node);
     NormNode *x = root;
     while (x)
     {
@@ -3304,6 +3986,7 @@ void NormNodeTree::AttachNode(NormNode *node)
 void NormNodeTree::DetachNode(NormNode* node)
 {
     ASSERT(NULL != node);
+    HashRemove(node);
     NormNode* x;
     NormNode* y;
     if (!node->left || !node->right)
@@ -3638,7 +4321,8 @@ int NormLossEstimator2::SequenceDelta(unsigned short a, unsigned short b)
 
 bool NormLossEstimator2::Update(const struct timeval&   currentTime,
                                 unsigned short          theSequence, 
-                                bool                    ecnStatus)
+                                bool                    ecnStatus,
+                                unsigned int*           excuseCount)
 {
     // (TBD) What if the first packet that arrives has ECN set???
     if (!init) 
@@ -3710,6 +4394,13 @@ bool NormLossEstimator2::Update(const struct timeval&   currentTime,
         return false;                    // Duplicate packet arrived, ignore
     }        
     
+    if ((NULL != excuseCount) && (0 != outageDepth))
+    {
+        unsigned int excused = MIN(outageDepth, *excuseCount);
+        outageDepth -= excused;
+        *excuseCount -= excused;
+    }
+    
     if (ignore_loss) outageDepth = 0;
     
     if (ecnStatus) outageDepth += 1;
@@ -3834,3 +4525,185 @@ double NormLossEstimator2::LossFraction()
     
     return result;
 }  // end NormLossEstimator2::LossFraction()
+
+const double NormBandwidthModel::STARTUP_GAIN = 2.885;  // (2/ln(2))
+const double NormBandwidthModel::MIN_RTT_WINDOW = 10.0;
+const double NormBandwidthModel::PROBE_RTT_DURATION = 0.2;
+const double NormBandwidthModel::QUEUE_RTT_FACTOR = 1.25;
+const double NormBandwidthModel::PROBE_BW_GAIN[PROBE_BW_PHASES] =
+    {1.25, 0.75, 1.0, 1.0, 1.0, 1.0, 1.0, 1.0};
+
+NormBandwidthModel::NormBandwidthModel()
+{
+    Reset();
+}
+
+void NormBandwidthModel::Reset()
+{
+    state = STARTUP;
+    state_start = 0.0;
+    pacing_gain = STARTUP_GAIN;
+    btl_bw = 0.0;
+    for (unsigned int i = 0; i < 3; i++)
+        bw_sample[i].value = bw_sample[i].time = 0.0;
+    min_rtt = -1.0;
+    min_rtt_time = 0.0;
+    round_start = 0.0;
+    full_bw = 0.0;
+    full_bw_count = 0;
+    filled_pipe = false;
+    cycle_index = 0;
+    cycle_start = 0.0;
+}  // end NormBandwidthModel::Reset()
+
+void NormBandwidthModel::EnterState(State newState, double now)
+{
+    state = newState;
+    state_start = now;
+    switch (newState)
+    {
+        case STARTUP:
+            pacing_gain = STARTUP_GAIN;
+            break;
+        case DRAIN:
+            pacing_gain = 1.0 / STARTUP_GAIN;
+            break;
+        case PROBE_BW:
+            cycle_index = 0;
+            cycle_start = now;
+            pacing_gain = PROBE_BW_GAIN[0];
+            break;
+        case PROBE_RTT:
+            // (without a congestion window, half rate lets the queue drain)
+            pacing_gain = 0.5;
+            break;
+    }
+    PLOG(PL_DEBUG, "NormBandwidthModel::EnterState() state>%d btlBw>%lf kbps minRtt>%lf\n",
+                   (int)newState, 8.0e-03*btl_bw, min_rtt);
+}  // end NormBandwidthModel::EnterState()
+
+void NormBandwidthModel::Update(double now, double rtt, double rate)
+{
+    if (rtt > 0.0)
+    {
+        bool minRttExpired = (min_rtt > 0.0) && ((now - min_rtt_time) > MIN_RTT_WINDOW);
+        if ((min_rtt < 0.0) || (rtt <= min_rtt) || minRttExpired)
+        {
+            min_rtt = rtt;
+            min_rtt_time = now;
+        }
+        if (minRttExpired && (PROBE_RTT != state))
+            EnterState(PROBE_RTT, now);
+    }
+    if (rate > 0.0) UpdateBtlBw(now, rate);
+    if (min_rtt <= 0.0) return;
+    
+    bool newRound = ((now - round_start) >= min_rtt);
+    if (newRound) round_start = now;
+    switch (state)
+    {
+        case STARTUP:
+            // The pipe is full once the bandwidth estimate stops
+            // growing (by 25%) for a few rounds
+            if (newRound && IsValid())
+            {
+                if (btl_bw >= (1.25 * full_bw))
+                {
+                    full_bw = btl_bw;
+                    full_bw_count = 0;
+                }
+                else if (++full_bw_count >= FULL_BW_ROUNDS)
+                {
+                    filled_pipe = true;
+                    EnterState(DRAIN, now);
+                }
+            }
+            break;
+        case DRAIN:
+            // Without an inflight count, the RTT tells when the queue
+            // STARTUP built is gone (with a limit in case it never settles)
+            if ((rtt <= (QUEUE_RTT_FACTOR * min_rtt)) || 
+                ((now - state_start) >= (DRAIN_ROUNDS_MAX * min_rtt)))
+            {
+                EnterState(PROBE_BW, now);
+            }
+            break;
+        case PROBE_BW:
+        {
+            // Each phase lasts a round, but the "drain" (gain < 1) phase
+            // is held a few rounds longer while the RTT still shows a queue
+            double elapsed = now - cycle_start;
+            bool queued = (pacing_gain < 1.0) && (rtt > (QUEUE_RTT_FACTOR * min_rtt));
+            if ((elapsed >= min_rtt) && (!queued || (elapsed >= (DRAIN_ROUNDS_MAX * min_rtt))))
+            {
+                cycle_index = (cycle_index + 1) % PROBE_BW_PHASES;
+                cycle_start = now;
+                pacing_gain = PROBE_BW_GAIN[cycle_index];
+            }
+            break;
+        }
+        case PROBE_RTT:
+        {
+            double duration = MAX(PROBE_RTT_DURATION, min_rtt);
+            if ((now - state_start) >= duration)
+            {
+                min_rtt_time = now;  // (min_rtt is now refreshed)
+                EnterState(filled_pipe ? PROBE_BW : STARTUP, now);
+            }
+            break;
+        }
+    }
+}  // end NormBandwidthModel::Update()
+
+// A running max over a window of BW_WINDOW_ROUNDS min RTTs, keeping the
+// best, 2nd best and 3rd best samples of successive sub-windows
+void NormBandwidthModel::UpdateBtlBw(double now, double rate)
+{
+    double window = (min_rtt > 0.0) ? (BW_WINDOW_ROUNDS * min_rtt) : 1.0;
+    Sample sample;
+    sample.value = rate;
+    sample.time = now;
+    if ((rate >= bw_sample[0].value) || ((now - bw_sample[2].time) > window))
+    {
+        bw_sample[0] = bw_sample[1] = bw_sample[2] = sample;
+    }
+    else
+    {
+        if (rate >= bw_sample[1].value)
+            bw_sample[2] = bw_sample[1] = sample;
+        else if (rate >= bw_sample[2].value)
+            bw_sample[2] = sample;
+        double elapsed = now - bw_sample[0].time;
+        if (elapsed > window)
+        {
+            // The best sample aged out, so promote the others
+            bw_sample[0] = bw_sample[1];
+            bw_sample[1] = bw_sample[2];
+            bw_sample[2] = sample;
+            if ((now - bw_sample[0].time) > window)
+            {
+                bw_sample[0] = bw_sample[1];
+                bw_sample[1] = bw_sample[2];
+            }
+        }
+        else if ((bw_sample[1].time == bw_sample[0].time) && (elapsed > (0.25 * window)))
+        {
+            bw_sample[2] = bw_sample[1] = sample;
+        }
+        else if ((bw_sample[2].time == bw_sample[1].time) && (elapsed > (0.5 * window)))
+        {
+            bw_sample[2] = sample;
+        }
+    }
+    btl_bw = bw_sample[0].value;
+}  // end NormBandwidthModel::UpdateBtlBw()
+
+void NormBandwidthModel::LimitBtlBw(double rate)
+{
+    for (unsigned int i = 0; i < 3; i++)
+    {
+        if (bw_sample[i].value > rate)
+            bw_sample[i].value = rate;
+    }
+    if (btl_bw > rate) btl_bw = rate;
+}  // end NormBandwidthModel::LimitBtlBw()
@@ -1,11 +1,15 @@
 #include "normObject.h"
 #include "normSession.h"
+#include "normDigest.h"
+#include "normGFKernel.h"  // for stream window repair coding
+#include "galois.h"
 
 #ifndef _WIN32_WCE
 #include <fcntl.h>
 #include <sys/types.h>
 #include <sys/stat.h>
 #endif // !_WIN32_WCE
+#include <time.h>  // for time()
 
 NormObject::NormObject(NormObject::Type      theType, 
                        class NormSession&    theSession, 
@@ -15,7 +19,8 @@ NormObject::NormObject(NormObject::Type      theType,
    transport_id(transportId), segment_size(0), pending_info(false), repair_info(false),
    current_block_id(0), next_segment_id(0), 
    max_pending_block(0), max_pending_segment(0),
-   info_ptr(NULL), info_len(0), first_pass(true), accepted(false), notify_on_update(true),
+   tx_weight(1), latency_pending(false), relay_source(NULL), relay_object(NULL), info_ptr(NULL), info_len(0), parity_key(0), 
+   digest_status(DIGEST_NONE), digest(0), digest_sum(0), digest_block(0), digest_segment(0), first_pass(true), info_sent(false), accepted(false), notify_on_update(true),
    user_data(NULL)
 #ifndef USE_PROTO_TREE
    , next(NULL)
@@ -229,6 +234,13 @@ bool NormObject::Open(const NormObjectSize& objectSize,
             objectSize - (numSegments - NormObjectSize((UINT32)1))*segmentSize;
         ASSERT(0 == finalSegmentSize.MSB());
         final_segment_size = finalSegmentSize.LSB();
+        if ((NULL != sender) && session.RcvrIsProgressive() &&
+            !completed_blocks.Init(numBlocks.LSB()))
+        {
+            PLOG(PL_FATAL, "NormObject::Open() completed_blocks.Init() error\n");
+            Close();
+            return false;
+        }
     }
     
     object_size = objectSize;
@@ -258,9 +270,158 @@ void NormObject::Close()
     repair_mask.Destroy();
     pending_mask.Destroy();
     block_buffer.Destroy();
+    completed_blocks.Destroy();
+    RelayClose();
     segment_size = 0;
 }  // end NormObject::Close()
 
+NormObjectSize NormObject::GetBlockOffset(NormBlockId blockId) const
+{
+    NormObjectSize largeBlockBytes = NormObjectSize(large_block_size) * 
+                                     NormObjectSize(segment_size);
+    UINT32 index = blockId.GetValue();
+    if (index < large_block_count)
+        return (largeBlockBytes * NormObjectSize((NormObjectSize::Offset)index));
+    NormObjectSize smallBlockBytes = NormObjectSize(small_block_size) * 
+                                     NormObjectSize(segment_size);
+    return (largeBlockBytes * NormObjectSize((NormObjectSize::Offset)large_block_count) +
+            smallBlockBytes * NormObjectSize((NormObjectSize::Offset)(index - large_block_count)));
+}  // end NormObject::GetBlockOffset()
+
+NormObjectSize NormObject::GetBlockLength(NormBlockId blockId) const
+{
+    if (blockId == final_block_id)
+        return (object_size - GetBlockOffset(blockId));
+    else
+        return (NormObjectSize(GetBlockSize(blockId)) * NormObjectSize(segment_size));
+}  // end NormObject::GetBlockLength()
+
+void NormObject::ReceiverBlockCompleted(NormBlockId blockId)
+{
+#ifndef SIMULATE
+    if (FILE == type) static_cast<NormFileObject*>(this)->JournalBlock(blockId);
+#endif // !SIMULATE
+    if (NULL != relay_object)
+        relay_object->GetSession().RelayBlockCompleted(*relay_object, blockId);
+    if (completed_blocks.Set(blockId.GetValue()))
+        session.Notify(NormController::RX_OBJECT_BLOCK_COMPLETED, sender, this);
+}  // end NormObject::ReceiverBlockCompleted()
+
+// A sender using digests puts the extension in all of the object's messages,
+// so the first message received tells whether to digest the object (and
+// a DIGEST_PENDING one's later messages give the digest value)
+void NormObject::ReceiverGetDigest(const NormObjectMsg& msg)
+{
+    NormDigestExtension ext;
+    if (!msg.FindExtension(NormHeaderExtension::DIGEST, ext)) 
+    {
+        // (so the object's other messages aren't searched too)
+        if (DIGEST_NONE == digest_status) digest_status = DIGEST_ABSENT;
+        return;
+    }
+    if (ext.IsValid() && (NormDigest::CRC32C == ext.GetAlgorithm()))
+    {
+        if (ext.IsPending())
+        {
+            digest_status = DIGEST_PENDING;  // (segments are digested meanwhile)
+        }
+        else
+        {
+            digest = ext.GetDigest();
+            digest_status = DIGEST_SET;
+        }
+    }
+    else
+    {
+        PLOG(PL_WARN, "NormObject::ReceiverGetDigest() node>%lu sender>%lu obj>%hu "
+                      "warning: unsupported digest (not verified)\n", (unsigned long)LocalNodeId(), 
+                      (unsigned long)sender->GetId(), (UINT16)transport_id);
+        digest_status = DIGEST_IGNORED;
+    }
+}  // end NormObject::ReceiverGetDigest()
+
+void NormObject::ReceiverDigestSegment(NormBlock* block, NormSegmentId segmentId, const char* buffer)
+{
+    if ((DIGEST_SET != digest_status) && (DIGEST_PENDING != digest_status)) return;
+    NormBlockId blockId = block->GetId();
+    block->AddDigest(NormDigest::SegmentDigest(blockId.GetValue(), segmentId, buffer, 
+                                               GetSegmentLength(blockId, segmentId)));
+}  // end NormObject::ReceiverDigestSegment()
+
+// Makes this (just opened) tx object a relay of "source", with nothing 
+// tx pending until source blocks complete
+bool NormObject::RelayOpen(NormObject& source)
+{
+    ASSERT((NULL == sender) && (NULL == relay_source));
+    UINT32 numBlocks = pending_mask.GetSize();
+    if (!relay_ready.Init(numBlocks))
+    {
+        PLOG(PL_FATAL, "NormObject::RelayOpen() relay_ready.Init() error\n");
+        return false;
+    }
+    pending_mask.Clear();
+    source.Retain();
+    relay_source = &source;
+    source.relay_object = this;
+    // The content (and its segmentation) is the source's, so is its digest
+    // (a DIGEST_PENDING source's value is picked up once it arrives)
+    if (source.HasDigest() || (DIGEST_PENDING == source.digest_status))
+        digest_status = source.digest_status;
+    else
+        digest_status = DIGEST_NONE;
+    digest = source.GetDigest();
+    return true;
+}  // end NormObject::RelayOpen()
+
+bool NormObject::RelaySetReady(NormBlockId blockId)
+{
+    if (!relay_ready.Set(blockId.GetValue())) return false;
+    pending_mask.Set(blockId.GetValue());
+    return true;
+}  // end NormObject::RelaySetReady()
+
+bool NormObject::RelayIsComplete() const
+{
+    UINT32 index = 0;
+    return (!IsRelay() || !relay_ready.GetNextUnset(index));
+}  // end NormObject::RelayIsComplete()
+
+// Unsets tx pending blocks the relay source hasn't completed yet
+void NormObject::RelayMaskPending()
+{
+    if (!IsRelay()) return;
+    UINT32 index = 0;
+    while (relay_ready.GetNextUnset(index))
+    {
+        pending_mask.Unset(index);
+        index++;
+    }
+}  // end NormObject::RelayMaskPending()
+
+void NormObject::RelayClose()
+{
+    // (a closed source object's relay still holds it and keeps 
+    // sending the blocks it has of its data)
+    relay_object = NULL;
+    if (NULL != relay_source)
+    {
+        NormObject* source = relay_source;
+        relay_source = NULL;
+        if (this == source->relay_object) 
+            source->relay_object = NULL;
+        source->Release();
+    }
+}  // end NormObject::RelayClose()
+
+bool NormObject::ReceiverGetCompletedBlock(NormBlockId& blockId)
+{
+    UINT32 index;
+    if (!completed_blocks.GetFirstSet(index)) return false;
+    completed_blocks.Unset(index);
+    blockId = NormBlockId(index);
+    return true;
+}  // end NormObject::ReceiverGetCompletedBlock()
+
 NormObjectSize NormObject::GetBytesPending() const
 {
     NormBlockId nextId;
@@ -359,7 +520,8 @@ bool NormObject::HandleBlockRequest(const NormBlockId& firstId, const NormBlockI
     NormBlockId nextId = firstId;
     while (Compare(nextId, lastId) <= 0)
     {
-        if (!repair_mask.Test(nextId.GetValue()))
+        // (a relay can't repair blocks its source hasn't completed yet)
+        if (!repair_mask.Test(nextId.GetValue()) && RelayIsReady(nextId))
         {
             // (TBD) these tests can probably go away if everything else is done right
             if (!pending_mask.CanSet(nextId.GetValue()))
@@ -411,6 +573,7 @@ bool NormObject::TxReset(NormBlockId firstBlock, bool requeue)
         //if (blockId >= firstBlock)
         if (Compare(blockId, firstBlock) >= 0)
         {
+            if (block->ParityPending()) session.SenderCollectParity(block);
             increasedRepair |= block->TxReset(GetBlockSize(blockId), 
                                               nparity, 
                                               session.SenderAutoParity(), 
@@ -421,8 +584,10 @@ bool NormObject::TxReset(NormBlockId firstBlock, bool requeue)
     if (requeue) 
     {
         first_pass = true;
+        info_sent = false;
         max_pending_block = 0;
     }
+    RelayMaskPending();
     return increasedRepair;
 }  // end NormObject::TxReset()
 
@@ -440,9 +605,13 @@ bool NormObject::TxResetBlocks(const NormBlockId& firstId, const NormBlockId& la
         }
         NormBlock* block = block_buffer.Find(nextId);
         if (NULL != block) 
+        {
+            if (block->ParityPending()) session.SenderCollectParity(block);
             increasedRepair |= block->TxReset(GetBlockSize(nextId), nparity, autoParity, segment_size);
+        }
         Increment(nextId);
     }
+    RelayMaskPending();
     return increasedRepair;
 }  // end NormObject::TxResetBlocks()
 
@@ -497,7 +666,11 @@ bool NormObject::ActivateRepairs()
             if (pending_mask.CanSet(nextId.GetValue()))
             {
                 NormBlock* block = block_buffer.Find(nextId);
-                if (NULL != block) block->TxReset(GetBlockSize(nextId), nparity, autoParity, segment_size);
+                if (NULL != block) 
+                {
+                    if (block->ParityPending()) session.SenderCollectParity(block);
+                    block->TxReset(GetBlockSize(nextId), nparity, autoParity, segment_size);
+                }
                 pending_mask.Set(nextId.GetValue());
                 repairsActivated = true;
             }
@@ -981,7 +1154,11 @@ bool NormObject::ReceiverRepairCheck(CheckLevel    level,
                         else if (firstPending == blockId)
                         {
                             NormBlock* block = block_buffer.Find(blockId);
-                            if (NULL != block)
+                            if ((NULL != block) && block->DecodePending())
+                            {
+                                // Block is complete, just being decoded by a FEC worker thread
+                            }
+                            else if (NULL != block)
                             {
                                 ASSERT(block->IsPending());
                                 NormSymbolId firstPendingSegment;
@@ -1148,7 +1325,11 @@ bool NormObject::IsRepairPending(bool flush)
             //if (!flush && (nextId > current_block_id)) break;
             if (!flush && (Compare(nextId, current_block_id) > 0)) break;
             NormBlock* block = block_buffer.Find(nextId);
-            if (block)
+            if (block && block->DecodePending())
+            {
+                // Block is complete, just being decoded by a FEC worker thread
+            }
+            else if (block)
             {
                 bool isPending;
                 UINT16 numData = GetBlockSize(nextId);
@@ -1184,6 +1365,10 @@ bool NormObject::AppendRepairRequest(NormNackMsg&   nack,
     NormRepairRequest req;
     bool requestAppended = false;  // is set to true when content added to "nack"
     NormRepairRequest::Form prevForm = NormRepairRequest::INVALID;
+    // SEGMENT requests for consecutive buffered blocks are coalesced into
+    // "segReq" (at most one of "req" and "segReq" is open at a time)
+    NormRepairRequest segReq;
+    NormRepairRequest::Form segForm = NormRepairRequest::INVALID;
     // First iterate over any pending blocks, appending any requests
     NormBlockId nextId;
     bool iterating = GetFirstPending(nextId);
@@ -1227,6 +1412,17 @@ bool NormObject::AppendRepairRequest(NormNackMsg&   nack,
                     nextForm = NormRepairRequest::RANGES;
                     break;
             }  // end switch(reqCount)
+            if ((NormRepairRequest::INVALID != nextForm) && (NormRepairRequest::INVALID != segForm))
+            {
+                // Close open SEGMENT request before this BLOCK request
+                segForm = NormRepairRequest::INVALID;
+                if (0 == nack.PackRepairRequest(segReq))
+                {
+                    PLOG(PL_WARN, "NormObject::AppendRepairRequest() warning: full NACK msg\n");
+                    return requestAppended;
+                }
+                requestAppended = true;
+            }
             if (prevForm != nextForm)
             {
                 if ((NormRepairRequest::INVALID != prevForm) &&
@@ -1281,7 +1477,11 @@ bool NormObject::AppendRepairRequest(NormNackMsg&   nack,
                 // Note our NACK construction is limited by "max_pending_block:max_pending_segment"
                 // based on most recent transmissions from sender
                 bool blockIsPending = false;
-                if (nextId == max_pending_block)
+                if (block->DecodePending())
+                {
+                    // Block is complete, just being decoded by a FEC worker thread
+                }
+                else if (nextId == max_pending_block)
                 {
                     ASSERT(block->IsPending());
                     NormSymbolId firstPending;
@@ -1304,32 +1504,22 @@ bool NormObject::AppendRepairRequest(NormNackMsg&   nack,
                         }
                         requestAppended = true;
                     }
-                    bool blockRequestAppended;
-		            if (flush || (nextId != max_pending_block))
+                    UINT16 numParity = nparity;
+                    if (!flush && (nextId == max_pending_block) && (max_pending_segment < numData))
                     {
-                        blockRequestAppended = 
-                            block->AppendRepairRequest(nack, fec_id, fec_m, numData, nparity, 
-                                                       transport_id, pending_info, payloadMax);
+                        numData = max_pending_segment;
+                        numParity = 0;
                     }
-                    else
+                    if (!block->AppendRepairRequest(nack, segReq, segForm, fec_id, fec_m, numData, numParity, 
+                                                    transport_id, pending_info, payloadMax))
                     {
-                        if (max_pending_segment < numData)
-                        {
-                            blockRequestAppended = 
-                                block->AppendRepairRequest(nack, fec_id, fec_m, max_pending_segment, 0,
-                                                           transport_id, pending_info, payloadMax); 
-                        }
-                        else
-                        {
-                            blockRequestAppended = 
-                                block->AppendRepairRequest(nack, fec_id, fec_m, numData, nparity, 
-                                                           transport_id, pending_info, payloadMax); 
-                        }
-                    }
-                    if (blockRequestAppended)
-		                requestAppended = true;
-                    else  // Must have filled NACK message
+                        // Must have filled NACK message, so pack what did fit
+                        if ((NormRepairRequest::INVALID != segForm) && (0 != nack.PackRepairRequest(segReq)))
+                            requestAppended = true;
                         return requestAppended;
+                    }
+                    // (receivers flag NACKed blocks for NormSenderNode::EVICT_SCORED)
+                    block->SetFlag(NormBlock::IN_REPAIR);
 		            prevForm = NormRepairRequest::INVALID;
                 }
                 consecutiveCount = 0;
@@ -1350,8 +1540,17 @@ bool NormObject::AppendRepairRequest(NormNackMsg&   nack,
         iterating = iterating && (flush || (Compare(nextId, max_pending_block) <= 0));
     }  // end while (iterating || (0 != consecutiveCount))
     
-    // This conditional makes sure any outstanding requests constructed
+    // These conditionals make sure any outstanding requests constructed
     // are packed into the nack message.
+    if (NormRepairRequest::INVALID != segForm)
+    {
+        if (0 == nack.PackRepairRequest(segReq))
+        {
+            PLOG(PL_WARN, "NormObject::AppendRepairRequest() warning: full NACK msg\n");
+            return requestAppended;
+        } 
+        requestAppended = true;
+    }
     if ((NormRepairRequest::INVALID != prevForm) && (NACK_NONE != nacking_mode))
     {
         if (0 == nack.PackRepairRequest(req))
@@ -1386,6 +1585,8 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                                      NormBlockId          blockId,
                                      NormSegmentId        segmentId)
 {
+    if (((DIGEST_NONE == digest_status) || (DIGEST_PENDING == digest_status)) && !IsStream()) 
+        ReceiverGetDigest(msg);
     if (NormMsg::INFO == msgType)
     {
         if (pending_info)
@@ -1435,6 +1636,7 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
         if (STREAM == type)
         {
             stream = static_cast<NormStreamObject*>(this);            
+            stream->ReceiverHandleSync(data, blockId);
             if (!stream->StreamUpdateStatus(blockId))
             {
                 PLOG(PL_WARN, "NormObject::HandleObjectMessage() node:%lu sender:%lu obj>%hu blk>%lu "
@@ -1480,7 +1682,24 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                 block->RxInit(blockId, numData, nparity);
                 block_buffer.Insert(block);
             }
-            if (block->IsPending(segmentId))
+            if ((NULL != stream) && (segmentId == WindowRepairId()))
+            {
+                // Stream sliding window repair (see NormStreamObject::SetWindowRepair())
+                if (0 == stream->ReceiverHandleWindowRepair(block, data)) return;
+                if (0 == block->ErasureCount())
+                {
+                    // OK, we're done with this block
+                    digest_sum += block->GetDigest();
+                    pending_mask.Unset(blockId.GetValue());
+                    block_buffer.Remove(block);
+                    sender->PutFreeBlock(block);
+                    ReceiverBlockCompleted(blockId);
+                }
+                if (notify_on_update && (stream->DetermineReadReadiness() || session.RcvrIsLowDelay()))
+                    stream->PostEvent(NormStreamObject::EVENT_RX_UPDATED);
+                return;
+            }
+            if (block->IsPending(segmentId) && !block->DecodePending())
             {
                 UINT16 segmentLength = data.GetPayloadDataLength();
                 if (segmentLength > segment_size)
@@ -1528,6 +1747,7 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                     block->DecrementErasureCount();
                     if (WriteSegment(blockId, segmentId, data.GetPayload()))
                     {
+                        ReceiverDigestSegment(block, segmentId, data.GetPayload());
                         objectUpdated = true;
                         // For statistics only (TBD) #ifdef NORM_DEBUG
                         sender->IncrementRecvGoodput(segmentLength);
@@ -1546,7 +1766,8 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                 }
                 
                 // 3) Decode block if ready and return to pool
-                if (block->ErasureCount() <= block->ParityCount())
+                //    (unless it's handed off to a FEC decode worker thread)
+                if ((block->ErasureCount() <= block->ParityCount()) && !SubmitBlockDecode(block))
                 {
                     // Decode (if pending_mask.FirstSet() < numData)
                     // and write any decoded data segments to object
@@ -1605,9 +1826,22 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                         }  // end if (nextErasure < numData)
                     }  // end if (block->GetFirstPending(nextErasure))                 
                     
-                    if (erasureCount)
+                    bool blockDecoded = true;
+                    if (erasureCount && (0 == sender->Decode(block->SegmentList(), numData, erasureCount)))
+                    {
+                        // Some codes (e.g., LDPC) may occasionally need more than
+                        // "erasureCount" parity segments, so count a "phantom"
+                        // erasure so one more repair segment is sought and retry
+                        // decoding when it arrives.
+                        PLOG(PL_DEBUG, "NormObject::HandleObjectMessage() node>%lu sender>%lu obj>%hu blk>%lu "
+                                       "decode incomplete, need more parity ...\n", (unsigned long)LocalNodeId(), 
+                                       (unsigned long)sender->GetId(), (UINT16)transport_id, 
+                                       (unsigned long)block->GetId().GetValue());
+                        block->IncrementErasureCount();
+                        blockDecoded = false;
+                    }
+                    else if (erasureCount)
                     {
-                        sender->Decode(block->SegmentList(), numData, erasureCount); 
                         for (UINT16 i = 0; i < erasureCount; i++) 
                         {
                             NormSegmentId sid = sender->GetErasureLoc(i);
@@ -1615,6 +1849,7 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                             {
                                 if (WriteSegment(blockId, sid, block->GetSegment(sid)))
                                 {
+                                    ReceiverDigestSegment(block, sid, block->GetSegment(sid));
                                     objectUpdated = true;
                                     // For statistics only (TBD) #ifdef NORM_DEBUG
                                     // "segmentLength" is not necessarily correct here (TBD - fix this)
@@ -1637,21 +1872,30 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                     // Clear any temporarily retrieved segments for the block
                     for (UINT16 i = 0; i < retrievalCount; i++) 
                         block->DetachSegment(sender->GetRetrievalLoc(i));
-                    // OK, we're done with this block
-                    pending_mask.Unset(blockId.GetValue());
-                    block_buffer.Remove(block);
-                    sender->PutFreeBlock(block); 
+                    if (blockDecoded)
+                    {
+                        // OK, we're done with this block
+                        digest_sum += block->GetDigest();
+                        pending_mask.Unset(blockId.GetValue());
+                        block_buffer.Remove(block);
+                        sender->PutFreeBlock(block); 
+                        ReceiverBlockCompleted(blockId);
+                    }
                 }  // if erasureCount <= parityCount (i.e., block complete)
                 // Notify application of new data available
                 // (TBD) this could be improved for stream objects
                 //        so it's not called unnecessarily
                 if (objectUpdated && notify_on_update)
                 {
-                    if ((NULL == stream) || stream->DetermineReadReadiness() || session.RcvrIsLowDelay())
+                    if (NULL == stream)
                     {
                         notify_on_update = false;
                         session.Notify(NormController::RX_OBJECT_UPDATED, sender, this);
                     }
+                    else if (stream->DetermineReadReadiness() || session.RcvrIsLowDelay())
+                    {
+                        stream->PostEvent(NormStreamObject::EVENT_RX_UPDATED);
+                    }
                 }   
             }
             else
@@ -1672,6 +1916,131 @@ void NormObject::HandleObjectMessage(const NormObjectMsg& msg,
                     
 }  // end NormObject::HandleObjectMessage()
 
+UINT16 NormObject::ReceiverReadSegment(NormBlockId      blockId, 
+                                       NormSegmentId    segmentId,
+                                       char*            buffer)
+{
+    if (IsStream())
+        return static_cast<NormStreamObject*>(this)->ReceiverCopySegment(blockId, segmentId, buffer);
+    if ((blockId.GetValue() > final_block_id.GetValue()) || (segmentId >= GetBlockSize(blockId)))
+        return 0;
+    if (pending_mask.Test(blockId.GetValue()))
+    {
+        // Only the received segments of a pending block have been written 
+        NormBlock* block = block_buffer.Find(blockId);
+        if ((NULL == block) || block->IsPending(segmentId)) return 0;
+    }
+    return ReadSegment(blockId, segmentId, buffer);
+}  // end NormObject::ReceiverReadSegment()
+
+// Copies a completed block with source symbol erasures into a FEC decode
+// worker job.  Returns false (so the block is decoded inline instead) if
+// there are no decode workers, no source erasures, or no job is available.
+bool NormObject::SubmitBlockDecode(NormBlock* block)
+{
+    NormSegmentId firstErasure;
+    if (!sender->DecodeWorkersActive() || !block->GetFirstPending(firstErasure)) return false;
+    NormBlockId blockId = block->GetId();
+    UINT16 numData = GetBlockSize(blockId);
+    if (firstErasure >= numData) return false;  // only parity is missing
+    char** vectorList = sender->ReserveDecodeJob(block);
+    if (NULL == vectorList) return false;
+    UINT16 payloadMax = segment_size + NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE                               
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    UINT16 erasureCount = 0;
+    for (UINT16 i = 0; i < (numData + nparity); i++)
+    {
+        if (block->IsPending(i))
+        {
+            sender->SetErasureLoc(erasureCount++, i);
+            if (i < numData)
+                memset(vectorList[i], 0, payloadMax);  // zeroize in prep for decoding
+            else
+                vectorList[i] = NULL;    
+        }
+        else
+        {
+            const char* segment = block->GetSegment(i);
+            if ((NULL == segment) && (NULL == (segment = RetrieveSegment(blockId, i))))
+            {
+                // (the inline decode path handles stream retrieval failure)
+                ASSERT(IsStream());
+                sender->CancelDecodeJob(block);
+                return false;
+            }
+            memcpy(vectorList[i], segment, payloadMax);
+        }
+    }
+    PLOG(PL_DETAIL, "NormObject::SubmitBlockDecode() node>%lu sender>%lu obj>%hu blk>%lu "
+                    "completed block queued for decoding ...\n", (unsigned long)LocalNodeId(), 
+                    (unsigned long)sender->GetId(), (UINT16)transport_id, 
+                    (unsigned long)blockId.GetValue());
+    sender->SubmitDecodeJob(this, block, numData, erasureCount);
+    return true;
+}  // end NormObject::SubmitBlockDecode()
+
+void NormObject::ReceiverMergeDecode(NormBlock*             block,
+                                     char**                 vectorList,
+                                     unsigned int           erasureCount,
+                                     const unsigned int*    erasureLocs,
+                                     bool                   decoded)
+{
+    block->ClearFlag(NormBlock::DECODE_PENDING);
+    NormBlockId blockId = block->GetId();
+    if (!decoded)
+    {
+        // Count a "phantom" erasure so another repair segment
+        // is sought (see NormObject::HandleObjectMessage())
+        PLOG(PL_DEBUG, "NormObject::ReceiverMergeDecode() node>%lu sender>%lu obj>%hu blk>%lu "
+                       "decode incomplete, need more parity ...\n", (unsigned long)LocalNodeId(), 
+                       (unsigned long)sender->GetId(), (UINT16)transport_id, 
+                       (unsigned long)blockId.GetValue());
+        block->IncrementErasureCount();
+        return;
+    }
+    UINT16 numData = GetBlockSize(blockId);
+    bool objectUpdated = false;
+    for (unsigned int i = 0; i < erasureCount; i++)
+    {
+        NormSegmentId sid = erasureLocs[i];
+        if (sid >= numData) break;
+        if (WriteSegment(blockId, sid, vectorList[sid]))
+        {
+            ReceiverDigestSegment(block, sid, vectorList[sid]);
+            objectUpdated = true;
+            // For statistics only (TBD) #ifdef NORM_DEBUG
+            sender->IncrementRecvGoodput(segment_size);
+        }
+        else
+        {
+            if (IsStream())
+                PLOG(PL_DEBUG, "NormObject::ReceiverMergeDecode() WriteSegment() error\n");
+            else
+                PLOG(PL_ERROR, "NormObject::ReceiverMergeDecode() WriteSegment() error\n");
+        }
+    }
+    // OK, we're done with this block
+    digest_sum += block->GetDigest();
+    pending_mask.Unset(blockId.GetValue());
+    block_buffer.Remove(block);
+    sender->PutFreeBlock(block);
+    ReceiverBlockCompleted(blockId);
+    if (objectUpdated && notify_on_update)
+    {
+        if (!IsStream())
+        {
+            notify_on_update = false;
+            session.Notify(NormController::RX_OBJECT_UPDATED, sender, this);
+        }
+        else if (static_cast<NormStreamObject*>(this)->DetermineReadReadiness() || session.RcvrIsLowDelay())
+        {
+            static_cast<NormStreamObject*>(this)->PostEvent(NormStreamObject::EVENT_RX_UPDATED);
+        }
+    }
+}  // end NormObject::ReceiverMergeDecode()
+
 // Returns source symbol segments to pool for ordinally _first_ block with such resources
 bool NormObject::ReclaimSourceSegments(NormSegmentPool& segmentPool)
 {
@@ -1776,6 +2145,47 @@ NormBlock* NormObject::StealOldestBlock(bool excludeBlock, NormBlockId excludeId
     }
 }  // end NormObject::StealOldestBlock()
 
+// For receiver resource management (NormSenderNode::EVICT_SCORED), a block's
+// cost to lose grows with the fraction of its segments received (which would
+// have to be received again), more so if it has been NACKed (its repairs may
+// already be on the way), and most if it is complete and being decoded
+NormBlock* NormObject::GetEvictionCandidate(bool            excludeBlock, 
+                                            NormBlockId     excludeId,
+                                            bool            preferNewer,
+                                            unsigned int&   costMin,
+                                            unsigned int&   scanCount)
+{
+    NormBlock* candidate = NULL;
+    NormBlockBuffer::Iterator iterator(block_buffer);
+    NormBlock* block;
+    while ((0 != scanCount) && (NULL != (block = iterator.GetNextBlock())))
+    {
+        if (excludeBlock && (excludeId == block->GetId())) continue;
+        scanCount--;
+        unsigned int cost;
+        if (block->DecodePending())
+        {
+            cost = 3*256;
+        }
+        else
+        {
+            UINT16 numData = GetBlockSize(block->GetId());
+            UINT16 erasures = block->ErasureCount();
+            UINT16 received = (erasures < numData) ? (numData - erasures) : numData;
+            cost = ((unsigned int)received << 8) / numData;
+            if (block->InRepair()) cost += 256;
+        }
+        // (blocks are iterated oldest first)
+        if ((cost < costMin) || (preferNewer && (NULL != candidate) && (cost == costMin)))
+        {
+            candidate = block;
+            costMin = cost;
+            if ((0 == cost) && !preferNewer) break;
+        }
+    }
+    return candidate;
+}  // end NormObject::GetEvictionCandidate()
+
 bool NormObject::NextSenderMsg(NormObjectMsg* msg)
 {             
     // Init() the message
@@ -1844,7 +2254,7 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
                 NormFtiExtension129 fti;
                 msg->AttachExtension(fti);
                 fti.SetObjectSize(object_size);
-                fti.SetFecInstanceId(0);   // ZERO is for legacy MDP/NORM FEC encoder (TBD - use appropriate instanceId)
+                fti.SetFecInstanceId(session.GetSenderFecInstanceId());   // ZERO is for legacy MDP/NORM FEC encoder
                 fti.SetSegmentSize(segment_size);
                 fti.SetFecMaxBlockLen(ndata);
                 fti.SetFecNumParity(nparity);
@@ -1855,14 +2265,41 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
                 return false;
         }
     }
+    // The digest goes in every message so receivers digest from the start
+    // no matter which of the object's messages they get first
+    // (a relay gets its source's digest value once that arrives)
+    if ((DIGEST_PENDING == digest_status) && (NULL != relay_source) && relay_source->HasDigest())
+    {
+        digest = relay_source->GetDigest();
+        digest_status = DIGEST_SET;
+    }
+    NormDigestExtension digestExt;
+    bool digestAttached = false;
+    if ((DIGEST_SET == digest_status) || (DIGEST_PENDING == digest_status))
+    {
+        msg->AttachExtension(digestExt);
+        digestExt.SetAlgorithm(NormDigest::CRC32C);
+        digestExt.SetPending(DIGEST_PENDING == digest_status);
+        digestExt.SetDigest(digest);
+        digestAttached = true;
+    }
     if (pending_info)
     {
-        // (TBD) set REPAIR_FLAG for retransmitted info
+        // NORM_INFO sent again (other than the periodic EMCON resend) is a repair
         NormInfoMsg* infoMsg = static_cast<NormInfoMsg*>(msg);
         infoMsg->SetInfo(info_ptr, info_len);
+        if (info_sent && !session.SndrEmcon())
+            infoMsg->SetFlag(NormObjectMsg::FLAG_REPAIR);
+        info_sent = true;
         pending_info = false;
         return true;
     }
+    // A due stream sync point rides on the next NORM_DATA (repair or not)
+    if (IsStream()) 
+        static_cast<NormStreamObject*>(this)->SenderAttachSync(static_cast<NormDataMsg*>(msg));
+    // A due stream window repair goes ahead of the next segment
+    if (IsStream() && static_cast<NormStreamObject*>(this)->SenderNextWindowRepair(static_cast<NormDataMsg*>(msg)))
+        return true;
     // This block gets the next pending block/segment
     // (The loop handles NORM_OBJECT_STREAM advancement 
     //  without the prior approach that used recursion)
@@ -1927,7 +2364,7 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
                     return false;
                 }
            }    
-           block->TxInit(blockId, numData, session.SenderAutoParity());  
+           block->TxInit(blockId, numData, session.SenderBlockAutoParity());  
            //if (blockId < max_pending_block) 
            if (Compare(blockId, max_pending_block) < 0)
                block->SetFlag(NormBlock::IN_REPAIR);
@@ -1985,6 +2422,12 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
                }
            }  // end while (!block_buffer.Insert())
            if (NULL == block) continue;
+           // Non-stream object source data is all available now, so the parity
+           // may be cached from an earlier transmission or FEC worker threads
+           // (if enabled) can compute it "ahead" of need
+           if (!SenderRetrieveParity(block) && 
+               (0 != nparity) && !IsStream() && session.SenderFecWorkersActive())
+               SubmitBlockParity(block);
         }  // end if (!block)
         if (!block->GetFirstPending(segmentId)) 
         {
@@ -1999,7 +2442,15 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
         {
             // Try to read data segment (Note "ReadSegment" copies in offset/length info also)
             char* buffer = data->AccessPayload(); 
-            UINT16 payloadLength = ReadSegment(blockId, segmentId, buffer);
+            UINT16 payloadLength = 0;
+            // With zero-copy transmit, segments not needed for incremental FEC
+            // encoding may be sent in place (e.g. from a memory-mapped file)
+            const char* segmentRef = NULL;
+            if (session.GetTxZeroCopy() && 
+                ((block->ParityReadiness() != segmentId) || (0 == nparity) || block->ParityPending()))
+                segmentRef = ReferenceSegment(blockId, segmentId, payloadLength);
+            if (NULL == segmentRef)
+                payloadLength = ReadSegment(blockId, segmentId, buffer);
             if (0 == payloadLength)
             {
                 // (TBD) deal with read error 
@@ -2032,10 +2483,22 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
                     return false;
                 }
             }
-            data->SetPayloadLength(payloadLength);
+            if (NULL != segmentRef)
+                data->SetPayloadRef(segmentRef, payloadLength);
+            else
+                data->SetPayloadLength(payloadLength);
+            // The segment that completes the digest already carries its value
+            if ((DIGEST_PENDING == digest_status) &&
+                SenderDigestSegment(blockId, segmentId, (NULL != segmentRef) ? segmentRef : buffer, payloadLength) &&
+                digestAttached)
+            {
+                digestExt.SetPending(false);
+                digestExt.SetDigest(digest);
+            }
 
-            // Perform incremental FEC encoding as needed
-            if ((block->ParityReadiness() == segmentId) && (0 != nparity)) 
+            // Perform incremental FEC encoding as needed (unless a FEC
+            // worker thread is computing the block's parity)
+            if ((block->ParityReadiness() == segmentId) && (0 != nparity) && !block->ParityPending()) 
                // (TBD) && ((incrementalParity == true) || (auto_parity != 0))
             {
                 // (TBD) for non-stream objects, catch alternate "last block/segment len"
@@ -2050,15 +2513,23 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
                 block->UpdateSegSizeMax(payloadLength);
                 session.SenderEncode(segmentId, data->AccessPayload(), block->SegmentList(numData)); 
                 block->IncreaseParityReadiness();     
+                if (block->ParityReady(numData))
+                {
+                    session.SenderEncodeFinish(numData, block->SegmentList(numData));
+                    SenderCacheParity(block);
+                }
             }
         }
         else
         {   
+            if (block->ParityPending())
+                session.SenderCollectParity(block);  // waits for FEC worker as needed
             if (!block->ParityReady(numData)) 
             {
                 ASSERT(0 == block->ParityReadiness());
                 CalculateBlockParity(block);
             }
+            SenderCacheParity(block);  // (e.g. computed by a FEC worker)
             char* segment = block->GetSegment(segmentId);
             ASSERT(NULL != segment);
             // We only need to send FEC content to cover the biggest segment
@@ -2073,9 +2544,30 @@ bool NormObject::NextSenderMsg(NormObjectMsg* msg)
         }
     }  // end while (NULL == block)
     block->UnsetPending(segmentId); 
-    //if (block->InRepair()) 
-    //    data->SetFlag(NormObjectMsg::FLAG_REPAIR);
+    if (block->InRepair()) 
+        data->SetFlag(NormObjectMsg::FLAG_REPAIR);
     data->SetFecPayloadId(fec_id, blockId.GetValue(), segmentId, numData, fec_m);
+    if (IsStream() && (segmentId < numData) && !block->InRepair())
+    {
+        static_cast<NormStreamObject*>(this)->SenderWindowSourceSent(blockId, segmentId);
+        static_cast<NormStreamObject*>(this)->SenderSyncSourceSent(blockId, segmentId);
+    }
+    // The final messages of an object (or of a flushed stream write)
+    // can carry the flush themselves (see NormSession::SetTxFlushPiggyback())
+    if (session.GetTxFlushPiggyback() && !block->InRepair())
+    {
+        if (IsStream())
+        {
+            NormStreamObject* stream = static_cast<NormStreamObject*>(this);
+            if (stream->IsFlushPending() && (blockId == stream->FlushBlockId()) && 
+                (segmentId == stream->FlushSegmentId()))
+                data->SetFlag(NormObjectMsg::FLAG_FLUSH);
+        }
+        else if ((blockId == final_block_id) && ((segmentId + 1) >= numData))
+        {
+            data->SetFlag(NormObjectMsg::FLAG_FLUSH);
+        }
+    }
     if (!block->IsPending()) 
     {
         // End of block reached
@@ -2203,33 +2695,164 @@ NormBlockId NormStreamObject::RepairWindowLo() const
 bool NormObject::CalculateBlockParity(NormBlock* block)
 {
     if (0 == nparity) return true;
-    char buffer[NormMsg::MAX_SIZE];
+    if (SenderRetrieveParity(block)) return true;
     UINT16 numData = GetBlockSize(block->GetId());
-    for (UINT16 i = 0; i < numData; i++)
-    {
-        UINT16 payloadLength = ReadSegment(block->GetId(), i, buffer);
-        if (0 != payloadLength)
-        {
-            UINT16 payloadMax = segment_size+NormDataMsg::GetStreamPayloadHeaderLength();
+    UINT16 payloadMax = segment_size+NormDataMsg::GetStreamPayloadHeaderLength();
 #ifdef SIMULATE
-            payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
 #endif // SIMULATE
+    char** vectorList = session.SenderEncodeVectorList();
+    if (NULL != vectorList)
+    {
+        // Read the whole block and encode it in one pass
+        for (UINT16 i = 0; i < numData; i++)
+        {
+            char* buffer = vectorList[i];
+            UINT16 payloadLength = ReadSegment(block->GetId(), i, buffer);
+            if (0 == payloadLength) return false;
             if (payloadLength < payloadMax)
                 memset(buffer+payloadLength, 0, payloadMax-payloadLength+1);
             block->UpdateSegSizeMax(payloadLength);
-            session.SenderEncode(i, buffer, block->SegmentList(numData));
         }
-        else
+        session.SenderEncodeBlock((const char**)vectorList, numData, block->SegmentList(numData));
+    }
+    else
+    {
+        char buffer[NormMsg::MAX_SIZE];
+        for (UINT16 i = 0; i < numData; i++)
         {
-            return false;   
+            UINT16 payloadLength = ReadSegment(block->GetId(), i, buffer);
+            if (0 != payloadLength)
+            {
+                if (payloadLength < payloadMax)
+                    memset(buffer+payloadLength, 0, payloadMax-payloadLength+1);
+                block->UpdateSegSizeMax(payloadLength);
+                session.SenderEncode(i, buffer, block->SegmentList(numData));
+            }
+            else
+            {
+                return false;   
+            }
         }
+        session.SenderEncodeFinish(numData, block->SegmentList(numData));
     }
     block->SetParityReadiness(numData);
+    SenderCacheParity(block);
     return true;
 }  // end NormObject::CalculateBlockParity()
 
+void NormObject::SenderSetParityKey(UINT64 contentKey)
+{
+    // The parity also depends on how the object is split into blocks
+    UINT64 key = NormParityCache::Hash(&contentKey, sizeof(UINT64));
+    UINT16 sizeMsb = object_size.MSB();
+    UINT32 sizeLsb = object_size.LSB();
+    key = NormParityCache::Hash(&sizeMsb, sizeof(UINT16), key);
+    key = NormParityCache::Hash(&sizeLsb, sizeof(UINT32), key);
+    key = NormParityCache::Hash(&segment_size, sizeof(UINT16), key);
+    key = NormParityCache::Hash(&fec_id, sizeof(UINT8), key);
+    key = NormParityCache::Hash(&fec_m, sizeof(UINT8), key);
+    key = NormParityCache::Hash(&ndata, sizeof(UINT16), key);
+    key = NormParityCache::Hash(&nparity, sizeof(UINT16), key);
+    parity_key = (0 != key) ? key : 1;
+}  // end NormObject::SenderSetParityKey()
+
+void NormObject::SenderStartDigest()
+{
+    digest_status = DIGEST_NONE;
+    if (IsStream()) return;
+    digest = digest_sum = 0;
+    digest_block = 0;
+    digest_segment = 0;
+    // (an empty object's digest is known already)
+    digest_status = (0 != object_size.GetOffset()) ? DIGEST_PENDING : DIGEST_SET;
+}  // end NormObject::SenderStartDigest()
+
+bool NormObject::SenderDigestSegment(NormBlockId    blockId,
+                                     NormSegmentId  segmentId,
+                                     const char*    buffer,
+                                     UINT16         len)
+{
+    if ((blockId != digest_block) || (segmentId != digest_segment))
+        return false;  // (a repair or requeued resend)
+    digest_sum += NormDigest::SegmentDigest(blockId.GetValue(), segmentId, buffer, len);
+    if (++digest_segment < GetBlockSize(blockId))
+        return false;
+    if (blockId != final_block_id)
+    {
+        Increment(digest_block);
+        digest_segment = 0;
+        return false;
+    }
+    digest = digest_sum;
+    digest_status = DIGEST_SET;
+    return true;
+}  // end NormObject::SenderDigestSegment()
+
+bool NormObject::SenderRetrieveParity(NormBlock* block)
+{
+    if ((0 == parity_key) || (0 == nparity)) return false;
+    UINT16 payloadMax = segment_size+NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    UINT16 numData = GetBlockSize(block->GetId());
+    UINT16 segSizeMax;
+    if (!session.SenderParityCache().Retrieve(parity_key, block->GetId().GetValue(), nparity,
+                                              payloadMax, block->SegmentList(numData), segSizeMax))
+        return false;
+    block->UpdateSegSizeMax(segSizeMax);
+    block->SetParityReadiness(numData);
+    block->SetFlag(NormBlock::PARITY_CACHED);
+    return true;
+}  // end NormObject::SenderRetrieveParity()
+
+void NormObject::SenderCacheParity(NormBlock* block)
+{
+    if ((0 == parity_key) || (0 == nparity) || block->ParityCached()) return;
+    UINT16 numData = GetBlockSize(block->GetId());
+    if (!block->ParityReady(numData) || block->ParityPending()) return;
+    UINT16 payloadMax = segment_size+NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    session.SenderParityCache().Store(parity_key, block->GetId().GetValue(), nparity,
+                                      payloadMax, block->SegmentList(numData), block->GetSegSizeMax());
+    block->SetFlag(NormBlock::PARITY_CACHED);
+}  // end NormObject::SenderCacheParity()
+
+// Hands the block off to the session's FEC worker threads to compute its
+// parity while its source segments are being sent.  Returns false if no worker
+// job was available (the parity is then computed inline as usual).
+bool NormObject::SubmitBlockParity(NormBlock* block)
+{
+    char** vectorList = session.SenderReserveParityJob(block);
+    if (NULL == vectorList) return false;
+    UINT16 numData = GetBlockSize(block->GetId());
+    UINT16 payloadMax = segment_size+NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    for (UINT16 i = 0; i < numData; i++)
+    {
+        char* buffer = vectorList[i];
+        UINT16 payloadLength = ReadSegment(block->GetId(), i, buffer);
+        if (0 == payloadLength)
+        {
+            session.SenderCancelParityJob(block);
+            return false;
+        }
+        if (payloadLength < payloadMax)
+            memset(buffer+payloadLength, 0, payloadMax-payloadLength+1);
+        block->UpdateSegSizeMax(payloadLength);
+    }
+    session.SenderSubmitParityJob(block, numData);
+    return true;
+}  // end NormObject::SubmitBlockParity()
+
 NormBlock* NormObject::SenderRecoverBlock(NormBlockId blockId)
 {
+    if (!RelayIsReady(blockId)) return NULL;
     NormBlock* block = session.SenderGetFreeBlock(transport_id, blockId);
     if (block)
     {
@@ -2292,9 +2915,16 @@ NormFileObject::NormFileObject(class NormSession&       theSession,
                                class NormSenderNode*    theSender,
                                const NormObjectId&      objectId)
  : NormObject(FILE, theSession, theSender, objectId), 
-   large_block_length(0), small_block_length(0)
+   large_block_length(0), small_block_length(0), file_io(NULL), read_ahead_size(0),
+   journal_resume(false), journal_mask(NULL), journal_mask_len(0), journal_mask_offset(0),
+   journal_pending(0), journal_dirty_min(0), journal_dirty_max(0)
 {
     path[0] = '\0';
+    for (unsigned int i = 0; i < READ_AHEAD_COUNT; i++)
+    {
+        read_ahead[i] = NULL;
+        read_ahead_chunk[i] = 0;
+    }
 }
 
 NormFileObject::~NormFileObject()
@@ -2317,10 +2947,15 @@ bool NormFileObject::Open(const char* thePath,
         }
         else
         {
-            if (file.Open(thePath, O_RDWR | O_CREAT | O_TRUNC))
+            // (a resumed reception keeps what was already received)
+            if (file.Open(thePath, O_RDWR | O_CREAT | (journal_resume ? 0 : O_TRUNC)))
             {
                 if (!file.Lock())
                     PLOG(PL_WARN, "NormFileObject::Open() warning: NormFile::Lock() failure\n");
+                // Pre-size and map the file so segments are written (and
+                // retrieved for decoding) in place
+                if (session.GetFileMapping() && !file.Map(NormObject::GetSize().GetOffset()))
+                    PLOG(PL_DEBUG, "NormFileObject::Open() recv file not mapped (using write())\n");
             }   
             else
             {
@@ -2358,6 +2993,22 @@ bool NormFileObject::Open(const char* thePath,
                     Close();
                     return false;
                 }
+                if (session.GetFileMapping() && !file.Map(size))
+                    PLOG(PL_DEBUG, "NormFileObject::Open() send file not mapped (using read())\n");
+                // The file content is identified by its path, size and modification
+                // time (hashing the content would cost about what the cache saves).
+                // Recently modified files aren't cached since a quick rewrite might
+                // not change the modification time.
+                if (session.SenderParityCache().IsEnabled() && (0 != nparity))
+                {
+                    time_t updateTime = NormFile::GetUpdateTime(thePath);
+                    if ((time(NULL) - updateTime) > 2)
+                    {
+                        UINT64 contentKey = NormParityCache::Hash(thePath, strlen(thePath));
+                        contentKey = NormParityCache::Hash(&updateTime, sizeof(time_t), contentKey);
+                        SenderSetParityKey(contentKey);
+                    }
+                }
             }
             /*
             else
@@ -2375,15 +3026,32 @@ bool NormFileObject::Open(const char* thePath,
     }
     large_block_length = NormObjectSize(large_block_size) * segment_size;
     small_block_length = NormObjectSize(small_block_size) * segment_size;
+    // Use background file I/O (if enabled) when the file isn't mapped
+    file_io = file.IsMapped() ? NULL : session.GetFileIo();
+    if (0 != segment_size)
+        read_ahead_size = (size_t)segment_size * MAX(1, READ_AHEAD_CHUNK / segment_size);
+    // Otherwise, buffer file reads and writes a FEC block at a time
+    if (!file.IsMapped() && (NULL == file_io) && (0 != segment_size))
+    {
+        size_t blockLength = (size_t)large_block_size * segment_size;
+        if (blockLength > FILE_BUFFER_MAX)
+            blockLength = (FILE_BUFFER_MAX / segment_size) * segment_size;
+        if (!file.SetBuffer(blockLength))
+            PLOG(PL_WARN, "NormFileObject::Open() warning: unable to buffer file (using unbuffered I/O)\n");
+    }
     strncpy(path, thePath, PATH_MAX);
     size_t len = strlen(thePath);
     len = MIN(len, PATH_MAX);
     if (len < PATH_MAX) path[len] = '\0';
+    if ((NULL == sender) && session.SenderDigestEnabled())
+        SenderStartDigest();
     return true;
 }  // end NormFileObject::Open()
                 
 bool NormFileObject::Accept(const char* thePath)
 {
+    // (blocks recovered from the journal aren't digested)
+    if (JournalOpen(thePath)) ReceiverIgnoreDigest();
     if (Open(thePath))
     {
         NormObject::Accept(); 
@@ -2391,16 +3059,21 @@ bool NormFileObject::Accept(const char* thePath)
     }
     else
     {
+        JournalClose();
         return false;
     }
 }  // end NormFileObject::Accept()
 
 void NormFileObject::CloseFile()
 {
+    if (journal.IsOpen()) JournalClose();
     if (file.IsOpen())
     {
+        DrainFileIo();
         if (NULL != sender)  // we've been receiving this file
             file.Unlock();
+        else if (file.IsMapped())  // any queued zero-copy messages need their data
+            session.SenderCopyPayloadRefs(file.GetMapPtr(), (size_t)file.GetMapSize());
         file.Close();
     }
 }  // end NormFileObject::CloseFile()
@@ -2427,21 +3100,18 @@ bool NormFileObject::WriteSegment(NormBlockId   blockId,
     {
         len = segment_size;
     }
-    // Determine segment offset from blockId::segmentId
-    NormObjectSize segmentOffset;
-    NormObjectSize segmentSize = NormObjectSize(segment_size);
-    if (blockId.GetValue() < large_block_count)
+	NormFile::Offset offset = GetSegmentOffset(blockId, segmentId);
+    if (file.IsMapped() && ((offset + (NormFile::Offset)len) <= file.GetMapSize()))
     {
-        segmentOffset = (large_block_length*blockId.GetValue()) + (segmentSize*segmentId);
-    }
-    else
-    {
-        segmentOffset = large_block_length*large_block_count;  // (TBD) pre-calc this 
-        UINT32 smallBlockIndex = blockId.GetValue() - large_block_count;
-        segmentOffset = segmentOffset + small_block_length*smallBlockIndex +
-                                        segmentSize*segmentId;
+        memcpy(file.GetMapPtr() + offset, buffer, len);
+        return true;
     }
-	NormFile::Offset offset = segmentOffset.GetOffset();
+#ifdef NORM_FILE_IO
+    if (NULL != file_io)
+        return file_io->Write(file.fd, offset, buffer, len);
+#endif // NORM_FILE_IO
+    if (0 != file.GetBufferSize())
+        return file.WriteBuffered(offset, buffer, len);
     if (offset != file.GetOffset())
     {
         if (!file.Seek(offset)) return false; 
@@ -2469,21 +3139,36 @@ UINT16 NormFileObject::ReadSegment(NormBlockId      blockId,
         len = segment_size;
     }
     
-    // Determine segment offset from blockId::segmentId
-    NormObjectSize segmentOffset;
-    NormObjectSize segmentSize = NormObjectSize(segment_size);
-    if (blockId.GetValue() < large_block_count)
+	NormFile::Offset offset = GetSegmentOffset(blockId, segmentId);
+    if (file.IsMapped() && ((offset + (NormFile::Offset)len) <= file.GetMapSize()))
     {
-        segmentOffset = large_block_length*blockId.GetValue() + segmentSize*segmentId;
+        memcpy(buffer, file.GetMapPtr() + offset, len);
+        return (UINT16)len;
     }
-    else
+#ifdef NORM_FILE_IO
+    if (NULL != file_io)
     {
-        segmentOffset = large_block_length*large_block_count;  // (TBD) pre-calc this  
-        UINT32 smallBlockIndex = blockId.GetValue() - large_block_count;
-        segmentOffset = segmentOffset + small_block_length*smallBlockIndex +
-                                        segmentSize*segmentId;
+        if (NULL != sender)
+        {
+            // Segments read back for decoding must have been written first
+            if (!file_io->Flush(file.fd))
+            {
+                PLOG(PL_FATAL, "NormFileObject::ReadSegment() error: file write failure\n");
+                return 0;
+            }
+        }
+        else if (ReadAhead(offset, buffer, len))
+        {
+            return (UINT16)len;
+        }
+    }
+#endif // NORM_FILE_IO
+    if (0 != file.GetBufferSize())
+    {
+        // (the buffer is filled from the start of the segment's block)
+        size_t nbytes = file.ReadBuffered(offset, buffer, len, GetSegmentOffset(blockId, 0));
+        return (len == nbytes) ? (UINT16)len : 0;
     }
-	NormFile::Offset offset = segmentOffset.GetOffset();
     if (offset != file.GetOffset())
     {
         if (!file.Seek(offset))
@@ -2504,6 +3189,16 @@ UINT16 NormFileObject::ReadSegment(NormBlockId      blockId,
 char* NormFileObject::RetrieveSegment(NormBlockId      blockId, 
                                       NormSegmentId    segmentId)
 {
+    if (file.IsMapped())
+    {
+        // Full-size segments can be used directly from the mapping
+        // (the decoder may read a stream payload header's worth beyond the segment)
+        NormFile::Offset offset = GetSegmentOffset(blockId, segmentId);
+        NormFile::Offset end = offset + segment_size + NormDataMsg::GetStreamPayloadHeaderLength();
+        bool isShort = (blockId == final_block_id) && (segmentId == (GetBlockSize(blockId) - 1));
+        if (!isShort && (end <= file.GetMapSize()))
+            return (file.GetMapPtr() + offset);
+    }
     if (sender)
     {
         char* segment = sender->GetRetrievalSegment();
@@ -2528,6 +3223,316 @@ char* NormFileObject::RetrieveSegment(NormBlockId      blockId,
     }
 }  // end NormFileObject::RetrieveSegment()
 
+const char* NormFileObject::ReferenceSegment(NormBlockId    blockId,
+                                             NormSegmentId  segmentId,
+                                             UINT16&        length)
+{
+    if (!file.IsMapped()) return NULL;
+    UINT16 len = segment_size;
+    if ((blockId == final_block_id) && (segmentId == (GetBlockSize(blockId) - 1)))
+        len = final_segment_size;
+    NormFile::Offset offset = GetSegmentOffset(blockId, segmentId);
+    if ((offset + (NormFile::Offset)len) > file.GetMapSize()) return NULL;
+    length = len;
+    return (file.GetMapPtr() + offset);
+}  // end NormFileObject::ReferenceSegment()
+
+NormFile::Offset NormFileObject::GetSegmentOffset(NormBlockId   blockId,
+                                                  NormSegmentId segmentId) const
+{
+    // Determine segment offset from blockId::segmentId
+    NormObjectSize segmentOffset;
+    NormObjectSize segmentSize = NormObjectSize(segment_size);
+    if (blockId.GetValue() < large_block_count)
+    {
+        segmentOffset = large_block_length*blockId.GetValue() + segmentSize*segmentId;
+    }
+    else
+    {
+        segmentOffset = large_block_length*large_block_count;  // (TBD) pre-calc this  
+        UINT32 smallBlockIndex = blockId.GetValue() - large_block_count;
+        segmentOffset = segmentOffset + small_block_length*smallBlockIndex +
+                                        segmentSize*segmentId;
+    }
+    return segmentOffset.GetOffset();
+}  // end NormFileObject::GetSegmentOffset()
+
+bool NormFileObject::ReadAhead(NormFile::Offset offset, char* buffer, size_t len)
+{
+    bool hit = false;
+#ifdef NORM_FILE_IO
+    if (0 == read_ahead_size) return false;
+    NormFile::Offset chunk = offset / (NormFile::Offset)read_ahead_size;
+    bool pending = false;
+    NormFile::Offset minChunk = 0;
+    for (unsigned int i = 0; i < READ_AHEAD_COUNT; i++)
+    {
+        if ((NULL != read_ahead[i]) && (!pending || (read_ahead_chunk[i] < minChunk)))
+        {
+            minChunk = read_ahead_chunk[i];
+            pending = true;
+        }
+    }
+    // A read behind the read-ahead (e.g. a repair) is done inline and
+    // leaves the read-ahead in place for the sequential reads to come
+    if (pending && (chunk < minChunk)) return false;
+    bool ahead = false;
+    bool failed = false;
+    NormFile::Offset maxChunk = chunk;
+    for (unsigned int i = 0; i < READ_AHEAD_COUNT; i++)
+    {
+        NormFileIoEngine::Request* req = read_ahead[i];
+        if (NULL == req) continue;
+        if (read_ahead_chunk[i] == chunk)
+        {
+            const char* data;
+            long result = file_io->Wait(req, data);
+            size_t start = (size_t)(offset - chunk*(NormFile::Offset)read_ahead_size);
+            if ((result > 0) && ((size_t)result >= (start + len)))
+            {
+                memcpy(buffer, data + start, len);
+                hit = true;
+                continue;  // (keep for the rest of this chunk)
+            }
+            failed = true;  // (don't retry a short read)
+        }
+        else if (read_ahead_chunk[i] > chunk)
+        {
+            if (read_ahead_chunk[i] > maxChunk)
+                maxChunk = read_ahead_chunk[i];
+            ahead = true;
+            continue;
+        }
+        // Chunks behind us (or a failed read) are released
+        file_io->Release(req);
+        read_ahead[i] = NULL;
+    }
+    NormFile::Offset nextChunk = (ahead || hit || failed) ? (maxChunk + 1) : chunk;
+    // Top up the read-ahead (without going past the end of the file)
+    NormFile::Offset objectSize = NormObject::GetSize().GetOffset();
+    for (unsigned int i = 0; i < READ_AHEAD_COUNT; i++)
+    {
+        if (NULL != read_ahead[i]) continue;
+        NormFile::Offset chunkOffset = nextChunk * (NormFile::Offset)read_ahead_size;
+        if (chunkOffset >= objectSize) break;
+        if (NULL == (read_ahead[i] = file_io->Read(file.fd, chunkOffset, read_ahead_size)))
+            break;  // (all engine requests busy)
+        read_ahead_chunk[i] = nextChunk++;
+    }
+#endif // NORM_FILE_IO
+    return hit;
+}  // end NormFileObject::ReadAhead()
+
+bool NormFileObject::DrainFileIo()
+{
+    bool result = true;
+#ifdef NORM_FILE_IO
+    if (NULL != file_io)
+    {
+        for (unsigned int i = 0; i < READ_AHEAD_COUNT; i++)
+        {
+            if (NULL != read_ahead[i])
+            {
+                file_io->Release(read_ahead[i]);
+                read_ahead[i] = NULL;
+            }
+        }
+        if (file.IsOpen() && !file_io->Flush(file.fd))
+        {
+            PLOG(PL_ERROR, "NormFileObject::DrainFileIo() error: file write failure\n");
+            result = false;
+        }
+    }
+#endif // NORM_FILE_IO
+    return result;
+}  // end NormFileObject::DrainFileIo()
+
+const char NormFileObject::JOURNAL_MAGIC[8] = {'N', 'O', 'R', 'M', 'J', 'R', 'N', '1'};
+
+// The journal for a received object is named by its sender, sender
+// instance and object id (the receive file name is up to the application)
+bool NormFileObject::JournalGetPath(char* pathBuffer)
+{
+    const char* dirPath = session.GetRxFileJournal();
+    if ((NULL == dirPath) || (NULL == sender)) return false;
+    char fileName[64];
+    sprintf(fileName, "normJournal-%08lx-%04hx-%04hx", (unsigned long)sender->GetId(),
+            (UINT16)sender->GetInstanceId(), (UINT16)transport_id);
+    if ((strlen(dirPath) + strlen(fileName)) >= PATH_MAX) return false;
+    strcpy(pathBuffer, dirPath);
+    strcat(pathBuffer, fileName);
+    return true;
+}  // end NormFileObject::JournalGetPath()
+
+// The header identifies the object and its FTI so a journal is only
+// applied to the very same object
+void NormFileObject::JournalGetHeader(char* buffer)
+{
+    memcpy(buffer, JOURNAL_MAGIC, 8);
+    UINT32 word32 = htonl((UINT32)sender->GetId());
+    memcpy(buffer + 8, &word32, 4);
+    UINT16 word16 = htons((UINT16)sender->GetInstanceId());
+    memcpy(buffer + 12, &word16, 2);
+    word16 = htons((UINT16)transport_id);
+    memcpy(buffer + 14, &word16, 2);
+    word16 = htons(object_size.MSB());
+    memcpy(buffer + 16, &word16, 2);
+    word32 = htonl(object_size.LSB());
+    memcpy(buffer + 18, &word32, 4);
+    word16 = htons(segment_size);
+    memcpy(buffer + 22, &word16, 2);
+    buffer[24] = (char)fec_id;
+    buffer[25] = (char)fec_m;
+    word16 = htons(ndata);
+    memcpy(buffer + 26, &word16, 2);
+    word16 = htons(nparity);
+    memcpy(buffer + 28, &word16, 2);
+}  // end NormFileObject::JournalGetHeader()
+
+bool NormFileObject::JournalOpen(const char* thePath)
+{
+    journal_resume = false;
+    char journalPath[PATH_MAX];
+    if (!JournalGetPath(journalPath)) return false;
+    if (NULL != journal_mask) delete[] journal_mask;
+    UINT32 numBlocks = final_block_id.GetValue() + 1;
+    journal_mask_len = (numBlocks + 7) >> 3;
+    if (NULL == (journal_mask = new char[journal_mask_len]))
+    {
+        PLOG(PL_ERROR, "NormFileObject::JournalOpen() new journal_mask error: %s\n", GetErrorString());
+        return false;
+    }
+    memset(journal_mask, 0, journal_mask_len);
+    char header[JOURNAL_HEADER_SIZE + 2];
+    JournalGetHeader(header);
+    if (NormFile::Exists(journalPath))
+    {
+        // Recover the partial reception if the journal is for this object
+        NormFile oldJournal;
+        if (oldJournal.Open(journalPath, O_RDONLY))
+        {
+            char buffer[JOURNAL_HEADER_SIZE + 2];
+            char oldPath[PATH_MAX];
+            UINT16 pathLen = 0;
+            if ((oldJournal.Read(buffer, JOURNAL_HEADER_SIZE + 2) == (JOURNAL_HEADER_SIZE + 2)) &&
+                (0 == memcmp(buffer, header, JOURNAL_HEADER_SIZE)))
+            {
+                memcpy(&pathLen, buffer + JOURNAL_HEADER_SIZE, 2);
+                pathLen = ntohs(pathLen);
+            }
+            if ((0 != pathLen) && (pathLen < PATH_MAX) &&
+                (oldJournal.Read(oldPath, pathLen) == pathLen) &&
+                (oldJournal.Read(journal_mask, journal_mask_len) == journal_mask_len))
+            {
+                oldPath[pathLen] = '\0';
+                if ((NormFile::NORMAL == NormFile::GetType(oldPath)) && file.Rename(oldPath, thePath))
+                    journal_resume = true;
+                else
+                    PLOG(PL_WARN, "NormFileObject::JournalOpen() warning: unable to recover \"%s\"\n", oldPath);
+            }
+            oldJournal.Close();
+        }
+        if (!journal_resume) memset(journal_mask, 0, journal_mask_len);
+    }
+    if (journal_resume)
+    {
+        UINT32 count = 0;
+        for (UINT32 i = 0; i < numBlocks; i++)
+        {
+            if (0 != (journal_mask[i >> 3] & (0x80 >> (i & 0x07))))
+            {
+                pending_mask.Unset(i);
+                count++;
+            }
+        }
+        PLOG(PL_INFO, "NormFileObject::JournalOpen() sender>%lu obj>%hu resuming with %lu of %lu blocks received\n",
+                      (unsigned long)sender->GetId(), (UINT16)transport_id, 
+                      (unsigned long)count, (unsigned long)numBlocks);
+    }
+    // (Re)write the journal for "thePath"
+    size_t pathLen = strlen(thePath);
+    UINT16 word16 = htons((UINT16)pathLen);
+    memcpy(header + JOURNAL_HEADER_SIZE, &word16, 2);
+    if (!journal.Open(journalPath, O_RDWR | O_CREAT | O_TRUNC) ||
+        (journal.Write(header, JOURNAL_HEADER_SIZE + 2) != (JOURNAL_HEADER_SIZE + 2)) ||
+        (journal.Write(thePath, pathLen) != pathLen) ||
+        (journal.Write(journal_mask, journal_mask_len) != journal_mask_len))
+    {
+        PLOG(PL_ERROR, "NormFileObject::JournalOpen() error writing journal \"%s\": %s\n", 
+                       journalPath, GetErrorString());
+        if (journal.IsOpen()) journal.Close();
+        NormFile::Unlink(journalPath);
+        delete[] journal_mask;
+        journal_mask = NULL;
+        return journal_resume;
+    }
+    journal_mask_offset = JOURNAL_HEADER_SIZE + 2 + pathLen;
+    journal_pending = 0;
+    return journal_resume;
+}  // end NormFileObject::JournalOpen()
+
+void NormFileObject::JournalBlock(NormBlockId blockId)
+{
+    if (!journal.IsOpen()) return;
+    UINT32 index = blockId.GetValue() >> 3;
+    if (index >= journal_mask_len) return;
+    journal_mask[index] |= (char)(0x80 >> (blockId.GetValue() & 0x07));
+    if (0 == journal_pending)
+    {
+        journal_dirty_min = journal_dirty_max = index;
+    }
+    else
+    {
+        if (index < journal_dirty_min) journal_dirty_min = index;
+        if (index > journal_dirty_max) journal_dirty_max = index;
+    }
+    if (++journal_pending >= JOURNAL_SYNC_BLOCKS) JournalSync();
+}  // end NormFileObject::JournalBlock()
+
+bool NormFileObject::JournalSync()
+{
+    if (!journal.IsOpen() || (0 == journal_pending)) return true;
+    // The journaled blocks must be in the file first
+    if (!DrainFileIo() || (file.IsOpen() && !file.Flush()))
+    {
+        PLOG(PL_ERROR, "NormFileObject::JournalSync() error: file write failure\n");
+        return false;
+    }
+    UINT32 len = journal_dirty_max - journal_dirty_min + 1;
+    if (!journal.Seek(journal_mask_offset + journal_dirty_min) ||
+        (journal.Write(journal_mask + journal_dirty_min, len) != len))
+    {
+        PLOG(PL_ERROR, "NormFileObject::JournalSync() journal write error: %s\n", GetErrorString());
+        return false;
+    }
+    journal_pending = 0;
+    return true;
+}  // end NormFileObject::JournalSync()
+
+void NormFileObject::JournalClose()
+{
+    if (journal.IsOpen())
+    {
+        if (PendingMaskIsSet())
+        {
+            JournalSync();   // keep it for a later resume
+            journal.Close();
+        }
+        else
+        {
+            journal.Close();
+            char journalPath[PATH_MAX];
+            if (JournalGetPath(journalPath)) NormFile::Unlink(journalPath);
+        }
+    }
+    if (NULL != journal_mask)
+    {
+        delete[] journal_mask;
+        journal_mask = NULL;
+    }
+    journal_resume = false;
+}  // end NormFileObject::JournalClose()
+
 /////////////////////////////////////////////////////////////////
 //
 // NormDataObject Implementation
@@ -2539,7 +3544,8 @@ NormDataObject::NormDataObject(class NormSession&       theSession,
  : NormObject(DATA, theSession, theSender, objectId), 
    large_block_length(0), small_block_length(0),
    data_ptr(NULL), data_max(0), data_released(false),
-   data_free_func(dataFreeFunc)
+   data_free_func(dataFreeFunc), vec_list(NULL), vec_count(0), vec_index(0),
+   spilled(false)
 {
     
 }
@@ -2547,36 +3553,38 @@ NormDataObject::NormDataObject(class NormSession&       theSession,
 NormDataObject::~NormDataObject()
 {
     Close();
-    if (data_released)
-    {
-        if (NULL != data_ptr)
-        {
-            if (NULL != data_free_func)
-                data_free_func(data_ptr);
-            else
-                delete[] data_ptr;
-            data_ptr = NULL;
-        }
-        data_released = false;
-    }
+    FreeVector();
+    FreeData();
 }
 
-// Assign data object to data ptr
-bool NormDataObject::Open(char*       dataPtr,
-                          UINT32      dataLen,
-                          bool        dataRelease,
-                          const char* infoPtr,
-                          UINT16      infoLen)
+void NormDataObject::FreeData()
 {
-    if (data_released && (NULL != data_ptr))
+    if (spilled)
+    {
+        NormFile::Unmap(data_ptr, data_max);
+        data_ptr = NULL;
+        spilled = false;
+    }
+    else if (data_released && (NULL != data_ptr))
     {
         if (NULL != data_free_func)
             data_free_func(data_ptr);
         else
             delete[] data_ptr;
         data_ptr = NULL;
-        data_released = false;   
     }
+    data_released = false;
+}  // end NormDataObject::FreeData()
+
+// Assign data object to data ptr
+bool NormDataObject::Open(char*       dataPtr,
+                          UINT32      dataLen,
+                          bool        dataRelease,
+                          const char* infoPtr,
+                          UINT16      infoLen)
+{
+    FreeData();
+    FreeVector();
     if (NULL == sender)
     {
         // We're sending this data object
@@ -2593,6 +3601,8 @@ bool NormDataObject::Open(char*       dataPtr,
             Close();
             return false;
         }
+        if ((NULL != dataPtr) && session.SenderParityCache().IsEnabled() && (0 != nparity))
+            SenderSetParityKey(NormParityCache::Hash(dataPtr, dataLen));
     }
     else
     {
@@ -2604,8 +3614,98 @@ bool NormDataObject::Open(char*       dataPtr,
     data_released = dataRelease;
     large_block_length = NormObjectSize(large_block_size) * segment_size;
     small_block_length = NormObjectSize(small_block_size) * segment_size;
+    if ((NULL == sender) && (NULL != dataPtr) && session.SenderDigestEnabled())
+        SenderStartDigest();
     return true;
 }  // end NormDataObject::Open()
+
+bool NormDataObject::OpenV(const Vector* vecList,
+                           unsigned int  vecCount,
+                           const char*   infoPtr,
+                           UINT16        infoLen)
+{
+    if (NULL != sender)
+    {
+        PLOG(PL_FATAL, "NormDataObject::OpenV() error: not a sender object\n");
+        return false;
+    }
+    UINT32 dataLen = 0;
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < vecCount; i++)
+    {
+        if (0 == vecList[i].len) continue;
+        if ((NULL == vecList[i].ptr) || (vecList[i].len > (0xffffffff - dataLen)))
+        {
+            PLOG(PL_FATAL, "NormDataObject::OpenV() error: invalid data vector\n");
+            return false;
+        }
+        dataLen += vecList[i].len;
+        count++;
+    }
+    if (!Open(NULL, dataLen, false, infoPtr, infoLen))
+        return false;
+    if (0 == count) return true;
+    if (NULL == (vec_list = new Fragment[count]))
+    {
+        PLOG(PL_FATAL, "NormDataObject::OpenV() new vec_list error: %s\n", GetErrorString());
+        Close();
+        return false;
+    }
+    UINT32 offset = 0;
+    for (unsigned int i = 0; i < vecCount; i++)
+    {
+        if (0 == vecList[i].len) continue;
+        vec_list[vec_count].ptr = vecList[i].ptr;
+        vec_list[vec_count].len = vecList[i].len;
+        vec_list[vec_count].offset = offset;
+        offset += vecList[i].len;
+        vec_count++;
+    }
+    if (session.SenderParityCache().IsEnabled() && (0 != nparity))
+    {
+        UINT64 contentKey = NormParityCache::HASH_INIT;
+        for (unsigned int i = 0; i < vec_count; i++)
+            contentKey = NormParityCache::Hash(vec_list[i].ptr, vec_list[i].len, contentKey);
+        SenderSetParityKey(contentKey);
+    }
+    if (session.SenderDigestEnabled())
+        SenderStartDigest();
+    return true;
+}  // end NormDataObject::OpenV()
+
+void NormDataObject::ReadVector(UINT32 offset, char* buffer, UINT16 len)
+{
+    // Find the fragment containing "offset", starting with the last one used
+    unsigned int index = (vec_index < vec_count) ? vec_index : 0;
+    if ((offset < vec_list[index].offset) ||
+        (offset >= (vec_list[index].offset + vec_list[index].len)))
+    {
+        unsigned int lo = 0;
+        unsigned int hi = vec_count - 1;
+        while (lo < hi)
+        {
+            unsigned int mid = (lo + hi + 1) >> 1;
+            if (vec_list[mid].offset <= offset)
+                lo = mid;
+            else
+                hi = mid - 1;
+        }
+        index = lo;
+    }
+    while ((len > 0) && (index < vec_count))
+    {
+        const Fragment& frag = vec_list[index];
+        UINT32 fragOffset = offset - frag.offset;
+        UINT32 count = frag.len - fragOffset;
+        if (count > len) count = len;
+        memcpy(buffer, frag.ptr + fragOffset, count);
+        buffer += count;
+        offset += count;
+        len -= (UINT16)count;
+        if (fragOffset + count >= frag.len) index++;
+    }
+    vec_index = index;
+}  // end NormDataObject::ReadVector()
                 
 bool NormDataObject::Accept(char* dataPtr, UINT32 dataMax, bool dataRelease)
 {
@@ -2625,6 +3725,55 @@ void NormDataObject::Close()
     NormObject::Close();
 }  // end NormDataObject::Close()
 
+bool NormDataObject::Spill(const char* path)
+{
+    if (spilled) return true;
+    if ((NULL != sender) || ((NULL == data_ptr) && (NULL == vec_list) && (0 != data_max)))
+    {
+        PLOG(PL_ERROR, "NormDataObject::Spill() error: no tx data to spill\n");
+        return false;
+    }
+    char* mapPtr = NULL;
+    if (0 != data_max)
+    {
+        NormFile file;
+        if (!file.Open(path, O_CREAT | O_RDWR | O_TRUNC))
+        {
+            PLOG(PL_ERROR, "NormDataObject::Spill() error: unable to create \"%s\"\n", path);
+            NormFile::Unlink(path);
+            return false;
+        }
+        if (!file.Map(data_max))
+        {
+            PLOG(PL_WARN, "NormDataObject::Spill() error: unable to map \"%s\"\n", path);
+            file.Close();
+            NormFile::Unlink(path);
+            return false;
+        }
+        mapPtr = file.DetachMap();
+        file.Close();
+        NormFile::Unlink(path);  // (the mapping keeps the content until unmapped)
+        if (NULL != vec_list)
+        {
+            for (unsigned int i = 0; i < vec_count; i++)
+                memcpy(mapPtr + vec_list[i].offset, vec_list[i].ptr, vec_list[i].len);
+        }
+        else
+        {
+            memcpy(mapPtr, data_ptr, data_max);
+        }
+    }
+    else
+    {
+        NormFile::Unlink(path);  // (nothing to keep)
+    }
+    FreeData();
+    FreeVector();
+    data_ptr = mapPtr;
+    spilled = true;
+    return true;
+}  // end NormDataObject::Spill()
+
 bool NormDataObject::WriteSegment(NormBlockId   blockId, 
                                   NormSegmentId segmentId, 
                                   const char*   buffer)
@@ -2674,7 +3823,7 @@ UINT16 NormDataObject::ReadSegment(NormBlockId      blockId,
                                    NormSegmentId    segmentId,
                                    char*            buffer)            
 {
-    if (NULL == data_ptr)
+    if ((NULL == data_ptr) && (NULL == vec_list))
     {
         PLOG(PL_FATAL, "NormDataObject::ReadSegment() error: NULL data_ptr\n");
         return 0;    
@@ -2713,14 +3862,17 @@ UINT16 NormDataObject::ReadSegment(NormBlockId      blockId,
     else if (data_max <= (segmentOffset.LSB() + len))
         len -= (segmentOffset.LSB() + len - data_max);
     
-    memcpy(buffer, data_ptr + segmentOffset.LSB(), len);
+    if (NULL != vec_list)
+        ReadVector(segmentOffset.LSB(), buffer, len);
+    else
+        memcpy(buffer, data_ptr + segmentOffset.LSB(), len);
     return len;
 }  // end NormDataObject::ReadSegment()
 
 char* NormDataObject::RetrieveSegment(NormBlockId   blockId, 
                                       NormSegmentId segmentId)
 {
-    if (NULL == data_ptr)
+    if ((NULL == data_ptr) && (NULL == vec_list))
     {
         PLOG(PL_FATAL, "NormDataObject::RetrieveSegment() error: NULL data_ptr\n");
         return NULL;    
@@ -2753,7 +3905,7 @@ char* NormDataObject::RetrieveSegment(NormBlockId   blockId,
                                         segmentSize*segmentId;
     }
     ASSERT(0 == segmentOffset.MSB());  // we don't yet support super-sized "data" objects
-    if ((len < segment_size) || (data_max < (segmentOffset.LSB() + len)))
+    if ((len < segment_size) || (data_max < (segmentOffset.LSB() + len)) || (NULL != vec_list))
     {
         if (sender)
         {
@@ -2783,17 +3935,34 @@ NormStreamObject::NormStreamObject(class NormSession&       theSession,
                                    class NormSenderNode*    theSender,
                                    const NormObjectId&      objectId)
  : NormObject(STREAM, theSession, theSender, objectId), 
-   stream_sync(false), write_vacancy(false), 
-   read_init(true), read_ready(false),
-   flush_pending(false), msg_start(true),
+   stream_sync(false), write_reserve(NULL), write_reserve_len(0),
+   write_vacancy(false), read_init(true), read_ready(false), read_view_len(0),
+   read_msg_aligned(false), msg_index_mask(0), flush_pending(false), msg_start(true),
    flush_mode(FLUSH_NONE), push_mode(false),
    stream_broken(false), stream_closing(false),
+   coalesce_delay(0.0), coalesce_fill(0), coalesce_force(false), coalesce_active(false),
+   swr_window(0), swr_interval(0), swr_pending(false), swr_block_id(0), swr_end(0), swr_key(0),
+   swr_list(NULL), swr_buffer(NULL), swr_next(0),
+   ssp_interval(0), ssp_count(0), ssp_pending(false), ssp_valid(false),
    block_pool_threshold(0)
 {
+    coalesce_timer.SetListener(this, &NormStreamObject::OnCoalesceTimeout);
+    coalesce_timer.SetInterval(0.0);
+    coalesce_timer.SetRepeat(-1);
+    for (unsigned int i = 0; i < 2; i++)
+    {
+        event_hold[i].count = event_hold[i].posted = 0;
+        event_hold[i].held = false;
+    }
+    notify_timer.SetListener(this, &NormStreamObject::OnNotifyTimeout);
+    notify_timer.SetInterval(0.0);
+    notify_timer.SetRepeat(-1);
 }
 
 NormStreamObject::~NormStreamObject()
 {
+    if (coalesce_timer.IsActive()) coalesce_timer.Deactivate();
+    if (notify_timer.IsActive()) notify_timer.Deactivate();
     Close();
     tx_offset = write_offset = read_offset = 0;
     NormBlock* b;
@@ -2806,6 +3975,7 @@ NormStreamObject::~NormStreamObject()
     stream_buffer.Destroy();
     segment_pool.Destroy();
     block_pool.Destroy();
+    FreeWindowRepair();
 }  
 
 NormBlockId NormStreamObject::FlushBlockId() const
@@ -2874,6 +4044,7 @@ bool NormStreamObject::Open(UINT32      bufferSize,
     if (doubleBuffer) numBlocks *= 2;
     UINT32 numSegments = numBlocks * numData;
     
+    session.SetPoolSlabMode(segment_pool, block_pool);
     if (!block_pool.Init(numBlocks, numData))
     {
         PLOG(PL_FATAL, "NormStreamObject::Open() block_pool init error\n");
@@ -2894,19 +4065,37 @@ bool NormStreamObject::Open(UINT32      bufferSize,
         Close();
         return false;
     }    
+    if (NULL != sender)
+    {
+        // (a power of two block slot count keeps the slots fixed across id wrap)
+        UINT32 numSlots = 1;
+        while (numSlots < numBlocks) numSlots <<= 1;
+        if (!msg_index.Init(numSlots * numData))
+        {
+            PLOG(PL_FATAL, "NormStreamObject::Open() msg_index init error\n");
+            Close();
+            return false;
+        }
+        msg_index_mask = numSlots - 1;
+    }
     // (TBD) we really only need one set of indexes & offset
     // since our objects are exclusively read _or_ write
     read_init = true;
     
     read_index.block = read_index.segment = read_index.offset = 0;
+    read_view_len = 0;
+    read_msg_aligned = false;
     write_index.block = write_index.segment = 0;
     tx_index.block = tx_index.segment = 0;
     tx_offset = write_offset = read_offset = 0;
+    write_reserve = NULL;
     write_vacancy = true;
     stream_sync = false;
     flush_pending = false;
     msg_start = true;
     stream_closing = false;
+    ssp_count = 0;
+    ssp_pending = ssp_valid = false;
     return true;
 }  // end NormStreamObject::Open()
 
@@ -2934,6 +4123,8 @@ void NormStreamObject::Close(bool graceful)
     }
     else
     {
+        if (coalesce_timer.IsActive()) coalesce_timer.Deactivate();
+        if (notify_timer.IsActive()) notify_timer.Deactivate();
         NormObject::Close();
         write_vacancy = false;
     }
@@ -3209,9 +4400,13 @@ UINT16 NormStreamObject::ReadSegment(NormBlockId      blockId,
                 write_vacancy = true; 
             }
             if (write_vacancy) 
-                session.Notify(NormController::TX_QUEUE_VACANCY, NULL, this); 
+                PostEvent(EVENT_TX_VACANCY); 
         }       
     }
+    else if (event_hold[EVENT_TX_VACANCY].held)
+    {
+        PostEvent(EVENT_TX_VACANCY);  // (another segment's worth of vacancy)
+    }
     
     UINT16 segmentLength = NormDataMsg::ReadStreamPayloadLength(segment);
     ASSERT(segmentLength <= segment_size);
@@ -3227,6 +4422,20 @@ UINT16 NormStreamObject::ReadSegment(NormBlockId      blockId,
     return payloadLength;
 }  // end NormStreamObject::ReadSegment()
 
+UINT16 NormStreamObject::ReceiverCopySegment(NormBlockId      blockId, 
+                                             NormSegmentId    segmentId,
+                                             char*            buffer)
+{
+    NormBlock* block = stream_buffer.Find(blockId);
+    if (NULL == block) return 0;
+    const char* segment = block->GetSegment(segmentId);
+    if (NULL == segment) return 0;
+    UINT16 len = NormDataMsg::GetStreamPayloadHeaderLength() + 
+                 NormDataMsg::ReadStreamPayloadLength(segment);
+    memcpy(buffer, segment, len);
+    return len;
+}  // end NormStreamObject::ReceiverCopySegment()
+
 bool NormStreamObject::WriteSegment(NormBlockId   blockId, 
                                     NormSegmentId segmentId, 
                                     const char*   segment)
@@ -3268,6 +4477,13 @@ bool NormStreamObject::WriteSegment(NormBlockId   blockId,
                 PLOG(PL_DEBUG, "NormStreamObject::WriteSegment() blockId too old!?\n"); 
                 return false;
             }
+            if ((0 != read_view_len) && (block->GetId() == read_index.block))
+            {
+                // The app holds a ReadView() of this block, so drop the new
+                // segment (it may be repaired later) instead of the viewed data
+                PLOG(PL_DEBUG, "NormStreamObject::WriteSegment() stream buffer full with read view pending\n");
+                return false;
+            }
             while (block->IsPending())
             {
                 // Force read_index forward, giving app a chance to read data
@@ -3352,6 +4568,7 @@ bool NormStreamObject::WriteSegment(NormBlockId   blockId,
         }  // end while (block_pool.IsEmpty() || !stream_buffer.CanInsert(blockId))
         if (broken)
         {
+            NORM_PROBE2(stream_broken, (unsigned long)((NULL != sender) ? sender->GetId() : 0), (UINT16)transport_id);
             PLOG(PL_WARN, "NormStreamObject::WriteSegment() node>%lu obj>%hu blk>%lu seg>%hu broken stream ...\n",
                             (unsigned long)LocalNodeId(), (UINT16)transport_id, 
                             (unsigned long)blockId.GetValue(), (UINT16)segmentId);
@@ -3361,6 +4578,7 @@ bool NormStreamObject::WriteSegment(NormBlockId   blockId,
         block = block_pool.Get();
         block->SetId(blockId);
         block->ClearPending();
+        msg_index.UnsetBits(MsgIndexBit(blockId, 0), ndata);  // (stale marks from the slot's last block)
         //ASSERT(blockId >= read_index.block);
         ASSERT(Compare(blockId, read_index.block) >= 0);
         bool success = stream_buffer.Insert(block);
@@ -3381,6 +4599,11 @@ bool NormStreamObject::WriteSegment(NormBlockId   blockId,
         memcpy(s, segment, payloadLength);
         block->AttachSegment(segmentId, s);
         block->SetPending(segmentId);
+        if ((0 != NormDataMsg::ReadStreamPayloadMsgStart(segment)) &&
+            (0 != NormDataMsg::ReadStreamPayloadLength(segment)))
+        {
+            msg_index.Set(MsgIndexBit(blockId, segmentId));
+        }
         
         if (!read_ready)
         {
@@ -3499,65 +4722,707 @@ bool NormStreamObject::PassiveReadCheck(NormBlockId blockId, NormSegmentId segme
     return result;
 }  // end NormStreamObject::PassiveReadCheck()
 
-bool NormStreamObject::Read(char* buffer, unsigned int* buflen, bool seekMsgStart)
+bool NormStreamObject::SetWindowRepair(UINT16 window, UINT16 interval)
 {
-    // NOTES:  ReadPrivate() always returns "true" if it reads any bytes
-    //         It returns "false" upon a stream break.
-    //         To properly reset "update" notification, it needs to 
-    //         be called until it passes back a read byte count of zero.
-    //         So, upon read byte count < bytesWanted, we add an extra
-    //         call to ReadPrivate() to do that. I.e., so the "update"
-    //         notification is reset upon a short read count.  The 
-    //         "stream_broken" state variable is used for when this
-    //         extra ReadPrivate() call reveals the broken stream condition.
-    if (stream_broken && !seekMsgStart)
+    if (NULL != sender)
     {
-        if (NULL != buflen) *buflen = 0;
-        stream_broken = false;
+        PLOG(PL_ERROR, "NormStreamObject::SetWindowRepair() error: not a sender stream\n");
         return false;
     }
-    unsigned int bytesWanted;
-    if (NULL == buflen)
+    if ((0 != window) && (0 == interval))
     {
-        bytesWanted = 0;
-        buflen = &bytesWanted;
+        PLOG(PL_ERROR, "NormStreamObject::SetWindowRepair() error: invalid repair interval\n");
+        return false;
     }
-    else
+    swr_window = (window < ndata) ? window : ndata;
+    swr_interval = interval;
+    swr_pending = false;
+    return true;
+}  // end NormStreamObject::SetWindowRepair()
+
+bool NormStreamObject::SetSyncInterval(UINT16 interval)
+{
+    if (NULL != sender)
     {
-        bytesWanted = *buflen;
+        PLOG(PL_ERROR, "NormStreamObject::SetSyncInterval() error: not a sender stream\n");
+        return false;
     }
-    bool result = ReadPrivate(buffer, buflen, seekMsgStart);
-    if (!read_ready) 
+    ssp_interval = interval;
+    ssp_count = 0;
+    ssp_pending = false;
+    return true;
+}  // end NormStreamObject::SetSyncInterval()
+
+void NormStreamObject::SenderSyncSourceSent(NormBlockId blockId, NormSegmentId segmentId)
+{
+    if (0 == ssp_interval) return;
+    const char* segment = FindStreamSegment(blockId, segmentId);
+    UINT16 msgStart = (NULL != segment) ? NormDataMsg::ReadStreamPayloadMsgStart(segment) : 0;
+    if ((0 != msgStart) && (0 != NormDataMsg::ReadStreamPayloadLength(segment)))
     {
-        notify_on_update = true;
+        ssp_index.block = blockId;
+        ssp_index.segment = segmentId;
+        ssp_index.offset = msgStart - 1;
+        ssp_valid = true;
     }
-    if (!seekMsgStart && result && (0 != *buflen) && (*buflen < bytesWanted))
+    if (++ssp_count >= ssp_interval)
     {
-        char dummyBuffer[8];
-        unsigned int dummyCount = 8;
-        stream_broken = ReadPrivate(dummyBuffer, &dummyCount, false) ? false : true;
-        ASSERT(0 == dummyCount);
-        if (!read_ready) 
-        {
-            notify_on_update = true;
-        }
+        ssp_count = 0;
+        ssp_pending = ssp_valid;
     }
-    return result;
-}  // end NormStreamObject::Read()
+}  // end NormStreamObject::SenderSyncSourceSent()
 
+void NormStreamObject::SenderAttachSync(NormDataMsg* msg)
+{
+    if (!ssp_pending) return;
+    ssp_pending = false;
+    if (NULL == FindStreamSegment(ssp_index.block, ssp_index.segment))
+    {
+        // (receivers couldn't get it repaired anymore)
+        ssp_valid = false;
+        return;
+    }
+    NormStreamSyncExtension ext;
+    msg->AttachExtension(ext);
+    ext.SetSegmentId(ssp_index.segment);
+    ext.SetBlockId(ssp_index.block.GetValue());
+    ext.SetMsgOffset(ssp_index.offset);
+}  // end NormStreamObject::SenderAttachSync()
 
-// Sequential (in order) read/write routines (TBD) Add a "Seek()" method
-bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seekMsgStart)
+bool NormStreamObject::ReceiverGetSync(const NormObjectMsg& msg, NormBlockId blockId, Index& index) const
 {
-    if (stream_closing || read_init)
-    {
-        if (stream_closing)
-            PLOG(PL_DEBUG, "NormStreamObject::Read() attempted to read from closed stream\n");
-        *buflen = 0;
-        return seekMsgStart ? false : true;
-    }   
-    Retain();
-    unsigned int bytesRead = 0;
+    NormStreamSyncExtension ext;
+    if (!msg.FindExtension(NormHeaderExtension::STREAM_SYNC, ext) || !ext.IsValid()) return false;
+    index.block = ext.GetBlockId();
+    index.segment = ext.GetSegmentId();
+    index.offset = ext.GetMsgOffset();
+    if ((index.segment >= ndata) || (index.offset >= segment_size) || (Compare(index.block, blockId) > 0))
+    {
+        PLOG(PL_WARN, "NormStreamObject::ReceiverGetSync() node>%lu obj>%hu blk>%lu seg>%hu "
+                      "invalid sync point\n", (unsigned long)LocalNodeId(), (UINT16)transport_id,
+                      (unsigned long)index.block.GetValue(), (UINT16)index.segment);
+        return false;
+    }
+    return true;
+}  // end NormStreamObject::ReceiverGetSync()
+
+void NormStreamObject::ReceiverHandleSync(const NormDataMsg& msg, NormBlockId blockId)
+{
+    Index index;
+    if (read_init || !ReceiverGetSync(msg, blockId, index)) return;
+    if ((Compare(index.block, stream_sync_id) < 0) && (0 == read_offset) && (0 == read_view_len) &&
+        (read_index.block == stream_sync_id) && (0 == read_index.segment) && (0 == read_index.offset))
+    {
+        // Nothing has been read since the stream started, so move its start
+        // back to the message start (if well within our pending window) and
+        // have the blocks before it repaired
+        if (((UINT32)Difference(blockId, index.block) >= (pending_mask.GetSize() >> 1)) ||
+            !pending_mask.CanSet(index.block.GetValue()))
+        {
+            return;
+        }
+        pending_mask.SetBits(index.block.GetValue(), (UINT32)Difference(stream_sync_id, index.block));
+        stream_sync_id = index.block;
+        read_index = index;
+        read_msg_aligned = false;
+        PLOG(PL_DEBUG, "NormStreamObject::ReceiverHandleSync() node>%lu obj>%hu synced stream back to blk>%lu seg>%hu\n",
+                       (unsigned long)LocalNodeId(), (UINT16)transport_id,
+                       (unsigned long)index.block.GetValue(), (UINT16)index.segment);
+        return;
+    }
+    // (kept for a message start seek after a stream break)
+    ssp_index = index;
+    ssp_valid = true;
+}  // end NormStreamObject::ReceiverHandleSync()
+
+bool NormStreamObject::ReceiverSyncPoint(Index& index)
+{
+    if (!ssp_valid) return false;
+    ssp_valid = false;  // (used once)
+    if ((Compare(ssp_index.block, read_index.block) > 0) ||
+        ((ssp_index.block == read_index.block) && (ssp_index.segment > read_index.segment)))
+    {
+        index = ssp_index;
+        return true;
+    }
+    return false;
+}  // end NormStreamObject::ReceiverSyncPoint()
+
+const char* NormStreamObject::FindStreamSegment(NormBlockId blockId, NormSegmentId segmentId) const
+{
+    NormBlock* block = stream_buffer.Find(blockId);
+    return ((NULL != block) ? block->GetSegment(segmentId) : NULL);
+}  // end NormStreamObject::FindStreamSegment()
+
+void NormStreamObject::WindowAddMul(char* dst, const char* src, UINT8 c, unsigned int len)
+{
+    const UINT8* mulRow = Norm::GMULT[c];
+    NormGFKernel::AddMul8 addmul = NormGFKernel::GetAddMul8();
+    if (NULL != addmul)
+    {
+        addmul((UINT8*)dst, (const UINT8*)src, mulRow, len);
+    }
+    else
+    {
+        for (unsigned int i = 0; i < len; i++)
+            dst[i] ^= (char)mulRow[(UINT8)src[i]];
+    }
+}  // end NormStreamObject::WindowAddMul()
+
+void NormStreamObject::WindowScale(char* buffer, UINT8 c, unsigned int len)
+{
+    const UINT8* mulRow = Norm::GMULT[c];
+    for (unsigned int i = 0; i < len; i++)
+        buffer[i] = (char)mulRow[(UINT8)buffer[i]];
+}  // end NormStreamObject::WindowScale()
+
+void NormStreamObject::SenderWindowSourceSent(NormBlockId blockId, NormSegmentId segmentId)
+{
+    if ((0 == swr_window) || (0 != ((segmentId + 1) % swr_interval))) return;
+    swr_pending = true;
+    swr_block_id = blockId;
+    swr_end = segmentId + 1;
+}  // end NormStreamObject::SenderWindowSourceSent()
+
+bool NormStreamObject::SenderNextWindowRepair(NormDataMsg* msg)
+{
+    if (!swr_pending) return false;
+    swr_pending = false;
+    UINT16 first = (swr_end > swr_window) ? (swr_end - swr_window) : 0;
+    // Make sure the window's source segments are still buffered
+    for (UINT16 i = first; i < swr_end; i++)
+    {
+        if (NULL == FindStreamSegment(swr_block_id, i))
+        {
+            PLOG(PL_DEBUG, "NormStreamObject::SenderNextWindowRepair() window blk>%lu no longer buffered\n",
+                           (unsigned long)swr_block_id.GetValue());
+            return false;
+        }
+    }
+    NormWindowRepairExtension ext;
+    msg->AttachExtension(ext);
+    ext.SetFirstSegment(first);
+    ext.SetSegmentCount(swr_end - first);
+    ext.SetRepairKey(swr_key);
+    UINT16 payloadMax = segment_size + NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    char* payload = msg->AccessPayload();
+    memset(payload, 0, payloadMax);
+    UINT16 payloadLength = 0;
+    UINT32 state = WindowRepairSeed(swr_key);
+    for (UINT16 i = first; i < swr_end; i++)
+    {
+        UINT8 c = WindowRepairCoefficient(state);
+        const char* segment = FindStreamSegment(swr_block_id, i);
+        UINT16 len = NormDataMsg::ReadStreamPayloadLength(segment) + NormDataMsg::GetStreamPayloadHeaderLength();
+        if (len > payloadMax) len = payloadMax;
+        WindowAddMul(payload, segment, c, len);
+        if (len > payloadLength) payloadLength = len;
+    }
+    msg->SetPayloadLength(payloadLength);
+    msg->SetFecPayloadId(fec_id, swr_block_id.GetValue(), WindowRepairId(), GetBlockSize(swr_block_id), fec_m);
+    swr_key++;
+    return true;
+}  // end NormStreamObject::SenderNextWindowRepair()
+
+unsigned int NormStreamObject::ReceiverHandleWindowRepair(NormBlock* block, const NormDataMsg& msg)
+{
+    NormWindowRepairExtension ext;
+    if (!msg.FindExtension(NormHeaderExtension::WINDOW_REPAIR, ext) || !ext.IsValid())
+    {
+        PLOG(PL_DEBUG, "NormStreamObject::ReceiverHandleWindowRepair() window repair extension missing\n");
+        return 0;
+    }
+    NormBlockId blockId = block->GetId();
+    UINT16 numData = GetBlockSize(blockId);
+    UINT16 first = ext.GetFirstSegment();
+    UINT16 count = ext.GetSegmentCount();
+    UINT16 payloadLength = msg.GetPayloadLength();
+    UINT16 payloadMax = segment_size + NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+    payloadLength = MIN(payloadLength, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    if ((0 == count) || (first >= numData) || (count > (numData - first)) || (payloadLength > payloadMax))
+    {
+        PLOG(PL_WARN, "NormStreamObject::ReceiverHandleWindowRepair() node>%lu obj>%hu blk>%lu "
+                      "invalid window repair\n", (unsigned long)LocalNodeId(), (UINT16)transport_id,
+                      (unsigned long)blockId.GetValue());
+        return 0;
+    }
+    if (block->DecodePending()) return 0;
+    // Only repairs covering a missing segment are of use
+    NormSegmentId firstPending = first;
+    if (!block->GetNextPending(firstPending) || (firstPending >= (first + count)))
+        return 0;
+    if (NULL == swr_list)
+    {
+        // Buffered repair payloads are followed by as much decoding work space
+        if ((NULL == (swr_list = new WindowRepair[WINDOW_REPAIR_MAX])) ||
+            (NULL == (swr_buffer = new char[2 * WINDOW_REPAIR_MAX * payloadMax])))
+        {
+            PLOG(PL_ERROR, "NormStreamObject::ReceiverHandleWindowRepair() new window repair buffer error: %s\n",
+                           GetErrorString());
+            FreeWindowRepair();
+            return 0;
+        }
+        for (unsigned int i = 0; i < WINDOW_REPAIR_MAX; i++)
+        {
+            swr_list[i].valid = false;
+            swr_list[i].payload = swr_buffer + i*payloadMax;
+        }
+        swr_next = 0;
+    }
+    // The oldest buffered repair is replaced
+    WindowRepair& repair = swr_list[swr_next];
+    swr_next = (swr_next + 1) % WINDOW_REPAIR_MAX;
+    repair.block_id = blockId;
+    repair.first = first;
+    repair.count = count;
+    repair.key = ext.GetRepairKey();
+    memcpy(repair.payload, msg.GetPayload(), payloadLength);
+    if (payloadLength < payloadMax)
+        memset(repair.payload + payloadLength, 0, payloadMax - payloadLength);
+    repair.valid = true;
+    return ReceiverWindowDecode(block);
+}  // end NormStreamObject::ReceiverHandleWindowRepair()
+
+unsigned int NormStreamObject::ReceiverWindowDecode(NormBlock* block)
+{
+    NormBlockId blockId = block->GetId();
+    UINT16 payloadMax = segment_size + NormDataMsg::GetStreamPayloadHeaderLength();
+#ifdef SIMULATE
+    payloadMax = MIN(payloadMax, SIM_PAYLOAD_MAX);
+#endif // SIMULATE
+    // Gather the block's buffered repairs and the missing segments they cover
+    WindowRepair* repairList[WINDOW_REPAIR_MAX];
+    NormSegmentId missingList[WINDOW_REPAIR_MAX];
+    unsigned int numRows = 0;
+    unsigned int numMissing = 0;
+    for (unsigned int i = 0; i < WINDOW_REPAIR_MAX; i++)
+    {
+        WindowRepair& repair = swr_list[i];
+        if (!repair.valid || (repair.block_id != blockId)) continue;
+        for (UINT16 j = repair.first; j < (repair.first + repair.count); j++)
+        {
+            if (!block->IsPending(j)) continue;
+            unsigned int m = 0;
+            while ((m < numMissing) && (missingList[m] != j)) m++;
+            if (m < numMissing) continue;
+            if (WINDOW_REPAIR_MAX == numMissing) return 0;  // (too many to solve for)
+            missingList[numMissing++] = j;
+        }
+        repairList[numRows++] = &repair;
+    }
+    if (numMissing > numRows) return 0;  // (wait for more repairs)
+    // Reduce each repair by the (known) source segments it covers, leaving
+    // the coefficients of the missing ones as a row of the system to solve
+    UINT8 matrix[WINDOW_REPAIR_MAX][WINDOW_REPAIR_MAX];
+    char* rowList[WINDOW_REPAIR_MAX];
+    char* work = swr_buffer + WINDOW_REPAIR_MAX*payloadMax;
+    for (unsigned int r = 0; r < numRows; r++)
+    {
+        WindowRepair& repair = *repairList[r];
+        char* row = work + r*payloadMax;
+        memcpy(row, repair.payload, payloadMax);
+        memset(matrix[r], 0, WINDOW_REPAIR_MAX);
+        UINT32 state = WindowRepairSeed(repair.key);
+        for (UINT16 j = repair.first; j < (repair.first + repair.count); j++)
+        {
+            UINT8 c = WindowRepairCoefficient(state);
+            if (block->IsPending(j))
+            {
+                for (unsigned int m = 0; m < numMissing; m++)
+                {
+                    if (missingList[m] == j)
+                    {
+                        matrix[r][m] = c;
+                        break;
+                    }
+                }
+                continue;
+            }
+            const char* segment = block->GetSegment(j);
+            if (NULL == segment) segment = FindStreamSegment(blockId, j);
+            if (NULL == segment)
+            {
+                // (e.g. the stream buffer was pruned past it)
+                PLOG(PL_DEBUG, "NormStreamObject::ReceiverWindowDecode() blk>%lu seg>%hu unavailable\n",
+                               (unsigned long)blockId.GetValue(), (UINT16)j);
+                repair.valid = false;
+                return 0;
+            }
+            UINT16 len = NormDataMsg::ReadStreamPayloadLength(segment) + NormDataMsg::GetStreamPayloadHeaderLength();
+            if (len > payloadMax) len = payloadMax;
+            WindowAddMul(row, segment, c, len);
+        }
+        rowList[r] = row;
+    }
+    // Gauss-Jordan elimination over GF(2^8)
+    for (unsigned int col = 0; col < numMissing; col++)
+    {
+        unsigned int pivot = col;
+        while ((pivot < numRows) && (0 == matrix[pivot][col])) pivot++;
+        if (pivot == numRows) return 0;  // (not solvable yet)
+        if (pivot != col)
+        {
+            UINT8 temp[WINDOW_REPAIR_MAX];
+            memcpy(temp, matrix[col], WINDOW_REPAIR_MAX);
+            memcpy(matrix[col], matrix[pivot], WINDOW_REPAIR_MAX);
+            memcpy(matrix[pivot], temp, WINDOW_REPAIR_MAX);
+            char* row = rowList[col];
+            rowList[col] = rowList[pivot];
+            rowList[pivot] = row;
+        }
+        UINT8 c = matrix[col][col];
+        if (1 != c)
+        {
+            UINT8 inv = ginv(c);
+            for (unsigned int k = col; k < numMissing; k++)
+                matrix[col][k] = gmult(matrix[col][k], inv);
+            WindowScale(rowList[col], inv, payloadMax);
+        }
+        for (unsigned int r = 0; r < numRows; r++)
+        {
+            UINT8 f = matrix[r][col];
+            if ((r == col) || (0 == f)) continue;
+            for (unsigned int k = col; k < numMissing; k++)
+                matrix[r][k] ^= gmult(f, matrix[col][k]);
+            WindowAddMul(rowList[r], rowList[col], f, payloadMax);
+        }
+    }
+    // Row "m" is now the content of missing segment "missingList[m]"
+    unsigned int recovered = 0;
+    for (unsigned int m = 0; m < numMissing; m++)
+    {
+        NormSegmentId sid = missingList[m];
+        const char* segment = rowList[m];
+        UINT16 segmentLength = NormDataMsg::ReadStreamPayloadLength(segment);
+        if (segmentLength > segment_size)
+        {
+            PLOG(PL_WARN, "NormStreamObject::ReceiverWindowDecode() node>%lu obj>%hu blk>%lu seg>%hu "
+                          "invalid decoded segment\n", (unsigned long)LocalNodeId(), (UINT16)transport_id,
+                          (unsigned long)blockId.GetValue(), (UINT16)sid);
+            continue;
+        }
+        block->UnsetPending(sid);
+        block->DecrementErasureCount();
+        if (WriteSegment(blockId, sid, segment))
+        {
+            ReceiverDigestSegment(block, sid, segment);
+            // For statistics only (TBD) #ifdef NORM_DEBUG
+            sender->IncrementRecvGoodput(segmentLength);
+        }
+        else
+        {
+            PLOG(PL_DEBUG, "NormStreamObject::ReceiverWindowDecode() WriteSegment() error\n");
+        }
+        recovered++;
+    }
+    // The block's buffered repairs have nothing more to offer
+    for (unsigned int r = 0; r < numRows; r++)
+        repairList[r]->valid = false;
+    PLOG(PL_DETAIL, "NormStreamObject::ReceiverWindowDecode() node>%lu obj>%hu blk>%lu recovered %u segments\n",
+                    (unsigned long)LocalNodeId(), (UINT16)transport_id, (unsigned long)blockId.GetValue(), recovered);
+    return recovered;
+}  // end NormStreamObject::ReceiverWindowDecode()
+
+void NormStreamObject::FreeWindowRepair()
+{
+    if (NULL != swr_list)
+    {
+        delete[] swr_list;
+        swr_list = NULL;
+    }
+    if (NULL != swr_buffer)
+    {
+        delete[] swr_buffer;
+        swr_buffer = NULL;
+    }
+    swr_next = 0;
+}  // end NormStreamObject::FreeWindowRepair()
+
+bool NormStreamObject::Read(char* buffer, unsigned int* buflen, bool seekMsgStart)
+{
+    // NOTES:  ReadPrivate() always returns "true" if it reads any bytes
+    //         It returns "false" upon a stream break.
+    //         To properly reset "update" notification, it needs to 
+    //         be called until it passes back a read byte count of zero.
+    //         So, upon read byte count < bytesWanted, we add an extra
+    //         call to ReadPrivate() to do that. I.e., so the "update"
+    //         notification is reset upon a short read count.  The 
+    //         "stream_broken" state variable is used for when this
+    //         extra ReadPrivate() call reveals the broken stream condition.
+    read_msg_aligned = false;
+    if (stream_broken && !seekMsgStart)
+    {
+        if (NULL != buflen) *buflen = 0;
+        stream_broken = false;
+        return false;
+    }
+    unsigned int bytesWanted;
+    if (NULL == buflen)
+    {
+        bytesWanted = 0;
+        buflen = &bytesWanted;
+    }
+    else
+    {
+        bytesWanted = *buflen;
+    }
+    read_view_len = 0;  // (unlocks any outstanding ReadView())
+    bool result = ReadPrivate(buffer, buflen, seekMsgStart);
+    if (!read_ready) 
+    {
+        notify_on_update = true;
+    }
+    if (!seekMsgStart && result && (0 != *buflen) && (*buflen < bytesWanted))
+    {
+        char dummyBuffer[8];
+        unsigned int dummyCount = 8;
+        stream_broken = ReadPrivate(dummyBuffer, &dummyCount, false) ? false : true;
+        ASSERT(0 == dummyCount);
+        if (!read_ready) 
+        {
+            notify_on_update = true;
+        }
+    }
+    return result;
+}  // end NormStreamObject::Read()
+
+bool NormStreamObject::ReadView(const char*& buffer, unsigned int& buflen)
+{
+    buffer = NULL;
+    read_view_len = 0;
+    read_msg_aligned = false;
+    if (stream_broken)
+    {
+        buflen = 0;
+        stream_broken = false;
+        return false;
+    }
+    if (0 == buflen) buflen = 0xffffffff;
+    bool result = ReadPrivate(NULL, &buflen, false, &buffer);
+    if (0 != buflen)
+        read_view_len = (UINT16)buflen;
+    else if (!read_ready) 
+        notify_on_update = true;
+    return result;
+}  // end NormStreamObject::ReadView()
+
+bool NormStreamObject::ReadRelease(unsigned int numBytes)
+{
+    if (numBytes > read_view_len)
+    {
+        PLOG(PL_ERROR, "NormStreamObject::ReadRelease() error: release of %u bytes exceeds read view length %hu\n",
+                       numBytes, read_view_len);
+        return false;
+    }
+    read_view_len = 0;
+    if (0 == numBytes) return true;
+    NormBlock* block = stream_buffer.Find(read_index.block);
+    char* segment = (NULL != block) ? block->GetSegment(read_index.segment) : NULL;
+    if (NULL == segment)
+    {
+        // (e.g., the stream was closed while the view was held)
+        PLOG(PL_ERROR, "NormStreamObject::ReadRelease() error: viewed segment no longer buffered\n");
+        return false;
+    }
+    UINT16 length = NormDataMsg::ReadStreamPayloadLength(segment);
+    read_index.offset += numBytes;
+    read_offset += numBytes;
+    if (read_index.offset >= length)
+    {
+        // Viewed segment is fully consumed, so advance as ReadPrivate() does
+        block->UnsetPending(read_index.segment++);
+        read_index.offset = 0;
+        if (read_index.segment >= ndata) 
+        {
+            stream_buffer.Remove(block);
+            block->EmptyToPool(segment_pool);
+            block_pool.Put(block);
+            Increment(read_index.block);
+            read_index.segment = 0;
+            Prune(read_index.block, false);
+            read_ready = DetermineReadReadiness();
+        }
+        else
+        {
+            read_ready = (NULL != block->GetSegment(read_index.segment));
+        }
+        if (!read_ready) notify_on_update = true;
+    }
+    return true;
+}  // end NormStreamObject::ReadRelease()
+
+bool NormStreamObject::ReadMsg(char* buffer, unsigned int* buflen)
+{
+    unsigned int bytesWanted = *buflen;
+    *buflen = 0;
+    if (stream_broken)
+    {
+        stream_broken = false;
+        read_msg_aligned = false;
+        return false;
+    }
+    if (!read_msg_aligned)
+    {
+        // Are we at a message start already? (else seek to the next one)
+        NormBlock* block = stream_buffer.Find(read_index.block);
+        char* segment = (NULL != block) ? block->GetSegment(read_index.segment) : NULL;
+        UINT16 msgStart = (NULL != segment) ? NormDataMsg::ReadStreamPayloadMsgStart(segment) : 0;
+        if ((0 == msgStart) || ((msgStart - 1) != read_index.offset))
+        {
+            unsigned int numBytes = 0;
+            read_view_len = 0;
+            if (!ReadPrivate(NULL, &numBytes, true))
+            {
+                if (!read_ready) notify_on_update = true;
+                return true;  // (no message start buffered yet)
+            }
+        }
+        read_msg_aligned = true;
+    }
+    // Measure the message, stopping at the next message start
+    // (or stream end) and returning if any of it is still missing
+    UINT32 msgLen = 0;
+    Index index = read_index;
+    bool msgEnd = false;
+    while (true)
+    {
+        NormBlock* block = stream_buffer.Find(index.block);
+        char* segment = (NULL != block) ? block->GetSegment(index.segment) : NULL;
+        if (NULL == segment) break;
+        UINT16 length = NormDataMsg::ReadStreamPayloadLength(segment);
+        if ((0 == length) || (length > segment_size))
+        {
+            // (the Read() below handles stream end or bad segments)
+            msgEnd = true;
+            break;
+        }
+        if (0 == msgLen)
+        {
+            msgLen = length - read_index.offset;  // (the message's first segment)
+        }
+        else
+        {
+            UINT16 msgStart = NormDataMsg::ReadStreamPayloadMsgStart(segment);
+            if (0 != msgStart)
+            {
+                msgLen += (msgStart - 1);
+                msgEnd = true;
+                break;
+            }
+            msgLen += length;
+        }
+        if (++index.segment >= ndata)
+        {
+            Increment(index.block);
+            index.segment = 0;
+        }
+    }
+    if (!msgEnd)
+    {
+        notify_on_update = true;  // (so the rest of it prompts an update)
+        return true;  // (message not yet complete)
+    }
+    if (msgLen > bytesWanted)
+    {
+        *buflen = msgLen;
+        return true;
+    }
+    *buflen = msgLen;
+    bool result = Read(buffer, buflen);
+    read_msg_aligned = result && (*buflen == msgLen);
+    return result;
+}  // end NormStreamObject::ReadMsg()
+
+bool NormStreamObject::FindMsgStart(Index& index)
+{
+    UINT32 numBits = msg_index.GetSize();
+    if (0 == numBits) return false;
+    UINT32 startBit = MsgIndexBit(read_index.block, read_index.segment);
+    UINT32 readSlot = read_index.block.GetValue() & msg_index_mask;
+    UINT32 bit = startBit;
+    bool wrapped = false;
+    while (true)
+    {
+        if (!msg_index.GetNextSet(bit) || (wrapped && (bit >= startBit)))
+        {
+            if (wrapped) return false;
+            wrapped = true;
+            bit = 0;
+            continue;
+        }
+        // Map the bit back to its block id (at or after the read_index)
+        NormBlockId blockId = read_index.block;
+        Increment(blockId, ((bit / ndata) - readSlot) & msg_index_mask);
+        NormSegmentId segmentId = bit % ndata;
+        NormBlock* block = stream_buffer.Find(blockId);
+        char* segment = (NULL != block) ? block->GetSegment(segmentId) : NULL;
+        UINT16 msgStart = (NULL != segment) ? NormDataMsg::ReadStreamPayloadMsgStart(segment) : 0;
+        if (0 != msgStart)
+        {
+            if ((blockId != read_index.block) || (segmentId > read_index.segment) ||
+                ((segmentId == read_index.segment) && ((msgStart - 1) >= read_index.offset)))
+            {
+                index.block = blockId;
+                index.segment = segmentId;
+                index.offset = msgStart - 1;
+                return true;
+            }
+            // else it's behind the read_index (a wrapped search of the current block)
+        }
+        else
+        {
+            msg_index.Unset(bit);  // (stale mark)
+        }
+        bit++;
+    }
+}  // end NormStreamObject::FindMsgStart()
+
+// Moves the read_index forward to the start of "index.segment", releasing the skipped data
+void NormStreamObject::ReadAdvance(const Index& index)
+{
+    bool blockChanged = false;
+    while (index.block != read_index.block)
+    {
+        NormBlock* block = stream_buffer.Find(read_index.block);
+        if (NULL != block)
+        {
+            stream_buffer.Remove(block);
+            block->EmptyToPool(segment_pool);
+            block_pool.Put(block);
+        }
+        Increment(read_index.block);
+        read_index.segment = 0;
+        blockChanged = true;
+    }
+    if (blockChanged) Prune(read_index.block, false);
+    NormBlock* block = stream_buffer.Find(read_index.block);
+    while (read_index.segment < index.segment)
+    {
+        if (NULL != block) block->UnsetPending(read_index.segment);
+        read_index.segment++;
+    }
+    read_index.offset = 0;
+}  // end NormStreamObject::ReadAdvance()
+
+
+// Sequential (in order) read/write routines (TBD) Add a "Seek()" method
+bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seekMsgStart, const char** view)
+{
+    if (stream_closing || read_init)
+    {
+        if (stream_closing)
+            PLOG(PL_DEBUG, "NormStreamObject::Read() attempted to read from closed stream\n");
+        *buflen = 0;
+        return seekMsgStart ? false : true;
+    }   
+    Retain();
+    unsigned int bytesRead = 0;
     unsigned int bytesToRead = *buflen;
     bool brokenStream = false;
     do
@@ -3606,6 +5471,12 @@ bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seek
                 }
                 if (forceForward)
                 {
+                    Index msgIndex;
+                    if (seekMsgStart && (FindMsgStart(msgIndex) || ReceiverSyncPoint(msgIndex)))
+                    {
+                        ReadAdvance(msgIndex);  // (skip straight to the next message start)
+                        continue;
+                    }
                     Increment(read_index.block);  
                     read_index.segment = 0; 
                     read_index.offset = 0;
@@ -3666,6 +5537,12 @@ bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seek
                 }
                 if (forceForward)
                 {
+                    Index msgIndex;
+                    if (seekMsgStart && (FindMsgStart(msgIndex) || ReceiverSyncPoint(msgIndex)))
+                    {
+                        ReadAdvance(msgIndex);  // (skip straight to the next message start)
+                        continue;
+                    }
                     // Force read_index forward and try again if seeking msg start
                     if (++read_index.segment >= ndata)
                     {
@@ -3822,6 +5699,15 @@ bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seek
                     stream_closing = true;
                     sender->DeleteObject(this);
                 }
+                else
+                {
+                    Index msgIndex;
+                    if (FindMsgStart(msgIndex))
+                    {
+                        ReadAdvance(msgIndex);  // (skip straight to the next message start)
+                        continue;
+                    }
+                }
                 // Don't bother managing individual segments since
                 // stream buffers are exact multiples of block size!
                 //block->DetachSegment(read_index.segment);
@@ -3848,6 +5734,15 @@ bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seek
         }
         UINT16 count = length - read_index.offset;
         count = MIN(count, bytesToRead);
+        if ((NULL != view) && (0 != count))
+        {
+            // Point the caller at the segment data in place and leave
+            // the read indices as-is until ReadRelease() is called
+            *view = segment + read_index.offset + NormDataMsg::GetStreamPayloadHeaderLength();
+            *buflen = count;
+            Release();
+            return true;
+        }
 #ifdef SIMULATE
         UINT16 simCount = read_index.offset + count + NormDataMsg::GetStreamPayloadHeaderLength();
         simCount = (simCount < SIM_PAYLOAD_MAX) ? (SIM_PAYLOAD_MAX - simCount) : 0;
@@ -3904,7 +5799,7 @@ bool NormStreamObject::ReadPrivate(char* buffer, unsigned int* buflen, bool seek
 void NormStreamObject::Terminate()
 {
     // Flush stream and create a ZERO length segment to send
-    Flush();  // should eom be set for this call?
+    FlushCoalesced();  // should eom be set for this call?
     stream_closing = true;
     NormBlock* block = stream_buffer.Find(write_index.block);
     if (NULL == block)
@@ -4036,178 +5931,215 @@ unsigned int NormStreamObject::GetVacancy(unsigned int wanted)
     return nBytes;
 }  // end NormStreamObject::GetVacancy()
 
-UINT32 NormStreamObject::Write(const char* buffer, UINT32 len, bool eom)
-{               
-    UINT32 nBytes = 0;
-    do
+char* NormStreamObject::AcquireWriteSegment(NormBlock*& block)
+{
+    // This old code detected buffer "fullness" by offset instead of segment index
+    // but, the problem there was when apps wrote & flushed messages smaller than
+    // the segment_size, the buffer was used up before this detected it.
+    //INT32 deltaOffset = write_offset - tx_offset;  // (TBD) deprecate tx_offset
+    //ASSERT(deltaOffset >= 0);
+    //if (deltaOffset >= (INT32)object_size.LSB())
+    //ASSERT(write_index.block >= tx_index.block);
+    ASSERT(Compare(write_index.block, tx_index.block) >= 0);
+    UINT32 deltaBlock = (UINT32)Difference(write_index.block, tx_index.block);
+    if (deltaBlock > (block_pool.GetTotal() >> 1))  
     {
-        if (stream_closing)
-        {
-            if (0 != len)
-            {
-                PLOG(PL_ERROR, "NormStreamObject::Write() error: stream is closing (len:%lu eom:%d)\n", 
-                                (unsigned long)len, eom);
-                len = 0;
-            }
-            break;
-        }
-        // This old code detected buffer "fullness" by offset instead of segment index
-        // but, the problem there was when apps wrote & flushed messages smaller than
-        // the segment_size, the buffer was used up before this detected it.
-        //INT32 deltaOffset = write_offset - tx_offset;  // (TBD) deprecate tx_offset
-        //ASSERT(deltaOffset >= 0);
-        //if (deltaOffset >= (INT32)object_size.LSB())
-        //ASSERT(write_index.block >= tx_index.block);
-        ASSERT(Compare(write_index.block, tx_index.block) >= 0);
-        UINT32 deltaBlock = (UINT32)Difference(write_index.block, tx_index.block);
-        if (deltaBlock > (block_pool.GetTotal() >> 1))  
-        {
-            write_vacancy = false;
-            PLOG(PL_DEBUG, "NormStreamObject::Write() stream buffer full (1)\n");
-            if (!push_mode) break;  
-        }
-        NormBlock* block = stream_buffer.Find(write_index.block);
+        write_vacancy = false;
+        PLOG(PL_DEBUG, "NormStreamObject::AcquireWriteSegment() stream buffer full (1)\n");
+        if (!push_mode) return NULL;  
+    }
+    block = stream_buffer.Find(write_index.block);
+    if (NULL == block)
+    {   
+        block = block_pool.Get();
         if (NULL == block)
-        {   
-            block = block_pool.Get();
-            if (NULL == block)
+        {
+            block = stream_buffer.Find(stream_buffer.RangeLo());
+            ASSERT(NULL != block);
+            double delay = session.GetFlowControlDelay() - block->GetNackAge();
+            if (block->IsPending() || (delay >= 1.0e-06))
             {
-                block = stream_buffer.Find(stream_buffer.RangeLo());
-                ASSERT(NULL != block);
-                double delay = session.GetFlowControlDelay() - block->GetNackAge();
-                if (block->IsPending() || (delay >= 1.0e-06))
+                write_vacancy = false;
+                if (push_mode)
                 {
-                    write_vacancy = false;
-                    if (push_mode)
+                    NormBlockId blockId = block->GetId();
+                    pending_mask.Unset(blockId.GetValue());
+                    repair_mask.Unset(blockId.GetValue());
+                    NormBlock* b = FindBlock(blockId);
+                    if (b)
                     {
-                        NormBlockId blockId = block->GetId();
-                        pending_mask.Unset(blockId.GetValue());
-                        repair_mask.Unset(blockId.GetValue());
-                        NormBlock* b = FindBlock(blockId);
-                        if (b)
-                        {
-                            block_buffer.Remove(b);
-                            session.SenderPutFreeBlock(b); 
-                        }   
-                        if (!pending_mask.IsSet()) 
-                        {
-                            pending_mask.Set(write_index.block.GetValue());  
-                            //stream_next_id = write_index.block + 1;
-                            stream_next_id = write_index.block;
-                            Increment(stream_next_id);
-                        }
+                        block_buffer.Remove(b);
+                        session.SenderPutFreeBlock(b); 
+                    }   
+                    if (!pending_mask.IsSet()) 
+                    {
+                        pending_mask.Set(write_index.block.GetValue());  
+                        //stream_next_id = write_index.block + 1;
+                        stream_next_id = write_index.block;
+                        Increment(stream_next_id);
                     }
-                    else
+                }
+                else
+                {
+                    // The timer activated here makes sure a deferred TX_QUEUE_VACANCY is posted
+                    // when flow control has been asserted.
+                    if (!block->IsPending())
                     {
-                        // The timer activated here makes sure a deferred TX_QUEUE_VACANCY is posted
-                        // when flow control has been asserted.
-                        if (!block->IsPending())
-                        {
-                            PLOG(PL_DEBUG, "NormStreamObject::Write() asserting flow control for stream (postedEmpty:%d)\n", 
-                                           session.GetPostedTxQueueEmpty());
-                            if (session.GetPostedTxQueueEmpty())
-                                session.ActivateFlowControl(delay, GetId(), NormController::TX_QUEUE_EMPTY);
-                            else
-                                session.ActivateFlowControl(delay, GetId(), NormController::TX_QUEUE_VACANCY);
-                        }
-                        PLOG(PL_DEBUG, "NormStreamObject::Write() stream buffer full (2) len:%d eom:%d\n", len, eom);
-                        break;
+                        PLOG(PL_DEBUG, "NormStreamObject::AcquireWriteSegment() asserting flow control for stream (postedEmpty:%d)\n", 
+                                       session.GetPostedTxQueueEmpty());
+                        if (session.GetPostedTxQueueEmpty())
+                            session.ActivateFlowControl(delay, GetId(), NormController::TX_QUEUE_EMPTY);
+                        else
+                            session.ActivateFlowControl(delay, GetId(), NormController::TX_QUEUE_VACANCY);
                     }
-                }                             
-                stream_buffer.Remove(block);
-                block->EmptyToPool(segment_pool);
-            }
-            block->SetId(write_index.block);
-            block->ClearPending();
-            bool success = stream_buffer.Insert(block);
-            ASSERT(success);
-        }  // end if (NULL == block)
-        char* segment = block->GetSegment(write_index.segment);
-        if (NULL == segment)
+                    PLOG(PL_DEBUG, "NormStreamObject::AcquireWriteSegment() stream buffer full (2)\n");
+                    return NULL;
+                }
+            }                             
+            stream_buffer.Remove(block);
+            block->EmptyToPool(segment_pool);
+        }
+        block->SetId(write_index.block);
+        block->ClearPending();
+        bool success = stream_buffer.Insert(block);
+        ASSERT(success);
+    }  // end if (NULL == block)
+    char* segment = block->GetSegment(write_index.segment);
+    if (NULL == segment)
+    {
+        if (NULL == (segment = segment_pool.Get()))
         {
-            if (NULL == (segment = segment_pool.Get()))
+            NormBlock* b = stream_buffer.Find(stream_buffer.RangeLo());
+            ASSERT(b != block);
+            if (b->IsPending())
             {
-                NormBlock* b = stream_buffer.Find(stream_buffer.RangeLo());
-                ASSERT(b != block);
-                if (b->IsPending())
+                write_vacancy = false;
+                if (push_mode)
                 {
-                    write_vacancy = false;
-                    if (push_mode)
+                    NormBlockId blockId = b->GetId();
+                    pending_mask.Unset(blockId.GetValue());
+                    repair_mask.Unset(blockId.GetValue());
+                    NormBlock* c = FindBlock(blockId);
+                    if (c)
                     {
-                        NormBlockId blockId = b->GetId();
-                        pending_mask.Unset(blockId.GetValue());
-                        repair_mask.Unset(blockId.GetValue());
-                        NormBlock* c = FindBlock(blockId);
-                        if (c)
-                        {
-                            block_buffer.Remove(c);
-                            session.SenderPutFreeBlock(c);
-                        }  
-                        if (!pending_mask.IsSet()) 
-                        {
-                            pending_mask.Set(write_index.block.GetValue());  
-                            //stream_next_id = write_index.block + 1;
-                            stream_next_id = write_index.block;
-                            Increment(stream_next_id);
-                        }  
-                    }
-                    else
+                        block_buffer.Remove(c);
+                        session.SenderPutFreeBlock(c);
+                    }  
+                    if (!pending_mask.IsSet()) 
                     {
-                        PLOG(PL_DEBUG, "NormStreamObject::Write() stream buffer full (3)\n");
-                        break;
-                    }
+                        pending_mask.Set(write_index.block.GetValue());  
+                        //stream_next_id = write_index.block + 1;
+                        stream_next_id = write_index.block;
+                        Increment(stream_next_id);
+                    }  
                 }
-                stream_buffer.Remove(b);
-                b->EmptyToPool(segment_pool);
-                block_pool.Put(b);
-                segment = segment_pool.Get();
-                ASSERT(NULL != segment);
+                else
+                {
+                    PLOG(PL_DEBUG, "NormStreamObject::AcquireWriteSegment() stream buffer full (3)\n");
+                    return NULL;
+                }
+            }
+            stream_buffer.Remove(b);
+            b->EmptyToPool(segment_pool);
+            block_pool.Put(b);
+            segment = segment_pool.Get();
+            ASSERT(NULL != segment);
+        }
+        NormDataMsg::WriteStreamPayloadMsgStart(segment, 0);
+        NormDataMsg::WriteStreamPayloadLength(segment, 0);
+        NormDataMsg::WriteStreamPayloadOffset(segment, write_offset);
+        block->AttachSegment(write_index.segment, segment);
+    }  // end if (!segment)
+    return segment;
+}  // end NormStreamObject::AcquireWriteSegment()
+
+// Enqueues the current write segment, short or not, for transmission
+void NormStreamObject::CloseWriteSegment(NormBlock* block)
+{
+    if (coalesce_timer.IsActive()) coalesce_timer.Deactivate();
+    coalesce_active = false;
+    block->SetPending(write_index.segment);
+    if (++write_index.segment >= ndata) 
+    {
+        ProtoTime currentTime;
+        currentTime.GetCurrentTime();
+        block->SetLastNackTime(currentTime);
+        Increment(write_index.block);
+        write_index.segment = 0;
+    }
+}  // end NormStreamObject::CloseWriteSegment()
+
+UINT32 NormStreamObject::Write(const char* buffer, UINT32 len, bool eom)
+{               
+    write_reserve = NULL;  // (cancels any outstanding Reserve())
+    UINT32 nBytes = 0;
+    bool held = false;  // (a coalescing stream is holding a short segment)
+    do
+    {
+        if (stream_closing)
+        {
+            if (0 != len)
+            {
+                PLOG(PL_ERROR, "NormStreamObject::Write() error: stream is closing (len:%lu eom:%d)\n", 
+                                (unsigned long)len, eom);
+                len = 0;
             }
-            NormDataMsg::WriteStreamPayloadMsgStart(segment, 0);
-            NormDataMsg::WriteStreamPayloadLength(segment, 0);
-            NormDataMsg::WriteStreamPayloadOffset(segment, write_offset);
-            block->AttachSegment(write_index.segment, segment);
-        }  // end if (!segment)
+            break;
+        }
+        NormBlock* block;
+        char* segment = AcquireWriteSegment(block);
+        if (NULL == segment) break;
         
         UINT16 index = NormDataMsg::ReadStreamPayloadLength(segment);
         // If it is an application start-of-message, mark the stream header accordingly
-        // (but only if it is the _first_ message start for this segment!)
+        // (a segment only marks one message start, so a message that would be
+        // the second one started in this segment goes to the next segment
+        // instead, keeping message boundaries recoverable for ReadMsg())
         if (msg_start && (0 != len))
         {
-            if (0 == NormDataMsg::ReadStreamPayloadMsgStart(segment))
-                NormDataMsg::WriteStreamPayloadMsgStart(segment, index+1);
+            if (0 != NormDataMsg::ReadStreamPayloadMsgStart(segment))
+            {
+                CloseWriteSegment(block);
+                continue;
+            }
+            NormDataMsg::WriteStreamPayloadMsgStart(segment, index+1);
             msg_start = false;
         }
         
         UINT32 count = len - nBytes;
         UINT32 space = (UINT32)(segment_size - index);
         count = MIN(count, space);
+        char* payload = segment + index + NormDataMsg::GetStreamPayloadHeaderLength();
+        if (payload != (buffer + nBytes))  // (else Commit() of data filled in place)
+        {
 #ifdef SIMULATE
-        UINT32 simCount = index + NormDataMsg::GetStreamPayloadHeaderLength();
-        simCount = (simCount < SIM_PAYLOAD_MAX) ? (SIM_PAYLOAD_MAX - simCount) : 0;
-        simCount = MIN(count, simCount);
-        memcpy(segment+index+NormDataMsg::GetStreamPayloadHeaderLength(), buffer+nBytes, simCount);
+            UINT32 simCount = index + NormDataMsg::GetStreamPayloadHeaderLength();
+            simCount = (simCount < SIM_PAYLOAD_MAX) ? (SIM_PAYLOAD_MAX - simCount) : 0;
+            simCount = MIN(count, simCount);
+            memcpy(payload, buffer+nBytes, simCount);
 #else
-        memcpy(segment+index+NormDataMsg::GetStreamPayloadHeaderLength(), buffer+nBytes, count);
+            memcpy(payload, buffer+nBytes, count);
 #endif // if/else SIMULATE
+        }
         NormDataMsg::WriteStreamPayloadLength(segment, index+count);
         nBytes += count;
         write_offset += count;
         // Is the segment full? or flushing
         //if ((count == space) || ((FLUSH_NONE != flush_mode) && (0 != index) && (nBytes == len)))
-        if ((count == space) || 
-            ((FLUSH_NONE != flush_mode) && (nBytes == len) && ((0 != index) || (0 != len))))
-        {   
-            block->SetPending(write_index.segment);
-            if (++write_index.segment >= ndata) 
-            {
-                ProtoTime currentTime;
-                currentTime.GetCurrentTime();
-                block->SetLastNackTime(currentTime);
-                Increment(write_index.block);
-                write_index.segment = 0;
+        bool flush = (count == space);
+        if (!flush && (FLUSH_NONE != flush_mode) && (nBytes == len) && ((0 != index) || (0 != len)))
+        {
+            if (IsCoalescing() && !coalesce_force && ((index + count) < CoalesceFill()))
+            {
+                held = true;
+                if (FLUSH_ACTIVE == flush_mode) coalesce_active = true;
+            }
+            else
+            {
+                flush = true;
             }
         }
+        if (flush) CloseWriteSegment(block);
     } while (nBytes < len);
     
     // if this was end-of-message next Write() will be considered a new message     
@@ -4215,7 +6147,16 @@ UINT32 NormStreamObject::Write(const char* buffer, UINT32 len, bool eom)
     {
         if (eom) 
             msg_start = true;
-        if (FLUSH_ACTIVE == flush_mode) 
+        if (held)
+        {
+            // (the timer is started when the segment is first held)
+            if (!coalesce_timer.IsActive())
+            {
+                coalesce_timer.SetInterval(coalesce_delay);
+                session.ActivateTimer(coalesce_timer);
+            }
+        }
+        else if (FLUSH_ACTIVE == flush_mode) 
             flush_pending = true;
         else if (!stream_closing)
             flush_pending = false;
@@ -4231,6 +6172,150 @@ UINT32 NormStreamObject::Write(const char* buffer, UINT32 len, bool eom)
     return nBytes;
 }  // end NormStreamObject::Write()
 
+bool NormStreamObject::SetCoalescing(double maxDelay, UINT16 minFill)
+{
+    if (NULL != sender)
+    {
+        PLOG(PL_ERROR, "NormStreamObject::SetCoalescing() error: not a sender stream\n");
+        return false;
+    }
+    coalesce_fill = minFill;
+    if (maxDelay > 0.0)
+    {
+        // (a segment already held keeps its original deadline)
+        coalesce_delay = maxDelay;
+    }
+    else
+    {
+        coalesce_delay = 0.0;
+        if (coalesce_timer.IsActive())
+        {
+            coalesce_timer.Deactivate();
+            FlushCoalesced();
+        }
+    }
+    return true;
+}  // end NormStreamObject::SetCoalescing()
+
+void NormStreamObject::FlushCoalesced()
+{
+    FlushMode oldFlushMode = flush_mode;
+    bool active = coalesce_active || (FLUSH_ACTIVE == oldFlushMode);
+    SetFlushMode(active ? FLUSH_ACTIVE : FLUSH_PASSIVE);
+    coalesce_force = true;
+    Write(NULL, 0, false);
+    coalesce_force = false;
+    SetFlushMode(oldFlushMode);
+}  // end NormStreamObject::FlushCoalesced()
+
+bool NormStreamObject::OnCoalesceTimeout(ProtoTimer& /*theTimer*/)
+{
+    // An outstanding Reserve() is the held segment's free space, so
+    // wait for its Commit() (or another Write()) before flushing
+    if (NULL != write_reserve) return true;
+    coalesce_timer.Deactivate();
+    if (!stream_closing) FlushCoalesced();
+    return false;
+}  // end NormStreamObject::OnCoalesceTimeout()
+
+void NormStreamObject::PostEvent(EventType type)
+{
+    CheckEvent(type, true);
+}  // end NormStreamObject::PostEvent()
+
+void NormStreamObject::CheckEvent(EventType type, bool update)
+{
+    EventHold& hold = event_hold[type];
+    if (update)
+        hold.count++;
+    else if (!hold.held)
+        return;
+    NormController::Event event = (EVENT_TX_VACANCY == type) ? 
+                                        NormController::TX_QUEUE_VACANCY : 
+                                        NormController::RX_OBJECT_UPDATED;
+    double interval = session.GetEventInterval(event);
+    if (interval > 0.0)
+    {
+        ProtoTime currentTime;
+        currentTime.GetCurrentTime();
+        double remaining = interval - ProtoTime::Delta(currentTime, hold.post_time);
+        unsigned int threshold = session.GetEventThreshold(event);
+        if ((remaining > 1.0e-06) && ((0 == threshold) || (hold.count < threshold)))
+        {
+            // Hold it (the timer is set for whichever held event is due first)
+            hold.held = true;
+            if (notify_timer.IsActive())
+            {
+                if (notify_timer.GetTimeRemaining() <= remaining) return;
+                notify_timer.Deactivate();
+            }
+            notify_timer.SetInterval(remaining);
+            session.ActivateTimer(notify_timer);
+            return;
+        }
+        hold.post_time = currentTime;
+    }
+    hold.held = false;
+    hold.posted = hold.count;
+    hold.count = 0;
+    if (EVENT_TX_VACANCY == type)
+    {
+        session.Notify(NormController::TX_QUEUE_VACANCY, NULL, this);
+    }
+    else
+    {
+        notify_on_update = false;
+        session.Notify(NormController::RX_OBJECT_UPDATED, sender, this);
+    }
+}  // end NormStreamObject::CheckEvent()
+
+bool NormStreamObject::OnNotifyTimeout(ProtoTimer& /*theTimer*/)
+{
+    // (an event that isn't due yet reactivates the timer)
+    notify_timer.Deactivate();
+    CheckEvent(EVENT_RX_UPDATED, false);
+    CheckEvent(EVENT_TX_VACANCY, false);
+    return false;
+}  // end NormStreamObject::OnNotifyTimeout()
+
+char* NormStreamObject::Reserve(unsigned int& len)
+{
+    write_reserve = NULL;
+    if (stream_closing)
+    {
+        PLOG(PL_ERROR, "NormStreamObject::Reserve() error: stream is closing\n");
+        len = 0;
+        return NULL;
+    }
+    NormBlock* block;
+    char* segment = AcquireWriteSegment(block);
+    if (NULL == segment)
+    {
+        len = 0;
+        return NULL;
+    }
+    UINT16 index = NormDataMsg::ReadStreamPayloadLength(segment);
+    unsigned int space = segment_size - index;
+    if ((0 == len) || (len > space)) len = space;
+    write_reserve = segment + index + NormDataMsg::GetStreamPayloadHeaderLength();
+    write_reserve_len = len;
+    return write_reserve;
+}  // end NormStreamObject::Reserve()
+
+UINT32 NormStreamObject::Commit(unsigned int len, bool eom)
+{
+    if (0 == len)
+        return Write(NULL, 0, eom);
+    if ((NULL == write_reserve) || (len > write_reserve_len))
+    {
+        PLOG(PL_ERROR, "NormStreamObject::Commit() error: %u bytes not reserved\n", len);
+        return 0;
+    }
+    // The reserved space is the current write segment's free space, so 
+    // Write() will find the data already in place and not copy it
+    return Write(write_reserve, len, eom);
+}  // end NormStreamObject::Commit()
+
 #ifdef SIMULATE
 /////////////////////////////////////////////////////////////////
 //
@@ -4330,6 +6415,11 @@ bool NormObjectTable::Init(UINT16 rangeMax, UINT16 tableSize)
     memset(table, 0, tableSize*sizeof(char*));
     hash_mask = tableSize - 1;
 #endif  //  !USE_PROTO_TREE
+    if (!ring.Init(MIN(rangeMax, tableSize), 0x10000))
+    {
+        Destroy();
+        return false;
+    }
     range_max = rangeMax;
     count = range = 0;
     size = NormObjectSize(0);
@@ -4368,8 +6458,13 @@ NormObject* NormObjectTable::Find(const NormObjectId& objectId) const
 {
     if ((0 == range) || (objectId < range_lo) || (objectId > range_hi))
         return NULL;    
-    else        
+    NormObject* theObject = ring.Get((UINT16)objectId);
+    if ((NULL != theObject) && (objectId == theObject->GetId()))
+        return theObject;
+    else if (ring.HasOverflow())
         return tree.Find(objectId.GetValuePtr(), 8*sizeof(UINT16));
+    else
+        return NULL;
 }  // end NormObjectTable::Find()
 
 void NormObjectTable::Destroy()
@@ -4383,6 +6478,7 @@ void NormObjectTable::Destroy()
         Remove(obj);
         obj->Release();
     }
+    ring.Destroy();
     count = range = range_max = 0;
 }  // end NormObjectTable::Destroy()
 
@@ -4393,7 +6489,12 @@ NormObject* NormObjectTable::Find(const NormObjectId& objectId) const
     if (0 != range)
     {
         if ((objectId < range_lo)  || (objectId > range_hi)) return (NormObject*)NULL;
-        NormObject* theObject = table[((UINT16)objectId) & hash_mask];
+        NormObject* theObject = ring.Get((UINT16)objectId);
+        if ((NULL != theObject) && (objectId == theObject->GetId()))
+            return theObject;
+        else if (!ring.HasOverflow())
+            return (NormObject*)NULL;
+        theObject = table[((UINT16)objectId) & hash_mask];
         while (theObject && (objectId != theObject->GetId())) 
             theObject = theObject->next;
         return theObject;
@@ -4419,6 +6520,7 @@ void NormObjectTable::Destroy()
         }
         delete[] table;
         table = (NormObject**)NULL;
+        ring.Destroy();
         count = range = range_max = 0;
     }  
 }  // end NormObjectTable::Destroy()
@@ -4499,6 +6601,7 @@ bool NormObjectTable::Insert(NormObject* theObject)
     ASSERT(((NULL != entry) ? (objectId != entry->GetId()) : true));
     theObject->next = entry;
 #endif  // if/else USE_PROTO_TREE
+    ring.Insert((UINT16)objectId, theObject);
     count++;
     size = size + theObject->GetSize();
     theObject->Retain();
@@ -4540,6 +6643,7 @@ bool NormObjectTable::Remove(NormObject* theObject)
         }
         ASSERT(NULL != tree.Find(theObject->GetId().GetValuePtr(), 8*sizeof(UINT16)));
         tree.Remove(*theObject);
+        ring.Remove((UINT16)objectId, theObject);
         count--;
         size = size - theObject->GetSize();
         theObject->Release();
@@ -4647,6 +6751,7 @@ bool NormObjectTable::Remove(NormObject* theObject)
         {
             range = 0;
         }  
+        ring.Remove((UINT16)objectId, theObject);
         count--;
         size = size - theObject->GetSize();
         theObject->Release();
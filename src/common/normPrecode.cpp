@@ -2,18 +2,21 @@
 #include "protoApp.h"
 #include "protoFile.h"
 
-// Commment this #define out to use new, faster RS8 codec instead
-// (TBD - provide option use 16-bit Reed Solomon for large block sizes?)
-//#define USE_MDP_FEC
-
-#ifdef USE_MDP_FEC
-#include "normEncoderMDP.h"
-#else
+// The 16-bit Reed Solomon codec is used automatically for block sizes greater
+// than 256 segments (both codecs use the NormGFKernel SIMD kernels where available).
+// FEC blocks are coded by a NormFecWorkerPool ("threads" option) while the
+// main thread reads, checksums and writes segments.  With the "gpu" option
+// (builds with HAVE_OPENCL), RS8 parity is computed by NormEncoderOCL in
+// batches of blocks instead.
 #include "normEncoderRS8.h"
 #include "normEncoderRS16.h"
-#endif // if/else USE_MDP_FEC
+#include "normEncoderOCL.h"
+#include "normFecWorker.h"
 
 #include <sys/types.h>  // for BYTE_ORDER macro
+#ifndef WIN32
+#include <unistd.h>     // for sysconf()
+#endif // !WIN32
 #include <stdlib.h>  // for atoi()
 #include <stdio.h>   // for stdout/stderr printouts
 #include <string.h>
@@ -39,6 +42,31 @@ class NormPrecodeApp : public ProtoApp
         bool Encode();
         bool Decode();
         
+        // FEC block pipeline (a ring of "slots" coded by the FEC workers)
+        struct Slot
+        {
+            char*           buffer;         // block vectors (each "vector_stride" bytes)
+            char**          vec;            // numData + num_parity vectors
+            char**          parity_list;    // per byte range parity pointers (encode)
+            unsigned int    num_data;
+            unsigned int    erasure_count;  // (decode)
+            unsigned int*   erasure_locs;
+        };
+        bool InitPipeline(unsigned int dataSegmentSize, ProtoFile::Offset numBlocks);
+        void DestroyPipeline();
+        void SubmitBlock(Slot& slot);
+        void CollectBlock(Slot& slot);
+        void FlushBatch();
+        bool ReadInput(char* buffer, unsigned int numBytes);
+        bool WriteOutput(const char* buffer, unsigned int numBytes);
+        bool FlushOutput();
+        void ShowProgress(int& progressPercent, int percent);
+        static unsigned int GetProcessorCount();
+        
+        enum {RANGE_MIN = 256};                 // smallest byte range given a worker
+        enum {IO_BUFFER_SIZE = 1048576};        // sequential read/write chunk size
+        static const unsigned long SLOT_MEMORY_MAX;  // limits blocks in flight
+        
         void InitInterleaver(ProtoFile::Offset numSegments);
         ProtoFile::Offset ComputeInterleaverOffset(ProtoFile::Offset segmentId, ProtoFile::Offset numSegments);
         ProtoFile::Offset ComputeSegmentOffset(ProtoFile::Offset interleaverId, ProtoFile::Offset numSegments);
@@ -101,6 +129,27 @@ class NormPrecodeApp : public ProtoApp
         ProtoFile::Offset interleaver_width;
         ProtoFile::Offset interleaver_height;
         ProtoFile::Offset interleaver_size;  // (width * height)
+        char*             i_buffer;          // interleaver block buffer (if it fits "i_buffer_max")
+        
+        int               thread_count;  // FEC worker threads (-1 is one per CPU, 0 codes inline)
+        bool              use_gpu;       // encode inline with NormEncoderOCL (RS8 only)
+        NormFecWorkerPool fec_pool;
+        NormEncoder*      encoder;       // (used when there are no workers)
+        NormDecoder*      decoder;
+        Slot*             slot_list;
+        unsigned int      slot_count;
+        unsigned int      batch_size;    // blocks per NormEncoder::EncodeBlocks() call (no workers, 0 is default)
+        unsigned int      batch_start;   // slot index of the first block awaiting encoding
+        unsigned int      batch_count;   // blocks awaiting encoding
+        const char***     batch_data;    // EncodeBlocks() argument lists
+        unsigned int*     batch_num_data;
+        char***           batch_parity;
+        unsigned int      range_count;   // byte ranges each block is split into
+        unsigned int      range_size;    // (multiple of 64 bytes)
+        unsigned int      vector_stride;
+        char*             io_buffer;
+        unsigned int      io_offset;
+        unsigned int      io_length;
         
 }; // end class NormPrecodeApp
 
@@ -109,25 +158,30 @@ PROTO_INSTANTIATE_APP(NormPrecodeApp)
         
 const ProtoFile::Offset NormPrecodeApp::SEGMENT_MIN = 8;
 const ProtoFile::Offset NormPrecodeApp::SEGMENT_MAX = 8192;
+const unsigned long NormPrecodeApp::SLOT_MEMORY_MAX = 256*1024*1024;
 
 NormPrecodeApp::NormPrecodeApp()
  : encode(true), segment_size(1024), num_data(196), num_parity(4), 
    parity_fraction(100.0), b_max(65536),
-   i_max(1000), i_buffer_max(1500000000)
+   i_max(1000), i_buffer_max(1500000000), i_buffer(NULL), 
+   thread_count(-1), use_gpu(false), encoder(NULL), decoder(NULL), slot_list(NULL), slot_count(0),
+   batch_size(0), batch_start(0), batch_count(0), batch_data(NULL), batch_num_data(NULL), batch_parity(NULL),
+   range_count(1), range_size(0), vector_stride(0), io_buffer(NULL), io_offset(0), io_length(0)
 {  
     in_file_path[0] = '\0';  
 }
 
 NormPrecodeApp::~NormPrecodeApp()
 {
+    DestroyPipeline();
 }
 
 void NormPrecodeApp::Usage()
 {
    fprintf(stderr, "Usage:  npc {encode|decode} input <inFile> [output <outFile>]\n"
                    "            [segment <segmentSize>][block numData][parity numParity]\n"
-                   "            [auto <parityPercentage>]\n"
-                   "            [background][help][debug <debugLevel>\n");  
+                   "            [auto <parityPercentage>][threads <count>][batch <count>]\n"
+                   "            [gpu][background][help][debug <debugLevel>\n");  
 }  // end NormPrecodeApp::Usage()
 
 const char* const NormPrecodeApp::cmd_list[] = 
@@ -145,6 +199,9 @@ const char* const NormPrecodeApp::cmd_list[] =
     "+bmax",        // limit maximum allowed block size for "auto" operation (default = 65536)
     "+imax",        // set interleaver max dimension
     "+ibuffer",     // set imax interleaver buffer (buffer is used if interleaver size fits)
+    "+threads",     // set FEC worker thread count (default = one per CPU, 0 = none)
+    "+batch",       // set blocks encoded per batch when "threads 0" (default = 1, or 64 with "gpu")
+    "-gpu",         // encode on an OpenCL GPU in batches (implies "threads 0", needs HAVE_OPENCL build)
     "-background",  // run w/out command shel (Win32)  
     NULL         
 };
@@ -271,6 +328,35 @@ bool NormPrecodeApp::OnCommand(const char* cmd, const char* val)
         }
         i_buffer_max = iBufferMax;
     }
+    else if (!strncmp("threads", cmd, len))
+    {
+        int threadCount = atoi(val);
+        if (threadCount < 0)
+        {
+            PLOG(PL_FATAL, "npc: error: \"threads\" cannot be less than zero\n");
+            return false;
+        }
+        thread_count = threadCount;
+    }
+    else if (!strncmp("batch", cmd, len))
+    {
+        int batchSize = atoi(val);
+        if (batchSize < 1)
+        {
+            PLOG(PL_FATAL, "npc: error: \"batch\" must be at least one\n");
+            return false;
+        }
+        batch_size = batchSize;
+    }
+    else if (!strncmp("gpu", cmd, len))
+    {
+#ifdef NORM_OPENCL
+        use_gpu = true;
+#else
+        PLOG(PL_FATAL, "npc: error: \"gpu\" requires a build with OpenCL support (HAVE_OPENCL)\n");
+        return false;
+#endif // if/else NORM_OPENCL
+    }
     else if (!strncmp("background", cmd, len))
     {
         // do nothing, handled by "ProtoApp" base
@@ -390,16 +476,15 @@ bool NormPrecodeApp::OnStartup(int argc, const char*const* argv)
         return false;
     }
     
-    if (encode)
-        return Encode();
-    else
-        return Decode();
+    bool result = encode ? Encode() : Decode();
+    DestroyPipeline();
+    return result;
     
 }  // end NormPrecodeApp::OnStartup()
 
 void NormPrecodeApp::OnShutdown()
 {
-    // (TBD) do better cleanup of allocated buffers, etc!!
+   DestroyPipeline();
    if (in_file.IsOpen()) in_file.Close();
    if (out_file.IsOpen()) out_file.Close();
    PLOG(PL_INFO, "npc: Done.\n");
@@ -585,6 +670,336 @@ ProtoFile::Offset NormPrecodeApp::ComputeSegmentOffset(ProtoFile::Offset interle
     return segmentOffset;
 }  // end NormPrecodeApp::ComputeSegmentOffset()
 
+unsigned int NormPrecodeApp::GetProcessorCount()
+{
+#ifdef WIN32
+    SYSTEM_INFO sysInfo;
+    GetSystemInfo(&sysInfo);
+    long count = (long)sysInfo.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+#endif // if/else WIN32
+    return ((count > 0) ? (unsigned int)count : 1);
+}  // end NormPrecodeApp::GetProcessorCount()
+
+// Sets up the block "slots" and FEC workers for Encode() or Decode().  Each
+// FEC block is split into "range_count" byte ranges (the code works column by
+// column) coded by different workers, and enough blocks are kept in flight for
+// all workers to be busy while the main thread reads and writes the file.
+bool NormPrecodeApp::InitPipeline(unsigned int dataSegmentSize, ProtoFile::Offset numBlocks)
+{
+    DestroyPipeline();
+    unsigned int blockSize = num_data + num_parity;
+    bool useRS16 = (blockSize > 256);
+    unsigned int numThreads = (thread_count < 0) ? GetProcessorCount() : (unsigned int)thread_count;
+    bool useGpu = use_gpu && encode;
+    if (useGpu && useRS16)
+    {
+        PLOG(PL_WARN, "npc: warning: \"gpu\" encoding is RS8 only (block size > 256), using CPU\n");
+        useGpu = false;
+    }
+    if (useGpu) numThreads = 0;  // (the device does the FEC work)
+    unsigned int rangeMax = (dataSegmentSize + RANGE_MIN - 1) / RANGE_MIN;
+    range_count = (numThreads < rangeMax) ? numThreads : rangeMax;
+    if (0 == range_count) range_count = 1;
+    // Ranges are multiples of 64 bytes (keeps 16-bit symbols and SIMD loads aligned),
+    // so the vectors are zero padded to (range_count * range_size) for coding
+    range_size = (((dataSegmentSize + range_count - 1) / range_count) + 63) & ~63;
+    vector_stride = range_count * range_size;
+    if (vector_stride < segment_size) vector_stride = (segment_size + 63) & ~63;
+    
+    unsigned long blockBytes = (unsigned long)blockSize * vector_stride;
+    unsigned long slotMax = SLOT_MEMORY_MAX / blockBytes;
+    if (slotMax < 2) slotMax = 2;
+    // (without workers, a batch of blocks is read ahead for each EncodeBlocks() call)
+    unsigned int batchSize = batch_size;
+#ifdef NORM_OPENCL
+    if ((0 == batchSize) && useGpu) batchSize = NormEncoderOCL::BATCH_MAX;
+#endif // NORM_OPENCL
+    if (0 == batchSize) batchSize = 1;
+    slot_count = (0 != numThreads) ? ((2 * numThreads) / range_count) : (encode ? batchSize : 1);
+    if (slot_count > slotMax) slot_count = (unsigned int)slotMax;
+    if (slot_count > numBlocks) slot_count = (unsigned int)numBlocks;
+    if (0 == slot_count) slot_count = 1;
+    
+    if (NULL == (slot_list = new Slot[slot_count]))
+    {
+        PLOG(PL_FATAL, "npc: new slot list error: %s\n", GetErrorString());
+        return false;
+    }
+    for (unsigned int i = 0; i < slot_count; i++)
+    {
+        Slot& slot = slot_list[i];
+        slot.buffer = new char[blockBytes];
+        slot.vec = new char*[blockSize];
+        slot.parity_list = new char*[range_count * num_parity];
+        slot.erasure_locs = new unsigned int[num_parity + 1];
+        if ((NULL == slot.buffer) || (NULL == slot.vec) || 
+            (NULL == slot.parity_list) || (NULL == slot.erasure_locs))
+        {
+            PLOG(PL_FATAL, "npc: block buffer allocation error: %s\n", GetErrorString());
+            return false;
+        }
+        for (unsigned int j = 0; j < blockSize; j++)
+            slot.vec[j] = slot.buffer + ((unsigned long)j * vector_stride);
+        slot.num_data = 0;
+        slot.erasure_count = 0;
+    }
+    
+    if (0 != numThreads)
+    {
+        // RS16 is FEC id 2 (m = 16) and RS8 is FEC id 5
+        if (!fec_pool.Init(encode ? NormFecWorkerPool::ENCODE : NormFecWorkerPool::DECODE, numThreads, 
+                           useRS16 ? 2 : 5, useRS16 ? 16 : 8, 0, 
+                           num_data, num_parity, range_size, false))
+        {
+            PLOG(PL_FATAL, "npc: error starting FEC worker threads\n");
+            return false;
+        }
+    }
+    else if (encode)
+    {
+        if (useRS16)
+            encoder = new NormEncoderRS16;
+#ifdef NORM_OPENCL
+        else if (useGpu)
+            encoder = new NormEncoderOCL;
+#endif // NORM_OPENCL
+        else
+            encoder = new NormEncoderRS8;
+        if ((NULL == encoder) || !encoder->Init(num_data, num_parity, range_size))
+        {
+            PLOG(PL_FATAL, "npc: error initializing FEC encoder\n");
+            return false;
+        }
+        batch_data = new const char**[slot_count];
+        batch_num_data = new unsigned int[slot_count];
+        batch_parity = new char**[slot_count];
+        if ((NULL == batch_data) || (NULL == batch_num_data) || (NULL == batch_parity))
+        {
+            PLOG(PL_FATAL, "npc: new batch list error: %s\n", GetErrorString());
+            return false;
+        }
+        batch_start = batch_count = 0;
+    }
+    else
+    {
+        if (useRS16)
+            decoder = new NormDecoderRS16;
+        else
+            decoder = new NormDecoderRS8;
+        if ((NULL == decoder) || !decoder->Init(num_data, num_parity, range_size))
+        {
+            PLOG(PL_FATAL, "npc: error initializing decoder\n");
+            return false;
+        }
+    }
+    PLOG(PL_INFO, "npc: %s with %u worker threads (%u byte ranges, %u blocks in flight)\n", 
+         useRS16 ? "RS16" : "RS8", numThreads, range_count, slot_count);
+    
+    if (NULL == (io_buffer = new char[IO_BUFFER_SIZE]))
+    {
+        PLOG(PL_FATAL, "npc: new i/o buffer error: %s\n", GetErrorString());
+        return false;
+    }
+    io_offset = io_length = 0;
+    return true;
+}  // end NormPrecodeApp::InitPipeline()
+
+void NormPrecodeApp::DestroyPipeline()
+{
+    fec_pool.Destroy();  // (waits for any busy workers)
+    if (NULL != slot_list)
+    {
+        for (unsigned int i = 0; i < slot_count; i++)
+        {
+            Slot& slot = slot_list[i];
+            if (NULL != slot.buffer) delete[] slot.buffer;
+            if (NULL != slot.vec) delete[] slot.vec;
+            if (NULL != slot.parity_list) delete[] slot.parity_list;
+            if (NULL != slot.erasure_locs) delete[] slot.erasure_locs;
+        }
+        delete[] slot_list;
+        slot_list = NULL;
+    }
+    slot_count = 0;
+    if (NULL != encoder)
+    {
+        delete encoder;
+        encoder = NULL;
+    }
+    if (NULL != batch_data)
+    {
+        delete[] batch_data;
+        batch_data = NULL;
+    }
+    if (NULL != batch_num_data)
+    {
+        delete[] batch_num_data;
+        batch_num_data = NULL;
+    }
+    if (NULL != batch_parity)
+    {
+        delete[] batch_parity;
+        batch_parity = NULL;
+    }
+    batch_start = batch_count = 0;
+    if (NULL != decoder)
+    {
+        delete decoder;
+        decoder = NULL;
+    }
+    if (NULL != i_buffer)
+    {
+        delete[] i_buffer;
+        i_buffer = NULL;
+    }
+    if (NULL != io_buffer)
+    {
+        delete[] io_buffer;
+        io_buffer = NULL;
+    }
+    io_offset = io_length = 0;
+}  // end NormPrecodeApp::DestroyPipeline()
+
+// Encodes the slot's block (computing its parity vectors) or, if it has
+// erasures, decodes it, on the FEC workers if there are any
+void NormPrecodeApp::SubmitBlock(Slot& slot)
+{
+    if (!encode && (0 == slot.erasure_count)) return;
+    if (!fec_pool.IsActive())
+    {
+        if (encode)
+        {
+            // Blocks are encoded "slot_count" (batch_size) at a time (see FlushBatch())
+            if (0 == batch_count) batch_start = (unsigned int)(&slot - slot_list);
+            if (++batch_count >= slot_count) FlushBatch();
+        }
+        else
+        {
+            decoder->Decode(slot.vec, slot.num_data, slot.erasure_count, slot.erasure_locs);
+        }
+        return;
+    }
+    unsigned int numVectors = slot.num_data + num_parity;
+    for (unsigned int r = 0; r < range_count; r++)
+    {
+        const void* key = slot.buffer + r;
+        char** vectorList = fec_pool.Reserve(key);
+        // (there are jobs enough for every range of all slots)
+        ASSERT(NULL != vectorList);
+        unsigned int offset = r * range_size;
+        if (encode)
+        {
+            char** parityList = slot.parity_list + r*num_parity;
+            for (unsigned int i = 0; i < slot.num_data; i++)
+                vectorList[i] = slot.vec[i] + offset;
+            for (unsigned int i = 0; i < num_parity; i++)
+                parityList[i] = slot.vec[slot.num_data + i] + offset;
+            fec_pool.Submit(key, slot.num_data, parityList);
+        }
+        else
+        {
+            for (unsigned int i = 0; i < numVectors; i++)
+                vectorList[i] = slot.vec[i] + offset;
+            fec_pool.SubmitDecode(key, this, slot.num_data, slot.erasure_count, slot.erasure_locs);
+        }
+    }
+}  // end NormPrecodeApp::SubmitBlock()
+
+// Waits for the FEC workers (if any) to finish the slot's block
+void NormPrecodeApp::CollectBlock(Slot& slot)
+{
+    if (!fec_pool.IsActive()) 
+    {
+        // (the oldest block may still be in a partial batch at end of input)
+        if (0 != batch_count) FlushBatch();
+        return;
+    }
+    for (unsigned int r = 0; r < range_count; r++)
+    {
+        unsigned int numData;
+        fec_pool.Collect(slot.buffer + r, numData);  // (false if nothing was submitted)
+    }
+}  // end NormPrecodeApp::CollectBlock()
+
+// Encodes the blocks submitted since the last batch (the "batch_count" slots
+// from "batch_start" in ring order) with one EncodeBlocks() call
+void NormPrecodeApp::FlushBatch()
+{
+    for (unsigned int i = 0; i < batch_count; i++)
+    {
+        Slot& slot = slot_list[(batch_start + i) % slot_count];
+        batch_data[i] = (const char**)slot.vec;
+        batch_num_data[i] = slot.num_data;
+        batch_parity[i] = slot.vec + slot.num_data;
+    }
+    encoder->EncodeBlocks(batch_count, batch_data, batch_num_data, batch_parity);
+    batch_count = 0;
+}  // end NormPrecodeApp::FlushBatch()
+
+// Sequential "in_file" read through "io_buffer" (Encode() only)
+bool NormPrecodeApp::ReadInput(char* buffer, unsigned int numBytes)
+{
+    while (numBytes > 0)
+    {
+        if (io_offset == io_length)
+        {
+            unsigned int len = IO_BUFFER_SIZE;
+            if (!in_file.Read(io_buffer, len)) return false;
+            if (0 == len) return false;  // unexpected end-of-file
+            io_offset = 0;
+            io_length = len;
+        }
+        unsigned int len = io_length - io_offset;
+        if (len > numBytes) len = numBytes;
+        memcpy(buffer, io_buffer + io_offset, len);
+        io_offset += len;
+        buffer += len;
+        numBytes -= len;
+    }
+    return true;
+}  // end NormPrecodeApp::ReadInput()
+
+// Sequential "out_file" write through "io_buffer" (Decode() only)
+bool NormPrecodeApp::WriteOutput(const char* buffer, unsigned int numBytes)
+{
+    while (numBytes > 0)
+    {
+        if (IO_BUFFER_SIZE == io_length)
+        {
+            if (!FlushOutput()) return false;
+        }
+        unsigned int len = IO_BUFFER_SIZE - io_length;
+        if (len > numBytes) len = numBytes;
+        memcpy(io_buffer + io_length, buffer, len);
+        io_length += len;
+        buffer += len;
+        numBytes -= len;
+    }
+    return true;
+}  // end NormPrecodeApp::WriteOutput()
+
+bool NormPrecodeApp::FlushOutput()
+{
+    if (0 == io_length) return true;
+    if (out_file.Write(io_buffer, io_length) != io_length) return false;
+    io_length = 0;
+    return true;
+}  // end NormPrecodeApp::FlushOutput()
+
+// Updates the "(progress: nn%)" display
+void NormPrecodeApp::ShowProgress(int& progressPercent, int percent)
+{
+    if (percent > 99) percent = 99;  // (100% is shown when done)
+    if (percent <= progressPercent) return;
+    if (progressPercent < 10)
+        PLOG(PL_ALWAYS, "\b\b\b%d%%)", percent);
+    else
+        PLOG(PL_ALWAYS, "\b\b\b\b%d%%)", percent);
+    progressPercent = percent;
+}  // end NormPrecodeApp::ShowProgress()
+
 bool NormPrecodeApp::Encode()
 {
     if (!out_file.IsOpen())
@@ -642,66 +1057,23 @@ bool NormPrecodeApp::Encode()
     ProtoFile::Offset numOutputSegments =  
         ((numBlocks - 1) * (fecBlockSize + num_parity)) + lastBlockSize + num_parity;
     
-    
     InitInterleaver(numOutputSegments);
-    // 1) Init our FEC encoder
-    NormEncoder* encoderPtr;
-    if ((num_data + num_parity) > 256)
-        encoderPtr = new NormEncoderRS16;
-    else
-        encoderPtr = new NormEncoderRS8;
-    NormEncoder& encoder = *encoderPtr;
     
-    if (!encoder.Init(num_data, num_parity, dataSegmentSize))  // 4 CRC bytes are _not_ encoded
-    {
-        PLOG(PL_FATAL, "npc: error initializing FEC encoder\n");
-        return false;
-    }
+    // 1) Set up our FEC block buffers and encoder(s)
+    if (!InitPipeline(dataSegmentSize, numBlocks)) return false;
+    unsigned int codedSize = range_count * range_size;  // (zero padded beyond "dataSegmentSize")
     
-    // Determine number of segments to allocate for FEC encoding and
-    // interleaver buffering if applicable
+    // Allocate buffering for a full interleaver block, if applicable,
+    // so it is written with a single write() instead of a seek per segment
     ProtoFile::Offset interleaverBytes = interleaver_size * segment_size;
-	char* iBuffer = NULL;
-    bool useBuffering = false;
     if (interleaverBytes <= i_buffer_max)
     {
-        // Allocate buffering for full interleaver block and parity
         PLOG(PL_INFO, "npc: allocating interleaver buffer ...\n");
-        iBuffer = new char[interleaverBytes + (num_parity * segment_size)];
-        if (NULL != iBuffer)
-            useBuffering = true;
-        else
+        if (NULL == (i_buffer = new char[interleaverBytes]))
             PLOG(PL_WARN, "npc: warning: couldn't allocate full interleaver buffer: %s\n", GetErrorString());
     }
-    if (NULL == iBuffer)
-    {
-        // Just allocate one segment plus parity vecs
-        iBuffer = new char[(1 + num_parity) * segment_size];
-        if (NULL == iBuffer)
-        {
-            PLOG(PL_FATAL, "npc: error: couldn't allocate parity buffer: %s\n", GetErrorString());
-            return false;
-        }
-    }       
     
-    // 2) Create parity vector array for FEC encoding
-    char**  parityVec = new char*[num_parity];
-    if (NULL == parityVec)
-    {
-        PLOG(PL_FATAL, "npc: new parity array error: %s\n", GetErrorString());
-        return false;
-    }
-    // Keep parity vecs after first _or_ "interleaver_size" segments of "iBuffer"
-    char* pvec =  iBuffer + (useBuffering ? interleaverBytes : segment_size);
-    memset(pvec, 0, num_parity*segment_size);
-    for (unsigned int i = 0; i < num_parity; i++)
-    {
-        parityVec[i] = pvec;
-        pvec += segment_size;
-    }
-    
-    // 3) Build "meta_data" segment for the file
-    // (TBD) This could be built directly into iBuffer segment zero
+    // 2) Build "meta_data" segment for the file
     char metaData[SEGMENT_MAX+4];
     memset(metaData, 0, SEGMENT_MAX);
     ProtoFile::Offset sz = fileSize;
@@ -729,134 +1101,112 @@ bool NormPrecodeApp::Encode()
     // Reserves space for file size (8 byte header) and CRC (4 byte trailer)
     strncpy(metaData+8, ptr, segment_size - 12);
     
-    // 2) Read "in_file" segments, encode, and output to "out_file"
+    // 3) Read "in_file" blocks, encode, and output them interleaved to "out_file".
+    //    Up to "slot_count" blocks are read ahead and encoded by the workers
+    //    while earlier ones are checksummed and written.
     PLOG(PL_ALWAYS, "npc: encoding file ... (progress:   0%%)");
-    // State to track/display encoding progress
-    ProtoFile::Offset progressThreshold = numInputSegments / 100;
-    if (progressThreshold < 1) progressThreshold = 1;
-    ProtoFile::Offset progressCounter = 0;
     int progressPercent = 0;
     
-    
-    ProtoFile::Offset blockId = 0;
-    unsigned int parityCount = 0;
-    bool parityReady = false;
     ProtoFile::Offset inputSegmentId = 0;
     ProtoFile::Offset outputSegmentId = 0;
-    while (outputSegmentId < numOutputSegments)
-    {
-        // The ComputerInterleaverOffset() call here retrieves the _output_ offset location that the
-        // current input segment will be mapped to.  I.e., data is read from the input order, but mapped
-        // to interleaved output position via this offset
-        ProtoFile::Offset interleaverOffset = ComputeInterleaverOffset(outputSegmentId, numOutputSegments);
-        char* segment = useBuffering ? (iBuffer + (interleaverOffset % interleaverBytes)) : iBuffer;
-        if (parityReady)
-        {
-            // D) Output parity segment for this block
-            char* pvec = parityVec[num_parity - parityCount];
-            memcpy(segment, pvec, dataSegmentSize);
-            if (0 == --parityCount) 
-            {
-                memset(parityVec[0], 0, num_parity * segment_size);
-                parityReady = false;
-                blockId++;
-            }
-        }
-        else
+    ProtoFile::Offset readBlockId = 0;
+    ProtoFile::Offset writeBlockId = 0;
+    while (writeBlockId < numBlocks)
+    {
+        if ((readBlockId < numBlocks) && ((readBlockId - writeBlockId) < slot_count))
         {
-            // Read and encode a segment
-            inputSegmentId++;
-            if (1 == inputSegmentId)
+            // A) Read the next block's data segments into a free slot and encode it
+            Slot& slot = slot_list[readBlockId % slot_count];
+            slot.num_data = (readBlockId != lastBlockId) ? fecBlockSize : lastBlockSize;
+            for (unsigned int i = 0; i < slot.num_data; i++)
             {
-                // A) Segment '0' is the meta-data segment
-                memcpy(segment, metaData, dataSegmentSize);
-            }
-            else
-            {
-                // B) Read in data portion of next "segment"
-                unsigned int expectedBytes;
-                if (inputSegmentId != numInputSegments)
+                char* segment = slot.vec[i];
+                inputSegmentId++;
+                if (1 == inputSegmentId)
                 {
-                    expectedBytes = dataSegmentSize; 
+                    // Segment '0' is the meta-data segment
+                    memcpy(segment, metaData, dataSegmentSize);
                 }
                 else
                 {
-                    memset(segment, 0, dataSegmentSize);
-                    expectedBytes = lastFecSegSize;
-                }
-                unsigned int bytesToRead = expectedBytes;
-                if (!in_file.Read(segment, bytesToRead))
-                {
-                    PLOG(PL_FATAL, "\nnpc: unexpected error reading input file: %s\n", GetErrorString());
-                    return false;
-                }
-                if (bytesToRead != expectedBytes)
-                {
-                    PLOG(PL_FATAL, "\nnpc: unexpected end-of-file: %s\n", GetErrorString());
-                    return false;
+                    unsigned int expectedBytes;
+                    if (inputSegmentId != numInputSegments)
+                    {
+                        expectedBytes = dataSegmentSize; 
+                    }
+                    else
+                    {
+                        memset(segment, 0, dataSegmentSize);
+                        expectedBytes = lastFecSegSize;
+                    }
+                    if (!ReadInput(segment, expectedBytes))
+                    {
+                        PLOG(PL_FATAL, "\nnpc: unexpected error (or end-of-file) reading input file: %s\n", GetErrorString());
+                        return false;
+                    }
                 }
-                if (0 != bytesToRead) segment[bytesToRead] = '\0';
+                if (codedSize > dataSegmentSize)
+                    memset(segment + dataSegmentSize, 0, codedSize - dataSegmentSize);
             }
-            // C) Encode and check for parity readiness
-            encoder.Encode(outputSegmentId % fecBlockSize, segment, parityVec);
-            unsigned int numData = (blockId != lastBlockId) ? fecBlockSize : lastBlockSize;
-            if (numData == ++parityCount) 
-            {
-                parityCount = num_parity;
-                parityReady = true;
-            }
-            if (++progressCounter >= progressThreshold)
-            {
-                progressPercent = int((double)inputSegmentId / (double)numInputSegments);
-                if (progressPercent < 9)
-                    PLOG(PL_ALWAYS, "\b\b\b%d%%)", progressPercent + 1);
-                else if (progressPercent < 99)
-                    PLOG(PL_ALWAYS, "\b\b\b\b%d%%)", progressPercent + 1);
-                if (progressPercent < 99) progressPercent++;
-                progressCounter = 0;
-            }   
+            for (unsigned int i = 0; i < num_parity; i++)
+                memset(slot.vec[slot.num_data + i], 0, codedSize);
+            SubmitBlock(slot);
+            readBlockId++;
+            ShowProgress(progressPercent, (int)((100.0 * (double)inputSegmentId) / (double)numInputSegments));
+            continue;
         }
-        // E) Calculate and add CRC32 checksum to each "segment"
-        UINT32 checksum = ComputeCRC32(segment, dataSegmentSize);
-        checksum = htonl(checksum);
-        memcpy(segment+dataSegmentSize, &checksum, 4);
         
-        if (useBuffering)
+        // B) Output the oldest block (data then parity) once it's encoded
+        Slot& slot = slot_list[writeBlockId % slot_count];
+        CollectBlock(slot);
+        for (unsigned int i = 0; i < (slot.num_data + num_parity); i++)
         {
+            char* segment = slot.vec[i];
+            // Calculate and add CRC32 checksum to each "segment"
+            UINT32 checksum = ComputeCRC32(segment, dataSegmentSize);
+            checksum = htonl(checksum);
+            memcpy(segment+dataSegmentSize, &checksum, 4);
+            
+            // The ComputeInterleaverOffset() call here retrieves the _output_ offset location the
+            // segment is mapped to.  I.e., blocks are built in input order, but mapped to
+            // interleaved output position via this offset
+            ProtoFile::Offset interleaverOffset = ComputeInterleaverOffset(outputSegmentId, numOutputSegments);
             outputSegmentId++;
-            if ((0 == (outputSegmentId % interleaver_size)) || (outputSegmentId == numOutputSegments))
+            if (NULL != i_buffer)
             {
-                // Output our buffered interleaver block from memory (iBuffer) to "out_file"
-                ProtoFile::Offset bytesToWrite;
-                if ((outputSegmentId != numOutputSegments) || (numOutputSegments == interleaver_size))
-                    bytesToWrite = interleaver_size;
-                else
-                    bytesToWrite = (outputSegmentId % interleaver_size);
-                bytesToWrite *= segment_size;
-                if (out_file.Write(iBuffer, bytesToWrite) != bytesToWrite)
-                {   
-                    PLOG(PL_FATAL, "\nnpc: unexpected error writing to output file: %s\n", GetErrorString()); 
-                    return false;
+                memcpy(i_buffer + (interleaverOffset % interleaverBytes), segment, segment_size);
+                if ((0 == (outputSegmentId % interleaver_size)) || (outputSegmentId == numOutputSegments))
+                {
+                    // Output our buffered interleaver block from memory to "out_file"
+                    ProtoFile::Offset bytesToWrite;
+                    if ((outputSegmentId != numOutputSegments) || (numOutputSegments == interleaver_size))
+                        bytesToWrite = interleaver_size;
+                    else
+                        bytesToWrite = (outputSegmentId % interleaver_size);
+                    bytesToWrite *= segment_size;
+                    if (out_file.Write(i_buffer, bytesToWrite) != bytesToWrite)
+                    {   
+                        PLOG(PL_FATAL, "\nnpc: unexpected error writing to output file: %s\n", GetErrorString()); 
+                        return false;
+                    }
                 }
             }
-        }
-        else
-        {
-            // Output interleaved segment directly to "out_file" one segment at a time
-            // "Seek" to interleaver offset
-            if (!out_file.Seek(interleaverOffset))
+            else
             {
-                PLOG(PL_FATAL, "\nnpc: unexpected output file seek error: %s\n", GetErrorString());
-                return false;
+                // Output interleaved segment directly to "out_file" one segment at a time
+                if (!out_file.Seek(interleaverOffset))
+                {
+                    PLOG(PL_FATAL, "\nnpc: unexpected output file seek error: %s\n", GetErrorString());
+                    return false;
+                }
+                if (out_file.Write(segment, segment_size) != segment_size)
+                {
+                    PLOG(PL_FATAL, "npc: unexpected error writing to output file: %s\n", GetErrorString());
+                    return false;
+                }   
             }
-            // And write segment to output file
-            if (out_file.Write(segment, segment_size) != segment_size)
-            {
-                PLOG(PL_FATAL, "npc: unexpected error writing to output file: %s\n", GetErrorString());
-                return false;
-            }   
-            outputSegmentId++;
-        }   
+        }
+        writeBlockId++;
     } 
     if (progressPercent < 10)
         PLOG(PL_ALWAYS, "\b\b\b100%%)\n");
@@ -867,12 +1217,6 @@ bool NormPrecodeApp::Encode()
     
     ProtoSystemTime(t2);
     
-    // Deallocate our interleaver/parity buffers
-    delete[] iBuffer;
-    iBuffer = NULL;
-    delete[] parityVec;
-    parityVec = NULL;
-    
     PLOG(PL_INFO, "NormPrecodeApp::Encode() encoding time: %ld usec\n", DIFF_T(t2, t1));
     
     return true;
@@ -908,311 +1252,177 @@ bool NormPrecodeApp::Decode()
     // set "interleaver_size", etc
     InitInterleaver(numInputSegments);
     
-    // 2) init FEC decoder
-    NormDecoder* decoderPtr;
-    if ((num_data + num_parity) > 256)
-        decoderPtr = new NormDecoderRS16;
-    else
-        decoderPtr = new NormDecoderRS8;
-    NormDecoder& decoder = *decoderPtr;
-    
+    // 2) Set up our FEC block buffers and decoder(s)
     unsigned int dataSegmentSize = segment_size - 4;  // leaves space for our CRC
-    if (!decoder.Init(num_data, num_parity, dataSegmentSize))
-    {
-        PLOG(PL_FATAL, "npc: error initializing decoder\n");
-        return false;   
-    }
+    if (!InitPipeline(dataSegmentSize, numFecBlocks)) return false;
+    unsigned int codedSize = range_count * range_size;  // (zero padded beyond "dataSegmentSize")
     
-    
-    // 3) allocate interleaving/FEC decoding buffer and erasure locs array
-    // Determine number of segments to allocate for FEC encoding and
-    // interleaver buffering if applicable
-    char* iBuffer = NULL;
-    bool useBuffering = false;
+    // Allocate buffering for a full interleaver block, if applicable,
+    // so it is read with a single read() instead of a seek per segment
     ProtoFile::Offset interleaverBytes = interleaver_size * segment_size;
-    
-    if ((interleaverBytes <= i_buffer_max))// && 
-        //((num_data + num_parity) <= interleaver_size) &&
-        //((num_data + num_parity) <= numInputSegments))
+    if (interleaverBytes <= i_buffer_max)
     {
-        // Allocate buffering for full interleaver block and parity
         PLOG(PL_INFO, "npc: allocating interleaver buffer ...\n");
-        iBuffer = new char[interleaverBytes + ((num_data + num_parity) * segment_size)];
-        if (NULL != iBuffer)
-            useBuffering = true;
-        else
+        if (NULL == (i_buffer = new char[interleaverBytes]))
             PLOG(PL_WARN, "npc: warning:  couldn't allocate full interleaver buffer: %s\n", GetErrorString());
     }
-    if (NULL == iBuffer)
-    {
-        // Just try to allocate FEC vecs
-        iBuffer = new char[(num_data + num_parity) * segment_size];
-        if (NULL == iBuffer)
-        {
-            PLOG(PL_FATAL, "npc: error: couldn't allocate parity buffer: %s\n", GetErrorString());
-            return false;
-        }
-    }      
-    
-    char** fecVec = new char*[num_data + num_parity];
-    if (NULL == fecVec)
-    {
-        PLOG(PL_FATAL, "npc: error: couldn't allocate parity buffer: %s\n", GetErrorString());
-        return false;
-    }
-    if (!useBuffering)
-    {
-        // Go ahead and assign
-        char* fptr = iBuffer;
-        for (unsigned int i = 0; i < (num_data + num_parity); i++)
-        {
-            fecVec[i] = fptr;
-            fptr += segment_size;
-        }
-    }
-     
-    
-    unsigned int* erasureLocs = new unsigned int[num_parity];
-    if (NULL == erasureLocs)
-    {
-        PLOG(PL_FATAL, "npc: new erasure location array error: %s\n", GetErrorString());
-        return false;
-    }
-    
+    ProtoFile::Offset lastInterleaverBlockId = numInputSegments / interleaver_size;
+    ProtoFile::Offset lastInterleaverBytes = (numInputSegments % interleaver_size) * segment_size;
     
     PLOG(PL_ALWAYS, "npc: decoding file ... (progress:   0%%)");
-    // State to track/display decoding progress
-    ProtoFile::Offset progressThreshold = numInputSegments / 100;
-    if (progressThreshold <= 1)
-         progressThreshold = numInputSegments; // small number of segments
-    ProtoFile::Offset progressCounter = 0;
     int progressPercent = 0;
     
-    
-    // Read and decode each block in "in_file"
-    ProtoFile::Offset fecBlockId = 0;
+    // 3) Read (de-interleave) "in_file" blocks, decode those with erasures, and
+    //    write them to "out_file".  Up to "slot_count" blocks are read ahead and
+    //    decoded by the workers while earlier ones are written.
     ProtoFile::Offset outFileSize = 0;
-    
-    ProtoFile::Offset lastInterleaverBlockId = numInputSegments / interleaver_size;
-    ProtoFile::Offset lastInterleaverBytes = (numInputSegments % interleaver_size) * segment_size;
-    ProtoFile::Offset interleaverBlockId = 0; 
-    
-    unsigned int erasureCount = 0;
-    unsigned int segmentCount = 0;
-    
-    enum State {READING, ADVANCING, DECODING};
-    State state = READING;
     ProtoFile::Offset inputSegmentId = 0;
-    while ((inputSegmentId < numInputSegments) || (DECODING == state))
+    ProtoFile::Offset readBlockId = 0;
+    ProtoFile::Offset writeBlockId = 0;
+    while (writeBlockId < numFecBlocks)
     {
-        switch (state)
+        if ((readBlockId < numFecBlocks) && ((readBlockId - writeBlockId) < slot_count))
         {
-            case READING:
-                if (useBuffering)
-                {
-                    // Read in a full interleaver block
-                    unsigned int bytesToRead;
-                    if (interleaverBlockId != lastInterleaverBlockId)
-                        bytesToRead = interleaverBytes;
-                    else
-                        bytesToRead = lastInterleaverBytes;
-                        
-                    if (!in_file.Read(iBuffer, bytesToRead))
-                    {
-                        PLOG(PL_FATAL, "\nnpc: error reading input file: %s\n", GetErrorString());
-                        return false;
-                    }    
-                    if (0 == bytesToRead)
-                    {
-                        PLOG(PL_FATAL, "\nnpc: error reading input file: unexpected end-of-file\n");
-                        return false;
-                    }
-                    interleaverBlockId++;
-                    state = ADVANCING;
-                }
-                else
+            // A) Read the next FEC block into a free slot and check for erasures
+            Slot& slot = slot_list[readBlockId % slot_count];
+            slot.num_data = (readBlockId != lastFecBlockId) ? fecBlockSize : lastFecBlockSize;
+            slot.erasure_count = 0;
+            for (unsigned int i = 0 ; i < (slot.num_data + num_parity); i++)
+            {
+                char* segment = slot.vec[i];
+                ProtoFile::Offset interleaverOffset = ComputeInterleaverOffset(inputSegmentId, numInputSegments);
+                if (NULL != i_buffer)
                 {
-                    // Read in a FEC block one segment at a time.
-                    unsigned int numData = (fecBlockId != lastFecBlockId) ? fecBlockSize : lastFecBlockSize;
-                    for (unsigned int i = 0 ; i < (numData + num_parity); i++)
+                    if (0 == (inputSegmentId % interleaver_size))
                     {
-                        // Calc offset (de-interleave) and seek
-                        ProtoFile::Offset interleaverOffset = ComputeInterleaverOffset(inputSegmentId, numInputSegments);
-                        // seek to interleaver offset
-                        if (!in_file.Seek(interleaverOffset))
-                        {
-                            PLOG(PL_FATAL, "\nnpc: unexpected input file seek error: %s\n", GetErrorString());
-                            return false;
-                        }
-                        // Read segment
-                        unsigned int bytesToRead = segment_size;
-                        if (!in_file.Read(fecVec[i], bytesToRead))
+                        // Read in the next full interleaver block
+                        unsigned int bytesToRead;
+                        if ((inputSegmentId / interleaver_size) != lastInterleaverBlockId)
+                            bytesToRead = (unsigned int)interleaverBytes;
+                        else
+                            bytesToRead = (unsigned int)lastInterleaverBytes;
+                        if (!in_file.Read(i_buffer, bytesToRead))
                         {
-                            PLOG(PL_FATAL, "\nnpc: unexpected error reading input file: %s\n", GetErrorString());
+                            PLOG(PL_FATAL, "\nnpc: error reading input file: %s\n", GetErrorString());
                             return false;
-                        }
-                        if (bytesToRead != segment_size)
+                        }    
+                        if (0 == bytesToRead)
                         {
-                            PLOG(PL_FATAL, "\nnpc: read() error: incomplete segment (len: %lu out of %lu bytes)\n", bytesToRead, segment_size);
+                            PLOG(PL_FATAL, "\nnpc: error reading input file: unexpected end-of-file\n");
                             return false;
                         }
-                        inputSegmentId++;
-                        
-                        // Validate checksum (detects errors/ erasures)
-                        UINT32 checksum = ComputeCRC32(fecVec[i], dataSegmentSize);
-                        checksum = htonl(checksum);
-                        if (0 != memcmp(&checksum, fecVec[i] + dataSegmentSize, 4))
-                        {
-                            PLOG(PL_TRACE, "\nnpc: bad checksum! (found erasure)\n");
-                            erasureLocs[erasureCount++] = i;
-                            if (erasureCount > num_parity)
-                            {
-                                PLOG(PL_FATAL, "\nnpc: decoding encountered block with too many errors!\n");
-                                return false;
-                            }
-                            memset(fecVec[i], 0, dataSegmentSize);
-                        }
                     }
-                    state = DECODING;
+                    memcpy(segment, i_buffer + (interleaverOffset % interleaverBytes), segment_size);
                 }
-                break;
-            
-            case ADVANCING:
-            {
-                ASSERT(useBuffering);
-                unsigned int numData = (fecBlockId != lastFecBlockId) ? fecBlockSize : lastFecBlockSize;
-                unsigned int priorSegmentCount = segmentCount;
-                for (; segmentCount < (numData + num_parity); segmentCount++)
+                else
                 {
-                    ProtoFile::Offset interleaverOffset = ComputeInterleaverOffset(inputSegmentId, numInputSegments);
-                    fecVec[segmentCount] = iBuffer + (interleaverOffset % interleaverBytes);
-                    inputSegmentId++;
-                    // Validate checksum (detects errors/ erasures)
-                    UINT32 checksum = ComputeCRC32(fecVec[segmentCount], dataSegmentSize);
-                    checksum = htonl(checksum);
-                    if (0 != memcmp(&checksum, fecVec[segmentCount] + dataSegmentSize, 4))
+                    // Seek to the interleaver offset and read the segment
+                    if (!in_file.Seek(interleaverOffset))
                     {
-                        PLOG(PL_TRACE, "\nnpc: bad checksum! (found erasure)\n");
-                        erasureLocs[erasureCount++] = segmentCount;
-                        if (erasureCount > num_parity)
-                        {
-                            PLOG(PL_FATAL, "\nnpc: decoding encountered block with too many errors!\n");
-                            return false;
-                        }
-                        memset(fecVec[segmentCount], 0, dataSegmentSize);
+                        PLOG(PL_FATAL, "\nnpc: unexpected input file seek error: %s\n", GetErrorString());
+                        return false;
                     }
-                    if (0 == (inputSegmentId % interleaver_size)) 
+                    unsigned int bytesToRead = segment_size;
+                    if (!in_file.Read(segment, bytesToRead))
                     {
-                        if ((segmentCount + 1) == (numData + num_parity))
-                            segmentCount++;  // we really finished
-                        break;    
+                        PLOG(PL_FATAL, "\nnpc: unexpected error reading input file: %s\n", GetErrorString());
+                        return false;
                     }
-                }
-                if (segmentCount < (numData + num_parity))
-                {
-                    segmentCount++;
-                    // We only got a partial FEC block, so copy remainder to our extra storage space
-                    char* fptr = iBuffer + interleaverBytes + (priorSegmentCount * segment_size);
-                    for (unsigned int i = priorSegmentCount; i < segmentCount; i++)
+                    if (bytesToRead != segment_size)
                     {
-                        memcpy(fptr, fecVec[i], segment_size);
-                        fecVec[i] = fptr;
-                        fptr += segment_size;
-
+                        PLOG(PL_FATAL, "\nnpc: read() error: incomplete segment (len: %lu out of %lu bytes)\n", bytesToRead, segment_size);
+                        return false;
                     }
-                    state = READING;  // we need more data from file to complete fec block
                 }
-                else
-                {
-                    state = DECODING;
-                }
-                break;
-            }
+                inputSegmentId++;
                 
-            case DECODING:
-            {
-                // Now decode
-                unsigned int numData = (fecBlockId != lastFecBlockId) ? fecBlockSize : lastFecBlockSize;
-                if (0 != erasureCount)
-                    decoder.Decode(fecVec, numData, erasureCount, erasureLocs);
-                for (unsigned int i = 0; i < numData; i++)
+                // Validate checksum (detects errors/ erasures)
+                UINT32 checksum = ComputeCRC32(segment, dataSegmentSize);
+                checksum = htonl(checksum);
+                if (0 != memcmp(&checksum, segment + dataSegmentSize, 4))
                 {
-                    unsigned int segmentSize = segment_size - 4;  // don't write the CRC tail
-                    if((0 == fecBlockId) && (0 == i))
-                    {
-                        // First segment of first block is our "meta_data" with file size info   
-                        switch (sizeof(ProtoFile::Offset))
-                        {
-                            case 8:
-                                memcpy(&outFileSize, fecVec[0], 8);
-                                outFileSize = ntoho(outFileSize);
-                                break;
-                            case 4:
-                                memcpy(&outFileSize, fecVec[0] + 4, 4);
-                                outFileSize = ntoho(outFileSize);
-                                break;
-                            default:
-                                PLOG(PL_FATAL, "\nnpc: error: unsupported file offset size\n");
-                                return false;
-                        }
-                        if (!out_file.IsOpen())
-                        {
-                            // Use meta-data file name
-                            char outFileName[PATH_MAX+1];
-                            unsigned int maxLen = (PATH_MAX < (segment_size - 12)) ? PATH_MAX : (segment_size - 12);
-                            outFileName[maxLen] = '\0';
-                            strncpy(outFileName, fecVec[0]+8, maxLen);  
-                            if (!out_file.Open(outFileName, O_WRONLY | O_CREAT | O_TRUNC))
-                            {
-                                PLOG(PL_FATAL, "\nnpc: error opening output file: %s\n", GetErrorString());
-                                return false;
-                            } 
-                        }
-                        continue;
-                    }
-                    else if ((lastFecBlockId == fecBlockId) && ((numData - 1) == i))
+                    PLOG(PL_TRACE, "\nnpc: bad checksum! (found erasure)\n");
+                    if (slot.erasure_count == num_parity)
                     {
-                        // Last segment, so calculate "lastSegmentSize"
-                        segmentSize = (unsigned int)(outFileSize % segmentSize); 
-                        if (0 == segmentSize) segmentSize = segment_size - 4;
-                    }
-                    if (out_file.Write(fecVec[i], segmentSize) != segmentSize)
-                    {
-                        PLOG(PL_FATAL, "\nnpc: unexpected error writing to output file: %s\n", GetErrorString());
+                        PLOG(PL_FATAL, "\nnpc: decoding encountered block with too many errors!\n");
                         return false;
                     }
+                    slot.erasure_locs[slot.erasure_count++] = i;
+                    memset(segment, 0, dataSegmentSize);
                 }
-                erasureCount = 0;
-                segmentCount = 0;
-                fecBlockId++;
-                state = useBuffering ? ADVANCING : READING;
-                break;
+                // (the coding range beyond the data is zero, as for encoding)
+                if (codedSize > dataSegmentSize)
+                    memset(segment + dataSegmentSize, 0, codedSize - dataSegmentSize);
             }
-                
-        }  // end switch (state)
+            SubmitBlock(slot);
+            readBlockId++;
+            ShowProgress(progressPercent, (int)((100.0 * (double)inputSegmentId) / (double)numInputSegments));
+            continue;
+        }
         
-        if (++progressCounter >= progressThreshold)
+        // B) Output the oldest block's data once it's decoded
+        Slot& slot = slot_list[writeBlockId % slot_count];
+        CollectBlock(slot);
+        for (unsigned int i = 0; i < slot.num_data; i++)
         {
-            if (progressPercent < 9)
-                PLOG(PL_ALWAYS, "\b\b\b%d%%)", progressPercent + 1);
-            else if (progressPercent < 99)
-                PLOG(PL_ALWAYS, "\b\b\b\b%d%%)", progressPercent + 1);
-            if (progressPercent < 99) progressPercent++;
-            progressCounter = 0;
-        }    
-        
-    }  // end while (inputSegmentId < numInputSegments)
+            unsigned int segmentSize = dataSegmentSize;  // don't write the CRC tail
+            if ((0 == writeBlockId) && (0 == i))
+            {
+                // First segment of first block is our "meta_data" with file size info   
+                switch (sizeof(ProtoFile::Offset))
+                {
+                    case 8:
+                        memcpy(&outFileSize, slot.vec[0], 8);
+                        outFileSize = ntoho(outFileSize);
+                        break;
+                    case 4:
+                        memcpy(&outFileSize, slot.vec[0] + 4, 4);
+                        outFileSize = ntoho(outFileSize);
+                        break;
+                    default:
+                        PLOG(PL_FATAL, "\nnpc: error: unsupported file offset size\n");
+                        return false;
+                }
+                if (!out_file.IsOpen())
+                {
+                    // Use meta-data file name
+                    char outFileName[PATH_MAX+1];
+                    unsigned int maxLen = (PATH_MAX < (segment_size - 12)) ? PATH_MAX : (segment_size - 12);
+                    outFileName[maxLen] = '\0';
+                    strncpy(outFileName, slot.vec[0]+8, maxLen);  
+                    if (!out_file.Open(outFileName, O_WRONLY | O_CREAT | O_TRUNC))
+                    {
+                        PLOG(PL_FATAL, "\nnpc: error opening output file: %s\n", GetErrorString());
+                        return false;
+                    } 
+                }
+                continue;
+            }
+            else if ((lastFecBlockId == writeBlockId) && ((slot.num_data - 1) == i))
+            {
+                // Last segment, so calculate "lastSegmentSize"
+                segmentSize = (unsigned int)(outFileSize % dataSegmentSize); 
+                if (0 == segmentSize) segmentSize = dataSegmentSize;
+            }
+            if (!WriteOutput(slot.vec[i], segmentSize))
+            {
+                PLOG(PL_FATAL, "\nnpc: unexpected error writing to output file: %s\n", GetErrorString());
+                return false;
+            }
+        }
+        writeBlockId++;
+    }
+    if (!FlushOutput())
+    {
+        PLOG(PL_FATAL, "\nnpc: unexpected error writing to output file: %s\n", GetErrorString());
+        return false;
+    }
     
     if (progressPercent < 10)
         PLOG(PL_ALWAYS, "\b\b\b100%%)\n");
     else 
         PLOG(PL_ALWAYS, "\b\b\b\b100%%)\n");
     
-    // Cleanup, cleanup
-    delete[] iBuffer;
-    delete[] fecVec;
-    delete[] erasureLocs;
-    
     return true;
 }  // end NormPrecodeApp::Decode()
 
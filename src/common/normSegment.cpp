@@ -1,7 +1,17 @@
 #include "normSegment.h"
 
+#include <new>  // for placement new
+
+#ifndef WIN32
+#include <sys/mman.h>     // for mmap()
+#include <sys/syscall.h>  // for SYS_mbind
+#include <unistd.h>
+#endif // !WIN32
+
 NormSegmentPool::NormSegmentPool()
  : seg_size(0), seg_count(0), seg_total(0), seg_list(NULL), seg_pool(NULL),
+   slab_mode(false), slab_huge_pages(false), slab_numa_node(-1),
+   slab_ptr(NULL), slab_size(0), share_pool(NULL),
    peak_usage(0), overruns(0), overrun_flag(false)
 {
 }
@@ -13,7 +23,18 @@ NormSegmentPool::~NormSegmentPool()
 
 bool NormSegmentPool::Init(unsigned int count, unsigned int size)
 {
-    if (seg_pool) Destroy();
+    if (seg_pool || slab_ptr) 
+    {
+        NormSegmentPool* sharePool = share_pool;
+        Destroy();
+        share_pool = sharePool;
+    }
+    if (NULL != share_pool)
+    {
+        // (NormBufferPool::Bind() made sure its segments are big enough)
+        seg_size = share_pool->GetSegmentSize();
+        return true;
+    }
     peak_usage = 0;
     overruns = 0;        
 #ifdef SIMULATE
@@ -25,6 +46,16 @@ bool NormSegmentPool::Init(unsigned int count, unsigned int size)
     unsigned int allocSize = size / sizeof(char*);
     if ((allocSize*sizeof(char*)) < size) allocSize++;
     seg_size = allocSize * sizeof(char*);
+    if (slab_mode)
+    {
+        if (!InitSlab(count))
+        {
+            Destroy();
+            return false;
+        }
+        seg_total = seg_count = count;
+        return true;
+    }
 	seg_pool = new char*[allocSize * count];
 	if (seg_pool)
 	{
@@ -47,20 +78,128 @@ bool NormSegmentPool::Init(unsigned int count, unsigned int size)
 	return true;
 }  // end NormSegmentPool::Init()
 
+bool NormSegmentPool::InitSlab(unsigned int count)
+{
+    // Round segments up to a cache line multiple and carve them from one region
+    seg_size = ((seg_size + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE) * CACHE_LINE_SIZE;
+    size_t regionSize = (size_t)seg_size * count;
+    char* region;
+#ifdef WIN32
+    if (NULL == (slab_ptr = new char[regionSize + CACHE_LINE_SIZE - 1]))
+    {
+        PLOG(PL_FATAL, "NormSegmentPool::InitSlab() memory allocation error: %s\n", GetErrorString());
+        return false;
+    }
+    slab_size = 0;
+    region = slab_ptr + ((CACHE_LINE_SIZE - ((size_t)slab_ptr % CACHE_LINE_SIZE)) % CACHE_LINE_SIZE);
+#else
+    void* ptr = MAP_FAILED;
+#ifdef MAP_HUGETLB
+    if (slab_huge_pages)
+    {
+        // Explicit huge page mappings must be a multiple of the (assumed 2 MB) huge page size
+        const size_t HUGE_PAGE_SIZE = 2*1024*1024;
+        size_t hugeSize = ((regionSize + HUGE_PAGE_SIZE - 1) / HUGE_PAGE_SIZE) * HUGE_PAGE_SIZE;
+        ptr = mmap(NULL, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (MAP_FAILED != ptr)
+            regionSize = hugeSize;
+        else
+            PLOG(PL_WARN, "NormSegmentPool::InitSlab() MAP_HUGETLB mmap() error: %s (using normal pages)\n", GetErrorString());
+    }
+#endif // MAP_HUGETLB
+    if (MAP_FAILED == ptr)
+    {
+        ptr = mmap(NULL, regionSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (MAP_FAILED == ptr)
+        {
+            PLOG(PL_FATAL, "NormSegmentPool::InitSlab() mmap() error: %s\n", GetErrorString());
+            return false;
+        }
+#ifdef MADV_HUGEPAGE
+        // Ask for transparent huge pages instead
+        if (slab_huge_pages) madvise(ptr, regionSize, MADV_HUGEPAGE);
+#endif // MADV_HUGEPAGE
+    }
+#ifdef SYS_mbind
+    if (slab_numa_node >= 0)
+    {
+        // Bind the (not yet touched) region pages to the given node (MPOL_BIND == 2)
+        unsigned long nodeMask[4];
+        memset(nodeMask, 0, sizeof(nodeMask));
+        const unsigned int bitsPerLong = 8*sizeof(unsigned long);
+        if ((unsigned int)slab_numa_node < (4*bitsPerLong))
+        {
+            nodeMask[slab_numa_node / bitsPerLong] = 1UL << (slab_numa_node % bitsPerLong);
+            if (0 != syscall(SYS_mbind, ptr, regionSize, 2, nodeMask, 4*bitsPerLong + 1, 0))
+                PLOG(PL_WARN, "NormSegmentPool::InitSlab() mbind(%d) error: %s\n", slab_numa_node, GetErrorString());
+        }
+        else
+        {
+            PLOG(PL_WARN, "NormSegmentPool::InitSlab() invalid NUMA node %d\n", slab_numa_node);
+        }
+    }
+#endif // SYS_mbind
+    slab_ptr = region = (char*)ptr;
+    slab_size = regionSize;
+#endif // if/else WIN32
+    for (unsigned int i = 0; i < count; i++)
+    {
+        *((char**)((void*)region)) = seg_list;
+        seg_list = region;
+        region += seg_size;
+    }
+    return true;
+}  // end NormSegmentPool::InitSlab()
+
 void NormSegmentPool::Destroy()
 {
     ASSERT(seg_count == seg_total);
 	if (NULL != seg_pool)
         delete[] seg_pool;
 	seg_pool = NULL;
+    if (NULL != slab_ptr)
+    {
+#ifndef WIN32
+        if (0 != slab_size)
+            munmap(slab_ptr, slab_size);
+        else
+#endif // !WIN32
+            delete[] slab_ptr;
+        slab_ptr = NULL;
+    }
+    slab_size = 0;
 	seg_list = NULL;
 	seg_count = 0;
 	seg_total = 0;
 	seg_size = 0;
+    share_pool = NULL;
 }  // end NormSegmentPool::Destroy()
 
+void NormSegmentPool::Prefault()
+{
+    if (NULL != share_pool)
+    {
+        share_pool->Prefault();
+        return;
+    }
+    char* base;
+    if (NULL != slab_ptr)
+        base = slab_ptr + ((CACHE_LINE_SIZE - ((size_t)slab_ptr % CACHE_LINE_SIZE)) % CACHE_LINE_SIZE);
+    else
+        base = (char*)seg_pool;
+    size_t size = (size_t)seg_size * seg_total;
+    if ((NULL == base) || (0 == size)) return;
+    // (rewrite a byte per page so the free list links are kept)
+    const size_t PAGE_SIZE_MIN = 4096;
+    volatile char* ptr = base;
+    for (size_t offset = 0; offset < size; offset += PAGE_SIZE_MIN)
+        ptr[offset] = ptr[offset];
+    ptr[size - 1] = ptr[size - 1];
+}  // end NormSegmentPool::Prefault()
+
 char* NormSegmentPool::Get()
 {
+    if (NULL != share_pool) return share_pool->Get();
     char* ptr = seg_list;
     if (ptr)
     {
@@ -90,7 +229,8 @@ char* NormSegmentPool::Get()
 // NormBlock Implementation
 
 NormBlock::NormBlock()
- : size(0), segment_table(NULL), erasure_count(0), parity_count(0), next(NULL)
+ : flags(0), erasure_count(0), parity_count(0), parity_offset(0), size(0), seg_size_max(0),
+   segment_table(NULL), nack_loss(0), auto_parity(0), storage_owner(true), digest_sum(0), next(NULL)
 {
 }     
 
@@ -99,22 +239,32 @@ NormBlock::~NormBlock()
     Destroy();
 }
 
-bool NormBlock::Init(UINT16 totalSize)
+bool NormBlock::Init(UINT16 totalSize, char* storage)
 {
     if (segment_table) Destroy();
-    if (!(segment_table = new char*[totalSize]))
+    storage_owner = (NULL == storage);
+    if (!storage_owner)
+    {
+        // The "storage" is laid out as pending_mask, repair_mask, segment_table
+        UINT32 numWords = NormBitmask::GetWordCount(totalSize);
+        UINT64* words = (UINT64*)storage;
+        pending_mask.Attach(words, totalSize);
+        repair_mask.Attach(words + numWords, totalSize);
+        segment_table = (char**)(words + 2*numWords);
+    }
+    else if (!(segment_table = new char*[totalSize]))
     {
         PLOG(PL_FATAL, "NormBlock::Init() segment_table allocation error: %s\n", GetErrorString());
         return false;   
     }
     memset(segment_table, 0, totalSize*sizeof(char*));
-    if (!pending_mask.Init(totalSize))
+    if (storage_owner && !pending_mask.Init(totalSize))
     {
         PLOG(PL_FATAL, "NormBlock::Init() pending_mask allocation error: %s\n", GetErrorString());
         Destroy();
         return false;   
     }
-    if (!repair_mask.Init(totalSize))
+    if (storage_owner && !repair_mask.Init(totalSize))
     {
         PLOG(PL_FATAL, "NormBlock::Init() repair_mask allocation error: %s\n", GetErrorString());
         Destroy();
@@ -130,8 +280,16 @@ bool NormBlock::Init(UINT16 totalSize)
 
 void NormBlock::Destroy()
 {
-    repair_mask.Destroy();
-    pending_mask.Destroy();
+    if (storage_owner)
+    {
+        repair_mask.Destroy();
+        pending_mask.Destroy();
+    }
+    else
+    {
+        repair_mask.Detach();
+        pending_mask.Detach();
+    }
     // (TBD) Option to return segments to pool from which they came
     if (segment_table)
     {
@@ -140,7 +298,7 @@ void NormBlock::Destroy()
             ASSERT(!segment_table[i]);
             if (segment_table[i]) delete []segment_table[i];
         }
-        delete []segment_table;
+        if (storage_owner) delete []segment_table;
         segment_table = (char**)NULL;
     }
     erasure_count = parity_count = size = 0;
@@ -233,6 +391,7 @@ bool NormBlock::TxReset(UINT16 numData,
         pending_mask.UnsetBits(numData+autoParity, numParity-autoParity);
         parity_offset = autoParity;  // reset parity since we're resending this one
         parity_count = numParity;    // no parity repair this repair cycle
+        auto_parity = autoParity;
         SetFlag(IN_REPAIR);
         if (!ParityReady(numData))  // (TBD) only when incrementalParity == true
         {
@@ -415,72 +574,64 @@ bool NormBlock::AppendRepairAdv(NormCmdRepairAdvMsg& cmd,
     req.SetFlag(NormRepairRequest::SEGMENT);
     if (repairInfo) req.SetFlag(NormRepairRequest::INFO);
     NormSymbolId nextId = 0;
-    if (GetFirstRepair(nextId))
+    UINT16 segmentCount = 0;
+    if (GetNextRepairRun(nextId, segmentCount))
     {
-        UINT16 totalSize = size;
         NormRepairRequest::Form prevForm = NormRepairRequest::INVALID;
-        UINT16 segmentCount = 0;
-        UINT16 firstId = 0;
-        while (nextId < totalSize)
+        do
         {
-            UINT16 currentId = nextId;
-            if (!GetNextRepair(++nextId)) nextId = totalSize;
-            if (!segmentCount) firstId = currentId;
-            segmentCount++;
-            // Check for break in consecutive series or end
-            if (((nextId  - currentId) > 1) || (nextId >= totalSize))
+            UINT16 firstId = nextId;
+            UINT16 currentId = firstId + segmentCount - 1;  // last segment of run
+            nextId = currentId + 1;
+            NormRepairRequest::Form form;
+            switch (segmentCount)
             {
-                NormRepairRequest::Form form;
-                switch (segmentCount)
-                {
-                    case 0:
-                        form = NormRepairRequest::INVALID;
-                        break;
-                    case 1:
-                    case 2:
-                        form = NormRepairRequest::ITEMS;
-                        break;
-                    default:
-                        form = NormRepairRequest::RANGES;
-                        break;
-                }
-                if (form != prevForm)
+                case 0:
+                    form = NormRepairRequest::INVALID;
+                    break;
+                case 1:
+                case 2:
+                    form = NormRepairRequest::ITEMS;
+                    break;
+                default:
+                    form = NormRepairRequest::RANGES;
+                    break;
+            }
+            if (form != prevForm)
+            {
+                if (NormRepairRequest::INVALID != prevForm) 
                 {
-                    if (NormRepairRequest::INVALID != prevForm) 
+                    if (0 == cmd.PackRepairRequest(req))
                     {
-                        if (0 == cmd.PackRepairRequest(req))
-                        {
-                            prevForm = NormRepairRequest::INVALID;
-                            PLOG(PL_WARN, "NormBlock::AppendRepairAdv() warning: full msg\n");
-                            break;
-                        }
-                        requestAppended = true;
-                    }
-                    req.SetForm(form);
-                    cmd.AttachRepairRequest(req, payloadMax); // (TBD) error check
-                    prevForm = form;
-                }            
-                switch(form)
-                {
-                    case NormRepairRequest::INVALID:
-                        ASSERT(0);  // can't happen
-                        break;
-                    case NormRepairRequest::ITEMS:
-                        req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, firstId);
-                        if (2 == segmentCount) 
-                            req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, currentId);
-                        break;
-                    case NormRepairRequest::RANGES:
-                        req.AppendRepairRange(fecId, fecM, objectId, blk_id, numData, firstId,
-                                              objectId, blk_id, numData, currentId);
-                        break;
-                    case NormRepairRequest::ERASURES:
-                        // erasure counts not used
+                        prevForm = NormRepairRequest::INVALID;
+                        PLOG(PL_WARN, "NormBlock::AppendRepairAdv() warning: full msg\n");
                         break;
-                } 
-                segmentCount = 0;  
-            }
-        }  // end while (nextId < totalSize)
+                    }
+                    requestAppended = true;
+                }
+                req.SetForm(form);
+                cmd.AttachRepairRequest(req, payloadMax); // (TBD) error check
+                prevForm = form;
+            }            
+            switch(form)
+            {
+                case NormRepairRequest::INVALID:
+                    ASSERT(0);  // can't happen
+                    break;
+                case NormRepairRequest::ITEMS:
+                    req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, firstId);
+                    if (2 == segmentCount) 
+                        req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, currentId);
+                    break;
+                case NormRepairRequest::RANGES:
+                    req.AppendRepairRange(fecId, fecM, objectId, blk_id, numData, firstId,
+                                          objectId, blk_id, numData, currentId);
+                    break;
+                case NormRepairRequest::ERASURES:
+                    // erasure counts not used
+                    break;
+            } 
+        } while ((nextId < size) && GetNextRepairRun(nextId, segmentCount));
         if (NormRepairRequest::INVALID != prevForm) 
         {
             if (0 == cmd.PackRepairRequest(req))
@@ -520,17 +671,22 @@ NormObjectSize NormBlock::GetBytesPending(UINT16      numData,
 }  // end NormBlock::GetBytesPending()
 
 // Called by receiver
-// (TBD) this should return true iff something appended, false otherwise
-bool NormBlock::AppendRepairRequest(NormNackMsg&    nack, 
-                                    UINT8           fecId,
-                                    UINT8           fecM,
-                                    UINT16          numData, 
-                                    UINT16          numParity,
-                                    NormObjectId    objectId,
-                                    bool            pendingInfo,
-                                    UINT16          payloadMax)
+// Appends this block's SEGMENT repair items to "req", continuing it if
+// it's already open with the needed form (so consecutive blocks share
+// one request header) or packing it and attaching a new one.  The last
+// request is left open ("reqForm" != INVALID) for the caller to continue
+// or pack. Returns false if the NACK message filled up.
+bool NormBlock::AppendRepairRequest(NormNackMsg&             nack, 
+                                    NormRepairRequest&       req,
+                                    NormRepairRequest::Form& reqForm,
+                                    UINT8                    fecId,
+                                    UINT8                    fecM,
+                                    UINT16                   numData, 
+                                    UINT16                   numParity,
+                                    NormObjectId             objectId,
+                                    bool                     pendingInfo,
+                                    UINT16                   payloadMax)
 {
-    bool requestAppended = false;
     NormSegmentId nextId = 0;
     NormSegmentId endId;
     if (erasure_count > numParity)
@@ -552,86 +708,60 @@ bool NormBlock::AppendRepairRequest(NormNackMsg&    nack,
         GetNextPending(nextId);
         endId = numData + erasure_count;   
     }
-    NormRepairRequest req;
-    req.SetFlag(NormRepairRequest::SEGMENT);                  
-    if (pendingInfo) req.SetFlag(NormRepairRequest::INFO);  
-    NormRepairRequest::Form prevForm = NormRepairRequest::INVALID;
+    // Step through runs of consecutive pending segments (found a mask
+    // word at a time) instead of testing segment by segment
     UINT16 segmentCount = 0;
-    // new code begins here  
-    UINT16 firstId = 0;
-    while (nextId < endId)
-    {
-        UINT16 currentId = nextId;
-        if (!GetNextPending(++nextId)) nextId = endId;
-        if (0 == segmentCount) firstId = currentId;
-        segmentCount++;
-        // Check for break in consecutive series or end
-        if (((nextId  - currentId) > 1) || (nextId >= endId))
+    while ((nextId < endId) && GetNextPendingRun(nextId, segmentCount) && (nextId < endId))
+    {
+        UINT16 firstId = nextId;
+        if (segmentCount > (endId - firstId)) segmentCount = endId - firstId;
+        UINT16 currentId = firstId + segmentCount - 1;  // last segment of run
+        nextId = currentId + 1;
+        NormRepairRequest::Form form = (segmentCount > 2) ? NormRepairRequest::RANGES : NormRepairRequest::ITEMS;
+        if (form != reqForm)
         {
-            NormRepairRequest::Form form;
-            switch (segmentCount)
-            {
-                case 0:
-                    form = NormRepairRequest::INVALID;
-                    break;
-                case 1:
-                case 2:
-                    form = NormRepairRequest::ITEMS;
-                    break;
-                default:
-                    form = NormRepairRequest::RANGES;
-                    break;
-            }   
-            if (form != prevForm)
+            if (NormRepairRequest::INVALID != reqForm) 
             {
-                if (NormRepairRequest::INVALID != prevForm) 
+                if (0 == nack.PackRepairRequest(req))
                 {
-                    if (0 == nack.PackRepairRequest(req))
-                    {
-                        prevForm = NormRepairRequest::INVALID;  // so we don't re-attempt pack
-                        PLOG(PL_WARN, "NormBlock::AppendRepairRequest() warning: full NACK msg\n");
-                        break;   
-                    }
-                    requestAppended = true;
+                    reqForm = NormRepairRequest::INVALID;  // so we don't re-attempt pack
+                    PLOG(PL_WARN, "NormBlock::AppendRepairRequest() warning: full NACK msg\n");
+                    return false;   
                 }
-                nack.AttachRepairRequest(req, payloadMax);  // (TBD) error check
-                req.SetForm(form);
-                prevForm = form;
             }
-            switch (form)
-            {
-                case NormRepairRequest::INVALID:
-                    ASSERT(0);
-                    break;
-                case NormRepairRequest::ITEMS:
-                    req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, firstId);       // (TBD) error check
-                    if (2 == segmentCount)
-                        req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, currentId); // (TBD) error check
-                    break;
-                case NormRepairRequest::RANGES:
-                    req.AppendRepairRange(fecId, fecM, 
-                                          objectId, blk_id, numData, firstId,       // (TBD) error check
-                                          objectId, blk_id, numData, currentId);    // (TBD) error check
-                    break;
-                case NormRepairRequest::ERASURES:
-                    // erasure counts not used
-                    break;
-            }  // end switch(form)
-            segmentCount = 0;
-        }       
-    }  // end while (nextId < lastId)
-    if (NormRepairRequest::INVALID != prevForm) 
-    {
-        if (0 == nack.PackRepairRequest(req))
-            PLOG(PL_WARN, "NormBlock::AppendRepairRequest() warning: full NACK msg\n");
+            nack.AttachRepairRequest(req, payloadMax);
+            req.SetForm(form);
+            req.ResetFlags();
+            req.SetFlag(NormRepairRequest::SEGMENT);                  
+            if (pendingInfo) req.SetFlag(NormRepairRequest::INFO);  
+            reqForm = form;
+        }
+        bool itemAppended;
+        if (NormRepairRequest::ITEMS == form)
+        {
+            itemAppended = req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, firstId);
+            if (itemAppended && (2 == segmentCount))
+                itemAppended = req.AppendRepairItem(fecId, fecM, objectId, blk_id, numData, currentId);
+        }
         else
-            requestAppended = true;
-    }
-    return requestAppended;
+        {
+            itemAppended = req.AppendRepairRange(fecId, fecM, 
+                                                 objectId, blk_id, numData, firstId,
+                                                 objectId, blk_id, numData, currentId);
+        }
+        if (!itemAppended)
+        {
+            // (the caller packs the items that did fit)
+            PLOG(PL_WARN, "NormBlock::AppendRepairRequest() warning: full NACK msg\n");
+            return false;
+        }
+    }  // end while (nextId < endId)
+    return true;
 }  // end NormBlock::AppendRepairRequest()
          
 NormBlockPool::NormBlockPool()
- : head((NormBlock*)NULL), blk_total(0), blk_count(0), overruns(0), overrun_flag(false)
+ : head((NormBlock*)NULL), blk_size(0), blk_total(0), blk_count(0), overruns(0), overrun_flag(false),
+   slab_mode(false), slab_array(NULL), share_pool(NULL)
 {
 }
 
@@ -642,34 +772,61 @@ NormBlockPool::~NormBlockPool()
 
 bool NormBlockPool::Init(UINT32 numBlocks, UINT16 segsPerBlock)
 {
-    if (head) Destroy();
+    if (head || slab_array) 
+    {
+        NormBlockPool* sharePool = share_pool;
+        Destroy();
+        share_pool = sharePool;
+    }
+    if (NULL != share_pool)
+    {
+        // (NormBufferPool::Bind() made sure its blocks are big enough)
+        blk_size = share_pool->GetBlockSize();
+        return true;
+    }
+    blk_size = segsPerBlock;
+    // Each block's segment table and masks directly follow it so that
+    // a block is one allocation (and the slab one for all blocks)
+    size_t blockSpace = GetBlockSpace(segsPerBlock);
+    size_t blockWords = (blockSpace + sizeof(UINT64) - 1) / sizeof(UINT64);
+    size_t headerSpace = blockSpace - NormBlock::GetStorageSize(segsPerBlock);
+    if (slab_mode && (NULL == (slab_array = new UINT64[(size_t)numBlocks * blockWords])))
+    {
+        PLOG(PL_FATAL, "NormBlockPool::Init() new slab error: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
     for (UINT32 i = 0; i < numBlocks; i++)
     {
-        NormBlock* b = new NormBlock();
-        if (b)
-        {
-            if (!b->Init(segsPerBlock))
-            {
-                PLOG(PL_FATAL, "NormBlockPool::Init() block init error\n");
-                delete b;
-                Destroy();
-                return false;   
-            }  
-            b->next = head;
-            head = b;
-            blk_count++;
-            blk_total++;
-        }
-        else
+        UINT64* space = slab_mode ? (slab_array + ((size_t)i * blockWords)) : new UINT64[blockWords];
+        if (NULL == space)
         {
             PLOG(PL_FATAL, "NormBlockPool::Init() new block error\n");
             Destroy();
             return false; 
         } 
+        NormBlock* b = new (space) NormBlock();
+        if (!b->Init(segsPerBlock, (char*)space + headerSpace))
+        {
+            PLOG(PL_FATAL, "NormBlockPool::Init() block init error\n");
+            DestroyBlock(b);
+            Destroy();
+            return false;   
+        }  
+        b->next = head;
+        head = b;
+        blk_count++;
+        blk_total++;
     }
     return true;
 }  // end NormBlockPool::Init()
 
+void NormBlockPool::DestroyBlock(NormBlock* b)
+{
+    b->~NormBlock();
+    if (NULL == slab_array) delete[] (UINT64*)b;
+}  // end NormBlockPool::DestroyBlock()
+
 void NormBlockPool::Destroy()
 {
     ASSERT(blk_total == blk_count);
@@ -677,11 +834,74 @@ void NormBlockPool::Destroy()
     while ((next = head))
     {
         head = next->next;
-        delete next;   
+        DestroyBlock(next);   
+    }
+    if (NULL != slab_array)
+    {
+        delete[] slab_array;  // (after the blocks it holds are destroyed)
+        slab_array = NULL;
     }
     blk_count = blk_total = 0;
+    blk_size = 0;
+    share_pool = NULL;
 }  // end NormBlockPool::Destroy()
 
+NormBufferPool::NormBufferPool()
+ : segment_size(0), block_size(0), ref_count(1)
+{
+}
+
+NormBufferPool::~NormBufferPool()
+{
+    block_pool.Destroy();
+    segment_pool.Destroy();
+}
+
+bool NormBufferPool::Init(unsigned long bufferSpace, UINT16 segmentSize, UINT16 numData, UINT16 numParity, 
+                          bool slabMode, bool hugePages, int numaNode)
+{
+    // Blocks are sized for "numParity" buffered segments each, as for 
+    // both the sender (parity) and remote senders (decoding)
+    UINT16 blockSize = numData + numParity;
+    unsigned long blockSpace = NormBlockPool::GetBlockSpace(blockSize) +
+                               numParity * (segmentSize + NormDataMsg::GetStreamPayloadHeaderLength());
+    unsigned long numBlocks = bufferSpace / blockSpace;
+    if (bufferSpace > (numBlocks * blockSpace)) numBlocks++;
+    if (numBlocks < 2) numBlocks = 2;
+    unsigned long numSegments = numBlocks * numParity;
+    block_pool.SetSlabMode(slabMode);
+    segment_pool.SetSlabMode(slabMode, hugePages, numaNode);
+    if (!block_pool.Init((UINT32)numBlocks, blockSize))
+    {
+        PLOG(PL_FATAL, "NormBufferPool::Init() block_pool init error\n");
+        return false;
+    }
+    if ((0 != numSegments) && 
+        !segment_pool.Init((unsigned int)numSegments, segmentSize + NormDataMsg::GetStreamPayloadHeaderLength()))
+    {
+        PLOG(PL_FATAL, "NormBufferPool::Init() segment_pool init error\n");
+        block_pool.Destroy();
+        return false;
+    }
+    segment_size = segmentSize;
+    block_size = blockSize;
+    return true;
+}  // end NormBufferPool::Init()
+
+bool NormBufferPool::Bind(NormSegmentPool& segmentPool, NormBlockPool& blockPool,
+                          UINT16 segmentSize, UINT16 blockSize)
+{
+    if ((segmentSize > segment_size) || (blockSize != block_size))
+    {
+        segmentPool.SetSharePool(NULL);
+        blockPool.SetSharePool(NULL);
+        return false;
+    }
+    segmentPool.SetSharePool(&segment_pool);
+    blockPool.SetSharePool(&block_pool);
+    return true;
+}  // end NormBufferPool::Bind()
+
 NormBlockBuffer::NormBlockBuffer()
 #ifdef USE_PROTO_TREE
  :
@@ -718,6 +938,14 @@ bool NormBlockBuffer::Init(unsigned long rangeMax, unsigned long tableSize, UINT
     memset(table, 0, tableSize*sizeof(char*));
     hash_mask = tableSize - 1;
 #endif // !USE_PROTO_TREE
+    // The ring covers up to "tableSize" blocks of the window (but no more
+    // than the block id space so ids within it never share a slot)
+    UINT32 ringMax = (0xffffffff != fecBlockMask) ? (fecBlockMask + 1) : 0x80000000;
+    if (!ring.Init((UINT32)MIN(rangeMax, tableSize), ringMax))
+    {
+        Destroy();
+        return false;
+    }
     range_max = rangeMax;
     range = 0;
     fec_block_mask = fecBlockMask;
@@ -734,6 +962,7 @@ void NormBlockBuffer::Destroy()
         Remove(block);
         delete block;   
     }
+    ring.Destroy();
     range_max = range = 0;
 }  // end NormBlockBuffer::Destroy()
 
@@ -741,8 +970,13 @@ NormBlock* NormBlockBuffer::Find(const NormBlockId& blockId) const
 {
     if ((0 == range) || (Compare(blockId, range_lo) < 0) || (Compare(blockId, range_hi) > 0))
         return NULL;
-    else
+    NormBlock* theBlock = ring.Get(blockId.GetValue());
+    if ((NULL != theBlock) && (blockId == theBlock->GetId()))
+        return theBlock;
+    else if (ring.HasOverflow())
         return tree.Find(blockId.GetValuePtr(), 8*sizeof(UINT32));
+    else
+        return NULL;
 }  // end NormBlockBuffer::Find()
 
 #else
@@ -761,6 +995,7 @@ void NormBlockBuffer::Destroy()
         delete []table;
         table = (NormBlock**)NULL;
     }  
+    ring.Destroy();
     range_max = range = 0;  
 }  // end NormBlockBuffer::Destroy()
 
@@ -771,7 +1006,12 @@ NormBlock* NormBlockBuffer::Find(const NormBlockId& blockId) const
         //if ((blockId < range_lo)  || (blockId > range_hi)) 
         if ((Compare(blockId, range_lo) < 0) || (Compare(blockId, range_hi) > 0))
             return (NormBlock*)NULL;
-        NormBlock* theBlock = table[(blockId.GetValue()) & hash_mask];
+        NormBlock* theBlock = ring.Get(blockId.GetValue());
+        if ((NULL != theBlock) && (blockId == theBlock->GetId()))
+            return theBlock;
+        else if (!ring.HasOverflow())
+            return (NormBlock*)NULL;
+        theBlock = table[(blockId.GetValue()) & hash_mask];
         while ((NULL != theBlock) && (blockId != theBlock->GetId())) 
             theBlock = theBlock->next;
         return theBlock;
@@ -876,6 +1116,7 @@ bool NormBlockBuffer::Insert(NormBlock* theBlock)
     ASSERT((entry ? (blockId != entry->GetId()) : true));
     theBlock->next = entry;
 #endif // if/else USE_PROTO_TREE
+    ring.Insert(blockId.GetValue(), theBlock);
     return true;
 }  // end NormBlockBuffer::Insert()
 
@@ -918,6 +1159,7 @@ bool NormBlockBuffer::Remove(NormBlock* theBlock)
     }
     ASSERT(NULL != tree.Find(theBlock->GetId().GetValuePtr(), 8*sizeof(UINT32)));
     tree.Remove(*theBlock);
+    ring.Remove(blockId.GetValue(), theBlock);
     return true;
 }  // end NormBlockBuffer::Remove()
 
@@ -945,6 +1187,7 @@ bool NormBlockBuffer::Remove(NormBlock* theBlock)
             prev->next = entry->next;
         else
             table[index] = entry->next;
+        ring.Remove(blockId.GetValue(), theBlock);
         
         if (range > 1)
         {
@@ -1157,3 +1400,168 @@ NormBlock* NormBlockBuffer::Iterator::GetNextBlock()
 }  // end NormBlockBuffer::Iterator::GetNextBlock()
 
 #endif  // if/else USE_PROTO_TREE
+
+const UINT64 NormParityCache::HASH_INIT = 0xcbf29ce484222325ULL;
+
+NormParityCache::Entry::Entry(UINT64 contentKey, UINT32 blockId)
+ : data(NULL), data_len(0), num_parity(0), segment_length(0), seg_size_max(0),
+   prev(NULL), next(NULL)
+{
+    memcpy(key, &contentKey, 8);
+    memcpy(key + 8, &blockId, 4);
+}
+
+NormParityCache::Entry::~Entry()
+{
+    if (NULL != data) delete[] data;
+}
+
+bool NormParityCache::Entry::Init(unsigned long length)
+{
+    if (NULL == (data = new char[length]))
+    {
+        PLOG(PL_ERROR, "NormParityCache::Entry::Init() new data error: %s\n", GetErrorString());
+        return false;
+    }
+    data_len = length;
+    return true;
+}  // end NormParityCache::Entry::Init()
+
+NormParityCache::NormParityCache()
+ : lru_head(NULL), lru_tail(NULL), byte_max(0), byte_count(0)
+{
+}
+
+NormParityCache::~NormParityCache()
+{
+    Destroy();
+}
+
+bool NormParityCache::Init(unsigned long byteMax)
+{
+    Destroy();
+    byte_max = byteMax;
+    return true;
+}  // end NormParityCache::Init()
+
+void NormParityCache::Destroy()
+{
+    while (NULL != lru_head) Remove(lru_head);
+    byte_max = 0;
+}  // end NormParityCache::Destroy()
+
+UINT64 NormParityCache::Hash(const void* buffer, size_t len, UINT64 hash)
+{
+    const unsigned char* ptr = (const unsigned char*)buffer;
+    const unsigned char* end = ptr + len;
+    while (ptr < end)
+    {
+        hash ^= (UINT64)(*ptr++);
+        hash *= 0x100000001b3ULL;  // FNV 64-bit prime
+    }
+    return hash;
+}  // end NormParityCache::Hash()
+
+NormParityCache::Entry* NormParityCache::Find(UINT64 contentKey, UINT32 blockId)
+{
+    char key[12];
+    memcpy(key, &contentKey, 8);
+    memcpy(key + 8, &blockId, 4);
+    return tree.Find(key, 8 * 12);
+}  // end NormParityCache::Find()
+
+void NormParityCache::Touch(Entry* entry)
+{
+    if (entry == lru_head) return;
+    // Unlink and put at head (most recently used)
+    if (NULL != entry->prev) entry->prev->next = entry->next;
+    if (NULL != entry->next)
+        entry->next->prev = entry->prev;
+    else
+        lru_tail = entry->prev;
+    entry->prev = NULL;
+    entry->next = lru_head;
+    if (NULL != lru_head)
+        lru_head->prev = entry;
+    else
+        lru_tail = entry;
+    lru_head = entry;
+}  // end NormParityCache::Touch()
+
+void NormParityCache::Remove(Entry* entry)
+{
+    if (NULL != entry->prev)
+        entry->prev->next = entry->next;
+    else
+        lru_head = entry->next;
+    if (NULL != entry->next)
+        entry->next->prev = entry->prev;
+    else
+        lru_tail = entry->prev;
+    tree.Remove(*entry);
+    byte_count -= entry->data_len;
+    delete entry;
+}  // end NormParityCache::Remove()
+
+bool NormParityCache::Retrieve(UINT64   contentKey, 
+                               UINT32   blockId, 
+                               UINT16   numParity, 
+                               UINT16   segmentLength, 
+                               char**   parityList, 
+                               UINT16&  segSizeMax)
+{
+    if (0 == byte_max) return false;
+    Entry* entry = Find(contentKey, blockId);
+    if ((NULL == entry) || (entry->num_parity != numParity) || (entry->segment_length != segmentLength))
+        return false;
+    const char* ptr = entry->data;
+    for (UINT16 i = 0; i < numParity; i++)
+    {
+        memcpy(parityList[i], ptr, segmentLength);
+        ptr += segmentLength;
+    }
+    segSizeMax = entry->seg_size_max;
+    Touch(entry);
+    return true;
+}  // end NormParityCache::Retrieve()
+
+void NormParityCache::Store(UINT64  contentKey, 
+                            UINT32  blockId, 
+                            UINT16  numParity, 
+                            UINT16  segmentLength, 
+                            char**  parityList, 
+                            UINT16  segSizeMax)
+{
+    unsigned long length = (unsigned long)numParity * segmentLength;
+    if ((0 == length) || (length > byte_max)) return;
+    Entry* entry = Find(contentKey, blockId);
+    if (NULL != entry) Remove(entry);  // (replaced with current content)
+    while ((byte_count + length) > byte_max) Remove(lru_tail);
+    if (NULL == (entry = new Entry(contentKey, blockId)))
+    {
+        PLOG(PL_ERROR, "NormParityCache::Store() new Entry error: %s\n", GetErrorString());
+        return;
+    }
+    if (!entry->Init(length))
+    {
+        delete entry;
+        return;
+    }
+    char* ptr = entry->data;
+    for (UINT16 i = 0; i < numParity; i++)
+    {
+        memcpy(ptr, parityList[i], segmentLength);
+        ptr += segmentLength;
+    }
+    entry->num_parity = numParity;
+    entry->segment_length = segmentLength;
+    entry->seg_size_max = segSizeMax;
+    tree.Insert(*entry);
+    byte_count += length;
+    entry->next = lru_head;
+    if (NULL != lru_head)
+        lru_head->prev = entry;
+    else
+        lru_tail = entry;
+    lru_head = entry;
+}  // end NormParityCache::Store()
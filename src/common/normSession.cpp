@@ -1,15 +1,38 @@
 #include "normSession.h"
 
-#include "normEncoderMDP.h"  // "legacy" MDP Reed-Solomon encoder
-#include "normEncoderRS8.h"  // 8-bit Reed-Solomon encoder of RFC 5510
-#include "normEncoderRS16.h" // 16-bit Reed-Solomon encoder of RFC 5510
-
 #include <time.h> // for gmtime() in NormTrace()
+#ifndef WIN32
+#include <stdlib.h>  // for mkstemp()
+#include <unistd.h>  // for close()
+#endif // !WIN32
 
 #include "protoPktETH.h"
 #include "protoPktIP.h"
 #include "protoNet.h"
 
+#ifdef NORM_TX_ZEROCOPY
+#include <sys/socket.h>
+#include <sys/uio.h>   // for struct iovec
+#include <errno.h>
+#ifdef __linux__
+#include <linux/errqueue.h>  // for MSG_ZEROCOPY notifications
+#endif // __linux__
+#endif // NORM_TX_ZEROCOPY
+
+#ifdef NORM_TX_TIME
+#include <linux/net_tstamp.h>  // for struct sock_txtime
+#endif // NORM_TX_TIME
+
+#if defined(__linux__) && !defined(SIMULATE)
+#include <sched.h>    // for busy-poll mode CPU affinity
+#include <pthread.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <linux/filter.h>  // for receive sharding BPF programs
+#include <linux/sockios.h> // for SIOCGSTAMP
+#include <linux/sock_diag.h> // for SK_MEMINFO_DROPS
+#endif // __linux__ && !SIMULATE
+
 const UINT8 NormSession::DEFAULT_TTL = 255;
 const double NormSession::DEFAULT_TRANSMIT_RATE = 64000.0;  // bits/sec
 const double NormSession::DEFAULT_GRTT_INTERVAL_MIN = 1.0;  // sec
@@ -26,6 +49,28 @@ const UINT16 NormSession::DEFAULT_TX_CACHE_MAX = 256;
 const UINT32 NormSession::DEFAULT_TX_CACHE_SIZE = (UINT32)20 * 1024 * 1024;
 const double NormSession::DEFAULT_FLOW_CONTROL_FACTOR = 2.0;
 const UINT16 NormSession::DEFAULT_RX_CACHE_MAX = 256;
+const double NormSession::TX_BATCH_QUANTUM = 1.0e-03;   // sec
+const double NormSession::CC_MODEL_LOSS_MAX = 0.02;
+const double NormSession::TX_WINDOW_GAIN = 2.0;
+const double NormSession::TX_WINDOW_PROBE = 1.25;
+const double NormSession::TX_WINDOW_QUEUE_FACTOR = 1.25;
+const double NormSession::TX_WINDOW_CYCLE_AGE = 10.0;  // sec
+const unsigned int NormSession::AUTO_TUNE_SOCK_MIN = 64 * 1024;
+const unsigned int NormSession::AUTO_TUNE_SOCK_MAX = 64 * 1024 * 1024;
+const double NormSession::RX_DROP_EXCUSE_AGE = 1.0;  // sec
+const unsigned int NormSession::AEAD_OVERHEAD = 8 + NormAead::TAG_SIZE;  // nonce counter + tag
+const double NormSession::AUTO_TUNE_SOCK_FACTOR = 2.0;
+const double NormSession::AUTO_TUNE_CACHE_FACTOR = 4.0;
+const double NormSession::DEFAULT_ADAPT_PARITY_TARGET = 0.05;
+const double NormSession::GSIZE_EPOCH = 30.0;  // sec
+const double NormSessionMgr::BUSY_POLL_INTERVAL = 1.0e-05;  // sec
+const double NormSessionMgr::TX_BUDGET_WINDOW = 0.1;  // sec
+const double NormSession::RX_LAYER_INTERVAL = 1.0;  // sec
+const double NormSession::RX_LAYER_LOSS_LOW = 0.01;
+const double NormSession::RX_LAYER_LOSS_HIGH = 0.05;
+const double NormSession::RX_LAYER_BACKOFF_MIN = 2.0;   // sec
+const double NormSession::RX_LAYER_BACKOFF_MAX = 64.0;  // sec
+const double NormSessionMgr::TX_BUDGET_DEPTH = 0.01;  // sec
 
 const int NormSession::DEFAULT_ROBUST_FACTOR = 20; // default robust factor
 
@@ -43,26 +88,49 @@ enum NormSocketCommand
 };
 
 NormSession::NormSession(NormSessionMgr &sessionMgr, NormNodeId localNodeId)
-    : session_mgr(sessionMgr), notify_pending(false), tx_port(0), tx_port_reuse(false),
+    : session_mgr(sessionMgr), notify_pending(false), 
+      tx_vacancy_threshold(0), tx_vacancy_interval(0.0), rx_update_threshold(0), rx_update_interval(0.0),
+      tx_port(0), tx_port_reuse(false),
       tx_socket_actual(ProtoSocket::UDP), tx_socket(&tx_socket_actual),
-      rx_socket(ProtoSocket::UDP),
+      rx_socket(ProtoSocket::UDP), tx_batching(false), tx_zero_copy(false), tx_zero_copy_sock(false),
+      tx_zero_copy_reap(false), tx_time_pacing(false), tx_time_tai(false), tx_time_sock(false),
+      tx_time_next(0), auto_tune(false), tx_sock_buffer_base(0), rx_sock_buffer_base(0),
+      tx_sock_buffer_tuned(0), rx_sock_buffer_tuned(0), busy_poll_usec(0), rx_timestamps(false),
+      rx_drop_last(0), rx_stat_socket_drops(0), rx_drop_excuse_enable(false), rx_drop_excuse(0),
+      posted_rx_socket_overflow(false), aead_counter(0), aead_buffer(NULL), rx_stat_auth_failures(0),
 #ifdef ECN_SUPPORT 
       proto_cap(NULL), 
 #endif // ECN_SUPPORT
-      rx_port_reuse(false), local_node_id(localNodeId),
+#ifdef NORM_XDP
+      xdp_socket(NULL), xdp_queue(0), xdp_blocked(false),
+#endif // NORM_XDP
+      rx_port_reuse(false), rx_port_share(false), rx_port(NULL), rx_port_item(NULL), rx_shard_index(0), rx_shard_count(0), local_node_id(localNodeId),
       ttl(DEFAULT_TTL), tos(0), loopback(false), mcast_loopback(false), fragmentation(false), ecn_enabled(false),
-      tx_rate(DEFAULT_TRANSMIT_RATE / 8.0), tx_rate_min(-1.0), tx_rate_max(-1.0), tx_residual(0),
+      tx_rate(DEFAULT_TRANSMIT_RATE / 8.0), tx_rate_min(-1.0), tx_rate_max(-1.0), 
+      tx_budget_weight(1.0), tx_budget_capped(false), tx_residual(0),
       backoff_factor(DEFAULT_BACKOFF_FACTOR), is_sender(false),
       tx_robust_factor(DEFAULT_ROBUST_FACTOR), instance_id(0),
       ndata(DEFAULT_NDATA), nparity(DEFAULT_NPARITY), auto_parity(0), extra_parity(0),
-      sndr_emcon(false), tx_only(false), tx_connect(false), fti_mode(FTI_ALWAYS), encoder(NULL),
+      adapt_parity(false), adapt_parity_target(DEFAULT_ADAPT_PARITY_TARGET), adapt_block_count(0),
+      sndr_emcon(false), tx_only(false), tx_connect(false), fti_mode(FTI_ALWAYS),
+      tx_pending_cached(false), tx_pending_any(false),
+      tx_weighted(false), tx_weight_default(1), tx_drr_object_id(0), tx_drr_credit(0), tx_drr_skips(0),
+      encoder(NULL),
+      tx_encode_buffer(NULL), tx_encode_list(NULL), fec_instance_id(0), tx_digest(false), tx_fec_worker_count(0),
       next_tx_object_id(0),
       tx_cache_count_min(DEFAULT_TX_CACHE_MIN),
       tx_cache_count_max(DEFAULT_TX_CACHE_MAX),
-      tx_cache_size_max(DEFAULT_TX_CACHE_SIZE),
-      posted_tx_queue_empty(false), posted_tx_rate_changed(false), posted_send_error(false),
+      tx_cache_size_max(DEFAULT_TX_CACHE_SIZE), tx_cache_size_base(DEFAULT_TX_CACHE_SIZE),
+      tx_spill_count_max(0), tx_spill_size_max(0), tx_spill_count(0), tx_spill_size(0), tx_spill_next(0),
+      tx_flush_piggyback(false), posted_tx_queue_empty(false), posted_tx_rate_changed(false), posted_send_error(false),
       acking_node_count(0), acking_auto_populate(TRACK_NONE), watermark_pending(false), watermark_flushes(false),
-      tx_repair_pending(false), advertise_repairs(false),
+      watermark_flush_serial(0),
+      watermark_pipeline_head(0), watermark_pipeline_count(0), tx_repair_pending(false),
+      tx_window_enable(false), tx_window(0.0), tx_window_sent(0), tx_window_acked(0),
+      tx_window_marked(false), tx_window_mark(0), tx_window_cycle_min(-1.0),
+      tx_window_auto(false), tx_window_limited(false),
+      tx_window_object_id(0), tx_window_block_id(0), tx_window_segment_id(0),
+      advertise_repairs(false),
       suppress_nonconfirmed(false), suppress_rate(-1.0), suppress_rtt(-1.0),
       probe_proactive(true), probe_pending(false), probe_reset(true), probe_data_check(false),
       probe_tos(0), grtt_interval(0.5), grtt_interval_min(DEFAULT_GRTT_INTERVAL_MIN),
@@ -71,19 +139,52 @@ NormSession::NormSession(NormSessionMgr &sessionMgr, NormNodeId localNodeId)
       grtt_decrease_delay_count(DEFAULT_GRTT_DECREASE_DELAY),
       grtt_response(false), grtt_current_peak(0.0), grtt_age(0.0), probe_count(1),
       cc_enable(false), cc_adjust(true), cc_sequence(0), cc_slow_start(true), cc_active(false),
+      cc_mode(CC_TFMCC), cc_model_clr(NORM_NODE_NONE),
+      tx_stat_bytes(0), tx_stat_segments(0), tx_stat_repair_bytes(0), tx_stat_nacks(0),
+      latency_stats(false),
       flow_control_factor(DEFAULT_FLOW_CONTROL_FACTOR),
       cmd_count(0), cmd_buffer(NULL), cmd_length(0), syn_status(false),
       ack_ex_buffer(NULL), ack_ex_length(0),
-      is_receiver(false), rx_robust_factor(DEFAULT_ROBUST_FACTOR), preset_sender(NULL), unicast_nacks(false),
-      receiver_silent(false), rcvr_ignore_info(false), rcvr_max_delay(-1), rcvr_realtime(false),
+      is_receiver(false), rx_robust_factor(DEFAULT_ROBUST_FACTOR), unicast_nacks(false),
+      receiver_silent(false), local_repair_ttl(0), local_repairer(false),
+      ack_aggregator_id(NORM_NODE_NONE), ack_aggregation(false), rcvr_ignore_info(false), rcvr_max_delay(-1), rcvr_realtime(false), rcvr_progressive(false),
+      relay_session(NULL), rx_mirror_primary(NULL), rx_mirror_head(NULL), rx_mirror_next(NULL),
+      rx_demux_listener(NULL), rx_demux_item(NULL), buffer_pool(NULL), event_queue(NULL),
       default_repair_boundary(NormSenderNode::BLOCK_BOUNDARY),
       default_nacking_mode(NormObject::NACK_NORMAL), default_sync_policy(NormSenderNode::SYNC_CURRENT),
-      rx_cache_count_max(DEFAULT_RX_CACHE_MAX), is_server_listener(false), notify_on_grtt_update(true),
+      default_eviction_policy(NormSenderNode::EVICT_ORDINAL),
+      rx_cache_count_max(DEFAULT_RX_CACHE_MAX), rx_quota_list(NULL), rx_quota_count(0),
+      rx_decoder_cache_size(NormDecoder::MATRIX_CACHE_DEFAULT), rx_fec_worker_count(0), file_mapping(false),
+      slab_mode(false), slab_huge_pages(false), slab_numa_node(-1), memory_prefault(false),
+      is_server_listener(false), notify_on_grtt_update(true),
       ecn_ignore_loss(false),
       trace(false), tx_loss_rate(0.0), rx_loss_rate(0.0),
       user_data(NULL), next(NULL)
 {
     interface_name[0] = '\0';
+    xdp_interface[0] = '\0';
+    for (unsigned int i = 0; i < TX_PATH_MAX; i++)
+    {
+        tx_path_list[i] = NULL;
+        tx_path_weight[i] = 1.0;
+        tx_path_credit[i] = 0.0;
+    }
+    tx_path_count = 1;
+    for (unsigned int i = 0; i < LAYER_MAX; i++)
+    {
+        tx_layer_addr[i].Invalidate();
+        tx_layer_weight[i] = 1.0;
+        tx_layer_credit[i] = 0.0;
+        tx_layer_seq[i] = 0;
+    }
+    tx_layer_count = 1;
+    tx_layer_scale = 1.0;
+    rx_layer_count = 1;
+    rx_layer_top = 0;
+    rx_layer_time = 0.0;
+    rx_msg_layer = 0;
+    rx_journal_dir[0] = '\0';
+    tx_spill_dir[0] = '\0';
     tx_socket_actual.SetNotifier(&sessionMgr.GetSocketNotifier());
     tx_socket_actual.SetListener(this, &NormSession::TxSocketRecvHandler);
     tx_address.Invalidate();
@@ -98,6 +199,8 @@ NormSession::NormSession(NormSessionMgr &sessionMgr, NormNodeId localNodeId)
     repair_timer.SetListener(this, &NormSession::OnRepairTimeout);
     repair_timer.SetInterval(0.0);
     repair_timer.SetRepeat(1);
+    memset(nack_digest, 0, sizeof(nack_digest));
+    nack_digest_count = 0;
 
     flush_timer.SetListener(this, &NormSession::OnFlushTimeout);
     flush_timer.SetInterval(0.0);
@@ -122,6 +225,11 @@ NormSession::NormSession(NormSessionMgr &sessionMgr, NormNodeId localNodeId)
     gsize_measured = DEFAULT_GSIZE_ESTIMATE;
     gsize_quantized = NormQuantizeGroupSize(DEFAULT_GSIZE_ESTIMATE);
     gsize_advertised = NormUnquantizeGroupSize(gsize_quantized);
+    gsize_auto = false;
+    gsize_age = 0.0;
+    gsize_epoch = 0;
+    gsize_zeros = GSIZE_BITMAP_BITS;
+    memset(gsize_bitmap, 0, sizeof(gsize_bitmap));
 
     // This timer is for printing out occasional status reports
     // (It may be used to trigger transmission of report messages
@@ -139,17 +247,178 @@ NormSession::~NormSession()
 {
     if (user_timer.IsActive())
         user_timer.Deactivate();
-    if (NULL != preset_sender)
+    preset_sender_list.Destroy();
+    if (NULL != rx_quota_list)
     {
-        delete preset_sender;
-        preset_sender = NULL;
+        delete[] rx_quota_list;
+        rx_quota_list = NULL;
+        rx_quota_count = 0;
     }
+    SetRxMirror(NULL);
+    while (NULL != rx_mirror_head)
+        rx_mirror_head->SetRxMirror(NULL);
     Close();
+    SetRxDemux(NULL, ProtoAddress());
+    while (!rx_demux_tree.IsEmpty())
+    {
+        NormRxDemuxTree::Iterator iterator(rx_demux_tree);
+        NormSession& child = iterator.GetNextItem()->GetSession();
+        child.Close();  // (its tx_socket is our rx_socket)
+        child.SetRxDemux(NULL, ProtoAddress());
+    }
+    SetBufferPool(NULL);
+    for (unsigned int i = 1; i < tx_path_count; i++)
+        delete tx_path_list[i];
+    if (NULL != aead_buffer)
+    {
+        delete[] aead_buffer;
+        aead_buffer = NULL;
+    }
 }
 
+void NormSession::SetRxMirror(NormSession *primary)
+{
+    if (NULL != rx_mirror_primary)
+    {
+        NormSession *prev = NULL;
+        NormSession *next = rx_mirror_primary->rx_mirror_head;
+        while ((NULL != next) && (this != next))
+        {
+            prev = next;
+            next = next->rx_mirror_next;
+        }
+        if (NULL != next)
+        {
+            if (NULL != prev)
+                prev->rx_mirror_next = rx_mirror_next;
+            else
+                rx_mirror_primary->rx_mirror_head = rx_mirror_next;
+        }
+        rx_mirror_primary = rx_mirror_next = NULL;
+    }
+    if (NULL != primary)
+    {
+        rx_mirror_primary = primary;
+        rx_mirror_next = primary->rx_mirror_head;
+        primary->rx_mirror_head = this;
+    }
+} // end NormSession::SetRxMirror()
+
+bool NormSession::SetRxDemux(NormSession* listener, const ProtoAddress& remoteAddr)
+{
+    if ((NULL != listener) && (rx_socket.IsOpen() || tx_socket->IsOpen()))
+    {
+        PLOG(PL_ERROR, "NormSession::SetRxDemux() error: session already open\n");
+        return false;
+    }
+    if (NULL != rx_demux_listener)
+    {
+        rx_demux_listener->rx_demux_tree.Remove(*rx_demux_item);
+        delete rx_demux_item;
+        rx_demux_item = NULL;
+        if (&rx_demux_listener->rx_socket == tx_socket)
+            tx_socket = &tx_socket_actual;
+        rx_demux_listener = NULL;
+    }
+    if (NULL != listener)
+    {
+        if (!remoteAddr.IsValid() || remoteAddr.IsMulticast() || (listener == this))
+        {
+            PLOG(PL_ERROR, "NormSession::SetRxDemux() error: invalid listener or remote address\n");
+            return false;
+        }
+        if (NULL != listener->rx_demux_tree.FindItem(remoteAddr))
+        {
+            PLOG(PL_ERROR, "NormSession::SetRxDemux() error: remote address already demultiplexed\n");
+            return false;
+        }
+        if (NULL == (rx_demux_item = new NormRxDemuxItem(*this, remoteAddr)))
+        {
+            PLOG(PL_ERROR, "NormSession::SetRxDemux() new NormRxDemuxItem error: %s\n", GetErrorString());
+            return false;
+        }
+        listener->rx_demux_tree.Insert(*rx_demux_item);
+        rx_demux_listener = listener;
+        tx_socket = &listener->rx_socket;
+    }
+    return true;
+} // end NormSession::SetRxDemux()
+
+bool NormSession::SetEventCoalescing(NormController::Event event, unsigned int threshold, double interval)
+{
+    if (interval < 0.0) interval = 0.0;
+    switch (event)
+    {
+        case NormController::TX_QUEUE_VACANCY:
+            tx_vacancy_threshold = threshold;
+            tx_vacancy_interval = interval;
+            return true;
+        case NormController::RX_OBJECT_UPDATED:
+            rx_update_threshold = threshold;
+            rx_update_interval = interval;
+            return true;
+        default:
+            PLOG(PL_ERROR, "NormSession::SetEventCoalescing() error: unsupported event type\n");
+            return false;
+    }
+} // end NormSession::SetEventCoalescing()
+
+void NormSession::SetBufferPool(NormBufferPool* bufferPool)
+{
+    if (NULL != bufferPool) bufferPool->Retain();
+    if (NULL != buffer_pool) buffer_pool->Release();
+    buffer_pool = bufferPool;
+} // end NormSession::SetBufferPool()
+
+bool NormSession::CreateBufferPool(unsigned long bufferSpace, UINT16 segmentSize, 
+                                   UINT16 numData, UINT16 numParity)
+{
+    NormBufferPool* pool = new NormBufferPool();
+    if (NULL == pool)
+    {
+        PLOG(PL_FATAL, "NormSession::CreateBufferPool() new NormBufferPool error: %s\n", GetErrorString());
+        return false;
+    }
+    if (!pool->Init(bufferSpace, segmentSize, numData, numParity, 
+                    slab_mode, slab_huge_pages, slab_numa_node))
+    {
+        PLOG(PL_FATAL, "NormSession::CreateBufferPool() error: unable to init buffer pool\n");
+        pool->Release();
+        return false;
+    }
+    SetBufferPool(pool);
+    pool->Release();  // (now held by this session only)
+    return true;
+} // end NormSession::CreateBufferPool()
+
+bool NormSession::BindBufferPool(NormSegmentPool& segmentPool, NormBlockPool& blockPool,
+                                 UINT16 segmentSize, UINT16 blockSize) const
+{
+    if (NULL != buffer_pool)
+        return buffer_pool->Bind(segmentPool, blockPool, segmentSize, blockSize);
+    segmentPool.SetSharePool(NULL);
+    blockPool.SetSharePool(NULL);
+    return false;
+} // end NormSession::BindBufferPool()
+
 bool NormSession::Open()
 {
     ASSERT(address.IsValid());
+    if (rx_port_share && (NULL == rx_port) && (NULL == rx_demux_listener) && !tx_only)
+    {
+        const char* interfaceName = ('\0' != interface_name[0]) ? interface_name : NULL;
+        if (NULL == (rx_port = session_mgr.GetRxPort(address.GetPort(), interfaceName, address.GetType())))
+        {
+            PLOG(PL_FATAL, "NormSession::Open() error: unable to open shared rx port\n");
+            return false;
+        }
+        if (NULL == (rx_port_item = rx_port->Attach(*this)))
+        {
+            session_mgr.ReleaseRxPort(rx_port);
+            rx_port = NULL;
+            return false;
+        }
+    }
     if (!tx_socket->IsOpen())
     {
         // Make sure user wants a separate tx_socket
@@ -159,6 +428,7 @@ bool NormSession::Open()
             if (!tx_socket->Open(tx_port, address.GetType(), false))
             {
                 PLOG(PL_FATAL, "NormSession::Open() tx_socket::Open() error\n");
+                Close();
                 return false;
             }
             if (tx_port_reuse)
@@ -191,12 +461,14 @@ bool NormSession::Open()
         }
         else
         {
-            tx_socket = &rx_socket;
+            // (sending from the session port, so through the shared port if any)
+            tx_socket = (NULL != rx_port) ? &rx_port->AccessSocket() : &rx_socket;
         }
         tx_port = tx_socket->GetPort();
             
     }
-    if (!rx_socket.IsOpen() && (!tx_only || (&rx_socket == tx_socket)))
+    if (!rx_socket.IsOpen() && (NULL == rx_demux_listener) && (NULL == rx_port) &&
+        (!tx_only || (&rx_socket == tx_socket)))
     {
         if (!rx_socket.Open(0, address.GetType(), false))
         {
@@ -205,7 +477,7 @@ bool NormSession::Open()
             return false;
         }
         rx_socket.EnableRecvDstAddr();
-        if (rx_port_reuse)
+        if (rx_port_reuse || (rx_shard_count > 1))
         {
             // Enable port/addr reuse and bind socket to destination address
             if (!rx_socket.SetReuse(true))
@@ -214,6 +486,11 @@ bool NormSession::Open()
                 Close();
                 return false;
             }
+            if ((rx_shard_count > 1) && !EnableRxShard(false))
+            {
+                Close();
+                return false;
+            }
         }
         const ProtoAddress *bindAddr = NULL;
         if (rx_bind_addr.IsValid())
@@ -231,6 +508,11 @@ bool NormSession::Open()
             Close();
             return false;
         }
+        if ((rx_shard_count > 1) && !EnableRxShard(true))
+        {
+            Close();
+            return false;
+        }
         if (rx_connect_addr.IsValid() && (0 != rx_connect_addr.GetPort()))
         {
             // For unicast, we use the "connect()" call to effectively
@@ -252,6 +534,33 @@ bool NormSession::Open()
             PLOG(PL_WARN, "NormSession::Open() warning: tx_socket.SetEcnEnable() error\n");
         }
     }
+#ifdef NORM_TX_ZEROCOPY
+    if (tx_zero_copy) EnableTxZeroCopy();
+#endif // NORM_TX_ZEROCOPY
+#ifdef NORM_TX_TIME
+    if (tx_time_pacing) EnableTxTimePacing();
+#endif // NORM_TX_TIME
+    if (0 != busy_poll_usec)
+    {
+        if (rx_socket.IsOpen()) EnableBusyPoll(rx_socket);
+        if ((tx_socket != &rx_socket) && tx_socket->IsOpen()) EnableBusyPoll(*tx_socket);
+    }
+    if (rx_timestamps)
+    {
+        bool result = rx_socket.IsOpen() ? EnableRxTimestamps(rx_socket) : true;
+        if ((tx_socket != &rx_socket) && tx_socket->IsOpen()) 
+            result &= EnableRxTimestamps(*tx_socket);
+        if (!result)
+        {
+            PLOG(PL_WARN, "NormSession::Open() warning: receive timestamps not available\n");
+            rx_timestamps = false;
+        }
+    }
+    // Kernel rx socket drop counts (cumulative per socket, so reset here)
+    rx_drop_last = 0;
+    rx_drop_excuse = 0;
+    if (rx_socket.IsOpen()) EnableRxDropCount(rx_socket);
+    if (ecn_enabled && rx_socket.IsOpen()) EnableRxEcn(rx_socket);
 
     if (0 != tos)
     {
@@ -280,7 +589,7 @@ bool NormSession::Open()
         const char *interfaceName = NULL;
         if ('\0' != interface_name[0])
         {
-            bool result = tx_only ? true : rx_socket.SetMulticastInterface(interface_name);
+            bool result = (tx_only || (NULL != rx_port)) ? true : rx_socket.SetMulticastInterface(interface_name);
             result &= tx_socket->SetMulticastInterface(interface_name);
             if (!result)
             {
@@ -290,7 +599,7 @@ bool NormSession::Open()
             }
             interfaceName = interface_name;
         }
-        if (!tx_only)
+        if (!tx_only && (NULL == rx_port))  // (the shared port joins in NormRxPort::Attach())
         {
             if (!rx_socket.JoinGroup(address, interfaceName, ssm_source_addr.IsValid() ? &ssm_source_addr : NULL))
             {
@@ -300,6 +609,14 @@ bool NormSession::Open()
             }
         }
     }
+    for (unsigned int i = 1; i < tx_path_count; i++)
+    {
+        if (!OpenTxPath(*tx_path_list[i]))
+        {
+            Close();
+            return false;
+        }
+    }
 
 #ifdef ECN_SUPPORT
     // TBD - do this via UDP socket recvmsg() instead of raw packet capture
@@ -323,6 +640,36 @@ bool NormSession::Open()
         }
     }
 #endif // ECN_SUPPORT
+#ifdef NORM_XDP
+    if ('\0' != xdp_interface[0])
+    {
+        if (!OpenXdpSocket())
+        {
+            PLOG(PL_FATAL, "NormSession::Open() error: unable to open AF_XDP socket!\n");
+            Close();
+            return false;
+        }
+        if (tx_only)
+        {
+            xdp_socket->StopInputNotification();
+        }
+        else
+        {
+            // Disable rx_socket (keep open so mcast JOIN holds)
+            rx_socket.StopInputNotification();
+#ifdef ECN_SUPPORT
+            if (NULL != proto_cap)
+                proto_cap->StopInputNotification();
+#endif // ECN_SUPPORT
+        }
+    }
+#endif // NORM_XDP
+    if (!rx_msg.SetBufferSize(NormMsg::MAX_SIZE))
+    {
+        PLOG(PL_FATAL, "NormSession::Open() error: unable to allocate receive buffer\n");
+        Close();
+        return false;
+    }
     if (message_pool.IsEmpty())
     {
         for (unsigned int i = 0; i < DEFAULT_MESSAGE_POOL_DEPTH; i++)
@@ -358,10 +705,33 @@ void NormSession::Close()
         tx_timer.Deactivate();
     message_queue.Destroy();
     message_pool.Destroy();
-    if (tx_socket->IsOpen())
+    if (!tx_batch.IsEmpty() && tx_socket->IsOpen())
+        tx_batch.Flush(*tx_socket);
+    tx_batch.Init(tx_batch.GetSize());  // discards anything left unsent
+    tx_zero_copy_sock = tx_zero_copy_reap = false;
+    tx_time_sock = false;
+    if (tx_socket->IsOpen() && (NULL == rx_demux_listener) && 
+        ((NULL == rx_port) || (&rx_port->AccessSocket() != tx_socket)))
         tx_socket->Close();
+    if (NULL != rx_port)
+    {
+        if (&rx_port->AccessSocket() == tx_socket)
+            tx_socket = &tx_socket_actual;
+        rx_port->Detach(rx_port_item);
+        rx_port_item = NULL;
+        session_mgr.ReleaseRxPort(rx_port);
+        rx_port = NULL;
+    }
+    for (unsigned int i = 1; i < tx_path_count; i++)
+    {
+        if (tx_path_list[i]->socket.IsOpen())
+            tx_path_list[i]->socket.Close();
+    }
     if (rx_socket.IsOpen())
     {
+        while (rx_layer_top > 0)
+            LeaveRxLayer(rx_layer_top);
+        rx_layer_time = 0.0;
         if (address.IsMulticast())
         {
             const char *interfaceName = ('\0' != interface_name[0]) ? interface_name : NULL;
@@ -372,8 +742,48 @@ void NormSession::Close()
 #ifdef ECN_SUPPORT
     CloseProtoCap();
 #endif // ECN_SUPPORT
+#ifdef NORM_XDP
+    CloseXdpSocket();
+#endif // NORM_XDP
 } // end NormSession::Close()
 
+// Populates "dst_addr_list" with the potential valid dst addrs for this
+// host (used to filter raw packets from ProtoCap or AF_XDP)
+bool NormSession::InitDstAddrList()
+{
+    dst_addr_list.Destroy();
+    if (rx_bind_addr.IsValid())
+    {
+        if (!dst_addr_list.Insert(rx_bind_addr))
+        {
+            PLOG(PL_FATAL, "NormSession::InitDstAddrList() error: unable to add rx_bind_addr to dst_addr_list!!\n");
+            return false;
+        }
+    }
+    else
+    {
+        // Put all local unicast addrs in list
+        if (!ProtoSocket::GetHostAddressList(ProtoAddress::IPv4, dst_addr_list))
+            PLOG(PL_WARN, "NormSession::InitDstAddrList() warning: incomplete IPv4 host address list\n");
+        if (!ProtoSocket::GetHostAddressList(ProtoAddress::IPv6, dst_addr_list))
+            PLOG(PL_WARN, "NormSession::InitDstAddrList() warning: incomplete IPv6 host address list\n");
+    }
+    if (address.IsMulticast() && !address.HostIsEqual(rx_bind_addr))
+    {
+        if (!dst_addr_list.Insert(address))
+        {
+            PLOG(PL_FATAL, "NormSession::InitDstAddrList() error: unable to add session addr to dst_addr_list!!\n");
+            return false;
+        }
+    }
+    if (dst_addr_list.IsEmpty())
+    {
+        PLOG(PL_FATAL, "NormSession::InitDstAddrList() error: unable to add any addresses to dst_addr_list!!\n");
+        return false;
+    }
+    return true;
+} // end NormSession::InitDstAddrList()
+
 #ifdef ECN_SUPPORT
 bool NormSession::OpenProtoCap()
 {
@@ -392,31 +802,8 @@ bool NormSession::OpenProtoCap()
             return false;
         }
         // Populate "dst_addr_list" with potential valid dst addrs for this host
-        dst_addr_list.Destroy();
-        if (rx_bind_addr.IsValid())
-        {
-            if (!dst_addr_list.Insert(rx_bind_addr))
-            {
-                PLOG(PL_FATAL, "NormSession::OpenProtoCap() error: unable to add rx_bind_addr to dst_addr_list!!\n");
-                return false;
-            }
-        }
-        else
-        {
-            // Put all local unicast addrs in list
-            if (!ProtoSocket::GetHostAddressList(ProtoAddress::IPv4, dst_addr_list))
-                PLOG(PL_WARN, "NormSession::OpenProtoCap() warning: incomplete IPv4 host address list\n");
-            if (!ProtoSocket::GetHostAddressList(ProtoAddress::IPv6, dst_addr_list))
-                PLOG(PL_WARN, "NormSession::OpenProtoCap() warning: incomplete IPv6 host address list\n");
-        }
-        if (address.IsMulticast() && !address.HostIsEqual(rx_bind_addr))
-        {
-            if (!dst_addr_list.Insert(address))
-            {
-                PLOG(PL_FATAL, "NormSession::OpenProtoCap() error: unable to add session addr to dst_addr_list!!\n");
-                return false;
-            }
-        }
+        if (!InitDstAddrList())
+            return false;
         
         // Get the interface source address for pcap message transmission
         if (!ProtoNet::GetInterfaceAddress(proto_cap->GetInterfaceIndex(),
@@ -425,12 +812,6 @@ bool NormSession::OpenProtoCap()
         {
             PLOG(PL_WARN, "NormSession::OpenProtoCap() warning: unable to get interface source address\n");
         }
-        
-        if (dst_addr_list.IsEmpty())
-        {
-            PLOG(PL_FATAL, "NormSession::OpenProtoCap() error: unable to add any addresses to dst_addr_list!!\n");
-            return false;
-        }
     }
     return true;
 }  // end NormSession::OpenProtoCap()
@@ -467,6 +848,348 @@ bool NormSession::SetMulticastInterface(const char *interfaceName)
     }
 } // end NormSession::SetMulticastInterface()
 
+bool NormSession::AddTxPath(const char* interfaceName, const char* srcAddr, double weight)
+{
+    if (tx_path_count >= TX_PATH_MAX)
+    {
+        PLOG(PL_ERROR, "NormSession::AddTxPath() error: maximum of %u paths\n", (unsigned int)TX_PATH_MAX);
+        return false;
+    }
+    if (weight < 0.0)
+    {
+        PLOG(PL_ERROR, "NormSession::AddTxPath() error: invalid weight\n");
+        return false;
+    }
+    TxPath* path = new TxPath;
+    if (NULL == path)
+    {
+        PLOG(PL_ERROR, "NormSession::AddTxPath() new TxPath error: %s\n", GetErrorString());
+        return false;
+    }
+    if (NULL != interfaceName)
+    {
+        strncpy(path->iface_name, interfaceName, IFACE_NAME_MAX);
+        path->iface_name[IFACE_NAME_MAX] = '\0';
+    }
+    if ((NULL != srcAddr) && !path->src_addr.ResolveFromString(srcAddr))
+    {
+        PLOG(PL_ERROR, "NormSession::AddTxPath() error: invalid source address \"%s\"\n", srcAddr);
+        delete path;
+        return false;
+    }
+    if (tx_socket->IsOpen() && !OpenTxPath(*path))
+    {
+        delete path;
+        return false;
+    }
+    tx_path_list[tx_path_count] = path;
+    tx_path_weight[tx_path_count] = weight;
+    tx_path_credit[tx_path_count] = 0.0;
+    tx_path_count++;
+    return true;
+} // end NormSession::AddTxPath()
+
+bool NormSession::SetTxPathWeight(unsigned int pathIndex, double weight)
+{
+    if ((pathIndex >= tx_path_count) || (weight < 0.0))
+    {
+        PLOG(PL_ERROR, "NormSession::SetTxPathWeight() error: invalid path index or weight\n");
+        return false;
+    }
+    tx_path_weight[pathIndex] = weight;
+    for (unsigned int i = 0; i < tx_path_count; i++)
+        tx_path_credit[i] = 0.0;  // (restart the round-robin cycle)
+    return true;
+} // end NormSession::SetTxPathWeight()
+
+// Opens a path socket configured like the tx_socket (sends only, since
+// receivers keep addressing feedback to the session tx_socket)
+bool NormSession::OpenTxPath(TxPath& path)
+{
+    if (!path.socket.Open(0, address.GetType(), false))
+    {
+        PLOG(PL_FATAL, "NormSession::OpenTxPath() socket open error\n");
+        return false;
+    }
+    if (!path.socket.Bind(0, path.src_addr.IsValid() ? &path.src_addr : NULL))
+    {
+        PLOG(PL_FATAL, "NormSession::OpenTxPath() socket bind error\n");
+        path.socket.Close();
+        return false;
+    }
+    if (0 != tos)
+    {
+        if (!path.socket.SetTOS(tos))
+            PLOG(PL_WARN, "NormSession::OpenTxPath() warning: SetTOS() error\n");
+    }
+    if (!path.socket.SetFragmentation(fragmentation))
+        PLOG(PL_WARN, "NormSession::OpenTxPath() warning: SetFragmentation() error\n");
+    if (address.IsMulticast())
+    {
+        if (!path.socket.SetTTL(ttl) || !path.socket.SetLoopback(mcast_loopback) ||
+            (('\0' != path.iface_name[0]) && !path.socket.SetMulticastInterface(path.iface_name)))
+        {
+            PLOG(PL_FATAL, "NormSession::OpenTxPath() multicast socket option error\n");
+            path.socket.Close();
+            return false;
+        }
+    }
+    return true;
+} // end NormSession::OpenTxPath()
+
+// Smooth weighted round-robin (each path's share of picks follows its weight,
+// spread evenly through the cycle instead of in bursts)
+unsigned int NormSession::SelectTxPath()
+{
+    double totalWeight = 0.0;
+    unsigned int pathIndex = 0;
+    for (unsigned int i = 0; i < tx_path_count; i++)
+    {
+        if ((0 != i) && !tx_path_list[i]->socket.IsOpen()) continue;
+        tx_path_credit[i] += tx_path_weight[i];
+        totalWeight += tx_path_weight[i];
+        if (tx_path_credit[i] > tx_path_credit[pathIndex])
+            pathIndex = i;
+    }
+    tx_path_credit[pathIndex] -= totalWeight;
+    return pathIndex;
+} // end NormSession::SelectTxPath()
+
+bool NormSession::AddTxLayer(const char* groupAddr, double weight)
+{
+    if (tx_layer_count >= LAYER_MAX)
+    {
+        PLOG(PL_ERROR, "NormSession::AddTxLayer() error: maximum of %u layers\n", (unsigned int)LAYER_MAX);
+        return false;
+    }
+    ProtoAddress groupAddress;
+    if ((NULL == groupAddr) || !groupAddress.ResolveFromString(groupAddr) || !groupAddress.IsMulticast() ||
+        !address.IsMulticast() || (weight <= 0.0))
+    {
+        PLOG(PL_ERROR, "NormSession::AddTxLayer() error: invalid layer group or weight\n");
+        return false;
+    }
+    groupAddress.SetPort(address.GetPort());
+    tx_layer_addr[tx_layer_count] = groupAddress;
+    tx_layer_weight[tx_layer_count] = weight;
+    tx_layer_seq[tx_layer_count] = 0;
+    tx_layer_count++;
+    tx_layer_scale = 0.0;
+    for (unsigned int i = 0; i < tx_layer_count; i++)
+    {
+        tx_layer_scale += tx_layer_weight[i];
+        tx_layer_credit[i] = 0.0;  // (restart the round-robin cycle)
+    }
+    return true;
+} // end NormSession::AddTxLayer()
+
+// (the same smooth weighted round-robin as SelectTxPath())
+unsigned int NormSession::SelectTxLayer()
+{
+    unsigned int layer = 0;
+    for (unsigned int i = 0; i < tx_layer_count; i++)
+    {
+        tx_layer_credit[i] += tx_layer_weight[i];
+        if (tx_layer_credit[i] > tx_layer_credit[layer])
+            layer = i;
+    }
+    tx_layer_credit[layer] -= tx_layer_scale;
+    return layer;
+} // end NormSession::SelectTxLayer()
+
+// True if the DATA message is from a tx block being repaired (by the
+// sender's own block state since the message flags aren't authoritative)
+bool NormSession::SenderMsgIsRepair(const NormDataMsg& data)
+{
+    NormObject* obj = tx_table.Find(data.GetObjectId());
+    if (NULL == obj) return false;
+    NormBlock* block = obj->FindBlock(data.GetFecBlockId(fec_m));
+    return ((NULL != block) && block->InRepair());
+} // end NormSession::SenderMsgIsRepair()
+
+bool NormSession::AddRxLayer(const char* groupAddr)
+{
+    if (rx_layer_count >= LAYER_MAX)
+    {
+        PLOG(PL_ERROR, "NormSession::AddRxLayer() error: maximum of %u layers\n", (unsigned int)LAYER_MAX);
+        return false;
+    }
+    if (rx_port_share)
+    {
+        PLOG(PL_ERROR, "NormSession::AddRxLayer() error: not supported with a shared rx port\n");
+        return false;
+    }
+    ProtoAddress groupAddress;
+    if ((NULL == groupAddr) || !groupAddress.ResolveFromString(groupAddr) || 
+        !groupAddress.IsMulticast() || !address.IsMulticast())
+    {
+        PLOG(PL_ERROR, "NormSession::AddRxLayer() error: invalid layer group\n");
+        return false;
+    }
+    groupAddress.SetPort(address.GetPort());
+    RxLayer& layer = rx_layer_list[rx_layer_count++];
+    layer.addr = groupAddress;
+    layer.join_backoff = RX_LAYER_BACKOFF_MIN;
+    layer.join_time = 0.0;  // (may be joined at the next decision)
+    return true;
+} // end NormSession::AddRxLayer()
+
+bool NormSession::JoinRxLayer(unsigned int index)
+{
+    ASSERT((index > 0) && (index < rx_layer_count));
+    const char* interfaceName = ('\0' != interface_name[0]) ? interface_name : NULL;
+    RxLayer& layer = rx_layer_list[index];
+    if (!rx_socket.JoinGroup(layer.addr, interfaceName, ssm_source_addr.IsValid() ? &ssm_source_addr : NULL))
+    {
+        PLOG(PL_ERROR, "NormSession::JoinRxLayer() rx_socket.JoinGroup error\n");
+        return false;
+    }
+    layer.seq_valid = false;
+    layer.recv_count = layer.lost_count = 0;
+    rx_layer_top = index;
+    PLOG(PL_DEBUG, "NormSession::JoinRxLayer() node>%lu joined layer %u\n", (unsigned long)LocalNodeId(), index);
+    return true;
+} // end NormSession::JoinRxLayer()
+
+void NormSession::LeaveRxLayer(unsigned int index)
+{
+    ASSERT((index > 0) && (index == rx_layer_top));
+    const char* interfaceName = ('\0' != interface_name[0]) ? interface_name : NULL;
+    RxLayer& layer = rx_layer_list[index];
+    rx_socket.LeaveGroup(layer.addr, interfaceName, ssm_source_addr.IsValid() ? &ssm_source_addr : NULL);
+    rx_layer_top = index - 1;
+    PLOG(PL_DEBUG, "NormSession::LeaveRxLayer() node>%lu left layer %u\n", (unsigned long)LocalNodeId(), index);
+} // end NormSession::LeaveRxLayer()
+
+// Returns the layer (by destination group) of a received sender message,
+// tracking each joined layer's loss from its sequence numbers and making
+// the periodic join/leave decision.  (Per-layer sequence tracking assumes
+// one sender per layered session.)
+unsigned int NormSession::RxLayerUpdate(const NormMsg& msg, const struct timeval& currentTime)
+{
+    unsigned int index = 0;
+    const ProtoAddress& dstAddr = msg.GetDestination();
+    if (dstAddr.IsValid())
+    {
+        for (unsigned int i = 1; i <= rx_layer_top; i++)
+        {
+            if (dstAddr.HostIsEqual(rx_layer_list[i].addr))
+            {
+                index = i;
+                break;
+            }
+        }
+    }
+    RxLayer& layer = rx_layer_list[index];
+    UINT16 seq = msg.GetSequence();
+    if (layer.seq_valid)
+    {
+        INT16 delta = (INT16)(seq - layer.seq_next);
+        if (delta >= 0)
+        {
+            layer.lost_count += (UINT32)delta;
+            layer.seq_next = seq + 1;
+        }
+    }
+    else
+    {
+        layer.seq_next = seq + 1;
+        layer.seq_valid = true;
+    }
+    layer.recv_count++;
+    
+    double now = ProtoTime(currentTime).GetValue();
+    if (0.0 == rx_layer_time)
+    {
+        rx_layer_time = now;
+    }
+    else if ((now - rx_layer_time) >= RX_LAYER_INTERVAL)
+    {
+        UINT32 recvCount = 0, lostCount = 0;
+        for (unsigned int i = 0; i <= rx_layer_top; i++)
+        {
+            recvCount += rx_layer_list[i].recv_count;
+            lostCount += rx_layer_list[i].lost_count;
+            rx_layer_list[i].recv_count = rx_layer_list[i].lost_count = 0;
+        }
+        double loss = (0 != recvCount) ? ((double)lostCount / (double)(recvCount + lostCount)) : 0.0;
+        if ((loss > RX_LAYER_LOSS_HIGH) && (rx_layer_top > 0))
+        {
+            // Leave the top layer and hold off rejoining it (for longer each time)
+            RxLayer& top = rx_layer_list[rx_layer_top];
+            top.join_time = now + top.join_backoff;
+            top.join_backoff *= 2.0;
+            if (top.join_backoff > RX_LAYER_BACKOFF_MAX) top.join_backoff = RX_LAYER_BACKOFF_MAX;
+            LeaveRxLayer(rx_layer_top);
+        }
+        else if ((loss < RX_LAYER_LOSS_LOW) && ((rx_layer_top + 1) < rx_layer_count) &&
+                 (now >= rx_layer_list[rx_layer_top + 1].join_time))
+        {
+            JoinRxLayer(rx_layer_top + 1);
+        }
+        rx_layer_time = now;
+    }
+    return index;
+} // end NormSession::RxLayerUpdate()
+
+bool NormSession::SetXdpInterface(const char *interfaceName, unsigned int queueId)
+{
+#ifdef NORM_XDP
+    if (IsOpen())
+    {
+        PLOG(PL_ERROR, "NormSession::SetXdpInterface() error: session already open\n");
+        return false;
+    }
+    if (NULL != interfaceName)
+    {
+        strncpy(xdp_interface, interfaceName, IFACE_NAME_MAX);
+        xdp_interface[IFACE_NAME_MAX] = '\0';
+        xdp_queue = queueId;
+    }
+    else
+    {
+        xdp_interface[0] = '\0';
+    }
+    return true;
+#else
+    PLOG(PL_ERROR, "NormSession::SetXdpInterface() error: AF_XDP support not built (HAVE_LIBXDP)\n");
+    return false;
+#endif // if/else NORM_XDP
+} // end NormSession::SetXdpInterface()
+
+bool NormSession::SetFileIoWorkerCount(unsigned int count)
+{
+    if (IsOpen())
+    {
+        PLOG(PL_ERROR, "NormSession::SetFileIoWorkerCount() error: session already open\n");
+        return false;
+    }
+    return file_io.Init(count);
+} // end NormSession::SetFileIoWorkerCount()
+
+bool NormSession::SetRxFileJournal(const char* dirPath)
+{
+    if (NULL == dirPath)
+    {
+        rx_journal_dir[0] = '\0';
+        return true;
+    }
+    // (leave room for a trailing PROTO_PATH_DELIMITER and the journal file names)
+    size_t len = strlen(dirPath);
+    if ((0 == len) || ((len + 64) > PATH_MAX))
+    {
+        PLOG(PL_ERROR, "NormSession::SetRxFileJournal() error: invalid directory path\n");
+        return false;
+    }
+    strcpy(rx_journal_dir, dirPath);
+    if (PROTO_PATH_DELIMITER != rx_journal_dir[len - 1])
+    {
+        rx_journal_dir[len++] = PROTO_PATH_DELIMITER;
+        rx_journal_dir[len] = '\0';
+    }
+    return true;
+}  // end NormSession::SetRxFileJournal()
+
 bool NormSession::SetSSM(const char *sourceAddress)
 {
     if (NULL != sourceAddress)
@@ -527,6 +1250,46 @@ bool NormSession::SetRxPortReuse(bool enableReuse,
     return result;
 } // end NormSession::SetRxPortReuse()
 
+bool NormSession::SetRxPortShare(bool enable)
+{
+    if (IsOpen())
+    {
+        PLOG(PL_ERROR, "NormSession::SetRxPortShare() error: session already open\n");
+        return false;
+    }
+    rx_port_share = enable;
+    return true;
+} // end NormSession::SetRxPortShare()
+
+// This must be called _before_ the receiver is started
+bool NormSession::SetRxShard(unsigned int shardIndex, unsigned int shardCount)
+{
+    if (rx_socket.IsOpen())
+    {
+        PLOG(PL_ERROR, "NormSession::SetRxShard() error: rx_socket already open\n");
+        return false;
+    }
+    if (shardCount <= 1)
+    {
+        rx_shard_index = rx_shard_count = 0;
+        return true;
+    }
+    if (shardIndex >= shardCount)
+    {
+        PLOG(PL_ERROR, "NormSession::SetRxShard() error: invalid shard index %u (count:%u)\n",
+                       shardIndex, shardCount);
+        return false;
+    }
+#if defined(__linux__) && !defined(SIMULATE) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    rx_shard_index = shardIndex;
+    rx_shard_count = shardCount;
+    return true;
+#else
+    PLOG(PL_ERROR, "NormSession::SetRxShard() error: receive sharding not supported\n");
+    return false;
+#endif // if/else __linux__ && !SIMULATE && SO_ATTACH_REUSEPORT_CBPF
+} // end NormSession::SetRxShard()
+
 bool NormSession::SetTxPort(UINT16 txPort, bool enableReuse, const char *txAddress)
 {
     tx_port = txPort;
@@ -587,6 +1350,10 @@ void NormSession::SetTxOnly(bool txOnly, bool connectToSessionAddress)
             if (NULL != proto_cap)
                 proto_cap->StopInputNotification();
 #endif // ECN_SUPPORT
+#ifdef NORM_XDP
+            if (NULL != xdp_socket)
+                xdp_socket->StopInputNotification();
+#endif // NORM_XDP
         }
         // We connect tx_only session sockets when tx port
         // reuse is set _and_ it is a unicast session
@@ -697,6 +1464,7 @@ void NormSession::SetTxRateInternal(double txRate)
                 Notify(NormController::GRTT_UPDATED, (NormSenderNode *)NULL, (NormObject *)NULL);
             }
         }
+        if (auto_tune) SenderAutoTune();
         // wakeup grtt/cc probing if necessary
         if (probe_reset)
         {
@@ -762,7 +1530,16 @@ bool NormSession::StartSender(UINT16 instanceId,
                               UINT8  fecId)
 {
     UINT16 blockSize = numData + numParity;
-    if (blockSize <= 255)
+    if ((segmentSize > NORM_SEGMENT_SIZE_MAX) || ((numData + numParity) > NORM_BLOCK_SIZE_MAX))
+    {
+        PLOG(PL_FATAL, "NormSession::StartSender() error: segment size or FEC block size exceeds build limit (%u, %u)\n",
+             (unsigned int)NORM_SEGMENT_SIZE_MAX, (unsigned int)NORM_BLOCK_SIZE_MAX);
+        return false;
+    }
+    // A non-zero fec_id = 129 instance id selects a registered large
+    // block code (e.g., LDPC) instead of Reed-Solomon
+    if ((129 != fecId) || (0 == numParity)) fec_instance_id = 0;
+    if ((blockSize <= 255) || (0 != fec_instance_id))
         fec_m = 8;
     else
         fec_m = 16;
@@ -782,19 +1559,20 @@ bool NormSession::StartSender(UINT16 instanceId,
         if (!Open())
             return false;
     }
-    if (!tx_table.Init(tx_cache_count_max))
+    if (!tx_table.Init(TxTableRangeMax()))
     {
         PLOG(PL_FATAL, "NormSession::StartSender() tx_table.Init() error!\n");
         StopSender();
         return false;
     }
-    if (!tx_pending_mask.Init(tx_cache_count_max, 0x0000ffff))
+    if (!tx_pending_mask.Init(TxTableRangeMax(), 0x0000ffff))
     {
         PLOG(PL_FATAL, "NormSession::StartSender() tx_pending_mask.Init() error!\n");
         StopSender();
         return false;
     }
-    if (!tx_repair_mask.Init(tx_cache_count_max, 0x0000ffff))
+    tx_pending_cached = false;
+    if (!tx_repair_mask.Init(TxTableRangeMax(), 0x0000ffff))
     {
         PLOG(PL_FATAL, "NormSession::StartSender() tx_repair_mask.Init() error!\n");
         StopSender();
@@ -802,12 +1580,7 @@ bool NormSession::StartSender(UINT16 instanceId,
     }
 
     // Calculate how much memory each buffered block will require
-    unsigned long maskSize = blockSize >> 3;
-    if (0 != (blockSize & 0x07))
-        maskSize++;
-    unsigned long blockSpace = sizeof(NormBlock) +
-                               blockSize * sizeof(char *) +
-                               2 * maskSize +
+    unsigned long blockSpace = NormBlockPool::GetBlockSpace(blockSize) +
                                numParity * (segmentSize + NormDataMsg::GetStreamPayloadHeaderLength());
 
     unsigned long numBlocks = bufferSpace / blockSpace;
@@ -817,6 +1590,8 @@ bool NormSession::StartSender(UINT16 instanceId,
         numBlocks = 2;
     unsigned long numSegments = numBlocks * numParity;
 
+    SetPoolSlabMode(segment_pool, block_pool);
+    BindBufferPool(segment_pool, block_pool, segmentSize, blockSize);
     if (!block_pool.Init((UINT32)numBlocks, blockSize))
     {
         PLOG(PL_FATAL, "NormSession::StartSender() block_pool init error\n");
@@ -830,55 +1605,53 @@ bool NormSession::StartSender(UINT16 instanceId,
         StopSender();
         return false;
     }
+    if (memory_prefault) segment_pool.Prefault();
 
     if (numParity)
     {
         if (NULL != encoder)
+        {
             delete encoder;
+            encoder = NULL;
+        }
 
-        if (blockSize <= 255)
+        if (0 != fec_instance_id)
         {
-#ifdef ASSUME_MDP_FEC
-            if (NULL == (encoder = new NormEncoderMDP))
-            {
-                PLOG(PL_FATAL, "NormSession::StartSender() new NormEncoderMDP error: %s\n", GetErrorString());
-                StopSender();
-                return false;
-            }
             fec_id = 129;
             fec_m = 8;
+        }
+        else if (blockSize <= 255)
+        {
+#ifdef ASSUME_MDP_FEC
+            fec_id = 129;
 #else
-            if (NULL == (encoder = new NormEncoderRS8))
-            {
-                PLOG(PL_FATAL, "NormSession::StartSender() new NormEncoderRS8 error: %s\n", GetErrorString());
-                StopSender();
-                return false;
-            }
             if (0 != fecId)
                 fec_id = fecId;
             else
                 fec_id = 5;
-            fec_m = 8;
 #endif
+            fec_m = 8;
         }
         else //if (blockSize <= 65535)
         {
-            if (NULL == (encoder = new NormEncoderRS16))
-            {
-                PLOG(PL_FATAL, "NormSession::StartSender() new NormEncoderRS16 error: %s\n", GetErrorString());
-                StopSender();
-                return false;
-            }
             // TBD - Investigate if fec_id == 129 can also support 16-bit Reed Solomon
             fec_id = 2;
             fec_m = 16;
         }
-        /*else
+        if (!NormFecRegistry::IsRegistered(fec_id, fec_m, fec_instance_id))
         {
-            PLOG(PL_FATAL, "NormSession::StartSender() error: invalid FEC block size\n");
+            PLOG(PL_FATAL, "NormSession::StartSender() error: unsupported fecId>%d m>%d instanceId>%hu\n",
+                           (int)fec_id, (int)fec_m, fec_instance_id);
             StopSender();
             return false;
-        }*/
+        }
+        if (NULL == (encoder = NormFecRegistry::CreateEncoder(fec_id, fec_m, fec_instance_id)))
+        {
+            PLOG(PL_FATAL, "NormSession::StartSender() new %s encoder error: %s\n",
+                           NormFecRegistry::GetName(fec_id, fec_m, fec_instance_id), GetErrorString());
+            StopSender();
+            return false;
+        }
 
         if (!encoder->Init(numData, numParity, segmentSize + NormDataMsg::GetStreamPayloadHeaderLength()))
         {
@@ -886,6 +1659,33 @@ bool NormSession::StartSender(UINT16 instanceId,
             StopSender();
             return false;
         }
+        
+        // Scratch vectors used to encode an entire block at once (see
+        // NormObject::CalculateBlockParity()).  If these can't be allocated,
+        // parity is computed one segment at a time instead.
+        unsigned int vectorSize = segmentSize + NormDataMsg::GetStreamPayloadHeaderLength() + 1;
+        if ((NULL == (tx_encode_buffer = new char[(unsigned long)numData * vectorSize])) ||
+            (NULL == (tx_encode_list = new char*[numData])))
+        {
+            PLOG(PL_WARN, "NormSession::StartSender() warning: unable to allocate block encode buffer: %s\n", GetErrorString());
+            if (NULL != tx_encode_buffer)
+            {
+                delete[] tx_encode_buffer;
+                tx_encode_buffer = NULL;
+            }
+        }
+        else
+        {
+            for (UINT16 i = 0; i < numData; i++)
+                tx_encode_list[i] = tx_encode_buffer + ((unsigned long)i * vectorSize);
+        }
+        
+        if ((0 != tx_fec_worker_count) &&
+            !tx_fec_pool.Init(NormFecWorkerPool::ENCODE, tx_fec_worker_count, fec_id, fec_m, fec_instance_id, numData, numParity, 
+                              segmentSize + NormDataMsg::GetStreamPayloadHeaderLength()))
+        {
+            PLOG(PL_WARN, "NormSession::StartSender() warning: unable to start FEC worker threads, encoding inline\n");
+        }
     }
     else
     {
@@ -915,6 +1715,9 @@ bool NormSession::StartSender(UINT16 instanceId,
     data_active = false;
     ndata = numData;
     nparity = numParity;
+    if (auto_parity > nparity) auto_parity = nparity;
+    adapt_block_count = 0;
+    memset(adapt_loss_hist, 0, sizeof(adapt_loss_hist));
     is_sender = true;
 
     flush_count = (GetTxRobustFactor() < 0) ? 0 : (GetTxRobustFactor() + 1);
@@ -969,6 +1772,7 @@ void NormSession::StopSender()
         repair_timer.Deactivate();
         tx_repair_pending = false;
     }
+    SenderClearNackDigests();
     if (flush_timer.IsActive())
         flush_timer.Deactivate();
     if (cmd_timer.IsActive())
@@ -990,12 +1794,23 @@ void NormSession::StopSender()
         cmd_length = 0;
     }
 
+    tx_fec_pool.Destroy();  // (finishes any pending parity jobs)
     if (NULL != encoder)
     {
         encoder->Destroy();
         delete encoder;
         encoder = NULL;
     }
+    if (NULL != tx_encode_list)
+    {
+        delete[] tx_encode_list;
+        tx_encode_list = NULL;
+    }
+    if (NULL != tx_encode_buffer)
+    {
+        delete[] tx_encode_buffer;
+        tx_encode_buffer = NULL;
+    }
     acking_node_tree.Destroy();
     cc_node_list.Destroy();
     // Iterate tx_table and release objects
@@ -1007,12 +1822,15 @@ void NormSession::StopSender()
         obj->Close();
         obj->Release();
     }
+    tx_spill_count = 0;
+    tx_spill_size = NormObjectSize(0);
     // Then destroy table
     tx_table.Destroy();  // I think this is redundant with above tx_table iteration
     block_pool.Destroy();
     segment_pool.Destroy();
     tx_repair_mask.Destroy();
     tx_pending_mask.Destroy();
+    tx_pending_cached = false;
     is_sender = false;
     if (!IsReceiver())
         Close();
@@ -1022,7 +1840,8 @@ bool NormSession::StartReceiver(unsigned long bufferSize)
 {
     //if (tx_only) return false;
     tx_only = false;
-    if (!rx_socket.IsOpen())
+    // (a demultiplexed session receives via its listener's rx_socket)
+    if (!rx_socket.IsOpen() && ((NULL == rx_demux_listener) || !tx_socket->IsOpen()))
     {
         if (!Open())
             return false;
@@ -1067,20 +1886,124 @@ void NormSession::DeleteRemoteSender(NormSenderNode &senderNode)
     senderNode.Release();
 } // end NormSession::DeleteRemoteSender()
 
-bool NormSession::PreallocateRemoteSender(unsigned int bufferSpace,
-                                          UINT16 segmentSize,
-                                          UINT16 numData,
-                                          UINT16 numParity,
-                                          unsigned int streamBufferSize)
+bool NormSession::PreallocateRemoteSenders(unsigned int count,
+                                           unsigned int bufferSpace,
+                                           UINT16 segmentSize,
+                                           UINT16 numData,
+                                           UINT16 numParity,
+                                           unsigned int streamBufferSize)
+{
+    preset_sender_list.Destroy();
+    for (unsigned int i = 0; i < count; i++)
+    {
+        NormSenderNode* presetSender = new NormSenderNode(*this, NORM_NODE_ANY);
+        if (NULL == presetSender)
+        {
+            PLOG(PL_ERROR, "NormSession::PreallocateRemoteSenders() new NormSenderNode error: %s\n", GetErrorString());
+            return false;
+        }
+        if (!PresetRemoteSender(*presetSender, bufferSpace, segmentSize, numData, numParity, streamBufferSize))
+        {
+            presetSender->Release();
+            return false;
+        }
+        preset_sender_list.Append(presetSender);  // (list now owns "presetSender")
+    }
+    return true;
+} // end NormSession::PreallocateRemoteSenders()
+
+// Pops the next preallocated remote sender (if any).  Preset senders are
+// built with the session defaults, so senders with quotas don't get one.
+NormSenderNode* NormSession::GetPresetSender(NormNodeId senderId)
+{
+    unsigned long bufferSpace;
+    UINT16 cacheMax;
+    if (ReceiverGetSenderQuota(senderId, bufferSpace, cacheMax)) return NULL;
+    NormSenderNode* presetSender = (NormSenderNode*)preset_sender_list.Head();
+    if (NULL != presetSender)
+        preset_sender_list.Remove(presetSender);  // (ownership passes to caller)
+    return presetSender;
+}  // end NormSession::GetPresetSender()
+
+bool NormSession::ReceiverSetSenderQuota(NormNodeId      senderId,
+                                         NormNodeId      idMask,
+                                         unsigned long   bufferSpace,
+                                         UINT16          cacheMax)
+{
+    if (cacheMax > 0x7fff) cacheMax = 0x7fff;
+    senderId &= idMask;
+    for (unsigned int i = 0; i < rx_quota_count; i++)
+    {
+        RxQuota& quota = rx_quota_list[i];
+        if ((quota.sender_id != senderId) || (quota.id_mask != idMask)) continue;
+        if ((0 == bufferSpace) && (0 == cacheMax))
+        {
+            // (removes the quota)
+            rx_quota_list[i] = rx_quota_list[--rx_quota_count];
+        }
+        else
+        {
+            quota.buffer_space = bufferSpace;
+            quota.cache_max = cacheMax;
+        }
+        return true;
+    }
+    if ((0 == bufferSpace) && (0 == cacheMax)) return true;
+    RxQuota* newList = new RxQuota[rx_quota_count + 1];
+    if (NULL == newList)
+    {
+        PLOG(PL_ERROR, "NormSession::ReceiverSetSenderQuota() new quota list error: %s\n", GetErrorString());
+        return false;
+    }
+    for (unsigned int i = 0; i < rx_quota_count; i++)
+        newList[i] = rx_quota_list[i];
+    if (NULL != rx_quota_list) delete[] rx_quota_list;
+    rx_quota_list = newList;
+    RxQuota& quota = rx_quota_list[rx_quota_count++];
+    quota.sender_id = senderId;
+    quota.id_mask = idMask;
+    quota.buffer_space = bufferSpace;
+    quota.cache_max = cacheMax;
+    return true;
+} // end NormSession::ReceiverSetSenderQuota()
+
+bool NormSession::ReceiverGetSenderQuota(NormNodeId      senderId,
+                                         unsigned long&  bufferSpace,
+                                         UINT16&         cacheMax) const
+{
+    bufferSpace = remote_sender_buffer_size;
+    cacheMax = rx_cache_count_max;
+    const RxQuota* match = NULL;
+    unsigned int matchBits = 0;
+    for (unsigned int i = 0; i < rx_quota_count; i++)
+    {
+        const RxQuota& quota = rx_quota_list[i];
+        if ((senderId & quota.id_mask) != quota.sender_id) continue;
+        unsigned int maskBits = 0;
+        for (NormNodeId mask = quota.id_mask; 0 != mask; mask >>= 1)
+            maskBits += (mask & 0x01);
+        if ((NULL == match) || (maskBits > matchBits))
+        {
+            match = &quota;
+            matchBits = maskBits;
+        }
+    }
+    if (NULL == match) return false;
+    if (0 != match->buffer_space) bufferSpace = match->buffer_space;
+    if (0 != match->cache_max) cacheMax = match->cache_max;
+    return true;
+} // end NormSession::ReceiverGetSenderQuota()
+
+bool NormSession::PresetRemoteSender(NormSenderNode& presetSender,
+                                     unsigned int    bufferSpace,
+                                     UINT16          segmentSize,
+                                     UINT16          numData,
+                                     UINT16          numParity,
+                                     unsigned int    streamBufferSize)
 {
-    if (NULL != preset_sender)
-        delete preset_sender;
-    preset_sender = new NormSenderNode(*this, NORM_NODE_ANY);
-    if (!preset_sender->Open(0))
+    if (!presetSender.Open(0))
     {
         PLOG(PL_ERROR, "NormSession::PreallocateRemoteSender() error: NormSenderNode::Open() failure!\n");
-        delete preset_sender;
-        preset_sender = NULL;
         return false;
     }
     UINT16 blockSize = numData + numParity;
@@ -1095,25 +2018,22 @@ bool NormSession::PreallocateRemoteSender(unsigned int bufferSpace,
     {
         fecId = 5;
     }
-    if (!preset_sender->AllocateBuffers(bufferSpace, fecId, 0, fecM, segmentSize, numData, numParity))
+    if (!presetSender.AllocateBuffers(bufferSpace, fecId, 0, fecM, segmentSize, numData, numParity))
     {
         PLOG(PL_ERROR, "NormSession::PreallocateRemoteSender() error: buffer allocation failure!\n");
-        delete preset_sender;
-        preset_sender = NULL;
         return false;
     }
     if (0 != streamBufferSize)
     {
-        if (!preset_sender->PreallocateRxStream(streamBufferSize, segmentSize, numData, numParity))
+        if (!presetSender.PreallocateRxStream(streamBufferSize, segmentSize, numData, numParity))
         {
             PLOG(PL_ERROR, "NormSession::PreallocateRemoteSender() error: preset_stream allocation failure!\n");
-            delete preset_sender;
-            preset_sender = NULL;
             return false;
         }
     }
+    if (memory_prefault) presetSender.Prefault();
     return true;
-} // end NormSession::PreallocateRemoteSender()
+} // end NormSession::PresetRemoteSender()
 
 bool NormSession::SetPresetFtiData(unsigned int objectSize,
                                    UINT16 segmentSize,
@@ -1258,6 +2178,13 @@ void NormSession::Serve()
             // The sender tx position is > watermark
             if (SenderQueueWatermarkFlush())
             {
+                if (tx_window_enable && !tx_window_marked)
+                {
+                    // Data sent so far is what this watermark's ACKs will cover
+                    tx_window_mark = tx_window_sent;
+                    tx_window_mark_time.GetCurrentTime();
+                    tx_window_marked = true;
+                }
                 watermark_active = true;
                 return;
             }
@@ -1282,9 +2209,15 @@ void NormSession::Serve()
                 if (!watermark_pending)
                 {
                     // watermark flush just completed
-                    if (watermark_flushes)
-                        flush_count = GetTxRobustFactor();
-                    watermarkJustCompleted = true;
+                    bool autoMark = tx_window_auto;
+                    if (tx_window_enable)
+                        SenderUpdateWindow(ACK_SUCCESS == SenderGetAckingStatus(NORM_NODE_ANY));
+                    if (!autoMark)
+                    {
+                        if (watermark_flushes)
+                            flush_count = GetTxRobustFactor();
+                        watermarkJustCompleted = true;
+                    }
                 }
             }
         }
@@ -1304,8 +2237,32 @@ void NormSession::Serve()
         }
     } // end if (watermark_pending && !flush_timer.IsActive())
 
+    // (the window check below applies to the object that would send)
+    if ((NULL != obj) && tx_weighted)
+    {
+        NormObject *firstObj = obj;
+        obj = SenderGetWeightedObject(firstObj);
+        // A window-blocked turn still lets the lowest pending object send its
+        // repairs so the watermark covering them can be acknowledged
+        if ((obj != firstObj) && tx_window_enable && SenderWindowBlocks(*obj) &&
+            !SenderWindowBlocks(*firstObj))
+            obj = firstObj;
+    }
+
+    if ((NULL != obj) && tx_window_enable && SenderWindowBlocks(*obj))
+    {
+        // Hold new data until a watermark ACK opens the window.  The
+        // flush_timer prompts us again to check watermark status.
+        tx_window_limited = true;
+        if (!watermark_pending)
+            SenderSetWindowMark();
+        return;
+    }
+
     if (NULL != obj)
     {
+        if (tx_fec_pool.IsActive())
+            SenderReapParity();
         NormObjectMsg *msg = (NormObjectMsg *)GetMessageFromPool();
         if (msg)
         {
@@ -1329,8 +2286,40 @@ void NormSession::Serve()
                 msg->SetGrtt(grtt_quantized);
                 msg->SetBackoffFactor((unsigned char)backoff_factor);
                 msg->SetGroupSize(gsize_quantized);
+                if (tx_window_enable)
+                {
+                    tx_window_sent += msg->GetLength();
+                    NormBlockId blockId = 0;
+                    NormSegmentId segmentId = 0;
+                    if (NormMsg::DATA == msg->GetType())
+                    {
+                        blockId = static_cast<NormDataMsg *>(msg)->GetFecBlockId(fec_m);
+                        segmentId = static_cast<NormDataMsg *>(msg)->GetFecSymbolId(fec_m);
+                    }
+                    if ((msg->GetObjectId() != tx_window_object_id) ?
+                        (msg->GetObjectId() > tx_window_object_id) :
+                        ((Compare(blockId, tx_window_block_id) > 0) ||
+                         ((blockId == tx_window_block_id) && (segmentId > tx_window_segment_id))))
+                    {
+                        tx_window_object_id = msg->GetObjectId();
+                        tx_window_block_id = blockId;
+                        tx_window_segment_id = segmentId;
+                    }
+                }
                 QueueMessage(msg);
                 flush_count = 0;
+                if (obj->LatencyPending())
+                    tx_latency.Record(obj->GetLatency());
+                if (tx_weighted)
+                {
+                    if ((0 != tx_drr_credit) && (obj->GetId() == tx_drr_object_id))
+                        tx_drr_credit--;
+                    tx_drr_skips = 0;
+                }
+                // Mark the data sent for ACK once half the window is in flight
+                if (tx_window_enable && !watermark_pending &&
+                    ((double)(tx_window_sent - tx_window_acked) >= (0.5 * tx_window)))
+                    SenderSetWindowMark();
                 // (TBD) ??? should streams every allowed to be non-pending?
                 //       we _could_ re-architect streams a little bit and allow
                 //       for this by having NormStreamObject::Write() control
@@ -1340,7 +2329,7 @@ void NormSession::Serve()
                 //        state as calls to NormStreamObject::Write() are made.
                 if (!obj->IsPending() && !obj->IsStream())
                 {
-                    tx_pending_mask.Unset(obj->GetId());
+                    SenderUnsetPending(obj->GetId());
                     if (!tx_pending_mask.IsSet() && !posted_tx_queue_empty)
                     {
                         // Tell the app we would like to send more data ...
@@ -1353,13 +2342,21 @@ void NormSession::Serve()
             else
             {
                 ReturnMessageToPool(msg);
+                if (tx_weighted)
+                {
+                    // Pass the turn on since another pending object may have
+                    // something to send (until each has had a turn)
+                    tx_drr_credit = 0;
+                    if (++tx_drr_skips < tx_table.GetCount())
+                        PromptSender();
+                }
                 if (obj->IsStream())
                 {
                     NormStreamObject *stream = static_cast<NormStreamObject *>(obj);
                     if (stream->IsFlushPending() || stream->IsClosing())
                     {
                         // Queue flush message
-                        if (!flush_timer.IsActive())
+                        if (!SenderFlushHeld())
                         {
                             if ((GetTxRobustFactor() < 0) || (flush_count < GetTxRobustFactor()))
                             {
@@ -1448,7 +2445,10 @@ bool NormSession::SenderSetWatermark(NormObjectId objectId,
 {
     PLOG(PL_DEBUG, "NormSession::SenderSetWatermark() watermark>%hu:%lu:%hu\n",
          (UINT16)objectId, (unsigned long)blockId.GetValue(), (UINT16)segmentId);
+    SenderClearWatermarkPipeline();
     watermark_flushes = overrideFlush;
+    tx_window_auto = false;
+    tx_window_marked = false;
     watermark_pending = true;
     watermark_active = false;
     watermark_object_id = objectId;
@@ -1519,9 +2519,328 @@ void NormSession::SenderResetWatermark()
 
 void NormSession::SenderCancelWatermark()
 {
+    SenderClearWatermarkPipeline();
     watermark_pending = false;
 } // end NormSession::SenderCancelWatermark()
 
+bool NormSession::SenderAddWatermark(NormObjectId objectId,
+                                     NormBlockId blockId,
+                                     NormSegmentId segmentId,
+                                     bool overrideFlush)
+{
+    // (as with SenderSetWatermark() without "appAckReq", no app-defined
+    //  ACK request content is sent for added watermarks)
+    if (!watermark_pending)
+        return SenderSetWatermark(objectId, blockId, segmentId, overrideFlush);
+    if (watermark_pipeline_count >= WATERMARK_PIPELINE_MAX)
+    {
+        PLOG(PL_WARN, "NormSession::SenderAddWatermark() warning: too many watermarks pending\n");
+        return false;
+    }
+    PLOG(PL_DEBUG, "NormSession::SenderAddWatermark() watermark>%hu:%lu:%hu (%u pending)\n",
+         (UINT16)objectId, (unsigned long)blockId.GetValue(), (UINT16)segmentId,
+         watermark_pipeline_count + 1);
+    // The pending watermark moves into the pipeline, keeping the ACKs
+    // collected so far, and acking nodes are reset for the new one
+    unsigned int slot = (watermark_pipeline_head + watermark_pipeline_count) % WATERMARK_PIPELINE_MAX;
+    PipelinedWatermark &older = watermark_pipeline[slot];
+    older.object_id = watermark_object_id;
+    older.block_id = watermark_block_id;
+    older.segment_id = watermark_segment_id;
+    watermark_pipeline_count++;
+    NormNodeTreeIterator iterator(acking_node_tree);
+    NormAckingNode *next;
+    int robustFactor = GetTxRobustFactor();
+    while (NULL != (next = static_cast<NormAckingNode *>(iterator.GetNextNode())))
+    {
+        if (next->AckReceived())
+            next->MarkPipelineAck(slot);
+        else
+            next->ClearPipelineAck(slot);
+        next->Reset(robustFactor);
+    }
+    watermark_flushes = overrideFlush;
+    tx_window_auto = false;
+    tx_window_marked = false;
+    watermark_active = false;
+    watermark_object_id = objectId;
+    watermark_block_id = blockId;
+    watermark_segment_id = segmentId;
+    acking_success_count = 0;
+    if (NULL != ack_ex_buffer)
+    {
+        delete[] ack_ex_buffer;
+        ack_ex_buffer = NULL;
+        ack_ex_length = 0;
+    }
+    // (ACKs for the older watermark may have completed it already)
+    SenderCheckWatermarkPipeline();
+    PromptSender();
+    return true;
+} // end NormSession::SenderAddWatermark()
+
+// Posts TX_WATERMARK_COMPLETED, oldest first, for pipelined watermarks all
+// acking nodes have acknowledged.  (Pipelined watermarks only complete
+// upon success, a failure is reported with the newest watermark)
+void NormSession::SenderCheckWatermarkPipeline()
+{
+    while (0 != watermark_pipeline_count)
+    {
+        unsigned int slot = watermark_pipeline_head;
+        NormNodeTreeIterator iterator(acking_node_tree);
+        NormAckingNode *next;
+        while (NULL != (next = static_cast<NormAckingNode *>(iterator.GetNextNode())))
+        {
+            if ((NORM_NODE_NONE != next->GetId()) && !next->PipelineAckReceived(slot))
+                return;
+        }
+        iterator.Reset();
+        while (NULL != (next = static_cast<NormAckingNode *>(iterator.GetNextNode())))
+            next->ClearPipelineAck(slot);
+        watermark_pipeline_head = (slot + 1) % WATERMARK_PIPELINE_MAX;
+        watermark_pipeline_count--;
+        PLOG(PL_DEBUG, "NormSession::SenderCheckWatermarkPipeline() node>%lu pipelined watermark>%hu:%lu:%hu ack finished.\n",
+             (unsigned long)LocalNodeId(), (UINT16)watermark_pipeline[slot].object_id,
+             (unsigned long)watermark_pipeline[slot].block_id.GetValue(),
+             (UINT16)watermark_pipeline[slot].segment_id);
+        Notify(NormController::TX_WATERMARK_COMPLETED, (NormSenderNode *)NULL,
+               tx_table.Find(watermark_pipeline[slot].object_id));
+    }
+} // end NormSession::SenderCheckWatermarkPipeline()
+
+void NormSession::SenderClearWatermarkPipeline()
+{
+    if (0 == watermark_pipeline_count)
+        return;
+    NormNodeTreeIterator iterator(acking_node_tree);
+    NormAckingNode *next;
+    while (NULL != (next = static_cast<NormAckingNode *>(iterator.GetNextNode())))
+        next->ClearPipelineAcks();
+    watermark_pipeline_head = watermark_pipeline_count = 0;
+} // end NormSession::SenderClearWatermarkPipeline()
+
+// Weighted round robin (a deficit round robin with one segment per
+// message) over the pending objects in object id order.  The object whose
+// turn it is keeps it until it has sent its weight in messages.
+NormObject *NormSession::SenderGetWeightedObject(NormObject *firstObj)
+{
+    if ((0 != tx_drr_credit) && tx_pending_mask.Test(tx_drr_object_id))
+    {
+        NormObject *obj = tx_table.Find(tx_drr_object_id);
+        if (NULL != obj)
+            return obj;
+    }
+    // The turn passes to the next pending object, wrapping around to the first
+    NormObject *obj = NULL;
+    if (tx_drr_object_id >= firstObj->GetId())
+    {
+        UINT32 index = (UINT16)(tx_drr_object_id + 1);
+        if (tx_pending_mask.GetNextSet(index))
+            obj = tx_table.Find((UINT16)index);
+    }
+    if (NULL == obj)
+        obj = firstObj;
+    tx_drr_object_id = obj->GetId();
+    tx_drr_credit = obj->GetTxWeight();
+    return obj;
+} // end NormSession::SenderGetWeightedObject()
+
+void NormSession::SetTxWindow(bool state)
+{
+    tx_window_enable = state;
+    if (state)
+    {
+        // Start from the bandwidth*delay of the current tx rate and GRTT
+        tx_window = MAX(GetTxWindowMin(), TX_WINDOW_GAIN * tx_rate * grtt_advertised);
+        tx_window_acked = tx_window_sent;
+        tx_window_marked = false;
+        tx_window_ack_time.GetCurrentTime();
+        tx_window_cycle_min = -1.0;
+        tx_window_limited = false;
+    }
+    if (IsSender())
+        PromptSender();
+} // end NormSession::SetTxWindow()
+
+// True if the window is full and the next message "obj" would send is new
+// data, not a repair of data already sent (repairs must get through so the
+// watermark covering them can be acknowledged)
+bool NormSession::SenderWindowBlocks(NormObject &obj)
+{
+    if (NULL == acking_node_tree.GetRoot())
+        return false;  // no ACKs to open the window
+    if (watermark_pending && !tx_window_auto && !watermark_active)
+        return false;  // app watermark needs data sent to be reached
+    if ((double)(tx_window_sent - tx_window_acked) < tx_window)
+        return false;
+    NormBlockId blockId = 0;
+    NormSegmentId segmentId = 0;
+    if (obj.IsPending())
+    {
+        if (obj.GetFirstPending(blockId))
+        {
+            NormBlock *block = obj.FindBlock(blockId);
+            if (NULL != block)
+                block->GetFirstPending(segmentId);
+        }
+    }
+    else if (obj.IsStream())
+    {
+        blockId = static_cast<NormStreamObject &>(obj).GetNextBlockId();
+        segmentId = static_cast<NormStreamObject &>(obj).GetNextSegmentId();
+    }
+    if (obj.GetId() != tx_window_object_id)
+        return (obj.GetId() > tx_window_object_id);
+    int delta = Compare(blockId, tx_window_block_id);
+    if (0 != delta)
+        return (delta > 0);
+    return (segmentId > tx_window_segment_id);
+} // end NormSession::SenderWindowBlocks()
+
+// Sets a watermark at the last new data sent so its ACK can move the window
+void NormSession::SenderSetWindowMark()
+{
+    if ((NULL == acking_node_tree.GetRoot()) || (0 == tx_window_sent))
+        return;
+    PLOG(PL_DEBUG, "NormSession::SenderSetWindowMark() window:%lf inFlight:%lu\n",
+         tx_window, (unsigned long)(tx_window_sent - tx_window_acked));
+    if (SenderSetWatermark(tx_window_object_id, tx_window_block_id, tx_window_segment_id))
+    {
+        tx_window_auto = true;
+        tx_window_mark = tx_window_sent;
+        tx_window_mark_time.GetCurrentTime();
+        tx_window_marked = true;
+    }
+} // end NormSession::SenderSetWindowMark()
+
+// Called when a watermark ACK completes.  The rate sample is the data newly
+// covered by ACK over the time since the previous ACK completed and the
+// window is sized to TX_WINDOW_GAIN times that rate and the minimum ACK
+// cycle (mark reached to ACK complete) time.  If the window held data back
+// and the cycle shows no queueing, the window is grown to probe for more
+// bandwidth.  An ACK failure halves the window.
+void NormSession::SenderUpdateWindow(bool success)
+{
+    ProtoTime currentTime;
+    currentTime.GetCurrentTime();
+    if (!tx_window_marked)
+    {
+        tx_window_mark = tx_window_sent;
+        tx_window_mark_time = currentTime;
+    }
+    double cycle = ProtoTime::Delta(currentTime, tx_window_mark_time);
+    double interval = ProtoTime::Delta(currentTime, tx_window_ack_time);
+    double acked = (double)(tx_window_mark - tx_window_acked);
+    tx_window_acked = tx_window_mark;
+    tx_window_ack_time = currentTime;
+    double window = tx_window;
+    if (!success)
+    {
+        window = 0.5 * tx_window;
+    }
+    else if (tx_window_marked && (cycle > 0.0) && (interval > 0.0))
+    {
+        if ((tx_window_cycle_min < 0.0) || (cycle < tx_window_cycle_min) ||
+            (ProtoTime::Delta(currentTime, tx_window_cycle_time) > TX_WINDOW_CYCLE_AGE))
+        {
+            tx_window_cycle_min = cycle;
+            tx_window_cycle_time = currentTime;
+        }
+        double bdp = TX_WINDOW_GAIN * (acked / interval) * tx_window_cycle_min;
+        if (tx_window_limited)
+        {
+            // (a window limited rate sample is the window, not the path,
+            //  so only probe if the cycle time shows no standing queue)
+            if (cycle < (TX_WINDOW_QUEUE_FACTOR * tx_window_cycle_min))
+                window = MAX(bdp, TX_WINDOW_PROBE * tx_window);
+            else
+                window = bdp;
+        }
+        else
+        {
+            // (app limited rate samples only ever grow the window)
+            window = MAX(bdp, tx_window);
+        }
+    }
+    double windowMax = (double)tx_cache_size_max.GetOffset();
+    if (window > windowMax) window = windowMax;
+    tx_window = MAX(window, GetTxWindowMin());
+    tx_window_marked = false;
+    tx_window_auto = false;
+    tx_window_limited = false;
+    PLOG(PL_DEBUG, "NormSession::SenderUpdateWindow() success:%d cycle:%lf window:%lf\n",
+         success, cycle, tx_window);
+} // end NormSession::SenderUpdateWindow()
+
+void NormSession::SetAutoTune(bool enable)
+{
+    auto_tune = enable;
+    if (enable)
+    {
+        SenderAutoTune();
+    }
+    else
+    {
+        // Restore the configured tx cache bound (socket buffers are left as tuned)
+        tx_cache_size_max = tx_cache_size_base;
+    }
+} // end NormSession::SetAutoTune()
+
+// Socket buffers are sized to AUTO_TUNE_SOCK_FACTOR times the bandwidth-delay
+// product, rounded up to a power of two (so small estimate changes don't cause
+// resizing) within the AUTO_TUNE_SOCK_MIN/MAX bounds and no smaller than the
+// configured "sizeMin"
+unsigned int NormSession::AutoTuneSocketSize(double bdp, unsigned int sizeMin)
+{
+    double target = AUTO_TUNE_SOCK_FACTOR * bdp;
+    unsigned int size = AUTO_TUNE_SOCK_MIN;
+    while ((size < AUTO_TUNE_SOCK_MAX) && ((double)size < target))
+        size <<= 1;
+    return ((size > sizeMin) ? size : sizeMin);
+} // end NormSession::AutoTuneSocketSize()
+
+// Called as the tx_rate or grtt_advertised change.  The tx socket buffer is
+// grown right away and only shrunk when the new size is a quarter or less of
+// the current one.  The tx cache size bound follows the BDP (with excess
+// objects trimmed as new ones are enqueued).
+void NormSession::SenderAutoTune()
+{
+    if (!auto_tune || !IsSender() || (tx_rate <= 0.0)) return;
+    double bdp = tx_rate * grtt_advertised;
+    NormObjectSize cacheSize((NormObjectSize::Offset)(AUTO_TUNE_CACHE_FACTOR * bdp));
+    tx_cache_size_max = (cacheSize > tx_cache_size_base) ? cacheSize : tx_cache_size_base;
+    if (tx_socket->IsOpen())
+    {
+        unsigned int size = AutoTuneSocketSize(bdp, tx_sock_buffer_base);
+        if ((size > tx_sock_buffer_tuned) || (size <= (tx_sock_buffer_tuned >> 2)))
+        {
+            if (tx_socket->SetTxBufferSize(size))
+                PLOG(PL_DEBUG, "NormSession::SenderAutoTune() node>%lu tx socket buffer %u bytes (bdp:%lf)\n",
+                     (unsigned long)LocalNodeId(), size, bdp);
+            else
+                PLOG(PL_WARN, "NormSession::SenderAutoTune() warning: unable to set tx socket buffer to %u bytes\n", size);
+            tx_sock_buffer_tuned = size;  // (so we don't keep retrying)
+        }
+    }
+} // end NormSession::SenderAutoTune()
+
+// Called by NormSenderNode::UpdateRecvRate() with its measured rate times grtt.
+// Since the rx socket is shared by all remote senders, it is only grown.
+void NormSession::ReceiverAutoTune(double bdp)
+{
+    if (!auto_tune || !rx_socket.IsOpen()) return;
+    unsigned int size = AutoTuneSocketSize(bdp, rx_sock_buffer_base);
+    if (size > rx_sock_buffer_tuned)
+    {
+        if (rx_socket.SetRxBufferSize(size))
+            PLOG(PL_DEBUG, "NormSession::ReceiverAutoTune() node>%lu rx socket buffer %u bytes (bdp:%lf)\n",
+                 (unsigned long)LocalNodeId(), size, bdp);
+        else
+            PLOG(PL_WARN, "NormSession::ReceiverAutoTune() warning: unable to set rx socket buffer to %u bytes\n", size);
+        rx_sock_buffer_tuned = size;  // (so we don't keep retrying)
+    }
+} // end NormSession::ReceiverAutoTune()
+
 NormAckingNode *NormSession::SenderAddAckingNode(NormNodeId nodeId, const ProtoAddress *srcAddress)
 {
     NormAckingNode *theNode = static_cast<NormAckingNode *>(acking_node_tree.FindNodeById(nodeId));
@@ -1563,6 +2882,41 @@ void NormSession::SenderRemoveAckingNode(NormNodeId nodeId)
     }
 } // end NormSession::RemoveAckingNode()
 
+bool NormSession::SenderSetAckingNodeAggregator(NormNodeId nodeId, NormNodeId aggregatorId)
+{
+    NormAckingNode *theNode =
+        static_cast<NormAckingNode *>(acking_node_tree.FindNodeById(nodeId));
+    if (NULL == theNode)
+    {
+        PLOG(PL_ERROR, "NormSession::SenderSetAckingNodeAggregator() error: node>%lu is not an acking node\n",
+             (unsigned long)nodeId);
+        return false;
+    }
+    if ((NORM_NODE_NONE == aggregatorId) || (nodeId == aggregatorId))
+    {
+        theNode->SetAggregatorId(NORM_NODE_NONE);
+        return true;
+    }
+    if ((NORM_NODE_ANY == aggregatorId) || (NORM_NODE_NONE == nodeId))
+    {
+        PLOG(PL_ERROR, "NormSession::SenderSetAckingNodeAggregator() error: invalid node id\n");
+        return false;
+    }
+    // The aggregator is an acking node itself
+    NormAckingNode *aggregator =
+        static_cast<NormAckingNode *>(acking_node_tree.FindNodeById(aggregatorId));
+    if ((NULL == aggregator) && (NULL == (aggregator = SenderAddAckingNode(aggregatorId))))
+        return false;
+    if (aggregator->IsAggregated())
+    {
+        PLOG(PL_ERROR, "NormSession::SenderSetAckingNodeAggregator() error: aggregator>%lu has an aggregator itself\n",
+             (unsigned long)aggregatorId);
+        return false;
+    }
+    theNode->SetAggregatorId(aggregatorId);
+    return true;
+} // end NormSession::SenderSetAckingNodeAggregator()
+
 NormSession::AckingStatus NormSession::SenderGetAckingStatus(NormNodeId nodeId)
 {
     if (NORM_NODE_ANY == nodeId)
@@ -1693,6 +3047,8 @@ bool NormSession::SenderQueueWatermarkFlush()
         watermark_pending = false;
         NormAckingNode *nodeNone = NULL;
         acking_success_count = 0;
+        // (the serial keeps an aggregator from being listed more than once)
+        watermark_flush_serial++;
         while (NULL != (next = static_cast<NormAckingNode *>(iterator.GetNextNode())))
         {
             // Save NORM_NODE_NONE for last
@@ -1710,9 +3066,25 @@ bool NormSession::SenderQueueWatermarkFlush()
             }
             else if (next->IsPending())
             {
-                // Add node to list
-                if (flush->AppendAckingNode(next->GetId(), segment_size))
+                // Aggregated nodes are requested via their aggregator, except on
+                // their last attempt (in case the aggregator isn't responding)
+                NormAckingNode *target = next;
+                if (next->IsAggregated() && (next->GetReqCount() > 1))
+                {
+                    NormAckingNode *aggregator =
+                        static_cast<NormAckingNode *>(acking_node_tree.FindNodeById(next->GetAggregatorId()));
+                    if (NULL != aggregator) target = aggregator;
+                }
+                if (watermark_flush_serial == target->GetFlushSerial())
+                {
+                    // (already listed)
+                    next->DecrementReqCount();
+                    watermark_pending = true;
+                }
+                else if (flush->AppendAckingNode(target->GetId(), segment_size))
                 {
+                    // Add node to list
+                    target->SetFlushSerial(watermark_flush_serial);
                     next->DecrementReqCount();
                     watermark_pending = true;
                 }
@@ -1752,7 +3124,11 @@ bool NormSession::SenderQueueWatermarkFlush()
             ReturnMessageToPool(flush);
             PLOG(PL_DEBUG, "NormSession::ServeQueueWatermarkFlush() node>%lu watermark ack finished.\n",
                  (unsigned long)LocalNodeId());
-            Notify(NormController::TX_WATERMARK_COMPLETED, (NormSenderNode *)NULL, (NormObject *)NULL);
+            // (any older pipelined watermark not acknowledged by now failed)
+            SenderCheckWatermarkPipeline();
+            SenderClearWatermarkPipeline();
+            if (!tx_window_auto)
+                Notify(NormController::TX_WATERMARK_COMPLETED, (NormSenderNode *)NULL, (NormObject *)NULL);
             return false;
         }
         else
@@ -1776,8 +3152,10 @@ bool NormSession::SenderQueueWatermarkFlush()
 void NormSession::SenderQueueFlush()
 {
     // (TBD) Don't enqueue a new flush if there is already one in our tx_queue!
-    if (flush_timer.IsActive())
+    if (SenderFlushHeld())
         return;
+    if (flush_timer.IsActive())
+        flush_timer.Deactivate();  // (early flush, see SetTxFlushPiggyback())
     NormObject *obj = tx_table.Find(tx_table.RangeHi());
     NormObjectId objectId;
     NormBlockId blockId;
@@ -1856,6 +3234,17 @@ bool NormSession::OnFlushTimeout(ProtoTimer & /*theTimer*/)
     return false;
 } // NormSession::OnFlushTimeout()
 
+NormMsg *NormSession::GetMessageFromPool(unsigned int payloadMax)
+{
+    NormMsg *msg = message_pool.RemoveHead();
+    if ((NULL != msg) && !msg->SetBufferSize(NormMsg::ComputeBufferSize(payloadMax)))
+    {
+        message_pool.Prepend(msg);
+        return NULL;
+    }
+    return msg;
+} // end NormSession::GetMessageFromPool()
+
 void NormSession::QueueMessage(NormMsg *msg)
 {
 
@@ -1930,13 +3319,48 @@ NormDataObject *NormSession::QueueTxData(const char* dataPtr,
     NormDataObject *obj = new NormDataObject(*this, (NormSenderNode *)NULL, next_tx_object_id, session_mgr.GetDataFreeFunction());
     if (!obj)
     {
-        PLOG(PL_FATAL, "NormSession::QueueTxData() new data object error: %s\n",
+        PLOG(PL_FATAL, "NormSession::QueueTxData() new data object error: %s\n",
+             GetErrorString());
+        return NULL;
+    }
+    if (!obj->Open((char *)dataPtr, dataLen, false, infoPtr, infoLen))
+    {
+        PLOG(PL_FATAL, "NormSession::QueueTxData() object open error\n");
+        obj->Release();
+        return NULL;
+    }
+    if (QueueTxObject(obj))
+    {
+        return obj;
+    }
+    else
+    {
+        obj->Close();
+        obj->Release();
+        return NULL;
+    }
+} // end NormSession::QueueTxData()
+
+NormDataObject *NormSession::QueueTxDataV(const NormDataObject::Vector* vecList,
+                                          unsigned int                  vecCount,
+                                          const char*                   infoPtr,
+                                          UINT16                        infoLen)
+{
+    if (!IsSender())
+    {
+        PLOG(PL_FATAL, "NormSession::QueueTxDataV() Error: sender is closed\n");
+        return NULL;
+    }
+    NormDataObject *obj = new NormDataObject(*this, (NormSenderNode *)NULL, next_tx_object_id, session_mgr.GetDataFreeFunction());
+    if (!obj)
+    {
+        PLOG(PL_FATAL, "NormSession::QueueTxDataV() new data object error: %s\n",
              GetErrorString());
         return NULL;
     }
-    if (!obj->Open((char *)dataPtr, dataLen, false, infoPtr, infoLen))
+    if (!obj->OpenV(vecList, vecCount, infoPtr, infoLen))
     {
-        PLOG(PL_FATAL, "NormSession::QueueTxData() object open error\n");
+        PLOG(PL_FATAL, "NormSession::QueueTxDataV() object open error\n");
         obj->Release();
         return NULL;
     }
@@ -1950,7 +3374,7 @@ NormDataObject *NormSession::QueueTxData(const char* dataPtr,
         obj->Release();
         return NULL;
     }
-} // end NormSession::QueueTxData()
+} // end NormSession::QueueTxDataV()
 
 NormStreamObject *NormSession::QueueTxStream(UINT32      bufferSize,
                                              bool        doubleBuffer,
@@ -1962,6 +3386,17 @@ NormStreamObject *NormSession::QueueTxStream(UINT32      bufferSize,
         PLOG(PL_FATAL, "NormSession::QueueTxStream() Error: sender is closed\n");
         return NULL;
     }
+    if ((0 == bufferSize) && auto_tune)
+    {
+        // Size the stream buffer from the current bandwidth-delay product
+        // (a stream buffer can't be resized once open)
+        double bdp = AUTO_TUNE_CACHE_FACTOR * tx_rate * grtt_advertised;
+        double bufferMin = GetTxWindowMin();
+        if (bdp < bufferMin) bdp = bufferMin;
+        bufferSize = (bdp < (double)AUTO_TUNE_SOCK_MAX) ? (UINT32)bdp : (UINT32)AUTO_TUNE_SOCK_MAX;
+        PLOG(PL_DEBUG, "NormSession::QueueTxStream() auto-tuned stream buffer size %lu bytes\n",
+             (unsigned long)bufferSize);
+    }
     NormStreamObject *stream = new NormStreamObject(*this, (NormSenderNode *)NULL, next_tx_object_id);
     if (!stream)
     {
@@ -2047,15 +3482,21 @@ bool NormSession::QueueTxObject(NormObject *obj)
     //      i.e., ((count > count_min) && ((count > count_max) || (size > size_max))), or
     // 2) When the "tx_table" state (from insert/remove history) doesn't allow
     //      i.e., !tx_table.CanInsert(obj)
+    //
+    // (The count_max and size_max bounds apply to the objects held in memory,
+    //  i.e. not counting those moved to the spill tier, see SetTxCacheSpill())
     unsigned long newCount = tx_table.GetCount() + 1;
     while (!tx_table.CanInsert(obj->GetId()) ||
            ((newCount > tx_cache_count_min) &&
-            ((newCount > tx_cache_count_max) ||
-             ((tx_table.GetSize() + obj->GetSize()) > tx_cache_size_max))))
+            (((newCount - tx_spill_count) > tx_cache_count_max) ||
+             ((tx_table.GetSize() - tx_spill_size + obj->GetSize()) > tx_cache_size_max))))
     {
-        // Remove oldest non-pending
+        // Spill the oldest in-memory object if possible ...
+        if (tx_table.CanInsert(obj->GetId()) && SenderSpillTxObject())
+            continue;
+        // ... else remove oldest non-pending
         NormObject *oldest = tx_table.Find(tx_table.RangeLo());
-        if (oldest->IsRepairPending() || oldest->IsPending())
+        if (oldest->IsRepairPending() || oldest->IsPending() || !oldest->RelayIsComplete())
         {
             PLOG(PL_DEBUG, "NormSession::QueueTxObject() all held objects repair pending:%d (repair active:%d) pending:%d\n",
                  oldest->IsRepairPending(), repair_timer.IsActive(), oldest->IsPending());
@@ -2089,13 +3530,73 @@ bool NormSession::QueueTxObject(NormObject *obj)
         ASSERT(0);
         return false;
     }
-    tx_pending_mask.Set(obj->GetId());
+    obj->SetTxWeight(tx_weight_default);
+    if (latency_stats) obj->MarkLatencyTime();
+    SenderSetPending(obj->GetId());
     ASSERT(tx_pending_mask.Test(obj->GetId()));
     next_tx_object_id++;
     TouchSender();
     return true;
 } // end NormSession::QueueTxObject()
 
+bool NormSession::SenderSpillTxObject()
+{
+    if (('\0' == tx_spill_dir[0]) || tx_table.IsEmpty() ||
+        (tx_spill_count >= tx_spill_count_max))
+    {
+        return false;
+    }
+    // Objects are spilled oldest first, so the ones before "tx_spill_next"
+    // are already spilled (or gone)
+    NormObjectId objectId = tx_spill_next;
+    if ((0 == tx_spill_count) ||
+        (objectId < tx_table.RangeLo()) || (tx_table.RangeHi() < objectId))
+    {
+        objectId = tx_table.RangeLo();
+    }
+    NormObject* obj;
+    while ((NULL == (obj = tx_table.Find(objectId))) || TxObjectIsSpilled(obj))
+    {
+        if (objectId == tx_table.RangeHi()) return false;
+        objectId++;
+    }
+    tx_spill_next = objectId;
+    // (STREAM objects and FILE objects, whose content is on disk already, stay put)
+    if ((NormObject::DATA != obj->GetType()) || obj->IsPending() || !obj->RelayIsComplete() ||
+        ((tx_spill_size + obj->GetSize()) > tx_spill_size_max))
+    {
+        return false;
+    }
+#ifdef WIN32
+    // (TBD) spill once NormFile::Map() supports WIN32
+    return false;
+#else
+    char path[PATH_MAX];
+    strcpy(path, tx_spill_dir);
+    strcat(path, "normSpillXXXXXX");
+    int fd = mkstemp(path);
+    if (fd < 0)
+    {
+        PLOG(PL_ERROR, "NormSession::SenderSpillTxObject() mkstemp() error: %s\n", GetErrorString());
+        return false;
+    }
+    close(fd);
+    if (!static_cast<NormDataObject*>(obj)->Spill(path))
+        return false;
+#endif // if/else WIN32
+    tx_spill_count++;
+    tx_spill_size += obj->GetSize();
+    objectId++;
+    tx_spill_next = objectId;
+    PLOG(PL_DEBUG, "NormSession::SenderSpillTxObject() spilled object %hu (spill count:%u)\n",
+         (UINT16)obj->GetId(), tx_spill_count);
+    // The application's copy of the data is no longer needed (a relay
+    // object's data is the retained source object, not the application's)
+    if (!obj->IsRelay())
+        Notify(NormController::TX_OBJECT_PURGED, (NormSenderNode*)NULL, obj);
+    return true;
+}  // end NormSession::SenderSpillTxObject()
+
 bool NormSession::RequeueTxObject(NormObject *obj)
 {
     ASSERT(NULL != obj);
@@ -2108,7 +3609,7 @@ bool NormSession::RequeueTxObject(NormObject *obj)
     NormObjectId objectId = obj->GetId();
     if (tx_table.Find(objectId) == obj)
     {
-        if (tx_pending_mask.Set(objectId))
+        if (SenderSetPending(objectId))
         {
             obj->TxReset(0, true);
             TouchSender();
@@ -2132,6 +3633,15 @@ void NormSession::DeleteTxObject(NormObject *obj, bool notify)
     ASSERT(NULL != obj);
     if (tx_table.Remove(obj))
     {
+        if (TxObjectIsSpilled(obj))
+        {
+            // (TX_OBJECT_PURGED was posted when it was spilled)
+            tx_spill_count--;
+            tx_spill_size -= obj->GetSize();
+            notify = false;
+        }
+        // (relay objects were never enqueued by the application)
+        if (obj->IsRelay()) notify = false;
         if (notify)
         {
             if (NormObject::FILE == obj->GetType())
@@ -2139,19 +3649,92 @@ void NormSession::DeleteTxObject(NormObject *obj, bool notify)
             Notify(NormController::TX_OBJECT_PURGED, (NormSenderNode*)NULL, obj);
         }
         NormObjectId objectId = obj->GetId();
-        tx_pending_mask.Unset(objectId);
+        SenderUnsetPending(objectId);
         tx_repair_mask.Unset(objectId);
         obj->Close();
         obj->Release();
     }
 } // end NormSession::DeleteTxObject()
 
+NormObject *NormSession::RelayOpenObject(NormObject &source)
+{
+    if (!IsSender() || (NormObject::DATA != source.GetType()))
+        return NULL;
+    // Source blocks are relayed as is, so segmentation must match
+    if ((source.GetSegmentSize() != SenderSegmentSize()) ||
+        (source.GetFecMaxBlockLen() != SenderBlockSize()))
+    {
+        PLOG(PL_ERROR, "NormSession::RelayOpenObject() error: relay segment/block size mismatch\n");
+        return NULL;
+    }
+    NormDataObject *obj = new NormDataObject(*this, NULL, next_tx_object_id, NULL);
+    if (NULL == obj)
+    {
+        PLOG(PL_FATAL, "NormSession::RelayOpenObject() new relay object error: %s\n",
+             GetErrorString());
+        return NULL;
+    }
+    // (the relay sends straight from the source object's data buffer)
+    NormDataObject &data = static_cast<NormDataObject &>(source);
+    if (!obj->Open((char *)data.GetData(), (UINT32)source.GetSize().GetOffset(), false,
+                   source.GetInfo(), source.GetInfoLength()) ||
+        !obj->RelayOpen(source))
+    {
+        PLOG(PL_FATAL, "NormSession::RelayOpenObject() relay object open error\n");
+        obj->Close();
+        obj->Release();
+        return NULL;
+    }
+    if (!QueueTxObject(obj))
+    {
+        PLOG(PL_WARN, "NormSession::RelayOpenObject() warning: unable to queue relay object\n");
+        obj->Close();
+        obj->Release();
+        return NULL;
+    }
+    // (nothing is pending but NORM_INFO until source blocks complete)
+    if (!obj->IsPending())
+        SenderUnsetPending(obj->GetId());
+    return obj;
+} // end NormSession::RelayOpenObject()
+
+void NormSession::RelayBlockCompleted(NormObject &relayObj, NormBlockId blockId)
+{
+    if (relayObj.RelaySetReady(blockId))
+    {
+        SenderSetPending(relayObj.GetId());
+        TouchSender();
+    }
+} // end NormSession::RelayBlockCompleted()
+
+void NormSession::RelayAbortObject(NormObject &relayObj)
+{
+    DeleteTxObject(&relayObj, true);
+} // end NormSession::RelayAbortObject()
+
+// Deletes relay objects of "upstream" objects (e.g. it's going away)
+void NormSession::RelayCancelSource(NormSession &upstream)
+{
+    NormObjectTable::Iterator iterator(tx_table);
+    NormObject *obj;
+    while ((obj = iterator.GetNextObject()))
+    {
+        NormObject *source = obj->GetRelaySource();
+        if ((NULL != source) && (&upstream == &source->GetSession()))
+        {
+            DeleteTxObject(obj, true);
+            iterator.Reset();
+        }
+    }
+} // end NormSession::RelayCancelSource()
+
 bool NormSession::SetTxCacheBounds(NormObjectSize sizeMax,
                                    unsigned long countMin,
                                    unsigned long countMax)
 {
     bool result = true;
-    tx_cache_size_max = sizeMax;
+    tx_cache_size_max = tx_cache_size_base = sizeMax;
+    if (auto_tune) SenderAutoTune();  // (may raise tx_cache_size_max above the base)
     tx_cache_count_min = (unsigned int)((countMin < countMax) ? countMin : countMax);
     if (tx_cache_count_min < 1)
         tx_cache_count_min = 1;
@@ -2167,29 +3750,37 @@ bool NormSession::SetTxCacheBounds(NormObjectSize sizeMax,
         // Trim/resize the tx_table and tx masks as needed
         unsigned long count = tx_table.GetCount();
         while ((count >= tx_cache_count_min) &&
-               ((count > tx_cache_count_max) ||
-                (tx_table.GetSize() > tx_cache_size_max)))
+               (((count - tx_spill_count) > tx_cache_count_max) ||
+                ((tx_table.GetSize() - tx_spill_size) > tx_cache_size_max) ||
+                (tx_spill_count > tx_spill_count_max) ||
+                (tx_spill_size > tx_spill_size_max)))
         {
-            // Remove oldest (hopefully non-pending ) object
-            NormObject *oldest = tx_table.Find(tx_table.RangeLo());
-            ASSERT(NULL != oldest);
-            DeleteTxObject(oldest, true);
+            // Spill if possible or else remove oldest (hopefully non-pending ) object
+            if (!SenderSpillTxObject())
+            {
+                NormObject *oldest = tx_table.Find(tx_table.RangeLo());
+                ASSERT(NULL != oldest);
+                DeleteTxObject(oldest, true);
+            }
             count = tx_table.GetCount();
         }
-        if (tx_cache_count_max < DEFAULT_TX_CACHE_MAX)
+        countMax = TxTableRangeMax();
+        if (countMax < DEFAULT_TX_CACHE_MAX)
             countMax = DEFAULT_TX_CACHE_MAX;
-        else
-            countMax = tx_cache_count_max;
         if (countMax != tx_table.GetRangeMax())
         {
             tx_table.SetRangeMax((UINT16)countMax);
             result = tx_pending_mask.Resize((UINT32)countMax);
+            tx_pending_cached = false;
             result &= tx_repair_mask.Resize((UINT32)countMax);
             if (!result)
             {
                 countMax = tx_pending_mask.GetSize();
                 if (tx_repair_mask.GetSize() < countMax)
                     countMax = tx_repair_mask.GetSize();
+                if ((tx_cache_count_max + tx_spill_count_max) > countMax)
+                    tx_spill_count_max = (countMax > tx_cache_count_max) ?
+                                            (unsigned int)(countMax - tx_cache_count_max) : 0;
                 if (tx_cache_count_max > countMax)
                     tx_cache_count_max = (unsigned int)countMax;
                 if (tx_cache_count_min > tx_cache_count_max)
@@ -2200,6 +3791,57 @@ bool NormSession::SetTxCacheBounds(NormObjectSize sizeMax,
     return result;
 } // end NormSession::SetTxCacheBounds()
 
+bool NormSession::SetTxCacheSpill(const char*    dirPath,
+                                  NormObjectSize sizeMax,
+                                  unsigned long  countMax)
+{
+    if (NULL == dirPath)
+    {
+        tx_spill_dir[0] = '\0';
+        tx_spill_count_max = 0;
+        tx_spill_size_max = NormObjectSize(0);
+    }
+    else
+    {
+        // (leave room for a trailing PROTO_PATH_DELIMITER and the spill file names)
+        size_t len = strlen(dirPath);
+        if ((0 == len) || ((len + 32) > PATH_MAX))
+        {
+            PLOG(PL_ERROR, "NormSession::SetTxCacheSpill() error: invalid directory path\n");
+            return false;
+        }
+        strcpy(tx_spill_dir, dirPath);
+        if (PROTO_PATH_DELIMITER != tx_spill_dir[len - 1])
+        {
+            tx_spill_dir[len++] = PROTO_PATH_DELIMITER;
+            tx_spill_dir[len] = '\0';
+        }
+        tx_spill_count_max = (unsigned int)(countMax & 0x00007fff);
+        tx_spill_size_max = sizeMax;
+    }
+    // Trims the spill tier and resizes the tx_table as needed
+    return SetTxCacheBounds(tx_cache_size_base, tx_cache_count_min, tx_cache_count_max);
+}  // end NormSession::SetTxCacheSpill()
+
+void NormSession::SenderCollectParity(NormBlock *block)
+{
+    unsigned int numData;
+    if (tx_fec_pool.Collect(block, numData))
+        block->SetParityReadiness(numData);
+    block->ClearFlag(NormBlock::PARITY_PENDING);
+} // end NormSession::SenderCollectParity()
+
+void NormSession::SenderReapParity()
+{
+    unsigned int numData;
+    NormBlock *block;
+    while (NULL != (block = (NormBlock *)tx_fec_pool.Reap(numData)))
+    {
+        block->SetParityReadiness(numData);
+        block->ClearFlag(NormBlock::PARITY_PENDING);
+    }
+} // end NormSession::SenderReapParity()
+
 NormBlock *NormSession::SenderGetFreeBlock(NormObjectId objectId,
                                            NormBlockId blockId)
 {
@@ -2218,6 +3860,8 @@ NormBlock *NormSession::SenderGetFreeBlock(NormObjectId objectId,
                 b = obj->StealNonPendingBlock(false);
             if (b)
             {
+                NORM_PROBE2(block_steal, (unsigned long)LocalNodeId(), (UINT16)obj->GetId());
+                if (b->ParityPending()) SenderCollectParity(b);
                 b->EmptyToPool(segment_pool);
                 break;
             }
@@ -2243,6 +3887,8 @@ NormBlock *NormSession::SenderGetFreeBlock(NormObjectId objectId,
                     b = obj->StealNewestBlock(true, blockId);
                 if (b)
                 {
+                    NORM_PROBE2(block_steal, (unsigned long)LocalNodeId(), (UINT16)obj->GetId());
+                    if (b->ParityPending()) SenderCollectParity(b);
                     b->EmptyToPool(segment_pool);
                     break;
                 }
@@ -2269,10 +3915,15 @@ char *NormSession::SenderGetFreeSegment(NormObjectId objectId,
 void NormSession::TxSocketRecvHandler(ProtoSocket &theSocket,
                                       ProtoSocket::Event theEvent)
 {
+#ifdef NORM_TX_ZEROCOPY
+    // (pending completion notifications make the socket "readable")
+    if (tx_zero_copy_reap && (ProtoSocket::RECV == theEvent))
+        TxZeroCopyReap();
+#endif // NORM_TX_ZEROCOPY
     if (ProtoSocket::RECV == theEvent)
     {
-        NormMsg msg;
-        unsigned int msgLength = NormMsg::MAX_SIZE;
+        NormMsg& msg = rx_msg;
+        unsigned int msgLength = msg.GetBufferSize();
         while (true)
         {
             if (theSocket.RecvFrom(msg.AccessBuffer(),
@@ -2284,8 +3935,12 @@ void NormSession::TxSocketRecvHandler(ProtoSocket &theSocket,
                 if (msg.InitFromBuffer(msgLength))
                 {
                     // Since it arrived on the tx_socket, we know it was unicast
-                    HandleReceiveMessage(msg, true);
-                    msgLength = NormMsg::MAX_SIZE;
+                    struct timeval rxTime;
+                    if (GetRxTimestamp(theSocket, msg, rxTime))
+                        HandleReceiveMessage(msg, true, false, &rxTime);
+                    else
+                        HandleReceiveMessage(msg, true);
+                    msgLength = msg.GetBufferSize();
                 }
                 else
                 {
@@ -2332,11 +3987,23 @@ int rxMeasureGapMax = 0;
 void NormSession::RxSocketRecvHandler(ProtoSocket &theSocket,
                                       ProtoSocket::Event theEvent)
 {
-    if (ProtoSocket::RECV == theEvent)
+#ifdef NORM_TX_ZEROCOPY
+    if (tx_zero_copy_reap && (&theSocket == tx_socket) && (ProtoSocket::RECV == theEvent))
+        TxZeroCopyReap();
+#endif // NORM_TX_ZEROCOPY
+    if ((ProtoSocket::RECV == theEvent) && rx_batch.IsEnabled())
     {
+        RxSocketRecvBatch(theSocket);
+    }
+    else if (ProtoSocket::RECV == theEvent)
+    {
+        // (Checked before reading so sequence gaps from drops are excused)
+        UINT32 dropCount;
+        if ((&theSocket == &rx_socket) && GetRxDropCount(theSocket, dropCount))
+            UpdateRxSocketDrops(dropCount);
         unsigned int recvCount = 0;
-        NormMsg msg;
-        unsigned int msgLength = NormMsg::MAX_SIZE;
+        NormMsg& msg = rx_msg;
+        unsigned int msgLength = msg.GetBufferSize();
         while (true)
         {
             ProtoAddress destAddr; // we get the pkt destAddr to determine unicast/multicast
@@ -2398,8 +4065,14 @@ void NormSession::RxSocketRecvHandler(ProtoSocket &theSocket,
                         wasUnicast = destAddr.IsUnicast();
                     else
                         wasUnicast = false;
-                    HandleReceiveMessage(msg, wasUnicast, ecnStatus);
-                    msgLength = NormMsg::MAX_SIZE;
+                    if (rx_layer_count > 1)
+                        msg.SetDestination(destAddr);  // (for RxLayerUpdate())
+                    struct timeval rxTime;
+                    if (GetRxTimestamp(theSocket, msg, rxTime))
+                        HandleReceiveMessage(msg, wasUnicast, ecnStatus, &rxTime);
+                    else
+                        HandleReceiveMessage(msg, wasUnicast, ecnStatus);
+                    msgLength = msg.GetBufferSize();
                 }
                 else  
                 {
@@ -2443,6 +4116,160 @@ void NormSession::RxSocketRecvHandler(ProtoSocket &theSocket,
     } // end if/else (theEvent == RECV/SEND)
 } // end NormSession::RxSocketRecvHandler()
 
+// Batched alternative to the RxSocketRecvHandler() recvfrom() loop
+// (Note the RX_MEASURE_ONLY debug option is not applied here)
+void NormSession::RxSocketRecvBatch(ProtoSocket &theSocket)
+{
+    unsigned int recvCount = 0;
+    unsigned int batchSize = rx_batch.GetSize();
+    // As in RxSocketRecvHandler(), we yield after about 100 packets
+    // so timeouts can be executed when the system is very busy
+    while (recvCount < 100)
+    {
+        int count = rx_batch.Recv(theSocket);
+        if (count < 0)
+        {
+            // Probably an ICMP "port unreachable" error (see RxSocketRecvHandler())
+            if (Address().IsUnicast())
+                Notify(NormController::SEND_ERROR, NULL, NULL);
+            break;
+        }
+        UINT32 dropCount;
+        if ((&theSocket == &rx_socket) && rx_batch.GetDropCount(dropCount))
+            UpdateRxSocketDrops(dropCount);
+        for (int i = 0; i < count; i++)
+        {
+            NormMsg &msg = rx_batch.AccessMsg(i);
+            unsigned int msgLength = rx_batch.GetMsgLength(i);
+            if ((0 != msgLength) && msg.InitFromBuffer(msgLength))
+            {
+                const ProtoAddress &destAddr = rx_batch.GetDestAddr(i);
+                bool wasUnicast = destAddr.IsValid() ? destAddr.IsUnicast() : false;
+                if (rx_layer_count > 1)
+                    msg.SetDestination(destAddr);  // (for RxLayerUpdate())
+                const struct timeval& rxTime = rx_batch.GetRxTime(i);
+                HandleReceiveMessage(msg, wasUnicast, rx_batch.GetEcnStatus(i),
+                                     (rx_timestamps && (0 != rxTime.tv_sec)) ? &rxTime : NULL);
+            }
+            else
+            {
+                PLOG(PL_ERROR, "NormSession::RxSocketRecvBatch() warning: received bad message\n");
+            }
+        }
+        if ((unsigned int)count < batchSize)
+            break;  // socket has been drained
+        recvCount += count;
+    }
+} // end NormSession::RxSocketRecvBatch()
+
+// Asks the kernel to attach its cumulative rx socket drop count to each
+// datagram received (read by NormRecvBatch::Recv())
+bool NormSession::EnableRxDropCount(ProtoSocket& theSocket)
+{
+#if defined(SO_RXQ_OVFL) && !defined(SIMULATE)
+    int enable = 1;
+    if (0 != setsockopt(theSocket.GetHandle(), SOL_SOCKET, SO_RXQ_OVFL, &enable, sizeof(enable)))
+    {
+        PLOG(PL_WARN, "NormSession::EnableRxDropCount() SO_RXQ_OVFL error: %s\n", GetErrorString());
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif // if/else SO_RXQ_OVFL && !SIMULATE
+} // end NormSession::EnableRxDropCount()
+
+// Asks the kernel to attach each datagram's IP traffic class (so its ECN
+// bits) to it for the batched receive path (read by NormRecvBatch::Recv())
+bool NormSession::EnableRxEcn(ProtoSocket& theSocket)
+{
+#if defined(NORM_RECV_BATCH)
+    int enable = 1;
+    int result;
+#ifdef HAVE_IPV6
+    if (ProtoAddress::IPv6 == Address().GetType())
+        result = setsockopt(theSocket.GetHandle(), IPPROTO_IPV6, IPV6_RECVTCLASS, &enable, sizeof(enable));
+    else
+#endif // HAVE_IPV6
+        result = setsockopt(theSocket.GetHandle(), IPPROTO_IP, IP_RECVTOS, &enable, sizeof(enable));
+    if (0 != result)
+    {
+        PLOG(PL_WARN, "NormSession::EnableRxEcn() error: %s\n", GetErrorString());
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif // if/else NORM_RECV_BATCH
+} // end NormSession::EnableRxEcn()
+
+// For the recvfrom() (not batched) receive path, which doesn't see the
+// SO_RXQ_OVFL ancillary data
+bool NormSession::GetRxDropCount(ProtoSocket& theSocket, UINT32& dropCount)
+{
+#if defined(SO_MEMINFO) && defined(SK_MEMINFO_DROPS) && !defined(SIMULATE)
+    UINT32 meminfo[SK_MEMINFO_VARS];
+    socklen_t len = sizeof(meminfo);
+    if (0 != getsockopt(theSocket.GetHandle(), SOL_SOCKET, SO_MEMINFO, meminfo, &len))
+        return false;
+    if (len <= (socklen_t)(SK_MEMINFO_DROPS * sizeof(UINT32)))
+        return false;
+    dropCount = meminfo[SK_MEMINFO_DROPS];
+    return true;
+#else
+    return false;
+#endif // if/else SO_MEMINFO && SK_MEMINFO_DROPS && !SIMULATE
+} // end NormSession::GetRxDropCount()
+
+// Given the rx socket's cumulative kernel drop count, accounts for any new
+// drops.  These can't be attributed to a particular remote sender, so the
+// loss estimate "excuse" is shared by the first senders' gaps seen
+void NormSession::UpdateRxSocketDrops(UINT32 dropCount)
+{
+    UINT32 drops = dropCount - rx_drop_last;  // (wraps ok)
+    if (0 == drops) return;
+    rx_drop_last = dropCount;
+    rx_stat_socket_drops += drops;
+    PLOG(PL_WARN, "NormSession::UpdateRxSocketDrops() node>%lu warning: rx socket dropped %lu datagrams (%lu total)\n",
+         (unsigned long)LocalNodeId(), (unsigned long)drops, (unsigned long)rx_stat_socket_drops);
+    if (rx_drop_excuse_enable)
+    {
+        rx_drop_excuse += drops;
+        ProtoSystemTime(rx_drop_time);
+    }
+    if (!posted_rx_socket_overflow)
+    {
+        posted_rx_socket_overflow = true;
+        Notify(NormController::RX_SOCKET_OVERFLOW, NULL, NULL);
+    }
+    if (auto_tune && (rx_sock_buffer_tuned < AUTO_TUNE_SOCK_MAX))
+    {
+        // Drops mean the bdp-based size is too small for our read latency
+        unsigned int size = (0 != rx_sock_buffer_tuned) ? (rx_sock_buffer_tuned << 1) : AUTO_TUNE_SOCK_MIN;
+        if (size < rx_sock_buffer_base) size = rx_sock_buffer_base;
+        if (size > AUTO_TUNE_SOCK_MAX) size = AUTO_TUNE_SOCK_MAX;
+        if (rx_socket.SetRxBufferSize(size))
+            PLOG(PL_DEBUG, "NormSession::UpdateRxSocketDrops() node>%lu rx socket buffer %u bytes\n",
+                 (unsigned long)LocalNodeId(), size);
+        else
+            PLOG(PL_WARN, "NormSession::UpdateRxSocketDrops() warning: unable to set rx socket buffer to %u bytes\n", size);
+        rx_sock_buffer_tuned = size;
+    }
+} // end NormSession::UpdateRxSocketDrops()
+
+unsigned int* NormSession::ReceiverDropExcuse(const struct timeval& currentTime)
+{
+    if (0 == rx_drop_excuse) return NULL;
+    double age = (double)(currentTime.tv_sec - rx_drop_time.tv_sec) +
+                 1.0e-06 * ((double)currentTime.tv_usec - (double)rx_drop_time.tv_usec);
+    if (age > RX_DROP_EXCUSE_AGE)
+    {
+        rx_drop_excuse = 0;  // (stale, those drops' gaps were already seen)
+        return NULL;
+    }
+    return &rx_drop_excuse;
+} // end NormSession::ReceiverDropExcuse()
+
 #ifdef ECN_SUPPORT
 #ifndef SIMULATE
 void NormSession::OnPktCapture(ProtoChannel &theChannel,
@@ -2577,6 +4404,233 @@ void NormSession::OnPktCapture(ProtoChannel &theChannel,
 #endif // !SIMULATE
 #endif // ECN_SUPPORT
 
+#ifdef NORM_XDP
+bool NormSession::OpenXdpSocket()
+{
+    if (NULL == xdp_socket)
+    {
+        if (NULL == (xdp_socket = new NormXdpSocket()))
+        {
+            PLOG(PL_FATAL, "NormSession::OpenXdpSocket() new NormXdpSocket error: %s\n", GetErrorString());
+            return false;
+        }
+        xdp_socket->SetListener(this, &NormSession::OnXdpInput);
+        xdp_socket->SetNotifier(session_mgr.GetChannelNotifier());
+        if (!xdp_socket->Open(xdp_interface, xdp_queue))
+        {
+            PLOG(PL_FATAL, "NormSession::OpenXdpSocket() error: unable to open AF_XDP socket on '%s' queue %u\n",
+                           xdp_interface, xdp_queue);
+            CloseXdpSocket();
+            return false;
+        }
+        if (!InitDstAddrList())
+        {
+            CloseXdpSocket();
+            return false;
+        }
+        // We need our own IP and Ethernet source addresses to build frames
+        // (if these aren't known, tx_socket is used for transmission)
+        if (!ProtoNet::GetInterfaceAddress(xdp_socket->GetInterfaceIndex(), ProtoAddress::IPv4, xdp_src_addr))
+        {
+            PLOG(PL_WARN, "NormSession::OpenXdpSocket() warning: unable to get interface IPv4 address\n");
+            xdp_src_addr.Invalidate();
+        }
+        if (!ProtoNet::GetInterfaceAddress(xdp_socket->GetInterfaceIndex(), ProtoAddress::ETH, xdp_src_mac))
+        {
+            PLOG(PL_WARN, "NormSession::OpenXdpSocket() warning: unable to get interface MAC address\n");
+            xdp_src_addr.Invalidate();
+        }
+        if (!xdp_socket->StartInputNotification())
+        {
+            PLOG(PL_FATAL, "NormSession::OpenXdpSocket() error: unable to start input notification\n");
+            CloseXdpSocket();
+            return false;
+        }
+    }
+    return true;
+}  // end NormSession::OpenXdpSocket()
+
+void NormSession::CloseXdpSocket()
+{
+    if (NULL != xdp_socket)
+    {
+        xdp_socket->Close();
+        delete xdp_socket;
+        xdp_socket = NULL;
+    }
+}  // end NormSession::CloseXdpSocket()
+
+// Only IPv4 multicast is sent via the AF_XDP socket since there is no
+// neighbor (ARP) resolution for unicast destinations here.  Other messages
+// (e.g. unicast feedback) still go out the tx_socket.
+bool NormSession::XdpSendTo(const char* buffer, unsigned int& numBytes, const ProtoAddress& dstAddr)
+{
+    unsigned int maxLen;
+    char* frame = xdp_socket->GetTxFrame(maxLen);
+    if (NULL == frame)
+    {
+        // Kick the kernel to complete outstanding transmissions and try again
+        xdp_socket->Flush();
+        if (NULL == (frame = xdp_socket->GetTxFrame(maxLen)))
+        {
+            numBytes = 0;  // "blocked"
+            xdp_blocked = true;
+            return true;
+        }
+    }
+    ProtoPktETH ethPkt((UINT32*)((void*)frame), maxLen);
+    ProtoAddress etherDst;
+    etherDst.GetEthernetMulticastAddress(dstAddr);
+    ethPkt.SetSrcAddr(xdp_src_mac);
+    ethPkt.SetDstAddr(etherDst);
+    ethPkt.SetType(ProtoPktETH::IP);
+    ProtoPktIPv4 ip4Pkt;
+    ip4Pkt.InitIntoBuffer(ethPkt.AccessPayload(), ethPkt.GetBufferLength() - ethPkt.GetHeaderLength());
+    UINT8 trafficClass = tos;
+    if (ecn_enabled)
+    {
+        trafficClass |= ((UINT8)ProtoSocket::ECN_ECT0);  // set ECT0 bit
+        trafficClass &= ~((UINT8)ProtoSocket::ECN_ECT1); // clear ECT1 bit
+    }
+    ip4Pkt.SetTOS(trafficClass);
+    ip4Pkt.SetID((UINT16)rand());
+    ip4Pkt.SetTTL(ttl);
+    ip4Pkt.SetProtocol(ProtoPktIP::UDP);
+    ip4Pkt.SetSrcAddr(xdp_src_addr);
+    ip4Pkt.SetDstAddr(dstAddr);
+    ProtoPktUDP udpPkt(ip4Pkt.AccessPayload(), ip4Pkt.GetBufferLength() - ip4Pkt.GetHeaderLength());
+    udpPkt.SetSrcPort(GetTxPort());
+    udpPkt.SetDstPort(dstAddr.GetPort());
+    udpPkt.SetPayload(buffer, numBytes);
+    ip4Pkt.SetPayloadLength(udpPkt.GetLength());
+    udpPkt.FinalizeChecksum(ip4Pkt);
+    ethPkt.SetPayloadLength(ip4Pkt.GetLength());
+    if (!xdp_socket->Send(frame, ethPkt.GetLength()))
+    {
+        numBytes = 0;  // tx ring full, so "blocked"
+        xdp_blocked = true;
+    }
+    return true;
+}  // end NormSession::XdpSendTo()
+
+void NormSession::OnXdpInput(ProtoChannel &theChannel,
+                             ProtoChannel::Notification notifyType)
+{
+    if (ProtoChannel::NOTIFY_OUTPUT == notifyType)
+    {
+        // The tx ring has room again after a blocked XdpSendTo() (the
+        // retry reclaims completed frames)
+        theChannel.StopOutputNotification();
+        if (tx_timer.IsActive())
+            tx_timer.Deactivate();
+        if (OnTxTimeout(tx_timer))
+        {
+            if (!tx_timer.IsActive())
+                ActivateTimer(tx_timer);
+        }
+        return;
+    }
+    if (ProtoChannel::NOTIFY_INPUT != notifyType)
+        return;
+    NormXdpSocket &xsk = static_cast<NormXdpSocket &>(theChannel);
+    NormMsg msg;
+    unsigned int total = 0;
+    unsigned int count;
+    while (0 != (count = xsk.RecvPeek(64)))
+    {
+        for (unsigned int i = 0; i < count; i++)
+        {
+            unsigned int frameLen;
+            const char *frame = xsk.GetRxFrame(i, frameLen);
+            HandleXdpFrame(msg, frame, frameLen);
+        }
+        xsk.RecvRelease();
+        // Yield so a steady rx stream can't starve timers, etc
+        // (the socket will still be "readable" if frames remain)
+        total += count;
+        if (total >= 256)
+            break;
+    }
+} // end NormSession::OnXdpInput()
+
+void NormSession::HandleXdpFrame(NormMsg &msg, const char *frame, unsigned int frameLen)
+{
+    // (UMEM frames are offset so the IP header is 32-bit aligned)
+    ProtoPktETH ethPkt((UINT32 *)((void *)frame), frameLen);
+    if (!ethPkt.InitFromBuffer(frameLen))
+        return;
+    UINT16 ethType = ethPkt.GetType();
+    if ((ethType != 0x0800) && (ethType != 0x86dd))
+        return;
+    ProtoPktIP ipPkt(ethPkt.AccessPayload(), frameLen - ethPkt.GetHeaderLength());
+    if (!ipPkt.InitFromBuffer(ethPkt.GetPayloadLength()))
+    {
+        PLOG(PL_ERROR, "NormSession::HandleXdpFrame() error: bad IP packet\n");
+        return;
+    }
+    ProtoAddress dstIp;
+    ProtoAddress srcIp;
+    ProtoSocket::EcnStatus ecnStatus = ProtoSocket::ECN_NONE;
+    switch (ipPkt.GetVersion())
+    {
+        case 4:
+        {
+            ProtoPktIPv4 ip4Pkt(ipPkt);
+            ip4Pkt.GetDstAddr(dstIp);
+            ip4Pkt.GetSrcAddr(srcIp);
+            ecnStatus = (ProtoSocket::EcnStatus)(ip4Pkt.GetTOS() & ProtoSocket::ECN_CE);
+            break;
+        }
+        case 6:
+        {
+            ProtoPktIPv6 ip6Pkt(ipPkt);
+            ip6Pkt.GetDstAddr(dstIp);
+            ip6Pkt.GetSrcAddr(srcIp);
+            ecnStatus = (ProtoSocket::EcnStatus)(ip6Pkt.GetTrafficClass() & ProtoSocket::ECN_CE);
+            break;
+        }
+        default:
+            return;
+    }
+    if (!dst_addr_list.Contains(dstIp))
+        return;
+    ProtoPktUDP udpPkt;
+    if (!udpPkt.InitFromPacket(ipPkt) || (udpPkt.GetDstPort() != rx_socket.GetPort()))
+        return;
+    srcIp.SetPort(udpPkt.GetSrcPort());
+    if (rx_connect_addr.IsValid())
+    {
+        if (0 != rx_connect_addr.GetPort())
+        {
+            if (!rx_connect_addr.HostIsEqual(srcIp))
+                return;
+        }
+        else if (!rx_connect_addr.IsEqual(srcIp))
+        {
+            return;
+        }
+    }
+    if (ssm_source_addr.IsValid() && !ssm_source_addr.HostIsEqual(srcIp))
+        return;
+    // (the kernel hasn't verified the checksum for AF_XDP frames)
+    if (!udpPkt.ChecksumIsValid(ipPkt))
+    {
+        PLOG(PL_WARN, "NormSession::HandleXdpFrame() error: recvd UDP packet w/ bad checksum\n");
+        return;
+    }
+    if (msg.CopyFromBuffer((const char *)udpPkt.GetPayload(), udpPkt.GetPayloadLength()))
+    {
+        msg.AccessAddress() = srcIp;
+        HandleReceiveMessage(msg, dstIp.IsUnicast(), (ProtoSocket::ECN_CE == ecnStatus));
+    }
+    else
+    {
+        PLOG(PL_WARN, "NormSession::HandleXdpFrame() error: recvd bad NORM packet?!\n");
+    }
+} // end NormSession::HandleXdpFrame()
+#endif // NORM_XDP
+
+#ifndef NORM_NO_TRACE
 // TBD - move this to its own cpp file???
 void NormTrace(const struct timeval &currentTime,
                NormNodeId localId,
@@ -2725,16 +4779,9 @@ void NormTrace(const struct timeval &currentTime,
         {
             const NormCmdCCMsg &cc = static_cast<const NormCmdCCMsg &>(msg);
             PLOG(PL_ALWAYS, " seq>%u ", cc.GetCCSequence());
-            NormHeaderExtension ext;
-            while (cc.GetNextExtension(ext))
-            {
-                if (NormHeaderExtension::CC_RATE == ext.GetType())
-                {
-                    UINT16 sendRate = ((NormCCRateExtension &)ext).GetSendRate();
-                    PLOG(PL_ALWAYS, " rate>%f ", 8.0e-03 * NormUnquantizeRate(sendRate));
-                    break;
-                }
-            }
+            NormCCRateExtension ext;
+            if (cc.FindExtension(NormHeaderExtension::CC_RATE, ext))
+                PLOG(PL_ALWAYS, " rate>%f ", 8.0e-03 * NormUnquantizeRate(ext.GetSendRate()));
             break;
         }
         default:
@@ -2748,16 +4795,7 @@ void NormTrace(const struct timeval &currentTime,
     {
         PLOG(PL_ALWAYS, "inst>%hu ", instId);
         // look for NormCCFeedback extension
-        bool ccExt = false;
-        NormHeaderExtension ext;
-        while (msg.GetNextExtension(ext))
-        {
-            if (NormHeaderExtension::CC_FEEDBACK == ext.GetType())
-            {
-                ccExt = true;
-                break;
-            }
-        }
+        bool ccExt = msg.HasExtension(NormHeaderExtension::CC_FEEDBACK);
         if (NormMsg::ACK == msgType)
         {
             const NormAckMsg &ack = static_cast<const NormAckMsg &>(msg);
@@ -2810,20 +4848,47 @@ void NormTrace(const struct timeval &currentTime,
     } // end switch (msgType)
     PLOG(PL_ALWAYS, "len>%hu %s\n", length, clrFlag ? "(CLR)" : "");
 } // end NormTrace();
+#endif // !NORM_NO_TRACE
 
-void NormSession::HandleReceiveMessage(NormMsg &msg, bool wasUnicast, bool ecnStatus)
+void NormSession::HandleReceiveMessage(NormMsg &msg, bool wasUnicast, bool ecnStatus, const struct timeval* rxTime)
 {
+    if (!rx_demux_tree.IsEmpty())
+    {
+        // Hand packets from demultiplexed remote addresses to their session
+        NormRxDemuxItem* item = rx_demux_tree.FindItem(msg.GetSource());
+        if (NULL != item)
+        {
+            item->GetSession().HandleReceiveMessage(msg, wasUnicast, ecnStatus, rxTime);
+            return;
+        }
+    }
+    NORM_PROBE3(rx_message, (int)msg.GetType(), (unsigned long)msg.GetSourceId(), msg.GetLength());
     // Ignore messages from ourself unless "loopback" is enabled
     if ((msg.GetSourceId() == LocalNodeId()) && !loopback)
         return;
     // Drop some rx messages for testing
     if ((rx_loss_rate > 0) && (UniformRand(100.0) < rx_loss_rate))
         return;
+    if (aead.IsKeySet() && !OpenMessage(msg))
+        return;
 
     struct timeval currentTime;
     ::ProtoSystemTime(currentTime);
+    if (NULL != rxTime)
+    {
+        // Use the kernel receive time (for RTT measurement) unless it's
+        // from the future (e.g. the system clock was stepped back)
+        if ((rxTime->tv_sec < currentTime.tv_sec) ||
+            ((rxTime->tv_sec == currentTime.tv_sec) && (rxTime->tv_usec <= currentTime.tv_usec)))
+            currentTime = *rxTime;
+    }
+    rx_msg_layer = 0;
+    if ((rx_layer_count > 1) && IsReceiver() && 
+        (NormMsg::NACK != msg.GetType()) && (NormMsg::ACK != msg.GetType()))
+        rx_msg_layer = RxLayerUpdate(msg, currentTime);
 
-    if (trace)
+#ifndef NORM_NO_TRACE
+    if (trace || trace_ring.IsOpen())
     {
         // Initially assume it's a message we generated (or similarly configured sender)
         UINT8 fecM = fec_m;
@@ -2860,8 +4925,11 @@ void NormSession::HandleReceiveMessage(NormMsg &msg, bool wasUnicast, bool ecnSt
                 instId = 0;
             }
         }
-        NormTrace(currentTime, LocalNodeId(), msg, false, fecM, instId); // TBD don't assume m == 16 (i.e. for fec_id == 2)
-    }                                                                    // end if (trace)
+        if (trace)
+            NormTrace(currentTime, LocalNodeId(), msg, false, fecM, instId); // TBD don't assume m == 16 (i.e. for fec_id == 2)
+        trace_ring.Add(currentTime, msg, false, fecM, instId);
+    }   // end if (trace || trace_ring.IsOpen())
+#endif // !NORM_NO_TRACE
 
     NormMsg::Type msgType = msg.GetType();
 
@@ -2999,6 +5067,23 @@ void NormSession::ReceiverHandleObjectMessage(const struct timeval &currentTime,
         theSender = client_tree.FindNodeByAddress(msg.GetSource());
     else
         theSender = (NormSenderNode *)sender_tree.FindNodeById(sourceId);
+    // A local repairer's retransmission (see ReceiverSetLocalRepair()) only updates
+    // the objects of a sender we already know (not its address, rate, etc)
+    if (msg.FlagIsSet(NormObjectMsg::FLAG_REPAIR))
+    {
+        NormLocalRepairExtension ext;
+        if (msg.FindExtension(NormHeaderExtension::LOCAL_REPAIR, ext) && ext.IsValid())
+        {
+            if ((NULL != theSender) && !IsServerListener() &&
+                (ext.GetRepairerId() != LocalNodeId()) &&
+                (msg.GetInstanceId() == theSender->GetInstanceId()))
+            {
+                theSender->LocalRepairHeard();
+                theSender->HandleObjectMessage(msg);
+            }
+            return;
+        }
+    }
     if (theSender)
     {
         if (msg.GetInstanceId() != theSender->GetInstanceId())
@@ -3018,10 +5103,8 @@ void NormSession::ReceiverHandleObjectMessage(const struct timeval &currentTime,
     }
     else
     {
-        if (NULL != preset_sender)
+        if (NULL != (theSender = GetPresetSender(msg.GetSourceId())))
         {
-            theSender = preset_sender;
-            preset_sender = NULL;
             theSender->SetId(msg.GetSourceId());
             theSender->SetInstanceId(msg.GetInstanceId());
             theSender->SetAddress(msg.GetSource());
@@ -3064,15 +5147,23 @@ void NormSession::ReceiverHandleObjectMessage(const struct timeval &currentTime,
         }
     }
     theSender->Activate(true);
-    if (!theSender->GetAddress().IsEqual(msg.GetSource()))
+    // (DATA may arrive from a multipath sender's other paths (see AddTxPath()),
+    //  so the sender address is taken from its INFO and CMD messages)
+    if ((NormMsg::DATA != msg.GetType()) && !theSender->GetAddress().IsEqual(msg.GetSource()))
     {
         // sender source address has changed
         theSender->SetAddress(msg.GetSource());
         Notify(NormController::REMOTE_SENDER_ADDRESS, theSender, NULL);
     }
-    theSender->UpdateRecvRate(currentTime, msg.GetLength());
-    theSender->UpdateLossEstimate(currentTime, msg.GetSequence(), ecnStatus);
+    if (0 == rx_msg_layer)
+    {
+        // (congestion control feedback is for layer 0, see AddTxLayer())
+        theSender->UpdateRecvRate(currentTime, msg.GetLength());
+        theSender->UpdateLossEstimate(currentTime, msg.GetSequence(), ecnStatus);
+    }
     theSender->IncrementRecvTotal(msg.GetLength()); // for statistics only (TBD) #ifdef NORM_DEBUG
+    if (NormMsg::DATA == msg.GetType())
+        theSender->IncrementRecvSegments();
     theSender->HandleObjectMessage(msg);
     theSender->CheckCCFeedback(); // this cues immediate CLR cc feedback if loss was detected
                                   // and cc feedback was not provided in response otherwise
@@ -3111,10 +5202,8 @@ void NormSession::ReceiverHandleCommand(const struct timeval &currentTime,
     {
         //DMSG(0, "NormSession::ReceiverHandleCommand() node>%lu recvd command from unknown sender ...\n",
         //          (unsigned long)LocalNodeId());
-        if (NULL != preset_sender)
+        if (NULL != (theSender = GetPresetSender(cmd.GetSourceId())))
         {
-            theSender = preset_sender;
-            preset_sender = NULL;
             theSender->SetId(cmd.GetSourceId());
             theSender->SetInstanceId(cmd.GetInstanceId());
             theSender->SetAddress(cmd.GetSource());
@@ -3290,6 +5379,79 @@ void NormSession::SenderUpdateGrttEstimate(double receiverRtt)
     }
 } // end NormSession::SenderUpdateGrttEstimate()
 
+void NormSession::SenderSetGroupSizeEstimation(bool enable)
+{
+    if (enable && !gsize_auto)
+    {
+        gsize_age = 0.0;
+        gsize_epoch = 0;
+        gsize_zeros = GSIZE_BITMAP_BITS;
+        memset(gsize_bitmap, 0, sizeof(gsize_bitmap));
+    }
+    gsize_auto = enable;
+} // end NormSession::SenderSetGroupSizeEstimation()
+
+void NormSession::SenderNoteReceiver(NormNodeId nodeId)
+{
+    if (!gsize_auto) return;
+    // (multiplicative hash of the id to a bitmap position)
+    UINT32 pos = ((UINT32)nodeId * 0x9e3779b1) >> (32 - GSIZE_BITMAP_LOG2);
+    UINT32 mask = (UINT32)1 << (pos & 31);
+    UINT32* word = gsize_bitmap[gsize_epoch] + (pos >> 5);
+    if (0 != (*word & mask)) return;  // (already heard from this epoch)
+    *word |= mask;
+    if (0 != (gsize_bitmap[1 - gsize_epoch][pos >> 5] & mask)) return;
+    gsize_zeros--;
+    double gsize = SenderCountReceivers();
+    if (gsize > gsize_measured)
+    {
+        UINT8 gsizeQuantizedOld = gsize_quantized;
+        SenderSetGroupSize(gsize);
+        if (gsizeQuantizedOld != gsize_quantized)
+            PLOG(PL_DEBUG, "NormSession::SenderNoteReceiver() node>%lu increased group size estimate to %lf\n",
+                 (unsigned long)LocalNodeId(), gsize_advertised);
+    }
+} // end NormSession::SenderNoteReceiver()
+
+// Linear counting estimate of the distinct receivers hashed into the
+// union of the two epoch bitmaps
+double NormSession::SenderCountReceivers() const
+{
+    const double bits = (double)GSIZE_BITMAP_BITS;
+    if (0 == gsize_zeros)
+        return (bits * log(bits));  // (saturated)
+    double count = bits * log(bits / (double)gsize_zeros);
+    return ((count > 1.0) ? count : 1.0);
+} // end NormSession::SenderCountReceivers()
+
+// Called each GSIZE_EPOCH to start a new epoch bitmap (forgetting the
+// receivers only heard from in the epoch before last).  Receivers that don't
+// need to give feedback often (suppression, no loss) aren't heard from each
+// epoch, so the estimate is cut by at most a half at a time and kept as is
+// when no receiver at all was heard from last epoch.
+void NormSession::SenderUpdateGroupSize()
+{
+    gsize_epoch = 1 - gsize_epoch;
+    memset(gsize_bitmap[gsize_epoch], 0, sizeof(gsize_bitmap[gsize_epoch]));
+    unsigned int count = 0;
+    const UINT32* word = gsize_bitmap[1 - gsize_epoch];
+    for (unsigned int i = 0; i < (GSIZE_BITMAP_BITS / 32); i++)
+    {
+        for (UINT32 w = word[i]; 0 != w; w &= (w - 1))
+            count++;
+    }
+    gsize_zeros = GSIZE_BITMAP_BITS - count;
+    if (0 == count) return;
+    double gsize = SenderCountReceivers();
+    if (gsize < 0.5 * gsize_measured)
+        gsize = 0.5 * gsize_measured;
+    UINT8 gsizeQuantizedOld = gsize_quantized;
+    SenderSetGroupSize(gsize);
+    if (gsizeQuantizedOld != gsize_quantized)
+        PLOG(PL_DEBUG, "NormSession::SenderUpdateGroupSize() node>%lu new group size estimate %lf\n",
+             (unsigned long)LocalNodeId(), gsize_advertised);
+} // end NormSession::SenderUpdateGroupSize()
+
 double NormSession::CalculateRate(double size, double rtt, double loss)
 {
     //                                  size
@@ -3542,6 +5704,7 @@ void NormSession::SenderHandleCCFeedback(struct timeval currentTime,
 
 void NormSession::SenderHandleAckMessage(const struct timeval &currentTime, const NormAckMsg &ack, bool wasUnicast)
 {
+    SenderNoteReceiver(ack.GetSourceId());
     // Update GRTT estimate
     struct timeval grttResponse;
     ack.GetGrttResponse(grttResponse);
@@ -3554,28 +5717,24 @@ void NormSession::SenderHandleAckMessage(const struct timeval &currentTime, cons
 
     // Look for NORM-CC Feedback header extension
     NormCCFeedbackExtension ext;
-    while (ack.GetNextExtension(ext))
-    {
-        if (NormHeaderExtension::CC_FEEDBACK == ext.GetType())
-        {
-            SenderHandleCCFeedback(currentTime,
-                                   ack.GetSourceId(),
-                                   ext.GetCCFlags(),
-                                   receiverRtt >= 0.0 ? receiverRtt : NormUnquantizeRtt(ext.GetCCRtt()),
-                                   NormUnquantizeLoss32(ext.GetCCLoss32()),
-                                   NormUnquantizeRate(ext.GetCCRate()),
-                                   ext.GetCCSequence());
-            if (wasUnicast && probe_proactive && Address().IsMulticast())
+    if (ack.FindExtension(NormHeaderExtension::CC_FEEDBACK, ext))
+    {
+        SenderHandleCCFeedback(currentTime,
+                               ack.GetSourceId(),
+                               ext.GetCCFlags(),
+                               receiverRtt >= 0.0 ? receiverRtt : NormUnquantizeRtt(ext.GetCCRtt()),
+                               NormUnquantizeLoss32(ext.GetCCLoss32()),
+                               NormUnquantizeRate(ext.GetCCRate()),
+                               ext.GetCCSequence());
+        if (wasUnicast && probe_proactive && Address().IsMulticast())
+        {
+            // if it's the CLR, it doesn't suppress anyone, don't advertise
+            if (!ext.CCFlagIsSet(NormCC::CLR))
             {
-                // if it's the CLR, it doesn't suppress anyone, don't advertise
-                if (!ext.CCFlagIsSet(NormCC::CLR))
-                {
-                    // for suppression of unicast cc feedback
-                    advertise_repairs = true;
-                    QueueMessage(NULL);
-                }
+                // for suppression of unicast cc feedback
+                advertise_repairs = true;
+                QueueMessage(NULL);
             }
-            break;
         }
     }
 
@@ -3592,62 +5751,95 @@ void NormSession::SenderHandleAckMessage(const struct timeval &currentTime, cons
                 static_cast<NormAckingNode *>(acking_node_tree.FindNodeById(ack.GetSourceId()));
             if (NULL != acker)
             {
-                if (!acker->AckReceived())
+                const NormAckFlushMsg &flushAck = static_cast<const NormAckFlushMsg &>(ack);
+                NormObjectId ackObjectId = flushAck.GetObjectId();
+                NormBlockId ackBlockId = flushAck.GetFecBlockId(fec_m);
+                NormSegmentId ackSegmentId = flushAck.GetFecSymbolId(fec_m);
+                bool isCurrent = ((watermark_object_id == ackObjectId) &&
+                                  (watermark_block_id == ackBlockId) &&
+                                  (watermark_segment_id == ackSegmentId));
+                // Otherwise, the ACK may be for an older pipelined watermark
+                unsigned int pipelineIndex = watermark_pipeline_count;
+                for (unsigned int i = 0; !isCurrent && (i < watermark_pipeline_count); i++)
                 {
-                    const NormAckFlushMsg &flushAck = static_cast<const NormAckFlushMsg &>(ack);
-                    if (flushAck.GetFecId() != fec_id)
+                    const PipelinedWatermark &older = watermark_pipeline[(watermark_pipeline_head + i) % WATERMARK_PIPELINE_MAX];
+                    if ((older.object_id == ackObjectId) &&
+                        (older.block_id == ackBlockId) &&
+                        (older.segment_id == ackSegmentId))
                     {
-                        PLOG(PL_ERROR, "NormSession::SenderHandleAckMessage() received watermark ACK with wrong fec_id?!\n");
+                        pipelineIndex = i;
+                        break;
                     }
-                    else if ((watermark_object_id == flushAck.GetObjectId()) &&
-                             (watermark_block_id == flushAck.GetFecBlockId(fec_m)) &&
-                             (watermark_segment_id == flushAck.GetFecSymbolId(fec_m)))
+                }
+                // An aggregator's ACK also covers the receivers it lists
+                // (even if its own ACK for the watermark is redundant)
+                NormAckAggregateExtension aggExt;
+                if ((flushAck.GetFecId() == fec_id) && (isCurrent || (pipelineIndex < watermark_pipeline_count)) &&
+                    ack.FindExtension(NormHeaderExtension::ACK_AGGREGATE, aggExt))
+                {
+                    SenderHandleAggregateAck(aggExt, acker->GetId(), isCurrent, pipelineIndex);
+                }
+                if (flushAck.GetFecId() != fec_id)
+                {
+                    PLOG(PL_ERROR, "NormSession::SenderHandleAckMessage() received watermark ACK with wrong fec_id?!\n");
+                }
+                else if (isCurrent && acker->AckReceived())
+                {
+                    PLOG(PL_DEBUG, "NormSession::SenderHandleAckMessage() received redundant watermark ACK?!\n");
+                }
+                else if (isCurrent || (pipelineIndex < watermark_pipeline_count))
+                {
+                    // Cache any application-defined extended ACK content for this acker
+                    NormAppAckExtension ext;
+                    if (ack.FindExtension(NormHeaderExtension::APP_ACK, ext))
                     {
-                        // Cache any application-defined extended ACK content for this acker
-                        NormAppAckExtension ext;
-                        while (ack.GetNextExtension(ext))
+                        if (!acker->SetAckEx(ext.GetContent(), ext.GetContentLength()))
                         {
-                            if (NormHeaderExtension::APP_ACK == ext.GetType())
-                            {
-                                if (!acker->SetAckEx(ext.GetContent(), ext.GetContentLength()))
-                                {
-                                    // TBD - notify app of error
-                                    PLOG(PL_ERROR, "NormSession::SenderHandleAckMessage() error: unable to cache application-defined ACK content!\n");
-                                }
-                            }
+                            // TBD - notify app of error
+                            PLOG(PL_ERROR, "NormSession::SenderHandleAckMessage() error: unable to cache application-defined ACK content!\n");
                         }
+                    }
+                    if (isCurrent)
+                    {
                         acker->MarkAckReceived();
-                        /*  This code was an attempt to expedite delivery of the TX_WATERMARK_COMPLETED
-                                notification to the application, but breaks some other desired behavior.
-                            watermark_pending = false;
-                            acking_success_count = 0;
-                            NormNodeTreeIterator iterator(acking_node_tree);
-                            NormAckingNode* next;
-                            while (NULL != (next = static_cast<NormAckingNode*>(iterator.GetNextNode())))
-                            {
-                                if (next->IsPending())
-                                    watermark_pending = true;
-                                else if (next->AckReceived() || (NORM_NODE_NONE == next->GetId()))
-                                    acking_success_count++;
-                            }
-                            if (!watermark_pending)
-                            {
-                                PLOG(PL_DEBUG, "NormSession::SenderHandleAckMessage() node>%lu watermark ack finished.\n",
-                                                (unsigned long)LocalNodeId());
-                                Notify(NormController::TX_WATERMARK_COMPLETED, (NormSenderNode*)NULL, (NormObject*)NULL);
-                            }
-                            */
+                        pipelineIndex = watermark_pipeline_count;
                     }
                     else
                     {
-                        // This can happen when new watermarks are set when an old watermark is still
-                        // pending (i.e. receivers may still be in the process of replying)
-                        PLOG(PL_DEBUG, "NormSession::SenderHandleAckMessage() received old/wrong watermark ACK?!\n");
+                        pipelineIndex++;
                     }
+                    // Receivers only ACK a watermark once they have everything before
+                    // it, so the ACK covers any older pipelined watermarks, too
+                    for (unsigned int i = 0; i < pipelineIndex; i++)
+                        acker->MarkPipelineAck((watermark_pipeline_head + i) % WATERMARK_PIPELINE_MAX);
+                    if (0 != pipelineIndex)
+                        SenderCheckWatermarkPipeline();
+                    /*  This code was an attempt to expedite delivery of the TX_WATERMARK_COMPLETED
+                            notification to the application, but breaks some other desired behavior.
+                        watermark_pending = false;
+                        acking_success_count = 0;
+                        NormNodeTreeIterator iterator(acking_node_tree);
+                        NormAckingNode* next;
+                        while (NULL != (next = static_cast<NormAckingNode*>(iterator.GetNextNode())))
+                        {
+                            if (next->IsPending())
+                                watermark_pending = true;
+                            else if (next->AckReceived() || (NORM_NODE_NONE == next->GetId()))
+                                acking_success_count++;
+                        }
+                        if (!watermark_pending)
+                        {
+                            PLOG(PL_DEBUG, "NormSession::SenderHandleAckMessage() node>%lu watermark ack finished.\n",
+                                            (unsigned long)LocalNodeId());
+                            Notify(NormController::TX_WATERMARK_COMPLETED, (NormSenderNode*)NULL, (NormObject*)NULL);
+                        }
+                        */
                 }
                 else
                 {
-                    PLOG(PL_DEBUG, "NormSession::SenderHandleAckMessage() received redundant watermark ACK?!\n");
+                    // This can happen when new watermarks are set when an old watermark is still
+                    // pending (i.e. receivers may still be in the process of replying)
+                    PLOG(PL_DEBUG, "NormSession::SenderHandleAckMessage() received old/wrong watermark ACK?!\n");
                 }
             }
             else
@@ -3669,8 +5861,45 @@ void NormSession::SenderHandleAckMessage(const struct timeval &currentTime, cons
     }
 } // end SenderHandleAckMessage()
 
+// Marks the acking nodes listed in an aggregator's watermark ACK (see
+// SenderSetAckingNodeAggregator()).  "pipelineIndex" is the older pipelined
+// watermark the ACK is for when it isn't for the current one.
+void NormSession::SenderHandleAggregateAck(const NormAckAggregateExtension &ext, NormNodeId aggregatorId,
+                                           bool isCurrent, unsigned int pipelineIndex)
+{
+    unsigned int pipelineMarks = isCurrent ? watermark_pipeline_count : (pipelineIndex + 1);
+    unsigned int ackCount = 0;
+    UINT16 pairCount = ext.GetPairCount();
+    for (UINT16 i = 0; i < pairCount; i++)
+    {
+        NormNodeId baseId = ext.GetPairBaseId(i);
+        UINT32 mask = ext.GetPairMask(i);
+        for (unsigned int bit = 0; 0 != mask; bit++, mask <<= 1)
+        {
+            if (0 == (mask & 0x80000000)) continue;
+            NormAckingNode *member =
+                static_cast<NormAckingNode *>(acking_node_tree.FindNodeById(baseId + bit));
+            // (an aggregator only vouches for its own members)
+            if ((NULL == member) || (aggregatorId != member->GetAggregatorId()))
+                continue;
+            if (isCurrent && member->AckReceived())
+                continue;
+            if (isCurrent) member->MarkAckReceived();
+            for (unsigned int j = 0; j < pipelineMarks; j++)
+                member->MarkPipelineAck((watermark_pipeline_head + j) % WATERMARK_PIPELINE_MAX);
+            ackCount++;
+        }
+    }
+    PLOG(PL_DEBUG, "NormSession::SenderHandleAggregateAck() node>%lu aggregator>%lu acknowledged for %u nodes\n",
+         (unsigned long)LocalNodeId(), (unsigned long)aggregatorId, ackCount);
+    if ((0 != ackCount) && (0 != pipelineMarks))
+        SenderCheckWatermarkPipeline();
+} // end NormSession::SenderHandleAggregateAck()
+
 void NormSession::SenderHandleNackMessage(const struct timeval &currentTime, NormNackMsg &nack)
 {
+    tx_stat_nacks++;
+    SenderNoteReceiver(nack.GetSourceId());
     struct timeval grttResponse;
     nack.GetGrttResponse(grttResponse);
     double receiverRtt = CalculateRtt(currentTime, grttResponse);
@@ -3681,27 +5910,34 @@ void NormSession::SenderHandleNackMessage(const struct timeval &currentTime, Nor
         LogRepairContent(nack.GetRepairContent(), nack.GetRepairContentLength(), fec_id, fec_m);
         PLOG(PL_ALWAYS, "\n");
     }
-    // (TBD) maintain average of "numErasures" for SEGMENT repair requests
-    //       to use as input to a future automatic "auto parity" adjustor???
     // Update GRTT estimate
     if (receiverRtt >= 0.0)
         SenderUpdateGrttEstimate(receiverRtt);
 
     // Look for NORM-CC Feedback header extension
     NormCCFeedbackExtension ext;
-    while (nack.GetNextExtension(ext))
-    {
-        if (NormHeaderExtension::CC_FEEDBACK == ext.GetType())
-        {
-            SenderHandleCCFeedback(currentTime,
-                                   nack.GetSourceId(),
-                                   ext.GetCCFlags(),
-                                   receiverRtt >= 0.0 ? receiverRtt : NormUnquantizeRtt(ext.GetCCRtt()),
-                                   NormUnquantizeLoss32(ext.GetCCLoss32()), // note using extended precision loss value here
-                                   NormUnquantizeRate(ext.GetCCRate()),
-                                   ext.GetCCSequence());
-        }
-        break;
+    if (nack.FindExtension(NormHeaderExtension::CC_FEEDBACK, ext))
+    {
+        SenderHandleCCFeedback(currentTime,
+                               nack.GetSourceId(),
+                               ext.GetCCFlags(),
+                               receiverRtt >= 0.0 ? receiverRtt : NormUnquantizeRtt(ext.GetCCRtt()),
+                               NormUnquantizeLoss32(ext.GetCCLoss32()), // note using extended precision loss value here
+                               NormUnquantizeRate(ext.GetCCRate()),
+                               ext.GetCCSequence());
+    }
+
+    // Within a NACK aggregation period, applying the same repair content
+    // again changes nothing (repair mask bits, parity counts and repair
+    // minimums are all idempotent) so identical NACKs from a large group
+    // are not re-parsed.  (The GRTT and CC feedback above still count.)
+    bool aggregating = repair_timer.IsActive() && (0 != repair_timer.GetRepeatCount());
+    UINT64 nackDigest = NackDigest(nack);
+    if (aggregating && SenderFindNackDigest(nackDigest))
+    {
+        PLOG(PL_DETAIL, "NormSession::SenderHandleNackMessage() node>%lu skipping duplicate NACK from node>%lu\n",
+             (unsigned long)LocalNodeId(), (unsigned long)nack.GetSourceId());
+        return;
     }
 
     // Parse and process NACK
@@ -3890,7 +6126,7 @@ void NormSession::SenderHandleNackMessage(const struct timeval &currentTime, Nor
                                 object->TxReset(((NormStreamObject *)object)->StreamBufferLo());
                             else
                                 object->TxReset();
-                            if (!tx_pending_mask.Set(nextObjectId))
+                            if (!SenderSetPending(nextObjectId))
                                 PLOG(PL_ERROR, "NormSession::SenderHandleNackMessage() tx_pending_mask.Set(%hu) error (1)\n",
                                      (UINT16)nextObjectId);
                         }
@@ -3990,7 +6226,7 @@ void NormSession::SenderHandleNackMessage(const struct timeval &currentTime, Nor
                         {
                             if (object->TxResetBlocks(nextBlockId, lastBlockId))
                             {
-                                if (!tx_pending_mask.Set(nextObjectId))
+                                if (!SenderSetPending(nextObjectId))
                                     PLOG(PL_ERROR, "NormSession::SenderHandleNackMessage() tx_pending_mask.Set(%hu) error (2)\n",
                                          (UINT16)nextObjectId);
                             }
@@ -4165,13 +6401,14 @@ void NormSession::SenderHandleNackMessage(const struct timeval &currentTime, Nor
                     // With a series of SEGMENT repair requests for a block, "numErasures" will
                     // eventually total the number of missing segments in the block.
                     numErasures += (lastSegmentId - nextSegmentId + 1);
+                    if (adapt_parity) SenderRecordBlockLoss(*block, numErasures - extra_parity);
                     if (holdoff)
                     {
                         if (nextObjectId > txObjectIndex)
                         {
                             if (object->TxUpdateBlock(block, nextSegmentId, lastSegmentId, numErasures))
                             {
-                                if (!tx_pending_mask.Set(nextObjectId))
+                                if (!SenderSetPending(nextObjectId))
                                     PLOG(PL_ERROR, "NormSession::SenderHandleNackMessage() tx_pending_mask.Set(%hu) error (3)\n",
                                          (UINT16)nextObjectId);
                             }
@@ -4276,8 +6513,118 @@ void NormSession::SenderHandleNackMessage(const struct timeval &currentTime, Nor
              (unsigned long)LocalNodeId(), aggregateInterval);
         ActivateTimer(repair_timer);
     }
+    if (repair_timer.IsActive() && (0 != repair_timer.GetRepeatCount()))
+        SenderAddNackDigest(nackDigest);
 } // end NormSession::SenderHandleNackMessage()
 
+// 64-bit FNV-1a hash of the NACK repair content
+UINT64 NormSession::NackDigest(const NormNackMsg& nack)
+{
+    const UINT8* ptr = (const UINT8*)nack.GetRepairContent();
+    UINT16 len = nack.GetRepairContentLength();
+    UINT64 digest = 14695981039346656037ULL;
+    for (UINT16 i = 0; i < len; i++)
+    {
+        digest ^= (UINT64)ptr[i];
+        digest *= 1099511628211ULL;
+    }
+    return ((0 != digest) ? digest : 1);  // (zero marks an empty slot)
+} // end NormSession::NackDigest()
+
+bool NormSession::SenderFindNackDigest(UINT64 digest) const
+{
+    unsigned int index = (unsigned int)digest & (NACK_DIGEST_SIZE - 1);
+    while (0 != nack_digest[index])
+    {
+        if (digest == nack_digest[index]) return true;
+        index = (index + 1) & (NACK_DIGEST_SIZE - 1);
+    }
+    return false;
+} // end NormSession::SenderFindNackDigest()
+
+void NormSession::SenderAddNackDigest(UINT64 digest)
+{
+    // (once half full, further NACKs are just processed as usual)
+    if (nack_digest_count >= (NACK_DIGEST_SIZE / 2)) return;
+    unsigned int index = (unsigned int)digest & (NACK_DIGEST_SIZE - 1);
+    while (0 != nack_digest[index])
+    {
+        if (digest == nack_digest[index]) return;
+        index = (index + 1) & (NACK_DIGEST_SIZE - 1);
+    }
+    nack_digest[index] = digest;
+    nack_digest_count++;
+} // end NormSession::SenderAddNackDigest()
+
+void NormSession::SenderSetAdaptiveParity(bool enable, double targetRepairProb)
+{
+    if (enable && !adapt_parity)
+    {
+        adapt_block_count = 0;
+        memset(adapt_loss_hist, 0, sizeof(adapt_loss_hist));
+    }
+    adapt_parity = enable;
+    if ((targetRepairProb > 0.0) && (targetRepairProb < 1.0))
+        adapt_parity_target = targetRepairProb;
+    else
+        PLOG(PL_WARN, "NormSession::SenderSetAdaptiveParity() invalid target %lf (using %lf)\n",
+                      targetRepairProb, adapt_parity_target);
+} // end NormSession::SenderSetAdaptiveParity()
+
+// "numErasures" is the running count of segments a NACK requests for
+// the block.  The block loss estimate adds the auto parity that was sent
+// (and evidently wasn't enough) and only the largest estimate for a block
+// is kept in the histogram.
+void NormSession::SenderRecordBlockLoss(NormBlock& block, UINT16 numErasures)
+{
+    unsigned int loss = numErasures + block.GetAutoParity();
+    if (loss > ADAPT_LOSS_MAX) loss = ADAPT_LOSS_MAX;
+    UINT16 prevLoss = block.GetNackLoss();
+    if (loss <= prevLoss) return;
+    // (a block NACKed in a previous window may already have been cleared)
+    if ((0 != prevLoss) && (0 != adapt_loss_hist[prevLoss]))
+        adapt_loss_hist[prevLoss]--;
+    adapt_loss_hist[loss]++;
+    block.SetNackLoss((UINT16)loss);
+} // end NormSession::SenderRecordBlockLoss()
+
+UINT16 NormSession::SenderBlockAutoParity()
+{
+    if (adapt_parity && (++adapt_block_count >= ADAPT_PARITY_WINDOW))
+        SenderAdaptParity();
+    return auto_parity;
+} // end NormSession::SenderBlockAutoParity()
+
+// Picks the smallest auto parity for which the fraction of blocks in the
+// window with greater loss is within target.  Blocks that weren't NACKed
+// only tell us their loss was covered by the auto parity in use, so
+// decreases are made one step per window as a probe.
+void NormSession::SenderAdaptParity()
+{
+    unsigned int nackCount = 0;
+    for (unsigned int i = 0; i <= ADAPT_LOSS_MAX; i++)
+        nackCount += adapt_loss_hist[i];
+    unsigned int blockCount = MAX(adapt_block_count, nackCount);
+    unsigned int allowed = (unsigned int)(adapt_parity_target * (double)blockCount);
+    unsigned int parityMax = MIN(nparity, ADAPT_LOSS_MAX);
+    unsigned int autoParity = 0;
+    unsigned int tail = nackCount - adapt_loss_hist[0];  // blocks with loss > autoParity
+    while ((tail > allowed) && (autoParity < parityMax))
+    {
+        autoParity++;
+        tail -= adapt_loss_hist[autoParity];
+    }
+    if (autoParity < auto_parity) autoParity = auto_parity - 1;
+    if (autoParity != auto_parity)
+    {
+        PLOG(PL_DEBUG, "NormSession::SenderAdaptParity() node>%lu auto parity %hu -> %u (%u of %u blocks NACKed)\n",
+                       (unsigned long)LocalNodeId(), auto_parity, autoParity, nackCount, blockCount);
+        auto_parity = autoParity;
+    }
+    adapt_block_count = 0;
+    memset(adapt_loss_hist, 0, sizeof(adapt_loss_hist));
+} // end NormSession::SenderAdaptParity()
+
 void NormSession::ReceiverHandleAckMessage(const NormAckMsg &ack)
 {
     NormSenderNode *theSender = (NormSenderNode *)sender_tree.FindNodeById(ack.GetSenderId());
@@ -4460,6 +6807,8 @@ bool NormSession::SenderSendAppCmd(const char *buffer, unsigned int length, cons
 {
     // Build/immediately send a NORM_CMD(APPLICATION) message
     NormCmdAppMsg appMsg;
+    if (!appMsg.SetBufferSize(NormMsg::ComputeBufferSize(segment_size)))
+        return false;
     appMsg.Init();
     appMsg.SetDestination(address);
     appMsg.SetGrtt(grtt_quantized);
@@ -4704,81 +7053,488 @@ bool NormSession::SenderBuildRepairAdv(NormCmdRepairAdvMsg &cmd)
             PLOG(PL_ERROR, "NormSession::SenderBuildRepairAdv() warning: full msg\n");
         // (TBD) set NORM_REPAIR_ADV_LIMIT flag in this case
     }
-    return true;
-} // end NormSession::SenderBuildRepairAdv()
-
-bool NormSession::OnRepairTimeout(ProtoTimer & /*theTimer*/)
-{
-    tx_repair_pending = false;
-    if (0 != repair_timer.GetRepeatCount())
+    return true;
+} // end NormSession::SenderBuildRepairAdv()
+
+bool NormSession::OnRepairTimeout(ProtoTimer & /*theTimer*/)
+{
+    tx_repair_pending = false;
+    if (0 != repair_timer.GetRepeatCount())
+    {
+        // NACK aggregation period has ended. (incorporate accumulated repair requests)
+        SenderClearNackDigests();
+        PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu sender NACK aggregation time ended.\n",
+             (unsigned long)LocalNodeId());
+        NormObjectTable::Iterator iterator(tx_table);
+        NormObject *obj;
+        while ((obj = iterator.GetNextObject()))
+        {
+            NormObjectId objectId = obj->GetId();
+            if (tx_repair_mask.Test(objectId))
+            {
+                PLOG(PL_TRACE, "NormSession::OnRepairTimeout() node>%lu tx reset obj>%hu ...\n",
+                     (unsigned long)LocalNodeId(), (UINT16)objectId);
+                if (obj->IsStream())
+                    obj->TxReset(((NormStreamObject *)obj)->RepairWindowLo());
+                else
+                    obj->TxReset();
+                tx_repair_mask.Unset(objectId);
+                if (!SenderSetPending(objectId))
+                {
+                    PLOG(PL_ERROR, "NormSession::OnRepairTimeout() tx_pending_mask.Set(%hu) error (1)\n",
+                         (UINT16)objectId);
+                }
+            }
+            else
+            {
+                PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu activating obj>%hu repairs ...\n",
+                     (unsigned long)LocalNodeId(), (UINT16)objectId);
+                if (obj->ActivateRepairs())
+                {
+                    PLOG(PL_TRACE, "NormSession::OnRepairTimeout() node>%lu activated obj>%hu repairs ...\n",
+                         (unsigned long)LocalNodeId(), (UINT16)objectId);
+                    if (!SenderSetPending(objectId))
+                        PLOG(PL_ERROR, "NormSession::OnRepairTimeout() node>%lu tx_pending_mask.Set(%hu) error (2)\n",
+                             (unsigned long)LocalNodeId(), (UINT16)objectId);
+                }
+            }
+        } // end while (iterator.GetNextObject())
+        PromptSender();
+        // BACKOFF related code
+        // Holdoff initiation of new repair cycle for one GRTT
+        // (TBD) for unicast sessions, use CLR RTT ???
+        //double holdoffInterval = backoff_factor > 0.0 ? grtt_advertised : 0.0;
+        double holdoffInterval = grtt_advertised;
+        repair_timer.SetInterval(holdoffInterval); // repair holdoff interval = 1*GRTT
+        PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu starting sender "
+                       "NACK holdoff timer (%lf sec)...\n",
+             (unsigned long)LocalNodeId(), holdoffInterval);
+    }
+    else
+    {
+        // REPAIR holdoff interval has now ended.
+        PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu sender holdoff time ended.\n",
+             (unsigned long)LocalNodeId());
+    }
+    return true;
+} // end NormSession::OnRepairTimeout()
+
+bool NormSession::SetTxBatchSize(unsigned int batchSize)
+{
+    if (!tx_batch.IsEmpty() && tx_socket->IsOpen())
+        tx_batch.Flush(*tx_socket);
+    return tx_batch.Init(batchSize);
+} // end NormSession::SetTxBatchSize()
+
+bool NormSession::SetTxZeroCopy(bool enable)
+{
+#ifdef NORM_TX_ZEROCOPY
+    tx_zero_copy = enable;
+    if (!enable)
+        tx_zero_copy_sock = false;  // (any queued references are sent w/ plain sendmsg())
+    else if (tx_socket->IsOpen())
+        EnableTxZeroCopy();
+    return true;
+#else
+    PLOG(PL_ERROR, "NormSession::SetTxZeroCopy() error: not supported on this platform\n");
+    return false;
+#endif // if/else NORM_TX_ZEROCOPY
+} // end NormSession::SetTxZeroCopy()
+
+bool NormSession::SetTxTimePacing(bool enable, bool taiClock)
+{
+#ifdef NORM_TX_TIME
+    tx_time_pacing = enable;
+    tx_time_tai = taiClock;
+    tx_time_next = 0;
+    if (!enable)
+        tx_time_sock = false;  // (SO_TXTIME is harmless without SCM_TXTIME stamps)
+    else if (tx_socket->IsOpen())
+        EnableTxTimePacing();
+    return true;
+#else
+    PLOG(PL_ERROR, "NormSession::SetTxTimePacing() error: not supported on this platform\n");
+    return false;
+#endif // if/else NORM_TX_TIME
+} // end NormSession::SetTxTimePacing()
+
+void NormSession::SenderCopyPayloadRefs(const char* base, size_t len)
+{
+    NormMsg *msg = message_queue.GetHead();
+    while (NULL != msg)
+    {
+        const char* ref = msg->GetPayloadRef();
+        if ((NULL != ref) && (ref >= base) && (ref < (base + len)))
+            msg->CopyPayloadRef();
+        msg = msg->GetNext();
+    }
+} // end NormSession::SenderCopyPayloadRefs()
+
+#ifdef NORM_TX_ZEROCOPY
+void NormSession::EnableTxZeroCopy()
+{
+    tx_zero_copy_sock = false;
+#ifdef SO_ZEROCOPY
+    int enable = 1;
+    if (0 == setsockopt(tx_socket->GetHandle(), SOL_SOCKET, SO_ZEROCOPY, &enable, sizeof(enable)))
+        tx_zero_copy_sock = true;
+    else
+        PLOG(PL_INFO, "NormSession::EnableTxZeroCopy() SO_ZEROCOPY not supported: %s (using sendmsg() copy)\n",
+                      GetErrorString());
+#endif // SO_ZEROCOPY
+} // end NormSession::EnableTxZeroCopy()
+
+// Sends a NORM_DATA message header from its buffer and the payload in
+// place with a single sendmsg() (the same "numBytes" semantics as SendTo())
+bool NormSession::ZeroCopySendTo(const NormMsg& msg, unsigned int& numBytes)
+{
+    UINT16 headerLength = msg.GetHeaderLength();
+    struct iovec iov[2];
+    iov[0].iov_base = (void*)msg.GetBuffer();
+    iov[0].iov_len = headerLength;
+    iov[1].iov_base = (void*)msg.GetPayloadRef();
+    iov[1].iov_len = numBytes - headerLength;
+    const ProtoAddress& dstAddr = msg.GetDestination();
+    struct msghdr hdr;
+    memset(&hdr, 0, sizeof(hdr));
+    hdr.msg_name = (void*)&dstAddr.GetSockAddr();
+    hdr.msg_namelen = (ProtoAddress::IPv6 == dstAddr.GetType()) ? 
+                            sizeof(struct sockaddr_in6) : sizeof(struct sockaddr_in);
+    hdr.msg_iov = iov;
+    hdr.msg_iovlen = 2;
+    int flags = 0;
+#ifdef MSG_ZEROCOPY
+    if (tx_zero_copy_sock) flags |= MSG_ZEROCOPY;
+#endif // MSG_ZEROCOPY
+    ssize_t result = sendmsg(tx_socket->GetHandle(), &hdr, flags);
+    if (result < 0)
+    {
+        if ((EAGAIN == errno) || (EWOULDBLOCK == errno) || (ENOBUFS == errno) || (EINTR == errno))
+        {
+            // (too many outstanding notifications can also cause ENOBUFS)
+            if (tx_zero_copy_reap) TxZeroCopyReap();
+            numBytes = 0;
+            return true;  // "blocked"
+        }
+        return false;
+    }
+    if (0 != flags) tx_zero_copy_reap = true;
+    numBytes = (unsigned int)result;
+    return true;
+} // end NormSession::ZeroCopySendTo()
+
+void NormSession::TxZeroCopyReap()
+{
+    // The kernel coalesces notifications, so there are usually few to read.
+    // We don't need them to reclaim buffers (referenced file content is
+    // read-only), but if the kernel had to copy anyway (e.g. the NIC lacks
+    // scatter-gather), MSG_ZEROCOPY only adds overhead so it's disabled
+    char control[128];
+    while (true)
+    {
+        struct msghdr hdr;
+        memset(&hdr, 0, sizeof(hdr));
+        hdr.msg_control = control;
+        hdr.msg_controllen = sizeof(control);
+        if (recvmsg(tx_socket->GetHandle(), &hdr, MSG_ERRQUEUE | MSG_DONTWAIT) < 0)
+            break;
+#ifdef SO_EE_ORIGIN_ZEROCOPY
+        for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&hdr); NULL != cmsg; cmsg = CMSG_NXTHDR(&hdr, cmsg))
+        {
+            const struct sock_extended_err* err = (const struct sock_extended_err*)CMSG_DATA(cmsg);
+            if ((SO_EE_ORIGIN_ZEROCOPY == err->ee_origin) && (0 != (err->ee_code & SO_EE_CODE_ZEROCOPY_COPIED)))
+            {
+                PLOG(PL_INFO, "NormSession::TxZeroCopyReap() kernel copied data, disabling MSG_ZEROCOPY\n");
+                tx_zero_copy_sock = false;
+            }
+        }
+#endif // SO_EE_ORIGIN_ZEROCOPY
+    }
+} // end NormSession::TxZeroCopyReap()
+#endif // NORM_TX_ZEROCOPY
+
+void NormSession::SetBusyPoll(unsigned int usec)
+{
+    busy_poll_usec = usec;
+    if (rx_socket.IsOpen()) EnableBusyPoll(rx_socket);
+    if ((tx_socket != &rx_socket) && tx_socket->IsOpen()) EnableBusyPoll(*tx_socket);
+} // end NormSession::SetBusyPoll()
+
+void NormSession::EnableBusyPoll(ProtoSocket& theSocket)
+{
+#if defined(SO_BUSY_POLL) && !defined(SIMULATE)
+    int usec = (int)busy_poll_usec;
+    // (values above the "net.core.busy_read" sysctl need CAP_NET_ADMIN)
+    if (0 != setsockopt(theSocket.GetHandle(), SOL_SOCKET, SO_BUSY_POLL, &usec, sizeof(usec)))
+        PLOG(PL_INFO, "NormSession::EnableBusyPoll() SO_BUSY_POLL error: %s (polling without it)\n",
+                      GetErrorString());
+#endif // SO_BUSY_POLL && !SIMULATE
+} // end NormSession::EnableBusyPoll()
+
+// Receive sharding steers each message by NORM node id: the message source id,
+// except for NACK and ACK messages, which go by the sender id they are addressed
+// to (so feedback suppression state stays with the sender's NormSenderNode).
+// Multicast datagrams are delivered to every socket bound to the group, so each
+// shard's socket filter keeps only its own share.  Unicast datagrams are
+// delivered to one socket of the SO_REUSEPORT group, picked by the reuseport
+// program as an index into the group's sockets in the order they were bound
+// (which is why shards must be opened in "shardIndex" order).  A socket filter
+// sees the UDP header while a reuseport program sees just the UDP payload.
+bool NormSession::EnableRxShard(bool isBound)
+{
+#if defined(__linux__) && !defined(SIMULATE) && defined(SO_ATTACH_REUSEPORT_CBPF)
+    if (!isBound)
+    {
+        int enable = 1;
+        if (0 != setsockopt(rx_socket.GetHandle(), SOL_SOCKET, SO_REUSEPORT, &enable, sizeof(enable)))
+        {
+            PLOG(PL_FATAL, "NormSession::EnableRxShard() SO_REUSEPORT error: %s\n", GetErrorString());
+            return false;
+        }
+        return true;
+    }
+    enum {UDP_HDR_LEN = 8};
+    struct sock_filter shardFilter[] =
+    {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, UDP_HDR_LEN),                     // NORM version/type
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0x0f),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, NormMsg::NACK, 3, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, NormMsg::ACK, 2, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, UDP_HDR_LEN + 4),                 // source id
+        BPF_STMT(BPF_JMP | BPF_JA, 1),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, UDP_HDR_LEN + 8),                 // NACK/ACK sender id
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, rx_shard_count),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, rx_shard_index, 0, 1),
+        BPF_STMT(BPF_RET | BPF_K, 0xffffffff),                               // accept
+        BPF_STMT(BPF_RET | BPF_K, 0)                                         // drop
+    };
+    struct sock_filter reusePortFilter[] =
+    {
+        BPF_STMT(BPF_LD | BPF_B | BPF_ABS, 0),
+        BPF_STMT(BPF_ALU | BPF_AND | BPF_K, 0x0f),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, NormMsg::NACK, 3, 0),
+        BPF_JUMP(BPF_JMP | BPF_JEQ | BPF_K, NormMsg::ACK, 2, 0),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 4),
+        BPF_STMT(BPF_JMP | BPF_JA, 1),
+        BPF_STMT(BPF_LD | BPF_W | BPF_ABS, 8),
+        BPF_STMT(BPF_ALU | BPF_MOD | BPF_K, rx_shard_count),
+        BPF_STMT(BPF_RET | BPF_A, 0)                                         // socket index
+    };
+    struct sock_fprog prog;
+    prog.len = sizeof(shardFilter) / sizeof(struct sock_filter);
+    prog.filter = shardFilter;
+    if (0 != setsockopt(rx_socket.GetHandle(), SOL_SOCKET, SO_ATTACH_FILTER, &prog, sizeof(prog)))
+    {
+        PLOG(PL_FATAL, "NormSession::EnableRxShard() SO_ATTACH_FILTER error: %s\n", GetErrorString());
+        return false;
+    }
+    // (every shard attaches the same reuseport program to the group)
+    prog.len = sizeof(reusePortFilter) / sizeof(struct sock_filter);
+    prog.filter = reusePortFilter;
+    if (0 != setsockopt(rx_socket.GetHandle(), SOL_SOCKET, SO_ATTACH_REUSEPORT_CBPF, &prog, sizeof(prog)))
+    {
+        PLOG(PL_FATAL, "NormSession::EnableRxShard() SO_ATTACH_REUSEPORT_CBPF error: %s\n", GetErrorString());
+        return false;
+    }
+    PLOG(PL_INFO, "NormSession::EnableRxShard() node>%lu receive shard %u of %u\n",
+                  (unsigned long)LocalNodeId(), rx_shard_index, rx_shard_count);
+    return true;
+#else
+    return false;
+#endif // if/else __linux__ && !SIMULATE && SO_ATTACH_REUSEPORT_CBPF
+} // end NormSession::EnableRxShard()
+
+bool NormSession::SetRxTimestamps(bool enable)
+{
+#if defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMP) && !defined(SIMULATE)
+    rx_timestamps = enable;
+    if (!enable) return true;  // (option left set on open sockets, but unused)
+    bool result = rx_socket.IsOpen() ? EnableRxTimestamps(rx_socket) : true;
+    if ((tx_socket != &rx_socket) && tx_socket->IsOpen())
+        result &= EnableRxTimestamps(*tx_socket);
+    if (!result) rx_timestamps = false;
+    return result;
+#else
+    if (!enable) return true;
+    PLOG(PL_ERROR, "NormSession::SetRxTimestamps() error: receive timestamps not supported\n");
+    return false;
+#endif // if/else SO_TIMESTAMPNS && SIOCGSTAMP && !SIMULATE
+} // end NormSession::SetRxTimestamps()
+
+bool NormSession::EnableRxTimestamps(ProtoSocket& theSocket)
+{
+#if defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMP) && !defined(SIMULATE)
+    int enable = 1;
+    if (0 != setsockopt(theSocket.GetHandle(), SOL_SOCKET, SO_TIMESTAMPNS, &enable, sizeof(enable)))
+    {
+        PLOG(PL_ERROR, "NormSession::EnableRxTimestamps() SO_TIMESTAMPNS error: %s\n", GetErrorString());
+        return false;
+    }
+    return true;
+#else
+    return false;
+#endif // if/else SO_TIMESTAMPNS && SIOCGSTAMP && !SIMULATE
+} // end NormSession::EnableRxTimestamps()
+
+// For the recvfrom() (not batched) receive paths: gets the kernel receive time 
+// of the datagram just read.  This costs a system call, so it is only done for
+// the messages that carry RTT timing (CMD, NACK and ACK messages).
+bool NormSession::GetRxTimestamp(ProtoSocket& theSocket, const NormMsg& msg, struct timeval& rxTime)
+{
+#if defined(SO_TIMESTAMPNS) && defined(SIOCGSTAMP) && !defined(SIMULATE)
+    if (!rx_timestamps) return false;
+    switch (msg.GetType())
+    {
+        case NormMsg::CMD:
+        case NormMsg::NACK:
+        case NormMsg::ACK:
+            return (0 == ioctl(theSocket.GetHandle(), SIOCGSTAMP, &rxTime));
+        default:
+            return false;
+    }
+#else
+    return false;
+#endif // if/else SO_TIMESTAMPNS && SIOCGSTAMP && !SIMULATE
+} // end NormSession::GetRxTimestamp()
+
+// The socket handlers read until the (non-blocking) sockets are empty,
+// so they are simply called whether or not anything is ready
+void NormSession::PollSockets()
+{
+    if (rx_socket.IsOpen()) 
+        RxSocketRecvHandler(rx_socket, ProtoSocket::RECV);
+    if ((tx_socket != &rx_socket) && tx_socket->IsOpen())
+        TxSocketRecvHandler(*tx_socket, ProtoSocket::RECV);
+} // end NormSession::PollSockets()
+
+#ifdef NORM_TX_TIME
+void NormSession::EnableTxTimePacing()
+{
+    tx_time_sock = false;
+#ifdef SO_TXTIME
+    struct sock_txtime txTime;
+    memset(&txTime, 0, sizeof(txTime));
+    txTime.clockid = CLOCK_MONOTONIC;  // (what the "fq" qdisc uses)
+#ifdef CLOCK_TAI
+    if (tx_time_tai) txTime.clockid = CLOCK_TAI;
+#endif // CLOCK_TAI
+    if (0 == setsockopt(tx_socket->GetHandle(), SOL_SOCKET, SO_TXTIME, &txTime, sizeof(txTime)))
+    {
+        tx_time_sock = true;
+        tx_time_next = 0;
+    }
+    else
+    {
+        PLOG(PL_WARN, "NormSession::EnableTxTimePacing() SO_TXTIME error: %s (using timer pacing only)\n",
+                      GetErrorString());
+    }
+#else
+    PLOG(PL_WARN, "NormSession::EnableTxTimePacing() SO_TXTIME not supported (using timer pacing only)\n");
+#endif // if/else SO_TXTIME
+} // end NormSession::EnableTxTimePacing()
+
+UINT64 NormSession::TxTimeNow() const
+{
+    struct timespec now;
+    clockid_t clockId = CLOCK_MONOTONIC;
+#ifdef CLOCK_TAI
+    if (tx_time_tai) clockId = CLOCK_TAI;
+#endif // CLOCK_TAI
+    clock_gettime(clockId, &now);
+    return ((UINT64)now.tv_sec * 1000000000 + (UINT64)now.tv_nsec);
+} // end NormSession::TxTimeNow()
+#endif // NORM_TX_TIME
+
+NormSendBatch::FlushStatus NormSession::FlushTxBatch()
+{
+    NormSendBatch::FlushStatus status = tx_batch.Flush(*tx_socket);
+    if (NormSendBatch::FLUSH_FAILED == status)
+    {
+        if (!posted_send_error)
+        {
+            posted_send_error = true;
+            Notify(NormController::SEND_ERROR, NULL, NULL);
+        }
+    }
+    return status;
+} // end NormSession::FlushTxBatch()
+
+// When tx batching is enabled, each tx_timer timeout queues a "burst" of
+// messages (up to the batch size or TX_BATCH_QUANTUM worth of pacing
+// interval) and sends them with one system call.  The timer interval is
+// then the sum of the burst's message intervals so the average rate holds.
+// With tx time pacing, each message is also stamped with its departure
+// time (the previous one's plus its pacing interval) so the qdisc spreads
+// the burst out on the wire.
+bool NormSession::OnTxTimeout(ProtoTimer & /*theTimer*/)
+{
+    if (!tx_batch.IsEnabled())
+    {
+        bool result = TxSendNext();
+#ifdef NORM_XDP
+        if (NULL != xdp_socket)
+            xdp_socket->Flush();
+#endif // NORM_XDP
+        return result;
+    }
+    // Finish sending any "blocked" remainder of the previous burst first
+    if (!tx_batch.IsEmpty() && (NormSendBatch::FLUSH_BLOCKED == FlushTxBatch()))
+    {
+        if (tx_timer.IsActive())
+            tx_timer.Deactivate();
+        tx_socket->StartOutputNotification();
+        return false;
+    }
+    bool result = true;
+    double burstInterval = 0.0;
+#ifdef NORM_TX_TIME
+    if (tx_time_sock)
     {
-        // NACK aggregation period has ended. (incorporate accumulated repair requests)
-        PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu sender NACK aggregation time ended.\n",
-             (unsigned long)LocalNodeId());
-        NormObjectTable::Iterator iterator(tx_table);
-        NormObject *obj;
-        while ((obj = iterator.GetNextObject()))
-        {
-            NormObjectId objectId = obj->GetId();
-            if (tx_repair_mask.Test(objectId))
-            {
-                PLOG(PL_TRACE, "NormSession::OnRepairTimeout() node>%lu tx reset obj>%hu ...\n",
-                     (unsigned long)LocalNodeId(), (UINT16)objectId);
-                if (obj->IsStream())
-                    obj->TxReset(((NormStreamObject *)obj)->RepairWindowLo());
-                else
-                    obj->TxReset();
-                tx_repair_mask.Unset(objectId);
-                if (!tx_pending_mask.Set(objectId))
-                {
-                    PLOG(PL_ERROR, "NormSession::OnRepairTimeout() tx_pending_mask.Set(%hu) error (1)\n",
-                         (UINT16)objectId);
-                }
-            }
-            else
-            {
-                PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu activating obj>%hu repairs ...\n",
-                     (unsigned long)LocalNodeId(), (UINT16)objectId);
-                if (obj->ActivateRepairs())
-                {
-                    PLOG(PL_TRACE, "NormSession::OnRepairTimeout() node>%lu activated obj>%hu repairs ...\n",
-                         (unsigned long)LocalNodeId(), (UINT16)objectId);
-                    if (!tx_pending_mask.Set(objectId))
-                        PLOG(PL_ERROR, "NormSession::OnRepairTimeout() node>%lu tx_pending_mask.Set(%hu) error (2)\n",
-                             (unsigned long)LocalNodeId(), (UINT16)objectId);
-                }
-            }
-        } // end while (iterator.GetNextObject())
-        PromptSender();
-        // BACKOFF related code
-        // Holdoff initiation of new repair cycle for one GRTT
-        // (TBD) for unicast sessions, use CLR RTT ???
-        //double holdoffInterval = backoff_factor > 0.0 ? grtt_advertised : 0.0;
-        double holdoffInterval = grtt_advertised;
-        repair_timer.SetInterval(holdoffInterval); // repair holdoff interval = 1*GRTT
-        PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu starting sender "
-                       "NACK holdoff timer (%lf sec)...\n",
-             (unsigned long)LocalNodeId(), holdoffInterval);
+        // Continue spacing from the previous burst unless we've fallen behind
+        UINT64 currentTime = TxTimeNow();
+        if (tx_time_next < currentTime) tx_time_next = currentTime;
     }
-    else
+#endif // NORM_TX_TIME
+    tx_batching = true;
+    while (!tx_batch.IsFull())
     {
-        // REPAIR holdoff interval has now ended.
-        PLOG(PL_DEBUG, "NormSession::OnRepairTimeout() node>%lu sender holdoff time ended.\n",
-             (unsigned long)LocalNodeId());
+        tx_timer.SetInterval(0.0);
+        if (!(result = TxSendNext())) break;  // nothing left to send (or blocked)
+        double msgInterval = tx_timer.GetInterval();
+        burstInterval += msgInterval;
+#ifdef NORM_TX_TIME
+        if (tx_time_sock) tx_time_next += (UINT64)(msgInterval * 1.0e+09);
+#endif // NORM_TX_TIME
+        if (burstInterval >= TX_BATCH_QUANTUM) break;
+    }
+    tx_batching = false;
+#ifdef NORM_XDP
+    if (NULL != xdp_socket)
+        xdp_socket->Flush();
+#endif // NORM_XDP
+    if (!tx_batch.IsEmpty() && (NormSendBatch::FLUSH_BLOCKED == FlushTxBatch()))
+    {
+        if (tx_timer.IsActive())
+            tx_timer.Deactivate();
+        tx_socket->StartOutputNotification();
+        return false;
     }
-    return true;
-} // end NormSession::OnRepairTimeout()
+    if (result)
+        tx_timer.SetInterval(burstInterval);
+    return result;
+} // end NormSession::OnTxTimeout()
 
 // (TBD) Should pass current system time to ProtoTimer timeout handlers
 //       for more efficiency ...
-bool NormSession::OnTxTimeout(ProtoTimer & /*theTimer*/)
+bool NormSession::TxSendNext()
 {
     NormMsg *msg;
 
     // Note: sometimes need RepairAdv even when cc_enable is false ...
     NormCmdRepairAdvMsg adv;
     if (advertise_repairs && (probe_proactive || (repair_timer.IsActive() &&
-                                                  repair_timer.GetRepeatCount())))
+                                                  repair_timer.GetRepeatCount())) &&
+        adv.SetBufferSize(NormMsg::ComputeBufferSize(segment_size)))
     {
         // Build a NORM_CMD(NACK_ADV) in response to
         // receipt of unicast NACK or CC update
@@ -4839,7 +7595,14 @@ bool NormSession::OnTxTimeout(ProtoTimer & /*theTimer*/)
         {
             case MSG_SEND_OK:
                 if (tx_rate > 0.0)
-                    tx_timer.SetInterval(GetTxInterval(msgLength, tx_rate));
+                    tx_timer.SetInterval(GetTxInterval(msgLength, tx_rate * tx_layer_scale));
+                if (session_mgr.GetTxRateBudget() > 0.0)
+                {
+                    // (the instance-wide budget only ever slows the session down)
+                    double budgetInterval = session_mgr.DrawTxBudget(*this, msgLength);
+                    if ((tx_rate <= 0.0) || (budgetInterval > tx_timer.GetInterval()))
+                        tx_timer.SetInterval(budgetInterval);
+                }
                 if (advertise_repairs)
                 {
                     advertise_repairs = false;
@@ -4863,6 +7626,15 @@ bool NormSession::OnTxTimeout(ProtoTimer & /*theTimer*/)
                     message_queue.Prepend(msg);
                 if (tx_timer.IsActive())
                     tx_timer.Deactivate();
+#ifdef NORM_XDP
+                if (xdp_blocked)
+                {
+                    // (tx_socket is always writable, so wait on the XDP socket)
+                    xdp_blocked = false;
+                    xdp_socket->StartOutputNotification();
+                    return false;
+                }
+#endif // NORM_XDP
                 tx_socket->StartOutputNotification();
                 return false; // since timer was deactivated
 
@@ -4872,7 +7644,7 @@ bool NormSession::OnTxTimeout(ProtoTimer & /*theTimer*/)
                 if (!advertise_repairs)
                     message_queue.Prepend(msg);
                 if (tx_rate > 0.0)
-                    tx_timer.SetInterval(GetTxInterval(msgLength, tx_rate));
+                    tx_timer.SetInterval(GetTxInterval(msgLength, tx_rate * tx_layer_scale));
                 else if (0.0 == tx_timer.GetInterval())
                     tx_timer.SetInterval(0.001);
                 return true; // timer will be reactivated
@@ -4897,11 +7669,11 @@ bool NormSession::OnTxTimeout(ProtoTimer & /*theTimer*/)
         else
         {
             // We have a new message as a result of serving, so send it immediately
-            return OnTxTimeout(tx_timer);
+            return TxSendNext();
         }
     }
     return true; // actually will never get here but compiler thinks it's needed
-} // end NormSession::OnTxTimeout()
+} // end NormSession::TxSendNext()
 
 NormSession::MessageStatus NormSession::SendMessage(NormMsg &msg)
 {
@@ -4921,7 +7693,21 @@ NormSession::MessageStatus NormSession::SendMessage(NormMsg &msg)
         {
             NormObjectMsg &objMsg = static_cast<NormObjectMsg &>(msg);
             objMsg.SetInstanceId(instId);
-            msg.SetSequence(tx_sequence++); // (TBD) set for session dst msgs
+            // (only fresh DATA is spread over the layers, see AddTxLayer())
+            unsigned int layer = 0;
+            if ((tx_layer_count > 1) && (NormMsg::DATA == msg.GetType()) && 
+                !SenderMsgIsRepair(static_cast<NormDataMsg&>(msg)))
+                layer = SelectTxLayer();
+            if (0 != layer)
+            {
+                // Each layer has its own sequence space for its receivers' loss measurement
+                msg.SetDestination(tx_layer_addr[layer]);
+                msg.SetSequence(tx_layer_seq[layer]++);
+            }
+            else
+            {
+                msg.SetSequence(tx_sequence++); // (TBD) set for session dst msgs
+            }
             if (syn_status)
                 objMsg.SetFlag(NormObjectMsg::FLAG_SYN);
             break;
@@ -5012,6 +7798,10 @@ NormSession::MessageStatus NormSession::SendMessage(NormMsg &msg)
     // Fill in common message fields
     msg.SetSourceId(local_node_id);
     UINT16 msgSize = msg.GetLength();
+#ifdef NORM_NO_TRACE
+    (void)fecM;  // (only the message trace needs these)
+    (void)instId;
+#endif // NORM_NO_TRACE
     // Possibly drop some tx messages for testing purposes
 
     bool drop = (tx_loss_rate > 0.0) ? (UniformRand(100.0) < tx_loss_rate) : false;
@@ -5029,29 +7819,83 @@ NormSession::MessageStatus NormSession::SendMessage(NormMsg &msg)
     {
         //DMSG(0, "TX MESSAGE DROPPED! (tx_loss_rate:%lf\n", tx_loss_rate);
         // "Pretend" like dropped message was sent for trace and timing purposes
-        if (trace)
+#ifndef NORM_NO_TRACE
+        if (trace || trace_ring.IsOpen())
         {
             struct timeval currentTime;
             ProtoSystemTime(currentTime);
-            NormTrace(currentTime, LocalNodeId(), msg, true, fecM, instId);
+            if (trace) NormTrace(currentTime, LocalNodeId(), msg, true, fecM, instId);
+            trace_ring.Add(currentTime, msg, true, fecM, instId);
         }
+#endif // !NORM_NO_TRACE
         // Update sent rate tracker even if dropped (for testing/debugging)
         sent_accumulator.Increment(msgSize);
         nominal_packet_size += 0.01 * (((double)msgSize) - nominal_packet_size);
     }
     else
     {
-        unsigned int numBytes = msgSize;
+        // With AEAD, a sealed copy is sent and "msg" is left clear (for the
+        // trace and since a blocked message is sent again later)
+        const char* txBuffer = msg.GetBuffer();
+        unsigned int txLength = msgSize;
+        if (aead.IsKeySet())
+        {
+            msg.CopyPayloadRef();  // (so no zero-copy send below)
+            txLength = SealMessage(msg);
+            txBuffer = aead_buffer;
+        }
+        unsigned int numBytes = txLength;
         bool result;
+        // (only sender DATA messages are striped over multiple tx paths)
+        unsigned int pathIndex = ((tx_path_count > 1) && (NormMsg::DATA == msg.GetType())) ? SelectTxPath() : 0;
+        if (0 != pathIndex)
+        {
+            msg.CopyPayloadRef();
+            result = tx_path_list[pathIndex]->socket.SendTo(txBuffer, numBytes, msg.GetDestination());
+        }
+        else
 #ifdef ECN_SUPPORT
         if (sendRaw)
-            result = RawSendTo(msg.GetBuffer(), numBytes, msg.GetDestination(), probe_tos);
+        {
+            // (send any batched messages first to preserve ordering)
+            if (tx_batching && !tx_batch.IsEmpty())
+                FlushTxBatch();
+            msg.CopyPayloadRef();
+            result = RawSendTo(txBuffer, numBytes, msg.GetDestination(), probe_tos);
+        }
         else
 #endif // ECN_SUPPORT
-            result = tx_socket->SendTo(msg.GetBuffer(), numBytes, msg.GetDestination());
+#ifdef NORM_XDP
+        if ((NULL != xdp_socket) && xdp_src_addr.IsValid() && msg.GetDestination().IsMulticast() &&
+            (ProtoAddress::IPv4 == msg.GetDestination().GetType()))
+        {
+            msg.CopyPayloadRef();  // (the frame is built in UMEM anyway)
+            result = XdpSendTo(txBuffer, numBytes, msg.GetDestination());
+        }
+        else
+#endif // NORM_XDP
+        if (tx_batching)
+        {
+            msg.CopyPayloadRef();
+#ifdef NORM_TX_TIME
+            UINT64 txTime = tx_time_sock ? tx_time_next : 0;
+#else
+            UINT64 txTime = 0;
+#endif // if/else NORM_TX_TIME
+            result = tx_batch.Queue(txBuffer, numBytes, msg.GetDestination(), txTime);
+        }
+#ifdef NORM_TX_ZEROCOPY
+        else if (NULL != msg.GetPayloadRef())
+            result = ZeroCopySendTo(msg, numBytes);
+#endif // NORM_TX_ZEROCOPY
+        else
+        {
+            msg.CopyPayloadRef();
+            result = tx_socket->SendTo(txBuffer, numBytes, msg.GetDestination());
+        }
         if (result)
         {
-            if (numBytes == msgSize)
+            if (numBytes == txLength)
             {
                 if (posted_send_error)
                 {
@@ -5060,14 +7904,27 @@ NormSession::MessageStatus NormSession::SendMessage(NormMsg &msg)
                     Notify(NormController::SEND_OK, NULL, NULL);
                 }
                 // Separate send/recv tracing
-                if (trace)
+#ifndef NORM_NO_TRACE
+                if (trace || trace_ring.IsOpen())
                 {
                     struct timeval currentTime;
                     ProtoSystemTime(currentTime);
-                    NormTrace(currentTime, LocalNodeId(), msg, true, fecM, instId);
+                    if (trace) NormTrace(currentTime, LocalNodeId(), msg, true, fecM, instId);
+                    trace_ring.Add(currentTime, msg, true, fecM, instId);
                 }
+#endif // !NORM_NO_TRACE
                 // To keep track of _actual_ sent rate
                 sent_accumulator.Increment(msgSize);
+                tx_stat_bytes += msgSize;
+                if (NormMsg::DATA == msg.GetType())
+                {
+                    tx_stat_segments++;
+                    if (static_cast<NormObjectMsg &>(msg).FlagIsSet(NormObjectMsg::FLAG_REPAIR))
+                    {
+                        tx_stat_repair_bytes += msgSize;
+                        NORM_PROBE2(tx_repair, (UINT16)static_cast<NormObjectMsg &>(msg).GetObjectId(), msgSize);
+                    }
+                }
                 // Update nominal packet size
                 nominal_packet_size += 0.01 * (((double)msgSize) - nominal_packet_size);
             }
@@ -5121,6 +7978,130 @@ NormSession::MessageStatus NormSession::SendMessage(NormMsg &msg)
     return MSG_SEND_OK;
 } // end NormSession::SendMessage()
 
+bool NormSession::SetAeadKey(const char* key, unsigned int keyLength)
+{
+    if (NULL == key)
+    {
+        aead.ClearKey();
+        return true;
+    }
+    if (NormAead::KEY_SIZE != keyLength)
+    {
+        PLOG(PL_ERROR, "NormSession::SetAeadKey() error: key must be %u bytes\n", (unsigned int)NormAead::KEY_SIZE);
+        return false;
+    }
+    if (NULL == aead_buffer)
+    {
+        if (NULL == (aead_buffer = new char[NormMsg::MAX_SIZE + AEAD_OVERHEAD]))
+        {
+            PLOG(PL_FATAL, "NormSession::SetAeadKey() new aead_buffer error: %s\n", GetErrorString());
+            return false;
+        }
+    }
+    // Nonces are our node id and a counter started at the current time in
+    // usec, so a restarted session doesn't reuse them with the same key
+    // (unless the system clock is set back)
+    struct timeval currentTime;
+    ProtoSystemTime(currentTime);
+    aead_counter = (UINT64)currentTime.tv_sec * 1000000 + (UINT64)currentTime.tv_usec;
+    aead.SetKey((const UINT8*)key);
+    return true;
+} // end NormSession::SetAeadKey()
+
+// The sealed message is the clear NORM header (authenticated as the AEAD
+// "associated data"), the encrypted payload and then the 64-bit nonce
+// counter and tag.  The nonce is the header source id and the counter.
+unsigned int NormSession::SealMessage(const NormMsg& msg)
+{
+    unsigned int hdrLen = msg.GetHeaderLength();
+    unsigned int msgLen = msg.GetLength();
+    UINT8* buffer = (UINT8*)aead_buffer;
+    memcpy(buffer, msg.GetBuffer(), msgLen);
+    UINT64 counter = aead_counter++;
+    UINT8* trailer = buffer + msgLen;
+    for (int i = 7; i >= 0; i--)
+    {
+        trailer[i] = (UINT8)counter;
+        counter >>= 8;
+    }
+    UINT8 nonce[NormAead::NONCE_SIZE];
+    memcpy(nonce, buffer + 4, 4);  // (source id, already network byte order)
+    memcpy(nonce + 4, trailer, 8);
+    aead.Seal(nonce, buffer, hdrLen, buffer + hdrLen, msgLen - hdrLen, trailer + 8);
+    return (msgLen + AEAD_OVERHEAD);
+} // end NormSession::SealMessage()
+
+bool NormSession::OpenMessage(NormMsg& msg)
+{
+    unsigned int hdrLen = msg.GetHeaderLength();
+    unsigned int msgLen = msg.GetLength();
+    if (msgLen < (hdrLen + AEAD_OVERHEAD))
+    {
+        rx_stat_auth_failures++;
+        PLOG(PL_DEBUG, "NormSession::OpenMessage() node>%lu message from %s too short\n",
+             (unsigned long)LocalNodeId(), msg.GetSource().GetHostString());
+        return false;
+    }
+    msgLen -= AEAD_OVERHEAD;
+    UINT8* buffer = (UINT8*)msg.AccessBuffer();
+    const UINT8* trailer = buffer + msgLen;
+    UINT8 nonce[NormAead::NONCE_SIZE];
+    memcpy(nonce, buffer + 4, 4);
+    memcpy(nonce + 4, trailer, 8);
+    if (!aead.Open(nonce, buffer, hdrLen, buffer + hdrLen, msgLen - hdrLen, trailer + 8))
+    {
+        rx_stat_auth_failures++;
+        PLOG(PL_DEBUG, "NormSession::OpenMessage() node>%lu message from %s failed authentication\n",
+             (unsigned long)LocalNodeId(), msg.GetSource().GetHostString());
+        return false;
+    }
+    return msg.InitFromBuffer((UINT16)msgLen);  // (re-parsed without the trailer)
+} // end NormSession::OpenMessage()
+
+NormSession::MessageStatus NormSession::SendScopedMessage(NormMsg& msg, UINT8 scopeTtl, bool localRepair)
+{
+    // (batching is suspended so the scope applies to just this message)
+    bool txBatching = tx_batching;
+    if (txBatching)
+    {
+        if (!tx_batch.IsEmpty()) FlushTxBatch();
+        tx_batching = false;
+    }
+    UINT8 sessionTtl = ttl;
+    if ((scopeTtl != sessionTtl) && msg.GetDestination().IsMulticast())
+    {
+        if (tx_socket->SetTTL(scopeTtl))
+            ttl = scopeTtl;  // (for XDP and raw sends)
+        else
+            PLOG(PL_WARN, "NormSession::SendScopedMessage() warning: tx_socket.SetTTL() error\n");
+    }
+    MessageStatus status = MSG_SEND_OK;
+    if (localRepair)
+    {
+        unsigned int numBytes = msg.GetLength();
+        msg.CopyPayloadRef();
+        if (!tx_socket->SendTo(msg.GetBuffer(), numBytes, msg.GetDestination()))
+            status = MSG_SEND_FAILED;
+        else if (numBytes != msg.GetLength())
+            status = MSG_SEND_BLOCKED;
+        if (MSG_SEND_OK != status)
+            PLOG(PL_WARN, "NormSession::SendScopedMessage() sendto(%s/%hu) local repair warning: %s\n",
+                 msg.GetDestination().GetHostString(), msg.GetDestination().GetPort(), GetErrorString());
+    }
+    else
+    {
+        status = SendMessage(msg);
+    }
+    if (ttl != sessionTtl)
+    {
+        if (!tx_socket->SetTTL(sessionTtl))
+            PLOG(PL_ERROR, "NormSession::SendScopedMessage() error: unable to restore session ttl\n");
+        ttl = sessionTtl;
+    }
+    tx_batching = txBatching;
+    return status;
+} // end NormSession::SendScopedMessage()
+
 #ifdef ECN_SUPPORT
 bool NormSession::RawSendTo(const char* buffer, unsigned int& numBytes, const ProtoAddress& dstAddr, UINT8 trafficClass)
 {
@@ -5294,20 +8275,31 @@ bool NormSession::OnProbeTimeout(ProtoTimer & /*theTimer*/)
     // sometimes not even close.
     struct timeval currentTime;
     ProtoSystemTime(currentTime);
+    double deltaTime;
     if ((0 == probe_time_last.tv_sec) && (0 == probe_time_last.tv_usec))
     {
-        grtt_age += probe_timer.GetInterval();
+        deltaTime = probe_timer.GetInterval();
     }
     else
     {
-        double deltaTime = currentTime.tv_sec - probe_time_last.tv_sec;
+        deltaTime = currentTime.tv_sec - probe_time_last.tv_sec;
         if (currentTime.tv_usec > probe_time_last.tv_usec)
             deltaTime += 1.0e-06 * ((double)(currentTime.tv_usec - probe_time_last.tv_usec));
         else
             deltaTime -= 1.0e-06 * ((double)(probe_time_last.tv_usec - currentTime.tv_usec));
-        grtt_age += deltaTime;
     }
+    grtt_age += deltaTime;
     probe_time_last = currentTime;
+    
+    if (gsize_auto)
+    {
+        gsize_age += deltaTime;
+        if (gsize_age >= GSIZE_EPOCH)
+        {
+            SenderUpdateGroupSize();
+            gsize_age = 0.0;
+        }
+    }
 
     // (TBD) We need to revisit the whole set of issues surrounding dynamic
     // estimation of grtt, particularly when congestion control is involved.
@@ -5369,6 +8361,7 @@ bool NormSession::OnProbeTimeout(ProtoTimer & /*theTimer*/)
             grtt_response = false; // reset
         }
         grtt_age = 0.0;
+        if (auto_tune) SenderAutoTune();
     }
 
     if (grtt_interval < grtt_interval_min)
@@ -5545,7 +8538,11 @@ void NormSession::AdjustRate(bool onResponse)
             // adjust probe schedule
             ASSERT(NULL != clr);
             // (TBD) check feedback age
-            if (cc_slow_start)
+            if (CC_BBR == cc_mode)
+            {
+                txRate = GetModelRate(*clr);
+            }
+            else if (cc_slow_start)
             {
                 txRate = clr->GetRate();
                 // Don't adjust rate more than double per RTT during slow start
@@ -5663,6 +8660,7 @@ void NormSession::AdjustRate(bool onResponse)
         txRate = tx_rate_max;
     if (txRate != tx_rate)
     {
+        NORM_PROBE2(rate_change, (UINT64)(8.0*tx_rate), (UINT64)(8.0*txRate));
         // TBD - don't adjust rate more than double per RTT all the time???
         //double rateDouble = 2.0*tx_rate;
         //if (txRate > rateDouble) txRate = rateDouble;
@@ -5691,6 +8689,33 @@ void NormSession::AdjustRate(bool onResponse)
     //ASSERT((NULL == clr) || (txRate <= clr->GetRate()));
 } // end NormSession::AdjustRate()
 
+// Feeds the CLR's latest feedback to the "cc_model" and returns its pacing rate
+double NormSession::GetModelRate(const NormCCNode& clr)
+{
+    struct timeval currentTime;
+    ::ProtoSystemTime(currentTime);
+    double now = (double)currentTime.tv_sec + 1.0e-06 * ((double)currentTime.tv_usec);
+    if (clr.GetId() != cc_model_clr)
+    {
+        // A new limiting receiver has its own path, so start over
+        cc_model.Reset();
+        cc_model_clr = clr.GetId();
+    }
+    double rtt = clr.GetRttSample();
+    // The delivery rate sample is the CLR's reported feedback rate: loss-free
+    // feedback reports twice its measured recv rate, otherwise it reports the
+    // TFMCC equation rate for its measured loss and RTT
+    double deliveryRate = cc_slow_start ? (0.5 * clr.GetRate()) : clr.GetRate();
+    cc_model.Update(now, rtt, deliveryRate);
+    if (clr.GetLoss() > CC_MODEL_LOSS_MAX)
+        cc_model.LimitBtlBw(deliveryRate);  // (persistent heavy loss, so back off)
+    double txRate = cc_model.IsValid() ? cc_model.GetPacingRate() : tx_rate;
+    PLOG(PL_DETAIL, "NormSession::GetModelRate() clr>%lu newRate>%lf (btlBw>%lf minRtt>%lf state>%d)\n",
+         (unsigned long)clr.GetId(), 8.0e-03 * txRate, 8.0e-03 * cc_model.GetBtlBw(),
+         cc_model.GetMinRtt(), (int)cc_model.GetState());
+    return txRate;
+} // end NormSession::GetModelRate()
+
 bool NormSession::OnReportTimeout(ProtoTimer & /*theTimer*/)
 {
     // Receiver reporting (just print out for now)
@@ -5787,9 +8812,14 @@ bool NormSession::OnUserTimeout(ProtoTimer & /*theTimer*/)
 NormSessionMgr::NormSessionMgr(ProtoTimerMgr &timerMgr,
                                ProtoSocket::Notifier &socketNotifier,
                                ProtoChannel::Notifier *channelNotifier)
-    : timer_mgr(timerMgr), socket_notifier(socketNotifier), channel_notifier(channelNotifier),
-      controller(NULL), data_free_func(NULL), top_session(NULL)
+    : timer_mgr(timerMgr), timer_wheel(timerMgr), socket_notifier(socketNotifier), channel_notifier(channelNotifier),
+      controller(NULL), data_free_func(NULL), top_session(NULL), rx_port_list(NULL), poll_cpu(-1), poll_pin(false),
+      rx_memory_budget(0), rx_memory_used(0), tx_budget_rate(0.0), tx_budget_tokens(0.0),
+      tx_share_rate(0.0), tx_share_weight(0.0)
 {
+    poll_timer.SetListener(this, &NormSessionMgr::OnPollTimeout);
+    poll_timer.SetInterval(BUSY_POLL_INTERVAL);
+    poll_timer.SetRepeat(-1);
 }
 
 NormSessionMgr::~NormSessionMgr()
@@ -5799,14 +8829,284 @@ NormSessionMgr::~NormSessionMgr()
 
 void NormSessionMgr::Destroy()
 {
+    if (poll_timer.IsActive())
+        poll_timer.Deactivate();
     NormSession *next;
     while ((next = top_session))
     {
         top_session = next->next;
         delete next;
     }
+    // (the sessions' Close() released their shared ports)
+    ASSERT(NULL == rx_port_list);
 } // end NormSessionMgr::Destroy()
 
+NormRxPort* NormSessionMgr::GetRxPort(UINT16 port, const char* interfaceName, ProtoAddress::Type addrType)
+{
+    if (NULL == interfaceName) interfaceName = "";
+    for (NormRxPort* rxPort = rx_port_list; NULL != rxPort; rxPort = rxPort->GetNext())
+    {
+        if ((port == rxPort->GetPort()) && (0 == strcmp(interfaceName, rxPort->GetInterfaceName())) &&
+            (addrType == rxPort->GetAddressType()))
+            return rxPort;
+    }
+    NormRxPort* rxPort = new NormRxPort(*this, port, interfaceName);
+    if (NULL == rxPort)
+    {
+        PLOG(PL_ERROR, "NormSessionMgr::GetRxPort() new NormRxPort error: %s\n", GetErrorString());
+        return NULL;
+    }
+    if (!rxPort->Open(addrType))
+    {
+        delete rxPort;
+        return NULL;
+    }
+    rxPort->SetNext(rx_port_list);
+    rx_port_list = rxPort;
+    return rxPort;
+} // end NormSessionMgr::GetRxPort()
+
+void NormSessionMgr::ReleaseRxPort(NormRxPort* rxPort)
+{
+    if (!rxPort->IsEmpty()) return;
+    NormRxPort* prev = NULL;
+    for (NormRxPort* next = rx_port_list; NULL != next; next = next->GetNext())
+    {
+        if (next == rxPort)
+        {
+            if (NULL != prev)
+                prev->SetNext(rxPort->GetNext());
+            else
+                rx_port_list = rxPort->GetNext();
+            break;
+        }
+        prev = next;
+    }
+    delete rxPort;
+} // end NormSessionMgr::ReleaseRxPort()
+
+NormRxPort::NormRxPort(NormSessionMgr& sessionMgr, UINT16 thePort, const char* interfaceName)
+ : socket(ProtoSocket::UDP), port(thePort),
+   addr_type(ProtoAddress::IPv4), session_count(0), next(NULL)
+{
+    strncpy(iface_name, (NULL != interfaceName) ? interfaceName : "", IFACE_NAME_MAX);
+    iface_name[IFACE_NAME_MAX] = '\0';
+    socket.SetNotifier(&sessionMgr.GetSocketNotifier());
+    socket.SetListener(this, &NormRxPort::OnSocketEvent);
+}
+
+NormRxPort::~NormRxPort()
+{
+    Close();
+}
+
+bool NormRxPort::Open(ProtoAddress::Type addrType)
+{
+    if (!socket.Open(0, addrType, false))
+    {
+        PLOG(PL_FATAL, "NormRxPort::Open() socket open error\n");
+        return false;
+    }
+    addr_type = addrType;
+    socket.EnableRecvDstAddr();
+    // (so non-sharing sessions with port reuse can still use the port too)
+    if (!socket.SetReuse(true))
+        PLOG(PL_WARN, "NormRxPort::Open() warning: SetReuse() error\n");
+    if (!socket.Bind(port))
+    {
+        PLOG(PL_FATAL, "NormRxPort::Open() error: unable to bind port %hu\n", port);
+        Close();
+        return false;
+    }
+    if (('\0' != iface_name[0]) && !socket.SetMulticastInterface(iface_name))
+    {
+        PLOG(PL_FATAL, "NormRxPort::Open() SetMulticastInterface(%s) error\n", iface_name);
+        Close();
+        return false;
+    }
+    if (!rx_msg.SetBufferSize(NormMsg::MAX_SIZE))
+    {
+        PLOG(PL_FATAL, "NormRxPort::Open() error: unable to allocate receive buffer\n");
+        Close();
+        return false;
+    }
+    return true;
+} // end NormRxPort::Open()
+
+void NormRxPort::Close()
+{
+    if (socket.IsOpen()) socket.Close();
+} // end NormRxPort::Close()
+
+NormRxDemuxItem* NormRxPort::Attach(NormSession& session)
+{
+    ProtoAddress key = session.Address();
+    key.SetPort(port);
+    if (NULL != session_tree.FindItem(key))
+    {
+        PLOG(PL_ERROR, "NormRxPort::Attach() error: session address already on port %hu\n", port);
+        return NULL;
+    }
+    NormRxDemuxItem* item = new NormRxDemuxItem(session, key);
+    if (NULL == item)
+    {
+        PLOG(PL_ERROR, "NormRxPort::Attach() new NormRxDemuxItem error: %s\n", GetErrorString());
+        return NULL;
+    }
+    if (session.Address().IsMulticast())
+    {
+        const ProtoAddress* ssmSource = session.ssm_source_addr.IsValid() ? &session.ssm_source_addr : NULL;
+        if (!socket.JoinGroup(session.Address(), ('\0' != iface_name[0]) ? iface_name : NULL, ssmSource))
+        {
+            PLOG(PL_FATAL, "NormRxPort::Attach() JoinGroup() error\n");
+            delete item;
+            return NULL;
+        }
+    }
+    session_tree.Insert(*item);
+    session_count++;
+    return item;
+} // end NormRxPort::Attach()
+
+void NormRxPort::Detach(NormRxDemuxItem* item)
+{
+    NormSession& session = item->GetSession();
+    if (session.Address().IsMulticast() && socket.IsOpen())
+    {
+        const ProtoAddress* ssmSource = session.ssm_source_addr.IsValid() ? &session.ssm_source_addr : NULL;
+        socket.LeaveGroup(session.Address(), ('\0' != iface_name[0]) ? iface_name : NULL, ssmSource);
+    }
+    session_tree.Remove(*item);
+    delete item;
+    session_count--;
+} // end NormRxPort::Detach()
+
+void NormRxPort::OnSocketEvent(ProtoSocket& theSocket, ProtoSocket::Event theEvent)
+{
+    if (ProtoSocket::RECV != theEvent) return;
+    // As in NormSession::RxSocketRecvHandler(), we yield after about 100 packets
+    for (unsigned int recvCount = 0; recvCount < 100; recvCount++)
+    {
+        unsigned int msgLength = rx_msg.GetBufferSize();
+        ProtoAddress destAddr;
+        if (!theSocket.RecvFrom(rx_msg.AccessBuffer(), msgLength, rx_msg.AccessAddress(), destAddr))
+            break;  // (e.g. an ICMP error, left for the sessions' tx_sockets to report)
+        if (0 == msgLength) break;
+        if (!rx_msg.InitFromBuffer(msgLength))
+        {
+            PLOG(PL_ERROR, "NormRxPort::OnSocketEvent() warning: received bad message\n");
+            continue;
+        }
+        NormRxDemuxItem* item = NULL;
+        bool wasUnicast = false;
+        if (destAddr.IsValid())
+        {
+            wasUnicast = destAddr.IsUnicast();
+            destAddr.SetPort(port);
+            item = session_tree.FindItem(destAddr);
+        }
+        if (NULL == item)
+        {
+            ProtoAddress srcAddr = rx_msg.GetSource();
+            srcAddr.SetPort(port);
+            item = session_tree.FindItem(srcAddr);
+        }
+        if (NULL != item)
+            item->GetSession().HandleReceiveMessage(rx_msg, wasUnicast);
+    }
+} // end NormRxPort::OnSocketEvent()
+
+unsigned long NormSessionMgr::ReserveRxMemory(unsigned long numBytes, unsigned long minBytes)
+{
+    if (0 != rx_memory_budget)
+    {
+        unsigned long available = (rx_memory_used < rx_memory_budget) ? 
+                                        (rx_memory_budget - rx_memory_used) : 0;
+        if (available < minBytes) return 0;
+        if (numBytes > available) numBytes = available;
+    }
+    rx_memory_used += numBytes;
+    return numBytes;
+} // end NormSessionMgr::ReserveRxMemory()
+
+void NormSessionMgr::SetTxRateBudget(double bytesPerSecond)
+{
+    tx_budget_rate = (bytesPerSecond > 0.0) ? bytesPerSecond : 0.0;
+    tx_budget_tokens = TX_BUDGET_DEPTH * tx_budget_rate;
+    tx_budget_time.GetCurrentTime();
+    tx_share_rate = tx_budget_rate;
+    tx_share_weight = 0.0;
+    tx_share_time = ProtoTime();  // (shares are updated at the next draw)
+} // end NormSessionMgr::SetTxRateBudget()
+
+double NormSessionMgr::DrawTxBudget(NormSession& session, unsigned int numBytes)
+{
+    ASSERT(tx_budget_rate > 0.0);
+    ProtoTime currentTime;
+    currentTime.GetCurrentTime();
+    // Refill the bucket, keeping at most TX_BUDGET_DEPTH worth of tokens
+    double elapsed = ProtoTime::Delta(currentTime, tx_budget_time);
+    if (elapsed > 0.0)
+    {
+        tx_budget_tokens += elapsed * tx_budget_rate;
+        double depth = TX_BUDGET_DEPTH * tx_budget_rate;
+        if (tx_budget_tokens > depth) tx_budget_tokens = depth;
+        tx_budget_time = currentTime;
+    }
+    bool wasIdle = ProtoTime::Delta(currentTime, session.tx_budget_sent) > TX_BUDGET_WINDOW;
+    session.tx_budget_sent = currentTime;
+    if (wasIdle || (ProtoTime::Delta(currentTime, tx_share_time) > TX_BUDGET_WINDOW))
+        UpdateTxShares(currentTime);
+    tx_budget_tokens -= (double)numBytes;
+    // The session is paced at its weighted share of the budget (a self-paced
+    // session's own rate is already below its share) and, if the bucket is
+    // overdrawn, holds off until it has been refilled
+    double interval = 0.0;
+    if (!session.tx_budget_capped && (tx_share_weight > 0.0) && (tx_share_rate > 0.0))
+        interval = (double)numBytes * tx_share_weight / (tx_share_rate * session.tx_budget_weight);
+    if (tx_budget_tokens < 0.0)
+    {
+        double refill = -tx_budget_tokens / tx_budget_rate;
+        if (refill > interval) interval = refill;
+    }
+    return interval;
+} // end NormSessionMgr::DrawTxBudget()
+
+void NormSessionMgr::UpdateTxShares(const ProtoTime& currentTime)
+{
+    // Only sessions that have sent recently share the budget.  Those whose
+    // own tx_rate is below their weighted share are given just that rate
+    // and the remainder is shared again among the others ("water filling").
+    tx_share_rate = tx_budget_rate;
+    tx_share_weight = 0.0;
+    NormSession* next;
+    for (next = top_session; NULL != next; next = next->next)
+    {
+        next->tx_budget_capped = false;
+        if (ProtoTime::Delta(currentTime, next->tx_budget_sent) <= TX_BUDGET_WINDOW)
+            tx_share_weight += next->tx_budget_weight;
+    }
+    bool changed = true;
+    while (changed && (tx_share_weight > 0.0))
+    {
+        changed = false;
+        for (next = top_session; NULL != next; next = next->next)
+        {
+            if (next->tx_budget_capped || (next->tx_rate <= 0.0) ||
+                (ProtoTime::Delta(currentTime, next->tx_budget_sent) > TX_BUDGET_WINDOW))
+                continue;
+            if (next->tx_rate < (tx_share_rate * next->tx_budget_weight / tx_share_weight))
+            {
+                next->tx_budget_capped = true;
+                tx_share_rate -= next->tx_rate;
+                tx_share_weight -= next->tx_budget_weight;
+                changed = true;
+            }
+        }
+    }
+    tx_share_time = currentTime;
+} // end NormSessionMgr::UpdateTxShares()
+
 NormSession *NormSessionMgr::NewSession(const char *sessionAddress,
                                         UINT16 sessionPort,
                                         NormNodeId localNodeId)
@@ -5841,6 +9141,8 @@ NormSession *NormSessionMgr::NewSession(const char *sessionAddress,
         return ((NormSession *)NULL);
     }
     theSession->SetAddress(theAddress);
+    if (poll_timer.IsActive())
+        theSession->SetBusyPoll(BUSY_POLL_USEC);
     // Add new session to our session list
     theSession->next = top_session;
     top_session = theSession;
@@ -5862,6 +9164,76 @@ void NormSessionMgr::DeleteSession(class NormSession *theSession)
             prev->next = theSession->next;
         else
             top_session = theSession->next;
+        // Detach any cut-through relays to or from the session
+        for (next = top_session; NULL != next; next = next->next)
+        {
+            next->RelayCancelSource(*theSession);
+            if (theSession == next->GetRelaySession())
+                next->SetRelaySession(NULL);
+        }
         delete theSession;
     }
 } // end NormSessionMgr::DeleteSession()
+
+bool NormSessionMgr::SetBusyPoll(bool enable, int cpuId)
+{
+    for (NormSession* session = top_session; NULL != session; session = session->next)
+        session->SetBusyPoll(enable ? BUSY_POLL_USEC : 0);
+    if (enable)
+    {
+        // (the affinity is set from the protocol thread on the first poll)
+        poll_cpu = cpuId;
+        poll_pin = (cpuId >= 0);
+        if (!poll_timer.IsActive())
+            timer_mgr.ActivateTimer(poll_timer);
+    }
+    else if (poll_timer.IsActive())
+    {
+        poll_timer.Deactivate();  // (note any CPU affinity set is kept)
+    }
+    return true;
+} // end NormSessionMgr::SetBusyPoll()
+
+bool NormSessionMgr::OnPollTimeout(ProtoTimer& /*theTimer*/)
+{
+    if (poll_pin)
+    {
+        poll_pin = false;
+#if defined(__linux__) && !defined(SIMULATE)
+        if (poll_cpu >= CPU_SETSIZE)
+        {
+            PLOG(PL_ERROR, "NormSessionMgr::OnPollTimeout() error: invalid cpu %d (CPU_SETSIZE is %d)\n",
+                           poll_cpu, (int)CPU_SETSIZE);
+        }
+        else
+        {
+            cpu_set_t cpuSet;
+            CPU_ZERO(&cpuSet);
+            CPU_SET(poll_cpu, &cpuSet);
+            int result = pthread_setaffinity_np(pthread_self(), sizeof(cpuSet), &cpuSet);
+            if (0 != result)
+                PLOG(PL_ERROR, "NormSessionMgr::OnPollTimeout() error: unable to pin thread to cpu %d: %s\n",
+                               poll_cpu, strerror(result));
+        }
+#elif defined(WIN32)
+        if (poll_cpu >= (int)(8 * sizeof(DWORD_PTR)))
+            PLOG(PL_ERROR, "NormSessionMgr::OnPollTimeout() error: invalid cpu %d (affinity mask is %d bits)\n",
+                           poll_cpu, (int)(8 * sizeof(DWORD_PTR)));
+        else if (0 == SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)1 << poll_cpu))
+            PLOG(PL_ERROR, "NormSessionMgr::OnPollTimeout() error: unable to pin thread to cpu %d: %s\n",
+                           poll_cpu, GetErrorString());
+#else
+        PLOG(PL_WARN, "NormSessionMgr::OnPollTimeout() warning: CPU pinning not supported\n");
+#endif // if/else __linux__ / WIN32
+    }
+    NormSession* next = top_session;
+    while (NULL != next)
+    {
+        NormSession* session = next;
+        next = session->next;
+        session->PollSockets();
+    }
+    for (NormRxPort* rxPort = rx_port_list; NULL != rxPort; rxPort = rxPort->GetNext())
+        rxPort->OnSocketEvent(rxPort->AccessSocket(), ProtoSocket::RECV);
+    return true;
+} // end NormSessionMgr::OnPollTimeout()
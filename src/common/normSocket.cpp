@@ -404,6 +404,7 @@ NormSocket::NormSocket(NormSessionHandle normSession)
     socket_option.buffer_size = DEFAULT_BUFFER_SIZE;
     socket_option.silent_receiver = false;
     socket_option.max_delay = -1;
+    socket_option.pool_size = 0;
     
     // For now we use the NormSession "user data" option to associate
     // the session with a "socket".  In the future we may add a
@@ -531,6 +532,14 @@ bool NormSocket::Listen(UINT16 serverPort, const char* groupAddr, const char* se
         //norm_session = NORM_SESSION_INVALID;      
         return false;
     }
+    // Accepted unicast sockets can share one FEC buffer pool instead of
+    // each preallocating "buffer_size" sender and receiver buffers
+    if ((NULL == groupAddr) && (0 != socket_option.pool_size))
+    {
+        if (!NormSetBufferPool(norm_session, socket_option.pool_size, socket_option.segment_size,
+                               socket_option.num_data, socket_option.num_parity))
+            fprintf(stderr, "NormSocket::Listen() warning: unable to create shared buffer pool\n");
+    }
     server_socket  = this;
     socket_state = LISTENING;
     return true;
@@ -583,12 +592,17 @@ NormSocket* NormSocket::Accept(NormNodeHandle client, NormInstanceHandle instanc
     // we wait for NORM_REMOTE_SENDER_INACTIVE to delete the remote sender from the listener sesssion
     
 #ifndef WIN32
-    // Enable rx port reuse since it's the server port, and connect
-    // this socket to client addr/port for unique, tight binding
+    // Unicast client sessions receive (and send) through the listener's
+    // socket, demultiplexed by client addr/port, so no socket per client
+    // is needed.  Otherwise, enable rx port reuse since it's the server 
+    // port, and connect this socket to client addr/port for unique, tight binding
     // TBD - support option to bind to specific server address
     //fprintf(stderr, "accepting connection from %s/%d on port %d ...\n", clientAddr, clientPort, serverPort);
-    NormSetRxPortReuse(clientSession, true, NULL, clientAddr, clientPort);  
+    if (!IsUnicastSocket() || !NormSetRxDemux(clientSession, norm_session, client))
+        NormSetRxPortReuse(clientSession, true, NULL, clientAddr, clientPort);  
 #endif // WIN32
+    if (IsUnicastSocket() && (0 != socket_option.pool_size))
+        NormShareBufferPool(clientSession, norm_session);
     NormSetDefaultUnicastNack(clientSession, true);
 	
     NormStartReceiver(clientSession, 2*1024*1024);
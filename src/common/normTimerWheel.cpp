@@ -0,0 +1,252 @@
+#include "normTimerWheel.h"
+
+NormTimerWheel::Timer::Timer()
+ : listener(NULL), interval(1.0), repeat(0), repeat_count(0), wheel(NULL),
+   expire_tick(0), level(-1), list_head(NULL), prev(NULL), next(NULL)
+{
+}
+
+NormTimerWheel::Timer::~Timer()
+{
+    if (IsActive()) Deactivate();
+    if (NULL != listener)
+    {
+        delete listener;
+        listener = NULL;
+    }
+}
+
+void NormTimerWheel::Timer::Deactivate()
+{
+    if (NULL != wheel) wheel->DeactivateTimer(*this);
+}  // end NormTimerWheel::Timer::Deactivate()
+
+void NormTimerWheel::Timer::Reschedule()
+{
+    if (NULL == wheel) return;
+    NormTimerWheel* theWheel = wheel;
+    int repeatCount = repeat_count;
+    theWheel->DeactivateTimer(*this);
+    theWheel->ActivateTimer(*this);
+    repeat_count = repeatCount;
+}  // end NormTimerWheel::Timer::Reschedule()
+
+double NormTimerWheel::Timer::GetTimeRemaining() const
+{
+    if (NULL == wheel) return -1.0;
+    UINT64 currentTick = wheel->CurrentTick();
+    if (expire_tick <= currentTick) return 0.0;
+    return ((double)(expire_tick - currentTick) * wheel->GetTickInterval());
+}  // end NormTimerWheel::Timer::GetTimeRemaining()
+
+NormTimerWheel::NormTimerWheel(ProtoTimerMgr& timerMgr, unsigned int tickUsec)
+ : timer_mgr(timerMgr), tick_usec((0 != tickUsec) ? tickUsec : DEFAULT_TICK_USEC),
+   base_tick(0), wake_tick(0), expire_list(NULL), timer_count(0), in_timeout(false)
+{
+    memset(slot, 0, sizeof(slot));
+    memset(level_count, 0, sizeof(level_count));
+    tick_timer.SetListener(this, &NormTimerWheel::OnTickTimeout);
+    tick_timer.SetInterval(0.0);
+    tick_timer.SetRepeat(-1);  // (managed by Schedule())
+}
+
+NormTimerWheel::~NormTimerWheel()
+{
+    if (tick_timer.IsActive()) tick_timer.Deactivate();
+    // Orphan any timers still in the wheel
+    for (int level = 0; level < LEVEL_COUNT; level++)
+    {
+        for (unsigned int i = 0; i < LEVEL_SIZE; i++)
+        {
+            Timer* timer;
+            while (NULL != (timer = slot[level][i]))
+            {
+                Unlink(*timer);
+                timer->wheel = NULL;
+            }
+        }
+    }
+    timer_count = 0;
+}
+
+UINT64 NormTimerWheel::CurrentTick() const
+{
+    struct timeval currentTime;
+    ::ProtoSystemTime(currentTime);
+    UINT64 usec = (UINT64)currentTime.tv_sec * 1000000 + (UINT64)currentTime.tv_usec;
+    return (usec / tick_usec);
+}  // end NormTimerWheel::CurrentTick()
+
+// Rounds up so timers never fire early
+UINT64 NormTimerWheel::IntervalTicks(double interval) const
+{
+    double usec = interval * 1.0e+06;
+    UINT64 ticks = (UINT64)(usec / (double)tick_usec);
+    if (((double)ticks * (double)tick_usec) < usec) ticks++;
+    return ticks;
+}  // end NormTimerWheel::IntervalTicks()
+
+void NormTimerWheel::Link(Timer& theTimer, Timer** head)
+{
+    theTimer.list_head = head;
+    theTimer.prev = NULL;
+    theTimer.next = *head;
+    if (NULL != *head) (*head)->prev = &theTimer;
+    *head = &theTimer;
+}  // end NormTimerWheel::Link()
+
+void NormTimerWheel::Unlink(Timer& theTimer)
+{
+    if (NULL == theTimer.list_head) return;
+    if (NULL != theTimer.prev)
+        theTimer.prev->next = theTimer.next;
+    else
+        *theTimer.list_head = theTimer.next;
+    if (NULL != theTimer.next) theTimer.next->prev = theTimer.prev;
+    theTimer.prev = theTimer.next = NULL;
+    theTimer.list_head = NULL;
+    if (theTimer.level >= 0) level_count[theTimer.level]--;
+    theTimer.level = -1;
+}  // end NormTimerWheel::Unlink()
+
+// Level "n" holds timers due within LEVEL_SIZE^(n+1) ticks, in the slot
+// for their expire tick's "n"th LEVEL_BITS digit.  Slots of higher levels
+// are cascaded down as "base_tick" reaches them.
+void NormTimerWheel::Insert(Timer& theTimer)
+{
+    if (theTimer.expire_tick < base_tick) theTimer.expire_tick = base_tick;
+    // (keep the furthest timers clear of the top level slot now in use)
+    const UINT64 deltaMax = ((UINT64)1 << (LEVEL_BITS * LEVEL_COUNT)) -
+                            ((UINT64)1 << (LEVEL_BITS * (LEVEL_COUNT - 1)));
+    if ((theTimer.expire_tick - base_tick) > deltaMax)
+        theTimer.expire_tick = base_tick + deltaMax;
+    UINT64 delta = theTimer.expire_tick - base_tick;
+    int level = 0;
+    while ((level < (LEVEL_COUNT - 1)) && (delta >= ((UINT64)1 << (LEVEL_BITS * (level + 1)))))
+        level++;
+    unsigned int index = (unsigned int)(theTimer.expire_tick >> (LEVEL_BITS * level)) & LEVEL_MASK;
+    Link(theTimer, &slot[level][index]);
+    theTimer.level = level;
+    level_count[level]++;
+}  // end NormTimerWheel::Insert()
+
+void NormTimerWheel::Cascade(int level)
+{
+    unsigned int index = (unsigned int)(base_tick >> (LEVEL_BITS * level)) & LEVEL_MASK;
+    // Detach the slot list first so re-inserted timers aren't revisited
+    Timer* next = slot[level][index];
+    slot[level][index] = NULL;
+    while (NULL != next)
+    {
+        Timer* timer = next;
+        next = timer->next;
+        level_count[level]--;
+        timer->list_head = NULL;
+        timer->level = -1;
+        timer->prev = timer->next = NULL;
+        Insert(*timer);
+    }
+}  // end NormTimerWheel::Cascade()
+
+void NormTimerWheel::ActivateTimer(Timer& theTimer)
+{
+    if (theTimer.IsActive()) theTimer.wheel->DeactivateTimer(theTimer);
+    UINT64 currentTick = CurrentTick();
+    if ((0 == timer_count) && !in_timeout) base_tick = currentTick;  // (wheel was idle)
+    theTimer.expire_tick = currentTick + IntervalTicks(theTimer.interval);
+    theTimer.repeat_count = theTimer.repeat;
+    theTimer.wheel = this;
+    timer_count++;
+    Insert(theTimer);
+    if (!in_timeout && (!tick_timer.IsActive() || (theTimer.expire_tick < wake_tick)))
+        Schedule();
+}  // end NormTimerWheel::ActivateTimer()
+
+void NormTimerWheel::DeactivateTimer(Timer& theTimer)
+{
+    if (this != theTimer.wheel) return;
+    Unlink(theTimer);
+    theTimer.wheel = NULL;
+    timer_count--;
+    // (an early "tick_timer" wake up is harmless, so it's left unless idle)
+    if ((0 == timer_count) && !in_timeout && tick_timer.IsActive())
+        tick_timer.Deactivate();
+}  // end NormTimerWheel::DeactivateTimer()
+
+// Sets "tick_timer" for the next occupied level 0 slot or, if there are
+// timers at higher levels, no later than the next level 0 wrap around
+// where they are cascaded.
+void NormTimerWheel::Schedule()
+{
+    if (0 == timer_count)
+    {
+        if (tick_timer.IsActive()) tick_timer.Deactivate();
+        return;
+    }
+    UINT64 limit = base_tick + LEVEL_SIZE;
+    if (timer_count > level_count[0])
+        limit = (base_tick + LEVEL_MASK) & ~((UINT64)LEVEL_MASK);  // (next cascade)
+    UINT64 nextTick = base_tick;
+    while ((nextTick < limit) && (NULL == slot[0][nextTick & LEVEL_MASK]))
+        nextTick++;
+    if (tick_timer.IsActive() && (nextTick == wake_tick)) return;
+    wake_tick = nextTick;
+    UINT64 currentTick = CurrentTick();
+    double delay = (nextTick > currentTick) ? ((double)(nextTick - currentTick) * GetTickInterval()) : 0.0;
+    tick_timer.SetInterval(delay);
+    if (tick_timer.IsActive())
+        tick_timer.Reschedule();
+    else
+        timer_mgr.ActivateTimer(tick_timer);
+}  // end NormTimerWheel::Schedule()
+
+bool NormTimerWheel::OnTickTimeout(ProtoTimer& /*theTimer*/)
+{
+    in_timeout = true;
+    UINT64 currentTick = CurrentTick();
+    while ((base_tick <= currentTick) && (0 != timer_count))
+    {
+        unsigned int index = (unsigned int)(base_tick & LEVEL_MASK);
+        if (0 == index)
+        {
+            // Cascade higher level slots down as we reach them
+            for (int level = 1; level < LEVEL_COUNT; level++)
+            {
+                Cascade(level);
+                if (0 != ((base_tick >> (LEVEL_BITS * level)) & LEVEL_MASK)) break;
+            }
+        }
+        // Move this tick's timers to the "expire_list" so they're
+        // handled as a batch (with any the listeners reactivate
+        // landing in later ticks)
+        Timer* timer;
+        while (NULL != (timer = slot[0][index]))
+        {
+            Unlink(*timer);
+            Link(*timer, &expire_list);
+        }
+        base_tick++;
+        while (NULL != (timer = expire_list))
+        {
+            Unlink(*timer);  // (timer is still "active" during its timeout)
+            bool result = (NULL != timer->listener) ? timer->listener->on_timeout(*timer) : true;
+            // (a "false" result means the listener deactivated or reactivated it)
+            if (!result || (this != timer->wheel) || (NULL != timer->list_head)) continue;
+            if (0 != timer->repeat_count)
+            {
+                if (timer->repeat_count > 0) timer->repeat_count--;
+                timer->expire_tick += IntervalTicks(timer->interval);
+                Insert(*timer);
+            }
+            else
+            {
+                timer->wheel = NULL;
+                timer_count--;
+            }
+        }
+    }
+    in_timeout = false;
+    tick_timer.Deactivate();
+    Schedule();
+    return false;  // since "tick_timer" is managed by Schedule()
+}  // end NormTimerWheel::OnTickTimeout()
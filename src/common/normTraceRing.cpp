@@ -0,0 +1,262 @@
+#include "normTraceRing.h"
+#include "normMessage.h"
+#include "protoDebug.h"
+
+#include <time.h>  // for gmtime() in Print()
+
+NormTraceRing::NormTraceRing()
+ : ring(NULL), size(0), next(0), count(0)
+{
+}
+
+NormTraceRing::~NormTraceRing()
+{
+    Close();
+}
+
+bool NormTraceRing::Open(unsigned int numRecords)
+{
+    Close();
+    if (0 == numRecords) return false;
+    if (NULL == (ring = new Record[numRecords]))
+    {
+        PLOG(PL_FATAL, "NormTraceRing::Open() new ring error: %s\n", GetErrorString());
+        return false;
+    }
+    size = numRecords;
+    next = count = 0;
+    return true;
+}  // end NormTraceRing::Open()
+
+void NormTraceRing::Close()
+{
+    if (NULL != ring)
+    {
+        delete[] ring;
+        ring = NULL;
+    }
+    size = next = count = 0;
+}  // end NormTraceRing::Close()
+
+void NormTraceRing::Add(const struct timeval& currentTime,
+                        const NormMsg&        msg,
+                        bool                  sent,
+                        UINT8                 fecM,
+                        UINT16                instId)
+{
+    if (NULL == ring) return;
+    Record& record = ring[next];
+    if (++next >= size) next = 0;
+    if (count < size) count++;
+
+    record.sec = (UINT32)currentTime.tv_sec;
+    record.usec = (UINT32)currentTime.tv_usec;
+    NormMsg::Type msgType = msg.GetType();
+    record.type = (UINT8)msgType;
+    record.subtype = 0;
+    record.flags = sent ? FLAG_SENT : 0;
+    record.reserved = 0;
+    record.seq = msg.GetSequence();
+    record.length = msg.GetLength();
+    record.sourceId = (UINT32)msg.GetSourceId();
+    record.instId = instId;
+    record.objectId = 0;
+    record.blockId = 0;
+    record.segmentId = 0;
+    const ProtoAddress& addr = sent ? msg.GetDestination() : msg.GetSource();
+    record.port = addr.GetPort();
+    if (ProtoAddress::IPv4 == addr.GetType())
+    {
+        memcpy(&record.addr, addr.GetRawHostAddress(), 4);
+    }
+    else
+    {
+        record.addr = 0;
+        record.flags |= FLAG_IPV6;
+    }
+
+    switch (msgType)
+    {
+        case NormMsg::INFO:
+        {
+            const NormInfoMsg& info = static_cast<const NormInfoMsg&>(msg);
+            record.instId = info.GetInstanceId();
+            record.objectId = (UINT16)info.GetObjectId();
+            if (info.FlagIsSet(NormObjectMsg::FLAG_REPAIR)) record.flags |= FLAG_REPAIR;
+            break;
+        }
+        case NormMsg::DATA:
+        {
+            const NormDataMsg& data = static_cast<const NormDataMsg&>(msg);
+            record.instId = data.GetInstanceId();
+            record.objectId = (UINT16)data.GetObjectId();
+            record.blockId = data.GetFecBlockId(fecM).GetValue();
+            record.segmentId = data.GetFecSymbolId(fecM);
+            if (data.FlagIsSet(NormObjectMsg::FLAG_REPAIR)) record.flags |= FLAG_REPAIR;
+            if (data.IsStream()) record.flags |= FLAG_STREAM;
+            break;
+        }
+        case NormMsg::CMD:
+        {
+            const NormCmdMsg& cmd = static_cast<const NormCmdMsg&>(msg);
+            NormCmdMsg::Flavor flavor = cmd.GetFlavor();
+            record.subtype = (UINT8)flavor;
+            record.instId = cmd.GetInstanceId();
+            switch (flavor)
+            {
+                case NormCmdMsg::FLUSH:
+                {
+                    const NormCmdFlushMsg& flush = static_cast<const NormCmdFlushMsg&>(msg);
+                    record.objectId = (UINT16)flush.GetObjectId();
+                    record.blockId = flush.GetFecBlockId(fecM).GetValue();
+                    record.segmentId = flush.GetFecSymbolId(fecM);
+                    if (0 != flush.GetAckingNodeCount()) record.flags |= FLAG_WATERMARK;
+                    break;
+                }
+                case NormCmdMsg::SQUELCH:
+                {
+                    const NormCmdSquelchMsg& squelch = static_cast<const NormCmdSquelchMsg&>(msg);
+                    record.objectId = (UINT16)squelch.GetObjectId();
+                    record.blockId = squelch.GetFecBlockId(fecM).GetValue();
+                    record.segmentId = squelch.GetFecSymbolId(fecM);
+                    break;
+                }
+                case NormCmdMsg::CC:
+                    record.blockId = static_cast<const NormCmdCCMsg&>(msg).GetCCSequence();
+                    break;
+                default:
+                    break;
+            }
+            break;
+        }
+        case NormMsg::ACK:
+        case NormMsg::NACK:
+        {
+            if (NormMsg::ACK == msgType)
+            {
+                const NormAckMsg& ack = static_cast<const NormAckMsg&>(msg);
+                record.subtype = (UINT8)ack.GetAckType();
+                if (NormAck::FLUSH == ack.GetAckType())
+                {
+                    const NormAckFlushMsg& flushAck = static_cast<const NormAckFlushMsg&>(ack);
+                    record.objectId = (UINT16)flushAck.GetObjectId();
+                    record.blockId = flushAck.GetFecBlockId(fecM).GetValue();
+                    record.segmentId = flushAck.GetFecSymbolId(fecM);
+                }
+            }
+            NormCCFeedbackExtension ext;
+            if (msg.FindExtension(NormHeaderExtension::CC_FEEDBACK, ext) && ext.CCFlagIsSet(NormCC::CLR))
+                record.flags |= FLAG_CLR;
+            break;
+        }
+        default:
+            break;
+    }
+}  // end NormTraceRing::Add()
+
+bool NormTraceRing::Write(const char* path, UINT32 localId) const
+{
+    FILE* filePtr = fopen(path, "wb");
+    if (NULL == filePtr)
+    {
+        PLOG(PL_ERROR, "NormTraceRing::Write() fopen(%s) error: %s\n", path, GetErrorString());
+        return false;
+    }
+    UINT8 buffer[RECORD_SIZE];
+    memcpy(buffer, "NTRC", 4);
+    PutUINT16(buffer + 4, FILE_VERSION);
+    PutUINT16(buffer + 6, RECORD_SIZE);
+    PutUINT32(buffer + 8, localId);
+    PutUINT32(buffer + 12, count);
+    bool result = (1 == fwrite(buffer, FILE_HEADER_SIZE, 1, filePtr));
+    unsigned int index = (count < size) ? 0 : next;
+    for (unsigned int i = 0; result && (i < count); i++)
+    {
+        const Record& record = ring[index];
+        if (++index >= size) index = 0;
+        PutUINT32(buffer, record.sec);
+        PutUINT32(buffer + 4, record.usec);
+        buffer[8] = record.type;
+        buffer[9] = record.subtype;
+        buffer[10] = record.flags;
+        buffer[11] = record.reserved;
+        PutUINT16(buffer + 12, record.seq);
+        PutUINT16(buffer + 14, record.length);
+        PutUINT32(buffer + 16, record.sourceId);
+        PutUINT16(buffer + 20, record.instId);
+        PutUINT16(buffer + 22, record.objectId);
+        PutUINT32(buffer + 24, record.blockId);
+        PutUINT16(buffer + 28, record.segmentId);
+        PutUINT16(buffer + 30, record.port);
+        memcpy(buffer + 32, &record.addr, 4);
+        result = (1 == fwrite(buffer, RECORD_SIZE, 1, filePtr));
+    }
+    if (!result)
+        PLOG(PL_ERROR, "NormTraceRing::Write() fwrite(%s) error: %s\n", path, GetErrorString());
+    if (0 != fclose(filePtr)) result = false;
+    return result;
+}  // end NormTraceRing::Write()
+
+void NormTraceRing::Print(FILE* filePtr, UINT32 localId, const Record& record)
+{
+    static const char* MSG_NAME[] =
+        {"INVALID", "INFO", "DATA", "CMD", "NACK", "ACK", "REPORT"};
+    static const char* CMD_NAME[] =
+        {"CMD(INVALID)", "CMD(FLUSH)", "CMD(EOT)", "CMD(SQUELCH)",
+         "CMD(CC)", "CMD(REPAIR_ADV)", "CMD(ACK_REQ)", "CMD(APP)"};
+
+    time_t secs = (time_t)record.sec;
+    struct tm* ct = gmtime(&secs);
+    fprintf(filePtr, "trace>%02d:%02d:%02d.%06lu ",
+            (int)ct->tm_hour, (int)ct->tm_min, (int)ct->tm_sec, (unsigned long)record.usec);
+    const char* status = (0 != (record.flags & FLAG_SENT)) ? "dst" : "src";
+    if (0 != (record.flags & FLAG_IPV6))
+    {
+        fprintf(filePtr, "node>%lu %s>(IPv6)/%hu ", (unsigned long)localId, status, record.port);
+    }
+    else
+    {
+        const UINT8* a = (const UINT8*)&record.addr;
+        fprintf(filePtr, "node>%lu %s>%u.%u.%u.%u/%hu ", (unsigned long)localId, status,
+                a[0], a[1], a[2], a[3], record.port);
+    }
+    switch (record.type)
+    {
+        case NormMsg::INFO:
+            fprintf(filePtr, "inst>%hu seq>%hu INFO obj>%hu ", record.instId, record.seq, record.objectId);
+            break;
+        case NormMsg::DATA:
+            fprintf(filePtr, "inst>%hu seq>%hu DATA obj>%hu blk>%lu seg>%hu ",
+                    record.instId, record.seq, record.objectId,
+                    (unsigned long)record.blockId, record.segmentId);
+            break;
+        case NormMsg::CMD:
+            fprintf(filePtr, "inst>%hu seq>%hu %s ", record.instId, record.seq,
+                    CMD_NAME[MIN(record.subtype, 7)]);
+            if ((NormCmdMsg::FLUSH == record.subtype) || (NormCmdMsg::SQUELCH == record.subtype))
+                fprintf(filePtr, " obj>%hu blk>%lu seg>%hu ", record.objectId,
+                        (unsigned long)record.blockId, record.segmentId);
+            else if (NormCmdMsg::CC == record.subtype)
+                fprintf(filePtr, " seq>%lu ", (unsigned long)record.blockId);
+            if (0 != (record.flags & FLAG_WATERMARK))
+                fprintf(filePtr, "(WATERMARK) ");
+            break;
+        case NormMsg::ACK:
+            fprintf(filePtr, "inst>%hu ", record.instId);
+            if (NormAck::FLUSH == record.subtype)
+                fprintf(filePtr, "ACK(FLUSH) obj>%hu blk>%lu seg>%hu ", record.objectId,
+                        (unsigned long)record.blockId, record.segmentId);
+            else if (NormAck::CC == record.subtype)
+                fprintf(filePtr, "ACK(CC) ");
+            else
+                fprintf(filePtr, "ACK(ZZZ) ");
+            break;
+        case NormMsg::NACK:
+            fprintf(filePtr, "inst>%hu NACK ", record.instId);
+            break;
+        default:
+            fprintf(filePtr, "%s ", MSG_NAME[MIN(record.type, 6)]);
+            break;
+    }
+    fprintf(filePtr, "len>%hu %s\n", record.length, (0 != (record.flags & FLAG_CLR)) ? "(CLR)" : "");
+}  // end NormTraceRing::Print()
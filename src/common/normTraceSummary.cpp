@@ -0,0 +1,220 @@
+#include "normTraceSummary.h"
+#include "normMessage.h"  // for NormMsg::Type values
+
+#include <stdlib.h>  // for qsort()
+#include <string.h>
+#include <errno.h>
+
+// (errors go to stderr since the trace tools may not link protolib)
+
+NormTraceSummary::NormTraceSummary()
+ : object_count(0)
+{
+    memset(sender_table, 0, sizeof(sender_table));
+}
+
+NormTraceSummary::~NormTraceSummary()
+{
+    Destroy();
+}
+
+void NormTraceSummary::Destroy()
+{
+    for (unsigned int i = 0; i < SENDER_HASH_SIZE; i++)
+    {
+        Sender* sender;
+        while (NULL != (sender = sender_table[i]))
+        {
+            sender_table[i] = sender->next;
+            for (unsigned int j = 0; j < OBJECT_HASH_SIZE; j++)
+            {
+                Object* obj;
+                while (NULL != (obj = sender->object_table[j]))
+                {
+                    sender->object_table[j] = obj->next;
+                    delete obj;
+                }
+            }
+            delete sender;
+        }
+    }
+    object_count = 0;
+}  // end NormTraceSummary::Destroy()
+
+UINT32 NormTraceSummary::GetSenderId(const NormTraceRing::Record& record, UINT32 localId)
+{
+    switch (record.type)
+    {
+        case NormMsg::NACK:
+        case NormMsg::ACK:
+            return ((0 != (record.flags & NormTraceRing::FLAG_SENT)) ? 0 : localId);
+        default:
+            return record.sourceId;
+    }
+}  // end NormTraceSummary::GetSenderId()
+
+NormTraceSummary::Sender* NormTraceSummary::GetSender(UINT32 senderId)
+{
+    unsigned int index = (senderId ^ (senderId >> 8) ^ (senderId >> 16)) & (SENDER_HASH_SIZE - 1);
+    Sender* sender = sender_table[index];
+    while ((NULL != sender) && (senderId != sender->id))
+        sender = sender->next;
+    if (NULL != sender) return sender;
+    if (NULL == (sender = new Sender))
+    {
+        fprintf(stderr, "NormTraceSummary::GetSender() new Sender error: %s\n", strerror(errno));
+        return NULL;
+    }
+    sender->id = senderId;
+    sender->seq_valid = false;
+    sender->seq_last = 0;
+    sender->nack_time = -1.0;
+    sender->current = NULL;
+    memset(sender->object_table, 0, sizeof(sender->object_table));
+    sender->next = sender_table[index];
+    sender_table[index] = sender;
+    return sender;
+}  // end NormTraceSummary::GetSender()
+
+NormTraceSummary::Object* NormTraceSummary::GetObject(Sender& sender, UINT16 objectId, double time)
+{
+    // (consecutive messages are nearly always for the same object)
+    if ((NULL != sender.current) && (objectId == sender.current->object_id))
+        return sender.current;
+    unsigned int index = objectId & (OBJECT_HASH_SIZE - 1);
+    Object* obj = sender.object_table[index];
+    while ((NULL != obj) && (objectId != obj->object_id))
+        obj = obj->next;
+    if (NULL == obj)
+    {
+        if (NULL == (obj = new Object))
+        {
+            fprintf(stderr, "NormTraceSummary::GetObject() new Object error: %s\n", strerror(errno));
+            return NULL;
+        }
+        memset(obj, 0, sizeof(Object));
+        obj->sender_id = sender.id;
+        obj->object_id = objectId;
+        obj->time_first = obj->time_last = time;
+        obj->next = sender.object_table[index];
+        sender.object_table[index] = obj;
+        object_count++;
+    }
+    sender.current = obj;
+    return obj;
+}  // end NormTraceSummary::GetObject()
+
+void NormTraceSummary::Add(const NormTraceRing::Record& record, UINT32 senderId)
+{
+    double time = (double)record.sec + 1.0e-06 * (double)record.usec;
+    bool sent = (0 != (record.flags & NormTraceRing::FLAG_SENT));
+    switch (record.type)
+    {
+        case NormMsg::NACK:
+        case NormMsg::ACK:
+        {
+            if ((NormMsg::NACK != record.type) || (0 == senderId)) return;
+            Sender* sender = GetSender(senderId);
+            if (NULL == sender) return;
+            if (sender->nack_time < 0.0) sender->nack_time = time;
+            if (NULL != sender->current) sender->current->nack_count++;
+            return;
+        }
+        case NormMsg::INFO:
+        case NormMsg::DATA:
+        case NormMsg::CMD:
+            break;
+        default:
+            return;
+    }
+    Sender* sender = GetSender(senderId);
+    if (NULL == sender) return;
+    Object* obj = sender->current;
+    if (NormMsg::CMD != record.type)
+    {
+        if (NULL == (obj = GetObject(*sender, record.objectId, time))) return;
+        obj->time_last = time;
+        obj->pkt_count++;
+        obj->byte_count += (double)record.length;
+        if (0 != (record.flags & NormTraceRing::FLAG_REPAIR))
+        {
+            obj->repair_count++;
+            if (sender->nack_time >= 0.0)
+            {
+                double delay = time - sender->nack_time;
+                obj->repair_samples++;
+                obj->repair_delay_sum += delay;
+                if (delay > obj->repair_delay_max) obj->repair_delay_max = delay;
+                sender->nack_time = -1.0;
+            }
+        }
+    }
+    // Sender message sequence gaps are losses (reordered messages are ignored)
+    if (sent) return;
+    if (sender->seq_valid)
+    {
+        INT16 delta = (INT16)(record.seq - sender->seq_last);
+        if (delta <= 0) return;
+        if ((delta > 1) && (NULL != obj))
+        {
+            UINT32 run = (UINT32)(delta - 1);
+            obj->run_count++;
+            obj->lost_count += run;
+            if (run > obj->run_max) obj->run_max = run;
+        }
+    }
+    sender->seq_last = record.seq;
+    sender->seq_valid = true;
+}  // end NormTraceSummary::Add()
+
+int NormTraceSummary::CompareObjects(const void* a, const void* b)
+{
+    const Object* objA = *((const Object**)a);
+    const Object* objB = *((const Object**)b);
+    if (objA->sender_id != objB->sender_id)
+        return ((objA->sender_id < objB->sender_id) ? -1 : 1);
+    if (objA->time_first != objB->time_first)
+        return ((objA->time_first < objB->time_first) ? -1 : 1);
+    return 0;
+}  // end NormTraceSummary::CompareObjects()
+
+void NormTraceSummary::Print(FILE* filePtr) const
+{
+    fprintf(filePtr, "%-10s %6s %17s %17s %8s %12s %10s %7s %6s %6s %8s %6s %9s %9s\n",
+            "sender", "object", "start", "end", "pkts", "bytes", "kbps", "repairs",
+            "nacks", "runs", "lost", "maxRun", "rptAvg", "rptMax");
+    if (0 == object_count) return;
+    Object** list = new Object*[object_count];
+    if (NULL == list)
+    {
+        fprintf(stderr, "NormTraceSummary::Print() new list error: %s\n", strerror(errno));
+        return;
+    }
+    unsigned int count = 0;
+    for (unsigned int i = 0; i < SENDER_HASH_SIZE; i++)
+    {
+        for (const Sender* sender = sender_table[i]; NULL != sender; sender = sender->next)
+        {
+            for (unsigned int j = 0; j < OBJECT_HASH_SIZE; j++)
+            {
+                for (Object* obj = sender->object_table[j]; NULL != obj; obj = obj->next)
+                    list[count++] = obj;
+            }
+        }
+    }
+    qsort(list, count, sizeof(Object*), CompareObjects);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        const Object& obj = *list[i];
+        double duration = obj.time_last - obj.time_first;
+        double kbps = (duration > 0.0) ? (8.0e-03 * obj.byte_count / duration) : 0.0;
+        double rptAvg = (0 != obj.repair_samples) ? (obj.repair_delay_sum / (double)obj.repair_samples) : 0.0;
+        fprintf(filePtr, "0x%08lx %6hu %17.6f %17.6f %8lu %12.0f %10.3f %7lu %6lu %6lu %8lu %6lu %9.3f %9.3f\n",
+                (unsigned long)obj.sender_id, obj.object_id, obj.time_first, obj.time_last,
+                (unsigned long)obj.pkt_count, obj.byte_count, kbps, (unsigned long)obj.repair_count,
+                (unsigned long)obj.nack_count, (unsigned long)obj.run_count,
+                (unsigned long)obj.lost_count, (unsigned long)obj.run_max,
+                1.0e+03 * rptAvg, 1.0e+03 * obj.repair_delay_max);
+    }
+    delete[] list;
+}  // end NormTraceSummary::Print()
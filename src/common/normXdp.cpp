@@ -0,0 +1,239 @@
+#include "normXdp.h"
+
+#ifdef NORM_XDP
+#include <sys/socket.h>
+#include <sys/mman.h>
+#include <net/if.h>   // for if_nametoindex()
+#include <linux/if_link.h>  // for XDP_FLAGS_*
+#include <errno.h>
+#include <string.h>  // for strerror()
+
+NormXdpSocket::NormXdpSocket()
+ : if_index(0), zero_copy(false), umem_area(NULL), umem(NULL), xsk(NULL),
+   rx_index(0), rx_count(0), tx_free_list(NULL), tx_free_count(0), tx_pending(0)
+{
+}
+
+NormXdpSocket::~NormXdpSocket()
+{
+    Close();
+}
+
+bool NormXdpSocket::Open(const char* ifaceName, unsigned int queueId)
+{
+    if (IsOpen()) Close();
+    if (0 == (if_index = if_nametoindex(ifaceName)))
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::Open() error: invalid interface \"%s\"\n", ifaceName);
+        return false;
+    }
+    size_t umemSize = (size_t)FRAME_COUNT * FRAME_SIZE;
+    void* area = mmap(NULL, umemSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == area)
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::Open() mmap() error: %s\n", GetErrorString());
+        return false;
+    }
+    umem_area = (char*)area;
+    struct xsk_umem_config umemConfig;
+    memset(&umemConfig, 0, sizeof(umemConfig));
+    umemConfig.fill_size = RING_SIZE;
+    umemConfig.comp_size = RING_SIZE;
+    umemConfig.frame_size = FRAME_SIZE;
+    // (Received Ethernet frames start XDP_PACKET_HEADROOM + 2 bytes into their
+    //  frame so the IP header that follows the 14 byte Ethernet header is aligned)
+    umemConfig.frame_headroom = TX_OFFSET;
+    umemConfig.flags = 0;
+    int result = xsk_umem__create(&umem, umem_area, umemSize, &fill_ring, &comp_ring, &umemConfig);
+    if (0 != result)
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::Open() xsk_umem__create() error: %s\n", strerror(-result));
+        umem = NULL;
+        Close();
+        return false;
+    }
+    struct xsk_socket_config xskConfig;
+    memset(&xskConfig, 0, sizeof(xskConfig));
+    xskConfig.rx_size = RING_SIZE;
+    xskConfig.tx_size = RING_SIZE;
+    xskConfig.xdp_flags = XDP_FLAGS_UPDATE_IF_NOEXIST;
+    // Try zero-copy first, falling back to copy mode (e.g., driver lacks support)
+    xskConfig.bind_flags = XDP_USE_NEED_WAKEUP | XDP_ZEROCOPY;
+    result = xsk_socket__create(&xsk, ifaceName, queueId, umem, &rx_ring, &tx_ring, &xskConfig);
+    if (0 != result)
+    {
+        PLOG(PL_INFO, "NormXdpSocket::Open() zero-copy bind to %s queue %u failed (%s), trying copy mode\n",
+                      ifaceName, queueId, strerror(-result));
+        xskConfig.bind_flags = XDP_USE_NEED_WAKEUP | XDP_COPY;
+        result = xsk_socket__create(&xsk, ifaceName, queueId, umem, &rx_ring, &tx_ring, &xskConfig);
+    }
+    else
+    {
+        zero_copy = true;
+    }
+    if (0 != result)
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::Open() xsk_socket__create(%s, %u) error: %s\n",
+                       ifaceName, queueId, strerror(-result));
+        xsk = NULL;
+        Close();
+        return false;
+    }
+    // Give the first half of the UMEM frames to the kernel for reception ...
+    UINT32 fillIndex;
+    if (RING_SIZE != xsk_ring_prod__reserve(&fill_ring, RING_SIZE, &fillIndex))
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::Open() error: unable to populate fill ring\n");
+        Close();
+        return false;
+    }
+    for (unsigned int i = 0; i < RING_SIZE; i++)
+        *xsk_ring_prod__fill_addr(&fill_ring, fillIndex++) = (UINT64)i * FRAME_SIZE;
+    xsk_ring_prod__submit(&fill_ring, RING_SIZE);
+    // ... and keep the second half as our free list of tx frames
+    if (NULL == (tx_free_list = new UINT64[RING_SIZE]))
+    {
+        PLOG(PL_FATAL, "NormXdpSocket::Open() new tx_free_list error: %s\n", GetErrorString());
+        Close();
+        return false;
+    }
+    for (unsigned int i = 0; i < RING_SIZE; i++)
+        tx_free_list[i] = (UINT64)(RING_SIZE + i) * FRAME_SIZE;
+    tx_free_count = RING_SIZE;
+    tx_pending = rx_count = 0;
+    descriptor = xsk_socket__fd(xsk);
+    if (!ProtoChannel::Open())
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::Open() error: unable to open channel\n");
+        Close();
+        return false;
+    }
+    PLOG(PL_INFO, "NormXdpSocket::Open() bound to %s queue %u (%s mode)\n",
+                  ifaceName, queueId, zero_copy ? "zero-copy" : "copy");
+    return true;
+}  // end NormXdpSocket::Open()
+
+void NormXdpSocket::Close()
+{
+    if (IsOpen()) ProtoChannel::Close();
+    descriptor = INVALID_HANDLE;
+    if (NULL != xsk)
+    {
+        xsk_socket__delete(xsk);
+        xsk = NULL;
+    }
+    if (NULL != umem)
+    {
+        xsk_umem__delete(umem);
+        umem = NULL;
+    }
+    if (NULL != umem_area)
+    {
+        munmap(umem_area, (size_t)FRAME_COUNT * FRAME_SIZE);
+        umem_area = NULL;
+    }
+    if (NULL != tx_free_list)
+    {
+        delete[] tx_free_list;
+        tx_free_list = NULL;
+    }
+    tx_free_count = tx_pending = rx_count = 0;
+    zero_copy = false;
+    if_index = 0;
+}  // end NormXdpSocket::Close()
+
+unsigned int NormXdpSocket::RecvPeek(unsigned int maxFrames)
+{
+    if (0 != rx_count) RecvRelease();
+    rx_count = xsk_ring_cons__peek(&rx_ring, maxFrames, &rx_index);
+    return rx_count;
+}  // end NormXdpSocket::RecvPeek()
+
+const char* NormXdpSocket::GetRxFrame(unsigned int index, unsigned int& frameLen) const
+{
+    const struct xdp_desc* desc = xsk_ring_cons__rx_desc(&rx_ring, rx_index + index);
+    frameLen = desc->len;
+    return (const char*)xsk_umem__get_data(umem_area, desc->addr);
+}  // end NormXdpSocket::GetRxFrame()
+
+void NormXdpSocket::RecvRelease()
+{
+    if (0 == rx_count) return;
+    // Hand the frames straight back to the kernel via the fill ring
+    // (the fill ring is sized to hold all rx frames so this won't fail)
+    UINT32 fillIndex;
+    if (rx_count == xsk_ring_prod__reserve(&fill_ring, rx_count, &fillIndex))
+    {
+        for (unsigned int i = 0; i < rx_count; i++)
+        {
+            const struct xdp_desc* desc = xsk_ring_cons__rx_desc(&rx_ring, rx_index + i);
+            *xsk_ring_prod__fill_addr(&fill_ring, fillIndex++) = desc->addr;
+        }
+        xsk_ring_prod__submit(&fill_ring, rx_count);
+    }
+    else
+    {
+        PLOG(PL_ERROR, "NormXdpSocket::RecvRelease() error: fill ring full?!\n");
+    }
+    xsk_ring_cons__release(&rx_ring, rx_count);
+    rx_count = 0;
+    if (xsk_ring_prod__needs_wakeup(&fill_ring))
+        recvfrom(descriptor, NULL, 0, MSG_DONTWAIT, NULL, NULL);
+}  // end NormXdpSocket::RecvRelease()
+
+char* NormXdpSocket::GetTxFrame(unsigned int& maxLen)
+{
+    if (0 == tx_free_count)
+    {
+        Reclaim();
+        if (0 == tx_free_count) return NULL;
+    }
+    maxLen = FRAME_SIZE - TX_OFFSET;
+    return (char*)xsk_umem__get_data(umem_area, tx_free_list[tx_free_count - 1] + TX_OFFSET);
+}  // end NormXdpSocket::GetTxFrame()
+
+bool NormXdpSocket::Send(char* frame, unsigned int frameLen)
+{
+    UINT32 txIndex;
+    if ((0 == tx_free_count) || (1 != xsk_ring_prod__reserve(&tx_ring, 1, &txIndex)))
+        return false;
+    UINT64 addr = (UINT64)(frame - umem_area);
+    // ("frame" should be the buffer returned by GetTxFrame())
+    ASSERT((tx_free_list[tx_free_count - 1] + TX_OFFSET) == addr);
+    tx_free_count--;
+    struct xdp_desc* desc = xsk_ring_prod__tx_desc(&tx_ring, txIndex);
+    desc->addr = addr;
+    desc->len = frameLen;
+    desc->options = 0;
+    xsk_ring_prod__submit(&tx_ring, 1);
+    tx_pending++;
+    return true;
+}  // end NormXdpSocket::Send()
+
+void NormXdpSocket::Flush()
+{
+    if ((0 != tx_pending) && xsk_ring_prod__needs_wakeup(&tx_ring))
+    {
+        if ((sendto(descriptor, NULL, 0, MSG_DONTWAIT, NULL, 0) < 0) &&
+            (ENOBUFS != errno) && (EAGAIN != errno) && (EBUSY != errno) && (ENETDOWN != errno))
+        {
+            PLOG(PL_WARN, "NormXdpSocket::Flush() sendto() error: %s\n", GetErrorString());
+        }
+    }
+    tx_pending = 0;
+    Reclaim();
+}  // end NormXdpSocket::Flush()
+
+void NormXdpSocket::Reclaim()
+{
+    UINT32 compIndex;
+    unsigned int count = xsk_ring_cons__peek(&comp_ring, RING_SIZE - tx_free_count, &compIndex);
+    for (unsigned int i = 0; i < count; i++)
+    {
+        UINT64 addr = *xsk_ring_cons__comp_addr(&comp_ring, compIndex++);
+        tx_free_list[tx_free_count++] = addr - (addr % FRAME_SIZE);
+    }
+    if (0 != count) xsk_ring_cons__release(&comp_ring, count);
+}  // end NormXdpSocket::Reclaim()
+
+#endif // NORM_XDP
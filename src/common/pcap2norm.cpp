@@ -9,7 +9,13 @@
 #include "protoPktIP.h"  // for IP packet parsing
 #include "protoPktARP.h"
 
+#include <sys/mman.h>     // for mmap()
+#include <sys/stat.h>     // for fstat()
+#include <pthread.h>
+
 #include "normSession.h"
+#include "normTraceRing.h"
+#include "normTraceSummary.h"
 
 void NormTrace2(const struct timeval &currentTime,
                 const NormMsg &msg,
@@ -17,35 +23,399 @@ void NormTrace2(const struct timeval &currentTime,
                 const ProtoAddress &dstAddr);
 void Usage()
 {
-    fprintf(stderr, "pcap2norm [pcapInputFile [outputFile]]\n");
+    fprintf(stderr, "pcap2norm [summary][threads <count>] [pcapInputFile [outputFile]]\n");
+    fprintf(stderr, "          (a NormWriteTraceRing() file may be given instead of a pcap file)\n");
+    fprintf(stderr, "          (\"summary\" prints per-object columns instead of trace lines, see normTraceSummary.h)\n");
 }
 
+// Parses a captured frame to the NORM message it carries (if any)
+static bool ParseFrame(int deviceType, const u_char *pktData, unsigned int capLen,
+                       unsigned int frameLen, NormMsg &msg, ProtoAddress &srcAddr,
+                       ProtoAddress &dstAddr)
+{
+    UINT32 alignedBuffer[4096 / 4]; // 4096 byte buffer for packet parsing
+    UINT16 *ethBuffer = ((UINT16 *)alignedBuffer) + 1;
+    unsigned int maxBytes = 4096 - 2; // due to offset, can only use 4094 bytes of buffer
+
+    unsigned int numBytes = maxBytes;
+    if (capLen < numBytes)
+        numBytes = capLen;
+    ProtoPktETH::Type ethType;
+    unsigned int payloadLength;
+    UINT32 *payloadPtr;
+    if (DLT_LINUX_SLL == deviceType)
+    {
+        // For now, assume the header is 16 bytes (6-byte link addr)
+        // TBD - do proper DLT_LINUX_SLL parsing
+        memcpy(alignedBuffer, pktData, numBytes);
+        //ethType = (ProtoPktETH::Type)ntohs(((UINT16*)alignedBuffer)[7]);
+        payloadPtr = alignedBuffer + 4;  // assumes 16 byte header
+        //ipBufferBytes = maxBytes + 2 - 16;
+        payloadLength = numBytes - 16;
+        ethType = ProtoPktETH::IP;
+
+    }
+    else if (DLT_NULL == deviceType)
+    {
+        // pcap was captured from "loopback" device
+        memcpy(alignedBuffer, pktData, numBytes);
+        switch (alignedBuffer[0])
+        {
+        case PF_INET:
+            ethType = ProtoPktETH::IP;
+            break;
+        case PF_INET6:
+            ethType = ProtoPktETH::IPv6;
+            break;
+        default:
+            return false; // not an IP packet
+        }
+        payloadLength = numBytes - 4;
+        payloadPtr = alignedBuffer + 1;
+    }
+    else
+    {
+        memcpy(ethBuffer, pktData, numBytes);
+        ProtoPktETH ethPkt(ethBuffer, maxBytes);
+        if (!ethPkt.InitFromBuffer(frameLen))
+        {
+            fprintf(stderr, "pcap2norm error: invalid Ether frame in pcap file\n");
+            return false;
+        }
+        ethType = ethPkt.GetType();
+        payloadLength = ethPkt.GetPayloadLength();
+        // This is done know we offset the ethBuffer above
+        payloadPtr = alignedBuffer + (2 + ethPkt.GetLength() - ethPkt.GetPayloadLength()) / 4;
+        //payloadPtr = (UINT32*)ethPkt.AccessPayload();
+    }
+
+    ProtoPktIP ipPkt;
+    srcAddr.Invalidate();
+    dstAddr.Invalidate();
+    if ((ProtoPktETH::IP == ethType) ||
+        (ProtoPktETH::IPv6 == ethType))
+    {
+        if (!ipPkt.InitFromBuffer(payloadLength, payloadPtr, payloadLength))
+        {
+            fprintf(stderr, "pcap2norm error: bad IP packet\n");
+            return false;
+        }
+        switch (ipPkt.GetVersion())
+        {
+        case 4:
+        {
+            ProtoPktIPv4 ip4Pkt(ipPkt);
+            ip4Pkt.GetDstAddr(dstAddr);
+            ip4Pkt.GetSrcAddr(srcAddr);
+            break;
+        }
+        case 6:
+        {
+            ProtoPktIPv6 ip6Pkt(ipPkt);
+            ip6Pkt.GetDstAddr(dstAddr);
+            ip6Pkt.GetSrcAddr(srcAddr);
+            break;
+        }
+        default:
+        {
+            PLOG(PL_ERROR, "pcap2norm Error: Invalid IP pkt version.\n");
+            break;
+        }
+        }
+        //PLOG(PL_ALWAYS, "pcap2norm IP packet dst>%s ", dstAddr.GetHostString());
+        //PLOG(PL_ALWAYS," src>%s length>%d\n", srcAddr.GetHostString(), ipPkt.GetLength());
+    }
+    else
+    {
+        fprintf(stderr, "eth type = %d\n", ethType);
+    }
+    if (!srcAddr.IsValid())
+        return false; // wasn't an IP packet
+
+    ProtoPktUDP udpPkt;
+    if (!udpPkt.InitFromPacket(ipPkt))
+        return false; // not a UDP packet
+
+    if (!msg.CopyFromBuffer((const char *)udpPkt.GetPayload(), udpPkt.GetPayloadLength()))
+    {
+        fprintf(stderr, "pcap2norm warning: UDP packet not an MGEN packet?\n");
+        return false;
+    }
+    srcAddr.SetPort(udpPkt.GetSrcPort());
+    msg.AccessAddress() = srcAddr;
+    dstAddr.SetPort(udpPkt.GetDstPort());
+    return true;
+} // end ParseFrame()
+
+// The sender a captured message pertains to (see NormTraceSummary::Add())
+static UINT32 GetSenderId(const NormMsg &msg)
+{
+    switch (msg.GetType())
+    {
+    case NormMsg::NACK:
+        return (UINT32)static_cast<const NormNackMsg &>(msg).GetSenderId();
+    case NormMsg::ACK:
+        return (UINT32)static_cast<const NormAckMsg &>(msg).GetSenderId();
+    default:
+        return (UINT32)msg.GetSourceId();
+    }
+} // end GetSenderId()
+
+// PcapMap reads a pcap file through a read-only memory mapping (instead of
+// pcap_next() copies) and can index its records so ranges of them can be
+// decoded in parallel.
+class PcapMap
+{
+public:
+    PcapMap() : base(NULL), size(0), link_type(0), swapped(false), nsec(false) {}
+    ~PcapMap() { Close(); }
+
+    enum
+    {
+        FILE_HEADER_SIZE = 24,
+        RECORD_HEADER_SIZE = 16
+    };
+
+    bool Open(FILE *filePtr)
+    {
+        struct stat info;
+        int fd = fileno(filePtr);
+        if ((0 != fstat(fd, &info)) || (info.st_size < FILE_HEADER_SIZE))
+            return false;
+        void *ptr = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (MAP_FAILED == ptr)
+            return false;
+        base = (const u_char *)ptr;
+        size = (size_t)info.st_size;
+        madvise(ptr, size, MADV_SEQUENTIAL);
+        UINT32 magic;
+        memcpy(&magic, base, 4);
+        swapped = false;
+        switch (magic)
+        {
+        case 0xd4c3b2a1:
+            swapped = true; // (and fall through)
+        case 0xa1b2c3d4:
+            nsec = false;
+            break;
+        case 0x4d3cb2a1:
+            swapped = true; // (and fall through)
+        case 0xa1b23c4d:
+            nsec = true;
+            break;
+        default:
+            Close(); // not a (classic) pcap file
+            return false;
+        }
+        link_type = (int)GetUINT32(base + 20);
+        return true;
+    }
+    void Close()
+    {
+        if (NULL != base)
+            munmap((void *)base, size);
+        base = NULL;
+        size = 0;
+    }
+    int GetLinkType() const { return link_type; }
+
+    // Steps from the record at "offset" (FILE_HEADER_SIZE is the first),
+    // returns false at the end of the file
+    bool GetRecord(size_t &offset, struct timeval &ts, const u_char *&data,
+                   unsigned int &capLen, unsigned int &frameLen) const
+    {
+        if ((size - offset) < RECORD_HEADER_SIZE)
+            return false;
+        const u_char *hdr = base + offset;
+        capLen = GetUINT32(hdr + 8);
+        if ((size - offset - RECORD_HEADER_SIZE) < capLen)
+            return false; // (truncated capture)
+        ts.tv_sec = GetUINT32(hdr);
+        ts.tv_usec = nsec ? (GetUINT32(hdr + 4) / 1000) : GetUINT32(hdr + 4);
+        frameLen = GetUINT32(hdr + 12);
+        data = hdr + RECORD_HEADER_SIZE;
+        offset += RECORD_HEADER_SIZE + capLen;
+        return true;
+    }
+
+private:
+    UINT32 GetUINT32(const u_char *ptr) const
+    {
+        UINT32 value;
+        memcpy(&value, ptr, 4);
+        if (swapped)
+            value = ((value >> 24) | ((value >> 8) & 0x0000ff00) |
+                     ((value << 8) & 0x00ff0000) | (value << 24));
+        return value;
+    }
+
+    const u_char *base;
+    size_t size;
+    int link_type;
+    bool swapped;
+    bool nsec;
+}; // end class PcapMap
+
+// For the "summary", up to WINDOW_SIZE records at a time are split among the
+// threads to decode (the costly part) and then added to the summary in order
+// (since its sequence gap and NACK to repair figures depend on that order)
+class SummaryWorker
+{
+public:
+    enum {WINDOW_SIZE = 1 << 20};
+
+    const PcapMap *map;
+    const size_t *offset_list;
+    unsigned int offset_count;
+    NormTraceRing records;   // (the decoded NORM messages)
+    UINT32 *sender_list;     // (and the senders they pertain to)
+    pthread_t thread;
+
+    static void *DoWork(void *arg)
+    {
+        ((SummaryWorker *)arg)->Decode();
+        return NULL;
+    }
+    void Decode()
+    {
+        records.Open(offset_count);
+        for (unsigned int i = 0; i < offset_count; i++)
+        {
+            size_t offset = offset_list[i];
+            struct timeval ts;
+            const u_char *data;
+            unsigned int capLen, frameLen;
+            map->GetRecord(offset, ts, data, capLen, frameLen);
+            NormMsg msg;
+            ProtoAddress srcAddr, dstAddr;
+            if (!ParseFrame(map->GetLinkType(), data, capLen, frameLen, msg, srcAddr, dstAddr))
+                continue;
+            sender_list[records.GetCount()] = GetSenderId(msg);
+            records.Add(ts, msg, false, 8, 0); // NOTE - assumes 16-bit RS code, as NormTrace2()
+        }
+    }
+}; // end class SummaryWorker
+
+static bool SummarizeMap(const PcapMap &map, unsigned int numThreads, NormTraceSummary &summary)
+{
+    size_t *offsetList = new size_t[SummaryWorker::WINDOW_SIZE];
+    UINT32 *senderList = new UINT32[SummaryWorker::WINDOW_SIZE];
+    SummaryWorker *workerList = new SummaryWorker[numThreads];
+    if ((NULL == offsetList) || (NULL == senderList) || (NULL == workerList))
+    {
+        fprintf(stderr, "pcap2norm: memory allocation error\n");
+        delete[] offsetList;
+        delete[] senderList;
+        delete[] workerList;
+        return false;
+    }
+    size_t offset = PcapMap::FILE_HEADER_SIZE;
+    while (true)
+    {
+        // Index the next window of records
+        unsigned int count = 0;
+        while (count < SummaryWorker::WINDOW_SIZE)
+        {
+            size_t recordOffset = offset;
+            struct timeval ts;
+            const u_char *data;
+            unsigned int capLen, frameLen;
+            if (!map.GetRecord(offset, ts, data, capLen, frameLen))
+                break;
+            offsetList[count++] = recordOffset;
+        }
+        if (0 == count)
+            break;
+        unsigned int chunk = (count + numThreads - 1) / numThreads;
+        for (unsigned int i = 0; i < numThreads; i++)
+        {
+            SummaryWorker &worker = workerList[i];
+            unsigned int start = i * chunk;
+            worker.map = &map;
+            worker.offset_list = offsetList + start;
+            worker.offset_count = (start < count) ? MIN(chunk, count - start) : 0;
+            worker.sender_list = senderList + start;
+        }
+        // (the last range is decoded by this thread)
+        for (unsigned int i = 0; i + 1 < numThreads; i++)
+        {
+            if (0 != pthread_create(&workerList[i].thread, NULL, SummaryWorker::DoWork, workerList + i))
+            {
+                fprintf(stderr, "pcap2norm: pthread_create() error: %s\n", GetErrorString());
+                workerList[i].thread = pthread_self();
+                workerList[i].Decode();
+            }
+        }
+        workerList[numThreads - 1].Decode();
+        for (unsigned int i = 0; i < numThreads; i++)
+        {
+            SummaryWorker &worker = workerList[i];
+            if ((i + 1 < numThreads) && !pthread_equal(worker.thread, pthread_self()))
+                pthread_join(worker.thread, NULL);
+            for (unsigned int j = 0; j < worker.records.GetCount(); j++)
+                summary.Add(worker.records.GetRecord(j), worker.sender_list[j]);
+            worker.records.Close();
+        }
+        if (count < SummaryWorker::WINDOW_SIZE)
+            break;
+    }
+    delete[] workerList;
+    delete[] senderList;
+    delete[] offsetList;
+    return true;
+} // end SummarizeMap()
+
 int main(int argc, char *argv[])
 {
     // Use stdin/stdout by default
     FILE *infile = stdin;
     FILE *outfile = stdout;
-    switch (argc)
+    bool summaryMode = false;
+    unsigned int numThreads = 1;
+    int argIndex = 1;
+    while (argIndex < argc)
     {
-    case 1:
+        if (0 == strcmp("summary", argv[argIndex]))
+        {
+            summaryMode = true;
+            argIndex++;
+        }
+        else if (0 == strcmp("threads", argv[argIndex]))
+        {
+            if (((argIndex + 1) >= argc) || (1 != sscanf(argv[argIndex + 1], "%u", &numThreads)) || (0 == numThreads))
+            {
+                fprintf(stderr, "pcap2norm: error: invalid \"threads\" count!\n");
+                Usage();
+                return -1;
+            }
+            argIndex += 2;
+        }
+        else
+        {
+            break;
+        }
+    }
+    switch (argc - argIndex)
+    {
+    case 0:
         // using default stdin/stdout
         break;
-    case 2:
+    case 1:
         // using named input pcap file and stdout
-        if (NULL == (infile = fopen(argv[1], "r")))
+        if (NULL == (infile = fopen(argv[argIndex], "r")))
         {
             perror("pcap2norm: error opening input file");
             return -1;
         }
         break;
-    case 3:
+    case 2:
         // use name input and output files
-        if (NULL == (infile = fopen(argv[1], "r")))
+        if (NULL == (infile = fopen(argv[argIndex], "r")))
         {
             perror("pcap2norm: error opening input file");
             return -1;
         }
-        if (NULL == (outfile = fopen(argv[2], "w+")))
+        if (NULL == (outfile = fopen(argv[argIndex + 1], "w+")))
         {
             perror("pcap2norm: error opening output file");
             return -1;
@@ -55,7 +425,62 @@ int main(int argc, char *argv[])
         fprintf(stderr, "pcap2norm: error: too many arguments!\n");
         Usage();
         return -1;
-    } // end switch(argc)
+    } // end switch(argc - argIndex)
+
+    NormTraceSummary summary;
+    // A named input file may be a binary NormTraceRing file instead
+    if (stdin != infile)
+    {
+        UINT32 localId, recordCount;
+        if (NormTraceRing::ReadHeader(infile, localId, recordCount))
+        {
+            NormTraceRing::Record record;
+            while (NormTraceRing::ReadRecord(infile, record))
+            {
+                if (summaryMode)
+                    summary.Add(record, NormTraceSummary::GetSenderId(record, localId));
+                else
+                    NormTraceRing::Print(outfile, localId, record);
+            }
+            if (summaryMode)
+                summary.Print(outfile);
+            fclose(infile);
+            if (stdout != outfile)
+                fclose(outfile);
+            return 0;
+        }
+        rewind(infile);
+    }
+
+    // Named pcap files are memory mapped
+    PcapMap pcapMap;
+    if ((stdin != infile) && pcapMap.Open(infile))
+    {
+        if (summaryMode)
+        {
+            SummarizeMap(pcapMap, numThreads, summary);
+            summary.Print(outfile);
+        }
+        else
+        {
+            size_t offset = PcapMap::FILE_HEADER_SIZE;
+            struct timeval ts;
+            const u_char *data;
+            unsigned int capLen, frameLen;
+            while (pcapMap.GetRecord(offset, ts, data, capLen, frameLen))
+            {
+                NormMsg msg;
+                ProtoAddress srcAddr, dstAddr;
+                if (ParseFrame(pcapMap.GetLinkType(), data, capLen, frameLen, msg, srcAddr, dstAddr))
+                    NormTrace2(ts, msg, srcAddr, dstAddr);
+            }
+        }
+        pcapMap.Close();
+        fclose(infile);
+        if (stdout != outfile)
+            fclose(outfile);
+        return 0;
+    }
 
     char pcapErrBuf[PCAP_ERRBUF_SIZE + 1];
     pcapErrBuf[PCAP_ERRBUF_SIZE] = '\0';
@@ -71,126 +496,34 @@ int main(int argc, char *argv[])
     }
 
     int deviceType = pcap_datalink(pcapDevice);
-
-    UINT32 alignedBuffer[4096 / 4]; // 4096 byte buffer for packet parsing
-    UINT16 *ethBuffer = ((UINT16 *)alignedBuffer) + 1;
-    unsigned int maxBytes = 4096 - 2; // due to offset, can only use 4094 bytes of buffer
+    NormTraceRing records; // (one record at a time for the "summary")
+    if (summaryMode)
+        records.Open(1);
 
     pcap_pkthdr hdr;
     const u_char *pktData;
     while (NULL != (pktData = pcap_next(pcapDevice, &hdr)))
     {
-        unsigned int numBytes = maxBytes;
-        if (hdr.caplen < numBytes)
-            numBytes = hdr.caplen;
-        ProtoPktETH::Type ethType;
-        unsigned int payloadLength;
-        UINT32 *payloadPtr;
-        if (DLT_LINUX_SLL == deviceType)
-        {
-            // For now, assume the header is 16 bytes (6-byte link addr)
-            // TBD - do proper DLT_LINUX_SLL parsing
-            memcpy(alignedBuffer, pktData, numBytes);
-            //ethType = (ProtoPktETH::Type)ntohs(((UINT16*)alignedBuffer)[7]);
-            payloadPtr = alignedBuffer + 4;  // assumes 16 byte header
-            //ipBufferBytes = maxBytes + 2 - 16;
-            payloadLength = numBytes - 16;
-            ethType = ProtoPktETH::IP;
-
-        }
-        else if (DLT_NULL == deviceType)
-        {
-            // pcap was captured from "loopback" device
-            memcpy(alignedBuffer, pktData, numBytes);
-            switch (alignedBuffer[0])
-            {
-            case PF_INET:
-                ethType = ProtoPktETH::IP;
-                break;
-            case PF_INET6:
-                ethType = ProtoPktETH::IPv6;
-                break;
-            default:
-                continue; // not an IP packet
-            }
-            payloadLength = numBytes - 4;
-            payloadPtr = alignedBuffer + 1;
-        }
-        else
-        {
-            memcpy(ethBuffer, pktData, numBytes);
-            ProtoPktETH ethPkt(ethBuffer, maxBytes);
-            if (!ethPkt.InitFromBuffer(hdr.len))
-            {
-                fprintf(stderr, "pcap2norm error: invalid Ether frame in pcap file\n");
-                continue;
-            }
-            ethType = ethPkt.GetType();
-            payloadLength = ethPkt.GetPayloadLength();
-            // This is done know we offset the ethBuffer above
-            payloadPtr = alignedBuffer + (2 + ethPkt.GetLength() - ethPkt.GetPayloadLength()) / 4;
-            //payloadPtr = (UINT32*)ethPkt.AccessPayload();
-        }
-
-        ProtoPktIP ipPkt;
+        NormMsg msg;
         ProtoAddress srcAddr, dstAddr;
-        if ((ProtoPktETH::IP == ethType) ||
-            (ProtoPktETH::IPv6 == ethType))
+        if (!ParseFrame(deviceType, pktData, hdr.caplen, hdr.len, msg, srcAddr, dstAddr))
+            continue;
+        if (summaryMode)
         {
-            if (!ipPkt.InitFromBuffer(payloadLength, payloadPtr, payloadLength))
-            {
-                fprintf(stderr, "pcap2norm error: bad IP packet\n");
-                continue;
-            }
-            switch (ipPkt.GetVersion())
-            {
-            case 4:
-            {
-                ProtoPktIPv4 ip4Pkt(ipPkt);
-                ip4Pkt.GetDstAddr(dstAddr);
-                ip4Pkt.GetSrcAddr(srcAddr);
-                break;
-            }
-            case 6:
-            {
-                ProtoPktIPv6 ip6Pkt(ipPkt);
-                ip6Pkt.GetDstAddr(dstAddr);
-                ip6Pkt.GetSrcAddr(srcAddr);
-                break;
-            }
-            default:
-            {
-                PLOG(PL_ERROR, "pcap2norm Error: Invalid IP pkt version.\n");
-                break;
-            }
-            }
-            //PLOG(PL_ALWAYS, "pcap2norm IP packet dst>%s ", dstAddr.GetHostString());
-            //PLOG(PL_ALWAYS," src>%s length>%d\n", srcAddr.GetHostString(), ipPkt.GetLength());
+            records.Add(hdr.ts, msg, false, 8, 0);
+            summary.Add(records.GetRecord(0), GetSenderId(msg));
         }
         else
         {
-            fprintf(stderr, "eth type = %d\n", ethType);
-        }
-        if (!srcAddr.IsValid())
-            continue; // wasn't an IP packet
-
-        ProtoPktUDP udpPkt;
-        if (!udpPkt.InitFromPacket(ipPkt))
-            continue; // not a UDP packet
-
-        NormMsg msg;
-        if (msg.CopyFromBuffer((const char *)udpPkt.GetPayload(), udpPkt.GetPayloadLength()))
-        {
-            srcAddr.SetPort(udpPkt.GetSrcPort());
-            msg.AccessAddress() = srcAddr;
-            dstAddr.SetPort(udpPkt.GetDstPort());
             NormTrace2(hdr.ts, msg, srcAddr, dstAddr);
         }
-        else
-        {
-            fprintf(stderr, "pcap2norm warning: UDP packet not an MGEN packet?\n");
-        }
     } // end while (pcap_next())
+    if (summaryMode)
+        summary.Print(outfile);
+    pcap_close(pcapDevice);
+    if (stdout != outfile)
+        fclose(outfile);
+    return 0;
 
 } // end main()
 
@@ -1,5 +1,6 @@
 
 #include "protokit.h"
+#include "normMsgBatch.h"  // for NormRecvBatch, NormSendBatch
 #include <stdio.h>  // for sscanf()
 
 #ifdef UNIX
@@ -24,7 +25,8 @@ class RaftApp : public ProtoApp
     private:
         static void Usage()
         {
-            fprintf(stderr, "Usage: raft [listen [<groupAddr>/]<port>][dest <addr>/<port>][ipv4|ipv6]\n");
+            fprintf(stderr, "Usage: raft [listen [<groupAddr>/]<port>][dest <addr>/<port>][ipv4|ipv6]\n"
+                            "            [batch <count>][bench <rate>[/<size>]][report <interval>]\n");
         }
         enum CmdType {CMD_INVALID, CMD_NOARG, CMD_ARG};
         static CmdType GetCommandType(const char* cmd);    
@@ -38,12 +40,63 @@ class RaftApp : public ProtoApp
                                  const void*                 userData);
         void OnInputReady();
         
+        // The UDP datagrams received are written to stdout, and those read from
+        // stdin are sent, as <msgLength><datagram> messages (the 2-byte, network
+        // order "msgLength" includes itself) to suit the "norm" app "minput" and
+        // "moutput" options, so each datagram is a NormStreamObject message.
+        // Datagrams are received and sent in batches (recvmmsg()/sendmmsg()
+        // where available) and stdio is read and written in bulk.
+        enum
+        {
+            MSG_SIZE_MAX  = 8192,   // largest datagram relayed
+            IO_BUFFER_SIZE = 65536,
+            DEFAULT_BATCH = 32,
+            RX_YIELD_MAX  = 256     // datagrams received per socket event
+        };
+        void AppendOutput(const char* buffer, unsigned int numBytes);
+        void FlushOutput();
+        void SendDatagram(const char* buffer, unsigned int numBytes);
+        
         ProtoSocket     rx_socket;
         ProtoSocket     tx_socket;
         ProtoAddress    tx_address;
-        char            tx_msg_buffer[8194];
-        UINT16          tx_msg_length;
-        UINT16          tx_msg_index;
+        unsigned int    batch_size;
+        NormRecvBatch   rx_batch;
+        NormSendBatch   tx_batch;
+        char            in_buffer[IO_BUFFER_SIZE];
+        unsigned int    in_length;
+        bool            input_installed;
+        char            out_buffer[IO_BUFFER_SIZE];
+        unsigned int    out_length;
+        
+        // Benchmark mode: "bench" generates sequenced, timestamped datagrams
+        // into the output stream (in place of or along with "listen") and
+        // "report" periodically logs the latency and loss of those arriving
+        // on the input stream (the latency assumes synchronized clocks)
+        enum {BENCH_HEADER_SIZE = 16};  // magic, sequence, sec, usec
+        static const char BENCH_MAGIC[4];
+        bool OnBenchTimeout(ProtoTimer& theTimer);
+        bool OnReportTimeout(ProtoTimer& theTimer);
+        void UpdateBenchStats(const char* buffer, unsigned int numBytes);
+        bool InstallInput();
+        
+        ProtoTimer      bench_timer;
+        double          bench_rate;     // datagrams per second
+        unsigned int    bench_size;
+        char            bench_buffer[MSG_SIZE_MAX];
+        UINT32          bench_seq;
+        struct timeval  bench_start;
+        ProtoTimer      report_timer;
+        bool            report_sync;    // true once a bench datagram has arrived
+        UINT32          report_seq;     // next expected sequence number
+        unsigned int    report_count;
+        unsigned int    report_lost;
+        unsigned int    report_late;
+        double          report_delay_sum;
+        double          report_delay_min;
+        double          report_delay_max;
+        unsigned int    report_total_count;
+        unsigned int    report_total_lost;
         
         // RTSP proxy related members ...
         void OnProxySocketEvent(ProtoSocket&       theSocket,
@@ -62,12 +115,17 @@ class RaftApp : public ProtoApp
 		UINT16			rcv_port;
 };  // end class RaftApp
 
+const char RaftApp::BENCH_MAGIC[4] = {'R', 'A', 'F', 'T'};
+
 const char* const RaftApp::CMD_LIST[] = 
 {
     "+debug",        // debug <level>
     "+listen",       // recv [<mcastAddr>/]<port>
     "+dest",         // send <addr>/<port>
     "+rtspProxy",    // rtsp <rtspUrl>
+    "+batch",        // batch <count> (datagrams per recvmmsg()/sendmmsg(), 0 disables)
+    "+bench",        // bench <rate>[/<size>] (generate benchmark datagrams)
+    "+report",       // report <interval> (log benchmark latency and loss)
 	"-ipv4",         // rcv socket is IPv4 (default)
 	"-ipv6",         // rcv socket is IPv6
     NULL        
@@ -75,7 +133,11 @@ const char* const RaftApp::CMD_LIST[] =
 
 RaftApp::RaftApp()
  : rx_socket(ProtoSocket::UDP),
-   tx_socket(ProtoSocket::UDP), tx_msg_length(0), tx_msg_index(0),
+   tx_socket(ProtoSocket::UDP), batch_size(DEFAULT_BATCH), in_length(0), 
+   input_installed(false), out_length(0), bench_rate(0.0), bench_size(64), bench_seq(0),
+   report_sync(false), report_seq(0), report_count(0), report_lost(0), report_late(0),
+   report_delay_sum(0.0), report_delay_min(0.0), report_delay_max(0.0),
+   report_total_count(0), report_total_lost(0),
    rtsp_proxy_socket(ProtoSocket::TCP), rtsp_url(NULL),
    rtsp_client_socket(ProtoSocket::TCP), rcv_socket_type(IPV4),
    rcv_port(0)
@@ -83,6 +145,13 @@ RaftApp::RaftApp()
     rx_socket.SetNotifier(&GetSocketNotifier());
     rx_socket.SetListener(this, &RaftApp::OnRxSocketEvent);
     
+    bench_timer.SetListener(this, &RaftApp::OnBenchTimeout);
+    bench_timer.SetRepeat(-1);
+    report_timer.SetListener(this, &RaftApp::OnReportTimeout);
+    report_timer.SetRepeat(-1);
+    memset(bench_buffer, 0, MSG_SIZE_MAX);
+    bench_start.tv_sec = bench_start.tv_usec = 0;
+    
     rtsp_proxy_socket.SetNotifier(&GetSocketNotifier());
     rtsp_proxy_socket.SetListener(this, &RaftApp::OnProxySocketEvent);
     rtsp_client_socket.SetNotifier(&GetSocketNotifier());
@@ -133,6 +202,25 @@ bool RaftApp::OnStartup(int argc, const char*const* argv)
 			}
 		}
 	}
+    if (result && (batch_size > 1))
+    {
+        // (without batching, the datagrams are just received and sent one per call)
+        if (rx_socket.IsOpen() && NormRecvBatch::IsSupported() && !rx_batch.Init(batch_size))
+            PLOG(PL_WARN, "Raft::OnStartup() warning: unable to enable receive batching\n");
+        if (tx_socket.IsOpen() && NormSendBatch::IsSupported() && !tx_batch.Init(batch_size))
+            PLOG(PL_WARN, "Raft::OnStartup() warning: unable to enable send batching\n");
+    }
+    if (result && (bench_rate > 0.0))
+    {
+        // (the timer is at most 1 kHz, with OnBenchTimeout() catching up to the rate)
+        double interval = 1.0 / bench_rate;
+        bench_timer.SetInterval((interval > 0.001) ? interval : 0.001);
+        ProtoSystemTime(bench_start);
+        bench_seq = 0;
+        ActivateTimer(bench_timer);
+    }
+    if (result && (report_timer.GetInterval() > 0.0))
+        ActivateTimer(report_timer);
 
     if (result && !dispatcher.IsPending())
     {
@@ -145,6 +233,19 @@ bool RaftApp::OnStartup(int argc, const char*const* argv)
 
 void RaftApp::OnShutdown()
 {
+    if (bench_timer.IsActive()) bench_timer.Deactivate();
+    if (report_timer.IsActive()) report_timer.Deactivate();
+    FlushOutput();
+    if (!tx_batch.IsEmpty()) tx_batch.Flush(tx_socket);
+    rx_batch.Destroy();
+    tx_batch.Destroy();
+    if (input_installed)
+    {
+        dispatcher.RemoveGenericInput(fileno(stdin));
+        input_installed = false;
+    }
+    if (rx_socket.IsOpen()) rx_socket.Close();
+    if (tx_socket.IsOpen()) tx_socket.Close();
     if (rtsp_proxy_socket.IsOpen()) 
         rtsp_proxy_socket.Close();
     if (rtsp_client_socket.IsOpen()) 
@@ -186,14 +287,49 @@ bool RaftApp::OnCommand(const char* cmd, const char* arg)
             return false;  
         }
         tx_address.SetPort(port);
-        int fd = fileno(stdin);
-        if(-1 == fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK))
+        // (opened here so the send batch has a socket descriptor to use)
+        if (!tx_socket.IsOpen() && !tx_socket.Open(0, tx_address.GetType()))
         {
-           PLOG(PL_FATAL, "Raft::OnCommand() warning: fcntl(stdout, F_SETFL(O_NONBLOCK)) error: %s",
-                    strerror(errno));
+            PLOG(PL_FATAL, "Raft::OnCommand() tx_socket.Open() error\n");
+            return false;
+        }
+        if (!InstallInput()) return false;
+    }
+    else if (!strncmp(cmd, "batch", strlen(cmd)))
+    {
+        if (1 != sscanf(arg, "%u", &batch_size))
+        {
+            PLOG(PL_FATAL, "Raft::OnCommand() invalid batch count\n"); 
+            return false;  
+        }
+    }
+    else if (!strncmp(cmd, "bench", strlen(cmd)))
+    {
+        const char* ptr = strchr(arg, '/');
+        if ((1 != sscanf(arg, "%lf", &bench_rate)) || (bench_rate <= 0.0))
+        {
+            PLOG(PL_FATAL, "Raft::OnCommand() invalid bench rate\n"); 
+            return false;  
+        }
+        if ((NULL != ptr) && 
+            ((1 != sscanf(ptr+1, "%u", &bench_size)) || 
+             (bench_size < BENCH_HEADER_SIZE) || (bench_size > MSG_SIZE_MAX)))
+        {
+            PLOG(PL_FATAL, "Raft::OnCommand() invalid bench size (%d to %d bytes)\n", 
+                    BENCH_HEADER_SIZE, MSG_SIZE_MAX); 
+            return false;  
+        }
+    }
+    else if (!strncmp(cmd, "report", strlen(cmd)))
+    {
+        double interval;
+        if ((1 != sscanf(arg, "%lf", &interval)) || (interval <= 0.0))
+        {
+            PLOG(PL_FATAL, "Raft::OnCommand() invalid report interval\n"); 
+            return false;  
         }
-        tx_msg_length = tx_msg_index = 0;
-        dispatcher.InstallGenericInput(fileno(stdin), RaftApp::DoInputReady, this);
+        report_timer.SetInterval(interval);
+        if (!InstallInput()) return false;
     }
     else if (!strncmp(cmd, "listen", strlen(cmd)))
     {
@@ -314,101 +450,263 @@ void RaftApp::DoInputReady(ProtoDispatcher::Descriptor /*descriptor*/,
     ((RaftApp*)userData)->OnInputReady();   
 }  // end RaftApp::DoInputReady()
 
+bool RaftApp::InstallInput()
+{
+    if (input_installed) return true;
+    int fd = fileno(stdin);
+    if(-1 == fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK))
+    {
+       PLOG(PL_FATAL, "Raft::InstallInput() warning: fcntl(stdin, F_SETFL(O_NONBLOCK)) error: %s",
+                strerror(errno));
+    }
+    in_length = 0;
+    if (!dispatcher.InstallGenericInput(fd, RaftApp::DoInputReady, this))
+    {
+        PLOG(PL_FATAL, "Raft::InstallInput() error: unable to install stdin input\n");
+        return false;
+    }
+    input_installed = true;
+    return true;
+}  // end RaftApp::InstallInput()
+
 void RaftApp::OnInputReady()
 {
-    // Read from stdin ...
-    unsigned int want = tx_msg_length ? tx_msg_length - tx_msg_index : 2 - tx_msg_index;
-    if (want)
+    // Read what stdin has (in bulk, bypassing stdio buffering so a ready
+    // descriptor always means unread input) ...
+    ssize_t result = read(fileno(stdin), in_buffer+in_length, IO_BUFFER_SIZE - in_length);
+    if (result > 0)
     {
-        int result = fread(tx_msg_buffer+tx_msg_index, 1, want, stdin);
-        if (result > 0)
-        {
-            tx_msg_index += result;
-        }
-        else if (ferror(stdin))
+        in_length += result;
+    }
+    else if (0 == result)
+    {
+        PLOG(PL_ERROR, "raft: input end-of-file\n");
+        dispatcher.RemoveGenericInput(fileno(stdin));
+        input_installed = false;
+        return;
+    }
+    else
+    {
+        switch (errno)
         {
-            switch (errno)
-            {
-                case EINTR:
-                case EAGAIN:
-                    break;
-                default:
-                    PLOG(PL_ERROR, "raft: input error:%s\n", strerror(errno));
-                    break;   
-            }
-            clearerr(stdin);
+            case EINTR:
+            case EAGAIN:
+                break;
+            default:
+                PLOG(PL_ERROR, "raft: input error:%s\n", strerror(errno));
+                break;   
         }
-        else if (feof(stdin))
+        return;
+    }
+    // ... and send all of the complete messages it holds as one batch
+    unsigned int index = 0;
+    while ((in_length - index) >= 2)
+    {
+        UINT16 msgLength;
+        memcpy(&msgLength, in_buffer+index, 2);
+        msgLength = ntohs(msgLength);
+        if ((msgLength < 2) || (msgLength > (MSG_SIZE_MAX + 2)))
         {
-            PLOG(PL_ERROR, "raft: input end-of-file\n");
+            PLOG(PL_ERROR, "raft: input error: invalid msgLength: %u\n", msgLength);
             dispatcher.RemoveGenericInput(fileno(stdin));
+            input_installed = false;
             return;
         }
-    } 
-    if (0 == tx_msg_length)
+        if ((in_length - index) < msgLength) break;  // (incomplete message)
+        SendDatagram(in_buffer+index+2, msgLength-2);
+        index += msgLength;
+    }
+    if (!tx_batch.IsEmpty() && (NormSendBatch::FLUSH_FAILED == tx_batch.Flush(tx_socket)))
+        PLOG(PL_ERROR, "raft: tx_batch.Flush() error: %s\n", GetErrorString());
+    if (index > 0)
     {
-        if (2 == tx_msg_index)
-        {
-            memcpy(&tx_msg_length, tx_msg_buffer, 2);
-            tx_msg_length = ntohs(tx_msg_length);
-            if ((tx_msg_length < 2) || (tx_msg_length > 8194))
-            {
-                PLOG(PL_ERROR, "raft: input error: invalid tx_msg_length: %u\n", tx_msg_length);
-                dispatcher.RemoveGenericInput(fileno(stdin));
-                return;
-            }
-        }   
-        OnInputReady();
+        in_length -= index;
+        memmove(in_buffer, in_buffer+index, in_length);
     }
-    else if (tx_msg_index == tx_msg_length)
+}  // end RaftApp::OnInputReady()
+
+void RaftApp::SendDatagram(const char* buffer, unsigned int numBytes)
+{
+    if (report_timer.IsActive())
+        UpdateBenchStats(buffer, numBytes);
+    if (!tx_address.IsValid() || (0 == numBytes)) return;
+    if (tx_batch.IsEnabled())
     {
-        unsigned int bytesSent = tx_msg_length-2;
-        if (!tx_socket.SendTo(tx_msg_buffer+2, bytesSent, tx_address))
-        {
+        if (tx_batch.Queue(buffer, numBytes, tx_address)) return;
+        // The batch is full, so send it and try again
+        if (NormSendBatch::FLUSH_FAILED == tx_batch.Flush(tx_socket))
+            PLOG(PL_ERROR, "raft: tx_batch.Flush() error: %s\n", GetErrorString());
+        if (!tx_batch.Queue(buffer, numBytes, tx_address))
+            PLOG(PL_WARN, "raft: tx_batch blocked, datagram dropped\n");
+    }
+    else
+    {
+        unsigned int bytesSent = numBytes;
+        if (!tx_socket.SendTo(buffer, bytesSent, tx_address))
             PLOG(PL_ERROR, "raft: tx_socket.SendTo() error: %s\n", GetErrorString());
-            return;   
-        }
         else if (0 == bytesSent)
-        {
             PLOG(PL_WARN, "raft: tx_socket.SendTo() error: %s\n", GetErrorString());
-            return;  
-        }
-        tx_msg_index = tx_msg_length = 0;
     }
-    
-}  // end RaftApp::OnInputReady()
+}  // end RaftApp::SendDatagram()
 
-void RaftApp::OnRxSocketEvent(ProtoSocket&       /*theSocket*/,
-                              ProtoSocket::Event theEvent)
+void RaftApp::AppendOutput(const char* buffer, unsigned int numBytes)
+{
+    if ((numBytes + 2) > (IO_BUFFER_SIZE - out_length)) 
+        FlushOutput();
+    UINT16 msgLength = htons((UINT16)(numBytes + 2));
+    memcpy(out_buffer+out_length, &msgLength, 2);
+    memcpy(out_buffer+out_length+2, buffer, numBytes);
+    out_length += (numBytes + 2);
+}  // end RaftApp::AppendOutput()
+
+void RaftApp::FlushOutput()
 {
-    char buffer[8194];
-    unsigned int numBytes = 8192;
-    ProtoAddress srcAddr;
-    if (!rx_socket.RecvFrom(buffer+2, numBytes, srcAddr))
-    {
-        PLOG(PL_ERROR, "RaftApp::OnRxSocketEvent() rx_socket.RecvFrom() error\n");
-        return;
-    }
-    numBytes += 2;
-    UINT16 msgLength = htons((UINT16)numBytes);
-    memcpy(buffer, &msgLength, 2);
     unsigned int put = 0;
-    while (put < numBytes)
+    while (put < out_length)
     {
-        size_t result = fwrite(buffer+put, 1, numBytes-put, stdout);
+        size_t result = fwrite(out_buffer+put, 1, out_length-put, stdout);
         if (result > 0)
         {
             put += result;
         }
         else if (EINTR != errno)
         {
-            PLOG(PL_ERROR, "RaftApp::OnRxSocketEvent() fwrite() error: %s\n",
+            PLOG(PL_ERROR, "RaftApp::FlushOutput() fwrite() error: %s\n",
                     strerror(errno));
+            break;
         }          
     }
-    fflush(stdout);
+    if (0 != out_length) fflush(stdout);
+    out_length = 0;
+}  // end RaftApp::FlushOutput()
+
+void RaftApp::OnRxSocketEvent(ProtoSocket&       /*theSocket*/,
+                              ProtoSocket::Event theEvent)
+{
+    if (ProtoSocket::RECV != theEvent) return;
+    // Everything received this event goes to stdout with one write
+    unsigned int recvCount = 0;
+    while (recvCount < RX_YIELD_MAX)
+    {
+        if (rx_batch.IsEnabled())
+        {
+            int result = rx_batch.Recv(rx_socket);
+            if (result < 0)
+                PLOG(PL_ERROR, "RaftApp::OnRxSocketEvent() rx_batch.Recv() error\n");
+            if (result <= 0) break;
+            for (int i = 0; i < result; i++)
+            {
+                unsigned int numBytes = rx_batch.GetMsgLength(i);
+                if ((0 == numBytes) || (numBytes > MSG_SIZE_MAX))
+                    PLOG(PL_WARN, "RaftApp::OnRxSocketEvent() oversize datagram dropped\n");
+                else
+                    AppendOutput(rx_batch.AccessMsg(i).AccessBuffer(), numBytes);
+            }
+            recvCount += result;
+        }
+        else
+        {
+            char buffer[MSG_SIZE_MAX];
+            unsigned int numBytes = MSG_SIZE_MAX;
+            ProtoAddress srcAddr;
+            if (!rx_socket.RecvFrom(buffer, numBytes, srcAddr))
+            {
+                PLOG(PL_ERROR, "RaftApp::OnRxSocketEvent() rx_socket.RecvFrom() error\n");
+                break;
+            }
+            if (0 == numBytes) break;  // (nothing more to read)
+            AppendOutput(buffer, numBytes);
+            recvCount++;
+        }
+    }
+    FlushOutput();
 }  // end RaftApp::OnRxSocketEvent()
 
+bool RaftApp::OnBenchTimeout(ProtoTimer& /*theTimer*/)
+{
+    struct timeval currentTime;
+    ProtoSystemTime(currentTime);
+    double elapsed = (double)(currentTime.tv_sec - bench_start.tv_sec) +
+                     1.0e-06*((double)currentTime.tv_usec - (double)bench_start.tv_usec);
+    // Generate the datagrams due by now (a limited number per timeout, so
+    // after a stall the generator catches up over a few timeouts)
+    UINT32 due = (UINT32)(elapsed * bench_rate) + 1;
+    unsigned int count = 0;
+    while (((INT32)(due - bench_seq) > 0) && (count < RX_YIELD_MAX))
+    {
+        UINT32 temp32 = htonl(bench_seq++);
+        memcpy(bench_buffer, BENCH_MAGIC, 4);
+        memcpy(bench_buffer+4, &temp32, 4);
+        temp32 = htonl((UINT32)currentTime.tv_sec);
+        memcpy(bench_buffer+8, &temp32, 4);
+        temp32 = htonl((UINT32)currentTime.tv_usec);
+        memcpy(bench_buffer+12, &temp32, 4);
+        AppendOutput(bench_buffer, bench_size);
+        count++;
+    }
+    FlushOutput();
+    return true;
+}  // end RaftApp::OnBenchTimeout()
+
+void RaftApp::UpdateBenchStats(const char* buffer, unsigned int numBytes)
+{
+    if ((numBytes < BENCH_HEADER_SIZE) || (0 != memcmp(buffer, BENCH_MAGIC, 4)))
+        return;  // not a benchmark datagram
+    UINT32 seq, sec, usec;
+    memcpy(&seq, buffer+4, 4);
+    seq = ntohl(seq);
+    memcpy(&sec, buffer+8, 4);
+    sec = ntohl(sec);
+    memcpy(&usec, buffer+12, 4);
+    usec = ntohl(usec);
+    struct timeval currentTime;
+    ProtoSystemTime(currentTime);
+    double delay = (double)((UINT32)currentTime.tv_sec - sec) +
+                   1.0e-06*((double)currentTime.tv_usec - (double)usec);
+    if (!report_sync)
+    {
+        report_seq = seq;
+        report_sync = true;
+    }
+    INT32 delta = (INT32)(seq - report_seq);
+    if (delta >= 0)
+    {
+        // (a gap is counted as lost until the datagrams arrive late)
+        report_lost += delta;
+        report_total_lost += delta;
+        report_seq = seq + 1;
+    }
+    else
+    {
+        report_late++;
+        if (report_total_lost > 0) report_total_lost--;
+    }
+    if ((0 == report_count) || (delay < report_delay_min)) report_delay_min = delay;
+    if ((0 == report_count) || (delay > report_delay_max)) report_delay_max = delay;
+    report_delay_sum += delay;
+    report_count++;
+    report_total_count++;
+}  // end RaftApp::UpdateBenchStats()
+
+bool RaftApp::OnReportTimeout(ProtoTimer& /*theTimer*/)
+{
+    double totalLoss = (0 != report_total_count) ? 
+        (100.0 * report_total_lost) / (double)(report_total_count + report_total_lost) : 0.0;
+    if (0 != report_count)
+    {
+        PLOG(PL_ALWAYS, "raft: bench recv>%u lost>%u late>%u delay(msec) min>%.3lf avg>%.3lf max>%.3lf total loss>%.3lf%%\n",
+                report_count, report_lost, report_late, 1.0e+03*report_delay_min,
+                1.0e+03*report_delay_sum / (double)report_count, 1.0e+03*report_delay_max, totalLoss);
+    }
+    else
+    {
+        PLOG(PL_ALWAYS, "raft: bench recv>0 total loss>%.3lf%%\n", totalLoss);
+    }
+    report_count = report_lost = report_late = 0;
+    report_delay_sum = report_delay_min = report_delay_max = 0.0;
+    return true;
+}  // end RaftApp::OnReportTimeout()
+
 void RaftApp::OnProxySocketEvent(ProtoSocket& /*theSocket*/,
                                  ProtoSocket::Event theEvent)
 {
@@ -106,6 +106,18 @@ namespace Mil.Navy.Nrl.Norm
         [DllImport(NORM_LIBRARY)]
         public static extern bool NormGetNextEvent(long instanceHandle, out NormEvent theEvent, bool waitForEvent);
 
+        /// <summary>
+        /// This function retrieves up to maxEvents pending NORM protocol events with a single handoff from the protocol engine.
+        /// </summary>
+        /// <param name="instanceHandle">The instanceHandle parameter specifies the applicable NORM protocol engine.</param>
+        /// <param name="eventList">The eventList parameter must point to an array of at least maxEvents NormEvent structures.</param>
+        /// <param name="maxEvents">The maximum number of events to retrieve.</param>
+        /// <param name="waitForEvent">waitForEvent specifies whether the call blocks until at least one event is available.</param>
+        /// <returns>The number of events retrieved. The handles of all returned events remain valid until the next
+        /// call to NormGetNextEvent() or NormGetNextEvents().</returns>
+        [DllImport(NORM_LIBRARY)]
+        public unsafe static extern uint NormGetNextEvents(long instanceHandle, NormEvent* eventList, uint maxEvents, bool waitForEvent);
+
         /// <summary>
         /// This function is used to retrieve a NormDescriptor (Unix int file descriptor or Win32 HANDLE) suitable for
         /// asynchronous I/O notification to avoid blocking calls to NormGetNextEvent().
@@ -1,4 +1,5 @@
-﻿using System.Runtime.InteropServices;
+﻿using System.Buffers;
+using System.Runtime.InteropServices;
 
 namespace Mil.Navy.Nrl.Norm
 {
@@ -10,6 +11,11 @@ namespace Mil.Navy.Nrl.Norm
     /// </remarks>
     public class NormData : NormObject
     {
+        /// <summary>
+        /// The pinned application memory of enqueued NORM_OBJECT_DATA objects, with the handle of the session each was enqueued in.
+        /// </summary>
+        private static Dictionary<long, (long SessionHandle, MemoryHandle MemoryHandle)> _pinnedData = new Dictionary<long, (long, MemoryHandle)>();
+
         /// <summary>
         /// Get the data storage area associated with a transport object of type NORM_OBJECT_DATA.
         /// </summary>
@@ -29,5 +35,55 @@ namespace Mil.Navy.Nrl.Norm
         internal NormData(long handle) : base(handle)
         {
         }
+
+        /// <summary>
+        /// Keeps the memory of an enqueued transport object pinned until the object is purged.
+        /// </summary>
+        /// <param name="handle">The handle of the enqueued transport object.</param>
+        /// <param name="sessionHandle">The handle of the session the object was enqueued in.</param>
+        /// <param name="memoryHandle">The pinned memory of the object.</param>
+        internal static void Pin(long handle, long sessionHandle, MemoryHandle memoryHandle)
+        {
+            lock (_pinnedData)
+            {
+                if (_pinnedData.Remove(handle, out var previous))
+                {
+                    previous.MemoryHandle.Dispose();
+                }
+                _pinnedData.Add(handle, (sessionHandle, memoryHandle));
+            }
+        }
+
+        /// <summary>
+        /// Releases the pinned memory, if any, of a purged transport object.
+        /// </summary>
+        /// <param name="handle">The handle of the purged transport object.</param>
+        internal static void Unpin(long handle)
+        {
+            lock (_pinnedData)
+            {
+                if (_pinnedData.Remove(handle, out var pinned))
+                {
+                    pinned.MemoryHandle.Dispose();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Releases the pinned memory of all transport objects enqueued in a session.
+        /// </summary>
+        /// <param name="sessionHandle">The handle of the session whose sender stopped.</param>
+        internal static void UnpinSession(long sessionHandle)
+        {
+            lock (_pinnedData)
+            {
+                var handles = _pinnedData.Where(p => p.Value.SessionHandle == sessionHandle).Select(p => p.Key).ToList();
+                foreach (var handle in handles)
+                {
+                    _pinnedData[handle].MemoryHandle.Dispose();
+                    _pinnedData.Remove(handle);
+                }
+            }
+        }
     }
 }
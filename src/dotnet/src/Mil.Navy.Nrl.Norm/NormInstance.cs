@@ -17,6 +17,10 @@ namespace Mil.Navy.Nrl.Norm
         /// The _handle refers to the NORM protocol engine instance
         /// </summary>
         private long _handle;
+        /// <summary>
+        /// Purged transport objects whose pinned memory is released at the next event retrieval.
+        /// </summary>
+        private List<long> _purgedObjects = new List<long>();
 
         /// <summary>
         /// Constructor for NormInstance with priority boost
@@ -122,14 +126,76 @@ namespace Mil.Navy.Nrl.Norm
         /// <returns>Returns an instance of NormEvent if NormGetNextEvent() returns true, returns null otherwise. </returns>
         public NormEvent? GetNextEvent(bool waitForEvent)
         {
+            ReleasePurgedObjects();
             bool success = NormGetNextEvent(_handle, out NormApi.NormEvent normEvent, waitForEvent);
             if (!success)
             {
                 return null;
             }
+            AddPurgedObject(normEvent);
             return new NormEvent(normEvent.Type, normEvent.Session, normEvent.Sender, normEvent.Object);
         }
 
+        /// <summary>
+        /// This function retrieves up to events.Length pending NORM protocol events with a single call to the protocol engine,
+        /// without allocating an object per event.
+        /// </summary>
+        /// <param name="events">The events retrieved are stored at the start of this span.</param>
+        /// <param name="waitForEvent">waitForEvent specifies whether the call blocks until at least one event is available.</param>
+        /// <returns>The number of events retrieved. Their handles remain valid until the next call to GetNextEvent() or GetNextEvents().</returns>
+        public int GetNextEvents(Span<NormApi.NormEvent> events, bool waitForEvent)
+        {
+            ReleasePurgedObjects();
+            if (events.IsEmpty)
+            {
+                return 0;
+            }
+
+            int count;
+            unsafe
+            {
+                fixed (NormApi.NormEvent* eventsPtr = events)
+                {
+                    count = (int)NormGetNextEvents(_handle, eventsPtr, (uint)events.Length, waitForEvent);
+                }
+            }
+            for (var i = 0; i < count; i++)
+            {
+                AddPurgedObject(events[i]);
+            }
+            return count;
+        }
+
+        /// <summary>
+        /// Notes a purged transport object, whose pinned memory (if any) must stay valid while its event is handled.
+        /// </summary>
+        /// <param name="normEvent">The retrieved event.</param>
+        private void AddPurgedObject(NormApi.NormEvent normEvent)
+        {
+            if (normEvent.Type == NormEventType.NORM_TX_OBJECT_PURGED)
+            {
+                lock (_purgedObjects)
+                {
+                    _purgedObjects.Add(normEvent.Object);
+                }
+            }
+        }
+
+        /// <summary>
+        /// Releases the pinned memory of transport objects purged by previously retrieved events.
+        /// </summary>
+        private void ReleasePurgedObjects()
+        {
+            lock (_purgedObjects)
+            {
+                foreach (var objectHandle in _purgedObjects)
+                {
+                    NormData.Unpin(objectHandle);
+                }
+                _purgedObjects.Clear();
+            }
+        }
+
         /// <summary>
         /// This function retrieves the next available NORM protocol event from the protocol engine.
         /// </summary>
@@ -433,6 +433,7 @@ namespace Mil.Navy.Nrl.Norm
         public void StopSender()
         {
             NormStopSender(_handle);
+            NormData.UnpinSession(_handle);
         }
 
         /// <summary>
@@ -611,6 +612,68 @@ namespace Mil.Navy.Nrl.Norm
             return new NormData(objectHandle);
         }
 
+        /// <summary>
+        /// This function enqueues application memory for transmission without copying it.
+        /// </summary>
+        /// <remarks>
+        /// This is an overload which will call DataEnqueue() with empty info.
+        /// </remarks>
+        /// <param name="data">The data to be transmitted.</param>
+        /// <returns>A NormData is returned which the application may use in other NORM API calls as needed.</returns>
+        /// <exception cref="IOException">Thrown when NormDataEnqueue() returns NORM_OBJECT_INVALID, indicating the failure to enqueue data.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">Thrown when the data is empty.</exception>
+        public NormData DataEnqueue(ReadOnlyMemory<byte> data)
+        {
+            return DataEnqueue(data, ReadOnlySpan<byte>.Empty);
+        }
+
+        /// <summary>
+        /// This function enqueues application memory for transmission without copying it.
+        /// </summary>
+        /// <remarks>
+        /// The data memory stays pinned, and must not be modified, until the NORM_TX_OBJECT_PURGED event for the
+        /// returned object has been retrieved and the next event retrieved after it, or until the sender is stopped.
+        /// The info content is copied by the protocol engine.
+        /// </remarks>
+        /// <param name="data">The data to be transmitted.</param>
+        /// <param name="info">The optional NORM_INFO content to associate with the sent transport object.</param>
+        /// <returns>A NormData is returned which the application may use in other NORM API calls as needed.</returns>
+        /// <exception cref="IOException">Thrown when NormDataEnqueue() returns NORM_OBJECT_INVALID, indicating the failure to enqueue data.</exception>
+        /// <exception cref="ArgumentOutOfRangeException">Thrown when the data is empty.</exception>
+        public NormData DataEnqueue(ReadOnlyMemory<byte> data, ReadOnlySpan<byte> info)
+        {
+            if (data.IsEmpty)
+            {
+                throw new ArgumentOutOfRangeException(nameof(data), "The data length is out of range");
+            }
+
+            long objectHandle;
+            var dataHandle = data.Pin();
+
+            try
+            {
+                unsafe
+                {
+                    fixed (byte* infoPtr = info)
+                    {
+                        objectHandle = NormDataEnqueue(_handle, (nint)dataHandle.Pointer, data.Length, (nint)infoPtr, info.Length);
+                    }
+                }
+                if (objectHandle == NormObject.NORM_OBJECT_INVALID)
+                {
+                    throw new IOException("Failed to enqueue data");
+                }
+            }
+            catch (Exception)
+            {
+                dataHandle.Dispose();
+                throw;
+            }
+
+            NormData.Pin(objectHandle, _handle, dataHandle);
+            return new NormData(objectHandle);
+        }
+
         /// <summary>
         /// This function opens a NORM_OBJECT_STREAM sender object and enqueues it for transmission.
         /// </summary>
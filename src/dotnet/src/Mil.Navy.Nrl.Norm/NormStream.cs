@@ -68,6 +68,27 @@
             return numBytes;
         }
 
+        /// <summary>
+        /// This function enqueues data for transmission within the NORM stream without copying it to an intermediate array.
+        /// </summary>
+        /// <param name="buffer">The data to be enqueued.</param>
+        /// <returns>This function returns the number of bytes of data successfully enqueued for NORM stream transmission.</returns>
+        public int Write(ReadOnlySpan<byte> buffer)
+        {
+            if (buffer.IsEmpty)
+            {
+                return 0;
+            }
+
+            unsafe
+            {
+                fixed (byte* bufferPtr = buffer)
+                {
+                    return NormStreamWrite(_handle, bufferPtr, buffer.Length);
+                }
+            }
+        }
+
         /// <summary>
         /// This function allows the application to indicate to the NORM protocol engine that the last data successfully written
         /// to the stream indicated by streamHandle corresponded to the end of an application-defined message boundary.
@@ -166,6 +187,34 @@
             return length;
         }
 
+        /// <summary>
+        /// This function can be used by the receiver application to read any available data from an incoming NORM stream
+        /// directly into the given buffer.
+        /// </summary>
+        /// <param name="buffer">The buffer where up to buffer.Length bytes of received data are stored.</param>
+        /// <returns>The length of data received, or -1 if a break in the stream occurred.</returns>
+        public int Read(Span<byte> buffer)
+        {
+            var length = buffer.Length;
+            if (length == 0)
+            {
+                return 0;
+            }
+
+            unsafe
+            {
+                fixed (byte* bufferPtr = buffer)
+                {
+                    if (!NormStreamRead(_handle, bufferPtr, ref length))
+                    {
+                        length = -1;
+                    }
+                }
+            }
+
+            return length;
+        }
+
         /// <summary>
         /// This function advances the read offset of the receive stream referenced by the streamHandle parameter to align
         /// with the next available message boundary
@@ -952,6 +952,85 @@ namespace Mil.Navy.Nrl.Norm.IntegrationTests
             }
         }
 
+        [SkippableFact(typeof(IOException))]
+        public void EnqueuesDataFromMemory()
+        {
+            StartSender();
+            var dataContent = GenerateTextContent();
+            var data = new ReadOnlyMemory<byte>(Encoding.ASCII.GetBytes(dataContent));
+            var infoContent = GenerateInfoContent();
+            var info = Encoding.ASCII.GetBytes(infoContent);
+
+            try
+            {
+                var normData = _normSession.DataEnqueue(data, info);
+                var expectedEventTypes = new List<NormEventType> { NormEventType.NORM_TX_OBJECT_SENT, NormEventType.NORM_TX_QUEUE_EMPTY };
+                var actualEventTypes = GetEvents().Select(e => e.Type).ToList();
+                Assert.Equal(expectedEventTypes, actualEventTypes);
+                Assert.Equal(data.ToArray(), normData.GetData());
+                Assert.Equal(info, normData.Info);
+            }
+            catch (Exception)
+            {
+                throw;
+            }
+            finally
+            {
+                StopSender();
+            }
+        }
+
+        [SkippableFact(typeof(IOException))]
+        public void ReceivesStreamIntoSpan()
+        {
+            _normSession.SetLoopback(true);
+            StartSender();
+            StartReceiver();
+
+            var content = GenerateTextContent();
+            var buffer = Encoding.ASCII.GetBytes(content);
+            NormStream? normStream = null;
+
+            try
+            {
+                var repairWindowSize = 1024 * 1024;
+                normStream = _normSession.StreamOpen(repairWindowSize);
+                var actualBytesWritten = normStream.Write(new ReadOnlySpan<byte>(buffer));
+                Assert.Equal(buffer.Length, actualBytesWritten);
+                normStream.MarkEom();
+                normStream.Flush();
+
+                var normEvents = new NormApi.NormEvent[16];
+                NormEvent? normObjectEvent = null;
+                while (normObjectEvent == null && _normInstance.HasNextEvent(TimeSpan.FromMilliseconds(30)))
+                {
+                    var count = _normInstance.GetNextEvents(normEvents, false);
+                    foreach (var e in normEvents.Take(count).Where(ev => ev.Type == NormEventType.NORM_RX_OBJECT_UPDATED))
+                    {
+                        normObjectEvent = new NormEvent(e.Type, e.Session, e.Sender, e.Object);
+                        break;
+                    }
+                }
+                Assert.NotNull(normObjectEvent);
+
+                var receivedNormStream = Assert.IsType<NormStream>(normObjectEvent.Object);
+                var receiveBuffer = new byte[65536];
+                var numRead = receivedNormStream.Read(receiveBuffer.AsSpan());
+                Assert.Equal(buffer.Length, numRead);
+                Assert.Equal(content, Encoding.ASCII.GetString(receiveBuffer, 0, numRead));
+            }
+            catch (Exception)
+            {
+                throw;
+            }
+            finally
+            {
+                normStream?.Close(true);
+                StopSender();
+                StopReceiver();
+            }
+        }
+
         [SkippableFact(typeof(IOException))]
         public void ReceivesStreamWithOffset()
         {
@@ -29,3 +29,21 @@ JNIEXPORT jbyteArray JNICALL PKGNAME(NormData_getData)
   return data;
 }
 
+JNIEXPORT jobject JNICALL PKGNAME(NormData_getDirectData)
+    (JNIEnv *env, jobject obj) {
+  NormObjectHandle objectHandle;
+  const char *buffer;
+
+  objectHandle = (NormObjectHandle)env->GetLongField(obj,
+    fid_NormObject_handle);
+
+  buffer = NormDataAccessData(objectHandle);
+  if (buffer == NULL) {
+    return NULL;
+  }
+
+  // Wrap the NORM data in place (no copy)
+  return env->NewDirectByteBuffer((void*)buffer,
+    (jlong)NormObjectGetSize(objectHandle));
+}
+
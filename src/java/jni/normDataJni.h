@@ -15,6 +15,14 @@ extern "C" {
 JNIEXPORT jbyteArray JNICALL Java_mil_navy_nrl_norm_NormData_getData
   (JNIEnv *, jobject);
 
+/*
+ * Class:     mil_navy_nrl_norm_NormData
+ * Method:    getDirectData
+ * Signature: ()Ljava/nio/ByteBuffer;
+ */
+JNIEXPORT jobject JNICALL Java_mil_navy_nrl_norm_NormData_getDirectData
+  (JNIEnv *, jobject);
+
 #ifdef __cplusplus
 }
 #endif
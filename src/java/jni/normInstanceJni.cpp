@@ -192,6 +192,64 @@ JNIEXPORT jobject JNICALL PKGNAME(NormInstance_getNextEvent)
       (jlong)event.session, (jlong)event.sender, (jlong)event.object);
 }
 
+JNIEXPORT jint JNICALL PKGNAME(NormInstance_getNextEvents)
+    (JNIEnv *env, jobject obj, jobjectArray events, jboolean waitForEvent) {
+  NormInstanceHandle handle;
+  NormEvent eventBuffer[64];
+  NormEvent *eventList;
+  unsigned int maxEvents, count, i;
+
+  handle = (NormInstanceHandle)env->GetLongField(obj, fid_NormInstance_handle);
+
+  maxEvents = (unsigned int)env->GetArrayLength(events);
+  if (maxEvents == 0) {
+    return 0;
+  }
+  if (maxEvents > 64) {
+    eventList = new NormEvent[maxEvents];
+  } else {
+    eventList = eventBuffer;
+  }
+
+  // Get all of the pending events with one NORM thread handoff
+  count = NormGetNextEvents(handle, eventList, maxEvents, waitForEvent);
+
+  jobjectArray types = NULL;
+  if (count > 0) {
+    types = (jobjectArray)env->CallStaticObjectMethod(
+      (jclass)env->NewLocalRef(jw_NormEventType), mid_NormEventType_values);
+  }
+
+  for (i = 0; i < count; i++) {
+    if (env->GetArrayLength(types) <= eventList[i].type) {
+      env->ThrowNew((jclass)env->NewLocalRef(jw_IOException), "Invalid NORM event type (NormEventType.java out of sync with NORM API event header?)");
+      break;
+    }
+    jobject type = env->GetObjectArrayElement(types, eventList[i].type);
+    jobject event = env->GetObjectArrayElement(events, i);
+
+    // Reuse the caller's NormEvent objects, creating any missing ones
+    if (event == NULL) {
+      event = env->NewObject((jclass)env->NewLocalRef(jw_NormEvent), mid_NormEvent_init, type,
+        (jlong)eventList[i].session, (jlong)eventList[i].sender, (jlong)eventList[i].object);
+      env->SetObjectArrayElement(events, i, event);
+    } else {
+      env->SetObjectField(event, fid_NormEvent_type, type);
+      env->SetLongField(event, fid_NormEvent_sessionHandle, (jlong)eventList[i].session);
+      env->SetLongField(event, fid_NormEvent_nodeHandle, (jlong)eventList[i].sender);
+      env->SetLongField(event, fid_NormEvent_objectHandle, (jlong)eventList[i].object);
+    }
+    env->DeleteLocalRef(event);
+    env->DeleteLocalRef(type);
+  }
+
+  if (eventList != eventBuffer) {
+    delete[] eventList;
+  }
+
+  return (jint)i;
+}
+
 JNIEXPORT jobject JNICALL PKGNAME(NormInstance_createSession)
     (JNIEnv *env, jobject obj, jstring address, jint port, jlong localNodeId) {
   NormInstanceHandle handle;
@@ -119,6 +119,14 @@ JNIEXPORT jboolean JNICALL Java_mil_navy_nrl_norm_NormInstance_hasNextEvent
 JNIEXPORT jobject JNICALL Java_mil_navy_nrl_norm_NormInstance_getNextEvent
   (JNIEnv *, jobject);
 
+/*
+ * Class:     mil_navy_nrl_norm_NormInstance
+ * Method:    getNextEvents
+ * Signature: ([Lmil/navy/nrl/norm/NormEvent;Z)I
+ */
+JNIEXPORT jint JNICALL Java_mil_navy_nrl_norm_NormInstance_getNextEvents
+  (JNIEnv *, jobject, jobjectArray, jboolean);
+
 /*
  * Class:     mil_navy_nrl_norm_NormInstance
  * Method:    createSession
@@ -16,6 +16,9 @@ jmethodID mid_NormData_init;
 jweak jw_NormEvent;
 jmethodID mid_NormEvent_init;
 jfieldID fid_NormEvent_objectHandle;
+jfieldID fid_NormEvent_type;
+jfieldID fid_NormEvent_sessionHandle;
+jfieldID fid_NormEvent_nodeHandle;
 
 jweak jw_NormEventType;
 jmethodID mid_NormEventType_values;
@@ -93,6 +96,10 @@ JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM *vm, void *reserved) {
   jclass NormEventClass = env->FindClass("mil/navy/nrl/norm/NormEvent");
   jw_NormEvent = env->NewWeakGlobalRef(NormEventClass);
   fid_NormEvent_objectHandle = env->GetFieldID(NormEventClass,"objectHandle", "J");
+  fid_NormEvent_type = env->GetFieldID(NormEventClass, "type",
+    "Lmil/navy/nrl/norm/enums/NormEventType;");
+  fid_NormEvent_sessionHandle = env->GetFieldID(NormEventClass, "sessionHandle", "J");
+  fid_NormEvent_nodeHandle = env->GetFieldID(NormEventClass, "nodeHandle", "J");
   mid_NormEvent_init = env->GetMethodID(NormEventClass, "<init>",
     "(Lmil/navy/nrl/norm/enums/NormEventType;JJJ)V");
 
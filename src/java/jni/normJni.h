@@ -11,7 +11,7 @@
  * and C native libraries. Update this string along with it's counterpart in
  * the NormInstance.java file whenever the native API changes.
  */
-#define VERSION "20130415-0927"
+#define VERSION "20261014-1200"
 
 #define PKGNAME(str) Java_mil_navy_nrl_norm_##str
 
@@ -36,6 +36,9 @@ extern jmethodID mid_NormData_init;
 extern jweak jw_NormEvent;
 extern jmethodID mid_NormEvent_init;
 extern jfieldID fid_NormEvent_objectHandle;
+extern jfieldID fid_NormEvent_type;
+extern jfieldID fid_NormEvent_sessionHandle;
+extern jfieldID fid_NormEvent_nodeHandle;
 
 extern jweak jw_NormEventType;
 extern jmethodID mid_NormEventType_values;
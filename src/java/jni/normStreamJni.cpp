@@ -29,6 +29,25 @@ JNIEXPORT jint JNICALL PKGNAME(NormStream_write)
   return (jint)n;
 }
 
+JNIEXPORT jint JNICALL PKGNAME(NormStream_writeBuffer)
+    (JNIEnv *env, jobject obj, jobject buffer,
+    jint offset, jint length) {
+  NormObjectHandle objectHandle;
+  char *ptr;
+
+  objectHandle = (NormObjectHandle)env->GetLongField(obj,
+    fid_NormObject_handle);
+
+  // Write straight from the direct ByteBuffer (no copy)
+  ptr = (char*)env->GetDirectBufferAddress(buffer);
+  if (ptr == NULL) {
+    env->ThrowNew((jclass)env->NewLocalRef(jw_IOException), "Cannot access direct ByteBuffer address");
+    return 0;
+  }
+
+  return (jint)NormStreamWrite(objectHandle, ptr + offset, length);
+}
+
 JNIEXPORT void JNICALL PKGNAME(NormStream_flush)
     (JNIEnv *env, jobject obj, jboolean eom, jobject flushMode) {
   NormObjectHandle objectHandle;
@@ -96,6 +115,7 @@ JNIEXPORT jint JNICALL PKGNAME(NormStream_read)
   bytes = env->GetByteArrayElements(buffer, 0);
 
   if (!NormStreamRead(objectHandle, (char*)(bytes + offset), &n)) {
+    env->ReleaseByteArrayElements(buffer, bytes, JNI_ABORT);
     return -1;
   }
 
@@ -104,6 +124,29 @@ JNIEXPORT jint JNICALL PKGNAME(NormStream_read)
   return (jint)n;
 }
 
+JNIEXPORT jint JNICALL PKGNAME(NormStream_readBuffer)
+    (JNIEnv *env, jobject obj, jobject buffer, jint offset, jint length) {
+  NormObjectHandle objectHandle;
+  char *ptr;
+  unsigned int n = length;
+
+  objectHandle = (NormObjectHandle)env->GetLongField(obj,
+    fid_NormObject_handle);
+
+  // Read straight into the direct ByteBuffer (no copy)
+  ptr = (char*)env->GetDirectBufferAddress(buffer);
+  if (ptr == NULL) {
+    env->ThrowNew((jclass)env->NewLocalRef(jw_IOException), "Cannot access direct ByteBuffer address");
+    return 0;
+  }
+
+  if (!NormStreamRead(objectHandle, ptr + offset, &n)) {
+    return -1;
+  }
+
+  return (jint)n;
+}
+
 JNIEXPORT jboolean JNICALL PKGNAME(NormStream_seekMsgStart)
     (JNIEnv *env, jobject obj) {
   NormObjectHandle objectHandle;
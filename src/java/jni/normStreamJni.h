@@ -23,6 +23,14 @@ JNIEXPORT void JNICALL Java_mil_navy_nrl_norm_NormStream_close
 JNIEXPORT jint JNICALL Java_mil_navy_nrl_norm_NormStream_write
   (JNIEnv *, jobject, jbyteArray, jint, jint);
 
+/*
+ * Class:     mil_navy_nrl_norm_NormStream
+ * Method:    writeBuffer
+ * Signature: (Ljava/nio/ByteBuffer;II)I
+ */
+JNIEXPORT jint JNICALL Java_mil_navy_nrl_norm_NormStream_writeBuffer
+  (JNIEnv *, jobject, jobject, jint, jint);
+
 /*
  * Class:     mil_navy_nrl_norm_NormStream
  * Method:    flush
@@ -71,6 +79,14 @@ JNIEXPORT void JNICALL Java_mil_navy_nrl_norm_NormStream_markEom
 JNIEXPORT jint JNICALL Java_mil_navy_nrl_norm_NormStream_read
   (JNIEnv *, jobject, jbyteArray, jint, jint);
 
+/*
+ * Class:     mil_navy_nrl_norm_NormStream
+ * Method:    readBuffer
+ * Signature: (Ljava/nio/ByteBuffer;II)I
+ */
+JNIEXPORT jint JNICALL Java_mil_navy_nrl_norm_NormStream_readBuffer
+  (JNIEnv *, jobject, jobject, jint, jint);
+
 /*
  * Class:     mil_navy_nrl_norm_NormStream
  * Method:    seekMsgStart
@@ -1,5 +1,7 @@
 package mil.navy.nrl.norm;
 
+import java.nio.ByteBuffer;
+
 /**
  * This class contains information about a NORM Data Object.
  * 
@@ -12,4 +14,15 @@ public class NormData extends NormObject {
   }
 
   public native byte[] getData();
+
+  /**
+   * @return A read-only direct buffer over the object data held by NORM (no
+   *         copy), which is valid only until the object is released.
+   */
+  public ByteBuffer getDataBuffer() {
+    ByteBuffer buffer = getDirectData();
+    return (buffer != null) ? buffer.asReadOnlyBuffer() : null;
+  }
+
+  private native ByteBuffer getDirectData();
 }
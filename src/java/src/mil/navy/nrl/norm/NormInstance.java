@@ -13,7 +13,7 @@ public class NormInstance {
    * and C native libraries. Update this string along with it's counterpart in
    * the normJni.h file whenever the native API changes.
    */
-  private static final String VERSION = "20130415-0927";
+  private static final String VERSION = "20261014-1200";
 
   static {
     System.loadLibrary("mil_navy_nrl_norm");
@@ -58,6 +58,19 @@ public class NormInstance {
 
   public native NormEvent getNextEvent() throws IOException;
 
+  /**
+   * Fills the given array with up to events.length pending events using a
+   * single native call.  The NormEvent objects already in the array are
+   * reused (null elements are filled with new ones) so a busy application
+   * can poll without allocating.  As with getNextEvent(), the event handles
+   * remain valid until the next getNextEvent(s)() call.
+   *
+   * @param waitForEvent Block until at least one event is ready.
+   * @return The number of events filled in.
+   */
+  public native int getNextEvents(NormEvent events[], boolean waitForEvent)
+      throws IOException;
+
   public native NormSession createSession(String address, int port,
       long localNodeId) throws IOException;
 }
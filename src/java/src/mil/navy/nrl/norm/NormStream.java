@@ -1,5 +1,9 @@
 package mil.navy.nrl.norm;
 
+import java.io.IOException;
+import java.nio.ByteBuffer;
+import java.nio.ReadOnlyBufferException;
+
 import mil.navy.nrl.norm.enums.NormFlushMode;
 
 /**
@@ -21,6 +25,33 @@ public class NormStream extends NormObject {
 
   public native int write(byte buffer[], int offset, int length);
 
+  /**
+   * Writes the remaining bytes of the buffer (as many as the stream can
+   * accept) and advances its position.  A direct buffer is written without
+   * an intermediate copy.
+   *
+   * @return The number of bytes written.
+   * @throws IOException if the direct buffer's address can't be accessed.
+   */
+  public int write(ByteBuffer buffer) throws IOException {
+    int n;
+    if (buffer.isDirect()) {
+      n = writeBuffer(buffer, buffer.position(), buffer.remaining());
+    } else if (buffer.hasArray()) {
+      n = write(buffer.array(), buffer.arrayOffset() + buffer.position(),
+          buffer.remaining());
+    } else {
+      byte bytes[] = new byte[buffer.remaining()];
+      buffer.duplicate().get(bytes);
+      n = write(bytes, 0, bytes.length);
+    }
+    buffer.position(buffer.position() + n);
+    return n;
+  }
+
+  private native int writeBuffer(ByteBuffer buffer, int offset, int length)
+      throws IOException;
+
   public void flush() {
     flush(false, NormFlushMode.NORM_FLUSH_PASSIVE);
   }
@@ -37,6 +68,38 @@ public class NormStream extends NormObject {
 
   public native int read(byte buffer[], int offset, int length);
 
+  /**
+   * Reads stream data into the buffer's remaining space and advances its
+   * position.  A direct buffer is filled without an intermediate copy.
+   *
+   * @return The number of bytes read or -1 if the stream broke.
+   * @throws IOException if the direct buffer's address can't be accessed.
+   */
+  public int read(ByteBuffer buffer) throws IOException {
+    int n;
+    if (buffer.isReadOnly()) {
+      throw new ReadOnlyBufferException();
+    } else if (buffer.isDirect()) {
+      n = readBuffer(buffer, buffer.position(), buffer.remaining());
+    } else if (buffer.hasArray()) {
+      n = read(buffer.array(), buffer.arrayOffset() + buffer.position(),
+          buffer.remaining());
+    } else {
+      byte bytes[] = new byte[buffer.remaining()];
+      n = read(bytes, 0, bytes.length);
+      if (n > 0) {
+        buffer.duplicate().put(bytes, 0, n);
+      }
+    }
+    if (n > 0) {
+      buffer.position(buffer.position() + n);
+    }
+    return n;
+  }
+
+  private native int readBuffer(ByteBuffer buffer, int offset, int length)
+      throws IOException;
+
   public native boolean seekMsgStart();
 
   public native long getReadOffset();
@@ -20,6 +20,60 @@ class NormEventStruct(ctypes.Structure):
             ("sender", ctypes.c_void_p),
             ("object", ctypes.c_void_p)]
 
+class PyBufferStruct(ctypes.Structure):
+    """The CPython Py_buffer structure"""
+    _fields_ = [
+            ("buf", ctypes.c_void_p),
+            ("obj", ctypes.c_void_p),
+            ("len", ctypes.c_ssize_t),
+            ("itemsize", ctypes.c_ssize_t),
+            ("readonly", ctypes.c_int),
+            ("ndim", ctypes.c_int),
+            ("format", ctypes.c_char_p),
+            ("shape", ctypes.POINTER(ctypes.c_ssize_t)),
+            ("strides", ctypes.POINTER(ctypes.c_ssize_t)),
+            ("suboffsets", ctypes.POINTER(ctypes.c_ssize_t)),
+            ("internal", ctypes.c_void_p)]
+
+PyBUF_SIMPLE = 0
+PyBUF_WRITABLE = 1
+
+ctypes.pythonapi.PyObject_GetBuffer.restype = ctypes.c_int
+ctypes.pythonapi.PyObject_GetBuffer.argtypes = [ctypes.py_object,
+        ctypes.POINTER(PyBufferStruct), ctypes.c_int]
+ctypes.pythonapi.PyBuffer_Release.restype = None
+ctypes.pythonapi.PyBuffer_Release.argtypes = [ctypes.POINTER(PyBufferStruct)]
+
+class PinnedBuffer(object):
+    """Exports the memory of a contiguous bytes-like object (bytes,
+    bytearray, memoryview, array, numpy array, ...) so it can be passed to
+    libnorm without a copy.  The exporter can not be resized or freed until
+    release() is called (a bytearray raises BufferError if resized)."""
+
+    def __init__(self, data, writable=False):
+        self._pinned = False
+        self._view = PyBufferStruct()
+        # (raises BufferError for non-contiguous or read-only buffers)
+        ctypes.pythonapi.PyObject_GetBuffer(data, ctypes.byref(self._view),
+                PyBUF_WRITABLE if writable else PyBUF_SIMPLE)
+        self._pinned = True
+
+    @property
+    def address(self) -> int:
+        return self._view.buf
+
+    @property
+    def length(self) -> int:
+        return self._view.len
+
+    def release(self):
+        if self._pinned:
+            self._pinned = False
+            ctypes.pythonapi.PyBuffer_Release(ctypes.byref(self._view))
+
+    def __del__(self):
+        self.release()
+
 # ctypes error checkers
 def errcheck_bool(result, func, args):
     """Checks the return value of functions that return bools.  Raises an
@@ -289,7 +343,7 @@ def get_libnorm():
     libnorm.NormFileEnqueue.errcheck = errcheck_object
 
     libnorm.NormDataEnqueue.restype = ctypes.c_void_p
-    libnorm.NormDataEnqueue.argtypes = [ctypes.c_void_p, ctypes.c_char_p,
+    libnorm.NormDataEnqueue.argtypes = [ctypes.c_void_p, ctypes.c_void_p,
             ctypes.c_uint32, ctypes.c_char_p, ctypes.c_uint]
     libnorm.NormDataEnqueue.errcheck = errcheck_object
 
@@ -307,7 +361,7 @@ def get_libnorm():
 
     libnorm.NormStreamWrite.restype = ctypes.c_uint
     libnorm.NormStreamWrite.argtypes = [
-      ctypes.c_void_p, ctypes.c_char_p, ctypes.c_uint]
+      ctypes.c_void_p, ctypes.c_void_p, ctypes.c_uint]
 
     libnorm.NormStreamFlush.restype = None
     libnorm.NormStreamFlush.argtypes = [
@@ -412,9 +466,18 @@ def get_libnorm():
     libnorm.NormNodeSetRxRobustFactor.argtypes = [ctypes.c_void_p, ctypes.c_int]
 
     libnorm.NormStreamRead.restype = ctypes.c_bool
-    libnorm.NormStreamRead.argtypes = [ctypes.c_void_p, ctypes.c_char_p, ctypes.POINTER(ctypes.c_uint)]
+    libnorm.NormStreamRead.argtypes = [ctypes.c_void_p, ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint)]
     libnorm.NormStreamRead.errcheck = return_bool
 
+    libnorm.NormStreamReadView.restype = ctypes.c_bool
+    libnorm.NormStreamReadView.argtypes = [ctypes.c_void_p,
+            ctypes.POINTER(ctypes.c_void_p), ctypes.POINTER(ctypes.c_uint)]
+    libnorm.NormStreamReadView.errcheck = return_bool
+
+    libnorm.NormStreamReadRelease.restype = ctypes.c_bool
+    libnorm.NormStreamReadRelease.argtypes = [ctypes.c_void_p, ctypes.c_uint]
+    libnorm.NormStreamReadRelease.errcheck = return_bool
+
     libnorm.NormStreamSeekMsgStart.restype = ctypes.c_bool
     libnorm.NormStreamSeekMsgStart.argtypes = [ctypes.c_void_p]
     libnorm.NormStreamSeekMsgStart.errcheck = return_bool
@@ -92,7 +92,11 @@ class Instance(object):
                 obj = self._objects[self._estruct.object] = Object(self._estruct.object)
         else:
             obj = None
-        return Event(self._estruct.type, self._sessions[self._estruct.session], sender, obj)
+        session = self._sessions[self._estruct.session]
+        if self._estruct.type == c.EventType.TX_OBJECT_PURGED:
+            # NORM no longer references the object's enqueued data
+            session._releasePinned(self._estruct.object)
+        return Event(self._estruct.type, session, sender, obj)
 
     def getDescriptor(self) -> int:
         return libnorm.NormGetDescriptor(self)
@@ -6,8 +6,9 @@ By: Tom Wambold <wambold@itd.nrl.navy.mil>
 from __future__ import absolute_import
 import ctypes
 import locale
+from typing import Optional
 import pynorm.constants as c
-from pynorm.core import libnorm, NormError
+from pynorm.core import libnorm, NormError, PinnedBuffer
 from pynorm.node import Node
 
 class Object(object):
@@ -66,6 +67,14 @@ class Object(object):
     def getData(self):
         return ctypes.string_at(libnorm.NormDataAccessData(self), self.size)
 
+    def getDataView(self) -> memoryview:
+        """Returns a read-only memoryview of the NORM object data (no copy)
+        that is valid for as long as this Object is referenced"""
+        data = libnorm.NormDataAccessData(self)
+        if not data:
+            return memoryview(b"")
+        return memoryview((ctypes.c_char * self.size).from_address(data)).cast("B").toreadonly()
+
     #def accessData(self):
     #    return ctypes.string_at(libnorm.NormDataAccessData(self), self.size)
     #def detachData(self):
@@ -81,8 +90,13 @@ class Object(object):
     def streamClose(self, graceful=False):
         libnorm.NormStreamClose(self, graceful)
 
-    def streamWrite(self, msg:bytes):
-        return libnorm.NormStreamWrite(self, msg, len(msg))
+    def streamWrite(self, msg) -> int:
+        """msg can be any contiguous bytes-like object (e.g. a memoryview)"""
+        buf = PinnedBuffer(msg)
+        try:
+            return libnorm.NormStreamWrite(self, buf.address, buf.length)
+        finally:
+            buf.release()
 
     def streamFlush(self, eom=False, flushmode:c.FlushMode = c.FlushMode.PASSIVE):
         libnorm.NormStreamFlush(self, eom, flushmode.value)
@@ -106,6 +120,36 @@ class Object(object):
         libnorm.NormStreamRead(self, buf, ctypes.byref(numBytes))
         return (numBytes.value, buf)
 
+    def streamReadInto(self, buffer) -> Optional[int]:
+        """Reads into a caller-provided writable buffer (e.g. a bytearray or
+        memoryview slice) and returns the number of bytes read, or None if
+        the stream broke (data was lost)"""
+        buf = PinnedBuffer(buffer, writable=True)
+        try:
+            numBytes = ctypes.c_uint(buf.length)
+            if not libnorm.NormStreamRead(self, buf.address, ctypes.byref(numBytes)):
+                return None
+            return numBytes.value
+        finally:
+            buf.release()
+
+    def streamReadView(self) -> Optional[memoryview]:
+        """Returns a read-only memoryview of the next received stream data
+        in place in the NORM stream buffer (no copy), or None if the stream
+        broke.  The view is valid until streamReadRelease() is called, which
+        must be done (with the number of bytes consumed) before the next
+        read.  An empty view means no data is ready yet."""
+        data = ctypes.c_void_p()
+        numBytes = ctypes.c_uint(0)
+        if not libnorm.NormStreamReadView(self, ctypes.byref(data), ctypes.byref(numBytes)):
+            return None
+        if 0 == numBytes.value:
+            return memoryview(b"")
+        return memoryview((ctypes.c_char * numBytes.value).from_address(data.value)).cast("B").toreadonly()
+
+    def streamReadRelease(self, numBytes:int) -> bool:
+        return libnorm.NormStreamReadRelease(self, numBytes)
+
     def streamSeekMsgStart(self):
         return libnorm.NormStreamSeekMsgStart(self)
 
@@ -1,4 +1,4 @@
-o"""
+"""
 pynorm - Python wrapper for NRL's libnorm
 By: Tom Wambold <wambold@itd.nrl.navy.mil>
 """
@@ -9,7 +9,7 @@ import ctypes
 import locale
 from typing import Optional
 import pynorm.constants as c
-from pynorm.core import libnorm, NormError
+from pynorm.core import libnorm, NormError, PinnedBuffer
 from pynorm.object import Object
 
 class Session(object):
@@ -28,9 +28,12 @@ class Session(object):
         self._session:int = libnorm.NormCreateSession(instance, address.encode('utf-8'), port, localId)
         self.sendGracefulStop = False
         self.gracePeriod = 0
+        # Buffers NORM references for enqueued data objects (until purged)
+        self._pinned = dict()
 
     def destroy(self):
         libnorm.NormDestroySession(self)
+        self._releaseAllPinned()
         del self._instance._sessions[self]
 
     def setUserData(self, data:str):
@@ -171,12 +174,24 @@ class Session(object):
             obj = self._instance._objects[result] = Object(result)
             return obj
 
-    def dataEnqueue(self, data:bytes, info:bytes=b""):
+    def dataEnqueue(self, data, info:bytes=b""):
+        """data can be any contiguous bytes-like object (bytes, bytearray,
+        memoryview, ...).  NORM transmits it in place without a copy, so it
+        is pinned (a bytearray can not be resized) until the object is
+        purged (TX_OBJECT_PURGED) or the session is destroyed and must not
+        be modified before then."""
         # TBD - allow for case of info being None?
-        result = libnorm.NormDataEnqueue(self, data, len(data), info, len(info))
+        buf = PinnedBuffer(data)
+        try:
+            result = libnorm.NormDataEnqueue(self, buf.address, buf.length, info, len(info))
+        except NormError:
+            buf.release()
+            raise
         if ctypes.c_void_p.in_dll(libnorm, "NORM_OBJECT_INVALID") == result:
+            buf.release()
             return None; # enqueue not successful due to flow control or sender cache limit
         else:
+            self._pinned[result] = buf
             # Put a reference of the object in our instance "_objects" cache to avoid creation 
             # of duplicative Python NORM Object during event notification
             obj = self._instance._objects[result] = Object(result)
@@ -287,6 +302,16 @@ class Session(object):
         self.stopSender()
         libnorm.NormDestroySession(self)
 
+    def _releasePinned(self, objectHandle:int):
+        buf = self._pinned.pop(objectHandle, None)
+        if buf is not None:
+            buf.release()
+
+    def _releaseAllPinned(self):
+        for buf in self._pinned.values():
+            buf.release()
+        self._pinned.clear()
+
     @property
     def _as_parameter_(self):
         """Used when passing this object to ctypes functions"""
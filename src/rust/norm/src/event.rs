@@ -7,7 +7,8 @@ use norm_sys::*;
 /// C event struct and provides accessors for the event data.
 ///
 /// Events are generated by the NORM protocol and can be retrieved using
-/// `Instance::next_event` or `Instance::events`.
+/// `Instance::next_event` or `Instance::events` (or `Session::pending_events`
+/// for a session with its own descriptor).
 #[derive(Debug, Clone)]
 pub struct Event {
     /// The type of event
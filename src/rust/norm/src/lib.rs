@@ -26,9 +26,8 @@ mod event;
 mod multicast;
 
 // Optional modules
-// Note: Async support with tokio is planned for future implementation
-// #[cfg(feature = "tokio")]
-// pub mod tokio;
+#[cfg(all(feature = "tokio", unix))]
+pub mod tokio;
 
 // Public re-exports
 pub use error::{Error, Result};
@@ -1,10 +1,15 @@
 use crate::error::{Error, Result, bool_result, check_handle, string_to_c_string};
 use crate::types::*;
 use crate::object::Object;
+use crate::event::Event;
 use norm_sys::*;
+use std::mem;
 use std::os::raw::c_char;
 use std::ptr;
 
+#[cfg(unix)]
+use std::os::unix::io::RawFd;
+
 /// NORM session handle with RAII semantics.
 ///
 /// A Session represents a NORM protocol session, which can be used to send and receive data.
@@ -443,6 +448,44 @@ impl Session {
         unsafe { NormCancelCommand(self.handle) };
     }
 
+    /// Get a file descriptor for this session's own event queue
+    ///
+    /// After the first call, this session's events are no longer returned by
+    /// `Instance::next_event` but by `Session::pending_events`. The descriptor
+    /// is readable while events are pending, so it can be registered with an
+    /// async runtime's reactor (e.g. `tokio::io::unix::AsyncFd`) to build an
+    /// event `Stream` without a blocking helper thread.
+    ///
+    /// # Returns
+    /// The file descriptor (`-1` on error)
+    #[cfg(unix)]
+    pub fn descriptor(&self) -> RawFd {
+        unsafe { NormGetSessionDescriptor(self.handle) }
+    }
+
+    /// Get up to `max_events` pending events from this session's queue
+    ///
+    /// This never blocks, and returns an empty list unless `descriptor` has
+    /// been called. The returned events' handles remain valid until the next
+    /// `pending_events` call.
+    ///
+    /// # Arguments
+    /// * `max_events` - The maximum number of events to return
+    ///
+    /// # Returns
+    /// The pending events, oldest first
+    pub fn pending_events(&self, max_events: usize) -> Vec<Event> {
+        let mut raw_events = vec![unsafe { mem::zeroed::<NormEvent>() }; max_events];
+        let count = unsafe {
+            NormGetSessionEvents(self.handle, raw_events.as_mut_ptr(), max_events as u32)
+        };
+        raw_events
+            .into_iter()
+            .take(count as usize)
+            .map(Event::from_raw)
+            .collect()
+    }
+
     /// Get the raw NORM session handle
     ///
     /// # Returns
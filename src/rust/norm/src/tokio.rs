@@ -0,0 +1,394 @@
+//! Async support with tokio (feature = "tokio")
+//!
+//! An `AsyncSession` gives its session its own event descriptor (see
+//! `Session::descriptor`) and registers it with the tokio reactor, so
+//! neither events nor stream I/O need a blocking helper thread:
+//!
+//! - `AsyncSession::next_event` (or `poll_next_event`, which has the
+//!   `Stream::poll_next` signature) yields the session's events
+//! - `AsyncSession::stream` wraps a NORM stream object in an `AsyncStream`
+//!   implementing `AsyncRead`, `AsyncBufRead` and `AsyncWrite`
+//!
+//! Reads use the zero-copy `NormStreamReadView()`/`NormStreamReadRelease()`
+//! calls (`AsyncBufRead::poll_fill_buf` returns the NORM segment itself) and
+//! writes fill the space from `NormStreamReserve()` before
+//! `NormStreamCommit()`.
+//!
+//! This module is only available on Unix platforms.
+
+use crate::error::{Error, Result};
+use crate::event::Event;
+use crate::object::Object;
+use crate::session::Session;
+use crate::types::{EventType, FlushMode};
+use norm_sys::*;
+use ::tokio::io::unix::AsyncFd;
+use ::tokio::io::{AsyncBufRead, AsyncRead, AsyncWrite, ReadBuf};
+use std::collections::VecDeque;
+use std::future::poll_fn;
+use std::io;
+use std::os::raw::c_char;
+use std::os::unix::io::{AsRawFd, RawFd};
+use std::pin::Pin;
+use std::ptr;
+use std::slice;
+use std::sync::{Arc, Mutex};
+use std::task::{Context, Poll, Waker};
+
+/// Maximum number of events taken from the session queue at once
+const EVENT_BATCH: usize = 64;
+
+/// The session descriptor (owned, and closed, by the NORM session)
+struct SessionFd(RawFd);
+
+impl AsRawFd for SessionFd {
+    fn as_raw_fd(&self) -> RawFd {
+        self.0
+    }
+}
+
+// Retains an event's object (or else sender) handle while it is buffered
+fn retain_event(event: &Event) {
+    if event.object != NORM_OBJECT_INVALID {
+        unsafe { NormObjectRetain(event.object) };
+    } else if event.sender != NORM_NODE_INVALID {
+        unsafe { NormNodeRetain(event.sender) };
+    }
+}
+
+fn release_event(event: &Event) {
+    if event.object != NORM_OBJECT_INVALID {
+        unsafe { NormObjectRelease(event.object) };
+    } else if event.sender != NORM_NODE_INVALID {
+        unsafe { NormNodeRelease(event.sender) };
+    }
+}
+
+struct DriverState {
+    /// Tasks to wake whenever events are drained
+    waiters: Vec<Waker>,
+    /// Events buffered for `poll_next_event` (if `buffer_events`)
+    events: VecDeque<Event>,
+    buffer_events: bool,
+    /// The last event returned (its handles stay retained until the next one)
+    previous: Option<Event>,
+    /// Receive streams known to have completed or been aborted
+    finished: Vec<NormObjectHandle>,
+}
+
+impl Drop for DriverState {
+    fn drop(&mut self) {
+        for event in self.events.iter().chain(self.previous.iter()) {
+            release_event(event);
+        }
+    }
+}
+
+/// Shared by an `AsyncSession` and its `AsyncStream`s.  (The fields are
+/// dropped in order, so the descriptor is deregistered and the buffered
+/// handles released before the session is destroyed.)
+struct Driver {
+    fd: AsyncFd<SessionFd>,
+    state: Mutex<DriverState>,
+    session: Session,
+}
+
+// The NORM API calls are thread-safe (each one suspends the NORM thread)
+unsafe impl Send for Driver {}
+unsafe impl Sync for Driver {}
+
+impl Driver {
+    /// Waits for the session descriptor and drains the pending events,
+    /// waking every task that waited for them.  `Ready` only means events
+    /// were drained, so callers re-check their own condition and poll again.
+    fn poll_drain(&self, cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        {
+            // (AsyncFd only wakes the last task to poll it)
+            let mut state = self.state.lock().unwrap();
+            if !state.waiters.iter().any(|waker| waker.will_wake(cx.waker())) {
+                state.waiters.push(cx.waker().clone());
+            }
+        }
+        let mut guard = match self.fd.poll_read_ready(cx) {
+            Poll::Ready(Ok(guard)) => guard,
+            Poll::Ready(Err(err)) => return Poll::Ready(Err(err)),
+            Poll::Pending => return Poll::Pending,
+        };
+        let events = self.session.pending_events(EVENT_BATCH);
+        if events.len() < EVENT_BATCH {
+            // (the session queue is empty, so the descriptor was reset)
+            guard.clear_ready();
+        }
+        let waiters = {
+            let mut state = self.state.lock().unwrap();
+            for event in events {
+                match event.event_type {
+                    EventType::RxObjectCompleted | EventType::RxObjectAborted => {
+                        state.finished.push(event.object)
+                    }
+                    _ => (),
+                }
+                if state.buffer_events {
+                    retain_event(&event);
+                    state.events.push_back(event);
+                }
+            }
+            std::mem::take(&mut state.waiters)
+        };
+        for waker in waiters {
+            waker.wake();
+        }
+        Poll::Ready(Ok(()))
+    }
+
+    fn is_finished(&self, object: NormObjectHandle) -> bool {
+        self.state.lock().unwrap().finished.contains(&object)
+    }
+
+    fn forget(&self, object: NormObjectHandle) {
+        self.state.lock().unwrap().finished.retain(|handle| *handle != object);
+    }
+}
+
+/// A NORM session driven by the tokio reactor
+///
+/// When dropped (along with any `AsyncStream`s), the session is destroyed.
+pub struct AsyncSession {
+    driver: Arc<Driver>,
+}
+
+impl AsyncSession {
+    /// Create an async session whose events are returned by `next_event`
+    ///
+    /// Must be called from within a tokio runtime.
+    ///
+    /// # Arguments
+    /// * `session` - The session, which is moved to its own event queue
+    ///
+    /// # Returns
+    /// The async session, or an error if the descriptor could not be set up
+    pub fn new(session: Session) -> Result<Self> {
+        Self::with_events(session, true)
+    }
+
+    /// Create an async session used for stream I/O only
+    ///
+    /// The session's events are still drained (to wake stream readers and
+    /// writers), but are not buffered for `next_event`.
+    pub fn without_events(session: Session) -> Result<Self> {
+        Self::with_events(session, false)
+    }
+
+    fn with_events(session: Session, buffer_events: bool) -> Result<Self> {
+        let fd = session.descriptor();
+        if fd < 0 {
+            return Err(Error::OperationFailed("Failed to get session descriptor".to_string()));
+        }
+        let fd = AsyncFd::new(SessionFd(fd))
+            .map_err(|err| Error::OperationFailed(format!("Failed to register session descriptor: {}", err)))?;
+        let state = DriverState {
+            waiters: Vec::new(),
+            events: VecDeque::new(),
+            buffer_events,
+            previous: None,
+            finished: Vec::new(),
+        };
+        Ok(AsyncSession {
+            driver: Arc::new(Driver { fd, state: Mutex::new(state), session }),
+        })
+    }
+
+    /// Get the underlying session
+    pub fn session(&self) -> &Session {
+        &self.driver.session
+    }
+
+    /// Poll for the next event
+    ///
+    /// This has the `Stream::poll_next` signature, so the session can be
+    /// used as an event stream (e.g. with `futures::stream::poll_fn`).  An
+    /// event's handles remain valid until the next event is returned.
+    ///
+    /// # Returns
+    /// `Poll::Ready(None)` if the descriptor failed (or events are not
+    /// buffered for this session)
+    pub fn poll_next_event(&self, cx: &mut Context<'_>) -> Poll<Option<Event>> {
+        loop {
+            {
+                let mut state = self.driver.state.lock().unwrap();
+                if !state.buffer_events {
+                    return Poll::Ready(None);
+                }
+                if let Some(previous) = state.previous.take() {
+                    release_event(&previous);
+                }
+                if let Some(event) = state.events.pop_front() {
+                    state.previous = Some(event.clone());
+                    return Poll::Ready(Some(event));
+                }
+            }
+            match self.driver.poll_drain(cx) {
+                Poll::Ready(Ok(())) => continue,
+                Poll::Ready(Err(_)) => return Poll::Ready(None),
+                Poll::Pending => return Poll::Pending,
+            }
+        }
+    }
+
+    /// Wait for the next event
+    ///
+    /// # Returns
+    /// The next event, or `None` as for `poll_next_event`
+    pub async fn next_event(&self) -> Option<Event> {
+        poll_fn(|cx| self.poll_next_event(cx)).await
+    }
+
+    /// Wrap a stream object for async I/O
+    ///
+    /// # Arguments
+    /// * `object` - A stream from `Session::stream_open` or a received
+    ///   `RxObjectNew` event (the handle is retained by the `AsyncStream`)
+    ///
+    /// # Returns
+    /// The async stream, or `Error::InvalidParameter` if `object` is not a stream
+    pub fn stream(&self, object: NormObjectHandle) -> Result<AsyncStream> {
+        if object == NORM_OBJECT_INVALID {
+            return Err(Error::InvalidHandle);
+        }
+        unsafe { NormObjectRetain(object) };
+        let object = Object::from_handle(object);
+        if object.get_type() != crate::types::ObjectType::Stream {
+            return Err(Error::InvalidParameter);
+        }
+        Ok(AsyncStream {
+            driver: Arc::clone(&self.driver),
+            object,
+            view_len: 0,
+        })
+    }
+}
+
+/// A NORM stream object with tokio `AsyncRead`/`AsyncBufRead`/`AsyncWrite`
+///
+/// A receive stream reads until its object completes (end of file), and a
+/// stream break (lost data) is returned as an `InvalidData` error once,
+/// after which reading resumes with the next data received.
+pub struct AsyncStream {
+    driver: Arc<Driver>,
+    object: Object,
+    /// Length of the current read view (zero if none)
+    view_len: usize,
+}
+
+impl AsyncStream {
+    /// Get the underlying stream object
+    pub fn object(&self) -> &Object {
+        &self.object
+    }
+
+    // Views the next bytes of received stream data, waiting as needed
+    fn poll_view(&mut self, cx: &mut Context<'_>) -> Poll<io::Result<&[u8]>> {
+        let handle = self.object.handle();
+        loop {
+            let mut buffer: *const c_char = ptr::null();
+            let mut len: u32 = 0;
+            let ok = unsafe { NormStreamReadView(handle, &mut buffer, &mut len) };
+            if !ok {
+                self.view_len = 0;
+                return Poll::Ready(Err(io::Error::new(io::ErrorKind::InvalidData, "NORM stream broken")));
+            }
+            if len > 0 {
+                self.view_len = len as usize;
+                let data = unsafe { slice::from_raw_parts(buffer as *const u8, len as usize) };
+                return Poll::Ready(Ok(data));
+            }
+            self.view_len = 0;
+            if self.driver.is_finished(handle) {
+                return Poll::Ready(Ok(&[]));
+            }
+            match self.driver.poll_drain(cx) {
+                Poll::Ready(Ok(())) => continue,
+                Poll::Ready(Err(err)) => return Poll::Ready(Err(err)),
+                Poll::Pending => return Poll::Pending,
+            }
+        }
+    }
+
+    fn release_view(&mut self, amount: usize) {
+        let amount = amount.min(self.view_len);
+        unsafe { NormStreamReadRelease(self.object.handle(), amount as u32) };
+        self.view_len = 0;
+    }
+}
+
+impl AsyncBufRead for AsyncStream {
+    fn poll_fill_buf(self: Pin<&mut Self>, cx: &mut Context<'_>) -> Poll<io::Result<&[u8]>> {
+        self.get_mut().poll_view(cx)
+    }
+
+    fn consume(self: Pin<&mut Self>, amount: usize) {
+        self.get_mut().release_view(amount);
+    }
+}
+
+impl AsyncRead for AsyncStream {
+    fn poll_read(self: Pin<&mut Self>, cx: &mut Context<'_>, buf: &mut ReadBuf<'_>) -> Poll<io::Result<()>> {
+        let this = self.get_mut();
+        let amount = match this.poll_view(cx) {
+            Poll::Ready(Ok(data)) => {
+                let amount = data.len().min(buf.remaining());
+                buf.put_slice(&data[..amount]);
+                amount
+            }
+            Poll::Ready(Err(err)) => return Poll::Ready(Err(err)),
+            Poll::Pending => return Poll::Pending,
+        };
+        if amount > 0 {
+            this.release_view(amount);
+        }
+        Poll::Ready(Ok(()))
+    }
+}
+
+impl AsyncWrite for AsyncStream {
+    fn poll_write(self: Pin<&mut Self>, cx: &mut Context<'_>, buf: &[u8]) -> Poll<io::Result<usize>> {
+        if buf.is_empty() {
+            return Poll::Ready(Ok(0));
+        }
+        let this = self.get_mut();
+        let handle = this.object.handle();
+        loop {
+            // Fill the reserved stream segment space in place
+            let mut len = buf.len() as u32;
+            let space = unsafe { NormStreamReserve(handle, &mut len) };
+            if !space.is_null() && len > 0 {
+                let amount = (len as usize).min(buf.len());
+                unsafe { ptr::copy_nonoverlapping(buf.as_ptr(), space as *mut u8, amount) };
+                let committed = unsafe { NormStreamCommit(handle, amount as u32, false) };
+                return Poll::Ready(Ok(committed as usize));
+            }
+            // (the stream is full until a TX_QUEUE_VACANCY event)
+            match this.driver.poll_drain(cx) {
+                Poll::Ready(Ok(())) => continue,
+                Poll::Ready(Err(err)) => return Poll::Ready(Err(err)),
+                Poll::Pending => return Poll::Pending,
+            }
+        }
+    }
+
+    fn poll_flush(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        unsafe { NormStreamFlush(self.object.handle(), false, FlushMode::Active.into()) };
+        Poll::Ready(Ok(()))
+    }
+
+    fn poll_shutdown(self: Pin<&mut Self>, _cx: &mut Context<'_>) -> Poll<io::Result<()>> {
+        unsafe { NormStreamClose(self.object.handle(), true) };
+        Poll::Ready(Ok(()))
+    }
+}
+
+impl Drop for AsyncStream {
+    fn drop(&mut self) {
+        self.driver.forget(self.object.handle());
+    }
+}
@@ -0,0 +1,644 @@
+#include "normEmu.h"
+#include "normMessage.h"
+
+// In SIMULATE builds the simulation environment supplies the system time
+// (Protolib timers and all NORM timing use the emulated clock)
+void ProtoSystemTime(struct timeval& theTime)
+{
+    NormEmuNet* net = NormEmuNet::GetInstance();
+    double now = (NULL != net) ? net->GetTime() : 0.0;
+    theTime.tv_sec = (unsigned long)now;
+    theTime.tv_usec = (unsigned long)(1.0e+06 * (now - (double)theTime.tv_sec));
+}  // end ProtoSystemTime()
+
+NormEmuLink::Result NormEmuLink::Transmit(NormEmuNet&  net,
+                                          double       sendTime,
+                                          unsigned int numBytes,
+                                          double&      arrivalTime)
+{
+    // 1) Gilbert-Elliott burst loss (state transition, then loss draw)
+    if (config.p_good_bad > 0.0)
+    {
+        if (bad_state)
+        {
+            if (net.UniformRand() < config.p_bad_good) bad_state = false;
+        }
+        else if (net.UniformRand() < config.p_good_bad)
+        {
+            bad_state = true;
+        }
+    }
+    double lossProb = bad_state ? config.loss_bad : config.loss_good;
+    if ((lossProb > 0.0) && (net.UniformRand() < lossProb))
+        return LOST;
+    // 2) Serialization and tail drop queueing
+    double startTime = (busy_until > sendTime) ? busy_until : sendTime;
+    if (config.rate > 0.0)
+    {
+        if ((0 != config.queue_limit) &&
+            ((startTime - sendTime) * config.rate / 8.0 > (double)config.queue_limit))
+            return QUEUE_DROP;
+        busy_until = startTime + 8.0 * (double)numBytes / config.rate;
+    }
+    else
+    {
+        busy_until = startTime;
+    }
+    // 3) Propagation delay and reordering
+    arrivalTime = busy_until + config.delay;
+    if ((config.reorder > 0.0) && (net.UniformRand() < config.reorder))
+        arrivalTime += config.reorder_delay;
+    return OK;
+}  // end NormEmuLink::Transmit()
+
+// A reference counted packet shared by its multicast deliveries
+class NormEmuNet::Packet
+{
+    public:
+        Packet(const char* buffer, unsigned int numBytes,
+               const ProtoAddress& srcAddr, const ProtoAddress& dstAddr, int msgType)
+         : data(new char[numBytes]), len(numBytes), src(srcAddr), dst(dstAddr),
+           type(msgType), ref_count(1)
+            {memcpy(data, buffer, numBytes);}
+        void Retain()
+            {ref_count++;}
+        void Release()
+        {
+            if (0 == --ref_count)
+            {
+                delete[] data;
+                delete this;
+            }
+        }
+
+        char*           data;
+        unsigned int    len;
+        ProtoAddress    src;
+        ProtoAddress    dst;
+        int             type;   // NormMsg::Type (or -1)
+
+    private:
+        unsigned int    ref_count;
+};  // end class NormEmuNet::Packet
+
+class NormEmuNet::Delivery : public NormEmuEvent
+{
+    public:
+        Delivery(NormEmuNet& theNet, Packet* thePkt, unsigned int dstIndex)
+         : net(theNet), pkt(thePkt), dst_index(dstIndex)
+            {pkt->Retain();}
+        void OnEvent();
+        void OnDiscard()
+        {
+            pkt->Release();
+            delete this;
+        }
+
+    private:
+        NormEmuNet&     net;
+        Packet*         pkt;
+        unsigned int    dst_index;
+};  // end class NormEmuNet::Delivery
+
+void NormEmuNet::Delivery::OnEvent()
+{
+    NormEmuAgent* agent = net.GetAgent(dst_index);
+    NormEmuAgent::UdpSocket* sock = (NULL != agent) ? agent->FindSocket(pkt->dst.GetPort()) : NULL;
+    if ((NULL != sock) && (!pkt->dst.IsMulticast() || sock->IsMember(pkt->dst)))
+    {
+        net.stats.delivered++;
+        if ((0 == dst_index) && (NormMsg::NACK == pkt->type))
+            net.stats.nacksToSender++;
+        sock->Enqueue(pkt->data, pkt->len, pkt->src, pkt->dst);
+        if (NULL != sock->GetSocket())
+            sock->GetSocket()->OnNotify(ProtoSocket::NOTIFY_INPUT);
+    }
+    pkt->Release();
+    delete this;
+}  // end NormEmuNet::Delivery::OnEvent()
+
+NormEmuNet* NormEmuNet::the_net = NULL;
+
+NormEmuNet::NormEmuNet()
+ : node_count(0), agent(NULL), uplink(NULL), downlink(NULL),
+   sim_time(0.0), next_order(0), heap(NULL), heap_size(0), heap_max(0),
+   rand_state(1)
+{
+    memset(&stats, 0, sizeof(stats));
+}
+
+NormEmuNet::~NormEmuNet()
+{
+    Destroy();
+}
+
+bool NormEmuNet::Init(unsigned int numNodes, UINT32 seed)
+{
+    Destroy();
+    if ((NULL != the_net) || (0 == numNodes))
+    {
+        PLOG(PL_FATAL, "NormEmuNet::Init() error: network already exists or no nodes\n");
+        return false;
+    }
+    the_net = this;
+    rand_state = (0 != seed) ? seed : 1;
+    if ((NULL == (uplink = new NormEmuLink[numNodes])) ||
+        (NULL == (downlink = new NormEmuLink[numNodes])) ||
+        (NULL == (agent = new NormEmuAgent*[numNodes])))
+    {
+        PLOG(PL_FATAL, "NormEmuNet::Init() new link/agent array error: %s\n", GetErrorString());
+        Destroy();
+        return false;
+    }
+    memset(agent, 0, numNodes * sizeof(NormEmuAgent*));
+    node_count = numNodes;
+    for (unsigned int i = 0; i < numNodes; i++)
+    {
+        if (NULL == (agent[i] = new NormEmuAgent(*this, i)))
+        {
+            PLOG(PL_FATAL, "NormEmuNet::Init() new agent error: %s\n", GetErrorString());
+            Destroy();
+            return false;
+        }
+    }
+    return true;
+}  // end NormEmuNet::Init()
+
+void NormEmuNet::Destroy()
+{
+    if (NULL != agent)
+    {
+        for (unsigned int i = 0; i < node_count; i++)
+        {
+            if (NULL != agent[i])
+            {
+                agent[i]->Stop();
+                delete agent[i];
+            }
+        }
+        delete[] agent;
+        agent = NULL;
+    }
+    // (only deliveries are still scheduled once the agents are gone)
+    while (heap_size > 0)
+    {
+        NormEmuEvent* theEvent = heap[0];
+        Cancel(*theEvent);
+        theEvent->OnDiscard();
+    }
+    if (NULL != heap)
+    {
+        delete[] heap;
+        heap = NULL;
+    }
+    heap_max = 0;
+    if (NULL != uplink)
+    {
+        delete[] uplink;
+        uplink = NULL;
+    }
+    if (NULL != downlink)
+    {
+        delete[] downlink;
+        downlink = NULL;
+    }
+    node_count = 0;
+    sim_time = 0.0;
+    memset(&stats, 0, sizeof(stats));
+    if (this == the_net) the_net = NULL;
+}  // end NormEmuNet::Destroy()
+
+void NormEmuNet::GetNodeAddress(unsigned int index, ProtoAddress& addr)
+{
+    char text[32];
+    sprintf(text, "10.%u.%u.1", (index >> 8) & 0xff, index & 0xff);
+    addr.ResolveFromString(text);
+}  // end NormEmuNet::GetNodeAddress()
+
+int NormEmuNet::GetNodeIndex(const ProtoAddress& addr)
+{
+    if (ProtoAddress::IPv4 != addr.GetType()) return -1;
+    const UINT8* a = (const UINT8*)addr.GetRawHostAddress();
+    if ((10 != a[0]) || (1 != a[3])) return -1;
+    return (int)(((unsigned int)a[1] << 8) | (unsigned int)a[2]);
+}  // end NormEmuNet::GetNodeIndex()
+
+double NormEmuNet::UniformRand()
+{
+    // (xorshift32, so runs don't depend on the C library rand())
+    rand_state ^= rand_state << 13;
+    rand_state ^= rand_state >> 17;
+    rand_state ^= rand_state << 5;
+    return ((double)rand_state / 4294967296.0);
+}  // end NormEmuNet::UniformRand()
+
+// The event queue is a binary heap ordered by (time, order)
+static inline bool NormEmuEventBefore(double t1, UINT32 o1, double t2, UINT32 o2)
+{
+    return ((t1 < t2) || ((t1 == t2) && ((INT32)(o1 - o2) < 0)));
+}
+
+void NormEmuNet::HeapUp(int index)
+{
+    NormEmuEvent* theEvent = heap[index];
+    while (index > 0)
+    {
+        int parent = (index - 1) >> 1;
+        NormEmuEvent* p = heap[parent];
+        if (!NormEmuEventBefore(theEvent->event_time, theEvent->event_order, p->event_time, p->event_order))
+            break;
+        heap[index] = p;
+        p->heap_index = index;
+        index = parent;
+    }
+    heap[index] = theEvent;
+    theEvent->heap_index = index;
+}  // end NormEmuNet::HeapUp()
+
+void NormEmuNet::HeapDown(int index)
+{
+    NormEmuEvent* theEvent = heap[index];
+    while (true)
+    {
+        int child = (index << 1) + 1;
+        if (child >= heap_size) break;
+        if (((child + 1) < heap_size) &&
+            NormEmuEventBefore(heap[child + 1]->event_time, heap[child + 1]->event_order,
+                               heap[child]->event_time, heap[child]->event_order))
+            child++;
+        NormEmuEvent* c = heap[child];
+        if (!NormEmuEventBefore(c->event_time, c->event_order, theEvent->event_time, theEvent->event_order))
+            break;
+        heap[index] = c;
+        c->heap_index = index;
+        index = child;
+    }
+    heap[index] = theEvent;
+    theEvent->heap_index = index;
+}  // end NormEmuNet::HeapDown()
+
+void NormEmuNet::Schedule(NormEmuEvent& theEvent, double eventTime)
+{
+    if (theEvent.heap_index >= 0) Cancel(theEvent);
+    if (heap_size >= heap_max)
+    {
+        int newMax = (0 != heap_max) ? (2 * heap_max) : 1024;
+        NormEmuEvent** newHeap = new NormEmuEvent*[newMax];
+        if (NULL == newHeap)
+        {
+            PLOG(PL_FATAL, "NormEmuNet::Schedule() new heap error: %s\n", GetErrorString());
+            return;
+        }
+        if (NULL != heap)
+        {
+            memcpy(newHeap, heap, heap_size * sizeof(NormEmuEvent*));
+            delete[] heap;
+        }
+        heap = newHeap;
+        heap_max = newMax;
+    }
+    theEvent.event_time = (eventTime > sim_time) ? eventTime : sim_time;
+    theEvent.event_order = next_order++;
+    heap[heap_size] = &theEvent;
+    HeapUp(heap_size++);
+}  // end NormEmuNet::Schedule()
+
+void NormEmuNet::Cancel(NormEmuEvent& theEvent)
+{
+    int index = theEvent.heap_index;
+    if (index < 0) return;
+    theEvent.heap_index = -1;
+    if (index != --heap_size)
+    {
+        heap[index] = heap[heap_size];
+        heap[index]->heap_index = index;
+        HeapUp(index);
+        HeapDown(heap[index]->heap_index);
+    }
+}  // end NormEmuNet::Cancel()
+
+void NormEmuNet::Run(double stopTime)
+{
+    while ((heap_size > 0) && (heap[0]->event_time <= stopTime))
+    {
+        NormEmuEvent* theEvent = heap[0];
+        Cancel(*theEvent);
+        sim_time = theEvent->event_time;
+        theEvent->OnEvent();  // (may delete itself)
+    }
+    if (sim_time < stopTime) sim_time = stopTime;
+}  // end NormEmuNet::Run()
+
+void NormEmuNet::Send(unsigned int        srcIndex,
+                      UINT16              srcPort,
+                      const char*         buffer,
+                      unsigned int        numBytes,
+                      const ProtoAddress& dstAddr)
+{
+    int msgType = -1;
+    NormMsg msg;
+    if (msg.CopyFromBuffer(buffer, numBytes))
+    {
+        msgType = msg.GetType();
+        if ((msgType >= 0) && (msgType < 8)) stats.sent[msgType]++;
+        if ((NormMsg::DATA == msgType) &&
+            static_cast<NormObjectMsg&>(msg).FlagIsSet(NormObjectMsg::FLAG_REPAIR))
+            stats.dataRepair++;
+    }
+    if (0 == srcIndex) stats.senderBytes += numBytes;
+    double upTime;
+    switch (uplink[srcIndex].Transmit(*this, sim_time, numBytes, upTime))
+    {
+        case NormEmuLink::LOST:
+            stats.lost++;
+            return;
+        case NormEmuLink::QUEUE_DROP:
+            stats.queueDrops++;
+            return;
+        default:
+            break;
+    }
+    ProtoAddress srcAddr;
+    GetNodeAddress(srcIndex, srcAddr);
+    srcAddr.SetPort(srcPort);
+    Packet* pkt = new Packet(buffer, numBytes, srcAddr, dstAddr, msgType);
+    if (dstAddr.IsMulticast())
+    {
+        for (unsigned int i = 0; i < node_count; i++)
+        {
+            if (i != srcIndex) Deliver(pkt, i, upTime);
+        }
+    }
+    else
+    {
+        int dstIndex = GetNodeIndex(dstAddr);
+        if ((dstIndex >= 0) && ((unsigned int)dstIndex < node_count))
+            Deliver(pkt, (unsigned int)dstIndex, upTime);
+    }
+    pkt->Release();
+}  // end NormEmuNet::Send()
+
+void NormEmuNet::Deliver(Packet* pkt, unsigned int dstIndex, double sendTime)
+{
+    // (nodes without a listening socket don't cost a downlink transmission)
+    NormEmuAgent::UdpSocket* sock = agent[dstIndex]->FindSocket(pkt->dst.GetPort());
+    if ((NULL == sock) || (pkt->dst.IsMulticast() && !sock->IsMember(pkt->dst)))
+        return;
+    double arrivalTime;
+    switch (downlink[dstIndex].Transmit(*this, sendTime, pkt->len, arrivalTime))
+    {
+        case NormEmuLink::LOST:
+            stats.lost++;
+            return;
+        case NormEmuLink::QUEUE_DROP:
+            stats.queueDrops++;
+            return;
+        default:
+            break;
+    }
+    Delivery* delivery = new Delivery(*this, pkt, dstIndex);
+    if (NULL == delivery)
+    {
+        PLOG(PL_FATAL, "NormEmuNet::Deliver() new delivery error: %s\n", GetErrorString());
+        return;
+    }
+    Schedule(*delivery, arrivalTime);
+}  // end NormEmuNet::Deliver()
+
+NormEmuAgent::NormEmuAgent(NormEmuNet& theNet, unsigned int nodeIndex)
+ : NormSimAgent(GetTimerMgr(), GetSocketNotifier()),
+   net(theNet), node_index(nodeIndex), timer_event(*this), socket_list(NULL),
+   next_port(40000), rx_completed(0), rx_completed_time(0.0), rx_aborted(0)
+{
+}
+
+NormEmuAgent::~NormEmuAgent()
+{
+    net.Cancel(timer_event);
+    while (NULL != socket_list)
+    {
+        UdpSocket* sock = socket_list;
+        socket_list = sock->GetNext();
+        delete sock;
+    }
+}
+
+bool NormEmuAgent::GetLocalAddress(ProtoAddress& localAddr)
+{
+    NormEmuNet::GetNodeAddress(node_index, localAddr);
+    return localAddr.IsValid();
+}  // end NormEmuAgent::GetLocalAddress()
+
+ProtoSimAgent::SocketProxy* NormEmuAgent::OpenSocket(ProtoSocket& theSocket)
+{
+    if (ProtoSocket::UDP != theSocket.GetProtocol())
+    {
+        PLOG(PL_ERROR, "NormEmuAgent::OpenSocket() error: only UDP is emulated\n");
+        return NULL;
+    }
+    UdpSocket* sock = new UdpSocket(*this);
+    if (NULL == sock)
+    {
+        PLOG(PL_FATAL, "NormEmuAgent::OpenSocket() new socket error: %s\n", GetErrorString());
+        return NULL;
+    }
+    sock->AttachSocket(theSocket);
+    sock->SetNext(socket_list);
+    socket_list = sock;
+    return sock;
+}  // end NormEmuAgent::OpenSocket()
+
+void NormEmuAgent::CloseSocket(ProtoSocket& theSocket)
+{
+    UdpSocket* prev = NULL;
+    UdpSocket* sock = socket_list;
+    while (NULL != sock)
+    {
+        if (&theSocket == sock->GetSocket())
+        {
+            if (NULL != prev)
+                prev->SetNext(sock->GetNext());
+            else
+                socket_list = sock->GetNext();
+            delete sock;
+            return;
+        }
+        prev = sock;
+        sock = sock->GetNext();
+    }
+}  // end NormEmuAgent::CloseSocket()
+
+NormEmuAgent::UdpSocket* NormEmuAgent::FindSocket(UINT16 thePort) const
+{
+    UdpSocket* sock = socket_list;
+    while ((NULL != sock) && ((0 == thePort) || (thePort != sock->GetPort())))
+        sock = sock->GetNext();
+    return sock;
+}  // end NormEmuAgent::FindSocket()
+
+bool NormEmuAgent::UpdateSystemTimer(ProtoTimer::Command command, double delay)
+{
+    net.Cancel(timer_event);
+    if (ProtoTimer::REMOVE != command)
+        net.Schedule(timer_event, net.GetTime() + ((delay > 0.0) ? delay : 0.0));
+    return true;
+}  // end NormEmuAgent::UpdateSystemTimer()
+
+void NormEmuAgent::Notify(NormController::Event event,
+                          class NormSessionMgr* sessionMgr,
+                          class NormSession*    session,
+                          class NormSenderNode* sender,
+                          class NormObject*     object)
+{
+    if (NormController::RX_OBJECT_COMPLETED == event)
+    {
+        rx_completed++;
+        rx_completed_time = net.GetTime();
+    }
+    else if (NormController::RX_OBJECT_ABORTED == event)
+    {
+        rx_aborted++;
+    }
+    NormSimAgent::Notify(event, sessionMgr, session, sender, object);
+}  // end NormEmuAgent::Notify()
+
+NormEmuAgent::UdpSocket::UdpSocket(NormEmuAgent& theAgent)
+ : agent(theAgent), proto_socket(NULL), port(0), group_count(0),
+   rx_head(NULL), rx_tail(NULL), next(NULL)
+{
+}
+
+NormEmuAgent::UdpSocket::~UdpSocket()
+{
+    while (NULL != rx_head)
+    {
+        Datagram* dgram = rx_head;
+        rx_head = dgram->next;
+        delete[] dgram->data;
+        delete dgram;
+    }
+    rx_tail = NULL;
+}
+
+bool NormEmuAgent::UdpSocket::Bind(UINT16& thePort)
+{
+    if (0 == thePort)
+    {
+        while (NULL != agent.FindSocket(agent.next_port)) agent.next_port++;
+        thePort = agent.next_port++;
+    }
+    else
+    {
+        // (port reuse is allowed, deliveries go to the first socket found)
+        if (agent.FindSocket(thePort) == this) return true;
+    }
+    port = thePort;
+    return true;
+}  // end NormEmuAgent::UdpSocket::Bind()
+
+bool NormEmuAgent::UdpSocket::Connect(const ProtoAddress& theAddress)
+{
+    connect_addr = theAddress;
+    return true;
+}  // end NormEmuAgent::UdpSocket::Connect()
+
+bool NormEmuAgent::UdpSocket::SendTo(const char*         buffer,
+                                     unsigned int&       numBytes,
+                                     const ProtoAddress& dstAddr)
+{
+    if (0 == port)
+    {
+        UINT16 ephemeralPort = 0;
+        Bind(ephemeralPort);
+    }
+    agent.net.Send(agent.node_index, port, buffer, numBytes, dstAddr);
+    return true;
+}  // end NormEmuAgent::UdpSocket::SendTo()
+
+bool NormEmuAgent::UdpSocket::RecvFrom(char*         buffer,
+                                       unsigned int& numBytes,
+                                       ProtoAddress& srcAddr)
+{
+    ProtoAddress dstAddr;
+    return RecvFrom(buffer, numBytes, srcAddr, dstAddr);
+}  // end NormEmuAgent::UdpSocket::RecvFrom()
+
+bool NormEmuAgent::UdpSocket::RecvFrom(char*         buffer,
+                                       unsigned int& numBytes,
+                                       ProtoAddress& srcAddr,
+                                       ProtoAddress& dstAddr)
+{
+    if (NULL == rx_head)
+    {
+        numBytes = 0;  // (nothing more to read)
+        return true;
+    }
+    Datagram* dgram = rx_head;
+    if (NULL == (rx_head = dgram->next)) rx_tail = NULL;
+    unsigned int len = (dgram->len < numBytes) ? dgram->len : numBytes;
+    memcpy(buffer, dgram->data, len);
+    numBytes = len;
+    srcAddr = dgram->src;
+    dstAddr = dgram->dst;
+    delete[] dgram->data;
+    delete dgram;
+    return true;
+}  // end NormEmuAgent::UdpSocket::RecvFrom()
+
+void NormEmuAgent::UdpSocket::Enqueue(const char*         buffer,
+                                      unsigned int        numBytes,
+                                      const ProtoAddress& srcAddr,
+                                      const ProtoAddress& dstAddr)
+{
+    Datagram* dgram = new Datagram;
+    if (NULL == dgram) return;
+    if (NULL == (dgram->data = new char[numBytes]))
+    {
+        delete dgram;
+        return;
+    }
+    memcpy(dgram->data, buffer, numBytes);
+    dgram->len = numBytes;
+    dgram->src = srcAddr;
+    dgram->dst = dstAddr;
+    dgram->next = NULL;
+    if (NULL != rx_tail)
+        rx_tail->next = dgram;
+    else
+        rx_head = dgram;
+    rx_tail = dgram;
+}  // end NormEmuAgent::UdpSocket::Enqueue()
+
+bool NormEmuAgent::UdpSocket::JoinGroup(const ProtoAddress& groupAddr)
+{
+    if (IsMember(groupAddr)) return true;
+    if (group_count >= GROUP_MAX)
+    {
+        PLOG(PL_ERROR, "NormEmuAgent::UdpSocket::JoinGroup() error: too many groups\n");
+        return false;
+    }
+    group[group_count++] = groupAddr;
+    return true;
+}  // end NormEmuAgent::UdpSocket::JoinGroup()
+
+bool NormEmuAgent::UdpSocket::LeaveGroup(const ProtoAddress& groupAddr)
+{
+    for (unsigned int i = 0; i < group_count; i++)
+    {
+        if (groupAddr.HostIsEqual(group[i]))
+        {
+            group[i] = group[--group_count];
+            return true;
+        }
+    }
+    return false;
+}  // end NormEmuAgent::UdpSocket::LeaveGroup()
+
+bool NormEmuAgent::UdpSocket::IsMember(const ProtoAddress& groupAddr) const
+{
+    for (unsigned int i = 0; i < group_count; i++)
+    {
+        if (groupAddr.HostIsEqual(group[i])) return true;
+    }
+    return false;
+}  // end NormEmuAgent::UdpSocket::IsMember()
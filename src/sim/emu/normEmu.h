@@ -0,0 +1,286 @@
+#ifndef _NORM_EMU
+#define _NORM_EMU
+
+// normEmu.h - In-process NORM network emulator
+//
+// This is a self-contained simulation environment (like the ns-2 and
+// OPNET agents) for SIMULATE builds.  Many NormSimAgent nodes run in
+// one process on a virtual clock (ProtoSystemTime() returns emulated
+// time) and exchange packets through a star network where every node
+// has an uplink and a downlink with its own delay, bandwidth, queue,
+// Gilbert-Elliott burst loss and reordering.  A multicast packet is
+// lost for everyone if its sender's uplink drops it and independently
+// on each receiver's downlink.  Runs are deterministic for a given seed.
+
+#include "protoSimAgent.h"  // from Protolib
+#include "normSimAgent.h"
+
+class NormEmuNet;
+class NormEmuAgent;
+
+// Link model parameters
+class NormEmuLinkConfig
+{
+    public:
+        NormEmuLinkConfig()
+         : delay(0.010), rate(0.0), queue_limit(0), loss_good(0.0), loss_bad(0.0),
+           p_good_bad(0.0), p_bad_good(1.0), reorder(0.0), reorder_delay(0.0) {}
+
+        double          delay;          // propagation delay (sec)
+        double          rate;           // bits/sec (zero is unlimited)
+        unsigned int    queue_limit;    // bytes queued before tail drop (zero is unlimited)
+        // Gilbert-Elliott loss: per packet loss probability in the "good"
+        // and "bad" states and per packet state transition probabilities
+        double          loss_good;
+        double          loss_bad;
+        double          p_good_bad;
+        double          p_bad_good;
+        double          reorder;        // probability a packet is held back ...
+        double          reorder_delay;  // ... by this extra delay (sec)
+};  // end class NormEmuLinkConfig
+
+class NormEmuLink
+{
+    public:
+        NormEmuLink() : busy_until(0.0), bad_state(false) {}
+
+        void SetConfig(const NormEmuLinkConfig& theConfig)
+            {config = theConfig;}
+        const NormEmuLinkConfig& GetConfig() const
+            {return config;}
+
+        // Sets the packet's "arrivalTime" unless it is dropped
+        enum Result {OK, LOST, QUEUE_DROP};
+        Result Transmit(NormEmuNet& net, double sendTime, unsigned int numBytes, double& arrivalTime);
+
+    private:
+        NormEmuLinkConfig   config;
+        double              busy_until; // when the queued packets are serialized
+        bool                bad_state;
+};  // end class NormEmuLink
+
+// A virtual time event (timer or packet delivery)
+class NormEmuEvent
+{
+    friend class NormEmuNet;
+    public:
+        virtual ~NormEmuEvent() {}
+        virtual void OnEvent() = 0;
+        // Called instead for events pending when the network is destroyed
+        virtual void OnDiscard() {}
+        double GetTime() const
+            {return event_time;}
+
+    protected:
+        NormEmuEvent() : event_time(0.0), event_order(0), heap_index(-1) {}
+
+    private:
+        double  event_time;
+        UINT32  event_order;  // (FIFO among events at the same time)
+        int     heap_index;   // -1 when not scheduled
+};  // end class NormEmuEvent
+
+// The emulated network, event scheduler and virtual clock
+class NormEmuNet
+{
+    public:
+        NormEmuNet();
+        ~NormEmuNet();
+
+        bool Init(unsigned int numNodes, UINT32 seed);
+        void Destroy();
+        static NormEmuNet* GetInstance()  // (for ProtoSystemTime())
+            {return the_net;}
+
+        unsigned int GetNodeCount() const
+            {return node_count;}
+        NormEmuAgent* GetAgent(unsigned int index) const
+            {return ((index < node_count) ? agent[index] : NULL);}
+        NormEmuLink& AccessUplink(unsigned int index)
+            {return uplink[index];}
+        NormEmuLink& AccessDownlink(unsigned int index)
+            {return downlink[index];}
+
+        // Node "index" has address 10.<index/256>.<index%256>.1 (its NormNodeId is index+1)
+        static void GetNodeAddress(unsigned int index, ProtoAddress& addr);
+        static int GetNodeIndex(const ProtoAddress& addr);
+
+        double GetTime() const
+            {return sim_time;}
+        void Schedule(NormEmuEvent& theEvent, double eventTime);
+        void Cancel(NormEmuEvent& theEvent);
+        // Runs events until "stopTime" or until there are none left
+        void Run(double stopTime);
+
+        // Deterministic uniform random numbers in [0.0, 1.0)
+        double UniformRand();
+
+        void Send(unsigned int srcIndex, UINT16 srcPort,
+                  const char* buffer, unsigned int numBytes,
+                  const ProtoAddress& dstAddr);
+
+        struct Stats
+        {
+            unsigned long   sent[8];        // by NormMsg::Type
+            unsigned long   dataRepair;     // NORM_DATA with FLAG_REPAIR
+            unsigned long   nacksToSender;  // NACKs delivered to node 0
+            unsigned long   lost;           // link loss (per link traversal)
+            unsigned long   queueDrops;
+            unsigned long   delivered;
+            unsigned long   senderBytes;    // sent by node 0
+        };
+        const Stats& GetStats() const
+            {return stats;}
+
+    private:
+        class Packet;
+        class Delivery;
+        friend class Delivery;
+        void Deliver(Packet* pkt, unsigned int dstIndex, double sendTime);
+        void HeapUp(int index);
+        void HeapDown(int index);
+
+        static NormEmuNet*  the_net;
+        unsigned int        node_count;
+        NormEmuAgent**      agent;
+        NormEmuLink*        uplink;
+        NormEmuLink*        downlink;
+        double              sim_time;
+        UINT32              next_order;
+        NormEmuEvent**      heap;
+        int                 heap_size;
+        int                 heap_max;
+        UINT32              rand_state;
+        Stats               stats;
+};  // end class NormEmuNet
+
+// Each emulated node runs a NormSimAgent
+// (ProtoSimAgent must be listed first, as for the ns-2 NsNormAgent)
+class NormEmuAgent : public ProtoSimAgent, public NormSimAgent
+{
+    public:
+        NormEmuAgent(NormEmuNet& theNet, unsigned int nodeIndex);
+        ~NormEmuAgent();
+
+        unsigned int GetIndex() const
+            {return node_index;}
+        bool ProcessCommand(const char* cmd, const char* val)
+            {return NormSimAgent::ProcessCommand(cmd, val);}
+
+        // Objects this node completed receiving and when it last did
+        unsigned long GetRxCompletedCount() const
+            {return rx_completed;}
+        double GetRxCompletedTime() const
+            {return rx_completed_time;}
+        unsigned long GetRxAbortedCount() const
+            {return rx_aborted;}
+
+        // ProtoSimAgent overrides
+        bool GetLocalAddress(ProtoAddress& localAddr);
+
+        // NormSimAgent overrides
+        unsigned long GetAgentId()
+            {return (unsigned long)(node_index + 1);}
+        bool HandleMessage(const char* txBuffer, unsigned int len, const ProtoAddress& srcAddr)
+            {return NormSimAgent::SendMessage(len, txBuffer);}
+
+        // The emulated UDP socket
+        class UdpSocket : public ProtoSimAgent::SocketProxy
+        {
+            public:
+                UdpSocket(NormEmuAgent& theAgent);
+                ~UdpSocket();
+
+                bool Bind(UINT16& thePort);
+                bool Connect(const ProtoAddress& theAddress);
+                bool Accept(ProtoSocket* theSocket) {return false;}
+                bool Listen(UINT16 thePort) {return false;}
+                bool SendTo(const char* buffer, unsigned int& numBytes, const ProtoAddress& dstAddr);
+                bool RecvFrom(char* buffer, unsigned int& numBytes, ProtoAddress& srcAddr);
+                bool RecvFrom(char* buffer, unsigned int& numBytes,
+                              ProtoAddress& srcAddr, ProtoAddress& dstAddr);
+                bool JoinGroup(const ProtoAddress& groupAddr);
+                bool LeaveGroup(const ProtoAddress& groupAddr);
+                void SetTTL(unsigned char ttl) {}
+                void SetLoopback(bool loopback) {}
+                bool SetTOS(UINT8 tos) {return true;}
+                bool SetEcnCapable(bool state) {return true;}
+                bool GetEcnStatus() const {return false;}
+
+                UINT16 GetPort() const
+                    {return port;}
+                bool IsMember(const ProtoAddress& groupAddr) const;
+                // (the packet data is copied)
+                void Enqueue(const char* buffer, unsigned int numBytes,
+                             const ProtoAddress& srcAddr, const ProtoAddress& dstAddr);
+
+                void AttachSocket(ProtoSocket& protoSocket)
+                    {proto_socket = &protoSocket;}
+                ProtoSocket* GetSocket() const
+                    {return proto_socket;}
+                UdpSocket* GetNext() const
+                    {return next;}
+                void SetNext(UdpSocket* theNext)
+                    {next = theNext;}
+
+            private:
+                struct Datagram
+                {
+                    char*           data;
+                    unsigned int    len;
+                    ProtoAddress    src;
+                    ProtoAddress    dst;
+                    Datagram*       next;
+                };
+                enum {GROUP_MAX = 8};
+                NormEmuAgent&       agent;
+                ProtoSocket*        proto_socket;
+                UINT16              port;
+                ProtoAddress        group[GROUP_MAX];
+                unsigned int        group_count;
+                ProtoAddress        connect_addr;
+                Datagram*           rx_head;
+                Datagram*           rx_tail;
+                UdpSocket*          next;
+        };  // end class NormEmuAgent::UdpSocket
+
+        UdpSocket* FindSocket(UINT16 thePort) const;
+        NormEmuNet& AccessNet()
+            {return net;}
+
+    protected:
+        // ProtoSimAgent overrides
+        ProtoSimAgent::SocketProxy* OpenSocket(ProtoSocket& theSocket);
+        void CloseSocket(ProtoSocket& theSocket);
+        // ProtoTimerMgr override
+        bool UpdateSystemTimer(ProtoTimer::Command command, double delay);
+
+        // NormSimAgent override (to count completions)
+        void Notify(NormController::Event event,
+                    class NormSessionMgr* sessionMgr,
+                    class NormSession*    session,
+                    class NormSenderNode* sender,
+                    class NormObject*     object);
+
+    private:
+        class TimerEvent : public NormEmuEvent
+        {
+            public:
+                TimerEvent(NormEmuAgent& theAgent) : agent(theAgent) {}
+                void OnEvent()
+                    {agent.OnSystemTimeout();}
+            private:
+                NormEmuAgent& agent;
+        };
+
+        NormEmuNet&     net;
+        unsigned int    node_index;
+        TimerEvent      timer_event;
+        UdpSocket*      socket_list;
+        UINT16          next_port;   // for ephemeral Bind()s
+        unsigned long   rx_completed;
+        double          rx_completed_time;
+        unsigned long   rx_aborted;
+};  // end class NormEmuAgent
+
+#endif // _NORM_EMU
@@ -0,0 +1,249 @@
+// normEmuApp.cpp - runs a NORM sender and many receivers on the emulator
+//
+// Node 0 is the sender and nodes 1..N are receivers, all in one multicast
+// session and all in one process on virtual time, so large groups (e.g.
+// 1000 receivers) can be studied on a laptop.  The results (NACKs the sender
+// got, repair overhead, receiver completion times and the sender rate over
+// time for CC convergence) are printed to stdout as a JSON object.
+//
+// Usage:  normEmu [receivers <count>][duration <sec>][seed <value>]
+//                 [delay <sec>][rate <bits/sec>][queue <bytes>][loss <percent>]
+//                 [burst <pGoodBad>:<pBadGood>:<lossBadPercent>]
+//                 [reorder <percent>:<delaySec>][sample <sec>]
+//                 [size <bytes>][norm <cmd> <value>] ...
+//
+// The link options apply to every receiver's downlink (the sender uplink
+// only gets "delay", "rate" and "queue").  Any NormSimAgent command can be
+// given to all nodes with "norm", e.g. "norm cc on" or "norm rate 1.0e+06".
+
+#include "normEmu.h"
+
+#include <stdio.h>
+#include <stdlib.h>  // for atoi(), atof(), srand()
+#include <string.h>
+
+// Samples the sender transmit rate at a fixed interval
+class NormEmuRateSampler : public NormEmuEvent
+{
+    public:
+        NormEmuRateSampler(NormEmuNet& theNet, double theInterval)
+         : net(theNet), interval(theInterval), last_bytes(0),
+           sample(NULL), sample_max(0), sample_count(0) {}
+        ~NormEmuRateSampler()
+            {if (NULL != sample) delete[] sample;}
+
+        bool Init(double duration)
+        {
+            sample_max = (unsigned int)(duration / interval) + 1;
+            if (NULL == (sample = new double[sample_max])) return false;
+            net.Schedule(*this, interval);
+            return true;
+        }
+        void OnEvent()
+        {
+            unsigned long bytes = net.GetStats().senderBytes;
+            if (sample_count < sample_max)
+                sample[sample_count++] = 8.0 * (double)(bytes - last_bytes) / interval;
+            last_bytes = bytes;
+            net.Schedule(*this, net.GetTime() + interval);
+        }
+        unsigned int GetCount() const
+            {return sample_count;}
+        double GetSample(unsigned int index) const
+            {return sample[index];}
+
+    private:
+        NormEmuNet&     net;
+        double          interval;
+        unsigned long   last_bytes;
+        double*         sample;
+        unsigned int    sample_max;
+        unsigned int    sample_count;
+};  // end class NormEmuRateSampler
+
+static void Usage()
+{
+    fprintf(stderr, "Usage: normEmu [receivers <count>][duration <sec>][seed <value>]\n"
+                    "               [delay <sec>][rate <bits/sec>][queue <bytes>][loss <percent>]\n"
+                    "               [burst <pGoodBad>:<pBadGood>:<lossBadPercent>]\n"
+                    "               [reorder <percent>:<delaySec>][sample <sec>]\n"
+                    "               [size <bytes>][norm <cmd> <value>] ...\n");
+}
+
+int main(int argc, char* argv[])
+{
+    unsigned int receiverCount = 100;
+    double duration = 60.0;
+    UINT32 seed = 1;
+    double sampleInterval = 1.0;
+    const char* objectSize = "1000000";
+    NormEmuLinkConfig upConfig, downConfig;
+    const char* normCmd[64];
+    const char* normVal[64];
+    unsigned int normCount = 0;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const char* cmd = argv[i];
+        if (!strcmp("norm", cmd))
+        {
+            if ((i + 2) >= argc)
+            {
+                fprintf(stderr, "normEmu error: missing \"norm\" command or value\n");
+                Usage();
+                return -1;
+            }
+            if (normCount < 64)
+            {
+                normCmd[normCount] = argv[++i];
+                normVal[normCount++] = argv[++i];
+            }
+            continue;
+        }
+        if (++i >= argc)
+        {
+            fprintf(stderr, "normEmu error: missing \"%s\" value\n", cmd);
+            Usage();
+            return -1;
+        }
+        const char* val = argv[i];
+        if (!strcmp("receivers", cmd))
+        {
+            receiverCount = atoi(val);
+        }
+        else if (!strcmp("duration", cmd))
+        {
+            duration = atof(val);
+        }
+        else if (!strcmp("seed", cmd))
+        {
+            seed = (UINT32)atoi(val);
+        }
+        else if (!strcmp("delay", cmd))
+        {
+            upConfig.delay = downConfig.delay = atof(val) / 2.0;
+        }
+        else if (!strcmp("rate", cmd))
+        {
+            upConfig.rate = downConfig.rate = atof(val);
+        }
+        else if (!strcmp("queue", cmd))
+        {
+            upConfig.queue_limit = downConfig.queue_limit = atoi(val);
+        }
+        else if (!strcmp("loss", cmd))
+        {
+            downConfig.loss_good = atof(val) / 100.0;
+        }
+        else if (!strcmp("burst", cmd))
+        {
+            double lossBad;
+            if (3 != sscanf(val, "%lf:%lf:%lf", &downConfig.p_good_bad, &downConfig.p_bad_good, &lossBad))
+            {
+                fprintf(stderr, "normEmu error: invalid \"burst\" value\n");
+                return -1;
+            }
+            downConfig.loss_bad = lossBad / 100.0;
+        }
+        else if (!strcmp("reorder", cmd))
+        {
+            double reorder;
+            if (2 != sscanf(val, "%lf:%lf", &reorder, &downConfig.reorder_delay))
+            {
+                fprintf(stderr, "normEmu error: invalid \"reorder\" value\n");
+                return -1;
+            }
+            downConfig.reorder = reorder / 100.0;
+        }
+        else if (!strcmp("sample", cmd))
+        {
+            sampleInterval = atof(val);
+        }
+        else if (!strcmp("size", cmd))
+        {
+            objectSize = val;
+        }
+        else
+        {
+            fprintf(stderr, "normEmu error: invalid command \"%s\"\n", cmd);
+            Usage();
+            return -1;
+        }
+    }
+    if ((0 == receiverCount) || (receiverCount > 65534) || (duration <= 0.0) || (sampleInterval <= 0.0))
+    {
+        fprintf(stderr, "normEmu error: invalid receiver count, duration or sample interval\n");
+        return -1;
+    }
+
+    srand(seed);  // (NORM backoff timers use rand())
+    NormEmuNet net;
+    if (!net.Init(receiverCount + 1, seed))
+    {
+        fprintf(stderr, "normEmu error: unable to create network\n");
+        return -1;
+    }
+    // (the sender downlink carries feedback only and is lossless)
+    net.AccessUplink(0).SetConfig(upConfig);
+    net.AccessDownlink(0).SetConfig(upConfig);
+    for (unsigned int i = 1; i <= receiverCount; i++)
+    {
+        net.AccessUplink(i).SetConfig(upConfig);
+        net.AccessDownlink(i).SetConfig(downConfig);
+    }
+
+    bool result = true;
+    for (unsigned int i = 0; result && (i <= receiverCount); i++)
+    {
+        NormEmuAgent* agent = net.GetAgent(i);
+        result = agent->ProcessCommand("address", "224.1.2.3/5000");
+        for (unsigned int j = 0; result && (j < normCount); j++)
+            result = agent->ProcessCommand(normCmd[j], normVal[j]);
+        if (result)
+            result = agent->ProcessCommand("start", (0 == i) ? "sender" : "receiver");
+    }
+    if (result) result = net.GetAgent(0)->ProcessCommand("sendFile", objectSize);
+    NormEmuRateSampler sampler(net, sampleInterval);
+    if (!result || !sampler.Init(duration))
+    {
+        fprintf(stderr, "normEmu error: unable to start NORM agents\n");
+        return -1;
+    }
+
+    net.Run(duration);
+
+    // Report results
+    const NormEmuNet::Stats& stats = net.GetStats();
+    unsigned int completeCount = 0;
+    double completeMin = 0.0, completeMax = 0.0, completeSum = 0.0;
+    for (unsigned int i = 1; i <= receiverCount; i++)
+    {
+        NormEmuAgent* agent = net.GetAgent(i);
+        if (0 == agent->GetRxCompletedCount()) continue;
+        double t = agent->GetRxCompletedTime();
+        if ((0 == completeCount) || (t < completeMin)) completeMin = t;
+        if ((0 == completeCount) || (t > completeMax)) completeMax = t;
+        completeSum += t;
+        completeCount++;
+    }
+    unsigned long dataSent = stats.sent[NormMsg::DATA];
+    double repairRatio = (dataSent > stats.dataRepair) ?
+                            ((double)stats.dataRepair / (double)(dataSent - stats.dataRepair)) : 0.0;
+    printf("{\"receivers\":%u,\"duration\":%g,\"seed\":%lu,"
+           "\"nacksSent\":%lu,\"nacksToSender\":%lu,\"dataSent\":%lu,\"repairSent\":%lu,"
+           "\"repairRatio\":%.4f,\"lost\":%lu,\"queueDrops\":%lu,\"delivered\":%lu,"
+           "\"completed\":%u,\"completeMin\":%.6f,\"completeMean\":%.6f,\"completeMax\":%.6f,"
+           "\"rateInterval\":%g,\"txRate\":[",
+           receiverCount, duration, (unsigned long)seed,
+           stats.sent[NormMsg::NACK], stats.nacksToSender, dataSent, stats.dataRepair,
+           repairRatio, stats.lost, stats.queueDrops, stats.delivered,
+           completeCount, completeMin,
+           (0 != completeCount) ? (completeSum / (double)completeCount) : 0.0, completeMax,
+           sampleInterval);
+    for (unsigned int i = 0; i < sampler.GetCount(); i++)
+        printf("%s%.0f", (0 != i) ? "," : "", sampler.GetSample(i));
+    printf("]}\n");
+    net.Cancel(sampler);
+    net.Destroy();
+    return 0;
+}  // end main()